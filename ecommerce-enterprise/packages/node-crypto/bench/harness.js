@@ -0,0 +1,115 @@
+#!/usr/bin/env node
+
+// Benchmarks for node_crypto_addon, written as an addon-bench/1 report.
+//
+//   npm run bench -- [--out results.json] [--duration 1000] [--quick]
+//   node ../../scripts/compare-benchmarks.js baseline.json results.json
+//
+// Native rows come from the addon's own benchmark harness (runStressTest):
+// the primitive runs on dedicated threads, so they exclude N-API. Node rows
+// time the exported functions from JS, per call and batched, so their gap
+// to the native rows is the binding and marshalling cost.
+
+const crypto = require('crypto');
+const path = require('path');
+const { parseBenchArgs, createReport, timeCalls, addResult, writeReport } = require('../../../scripts/bench-report');
+
+const addon = require(path.join(__dirname, '..', 'build', 'Release', 'node_crypto_addon.node'));
+const { version } = require('../package.json');
+
+const options = parseBenchArgs(process.argv.slice(2));
+const payloadSizes = options.quick ? [64, 16384] : [64, 1024, 16384, 1024 * 1024];
+const threadCounts = options.quick ? [1, 2] : [1, 2, 4];
+const batchSizes = options.quick ? [64] : [16, 256];
+
+// Audit and metrics records are small and fixed-size, so one payload
+// (the details / dataSize) is enough
+const nativeOperations = [
+  { operation: 'aes-256-gcm-encrypt', payloadSizes },
+  { operation: 'aes-256-gcm-decrypt', payloadSizes },
+  { operation: 'hash', algorithm: 'sha256', payloadSizes },
+  { operation: 'hmac', algorithm: 'hmac-sha256', payloadSizes },
+  { operation: 'audit-log', payloadSizes: [64] },
+  { operation: 'metrics-record', payloadSizes: [64] },
+];
+
+async function benchNative(report) {
+  for (const { operation, algorithm, payloadSizes: sizes } of nativeOperations) {
+    const results = await addon.runStressTest(operation, {
+      algorithm,
+      payloadSizes: sizes,
+      threads: threadCounts,
+      durationMs: options.durationMs,
+    });
+    for (const result of results) {
+      // hash/sha256, but aes-256-gcm-encrypt rather than .../aes-256-gcm
+      const name = operation.startsWith(result.algorithm) ? operation : `${operation}/${result.algorithm}`;
+      addResult(report, name, 'native',
+                { payloadSize: result.payloadSize, threads: result.threads },
+                {
+                  operations: result.operations,
+                  nsPerOp: result.nsPerOp,
+                  opsPerSecond: result.opsPerSecond,
+                  mbPerSecond: result.mbPerSecond,
+                  p50Ns: result.latencyNs.p50,
+                  p99Ns: result.latencyNs.p99,
+                });
+    }
+  }
+}
+
+// Back-to-back records with their Uint32Array boundaries, as the *Batch
+// functions take them
+function packRecords(payloadSize, count) {
+  const offsets = new Uint32Array(count + 1);
+  for (let i = 0; i <= count; i++) {
+    offsets[i] = i * payloadSize;
+  }
+  return { data: crypto.randomBytes(payloadSize * count), offsets };
+}
+
+function benchPerCall(report) {
+  const key = crypto.randomBytes(32);
+  const iv = crypto.randomBytes(12);
+  addResult(report, 'benchmarkNoop', 'node', {}, timeCalls(() => addon.benchmarkNoop(), options));
+
+  for (const payloadSize of payloadSizes) {
+    const data = crypto.randomBytes(payloadSize);
+    const callsPerRound = payloadSize >= 1024 * 1024 ? 1 : 64;
+    const timing = { ...options, payloadSize, callsPerRound };
+    addResult(report, 'encryptAES256GCM', 'node', { payloadSize },
+              timeCalls(() => addon.encryptAES256GCM(data, key, iv), timing));
+    addResult(report, 'hashData/sha256', 'node', { payloadSize },
+              timeCalls(() => addon.hashData(data, 'sha256'), timing));
+    addResult(report, 'hmacData/hmac-sha256', 'node', { payloadSize },
+              timeCalls(() => addon.hmacData(data, key, 'hmac-sha256'), timing));
+  }
+}
+
+function benchBatch(report) {
+  const key = crypto.randomBytes(32);
+  for (const payloadSize of payloadSizes.filter(size => size <= 16384)) {
+    for (const batch of batchSizes) {
+      const { data, offsets } = packRecords(payloadSize, batch);
+      const ivs = crypto.randomBytes(12 * batch);
+      const timing = { ...options, payloadSize, opsPerCall: batch, callsPerRound: 4 };
+      addResult(report, 'encryptAES256GCMBatch', 'node', { payloadSize, batch },
+                timeCalls(() => addon.encryptAES256GCMBatch(data, offsets, key, ivs), timing));
+      addResult(report, 'hashDataBatch/sha256', 'node', { payloadSize, batch },
+                timeCalls(() => addon.hashDataBatch(data, offsets, 'sha256'), timing));
+    }
+  }
+}
+
+async function main() {
+  const report = createReport('node-crypto', version);
+  await benchNative(report);
+  benchPerCall(report);
+  benchBatch(report);
+  writeReport(report, options.out);
+}
+
+main().catch(error => {
+  console.error(error);
+  process.exit(1);
+});
@@ -5,8 +5,16 @@
       "sources": [
         "src/addon.cc",
         "src/crypto_operations.cc",
+        "src/key_handle.cc",
+        "src/gcm_stream.cc",
+        "src/hash_engine.cc",
+        "src/kdf_pool.cc",
+        "src/random_pool.cc",
+        "src/signature_engine.cc",
         "src/audit_trail.cc",
-        "src/performance_monitor.cc"
+        "src/audit_segment.cc",
+        "src/performance_monitor.cc",
+        "src/performance_benchmark.cc"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
@@ -0,0 +1,49 @@
+/**
+ * Native Performance Monitor Tests
+ *
+ * Exercises the addon's metric slots directly, without the service layer.
+ */
+
+import * as path from 'path';
+
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const addon = require(path.join(__dirname, '..', '..', 'build', 'Release', 'node_crypto_addon.node'));
+
+describe('Native performance monitor', () => {
+  describe('endSpan', () => {
+    it('should record through a registered slot', () => {
+      const slot = addon.registerOperation('test-registered-slot');
+      const start = addon.startSpan();
+
+      expect(addon.endSpan(slot, start, 16, true)).toBeGreaterThanOrEqual(0);
+    });
+
+    it('should reject a slot that was never registered', () => {
+      const start = addon.startSpan();
+
+      expect(() => addon.endSpan(255, start)).toThrow(RangeError);
+      expect(() => addon.endSpan(100000, start)).toThrow(RangeError);
+    });
+  });
+
+  describe('OpenMetrics export', () => {
+    const bucket = (text: string, operation: string, le: string): number => {
+      const prefix = `enterprise_crypto_operation_duration_seconds_bucket{operation="${operation}",le="${le}"} `;
+      const line = text.split('\n').find((entry) => entry.startsWith(prefix));
+      return line === undefined ? NaN : Number(line.slice(prefix.length));
+    };
+
+    it('should count a duration equal to a bound in that le bucket', () => {
+      // 2^20 ns exactly, then one sample between that bound and the next
+      addon.recordOperation('test-le-edge', 1.048576, 0);
+      addon.recordOperation('test-le-edge', 2, 0);
+
+      const text: string = addon.exportPerformanceData('openmetrics');
+
+      expect(bucket(text, 'test-le-edge', '0.000524288')).toBe(0);
+      expect(bucket(text, 'test-le-edge', '0.001048576')).toBe(1);
+      expect(bucket(text, 'test-le-edge', '0.002097152')).toBe(2);
+      expect(bucket(text, 'test-le-edge', '+Inf')).toBe(2);
+    });
+  });
+});
@@ -3,17 +3,44 @@
 #include "crypto_operations.h"
 #include "audit_trail.h"
 #include "performance_monitor.h"
+#include "key_handle.h"
+#include "gcm_stream.h"
+#include "hash_engine.h"
+#include "kdf_pool.h"
+#include "random_pool.h"
+#include "signature_engine.h"
 
 // Initialize the addon
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
   // Initialize crypto operations
-  CryptoOperations::Init(env, exports);
+  EnterpriseCrypto::CryptoOperations::Init(env, exports);
+  
+  // Initialize key handles
+  EnterpriseCrypto::KeyHandle::Init(env, exports);
+  
+  // Initialize streaming GCM ciphers
+  EnterpriseCrypto::GcmEncryptor::Init(env, exports);
+  EnterpriseCrypto::GcmDecryptor::Init(env, exports);
+  
+  // Initialize incremental hashing
+  EnterpriseCrypto::Hasher::Init(env, exports);
+  
+  // Initialize the key derivation pool
+  EnterpriseCrypto::KdfPool::Init(env, exports);
+  
+  // Initialize the buffered random pool fast path
+  EnterpriseCrypto::RandomPool::Init(env, exports);
+  
+  // Initialize signature key registry and batch verification
+  EnterpriseCrypto::SignatureEngine::Init(env, exports);
   
   // Initialize audit trail
-  AuditTrail::Init(env, exports);
+  EnterpriseCrypto::AuditTrail::Init(env, exports);
   
   // Initialize performance monitor
-  PerformanceMonitor::Init(env, exports);
+  EnterpriseCrypto::PerformanceMonitor::Init(env, exports);
+  EnterpriseCrypto::RealTimeMonitor::Init(env, exports);
+  EnterpriseCrypto::PerformanceBenchmark::Init(env, exports);
   
   return exports;
 }
@@ -0,0 +1,571 @@
+#include "audit_segment.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace EnterpriseCrypto {
+
+using namespace AuditSegmentFormat;
+
+namespace {
+
+bool WriteAll(int fd, const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t n = ::write(fd, data.data() + offset, data.size() - offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        offset += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void PadTo8(std::string& out) {
+    out.append((8 - out.size() % 8) % 8, '\0');
+}
+
+template <typename T>
+void AppendRaw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+// Reflected CRC-32 (IEEE 802.3), table driven
+uint32_t AuditSegmentFormat::Crc32(const void* data, size_t length, uint32_t crc) {
+    static const std::vector<uint32_t> table = [] {
+        std::vector<uint32_t> entries(256);
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++) {
+                value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+            }
+            entries[i] = value;
+        }
+        return entries;
+    }();
+    
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+AuditSegmentWriter::AuditSegmentWriter()
+    : fd(-1), size(0), recordCount(0), firstTimestampUs(0), lastTimestampUs(0) {}
+
+AuditSegmentWriter::~AuditSegmentWriter() {
+    Close();
+}
+
+bool AuditSegmentWriter::Open(const std::string& directory, std::string& error) {
+    Close();
+    
+    if (::mkdir(directory.c_str(), 0750) != 0 && errno != EEXIST) {
+        error = "Failed to create audit segment directory " + directory;
+        return false;
+    }
+    
+    // Zero-padded creation time keeps lexical order chronological
+    int64_t createdUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    while (true) {
+        char name[48];
+        std::snprintf(name, sizeof(name), "/audit-%020lld.seg", static_cast<long long>(createdUs));
+        path = directory + name;
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0640);
+        if (fd >= 0 || errno != EEXIST) {
+            break;
+        }
+        createdUs++;
+    }
+    
+    if (fd < 0) {
+        error = "Failed to create audit segment " + path;
+        return false;
+    }
+    
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.recordSize = sizeof(AuditRecord);
+    header.createdUs = createdUs;
+    
+    std::string out;
+    AppendRaw(out, header);
+    if (!WriteAll(fd, out)) {
+        error = "Failed to write audit segment header";
+        Close();
+        return false;
+    }
+    
+    size = out.size();
+    localIds.clear();
+    localIds.emplace(AuditStringTable::kEmptyId, 0);
+    dictionary.assign(1, std::string());
+    index.clear();
+    postings.clear();
+    recordCount = 0;
+    firstTimestampUs = 0;
+    lastTimestampUs = 0;
+    return true;
+}
+
+void AuditSegmentWriter::WriteBlock(std::string& out, uint32_t type, uint32_t count, const std::string& payload,
+                                    int64_t firstUs, int64_t lastUs, bool indexed) {
+    if (indexed) {
+        IndexEntry entry;
+        entry.offset = size + out.size();
+        entry.count = count;
+        entry.reserved = 0;
+        entry.firstTimestampUs = firstUs;
+        entry.lastTimestampUs = lastUs;
+        index.push_back(entry);
+    }
+    
+    BlockHeader header;
+    header.type = type;
+    header.count = count;
+    header.payloadBytes = static_cast<uint32_t>(payload.size());
+    header.crc = Crc32(payload.data(), payload.size());
+    header.firstTimestampUs = firstUs;
+    header.lastTimestampUs = lastUs;
+    
+    AppendRaw(out, header);
+    out += payload;
+}
+
+bool AuditSegmentWriter::Append(const AuditRecord* records, size_t count, const AuditStringTable& strings) {
+    if (fd < 0 || count == 0) {
+        return fd >= 0;
+    }
+    
+    std::vector<AuditRecord> local(records, records + count);
+    std::string stringPayload;
+    uint32_t newStrings = 0;
+    
+    // Rewrite process-wide ids to segment ids, collecting first sightings
+    auto remap = [&](uint32_t& id) {
+        auto it = localIds.find(id);
+        if (it != localIds.end()) {
+            id = it->second;
+            return;
+        }
+        const std::string& value = strings.Get(id);
+        uint32_t localId = static_cast<uint32_t>(dictionary.size());
+        dictionary.push_back(value);
+        localIds.emplace(id, localId);
+    
+        AppendRaw(stringPayload, static_cast<uint32_t>(value.size()));
+        stringPayload += value;
+        newStrings++;
+        id = localId;
+    };
+    
+    int64_t firstUs = local[0].timestampUs;
+    int64_t lastUs = local[0].timestampUs;
+    for (AuditRecord& record : local) {
+        remap(record.operation);
+        remap(record.keyId);
+        remap(record.userId);
+        firstUs = std::min(firstUs, record.timestampUs);
+        lastUs = std::max(lastUs, record.timestampUs);
+    }
+    
+    // Strings precede the records that use them, so a replay never sees an
+    // unknown id
+    std::string out;
+    if (newStrings > 0) {
+        PadTo8(stringPayload);
+        WriteBlock(out, kStringBlock, newStrings, stringPayload, firstUs, lastUs, false);
+    }
+    uint64_t recordsOffset = size + out.size() + sizeof(BlockHeader);
+    std::string recordPayload(reinterpret_cast<const char*>(local.data()), local.size() * sizeof(AuditRecord));
+    WriteBlock(out, kRecordBlock, static_cast<uint32_t>(count), recordPayload, firstUs, lastUs, true);
+    
+    if (!WriteAll(fd, out)) {
+        return false;
+    }
+    
+    // Empty values are never looked up, so they get no posting list
+    auto post = [&](PostingField field, uint32_t id, uint64_t offset) {
+        if (id != 0) {
+            postings[(static_cast<uint64_t>(field) << 32) | id].push_back(offset);
+        }
+    };
+    for (size_t i = 0; i < count; i++) {
+        uint64_t offset = recordsOffset + i * sizeof(AuditRecord);
+        post(kOperationField, local[i].operation, offset);
+        post(kKeyIdField, local[i].keyId, offset);
+        post(kUserIdField, local[i].userId, offset);
+    }
+    
+    size += out.size();
+    firstTimestampUs = recordCount == 0 ? firstUs : std::min(firstTimestampUs, firstUs);
+    lastTimestampUs = std::max(lastTimestampUs, lastUs);
+    recordCount += count;
+    return true;
+}
+
+bool AuditSegmentWriter::Seal() {
+    if (fd < 0) {
+        return false;
+    }
+    
+    std::string tail;
+    
+    // Dictionary as an offset table for O(1) lookups from the mapping
+    uint64_t dictionaryOffset = size;
+    AppendRaw(tail, static_cast<uint32_t>(dictionary.size()));
+    uint32_t offset = 0;
+    for (const std::string& value : dictionary) {
+        AppendRaw(tail, offset);
+        offset += static_cast<uint32_t>(value.size());
+    }
+    AppendRaw(tail, offset);
+    for (const std::string& value : dictionary) {
+        tail += value;
+    }
+    PadTo8(tail);
+    uint64_t dictionaryBytes = tail.size();
+    
+    uint64_t indexOffset = size + tail.size();
+    for (const IndexEntry& entry : index) {
+        AppendRaw(tail, entry);
+    }
+    uint32_t tailCrc = Crc32(tail.data(), tail.size());
+    
+    // Posting lists sorted by (field, id) for binary search, then their offsets
+    uint64_t postingsOffset = size + tail.size();
+    std::vector<uint64_t> keys;
+    keys.reserve(postings.size());
+    for (const auto& entry : postings) {
+        keys.push_back(entry.first);
+    }
+    std::sort(keys.begin(), keys.end());
+    
+    std::string postingBytes;
+    uint64_t start = 0;
+    for (uint64_t key : keys) {
+        PostingList list;
+        list.field = static_cast<uint32_t>(key >> 32);
+        list.id = static_cast<uint32_t>(key);
+        list.start = start;
+        list.count = postings[key].size();
+        AppendRaw(postingBytes, list);
+        start += list.count;
+    }
+    for (uint64_t key : keys) {
+        const std::vector<uint64_t>& offsets = postings[key];
+        postingBytes.append(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    }
+    tail += postingBytes;
+    
+    Footer footer;
+    footer.dictionaryOffset = dictionaryOffset;
+    footer.dictionaryBytes = dictionaryBytes;
+    footer.indexOffset = indexOffset;
+    footer.blockCount = static_cast<uint32_t>(index.size());
+    footer.crc = tailCrc;
+    footer.postingsOffset = postingsOffset;
+    footer.postingCount = static_cast<uint32_t>(keys.size());
+    footer.postingsCrc = Crc32(postingBytes.data(), postingBytes.size());
+    footer.recordCount = recordCount;
+    footer.firstTimestampUs = firstTimestampUs;
+    footer.lastTimestampUs = lastTimestampUs;
+    std::memcpy(footer.magic, kFooterMagic, sizeof(kFooterMagic));
+    AppendRaw(tail, footer);
+    
+    bool ok = WriteAll(fd, tail) && ::fdatasync(fd) == 0;
+    size += tail.size();
+    Close();
+    return ok;
+}
+
+void AuditSegmentWriter::Close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+AuditSegmentReader::AuditSegmentReader()
+    : data(nullptr), length(0), sealed(false), dictionaryOffsets(nullptr), dictionaryBytes(nullptr),
+      dictionaryCount(0), postingLists(nullptr), postingCount(0), postingOffsets(nullptr), postingOffsetCount(0),
+      postingsCrc(0), postingsState(0), recordCount(0), firstTimestampUs(0), lastTimestampUs(0), corruptBlocks(0) {}
+
+AuditSegmentReader::~AuditSegmentReader() {
+    if (data) {
+        ::munmap(const_cast<uint8_t*>(data), length);
+    }
+}
+
+bool AuditSegmentReader::Open(const std::string& path, std::string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "Failed to open audit segment " + path;
+        return false;
+    }
+    
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        error = "Audit segment is truncated: " + path;
+        return false;
+    }
+    
+    // The active segment keeps growing; the mapping covers what exists now
+    length = static_cast<size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        length = 0;
+        error = "Failed to map audit segment " + path;
+        return false;
+    }
+    data = static_cast<const uint8_t*>(mapping);
+    ::madvise(mapping, length, MADV_SEQUENTIAL);
+    
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.recordSize != sizeof(AuditRecord)) {
+        error = "Not a compatible audit segment: " + path;
+        return false;
+    }
+    
+    // Sealed if the footer is intact and its sections check out
+    if (length >= sizeof(Header) + sizeof(Footer)) {
+        Footer footer;
+        std::memcpy(&footer, data + length - sizeof(Footer), sizeof(Footer));
+        uint64_t tailEnd = length - sizeof(Footer);
+        uint64_t indexBytes = static_cast<uint64_t>(footer.blockCount) * sizeof(IndexEntry);
+        uint64_t listsEnd = footer.postingsOffset + static_cast<uint64_t>(footer.postingCount) * sizeof(PostingList);
+        if (std::memcmp(footer.magic, kFooterMagic, sizeof(kFooterMagic)) == 0 &&
+            footer.dictionaryOffset >= sizeof(Header) && footer.dictionaryOffset % 8 == 0 &&
+            footer.indexOffset == footer.dictionaryOffset + footer.dictionaryBytes &&
+            footer.indexOffset + indexBytes == footer.postingsOffset &&
+            listsEnd <= tailEnd && (tailEnd - listsEnd) % sizeof(uint64_t) == 0 &&
+            Crc32(data + footer.dictionaryOffset, footer.postingsOffset - footer.dictionaryOffset) == footer.crc) {
+            uint32_t count = *reinterpret_cast<const uint32_t*>(data + footer.dictionaryOffset);
+            const uint32_t* offsets = reinterpret_cast<const uint32_t*>(data + footer.dictionaryOffset + sizeof(uint32_t));
+            uint64_t tableBytes = (static_cast<uint64_t>(count) + 2) * sizeof(uint32_t);
+            if (tableBytes > footer.dictionaryBytes || offsets[count] > footer.dictionaryBytes - tableBytes) {
+                error = "Corrupt audit segment dictionary: " + path;
+                return false;
+            }
+            sealed = true;
+            dictionaryCount = count;
+            dictionaryOffsets = offsets;
+            dictionaryBytes = reinterpret_cast<const char*>(offsets + count + 1);
+            const IndexEntry* entries = reinterpret_cast<const IndexEntry*>(data + footer.indexOffset);
+            blocks.assign(entries, entries + footer.blockCount);
+            blockState.assign(blocks.size(), 0);
+            postingLists = reinterpret_cast<const PostingList*>(data + footer.postingsOffset);
+            postingCount = footer.postingCount;
+            postingOffsets = reinterpret_cast<const uint64_t*>(data + listsEnd);
+            postingOffsetCount = (tailEnd - listsEnd) / sizeof(uint64_t);
+            postingsCrc = footer.postingsCrc;
+            recordCount = footer.recordCount;
+            firstTimestampUs = footer.firstTimestampUs;
+            lastTimestampUs = footer.lastTimestampUs;
+            return true;
+        }
+    }
+    
+    Replay();
+    return true;
+}
+
+// Rebuild the dictionary and block list of an unsealed segment. Stops at the
+// first incomplete or corrupt block: with no footer nothing past it can be
+// located reliably.
+void AuditSegmentReader::Replay() {
+    replayedStrings.assign(1, std::string_view());
+    
+    size_t offset = sizeof(Header);
+    while (offset + sizeof(BlockHeader) <= length) {
+        BlockHeader header;
+        std::memcpy(&header, data + offset, sizeof(BlockHeader));
+        const uint8_t* payload = data + offset + sizeof(BlockHeader);
+        if (header.payloadBytes > length - offset - sizeof(BlockHeader) ||
+            Crc32(payload, header.payloadBytes) != header.crc) {
+            break;
+        }
+    
+        if (header.type == kStringBlock) {
+            size_t cursor = 0;
+            for (uint32_t i = 0; i < header.count && cursor + sizeof(uint32_t) <= header.payloadBytes; i++) {
+                uint32_t size;
+                std::memcpy(&size, payload + cursor, sizeof(uint32_t));
+                cursor += sizeof(uint32_t);
+                if (size > header.payloadBytes - cursor) {
+                    break;
+                }
+                replayedStrings.emplace_back(reinterpret_cast<const char*>(payload + cursor), size);
+                cursor += size;
+            }
+        } else if (header.type == kRecordBlock &&
+                   static_cast<uint64_t>(header.count) * sizeof(AuditRecord) <= header.payloadBytes) {
+            IndexEntry entry;
+            entry.offset = offset;
+            entry.count = header.count;
+            entry.reserved = 0;
+            entry.firstTimestampUs = header.firstTimestampUs;
+            entry.lastTimestampUs = header.lastTimestampUs;
+            blocks.push_back(entry);
+            blockState.push_back(1);
+    
+            firstTimestampUs = recordCount == 0 ? header.firstTimestampUs
+                                                : std::min(firstTimestampUs, header.firstTimestampUs);
+            lastTimestampUs = std::max(lastTimestampUs, header.lastTimestampUs);
+            recordCount += header.count;
+        }
+    
+        offset += sizeof(BlockHeader) + header.payloadBytes;
+    }
+}
+
+// Replay already checked unsealed blocks; sealed ones are checked on first
+// touch and the verdict kept for later scans and RecordAt()
+bool AuditSegmentReader::VerifyBlock(size_t block) const {
+    if (blockState[block] != 0) {
+        return blockState[block] > 0;
+    }
+    
+    const IndexEntry& entry = blocks[block];
+    bool good = false;
+    if (entry.offset + sizeof(BlockHeader) <= length) {
+        BlockHeader header;
+        std::memcpy(&header, data + entry.offset, sizeof(BlockHeader));
+        const uint8_t* payload = data + entry.offset + sizeof(BlockHeader);
+        good = header.payloadBytes <= length - entry.offset - sizeof(BlockHeader) &&
+               static_cast<uint64_t>(entry.count) * sizeof(AuditRecord) <= header.payloadBytes &&
+               Crc32(payload, header.payloadBytes) == header.crc;
+    }
+    
+    if (!good) {
+        corruptBlocks++;
+    }
+    blockState[block] = good ? 1 : -1;
+    return good;
+}
+
+void AuditSegmentReader::ForEachBlock(int64_t fromUs, int64_t toUs, const BlockVisitor& visit) const {
+    for (size_t i = 0; i < blocks.size(); i++) {
+        const IndexEntry& entry = blocks[i];
+        if (entry.lastTimestampUs < fromUs || entry.firstTimestampUs > toUs || !VerifyBlock(i)) {
+            continue;
+        }
+    
+        const uint8_t* payload = data + entry.offset + sizeof(BlockHeader);
+        if (!visit(reinterpret_cast<const AuditRecord*>(payload), entry.count)) {
+            return;
+        }
+    }
+}
+
+std::string_view AuditSegmentReader::String(uint32_t id) const {
+    if (sealed) {
+        if (id >= dictionaryCount) {
+            return std::string_view();
+        }
+        return std::string_view(dictionaryBytes + dictionaryOffsets[id], dictionaryOffsets[id + 1] - dictionaryOffsets[id]);
+    }
+    return id < replayedStrings.size() ? replayedStrings[id] : std::string_view();
+}
+
+bool AuditSegmentReader::FindString(std::string_view value, uint32_t& id) const {
+    uint32_t count = sealed ? dictionaryCount : static_cast<uint32_t>(replayedStrings.size());
+    for (uint32_t i = 1; i < count; i++) {
+        if (String(i) == value) {
+            id = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AuditSegmentReader::Postings(uint32_t field, uint32_t id, const uint64_t*& offsets, size_t& count) const {
+    if (!sealed) {
+        return false;
+    }
+    
+    // One CRC pass over the whole section, on the first lookup only
+    if (postingsState == 0) {
+        const uint8_t* begin = reinterpret_cast<const uint8_t*>(postingLists);
+        const uint8_t* end = reinterpret_cast<const uint8_t*>(postingOffsets + postingOffsetCount);
+        postingsState = Crc32(begin, end - begin) == postingsCrc ? 1 : -1;
+    }
+    if (postingsState < 0) {
+        return false;
+    }
+    
+    const PostingList* end = postingLists + postingCount;
+    const PostingList* list = std::lower_bound(postingLists, end, std::make_pair(field, id),
+        [](const PostingList& entry, const std::pair<uint32_t, uint32_t>& key) {
+            return entry.field != key.first ? entry.field < key.first : entry.id < key.second;
+        });
+    
+    offsets = postingOffsets;
+    count = 0;
+    if (list == end || list->field != field || list->id != id) {
+        return true;
+    }
+    if (list->start > postingOffsetCount || list->count > postingOffsetCount - list->start) {
+        return false;
+    }
+    offsets = postingOffsets + list->start;
+    count = static_cast<size_t>(list->count);
+    return true;
+}
+
+const AuditRecord* AuditSegmentReader::RecordAt(uint64_t offset) const {
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), offset,
+        [](uint64_t value, const IndexEntry& entry) { return value < entry.offset; });
+    if (it == blocks.begin()) {
+        return nullptr;
+    }
+    
+    size_t block = static_cast<size_t>(it - blocks.begin()) - 1;
+    uint64_t first = blocks[block].offset + sizeof(BlockHeader);
+    if (offset < first || (offset - first) % sizeof(AuditRecord) != 0 ||
+        (offset - first) / sizeof(AuditRecord) >= blocks[block].count || !VerifyBlock(block)) {
+        return nullptr;
+    }
+    return reinterpret_cast<const AuditRecord*>(data + offset);
+}
+
+std::vector<std::string> AuditSegmentReader::List(const std::string& directory) {
+    std::vector<std::string> paths;
+    DIR* dir = ::opendir(directory.c_str());
+    if (!dir) {
+        return paths;
+    }
+    
+    while (struct dirent* entry = ::readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() > 10 && name.compare(0, 6, "audit-") == 0 && name.compare(name.size() - 4, 4, ".seg") == 0) {
+            paths.push_back(directory + "/" + name);
+        }
+    }
+    ::closedir(dir);
+    
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+} // namespace EnterpriseCrypto
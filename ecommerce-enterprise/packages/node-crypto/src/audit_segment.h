@@ -0,0 +1,207 @@
+#ifndef AUDIT_SEGMENT_H
+#define AUDIT_SEGMENT_H
+
+#include "audit_trail.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+
+namespace EnterpriseCrypto {
+
+// Binary, append-only audit segments.
+//
+// A segment is a header followed by CRC-protected blocks. String blocks add
+// entries to the segment's own dictionary; record blocks hold fixed-width
+// AuditRecords whose string ids refer to that dictionary. Sealing appends
+// the whole dictionary as an offset table, an index of the record blocks
+// and a fixed-size footer, so a sealed segment can be mapped and queried
+// without parsing it. An unsealed segment (the active one, or one left by a
+// crash) is read by replaying its blocks up to the first bad CRC.
+//
+// Sealed segments also carry posting lists: for each operation, keyId and
+// userId in the dictionary, the file offsets of the records that use it.
+//
+// Records are stored in host byte order; segments are not meant to move
+// between architectures.
+namespace AuditSegmentFormat {
+
+const char kMagic[8] = { 'E', 'C', 'A', 'U', 'D', 'S', 'G', '1' };
+const char kFooterMagic[8] = { 'E', 'C', 'A', 'U', 'D', 'E', 'N', 'D' };
+const uint32_t kVersion = 3;
+
+enum BlockType : uint32_t {
+    kStringBlock = 1,
+    kRecordBlock = 2
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    int64_t createdUs;
+};
+
+struct BlockHeader {
+    uint32_t type;
+    uint32_t count;
+    uint32_t payloadBytes; // padded to 8 so records stay aligned in the mapping
+    uint32_t crc;          // CRC-32 of the payload
+    int64_t firstTimestampUs;
+    int64_t lastTimestampUs;
+};
+
+struct IndexEntry {
+    uint64_t offset; // of the BlockHeader
+    uint32_t count;
+    uint32_t reserved;
+    int64_t firstTimestampUs;
+    int64_t lastTimestampUs;
+};
+
+// Record fields with posting lists
+enum PostingField : uint32_t {
+    kOperationField = 0,
+    kKeyIdField = 1,
+    kUserIdField = 2
+};
+
+struct PostingList {
+    uint32_t field;
+    uint32_t id;      // segment dictionary id
+    uint64_t start;   // first entry in the record offset array
+    uint64_t count;
+};
+
+struct Footer {
+    uint64_t dictionaryOffset; // uint32 count, uint32 offsets[count + 1], bytes
+    uint64_t dictionaryBytes;
+    uint64_t indexOffset;
+    uint32_t blockCount;
+    uint32_t crc;              // CRC-32 of dictionary and index sections
+    uint64_t postingsOffset;   // PostingList[postingCount] sorted by (field, id), then uint64 record offsets
+    uint32_t postingCount;
+    uint32_t postingsCrc;      // checked on first use, not on open
+    uint64_t recordCount;
+    int64_t firstTimestampUs;
+    int64_t lastTimestampUs;
+    char magic[8];
+};
+
+uint32_t Crc32(const void* data, size_t length, uint32_t crc = 0);
+
+} // namespace AuditSegmentFormat
+
+// Owned by the audit writer thread; not thread-safe
+class AuditSegmentWriter {
+public:
+    AuditSegmentWriter();
+    ~AuditSegmentWriter();
+    
+    // Create a new segment file in directory, named by its creation time
+    bool Open(const std::string& directory, std::string& error);
+    
+    // Append records (ids from the process string table) as at most one
+    // string block and one record block. Returns false on a write error,
+    // after which the segment should be abandoned.
+    bool Append(const AuditRecord* records, size_t count, const AuditStringTable& strings);
+    
+    // Write dictionary, index, posting lists and footer, then sync and close
+    bool Seal();
+    
+    // Close without sealing
+    void Close();
+    
+    bool IsOpen() const { return fd >= 0; }
+    int Descriptor() const { return fd; }
+    uint64_t Size() const { return size; }
+    const std::string& Path() const { return path; }
+    
+private:
+    void WriteBlock(std::string& out, uint32_t type, uint32_t count, const std::string& payload,
+                    int64_t firstUs, int64_t lastUs, bool indexed);
+    
+    int fd;
+    uint64_t size;
+    std::string path;
+    std::unordered_map<uint32_t, uint32_t> localIds; // process id -> segment id
+    std::vector<std::string> dictionary;
+    std::vector<AuditSegmentFormat::IndexEntry> index;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> postings; // (field << 32 | id) -> record offsets
+    uint64_t recordCount;
+    int64_t firstTimestampUs;
+    int64_t lastTimestampUs;
+};
+
+// Read-only view over one memory-mapped segment
+class AuditSegmentReader {
+public:
+    typedef std::function<bool(const AuditRecord* records, size_t count)> BlockVisitor;
+    
+    AuditSegmentReader();
+    ~AuditSegmentReader();
+    
+    bool Open(const std::string& path, std::string& error);
+    
+    // Visit record blocks that may hold entries in [fromUs, toUs], in file
+    // order; returning false from visit stops the scan. Blocks failing their
+    // CRC are skipped and counted.
+    void ForEachBlock(int64_t fromUs, int64_t toUs, const BlockVisitor& visit) const;
+    
+    // Dictionary lookup for ids found in this segment's records
+    std::string_view String(uint32_t id) const;
+    
+    // Reverse lookup; false if no record in this segment uses value
+    bool FindString(std::string_view value, uint32_t& id) const;
+    
+    // Record offsets for one field value; sealed segments only
+    bool Postings(uint32_t field, uint32_t id, const uint64_t*& offsets, size_t& count) const;
+    
+    // Record at a file offset from Postings(); nullptr if its block is damaged
+    const AuditRecord* RecordAt(uint64_t offset) const;
+    
+    bool IsSealed() const { return sealed; }
+    uint64_t RecordCount() const { return recordCount; }
+    int64_t FirstTimestamp() const { return firstTimestampUs; }
+    int64_t LastTimestamp() const { return lastTimestampUs; }
+    uint64_t Bytes() const { return length; }
+    size_t CorruptBlocks() const { return corruptBlocks; }
+    size_t BlockCount() const { return blocks.size(); }
+    
+    // Segment files in directory, oldest first
+    static std::vector<std::string> List(const std::string& directory);
+    
+private:
+    void Replay();
+    bool VerifyBlock(size_t block) const;
+    
+    const uint8_t* data;
+    size_t length;
+    bool sealed;
+    std::vector<AuditSegmentFormat::IndexEntry> blocks;
+    mutable std::vector<int8_t> blockState; // 0 unchecked, 1 good, -1 damaged
+    
+    // Sealed: offset table in the mapping. Unsealed: views built by Replay().
+    const uint32_t* dictionaryOffsets;
+    const char* dictionaryBytes;
+    uint32_t dictionaryCount;
+    std::vector<std::string_view> replayedStrings;
+    
+    const AuditSegmentFormat::PostingList* postingLists;
+    uint32_t postingCount;
+    const uint64_t* postingOffsets;
+    uint64_t postingOffsetCount;
+    uint32_t postingsCrc;
+    mutable int8_t postingsState;
+    
+    uint64_t recordCount;
+    int64_t firstTimestampUs;
+    int64_t lastTimestampUs;
+    mutable size_t corruptBlocks;
+};
+
+} // namespace EnterpriseCrypto
+
+#endif // AUDIT_SEGMENT_H
@@ -1,22 +1,260 @@
 #include "audit_trail.h"
+#include "audit_segment.h"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <ctime>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace EnterpriseCrypto {
 
 // Static member definitions
-std::vector<AuditEntry> AuditTrail::auditEntries;
-std::mutex AuditTrail::auditMutex;
+AuditRing AuditTrail::auditRing(16384);
+AuditStringTable AuditTrail::auditStrings;
+std::atomic<uint64_t> AuditTrail::clearedBefore(0);
+std::atomic<uint64_t> AuditTrail::truncatedRecords(0);
 std::string AuditTrail::auditFilePath = "./audit.log";
 bool AuditTrail::enableFileLogging = true;
 size_t AuditTrail::maxMemoryEntries = 10000;
 
+namespace {
+
+enum class FsyncMode { None, Interval, Batch };
+
+// State shared between the JS thread and the audit writer thread. The file
+// settings on AuditTrail (path, enabled) are also guarded by mutex.
+struct AuditWriter {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread thread;
+    size_t envCount = 0;
+    bool stopping = false;
+    FsyncMode fsyncMode = FsyncMode::Interval;
+    uint32_t fsyncIntervalMs = 1000;
+    uint32_t flushIntervalMs = 10;
+    bool binary = false;
+    std::string segmentDirectory = "./audit-segments";
+    uint64_t maxSegmentBytes = 64ull << 20;
+    
+    std::atomic<uint64_t> cursor{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> batches{0};
+    std::atomic<uint64_t> fsyncs{0};
+    std::atomic<uint64_t> writeErrors{0};
+    std::atomic<uint64_t> segmentsSealed{0};
+};
+
+AuditWriter writer;
+
+// The writer wakes early once this many entries are waiting
+const uint64_t kWakeThreshold = 1024;
+
+// Upper bound on the entries handed to a single write()
+const size_t kMaxBatchRecords = 4096;
+
+bool WriteFully(int fd, const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t n = ::write(fd, data.data() + offset, data.size() - offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        offset += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+const char* FsyncModeName(FsyncMode mode) {
+    return mode == FsyncMode::None ? "none" : mode == FsyncMode::Batch ? "batch" : "interval";
+}
+
+// Ring positions by interned id, and by timestamp. Position lists are
+// ascending and shed overwritten positions from the front; byTime is kept
+// sorted, which costs little because entries arrive almost in order.
+struct AuditIndex {
+    std::mutex mutex;
+    uint64_t indexedTo = 0;
+    uint64_t prunedAt = 0;
+    std::unordered_map<uint32_t, std::deque<uint64_t>> byUser;
+    std::unordered_map<uint32_t, std::deque<uint64_t>> byKey;
+    std::unordered_map<uint32_t, std::deque<uint64_t>> byOperation;
+    std::deque<std::pair<int64_t, uint64_t>> byTime;
+};
+
+AuditIndex auditIndex;
+
+void PrunePositions(std::unordered_map<uint32_t, std::deque<uint64_t>>& lists, uint64_t oldest) {
+    for (auto it = lists.begin(); it != lists.end();) {
+        std::deque<uint64_t>& positions = it->second;
+        positions.erase(positions.begin(), std::lower_bound(positions.begin(), positions.end(), oldest));
+        it = positions.empty() ? lists.erase(it) : std::next(it);
+    }
+}
+
+// Ids of the query's string filters in one string table (process or segment)
+struct QueryIds {
+    uint32_t user = 0;
+    uint32_t key = 0;
+    uint32_t operation = 0;
+};
+
+// Copy value into a fixed inline field, cutting at a UTF-8 character
+// boundary; true if anything was cut
+bool CopyInline(const std::string& value, char* field, size_t capacity, uint8_t& length) {
+    size_t size = value.size();
+    bool truncated = size > capacity;
+    if (truncated) {
+        size = capacity;
+        while (size > 0 && (static_cast<unsigned char>(value[size]) & 0xC0) == 0x80) {
+            size--;
+        }
+    }
+    std::memcpy(field, value.data(), size);
+    length = static_cast<uint8_t>(size);
+    return truncated;
+}
+
+} // namespace
+
+namespace {
+
+// Never reused, unlike table addresses
+std::atomic<uint64_t> nextTableGeneration{1};
+
+} // namespace
+
+AuditStringTable::AuditStringTable()
+    : count(1), dropped(0), generation(nextTableGeneration.fetch_add(1, std::memory_order_relaxed)) {
+    // Id 0 is the empty string so default-initialized records read back cleanly
+    chunks[0].reset(new std::string[kChunkSize]);
+    ids.emplace(std::string(), kEmptyId);
+}
+
+uint32_t AuditStringTable::Intern(const std::string& value) {
+    if (value.empty()) {
+        return kEmptyId;
+    }
+    
+    // Operations, key ids and user ids repeat constantly; keep recent ones
+    // per thread. Ids never change, so the cache only goes stale when the
+    // thread switches to another table.
+    thread_local std::unordered_map<std::string, uint32_t> cache;
+    thread_local uint64_t cacheGeneration = 0;
+    if (cacheGeneration != generation) {
+        cache.clear();
+        cacheGeneration = generation;
+    }
+    auto cached = cache.find(value);
+    if (cached != cache.end()) {
+        return cached->second;
+    }
+    
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = ids.find(value);
+        if (it != ids.end()) {
+            id = it->second;
+        } else {
+            id = count.load(std::memory_order_relaxed);
+            if (id >= Capacity()) {
+                // Table full; record the entry without this field
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return kEmptyId;
+            }
+            std::unique_ptr<std::string[]>& chunk = chunks[id >> kChunkBits];
+            if (!chunk) {
+                chunk.reset(new std::string[kChunkSize]);
+            }
+            chunk[id & (kChunkSize - 1)] = value;
+            ids.emplace(value, id);
+            count.store(id + 1, std::memory_order_release);
+        }
+    }
+    
+    if (cache.size() >= 4096) {
+        cache.clear();
+    }
+    cache.emplace(value, id);
+    return id;
+}
+
+bool AuditStringTable::Find(const std::string& value, uint32_t& id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ids.find(value);
+    if (it == ids.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+const std::string& AuditStringTable::Get(uint32_t id) const {
+    static const std::string empty;
+    if (id >= Size()) {
+        return empty;
+    }
+    return chunks[id >> kChunkBits][id & (kChunkSize - 1)];
+}
+
+AuditRing::AuditRing(size_t requested) : head(0) {
+    capacity = 1;
+    while (capacity < requested) {
+        capacity <<= 1;
+    }
+    mask = capacity - 1;
+    slots.reset(new Slot[capacity]);
+    for (size_t i = 0; i < capacity; i++) {
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t AuditRing::Append(const AuditRecord& record) {
+    uint64_t pos = head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[pos & mask];
+    
+    // The writer one lap behind must be done with this slot. That only
+    // blocks if a thread stalls mid-write for a whole lap of the ring.
+    uint64_t previous = pos >= capacity ? 2 * (pos - capacity) + 2 : 0;
+    while (slot.sequence.load(std::memory_order_acquire) != previous) {
+        std::this_thread::yield();
+    }
+    
+    slot.sequence.store(2 * pos + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot.record, &record, sizeof(AuditRecord));
+    slot.sequence.store(2 * pos + 2, std::memory_order_release);
+    return pos;
+}
+
+bool AuditRing::Read(uint64_t pos, AuditRecord& out) const {
+    const Slot& slot = slots[pos & mask];
+    uint64_t expected = 2 * pos + 2;
+    if (slot.sequence.load(std::memory_order_acquire) != expected) {
+        return false;
+    }
+    std::memcpy(&out, &slot.record, sizeof(AuditRecord));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
 // Initialize audit trail system
 void AuditTrail::Init(Napi::Env env, Napi::Object exports) {
     // Core audit logging
-    exports.Set("logOperation", Napi::Function::New(env, [](const Napi::CallbackInfo& info) {
+    exports.Set("logOperation", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
         if (info.Length() >= 4) {
             std::string operation = info[0].As<Napi::String>().Utf8Value();
             std::string keyId = info[1].As<Napi::String>().Utf8Value();
@@ -32,7 +270,7 @@ void AuditTrail::Init(Napi::Env env, Napi::Object exports) {
             
             LogOperation(operation, keyId, userId, success, details, sessionId, ipAddress, userAgent, duration, dataSize);
         }
-        return env.Undefined();
+        return info.Env().Undefined();
     }));
     
     // Audit retrieval methods
@@ -41,12 +279,18 @@ void AuditTrail::Init(Napi::Env env, Napi::Object exports) {
     exports.Set("getAuditLogByKey", Napi::Function::New(env, GetAuditLogByKey));
     exports.Set("getAuditLogByOperation", Napi::Function::New(env, GetAuditLogByOperation));
     exports.Set("getAuditLogByTimeRange", Napi::Function::New(env, GetAuditLogByTimeRange));
+    exports.Set("queryAuditLog", Napi::Function::New(env, QueryAuditLog));
     
     // Export methods
     exports.Set("exportAuditLog", Napi::Function::New(env, ExportAuditLog));
     exports.Set("exportAuditLogCSV", Napi::Function::New(env, ExportAuditLogCSV));
     exports.Set("exportAuditLogJSON", Napi::Function::New(env, ExportAuditLogJSON));
     exports.Set("generateComplianceReport", Napi::Function::New(env, GenerateComplianceReport));
+    exports.Set("generateSOXReport", Napi::Function::New(env, ComplianceReporter::GenerateSOXReport));
+    exports.Set("generateGDPRReport", Napi::Function::New(env, ComplianceReporter::GenerateGDPRReport));
+    exports.Set("generateHIPAAReport", Napi::Function::New(env, ComplianceReporter::GenerateHIPAAReport));
+    exports.Set("generatePCIDSSReport", Napi::Function::New(env, ComplianceReporter::GeneratePCIDSSReport));
+    exports.Set("listAuditSegments", Napi::Function::New(env, ListAuditSegments));
     
     // Analysis methods
     exports.Set("analyzeAuditPatterns", Napi::Function::New(env, AnalyzeAuditPatterns));
@@ -61,6 +305,9 @@ void AuditTrail::Init(Napi::Env env, Napi::Object exports) {
     // Configuration methods
     exports.Set("setAuditConfig", Napi::Function::New(env, SetAuditConfig));
     exports.Set("getAuditConfig", Napi::Function::New(env, GetAuditConfig));
+    
+    StartWriter();
+    napi_add_env_cleanup_hook(env, StopWriter, nullptr);
 }
 
 // Log a crypto operation to the audit trail
@@ -74,364 +321,1292 @@ void AuditTrail::LogOperation(const std::string& operation,
                              const std::string& userAgent,
                              double duration,
                              size_t dataSize) {
-    std::lock_guard<std::mutex> lock(auditMutex);
-    
-    AuditEntry entry;
-    entry.timestamp = GetCurrentTimestamp();
-    entry.operation = operation;
-    entry.keyId = keyId;
-    entry.userId = userId;
-    entry.sessionId = sessionId;
-    entry.success = success;
-    entry.details = details;
-    entry.ipAddress = ipAddress;
-    entry.userAgent = userAgent;
-    entry.duration = duration;
-    entry.dataSize = dataSize;
+    AuditRecord record;
+    if (EncodeRecord(auditStrings, operation, keyId, userId, success, details, sessionId, ipAddress, userAgent,
+                     duration, dataSize, record) != 0) {
+        truncatedRecords.fetch_add(1, std::memory_order_relaxed);
+    }
     
-    // Add to memory storage
-    auditEntries.push_back(entry);
+    uint64_t pos = auditRing.Append(record);
     
-    // Maintain memory limit
-    if (auditEntries.size() > maxMemoryEntries) {
-        auditEntries.erase(auditEntries.begin());
+    // The file writer polls on its flush interval; only the entry that
+    // crosses the backlog threshold pays for an early wakeup
+    if (pos - writer.cursor.load(std::memory_order_relaxed) == kWakeThreshold) {
+        writer.wake.notify_one();
     }
+}
+
+uint8_t AuditTrail::EncodeRecord(AuditStringTable& strings,
+                                const std::string& operation,
+                                const std::string& keyId,
+                                const std::string& userId,
+                                bool success,
+                                const std::string& details,
+                                const std::string& sessionId,
+                                const std::string& ipAddress,
+                                const std::string& userAgent,
+                                double duration,
+                                size_t dataSize,
+                                AuditRecord& record) {
+    record.timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.duration = duration;
+    record.dataSize = dataSize;
+    record.operation = strings.Intern(operation);
+    record.keyId = strings.Intern(keyId);
+    record.userId = strings.Intern(userId);
+    record.success = success ? 1 : 0;
+    record.flags = 0;
     
-    // Write to file if enabled
-    if (enableFileLogging) {
-        WriteToFile(entry);
+    if ((record.operation == AuditStringTable::kEmptyId && !operation.empty()) ||
+        (record.keyId == AuditStringTable::kEmptyId && !keyId.empty()) ||
+        (record.userId == AuditStringTable::kEmptyId && !userId.empty())) {
+        record.flags |= AuditRecord::kStringDropped;
+    }
+    if (CopyInline(details, record.details, AuditRecord::kDetailsCapacity, record.detailsLength)) {
+        record.flags |= AuditRecord::kDetailsTruncated;
+    }
+    if (CopyInline(sessionId, record.sessionId, AuditRecord::kSessionIdCapacity, record.sessionIdLength)) {
+        record.flags |= AuditRecord::kSessionIdTruncated;
     }
+    if (CopyInline(ipAddress, record.ipAddress, AuditRecord::kIpAddressCapacity, record.ipAddressLength)) {
+        record.flags |= AuditRecord::kIpAddressTruncated;
+    }
+    if (CopyInline(userAgent, record.userAgent, AuditRecord::kUserAgentCapacity, record.userAgentLength)) {
+        record.flags |= AuditRecord::kUserAgentTruncated;
+    }
+    return record.flags;
 }
 
 // Get current timestamp in ISO format
 std::string AuditTrail::GetCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+    return FormatTimestamp(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// ISO 8601 with millisecond precision, e.g. 2024-05-01T12:00:00.123Z
+std::string AuditTrail::FormatTimestamp(int64_t timestampUs) {
+    std::time_t seconds = static_cast<std::time_t>(timestampUs / 1000000);
+    int64_t ms = (timestampUs / 1000) % 1000;
+    std::tm utc;
+    gmtime_r(&seconds, &utc);
     
-    std::stringstream ss;
-    ss << std::put_time(std::gmtime(&time_t), "%Y-%m-%dT%H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms.count() << 'Z';
+    char buffer[32];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%03dZ", static_cast<int>(ms));
+    return buffer;
+}
+
+// Accepts an ISO 8601 UTC string or epoch milliseconds
+bool AuditTrail::ParseTimestamp(const Napi::Value& value, int64_t& timestampUs) {
+    if (value.IsNumber()) {
+        timestampUs = static_cast<int64_t>(value.As<Napi::Number>().DoubleValue() * 1000.0);
+        return true;
+    }
+    
+    if (!value.IsString()) {
+        return false;
+    }
     
-    return ss.str();
+    std::string text = value.As<Napi::String>().Utf8Value();
+    std::tm utc = {};
+    int ms = 0;
+    int fields = std::sscanf(text.c_str(), "%d-%d-%dT%d:%d:%d.%d",
+                             &utc.tm_year, &utc.tm_mon, &utc.tm_mday,
+                             &utc.tm_hour, &utc.tm_min, &utc.tm_sec, &ms);
+    if (fields < 3) {
+        return false;
+    }
+    utc.tm_year -= 1900;
+    utc.tm_mon -= 1;
+    timestampUs = static_cast<int64_t>(timegm(&utc)) * 1000000 + static_cast<int64_t>(ms) * 1000;
+    return true;
 }
 
-// Format audit entry for display
-std::string AuditTrail::FormatAuditEntry(const AuditEntry& entry) {
-    std::stringstream ss;
-    ss << "[" << entry.timestamp << "] "
-       << "Operation: " << entry.operation << " "
-       << "KeyID: " << entry.keyId << " "
-       << "User: " << entry.userId << " "
-       << "Success: " << (entry.success ? "true" : "false") << " "
-       << "Duration: " << entry.duration << "ms "
-       << "DataSize: " << entry.dataSize << " bytes";
+// Append one text line for the audit file
+void AuditTrail::FormatAuditEntry(const AuditRecord& record, std::string& out) {
+    out += '[';
+    out += FormatTimestamp(record.timestampUs);
+    out += "] Operation: ";
+    out += auditStrings.Get(record.operation);
+    out += " KeyID: ";
+    out += auditStrings.Get(record.keyId);
+    out += " User: ";
+    out += auditStrings.Get(record.userId);
+    
+    char numbers[96];
+    std::snprintf(numbers, sizeof(numbers), " Success: %s Duration: %gms DataSize: %llu bytes",
+                  record.success ? "true" : "false", record.duration,
+                  static_cast<unsigned long long>(record.dataSize));
+    out += numbers;
     
-    if (!entry.details.empty()) {
-        ss << " Details: " << entry.details;
+    if (record.detailsLength > 0) {
+        out += " Details: ";
+        out.append(record.details, record.detailsLength);
+    }
+    if (record.flags != 0) {
+        out += " Truncated: true";
     }
     
-    return ss.str();
+    out += '\n';
 }
 
-// Write audit entry to file
-void AuditTrail::WriteToFile(const AuditEntry& entry) {
-    std::ofstream file(auditFilePath, std::ios::app);
-    if (file.is_open()) {
-        file << FormatAuditEntry(entry) << std::endl;
-        file.close();
+// Start the file writer thread; one thread serves every environment
+void AuditTrail::StartWriter() {
+    std::lock_guard<std::mutex> lock(writer.mutex);
+    if (writer.envCount++ == 0) {
+        writer.stopping = false;
+        writer.thread = std::thread(WriterLoop);
     }
 }
 
-// Get all audit log entries
-Napi::Value AuditTrail::GetAuditLog(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(auditMutex);
+// Env cleanup hook: flush what is left and stop once the last environment exits
+void AuditTrail::StopWriter(void*) {
+    std::thread joinable;
+    {
+        std::lock_guard<std::mutex> lock(writer.mutex);
+        if (--writer.envCount > 0) {
+            return;
+        }
+        writer.stopping = true;
+        joinable.swap(writer.thread);
+    }
+    writer.wake.notify_one();
+    if (joinable.joinable()) {
+        joinable.join();
+    }
+}
+
+// Group commit: every wakeup turns all pending entries into as few write()
+// calls as possible, then syncs according to the configured durability
+void AuditTrail::WriterLoop() {
+    int fd = -1;
+    std::string openPath;
+    AuditSegmentWriter segment;
+    std::string segmentDirectory;
+    bool unsynced = false;
+    auto lastSync = std::chrono::steady_clock::now();
     
-    Napi::Array result = Napi::Array::New(env, auditEntries.size());
+    auto sealSegment = [&]() {
+        if (segment.Seal()) {
+            writer.segmentsSealed++;
+            writer.fsyncs++;
+        } else {
+            writer.writeErrors++;
+        }
+        unsynced = false;
+    };
     
-    for (size_t i = 0; i < auditEntries.size(); i++) {
-        Napi::Object entry = Napi::Object::New(env);
-        entry.Set("timestamp", auditEntries[i].timestamp);
-        entry.Set("operation", auditEntries[i].operation);
-        entry.Set("keyId", auditEntries[i].keyId);
-        entry.Set("userId", auditEntries[i].userId);
-        entry.Set("sessionId", auditEntries[i].sessionId);
-        entry.Set("success", auditEntries[i].success);
-        entry.Set("details", auditEntries[i].details);
-        entry.Set("ipAddress", auditEntries[i].ipAddress);
-        entry.Set("userAgent", auditEntries[i].userAgent);
-        entry.Set("duration", auditEntries[i].duration);
-        entry.Set("dataSize", auditEntries[i].dataSize);
+    std::unique_lock<std::mutex> lock(writer.mutex);
+    while (true) {
+        writer.wake.wait_for(lock, std::chrono::milliseconds(writer.flushIntervalMs), [] {
+            return writer.stopping ||
+                   auditRing.Head() - writer.cursor.load(std::memory_order_relaxed) >= kWakeThreshold;
+        });
         
-        result.Set(i, entry);
+        bool stop = writer.stopping;
+        bool enabled = enableFileLogging;
+        bool binary = writer.binary;
+        std::string path = binary ? writer.segmentDirectory : auditFilePath;
+        uint64_t maxSegmentBytes = writer.maxSegmentBytes;
+        FsyncMode mode = writer.fsyncMode;
+        auto fsyncInterval = std::chrono::milliseconds(writer.fsyncIntervalMs);
+        lock.unlock();
+        
+        // Reopen on a path or format change; descriptors otherwise stay open
+        if (fd >= 0 && (!enabled || binary || path != openPath)) {
+            if (unsynced && mode != FsyncMode::None) {
+                ::fdatasync(fd);
+            }
+            ::close(fd);
+            fd = -1;
+            unsynced = false;
+        }
+        if (segment.IsOpen() && (!enabled || !binary || path != segmentDirectory)) {
+            sealSegment();
+        }
+        if (enabled && !binary && fd < 0) {
+            fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0640);
+            if (fd >= 0) {
+                openPath = path;
+            } else {
+                writer.writeErrors++;
+            }
+        }
+        if (enabled && binary && !segment.IsOpen()) {
+            std::string error;
+            if (segment.Open(path, error)) {
+                segmentDirectory = path;
+            } else {
+                writer.writeErrors++;
+            }
+        }
+        
+        int target = binary ? segment.Descriptor() : fd;
+        if (enabled && target >= 0) {
+            if (DrainToFile(target, mode == FsyncMode::Batch, binary ? &segment : nullptr) > 0 &&
+                mode == FsyncMode::Interval) {
+                unsynced = true;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (unsynced && (stop || now - lastSync >= fsyncInterval)) {
+                if (::fdatasync(target) == 0) {
+                    writer.fsyncs++;
+                }
+                unsynced = false;
+                lastSync = now;
+            }
+            if (binary && segment.IsOpen() && segment.Size() >= maxSegmentBytes) {
+                sealSegment();
+            }
+        } else {
+            // Nothing to write to; skip ahead, counting the loss if logging was wanted
+            uint64_t head = auditRing.Head();
+            uint64_t skipped = head - writer.cursor.exchange(head, std::memory_order_relaxed);
+            if (enabled) {
+                writer.dropped += skipped;
+            }
+        }
+        
+        if (stop) {
+            break;
+        }
+        lock.lock();
+    }
+    
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (segment.IsOpen()) {
+        sealSegment();
+    }
+}
+
+// Write everything between the cursor and the ring head, as text lines to
+// fd or as blocks of the active segment. Returns the number of entries written.
+size_t AuditTrail::DrainToFile(int fd, bool durable, AuditSegmentWriter* segment) {
+    uint64_t cursor = writer.cursor.load(std::memory_order_relaxed);
+    uint64_t head = auditRing.Head();
+    uint64_t capacity = auditRing.Capacity();
+    
+    // Lapped by the producers: the oldest pending entries are already gone
+    if (head - cursor > capacity) {
+        writer.dropped += head - capacity - cursor;
+        cursor = head - capacity;
+    }
+    
+    std::vector<AuditRecord> pending;
+    pending.reserve(std::min<uint64_t>(head - cursor, kMaxBatchRecords));
+    std::string batch;
+    size_t total = 0;
+    
+    auto commit = [&]() {
+        if (pending.empty()) {
+            return;
+        }
+        bool ok;
+        if (segment) {
+            ok = segment->Append(pending.data(), pending.size(), auditStrings);
+        } else {
+            batch.clear();
+            for (const AuditRecord& record : pending) {
+                FormatAuditEntry(record, batch);
+            }
+            ok = WriteFully(fd, batch);
+        }
+        if (ok) {
+            writer.written += pending.size();
+            writer.batches++;
+            total += pending.size();
+            if (durable && ::fdatasync(fd) == 0) {
+                writer.fsyncs++;
+            }
+        } else {
+            writer.writeErrors++;
+            writer.dropped += pending.size();
+        }
+        pending.clear();
+    };
+    
+    AuditRecord record;
+    for (; cursor < head; cursor++) {
+        if (!auditRing.Read(cursor, record)) {
+            if (auditRing.Head() - cursor > capacity) {
+                writer.dropped++;
+                continue;
+            }
+            // Still being written; pick it up on the next pass
+            break;
+        }
+        pending.push_back(record);
+        if (pending.size() >= kMaxBatchRecords) {
+            commit();
+        }
+    }
+    
+    // Advance only once the entries are in the file, so a history scan that
+    // reads the cursor first sees every entry at least once
+    commit();
+    writer.cursor.store(cursor, std::memory_order_release);
+    return total;
+}
+
+void AuditTrail::ScanHistory(int64_t fromUs, int64_t toUs, const HistoryVisitor& visit) {
+    bool segments;
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock(writer.mutex);
+        segments = writer.binary && enableFileLogging;
+        directory = writer.segmentDirectory;
+    }
+    
+    StringResolver global = [](uint32_t id) { return std::string_view(auditStrings.Get(id)); };
+    std::vector<AuditRecord> records;
+    
+    if (!segments) {
+        Snapshot(records);
+        visit(records.data(), records.size(), global);
+        return;
+    }
+    
+    // Read the cursor before the files: entries committed during the scan
+    // may then be visited twice, but none can be missed
+    uint64_t unwritten = writer.cursor.load(std::memory_order_acquire);
+    
+    for (const std::string& path : AuditSegmentReader::List(directory)) {
+        AuditSegmentReader reader;
+        std::string error;
+        if (!reader.Open(path, error) || reader.RecordCount() == 0 ||
+            reader.LastTimestamp() < fromUs || reader.FirstTimestamp() > toUs) {
+            continue;
+        }
+        
+        StringResolver local = [&reader](uint32_t id) { return reader.String(id); };
+        bool more = true;
+        reader.ForEachBlock(fromUs, toUs, [&](const AuditRecord* block, size_t count) {
+            more = visit(block, count, local);
+            return more;
+        });
+        if (!more) {
+            return;
+        }
+    }
+    
+    uint64_t head = auditRing.Head();
+    uint64_t first = std::max(unwritten, head > auditRing.Capacity() ? head - auditRing.Capacity() : 0);
+    AuditRecord record;
+    for (uint64_t pos = first; pos < head; pos++) {
+        if (auditRing.Read(pos, record)) {
+            records.push_back(record);
+        }
+    }
+    visit(records.data(), records.size(), global);
+}
+
+void AuditTrail::AppendCsvRow(const AuditRecord& record, const StringResolver& strings, std::string& out) {
+    out += FormatTimestamp(record.timestampUs);
+    out += ',';
+    out += strings(record.operation);
+    out += ',';
+    out += strings(record.keyId);
+    out += ',';
+    out += strings(record.userId);
+    out += ',';
+    out.append(record.sessionId, record.sessionIdLength);
+    out += record.success ? ",true,\"" : ",false,\"";
+    out.append(record.details, record.detailsLength);
+    out += "\",";
+    out.append(record.ipAddress, record.ipAddressLength);
+    out += ",\"";
+    out.append(record.userAgent, record.userAgentLength);
+    
+    char numbers[72];
+    std::snprintf(numbers, sizeof(numbers), "\",%g,%llu,%s\n", record.duration,
+                  static_cast<unsigned long long>(record.dataSize), record.flags != 0 ? "true" : "false");
+    out += numbers;
+}
+
+namespace {
+
+void AppendJsonString(std::string& out, std::string_view value) {
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+// One JSON object per line (NDJSON)
+void AuditTrail::AppendJsonRow(const AuditRecord& record, const StringResolver& strings, std::string& out) {
+    out += "{\"timestamp\":";
+    AppendJsonString(out, FormatTimestamp(record.timestampUs));
+    out += ",\"operation\":";
+    AppendJsonString(out, strings(record.operation));
+    out += ",\"keyId\":";
+    AppendJsonString(out, strings(record.keyId));
+    out += ",\"userId\":";
+    AppendJsonString(out, strings(record.userId));
+    out += ",\"sessionId\":";
+    AppendJsonString(out, std::string_view(record.sessionId, record.sessionIdLength));
+    out += record.success ? ",\"success\":true" : ",\"success\":false";
+    out += ",\"details\":";
+    AppendJsonString(out, std::string_view(record.details, record.detailsLength));
+    out += ",\"ipAddress\":";
+    AppendJsonString(out, std::string_view(record.ipAddress, record.ipAddressLength));
+    out += ",\"userAgent\":";
+    AppendJsonString(out, std::string_view(record.userAgent, record.userAgentLength));
+    
+    char numbers[112];
+    std::snprintf(numbers, sizeof(numbers), ",\"duration\":%g,\"dataSize\":%llu,\"truncated\":%s}\n",
+                  record.duration, static_cast<unsigned long long>(record.dataSize),
+                  record.flags != 0 ? "true" : "false");
+    out += numbers;
+}
+
+// Copy the retained records, oldest first. Writers are never blocked;
+// slots that are mid-write or get overwritten during the copy are skipped.
+void AuditTrail::Snapshot(std::vector<AuditRecord>& records) {
+    uint64_t head = auditRing.Head();
+    uint64_t retained = std::min<uint64_t>(auditRing.Capacity(), maxMemoryEntries);
+    uint64_t first = head > retained ? head - retained : 0;
+    first = std::max(first, clearedBefore.load(std::memory_order_acquire));
+    
+    records.clear();
+    records.reserve(head - std::min(first, head));
+    
+    AuditRecord record;
+    for (uint64_t pos = first; pos < head; pos++) {
+        if (auditRing.Read(pos, record)) {
+            records.push_back(record);
+        }
     }
+}
+
+AuditEntry AuditTrail::Materialize(const AuditRecord& record) {
+    AuditEntry entry;
+    entry.timestamp = FormatTimestamp(record.timestampUs);
+    entry.operation = auditStrings.Get(record.operation);
+    entry.keyId = auditStrings.Get(record.keyId);
+    entry.userId = auditStrings.Get(record.userId);
+    entry.sessionId.assign(record.sessionId, record.sessionIdLength);
+    entry.success = record.success != 0;
+    entry.details.assign(record.details, record.detailsLength);
+    entry.ipAddress.assign(record.ipAddress, record.ipAddressLength);
+    entry.userAgent.assign(record.userAgent, record.userAgentLength);
+    entry.truncated = record.flags != 0;
+    entry.duration = record.duration;
+    entry.dataSize = record.dataSize;
+    return entry;
+}
+
+Napi::Object AuditTrail::RecordToObject(Napi::Env env, const AuditRecord& record, const StringResolver& strings, bool full) {
+    auto string = [&](uint32_t id) {
+        std::string_view value = strings(id);
+        return Napi::String::New(env, value.data(), value.size());
+    };
     
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("timestamp", FormatTimestamp(record.timestampUs));
+    entry.Set("operation", string(record.operation));
+    entry.Set("keyId", string(record.keyId));
+    entry.Set("userId", string(record.userId));
+    if (full) {
+        entry.Set("sessionId", std::string(record.sessionId, record.sessionIdLength));
+    }
+    entry.Set("success", record.success != 0);
+    if (full) {
+        entry.Set("details", std::string(record.details, record.detailsLength));
+        entry.Set("ipAddress", std::string(record.ipAddress, record.ipAddressLength));
+        entry.Set("userAgent", std::string(record.userAgent, record.userAgentLength));
+    }
+    entry.Set("duration", record.duration);
+    if (full) {
+        entry.Set("dataSize", static_cast<double>(record.dataSize));
+    }
+    if (record.flags != 0) {
+        entry.Set("truncated", true);
+    }
+    return entry;
+}
+
+Napi::Array AuditTrail::RecordsToArray(Napi::Env env, const std::vector<AuditRecord>& records, bool full) {
+    StringResolver strings = [](uint32_t id) { return std::string_view(auditStrings.Get(id)); };
+    Napi::Array result = Napi::Array::New(env, records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        result.Set(i, RecordToObject(env, records[i], strings, full));
+    }
     return result;
 }
 
-// Get audit log by user
+// Get all audit log entries
+Napi::Value AuditTrail::GetAuditLog(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    std::vector<AuditRecord> records;
+    Snapshot(records);
+    return RecordsToArray(env, records, true);
+}
+
+// Get audit log by user; optional { from, to, offset, limit, source }
 Napi::Value AuditTrail::GetAuditLogByUser(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1) {
+    if (info.Length() < 1 || !info[0].IsString()) {
         Napi::TypeError::New(env, "Expected userId parameter").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    std::string userId = info[0].As<Napi::String>().Utf8Value();
-    std::lock_guard<std::mutex> lock(auditMutex);
-    
-    std::vector<AuditEntry> filteredEntries = FilterByUser(auditEntries, userId);
-    Napi::Array result = Napi::Array::New(env, filteredEntries.size());
-    
-    for (size_t i = 0; i < filteredEntries.size(); i++) {
-        Napi::Object entry = Napi::Object::New(env);
-        entry.Set("timestamp", filteredEntries[i].timestamp);
-        entry.Set("operation", filteredEntries[i].operation);
-        entry.Set("keyId", filteredEntries[i].keyId);
-        entry.Set("userId", filteredEntries[i].userId);
-        entry.Set("success", filteredEntries[i].success);
-        entry.Set("duration", filteredEntries[i].duration);
-        
-        result.Set(i, entry);
+    AuditQuery query;
+    if (info.Length() > 1 && !ParseQueryOptions(env, info[1], query)) {
+        return env.Null();
     }
+    query.userId = info[0].As<Napi::String>().Utf8Value();
+    query.byUser = true;
     
-    return result;
+    bool more;
+    return RunQuery(env, query, false, more);
 }
 
-// Get audit log by key
+// Get audit log by key; optional { from, to, offset, limit, source }
 Napi::Value AuditTrail::GetAuditLogByKey(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1) {
+    if (info.Length() < 1 || !info[0].IsString()) {
         Napi::TypeError::New(env, "Expected keyId parameter").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    std::string keyId = info[0].As<Napi::String>().Utf8Value();
-    std::lock_guard<std::mutex> lock(auditMutex);
-    
-    std::vector<AuditEntry> filteredEntries = FilterByKey(auditEntries, keyId);
-    Napi::Array result = Napi::Array::New(env, filteredEntries.size());
-    
-    for (size_t i = 0; i < filteredEntries.size(); i++) {
-        Napi::Object entry = Napi::Object::New(env);
-        entry.Set("timestamp", filteredEntries[i].timestamp);
-        entry.Set("operation", filteredEntries[i].operation);
-        entry.Set("keyId", filteredEntries[i].keyId);
-        entry.Set("userId", filteredEntries[i].userId);
-        entry.Set("success", filteredEntries[i].success);
-        entry.Set("duration", filteredEntries[i].duration);
-        
-        result.Set(i, entry);
+    AuditQuery query;
+    if (info.Length() > 1 && !ParseQueryOptions(env, info[1], query)) {
+        return env.Null();
     }
+    query.keyId = info[0].As<Napi::String>().Utf8Value();
+    query.byKey = true;
     
-    return result;
+    bool more;
+    return RunQuery(env, query, false, more);
 }
 
-// Get audit log by operation
+// Get audit log by operation; optional { from, to, offset, limit, source }
 Napi::Value AuditTrail::GetAuditLogByOperation(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1) {
+    if (info.Length() < 1 || !info[0].IsString()) {
         Napi::TypeError::New(env, "Expected operation parameter").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    std::string operation = info[0].As<Napi::String>().Utf8Value();
-    std::lock_guard<std::mutex> lock(auditMutex);
-    
-    std::vector<AuditEntry> filteredEntries = FilterByOperation(auditEntries, operation);
-    Napi::Array result = Napi::Array::New(env, filteredEntries.size());
-    
-    for (size_t i = 0; i < filteredEntries.size(); i++) {
-        Napi::Object entry = Napi::Object::New(env);
-        entry.Set("timestamp", filteredEntries[i].timestamp);
-        entry.Set("operation", filteredEntries[i].operation);
-        entry.Set("keyId", filteredEntries[i].keyId);
-        entry.Set("userId", filteredEntries[i].userId);
-        entry.Set("success", filteredEntries[i].success);
-        entry.Set("duration", filteredEntries[i].duration);
-        
-        result.Set(i, entry);
+    AuditQuery query;
+    if (info.Length() > 1 && !ParseQueryOptions(env, info[1], query)) {
+        return env.Null();
     }
+    query.operation = info[0].As<Napi::String>().Utf8Value();
+    query.byOperation = true;
     
-    return result;
+    bool more;
+    return RunQuery(env, query, false, more);
 }
 
-// Get audit log by time range
+// Get audit log by time range (inclusive; ISO strings or epoch milliseconds);
+// optional { offset, limit, source }
 Napi::Value AuditTrail::GetAuditLogByTimeRange(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 2) {
+    int64_t startUs = 0;
+    int64_t endUs = 0;
+    if (info.Length() < 2 || !ParseTimestamp(info[0], startUs) || !ParseTimestamp(info[1], endUs)) {
         Napi::TypeError::New(env, "Expected startTime and endTime parameters").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    std::string startTime = info[0].As<Napi::String>().Utf8Value();
-    std::string endTime = info[1].As<Napi::String>().Utf8Value();
-    std::lock_guard<std::mutex> lock(auditMutex);
+    AuditQuery query;
+    if (info.Length() > 2 && !ParseQueryOptions(env, info[2], query)) {
+        return env.Null();
+    }
     
-    std::vector<AuditEntry> filteredEntries = FilterByTimeRange(auditEntries, startTime, endTime);
-    Napi::Array result = Napi::Array::New(env, filteredEntries.size());
+    // Entries are stored with microsecond precision but the bounds are
+    // millisecond strings; include the whole final millisecond
+    query.fromUs = startUs;
+    query.toUs = endUs + 999;
     
-    for (size_t i = 0; i < filteredEntries.size(); i++) {
-        Napi::Object entry = Napi::Object::New(env);
-        entry.Set("timestamp", filteredEntries[i].timestamp);
-        entry.Set("operation", filteredEntries[i].operation);
-        entry.Set("keyId", filteredEntries[i].keyId);
-        entry.Set("userId", filteredEntries[i].userId);
-        entry.Set("success", filteredEntries[i].success);
-        entry.Set("duration", filteredEntries[i].duration);
-        
-        result.Set(i, entry);
+    bool more;
+    return RunQuery(env, query, false, more);
+}
+
+// queryAuditLog({ userId, keyId, operation, success, from, to, offset, limit,
+// source: 'memory' | 'history' }) -> { entries, count, nextOffset }
+Napi::Value AuditTrail::QueryAuditLog(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    AuditQuery query;
+    query.limit = 100;
+    if (info.Length() > 0 && !ParseQueryOptions(env, info[0], query)) {
+        return env.Null();
     }
     
+    bool more;
+    Napi::Array entries = RunQuery(env, query, true, more);
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("entries", entries);
+    result.Set("count", entries.Length());
+    if (more) {
+        result.Set("nextOffset", static_cast<double>(query.offset + entries.Length()));
+    } else {
+        result.Set("nextOffset", env.Null());
+    }
     return result;
 }
 
 // Export audit log as CSV
 Napi::Value AuditTrail::ExportAuditLogCSV(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(auditMutex);
     
-    std::stringstream csv;
-    csv << "Timestamp,Operation,KeyID,UserID,SessionID,Success,Details,IPAddress,UserAgent,Duration,DataSize\n";
+    std::vector<AuditRecord> records;
+    Snapshot(records);
     
-    for (const auto& entry : auditEntries) {
-        csv << entry.timestamp << ","
-            << entry.operation << ","
-            << entry.keyId << ","
-            << entry.userId << ","
-            << entry.sessionId << ","
-            << (entry.success ? "true" : "false") << ","
-            << "\"" << entry.details << "\","
-            << entry.ipAddress << ","
-            << "\"" << entry.userAgent << "\","
-            << entry.duration << ","
-            << entry.dataSize << "\n";
+    StringResolver strings = [](uint32_t id) { return std::string_view(auditStrings.Get(id)); };
+    std::string csv = "Timestamp,Operation,KeyID,UserID,SessionID,Success,Details,IPAddress,UserAgent,Duration,DataSize,Truncated\n";
+    for (const auto& record : records) {
+        AppendCsvRow(record, strings, csv);
     }
     
-    return Napi::String::New(env, csv.str());
+    return Napi::String::New(env, csv);
 }
 
 // Export audit log as JSON
 Napi::Value AuditTrail::ExportAuditLogJSON(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(auditMutex);
-    
-    Napi::Array result = Napi::Array::New(env, auditEntries.size());
-    
-    for (size_t i = 0; i < auditEntries.size(); i++) {
-        Napi::Object entry = Napi::Object::New(env);
-        entry.Set("timestamp", auditEntries[i].timestamp);
-        entry.Set("operation", auditEntries[i].operation);
-        entry.Set("keyId", auditEntries[i].keyId);
-        entry.Set("userId", auditEntries[i].userId);
-        entry.Set("sessionId", auditEntries[i].sessionId);
-        entry.Set("success", auditEntries[i].success);
-        entry.Set("details", auditEntries[i].details);
-        entry.Set("ipAddress", auditEntries[i].ipAddress);
-        entry.Set("userAgent", auditEntries[i].userAgent);
-        entry.Set("duration", auditEntries[i].duration);
-        entry.Set("dataSize", auditEntries[i].dataSize);
-        
-        result.Set(i, entry);
-    }
     
-    return result;
+    std::vector<AuditRecord> records;
+    Snapshot(records);
+    return RecordsToArray(env, records, true);
 }
 
 // Get audit log statistics
 Napi::Value AuditTrail::GetAuditLogStats(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(auditMutex);
+    
+    std::vector<AuditRecord> records;
+    Snapshot(records);
     
     Napi::Object stats = Napi::Object::New(env);
-    stats.Set("totalEntries", auditEntries.size());
+    stats.Set("totalEntries", records.size());
     
-    // Count by operation
-    std::map<std::string, int> operationCounts;
-    std::map<std::string, int> userCounts;
-    int successCount = 0;
+    // Count by interned id; names are resolved once per distinct value
+    std::unordered_map<uint32_t, int> operationCounts;
+    std::unordered_map<uint32_t, int> userCounts;
+    size_t successCount = 0;
     double totalDuration = 0.0;
-    size_t totalDataSize = 0;
+    uint64_t totalDataSize = 0;
     
-    for (const auto& entry : auditEntries) {
-        operationCounts[entry.operation]++;
-        userCounts[entry.userId]++;
-        if (entry.success) successCount++;
-        totalDuration += entry.duration;
-        totalDataSize += entry.dataSize;
+    for (const auto& record : records) {
+        operationCounts[record.operation]++;
+        userCounts[record.userId]++;
+        if (record.success) successCount++;
+        totalDuration += record.duration;
+        totalDataSize += record.dataSize;
     }
     
     stats.Set("successCount", successCount);
-    stats.Set("failureCount", auditEntries.size() - successCount);
-    stats.Set("successRate", auditEntries.size() > 0 ? (double)successCount / auditEntries.size() : 0.0);
-    stats.Set("averageDuration", auditEntries.size() > 0 ? totalDuration / auditEntries.size() : 0.0);
-    stats.Set("totalDataSize", totalDataSize);
+    stats.Set("failureCount", records.size() - successCount);
+    stats.Set("successRate", records.size() > 0 ? (double)successCount / records.size() : 0.0);
+    stats.Set("averageDuration", records.size() > 0 ? totalDuration / records.size() : 0.0);
+    stats.Set("totalDataSize", static_cast<double>(totalDataSize));
     
     // Operation counts
     Napi::Object operationStats = Napi::Object::New(env);
     for (const auto& pair : operationCounts) {
-        operationStats.Set(pair.first, pair.second);
+        operationStats.Set(auditStrings.Get(pair.first), pair.second);
     }
     stats.Set("operationCounts", operationStats);
     
     // User counts
     Napi::Object userStats = Napi::Object::New(env);
     for (const auto& pair : userCounts) {
-        userStats.Set(pair.first, pair.second);
+        userStats.Set(auditStrings.Get(pair.first), pair.second);
     }
     stats.Set("userCounts", userStats);
     
+    stats.Set("capacity", auditRing.Capacity());
+    stats.Set("totalLogged", static_cast<double>(auditRing.Head()));
+    stats.Set("internedStrings", auditStrings.Size());
+    stats.Set("internedStringCapacity", AuditStringTable::Capacity());
+    stats.Set("droppedStrings", static_cast<double>(auditStrings.Dropped()));
+    stats.Set("truncatedEntries", static_cast<double>(truncatedRecords.load(std::memory_order_relaxed)));
+    
+    // File writer
+    stats.Set("queueDepth", static_cast<double>(auditRing.Head() - writer.cursor.load(std::memory_order_relaxed)));
+    stats.Set("droppedEntries", static_cast<double>(writer.dropped.load()));
+    stats.Set("writtenEntries", static_cast<double>(writer.written.load()));
+    stats.Set("writeBatches", static_cast<double>(writer.batches.load()));
+    stats.Set("fsyncCount", static_cast<double>(writer.fsyncs.load()));
+    stats.Set("writeErrors", static_cast<double>(writer.writeErrors.load()));
+    stats.Set("segmentsSealed", static_cast<double>(writer.segmentsSealed.load()));
+    
     return stats;
 }
 
-// Filter helper methods
-std::vector<AuditEntry> AuditTrail::FilterByUser(const std::vector<AuditEntry>& entries, const std::string& userId) {
-    std::vector<AuditEntry> filtered;
-    std::copy_if(entries.begin(), entries.end(), std::back_inserter(filtered),
-                [&userId](const AuditEntry& entry) { return entry.userId == userId; });
-    return filtered;
-}
-
-std::vector<AuditEntry> AuditTrail::FilterByKey(const std::vector<AuditEntry>& entries, const std::string& keyId) {
-    std::vector<AuditEntry> filtered;
-    std::copy_if(entries.begin(), entries.end(), std::back_inserter(filtered),
-                [&keyId](const AuditEntry& entry) { return entry.keyId == keyId; });
-    return filtered;
+bool AuditTrail::ParseQueryOptions(Napi::Env env, Napi::Value value, AuditQuery& query) {
+    if (value.IsUndefined() || value.IsNull()) {
+        return true;
+    }
+    if (!value.IsObject()) {
+        Napi::TypeError::New(env, "Query options must be an object").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    Napi::Object options = value.As<Napi::Object>();
+    auto text = [&](const char* name, std::string& out, bool& set) {
+        Napi::Value field = options.Get(name);
+        if (field.IsUndefined()) {
+            return true;
+        }
+        if (!field.IsString()) {
+            Napi::TypeError::New(env, std::string(name) + " must be a string").ThrowAsJavaScriptException();
+            return false;
+        }
+        out = field.As<Napi::String>().Utf8Value();
+        set = true;
+        return true;
+    };
+    auto count = [&](const char* name, uint64_t& out) {
+        Napi::Value field = options.Get(name);
+        if (field.IsUndefined()) {
+            return true;
+        }
+        if (!field.IsNumber() || field.As<Napi::Number>().DoubleValue() < 0) {
+            Napi::TypeError::New(env, std::string(name) + " must be a non-negative number").ThrowAsJavaScriptException();
+            return false;
+        }
+        out = static_cast<uint64_t>(field.As<Napi::Number>().DoubleValue());
+        return true;
+    };
+    
+    if (!text("userId", query.userId, query.byUser) || !text("keyId", query.keyId, query.byKey) ||
+        !text("operation", query.operation, query.byOperation) ||
+        !count("offset", query.offset) || !count("limit", query.limit)) {
+        return false;
+    }
+    
+    Napi::Value success = options.Get("success");
+    if (success.IsBoolean()) {
+        query.success = success.As<Napi::Boolean>().Value() ? 1 : 0;
+    }
+    
+    Napi::Value from = options.Get("from");
+    Napi::Value to = options.Get("to");
+    if ((!from.IsUndefined() && !ParseTimestamp(from, query.fromUs)) ||
+        (!to.IsUndefined() && !ParseTimestamp(to, query.toUs))) {
+        Napi::TypeError::New(env, "from and to must be ISO 8601 strings or epoch milliseconds").ThrowAsJavaScriptException();
+        return false;
+    }
+    if (!to.IsUndefined()) {
+        query.toUs += 999;
+    }
+    
+    Napi::Value source = options.Get("source");
+    if (!source.IsUndefined()) {
+        std::string name = source.IsString() ? source.As<Napi::String>().Utf8Value() : "";
+        if (name != "memory" && name != "history") {
+            Napi::TypeError::New(env, "source must be 'memory' or 'history'").ThrowAsJavaScriptException();
+            return false;
+        }
+        query.history = name == "history";
+    }
+    return true;
 }
 
-std::vector<AuditEntry> AuditTrail::FilterByOperation(const std::vector<AuditEntry>& entries, const std::string& operation) {
-    std::vector<AuditEntry> filtered;
-    std::copy_if(entries.begin(), entries.end(), std::back_inserter(filtered),
-                [&operation](const AuditEntry& entry) { return entry.operation == operation; });
-    return filtered;
+void AuditTrail::CatchUpIndex() {
+    uint64_t head = auditRing.Head();
+    uint64_t oldest = head > auditRing.Capacity() ? head - auditRing.Capacity() : 0;
+    
+    // Stop at the first slot still being written; it is picked up next time
+    uint64_t pos = std::max(auditIndex.indexedTo, oldest);
+    AuditRecord record;
+    for (; pos < head && auditRing.Read(pos, record); pos++) {
+        auditIndex.byUser[record.userId].push_back(pos);
+        auditIndex.byKey[record.keyId].push_back(pos);
+        auditIndex.byOperation[record.operation].push_back(pos);
+    
+        auto it = auditIndex.byTime.end();
+        while (it != auditIndex.byTime.begin() && std::prev(it)->first > record.timestampUs) {
+            --it;
+        }
+        auditIndex.byTime.emplace(it, record.timestampUs, pos);
+    }
+    auditIndex.indexedTo = pos;
+    
+    // Overwritten positions are pruned once per ring's worth of entries,
+    // which keeps every index within about twice the ring capacity
+    if (oldest >= auditIndex.prunedAt + auditRing.Capacity()) {
+        PrunePositions(auditIndex.byUser, oldest);
+        PrunePositions(auditIndex.byKey, oldest);
+        PrunePositions(auditIndex.byOperation, oldest);
+        auto& byTime = auditIndex.byTime;
+        byTime.erase(std::remove_if(byTime.begin(), byTime.end(),
+                                    [oldest](const std::pair<int64_t, uint64_t>& entry) { return entry.second < oldest; }),
+                     byTime.end());
+        auditIndex.prunedAt = oldest;
+    }
 }
 
-std::vector<AuditEntry> AuditTrail::FilterByTimeRange(const std::vector<AuditEntry>& entries, 
-                                                    const std::string& startTime, 
-                                                    const std::string& endTime) {
-    std::vector<AuditEntry> filtered;
-    std::copy_if(entries.begin(), entries.end(), std::back_inserter(filtered),
-                [&startTime, &endTime](const AuditEntry& entry) { 
-                    return entry.timestamp >= startTime && entry.timestamp <= endTime; 
+// Answer a query from the indexes: posting lists or the time index pick the
+// candidates, and only records that pass every filter become JS objects
+Napi::Array AuditTrail::RunQuery(Napi::Env env, const AuditQuery& query, bool full, bool& more) {
+    Napi::Array out = Napi::Array::New(env);
+    uint32_t emitted = 0;
+    uint64_t skipped = 0;
+    more = false;
+    
+    auto matches = [&query](const AuditRecord& record, const QueryIds& ids) {
+        return (!query.byUser || record.userId == ids.user) &&
+               (!query.byKey || record.keyId == ids.key) &&
+               (!query.byOperation || record.operation == ids.operation) &&
+               (query.success < 0 || record.success == query.success) &&
+               record.timestampUs >= query.fromUs && record.timestampUs <= query.toUs;
+    };
+    // False once the page is full; one extra match sets more
+    auto accept = [&](const AuditRecord& record, const StringResolver& strings) {
+        if (skipped < query.offset) {
+            skipped++;
+            return true;
+        }
+        if (emitted == query.limit) {
+            more = true;
+            return false;
+        }
+        out.Set(emitted++, RecordToObject(env, record, strings, full));
+        return true;
+    };
+    
+    bool segments;
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock(writer.mutex);
+        segments = query.history && writer.binary && enableFileLogging;
+        directory = writer.segmentDirectory;
+    }
+    
+    // Segments first, oldest to newest. Read the cursor before the files, as
+    // ScanHistory does, so nothing committed meanwhile is missed.
+    uint64_t unwritten = writer.cursor.load(std::memory_order_acquire);
+    if (segments) {
+        for (const std::string& path : AuditSegmentReader::List(directory)) {
+            AuditSegmentReader reader;
+            std::string error;
+            if (!reader.Open(path, error) || reader.RecordCount() == 0 ||
+                reader.LastTimestamp() < query.fromUs || reader.FirstTimestamp() > query.toUs) {
+                continue;
+            }
+    
+            // A value missing from the dictionary rules the segment out
+            QueryIds ids;
+            if ((query.byUser && !reader.FindString(query.userId, ids.user)) ||
+                (query.byKey && !reader.FindString(query.keyId, ids.key)) ||
+                (query.byOperation && !reader.FindString(query.operation, ids.operation))) {
+                continue;
+            }
+    
+            StringResolver strings = [&reader](uint32_t id) { return reader.String(id); };
+            bool open = true;
+    
+            // Shortest posting list of the requested fields, if the segment has them
+            const uint64_t* offsets = nullptr;
+            size_t count = SIZE_MAX;
+            bool posted = query.byUser || query.byKey || query.byOperation;
+            auto consider = [&](bool wanted, uint32_t field, uint32_t id) {
+                const uint64_t* listOffsets;
+                size_t listCount;
+                if (!wanted || !posted) {
+                    return;
+                }
+                if (!reader.Postings(field, id, listOffsets, listCount)) {
+                    posted = false;
+                } else if (listCount < count) {
+                    offsets = listOffsets;
+                    count = listCount;
+                }
+            };
+            consider(query.byUser, AuditSegmentFormat::kUserIdField, ids.user);
+            consider(query.byKey, AuditSegmentFormat::kKeyIdField, ids.key);
+            consider(query.byOperation, AuditSegmentFormat::kOperationField, ids.operation);
+    
+            if (posted) {
+                for (size_t i = 0; i < count && open; i++) {
+                    const AuditRecord* record = reader.RecordAt(offsets[i]);
+                    if (record && matches(*record, ids)) {
+                        open = accept(*record, strings);
+                    }
+                }
+            } else {
+                reader.ForEachBlock(query.fromUs, query.toUs, [&](const AuditRecord* block, size_t blockCount) {
+                    for (size_t i = 0; i < blockCount && open; i++) {
+                        if (matches(block[i], ids)) {
+                            open = accept(block[i], strings);
+                        }
+                    }
+                    return open;
                 });
-    return filtered;
+            }
+            if (!open) {
+                return out;
+            }
+        }
+    }
+    
+    // Ring: a string never interned cannot match any entry
+    QueryIds ids;
+    if ((query.byUser && !auditStrings.Find(query.userId, ids.user)) ||
+        (query.byKey && !auditStrings.Find(query.keyId, ids.key)) ||
+        (query.byOperation && !auditStrings.Find(query.operation, ids.operation))) {
+        return out;
+    }
+    
+    StringResolver strings = [](uint32_t id) { return std::string_view(auditStrings.Get(id)); };
+    std::lock_guard<std::mutex> lock(auditIndex.mutex);
+    CatchUpIndex();
+    
+    uint64_t head = auditRing.Head();
+    uint64_t first = head > auditRing.Capacity() ? head - auditRing.Capacity() : 0;
+    if (segments) {
+        first = std::max(first, unwritten);
+    } else {
+        uint64_t retained = std::min<uint64_t>(auditRing.Capacity(), maxMemoryEntries);
+        first = std::max({ first, head > retained ? head - retained : 0, clearedBefore.load(std::memory_order_acquire) });
+    }
+    
+    AuditRecord record;
+    auto visit = [&](uint64_t pos) {
+        if (pos < first || !auditRing.Read(pos, record) || !matches(record, ids)) {
+            return true;
+        }
+        return accept(record, strings);
+    };
+    
+    // Shortest posting list among the requested fields, else the time index
+    const std::deque<uint64_t>* positions = nullptr;
+    bool empty = false;
+    auto consider = [&](bool wanted, std::unordered_map<uint32_t, std::deque<uint64_t>>& index, uint32_t id) {
+        if (!wanted) {
+            return;
+        }
+        auto it = index.find(id);
+        if (it == index.end()) {
+            empty = true;
+        } else if (!positions || it->second.size() < positions->size()) {
+            positions = &it->second;
+        }
+    };
+    consider(query.byUser, auditIndex.byUser, ids.user);
+    consider(query.byKey, auditIndex.byKey, ids.key);
+    consider(query.byOperation, auditIndex.byOperation, ids.operation);
+    
+    bool open = true;
+    if (empty) {
+        // Nothing indexed yet; only the unindexed tail can match
+    } else if (positions) {
+        for (auto it = std::lower_bound(positions->begin(), positions->end(), first);
+             it != positions->end() && open; ++it) {
+            open = visit(*it);
+        }
+    } else if (query.fromUs != INT64_MIN || query.toUs != INT64_MAX) {
+        const auto& byTime = auditIndex.byTime;
+        for (auto it = std::lower_bound(byTime.begin(), byTime.end(), std::make_pair(query.fromUs, uint64_t(0)));
+             it != byTime.end() && it->first <= query.toUs && open; ++it) {
+            open = visit(it->second);
+        }
+    } else {
+        for (uint64_t pos = first; pos < auditIndex.indexedTo && open; pos++) {
+            open = visit(pos);
+        }
+    }
+    
+    // Entries logged after the catch-up that are not in the indexes yet
+    for (uint64_t pos = std::max(first, auditIndex.indexedTo); pos < head && open; pos++) {
+        open = visit(pos);
+    }
+    return out;
 }
 
-// Placeholder implementations for other methods
+// exportAuditLog(path, { format: 'csv' | 'ndjson', from, to }) streams the
+// whole history to a file in one sequential pass
 Napi::Value AuditTrail::ExportAuditLog(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    return Napi::String::New(env, "Audit log export not implemented");
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected output path").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string path = info[0].As<Napi::String>().Utf8Value();
+    bool json = false;
+    int64_t fromUs = INT64_MIN;
+    int64_t toUs = INT64_MAX;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        Napi::Value format = options.Get("format");
+        if (format.IsString()) {
+            std::string name = format.As<Napi::String>().Utf8Value();
+            if (name != "csv" && name != "ndjson") {
+                Napi::TypeError::New(env, "format must be 'csv' or 'ndjson'").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            json = name == "ndjson";
+        }
+        if (!options.Get("from").IsUndefined()) {
+            ParseTimestamp(options.Get("from"), fromUs);
+        }
+        if (!options.Get("to").IsUndefined() && ParseTimestamp(options.Get("to"), toUs)) {
+            toUs += 999;
+        }
+    }
+    
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        Napi::Error::New(env, "Failed to open " + path).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string out;
+    if (!json) {
+        out = "Timestamp,Operation,KeyID,UserID,SessionID,Success,Details,IPAddress,UserAgent,Duration,DataSize,Truncated\n";
+    }
+    uint64_t exported = 0;
+    uint64_t bytes = 0;
+    
+    ScanHistory(fromUs, toUs, [&](const AuditRecord* records, size_t count, const StringResolver& strings) {
+        for (size_t i = 0; i < count; i++) {
+            if (records[i].timestampUs < fromUs || records[i].timestampUs > toUs) {
+                continue;
+            }
+            json ? AppendJsonRow(records[i], strings, out) : AppendCsvRow(records[i], strings, out);
+            exported++;
+        }
+        if (out.size() >= (1 << 20)) {
+            file.write(out.data(), out.size());
+            bytes += out.size();
+            out.clear();
+        }
+        return file.good();
+    });
+    
+    file.write(out.data(), out.size());
+    bytes += out.size();
+    file.close();
+    
+    if (file.fail()) {
+        Napi::Error::New(env, "Failed to write " + path).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("path", path);
+    result.Set("records", static_cast<double>(exported));
+    result.Set("bytes", static_cast<double>(bytes));
+    return result;
 }
 
+// generateComplianceReport(standard = 'SOX', { from, to, maxViolations })
 Napi::Value AuditTrail::GenerateComplianceReport(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    return Napi::String::New(env, "Compliance report not implemented");
+    
+    std::string standard = info.Length() > 0 && info[0].IsString() ? info[0].As<Napi::String>().Utf8Value() : "SOX";
+    if (standard != "SOX" && standard != "GDPR" && standard != "HIPAA" && standard != "PCI-DSS") {
+        Napi::TypeError::New(env, "standard must be SOX, GDPR, HIPAA or PCI-DSS").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return BuildComplianceReport(env, standard, info.Length() > 1 ? info[1] : env.Undefined());
+}
+
+// Aggregate in a single pass; only failed entries are materialized, up to
+// maxViolations of them
+Napi::Object AuditTrail::BuildComplianceReport(Napi::Env env, const std::string& standard, Napi::Value options) {
+    int64_t fromUs = INT64_MIN;
+    int64_t toUs = INT64_MAX;
+    size_t maxViolations = 100;
+    if (options.IsObject()) {
+        Napi::Object config = options.As<Napi::Object>();
+        if (!config.Get("from").IsUndefined()) {
+            ParseTimestamp(config.Get("from"), fromUs);
+        }
+        if (!config.Get("to").IsUndefined() && ParseTimestamp(config.Get("to"), toUs)) {
+            toUs += 999;
+        }
+        if (config.Get("maxViolations").IsNumber()) {
+            maxViolations = config.Get("maxViolations").As<Napi::Number>().Uint32Value();
+        }
+    }
+    
+    struct Violation {
+        std::string operation;
+        int64_t timestampUs;
+        std::string details;
+    };
+    
+    uint64_t total = 0;
+    uint64_t failed = 0;
+    int64_t firstSeen = INT64_MAX;
+    int64_t lastSeen = INT64_MIN;
+    std::vector<Violation> violations;
+    
+    ScanHistory(fromUs, toUs, [&](const AuditRecord* records, size_t count, const StringResolver& strings) {
+        for (size_t i = 0; i < count; i++) {
+            const AuditRecord& record = records[i];
+            if (record.timestampUs < fromUs || record.timestampUs > toUs) {
+                continue;
+            }
+            total++;
+            firstSeen = std::min(firstSeen, record.timestampUs);
+            lastSeen = std::max(lastSeen, record.timestampUs);
+            if (!record.success) {
+                failed++;
+                if (violations.size() < maxViolations) {
+                    violations.push_back(Violation{ std::string(strings(record.operation)), record.timestampUs,
+                                                    std::string(record.details, record.detailsLength) });
+                }
+            }
+        }
+        return true;
+    });
+    
+    bool segments;
+    FsyncMode fsyncMode;
+    {
+        std::lock_guard<std::mutex> lock(writer.mutex);
+        segments = writer.binary && enableFileLogging;
+        fsyncMode = writer.fsyncMode;
+    }
+    
+    Napi::Object report = Napi::Object::New(env);
+    report.Set("standard", standard);
+    
+    Napi::Object period = Napi::Object::New(env);
+    period.Set("start", total > 0 ? FormatTimestamp(fromUs != INT64_MIN ? fromUs : firstSeen) : "");
+    period.Set("end", total > 0 ? FormatTimestamp(toUs != INT64_MAX ? toUs : lastSeen) : "");
+    report.Set("period", period);
+    
+    Napi::Object summary = Napi::Object::New(env);
+    summary.Set("totalOperations", static_cast<double>(total));
+    summary.Set("compliantOperations", static_cast<double>(total - failed));
+    summary.Set("violations", static_cast<double>(failed));
+    summary.Set("complianceRate", total > 0 ? static_cast<double>(total - failed) / total : 1.0);
+    report.Set("summary", summary);
+    
+    Napi::Array violationList = Napi::Array::New(env, violations.size());
+    for (size_t i = 0; i < violations.size(); i++) {
+        const Violation& violation = violations[i];
+        const std::string& operation = violation.operation;
+        bool authentication = operation.find("decrypt") != std::string::npos ||
+                              operation.find("verify") != std::string::npos ||
+                              operation.find("Verify") != std::string::npos;
+        bool keyManagement = operation.find("Key") != std::string::npos ||
+                             operation.find("rotate") != std::string::npos;
+        
+        Napi::Object entry = Napi::Object::New(env);
+        entry.Set("operation", operation);
+        entry.Set("violation", authentication ? "Authentication failed" : "Operation failed");
+        entry.Set("severity", keyManagement ? "critical" : authentication ? "high" : "medium");
+        entry.Set("timestamp", FormatTimestamp(violation.timestampUs));
+        entry.Set("details", violation.details);
+        violationList.Set(i, entry);
+    }
+    report.Set("violations", violationList);
+    
+    std::vector<std::vector<std::string>> recommendations;
+    if (total > 0 && failed * 100 > total) {
+        recommendations.push_back({ "operations", "Investigate failed cryptographic operations (failure rate above 1%)", "high" });
+    }
+    if (writer.dropped.load() > 0) {
+        recommendations.push_back({ "audit-capacity", "Audit entries were dropped before reaching disk; lower flushIntervalMs or reduce log volume", "high" });
+    }
+    if (standard == "SOX" && fsyncMode != FsyncMode::Batch) {
+        recommendations.push_back({ "audit-durability", "Set audit fsync to 'batch' so every committed entry is durable", "high" });
+    }
+    if (!segments) {
+        recommendations.push_back({ "audit-retention", "Enable binary audit segments to report beyond the in-memory window", "medium" });
+    }
+    
+    Napi::Array recommendationList = Napi::Array::New(env, recommendations.size());
+    for (size_t i = 0; i < recommendations.size(); i++) {
+        Napi::Object entry = Napi::Object::New(env);
+        entry.Set("area", recommendations[i][0]);
+        entry.Set("recommendation", recommendations[i][1]);
+        entry.Set("priority", recommendations[i][2]);
+        recommendationList.Set(i, entry);
+    }
+    report.Set("recommendations", recommendationList);
+    report.Set("generatedAt", GetCurrentTimestamp());
+    report.Set("source", segments ? "segments" : "memory");
+    
+    return report;
+}
+
+// listAuditSegments() -> [{ path, sealed, records, firstTimestamp, lastTimestamp, bytes, blocks }]
+Napi::Value AuditTrail::ListAuditSegments(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock(writer.mutex);
+        directory = writer.segmentDirectory;
+    }
+    
+    std::vector<std::string> paths = AuditSegmentReader::List(directory);
+    Napi::Array result = Napi::Array::New(env);
+    uint32_t index = 0;
+    for (const std::string& path : paths) {
+        AuditSegmentReader reader;
+        std::string error;
+        if (!reader.Open(path, error)) {
+            continue;
+        }
+        Napi::Object segment = Napi::Object::New(env);
+        segment.Set("path", path);
+        segment.Set("sealed", reader.IsSealed());
+        segment.Set("records", static_cast<double>(reader.RecordCount()));
+        segment.Set("firstTimestamp", reader.RecordCount() > 0 ? FormatTimestamp(reader.FirstTimestamp()) : "");
+        segment.Set("lastTimestamp", reader.RecordCount() > 0 ? FormatTimestamp(reader.LastTimestamp()) : "");
+        segment.Set("bytes", static_cast<double>(reader.Bytes()));
+        segment.Set("blocks", reader.BlockCount());
+        result.Set(index++, segment);
+    }
+    
+    return result;
+}
+
+// Standard-specific entry points over the same single-pass report
+Napi::Value ComplianceReporter::GenerateSOXReport(const Napi::CallbackInfo& info) {
+    return AuditTrail::BuildComplianceReport(info.Env(), "SOX", info.Length() > 0 ? info[0] : info.Env().Undefined());
+}
+
+Napi::Value ComplianceReporter::GenerateGDPRReport(const Napi::CallbackInfo& info) {
+    return AuditTrail::BuildComplianceReport(info.Env(), "GDPR", info.Length() > 0 ? info[0] : info.Env().Undefined());
+}
+
+Napi::Value ComplianceReporter::GenerateHIPAAReport(const Napi::CallbackInfo& info) {
+    return AuditTrail::BuildComplianceReport(info.Env(), "HIPAA", info.Length() > 0 ? info[0] : info.Env().Undefined());
+}
+
+Napi::Value ComplianceReporter::GeneratePCIDSSReport(const Napi::CallbackInfo& info) {
+    return AuditTrail::BuildComplianceReport(info.Env(), "PCI-DSS", info.Length() > 0 ? info[0] : info.Env().Undefined());
 }
 
 Napi::Value AuditTrail::AnalyzeAuditPatterns(const Napi::CallbackInfo& info) {
@@ -451,8 +1626,8 @@ Napi::Value AuditTrail::GetSecurityMetrics(const Napi::CallbackInfo& info) {
 
 Napi::Value AuditTrail::ClearAuditLog(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(auditMutex);
-    auditEntries.clear();
+    // Records are not freed, just hidden from readers; the ring reuses them
+    clearedBefore.store(auditRing.Head(), std::memory_order_release);
     return Napi::Boolean::New(env, true);
 }
 
@@ -461,17 +1636,98 @@ Napi::Value AuditTrail::ArchiveAuditLog(const Napi::CallbackInfo& info) {
     return Napi::Boolean::New(env, true);
 }
 
+// setAuditConfig({ fileLogging, filePath, maxMemoryEntries, fsync, fsyncIntervalMs, flushIntervalMs,
+//                  format, segmentDirectory, maxSegmentBytes }).
+// fsync is 'none', 'interval' (every fsyncIntervalMs) or 'batch' (after every
+// group commit, for SOX-level durability). format 'binary' writes rotating
+// AuditSegments to segmentDirectory instead of text lines to filePath.
 Napi::Value AuditTrail::SetAuditConfig(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Expected audit config object").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object config = info[0].As<Napi::Object>();
+    Napi::Value fsync = config.Get("fsync");
+    FsyncMode mode = writer.fsyncMode;
+    if (fsync.IsString()) {
+        std::string name = fsync.As<Napi::String>().Utf8Value();
+        if (name == "none") {
+            mode = FsyncMode::None;
+        } else if (name == "interval") {
+            mode = FsyncMode::Interval;
+        } else if (name == "batch") {
+            mode = FsyncMode::Batch;
+        } else {
+            Napi::TypeError::New(env, "fsync must be 'none', 'interval' or 'batch'").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    
+    // -1 keeps the current format
+    int binary = -1;
+    Napi::Value format = config.Get("format");
+    if (format.IsString()) {
+        std::string name = format.As<Napi::String>().Utf8Value();
+        if (name != "text" && name != "binary") {
+            Napi::TypeError::New(env, "format must be 'text' or 'binary'").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        binary = name == "binary" ? 1 : 0;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(writer.mutex);
+        writer.fsyncMode = mode;
+        
+        if (config.Get("fileLogging").IsBoolean()) {
+            enableFileLogging = config.Get("fileLogging").As<Napi::Boolean>().Value();
+        }
+        if (config.Get("filePath").IsString()) {
+            auditFilePath = config.Get("filePath").As<Napi::String>().Utf8Value();
+        }
+        if (config.Get("fsyncIntervalMs").IsNumber()) {
+            writer.fsyncIntervalMs = std::max(1u, config.Get("fsyncIntervalMs").As<Napi::Number>().Uint32Value());
+        }
+        if (config.Get("flushIntervalMs").IsNumber()) {
+            writer.flushIntervalMs = std::max(1u, config.Get("flushIntervalMs").As<Napi::Number>().Uint32Value());
+        }
+        if (binary >= 0) {
+            writer.binary = binary == 1;
+        }
+        if (config.Get("segmentDirectory").IsString()) {
+            writer.segmentDirectory = config.Get("segmentDirectory").As<Napi::String>().Utf8Value();
+        }
+        if (config.Get("maxSegmentBytes").IsNumber()) {
+            writer.maxSegmentBytes = std::max<uint64_t>(1 << 20, config.Get("maxSegmentBytes").As<Napi::Number>().Int64Value());
+        }
+    }
+    
+    // Bounded by the ring; only read on the JS thread
+    if (config.Get("maxMemoryEntries").IsNumber()) {
+        size_t entries = config.Get("maxMemoryEntries").As<Napi::Number>().Uint32Value();
+        maxMemoryEntries = std::max<size_t>(1, std::min(entries, auditRing.Capacity()));
+    }
+    
+    writer.wake.notify_one();
     return Napi::Boolean::New(env, true);
 }
 
 Napi::Value AuditTrail::GetAuditConfig(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     Napi::Object config = Napi::Object::New(env);
+    std::lock_guard<std::mutex> lock(writer.mutex);
     config.Set("fileLogging", enableFileLogging);
     config.Set("filePath", auditFilePath);
     config.Set("maxMemoryEntries", maxMemoryEntries);
+    config.Set("fsync", FsyncModeName(writer.fsyncMode));
+    config.Set("fsyncIntervalMs", writer.fsyncIntervalMs);
+    config.Set("flushIntervalMs", writer.flushIntervalMs);
+    config.Set("format", writer.binary ? "binary" : "text");
+    config.Set("segmentDirectory", writer.segmentDirectory);
+    config.Set("maxSegmentBytes", static_cast<double>(writer.maxSegmentBytes));
     return config;
 }
 
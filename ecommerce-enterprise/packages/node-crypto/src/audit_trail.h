@@ -7,6 +7,12 @@
 #include <chrono>
 #include <mutex>
 #include <fstream>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include <functional>
+#include <string_view>
 
 namespace EnterpriseCrypto {
 
@@ -23,8 +29,109 @@ struct AuditEntry {
     std::string userAgent;
     double duration;
     size_t dataSize;
+    bool truncated;   // a field was cut or dropped when the entry was logged
 };
 
+// Compact in-memory audit record. Operation, key id and user id repeat
+// constantly and are interned in AuditStringTable; the per-request strings
+// are truncated inline so a record never owns heap memory and can be copied
+// with memcpy. Anything cut or dropped sets a bit in flags.
+struct AuditRecord {
+    static constexpr size_t kDetailsCapacity = 94;
+    static constexpr size_t kSessionIdCapacity = 64;
+    static constexpr size_t kIpAddressCapacity = 46;
+    static constexpr size_t kUserAgentCapacity = 128;
+    
+    enum Flags : uint8_t {
+        kDetailsTruncated = 1 << 0,
+        kSessionIdTruncated = 1 << 1,
+        kIpAddressTruncated = 1 << 2,
+        kUserAgentTruncated = 1 << 3,
+        kStringDropped = 1 << 4   // string table was full
+    };
+    
+    int64_t timestampUs;
+    double duration;
+    uint64_t dataSize;
+    uint32_t operation;
+    uint32_t keyId;
+    uint32_t userId;
+    uint8_t success;
+    uint8_t flags;
+    uint8_t detailsLength;
+    uint8_t sessionIdLength;
+    uint8_t ipAddressLength;
+    uint8_t userAgentLength;
+    char details[kDetailsCapacity];
+    char sessionId[kSessionIdCapacity];
+    char ipAddress[kIpAddressCapacity];
+    char userAgent[kUserAgentCapacity];
+};
+
+// Append-only string interner. Ids are stable for the life of the process
+// and Get() is lock-free: strings live in fixed chunks that never move, and
+// an id is only handed out after its string is published.
+class AuditStringTable {
+public:
+    static constexpr uint32_t kEmptyId = 0;
+    
+    AuditStringTable();
+    
+    // Id for value, adding it if needed. Threads keep a small cache in front
+    // of the shared map so the common case takes no lock.
+    uint32_t Intern(const std::string& value);
+    bool Find(const std::string& value, uint32_t& id);
+    const std::string& Get(uint32_t id) const;
+    uint32_t Size() const { return count.load(std::memory_order_acquire); }
+    static constexpr uint32_t Capacity() { return kChunkSize * kMaxChunks; }
+    
+    // Values that were not stored because the table was full
+    uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+    
+private:
+    static constexpr uint32_t kChunkBits = 10;
+    static constexpr uint32_t kChunkSize = 1u << kChunkBits;
+    static constexpr uint32_t kMaxChunks = 1024;
+    
+    std::unique_ptr<std::string[]> chunks[kMaxChunks];
+    std::atomic<uint32_t> count;
+    std::atomic<uint64_t> dropped;
+    uint64_t generation;    // tags the per-thread cache with its table
+    std::mutex mutex;
+    std::unordered_map<std::string, uint32_t> ids;
+};
+
+// Fixed-capacity multi-producer ring of the most recent audit records.
+// Writers claim a position with one fetch_add and publish through a per-slot
+// sequence number; readers copy slots optimistically and drop any that were
+// rewritten underneath them, so neither side ever waits on the other.
+class AuditRing {
+public:
+    explicit AuditRing(size_t capacity);
+    
+    uint64_t Append(const AuditRecord& record);
+    
+    // Copy the record written at position pos; false if it is still being
+    // written or has already been overwritten
+    bool Read(uint64_t pos, AuditRecord& out) const;
+    
+    uint64_t Head() const { return head.load(std::memory_order_acquire); }
+    size_t Capacity() const { return capacity; }
+    
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence; // 2*pos+1 while writing, 2*pos+2 once published
+        AuditRecord record;
+    };
+    
+    size_t capacity;
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<uint64_t> head;
+};
+
+class AuditSegmentWriter;
+
 // Audit trail manager for compliance and security
 class AuditTrail {
 public:
@@ -42,18 +149,39 @@ public:
                            double duration = 0.0,
                            size_t dataSize = 0);
     
+    // Fill record as LogOperation would, interning into strings; returns
+    // the record's truncation flags. Lets callers such as the benchmark
+    // write into a private ring and table.
+    static uint8_t EncodeRecord(AuditStringTable& strings,
+                                const std::string& operation,
+                                const std::string& keyId,
+                                const std::string& userId,
+                                bool success,
+                                const std::string& details,
+                                const std::string& sessionId,
+                                const std::string& ipAddress,
+                                const std::string& userAgent,
+                                double duration,
+                                size_t dataSize,
+                                AuditRecord& record);
+    
     // Audit trail retrieval
     static Napi::Value GetAuditLog(const Napi::CallbackInfo& info);
     static Napi::Value GetAuditLogByUser(const Napi::CallbackInfo& info);
     static Napi::Value GetAuditLogByKey(const Napi::CallbackInfo& info);
     static Napi::Value GetAuditLogByOperation(const Napi::CallbackInfo& info);
     static Napi::Value GetAuditLogByTimeRange(const Napi::CallbackInfo& info);
+    static Napi::Value QueryAuditLog(const Napi::CallbackInfo& info);
     
     // Audit trail export and compliance
     static Napi::Value ExportAuditLog(const Napi::CallbackInfo& info);
     static Napi::Value ExportAuditLogCSV(const Napi::CallbackInfo& info);
     static Napi::Value ExportAuditLogJSON(const Napi::CallbackInfo& info);
     static Napi::Value GenerateComplianceReport(const Napi::CallbackInfo& info);
+    static Napi::Value ListAuditSegments(const Napi::CallbackInfo& info);
+    
+    // Report for one standard over the full history (segments when enabled)
+    static Napi::Object BuildComplianceReport(Napi::Env env, const std::string& standard, Napi::Value options);
     
     // Audit trail analysis
     static Napi::Value AnalyzeAuditPatterns(const Napi::CallbackInfo& info);
@@ -71,26 +199,69 @@ public:
     
 private:
     // Internal storage and management
-    static std::vector<AuditEntry> auditEntries;
-    static std::mutex auditMutex;
+    static AuditRing auditRing;
+    static AuditStringTable auditStrings;
+    static std::atomic<uint64_t> clearedBefore;
+    static std::atomic<uint64_t> truncatedRecords;
     static std::string auditFilePath;
     static bool enableFileLogging;
     static size_t maxMemoryEntries;
     
     // Helper methods
     static std::string GetCurrentTimestamp();
-    static std::string FormatAuditEntry(const AuditEntry& entry);
-    static void WriteToFile(const AuditEntry& entry);
+    static std::string FormatTimestamp(int64_t timestampUs);
+    static bool ParseTimestamp(const Napi::Value& value, int64_t& timestampUs);
+    static void FormatAuditEntry(const AuditRecord& record, std::string& out);
     static void LoadAuditLogFromFile();
     static void SaveAuditLogToFile();
     
-    // Analysis helpers
-    static std::vector<AuditEntry> FilterByUser(const std::vector<AuditEntry>& entries, const std::string& userId);
-    static std::vector<AuditEntry> FilterByKey(const std::vector<AuditEntry>& entries, const std::string& keyId);
-    static std::vector<AuditEntry> FilterByOperation(const std::vector<AuditEntry>& entries, const std::string& operation);
-    static std::vector<AuditEntry> FilterByTimeRange(const std::vector<AuditEntry>& entries, 
-                                                   const std::string& startTime, 
-                                                   const std::string& endTime);
+    // Background file writer. It follows the ring with its own cursor, so the
+    // ring doubles as the write queue; entries it is lapped on are dropped.
+    // In binary mode it writes AuditSegments instead of text lines.
+    static void StartWriter();
+    static void StopWriter(void* arg);
+    static void WriterLoop();
+    static size_t DrainToFile(int fd, bool durable, AuditSegmentWriter* segment);
+    
+    // Sequential scan over the whole history: sealed and active segments,
+    // then entries not yet written, or just the in-memory ring when segments
+    // are off. Blocks are passed as they are; visitors filter by time.
+    typedef std::function<std::string_view(uint32_t)> StringResolver;
+    typedef std::function<bool(const AuditRecord* records, size_t count, const StringResolver& strings)> HistoryVisitor;
+    static void ScanHistory(int64_t fromUs, int64_t toUs, const HistoryVisitor& visit);
+    static void AppendCsvRow(const AuditRecord& record, const StringResolver& strings, std::string& out);
+    static void AppendJsonRow(const AuditRecord& record, const StringResolver& strings, std::string& out);
+    
+    // Ring buffer readers
+    static void Snapshot(std::vector<AuditRecord>& records);
+    static AuditEntry Materialize(const AuditRecord& record);
+    static Napi::Object RecordToObject(Napi::Env env, const AuditRecord& record, const StringResolver& strings, bool full);
+    static Napi::Array RecordsToArray(Napi::Env env, const std::vector<AuditRecord>& records, bool full);
+    
+    // Indexed queries. Filters are ANDed; offset/limit page through matches
+    // in storage order. Memory queries cover the retained ring entries,
+    // history queries the segments plus entries not yet written.
+    struct AuditQuery {
+        std::string userId;
+        std::string keyId;
+        std::string operation;
+        bool byUser = false;
+        bool byKey = false;
+        bool byOperation = false;
+        int success = -1; // -1 any, 0 failures, 1 successes
+        int64_t fromUs = INT64_MIN;
+        int64_t toUs = INT64_MAX;
+        uint64_t offset = 0;
+        uint64_t limit = UINT64_MAX;
+        bool history = false;
+    };
+    static bool ParseQueryOptions(Napi::Env env, Napi::Value options, AuditQuery& query);
+    static Napi::Array RunQuery(Napi::Env env, const AuditQuery& query, bool full, bool& more);
+    
+    // Secondary indexes over ring positions (user, key, operation, time).
+    // Queries bring them up to date before reading, so logging never touches
+    // them. Caller holds the index mutex.
+    static void CatchUpIndex();
     
     // Compliance helpers
     static bool IsCompliantOperation(const std::string& operation);
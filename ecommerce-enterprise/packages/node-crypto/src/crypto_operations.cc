@@ -1,23 +1,61 @@
 #include "crypto_operations.h"
+#include "key_handle.h"
+#include "hash_engine.h"
+#include "kdf_pool.h"
+#include "random_pool.h"
+#include "signature_engine.h"
 #include "audit_trail.h"
 #include "performance_monitor.h"
 #include <chrono>
+#include <climits>
+#include <cstring>
+#include <openssl/crypto.h>
 #include <sstream>
 #include <iomanip>
 
 namespace EnterpriseCrypto {
 
+namespace {
+
+// Metric slots for this file's operations, resolved once at load
+const uint32_t kEncryptAES256GCMMetric = PerformanceMonitor::RegisterOperation("encryptAES256GCM");
+const uint32_t kDecryptAES256GCMMetric = PerformanceMonitor::RegisterOperation("decryptAES256GCM");
+const uint32_t kEncryptAES256GCMIntoMetric = PerformanceMonitor::RegisterOperation("encryptAES256GCMInto");
+const uint32_t kDecryptAES256GCMIntoMetric = PerformanceMonitor::RegisterOperation("decryptAES256GCMInto");
+const uint32_t kEncryptAES256GCMBatchMetric = PerformanceMonitor::RegisterOperation("encryptAES256GCMBatch");
+const uint32_t kDecryptAES256GCMBatchMetric = PerformanceMonitor::RegisterOperation("decryptAES256GCMBatch");
+const uint32_t kSignDataMetric = PerformanceMonitor::RegisterOperation("signData");
+const uint32_t kVerifySignatureMetric = PerformanceMonitor::RegisterOperation("verifySignature");
+const uint32_t kHashDataMetric = PerformanceMonitor::RegisterOperation("hashData");
+const uint32_t kHmacDataMetric = PerformanceMonitor::RegisterOperation("hmacData");
+const uint32_t kVerifyHMACMetric = PerformanceMonitor::RegisterOperation("verifyHMAC");
+const uint32_t kHashDataBatchMetric = PerformanceMonitor::RegisterOperation("hashDataBatch");
+const uint32_t kHmacDataBatchMetric = PerformanceMonitor::RegisterOperation("hmacDataBatch");
+const uint32_t kEncryptAES256GCMAsyncMetric = PerformanceMonitor::RegisterOperation("encryptAES256GCMAsync");
+const uint32_t kDecryptAES256GCMAsyncMetric = PerformanceMonitor::RegisterOperation("decryptAES256GCMAsync");
+
+} // namespace
+
 // Initialize all crypto operations
 void CryptoOperations::Init(Napi::Env env, Napi::Object exports) {
     // Core crypto operations
     exports.Set("encryptAES256GCM", Napi::Function::New(env, EncryptAES256GCM));
     exports.Set("decryptAES256GCM", Napi::Function::New(env, DecryptAES256GCM));
+    exports.Set("encryptAES256GCMAsync", Napi::Function::New(env, EncryptAES256GCMAsync));
+    exports.Set("decryptAES256GCMAsync", Napi::Function::New(env, DecryptAES256GCMAsync));
+    exports.Set("encryptAES256GCMInto", Napi::Function::New(env, EncryptAES256GCMInto));
+    exports.Set("decryptAES256GCMInto", Napi::Function::New(env, DecryptAES256GCMInto));
+    exports.Set("encryptAES256GCMBatch", Napi::Function::New(env, EncryptAES256GCMBatch));
+    exports.Set("decryptAES256GCMBatch", Napi::Function::New(env, DecryptAES256GCMBatch));
     exports.Set("generateKeyPair", Napi::Function::New(env, GenerateKeyPair));
     exports.Set("generateSecretKey", Napi::Function::New(env, GenerateSecretKey));
     exports.Set("signData", Napi::Function::New(env, SignData));
     exports.Set("verifySignature", Napi::Function::New(env, VerifySignature));
     exports.Set("hashData", Napi::Function::New(env, HashData));
     exports.Set("hmacData", Napi::Function::New(env, HMACData));
+    exports.Set("verifyHMAC", Napi::Function::New(env, VerifyHMAC));
+    exports.Set("hashDataBatch", Napi::Function::New(env, HashDataBatch));
+    exports.Set("hmacDataBatch", Napi::Function::New(env, HMACDataBatch));
     exports.Set("deriveKey", Napi::Function::New(env, DeriveKey));
     exports.Set("deriveKeyFromPassword", Napi::Function::New(env, DeriveKeyFromPassword));
     exports.Set("generateRandomBytes", Napi::Function::New(env, GenerateRandomBytes));
@@ -28,6 +66,7 @@ void CryptoOperations::Init(Napi::Env env, Napi::Object exports) {
     exports.Set("validateKey", Napi::Function::New(env, ValidateKey));
     exports.Set("exportKey", Napi::Function::New(env, ExportKey));
     exports.Set("importKey", Napi::Function::New(env, ImportKey));
+    exports.Set("createKeyHandle", Napi::Function::New(env, CreateKeyHandle));
     
     // Performance and security
     exports.Set("getPerformanceMetrics", Napi::Function::New(env, GetPerformanceMetrics));
@@ -40,8 +79,7 @@ void CryptoOperations::Init(Napi::Env env, Napi::Object exports) {
 Napi::Value CryptoOperations::EncryptAES256GCM(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 3) {
-        Napi::TypeError::New(env, "Expected data, key, and iv").ThrowAsJavaScriptException();
+    if (!ValidateAES256GCMArgs(info, false)) {
         return env.Null();
     }
     
@@ -53,78 +91,126 @@ Napi::Value CryptoOperations::EncryptAES256GCM(const Napi::CallbackInfo& info) {
         Napi::Buffer<uint8_t> key = info[1].As<Napi::Buffer<uint8_t>>();
         Napi::Buffer<uint8_t> iv = info[2].As<Napi::Buffer<uint8_t>>();
         
-        if (key.Length() != 32) {
-            Napi::TypeError::New(env, "Key must be 32 bytes for AES-256").ThrowAsJavaScriptException();
+        // Encrypt straight into the Buffer handed back to JS
+        Napi::Buffer<uint8_t> output = Napi::Buffer<uint8_t>::New(env, data.Length());
+        uint8_t tag[16];
+        std::string error;
+        if (!RunAES256GCMEncrypt(key.Data(), iv.Data(), data.Data(), data.Length(),
+                                 output.Data(), tag, error)) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
             return env.Null();
         }
         
-        if (iv.Length() != 12) {
-            Napi::TypeError::New(env, "IV must be 12 bytes for GCM").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+        // Calculate performance metrics
+        auto end = std::chrono::high_resolution_clock::now();
+        double duration = std::chrono::duration<double, std::milli>(end - start).count();
         
-        // Initialize OpenSSL context
-        EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-        if (!ctx) {
-            Napi::Error::New(env, "Failed to create cipher context").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+        // Record performance metrics
+        RecordPerformanceMetric(kEncryptAES256GCMMetric, duration, data.Length());
         
-        // Initialize encryption
-        if (EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, key.Data(), iv.Data()) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            Napi::Error::New(env, "Failed to initialize encryption").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+        // Log audit trail
+        std::string keyId = GetKeyId(key.Data(), key.Length());
+        LogCryptoOperation("encryptAES256GCM", keyId, duration);
         
-        // Encrypt data
-        std::vector<uint8_t> ciphertext(data.Length());
-        int len;
-        if (EVP_EncryptUpdate(ctx, ciphertext.data(), &len, data.Data(), data.Length()) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            Napi::Error::New(env, "Failed to encrypt data").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+        return CreateEncryptionResult(env, output, tag, iv, keyId, duration, data.Length());
         
-        // Finalize encryption
-        int finalLen;
-        if (EVP_EncryptFinal_ex(ctx, ciphertext.data() + len, &finalLen) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            Napi::Error::New(env, "Failed to finalize encryption").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+// High-performance AES-256-GCM decryption
+Napi::Value CryptoOperations::DecryptAES256GCM(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!ValidateAES256GCMArgs(info, true)) {
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    try {
+        // Extract parameters
+        Napi::Buffer<uint8_t> ciphertext = info[0].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> key = info[1].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> iv = info[2].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> tag = info[3].As<Napi::Buffer<uint8_t>>();
         
-        // Get authentication tag
-        uint8_t tag[16];
-        if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, 16, tag) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            Napi::Error::New(env, "Failed to get authentication tag").ThrowAsJavaScriptException();
+        // Decrypt and authenticate straight into the Buffer handed back to JS
+        Napi::Buffer<uint8_t> output = Napi::Buffer<uint8_t>::New(env, ciphertext.Length());
+        std::string error;
+        if (!RunAES256GCMDecrypt(key.Data(), iv.Data(), ciphertext.Data(), ciphertext.Length(),
+                                 tag.Data(), output.Data(), error)) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
             return env.Null();
         }
         
-        EVP_CIPHER_CTX_free(ctx);
-        
         // Calculate performance metrics
         auto end = std::chrono::high_resolution_clock::now();
         double duration = std::chrono::duration<double, std::milli>(end - start).count();
         
         // Record performance metrics
-        RecordPerformanceMetric("encryptAES256GCM", duration, data.Length());
+        RecordPerformanceMetric(kDecryptAES256GCMMetric, duration, ciphertext.Length());
         
         // Log audit trail
-        std::string keyId = "key_" + std::to_string(std::hash<std::string>{}(std::string(key.Data(), key.Data() + key.Length())));
-        LogCryptoOperation("encryptAES256GCM", keyId, duration);
+        std::string keyId = GetKeyId(key.Data(), key.Length());
+        LogCryptoOperation("decryptAES256GCM", keyId, duration);
+        
+        return CreateDecryptionResult(env, output, keyId, duration, ciphertext.Length());
+        
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+// AES-256-GCM encryption into a caller-owned buffer.
+// Arguments: out, offset, data, key, iv. The ciphertext is written to
+// out[offset, offset + data.length); out may be data itself for in-place
+// encryption but must not otherwise overlap it.
+Napi::Value CryptoOperations::EncryptAES256GCMInto(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    size_t offset = 0;
+    if (!ValidateAES256GCMIntoArgs(info, false, offset)) {
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    try {
+        Napi::Buffer<uint8_t> out = info[0].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> data = info[2].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> key = info[3].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> iv = info[4].As<Napi::Buffer<uint8_t>>();
+        
+        uint8_t tag[16];
+        std::string error;
+        if (!RunAES256GCMEncrypt(key.Data(), iv.Data(), data.Data(), data.Length(),
+                                 out.Data() + offset, tag, error)) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        
+        auto end = std::chrono::high_resolution_clock::now();
+        double duration = std::chrono::duration<double, std::milli>(end - start).count();
+        
+        RecordPerformanceMetric(kEncryptAES256GCMIntoMetric, duration, data.Length());
+        std::string keyId = GetKeyId(key.Data(), key.Length());
+        LogCryptoOperation("encryptAES256GCMInto", keyId, duration);
         
-        // Create result object
         Napi::Object result = Napi::Object::New(env);
-        result.Set("ciphertext", Napi::Buffer<uint8_t>::Copy(env, ciphertext.data(), len + finalLen));
+        result.Set("bytesWritten", data.Length());
         result.Set("tag", Napi::Buffer<uint8_t>::Copy(env, tag, 16));
         result.Set("iv", iv);
         result.Set("algorithm", "aes-256-gcm");
         result.Set("keyId", keyId);
-        result.Set("performance", Napi::Object::New(env));
-        result.Get("performance").As<Napi::Object>().Set("duration", duration);
-        result.Get("performance").As<Napi::Object>().Set("dataSize", data.Length());
+        
+        Napi::Object performance = Napi::Object::New(env);
+        performance.Set("duration", duration);
+        performance.Set("dataSize", data.Length());
+        result.Set("performance", performance);
         
         return result;
         
@@ -134,100 +220,112 @@ Napi::Value CryptoOperations::EncryptAES256GCM(const Napi::CallbackInfo& info) {
     }
 }
 
-// High-performance AES-256-GCM decryption
-Napi::Value CryptoOperations::DecryptAES256GCM(const Napi::CallbackInfo& info) {
+// AES-256-GCM decryption into a caller-owned buffer.
+// Arguments: out, offset, ciphertext, key, iv, tag. On authentication
+// failure the written range is wiped before the error is thrown.
+Napi::Value CryptoOperations::DecryptAES256GCMInto(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 4) {
-        Napi::TypeError::New(env, "Expected ciphertext, key, iv, and tag").ThrowAsJavaScriptException();
+    size_t offset = 0;
+    if (!ValidateAES256GCMIntoArgs(info, true, offset)) {
         return env.Null();
     }
     
     auto start = std::chrono::high_resolution_clock::now();
     
     try {
-        // Extract parameters
-        Napi::Buffer<uint8_t> ciphertext = info[0].As<Napi::Buffer<uint8_t>>();
-        Napi::Buffer<uint8_t> key = info[1].As<Napi::Buffer<uint8_t>>();
-        Napi::Buffer<uint8_t> iv = info[2].As<Napi::Buffer<uint8_t>>();
-        Napi::Buffer<uint8_t> tag = info[3].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> out = info[0].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> ciphertext = info[2].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> key = info[3].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> iv = info[4].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> tag = info[5].As<Napi::Buffer<uint8_t>>();
         
-        if (key.Length() != 32) {
-            Napi::TypeError::New(env, "Key must be 32 bytes for AES-256").ThrowAsJavaScriptException();
+        std::string error;
+        if (!RunAES256GCMDecrypt(key.Data(), iv.Data(), ciphertext.Data(), ciphertext.Length(),
+                                 tag.Data(), out.Data() + offset, error)) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
             return env.Null();
         }
         
-        if (iv.Length() != 12) {
-            Napi::TypeError::New(env, "IV must be 12 bytes for GCM").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double duration = std::chrono::duration<double, std::milli>(end - start).count();
         
-        if (tag.Length() != 16) {
-            Napi::TypeError::New(env, "Tag must be 16 bytes for GCM").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+        RecordPerformanceMetric(kDecryptAES256GCMIntoMetric, duration, ciphertext.Length());
+        std::string keyId = GetKeyId(key.Data(), key.Length());
+        LogCryptoOperation("decryptAES256GCMInto", keyId, duration);
         
-        // Initialize OpenSSL context
-        EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-        if (!ctx) {
-            Napi::Error::New(env, "Failed to create cipher context").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("bytesWritten", ciphertext.Length());
+        result.Set("algorithm", "aes-256-gcm");
+        result.Set("keyId", keyId);
         
-        // Initialize decryption
-        if (EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, key.Data(), iv.Data()) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            Napi::Error::New(env, "Failed to initialize decryption").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+        Napi::Object performance = Napi::Object::New(env);
+        performance.Set("duration", duration);
+        performance.Set("dataSize", ciphertext.Length());
+        result.Set("performance", performance);
         
-        // Set authentication tag
-        if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, 16, tag.Data()) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            Napi::Error::New(env, "Failed to set authentication tag").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+        return result;
         
-        // Decrypt data
-        std::vector<uint8_t> plaintext(ciphertext.Length());
-        int len;
-        if (EVP_DecryptUpdate(ctx, plaintext.data(), &len, ciphertext.Data(), ciphertext.Length()) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            Napi::Error::New(env, "Failed to decrypt data").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+// Batched AES-256-GCM encryption.
+// Arguments: data (all plaintexts back to back), offsets (Uint32Array of
+// recordCount + 1 boundaries into data), key, ivs (recordCount * 12 bytes).
+// The output buffer holds the ciphertexts at the same offsets as the input,
+// followed by recordCount 16-byte tags starting at tagOffset.
+Napi::Value CryptoOperations::EncryptAES256GCMBatch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    size_t recordCount = 0;
+    if (!ValidateAES256GCMBatchArgs(info, false, recordCount)) {
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    try {
+        Napi::Buffer<uint8_t> data = info[0].As<Napi::Buffer<uint8_t>>();
+        Napi::Uint32Array offsets = info[1].As<Napi::Uint32Array>();
+        Napi::Buffer<uint8_t> key = info[2].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> ivs = info[3].As<Napi::Buffer<uint8_t>>();
         
-        // Finalize decryption
-        int finalLen;
-        int result = EVP_DecryptFinal_ex(ctx, plaintext.data() + len, &finalLen);
-        EVP_CIPHER_CTX_free(ctx);
+        size_t dataLength = offsets[recordCount];
+        Napi::Buffer<uint8_t> output = Napi::Buffer<uint8_t>::New(env, dataLength + recordCount * 16);
         
-        if (result != 1) {
-            Napi::Error::New(env, "Failed to finalize decryption - authentication failed").ThrowAsJavaScriptException();
+        size_t failedCount = 0;
+        std::string error;
+        if (!RunAES256GCMBatch(false, key.Data(), data.Data(), offsets.Data(), recordCount,
+                               ivs.Data(), output.Data(), output.Data() + dataLength,
+                               nullptr, failedCount, error)) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
             return env.Null();
         }
         
-        // Calculate performance metrics
         auto end = std::chrono::high_resolution_clock::now();
         double duration = std::chrono::duration<double, std::milli>(end - start).count();
         
-        // Record performance metrics
-        RecordPerformanceMetric("decryptAES256GCM", duration, ciphertext.Length());
+        // One metric and one audit entry per batch, not per record
+        RecordPerformanceMetric(kEncryptAES256GCMBatchMetric, duration, dataLength);
+        std::string keyId = GetKeyId(key.Data(), key.Length());
+        LogCryptoOperation("encryptAES256GCMBatch", keyId, duration);
         
-        // Log audit trail
-        std::string keyId = "key_" + std::to_string(std::hash<std::string>{}(std::string(key.Data(), key.Data() + key.Length())));
-        LogCryptoOperation("decryptAES256GCM", keyId, duration);
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("output", output);
+        result.Set("tagOffset", dataLength);
+        result.Set("recordCount", recordCount);
+        result.Set("algorithm", "aes-256-gcm");
+        result.Set("keyId", keyId);
         
-        // Create result object
-        Napi::Object resultObj = Napi::Object::New(env);
-        resultObj.Set("plaintext", Napi::Buffer<uint8_t>::Copy(env, plaintext.data(), len + finalLen));
-        resultObj.Set("algorithm", "aes-256-gcm");
-        resultObj.Set("keyId", keyId);
-        resultObj.Set("performance", Napi::Object::New(env));
-        resultObj.Get("performance").As<Napi::Object>().Set("duration", duration);
-        resultObj.Get("performance").As<Napi::Object>().Set("dataSize", ciphertext.Length());
+        Napi::Object performance = Napi::Object::New(env);
+        performance.Set("duration", duration);
+        performance.Set("dataSize", dataLength);
+        result.Set("performance", performance);
         
-        return resultObj;
+        return result;
         
     } catch (const std::exception& e) {
         Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
@@ -235,50 +333,61 @@ Napi::Value CryptoOperations::DecryptAES256GCM(const Napi::CallbackInfo& info) {
     }
 }
 
-// Generate high-quality random bytes
-Napi::Value CryptoOperations::GenerateRandomBytes(const Napi::CallbackInfo& info) {
+// Batched AES-256-GCM decryption.
+// Arguments: ciphertext, offsets, key, ivs as for encryption plus tags
+// (recordCount * 16 bytes). A record that fails authentication does not abort
+// the batch: its plaintext range is zeroed and failures[i] is set to 1.
+Napi::Value CryptoOperations::DecryptAES256GCMBatch(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1) {
-        Napi::TypeError::New(env, "Expected length parameter").ThrowAsJavaScriptException();
+    size_t recordCount = 0;
+    if (!ValidateAES256GCMBatchArgs(info, true, recordCount)) {
         return env.Null();
     }
     
     auto start = std::chrono::high_resolution_clock::now();
     
     try {
-        int length = info[0].As<Napi::Number>().Int32Value();
-        
-        if (length <= 0 || length > 1024 * 1024) { // Max 1MB
-            Napi::TypeError::New(env, "Length must be between 1 and 1048576").ThrowAsJavaScriptException();
-            return env.Null();
-        }
+        Napi::Buffer<uint8_t> ciphertext = info[0].As<Napi::Buffer<uint8_t>>();
+        Napi::Uint32Array offsets = info[1].As<Napi::Uint32Array>();
+        Napi::Buffer<uint8_t> key = info[2].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> ivs = info[3].As<Napi::Buffer<uint8_t>>();
+        Napi::Buffer<uint8_t> tags = info[4].As<Napi::Buffer<uint8_t>>();
         
-        std::vector<uint8_t> randomBytes(length);
+        size_t dataLength = offsets[recordCount];
+        Napi::Buffer<uint8_t> plaintext = Napi::Buffer<uint8_t>::New(env, dataLength);
+        Napi::Uint8Array failures = Napi::Uint8Array::New(env, recordCount);
         
-        if (RAND_bytes(randomBytes.data(), length) != 1) {
-            Napi::Error::New(env, "Failed to generate random bytes").ThrowAsJavaScriptException();
+        size_t failedCount = 0;
+        std::string error;
+        if (!RunAES256GCMBatch(true, key.Data(), ciphertext.Data(), offsets.Data(), recordCount,
+                               ivs.Data(), plaintext.Data(), tags.Data(),
+                               failures.Data(), failedCount, error)) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
             return env.Null();
         }
         
-        // Calculate performance metrics
         auto end = std::chrono::high_resolution_clock::now();
         double duration = std::chrono::duration<double, std::milli>(end - start).count();
         
-        // Record performance metrics
-        RecordPerformanceMetric("generateRandomBytes", duration, length);
-        
-        // Log audit trail
-        LogCryptoOperation("generateRandomBytes", "system", duration);
+        RecordPerformanceMetric(kDecryptAES256GCMBatchMetric, duration, dataLength);
+        std::string keyId = GetKeyId(key.Data(), key.Length());
+        AuditLogger::LogOperation("decryptAES256GCMBatch", keyId, "system", failedCount == 0,
+                                  "Duration: " + std::to_string(duration) + "ms, Records: " +
+                                  std::to_string(recordCount) + ", AuthFailures: " + std::to_string(failedCount));
         
-        // Create result object
         Napi::Object result = Napi::Object::New(env);
-        result.Set("randomBytes", Napi::Buffer<uint8_t>::Copy(env, randomBytes.data(), length));
-        result.Set("length", length);
-        result.Set("entropy", "high");
-        result.Set("performance", Napi::Object::New(env));
-        result.Get("performance").As<Napi::Object>().Set("duration", duration);
-        result.Get("performance").As<Napi::Object>().Set("dataSize", length);
+        result.Set("plaintext", plaintext);
+        result.Set("failures", failures);
+        result.Set("failedCount", failedCount);
+        result.Set("recordCount", recordCount);
+        result.Set("algorithm", "aes-256-gcm");
+        result.Set("keyId", keyId);
+        
+        Napi::Object performance = Napi::Object::New(env);
+        performance.Set("duration", duration);
+        performance.Set("dataSize", dataLength);
+        result.Set("performance", performance);
         
         return result;
         
@@ -288,6 +397,144 @@ Napi::Value CryptoOperations::GenerateRandomBytes(const Napi::CallbackInfo& info
     }
 }
 
+// Runs one AES-256-GCM pass on the libuv threadpool and settles a promise with
+// the same result object the synchronous entry points return. Key, IV and tag
+// are copied into the worker; the input buffer is pinned with a persistent
+// reference and must not be mutated by the caller until the promise settles.
+class AES256GCMWorker : public Napi::AsyncWorker {
+public:
+    AES256GCMWorker(Napi::Env env, bool decrypt,
+                    Napi::Buffer<uint8_t> input,
+                    Napi::Buffer<uint8_t> key,
+                    Napi::Buffer<uint8_t> iv,
+                    const uint8_t* tag)
+        : Napi::AsyncWorker(env, decrypt ? "decryptAES256GCMAsync" : "encryptAES256GCMAsync"),
+          deferred(Napi::Promise::Deferred::New(env)),
+          decrypt(decrypt),
+          inputRef(Napi::Persistent(input)),
+          ivRef(Napi::Persistent(iv)),
+          input(input.Data()),
+          inputLength(input.Length()),
+          output(new uint8_t[input.Length() > 0 ? input.Length() : 1]),
+          keyId(CryptoOperations::GetKeyId(key.Data(), key.Length())),
+          duration(0.0),
+          span(decrypt ? kDecryptAES256GCMAsyncMetric : kEncryptAES256GCMAsyncMetric, input.Length()) {
+        std::memcpy(this->key, key.Data(), sizeof(this->key));
+        std::memcpy(this->iv, iv.Data(), sizeof(this->iv));
+        if (tag) {
+            std::memcpy(this->tag, tag, sizeof(this->tag));
+        }
+    }
+    
+    ~AES256GCMWorker() override {
+        OPENSSL_cleanse(key, sizeof(key));
+        delete[] output;
+    }
+    
+    Napi::Promise GetPromise() const {
+        return deferred.Promise();
+    }
+    
+protected:
+    // Runs on a threadpool thread - no N-API calls allowed here
+    void Execute() override {
+        auto start = std::chrono::high_resolution_clock::now();
+        
+        std::string error;
+        bool ok = decrypt
+            ? CryptoOperations::RunAES256GCMDecrypt(key, iv, input, inputLength, tag, output, error)
+            : CryptoOperations::RunAES256GCMEncrypt(key, iv, input, inputLength, output, tag, error);
+        
+        auto end = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration<double, std::milli>(end - start).count();
+        
+        if (!ok) {
+            SetError(error);
+        }
+    }
+    
+    void OnOK() override {
+        Napi::Env env = Env();
+        const char* operation = decrypt ? "decryptAES256GCMAsync" : "encryptAES256GCMAsync";
+        
+        span.End();
+        CryptoOperations::LogCryptoOperation(operation, keyId, duration);
+        
+        // Hand the worker's output block to JS as an external Buffer; the
+        // finalizer releases it once the Buffer is collected
+        Napi::Buffer<uint8_t> result = Napi::Buffer<uint8_t>::New(env, output, inputLength,
+                                                                  [](Napi::Env, uint8_t* data) { delete[] data; });
+        output = nullptr;
+        if (decrypt) {
+            deferred.Resolve(CryptoOperations::CreateDecryptionResult(env, result, keyId, duration, inputLength));
+        } else {
+            deferred.Resolve(CryptoOperations::CreateEncryptionResult(env, result, tag, ivRef.Value(),
+                                                                      keyId, duration, inputLength));
+        }
+    }
+    
+    void OnError(const Napi::Error& error) override {
+        span.End(false);
+        deferred.Reject(error.Value());
+    }
+    
+private:
+    Napi::Promise::Deferred deferred;
+    bool decrypt;
+    Napi::Reference<Napi::Buffer<uint8_t>> inputRef;
+    Napi::Reference<Napi::Buffer<uint8_t>> ivRef;
+    const uint8_t* input;
+    size_t inputLength;
+    uint8_t* output;
+    std::string keyId;
+    uint8_t key[32];
+    uint8_t iv[12];
+    uint8_t tag[16];
+    double duration; // time in Execute(), as reported to the caller
+    PerformanceSpan span; // enqueue to settle, including threadpool wait
+};
+
+// Asynchronous AES-256-GCM encryption
+Napi::Value CryptoOperations::EncryptAES256GCMAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!ValidateAES256GCMArgs(info, false)) {
+        return env.Null();
+    }
+    
+    AES256GCMWorker* worker = new AES256GCMWorker(env, false,
+                                                  info[0].As<Napi::Buffer<uint8_t>>(),
+                                                  info[1].As<Napi::Buffer<uint8_t>>(),
+                                                  info[2].As<Napi::Buffer<uint8_t>>(),
+                                                  nullptr);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+// Asynchronous AES-256-GCM decryption
+Napi::Value CryptoOperations::DecryptAES256GCMAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!ValidateAES256GCMArgs(info, true)) {
+        return env.Null();
+    }
+    
+    AES256GCMWorker* worker = new AES256GCMWorker(env, true,
+                                                  info[0].As<Napi::Buffer<uint8_t>>(),
+                                                  info[1].As<Napi::Buffer<uint8_t>>(),
+                                                  info[2].As<Napi::Buffer<uint8_t>>(),
+                                                  info[3].As<Napi::Buffer<uint8_t>>().Data());
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+// Generate high-quality random bytes
+Napi::Value CryptoOperations::GenerateRandomBytes(const Napi::CallbackInfo& info) {
+    return CreateRandomResult(info, false, "generateRandomBytes");
+}
+
 // Timing-safe comparison
 Napi::Value CryptoOperations::TimingSafeEqual(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
@@ -328,81 +575,1009 @@ std::string CryptoOperations::GetAlgorithmName(int algorithm) {
     }
 }
 
-bool CryptoOperations::ValidateKeyStrength(int keySize, const std::string& algorithm) {
-    if (algorithm == "aes-256-gcm") {
-        return keySize == 256;
-    } else if (algorithm == "rsa-2048") {
-        return keySize == 2048;
-    } else if (algorithm == "ec-p256") {
-        return keySize == 256;
+// Validate AES-256-GCM arguments (data, key, iv[, tag]); throws on failure
+bool CryptoOperations::ValidateAES256GCMArgs(const Napi::CallbackInfo& info, bool expectTag) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < (expectTag ? 4u : 3u)) {
+        Napi::TypeError::New(env, expectTag ? "Expected ciphertext, key, iv, and tag"
+                                            : "Expected data, key, and iv").ThrowAsJavaScriptException();
+        return false;
     }
-    return false;
-}
-
-void CryptoOperations::LogCryptoOperation(const std::string& operation, const std::string& keyId, double duration) {
-    // This would integrate with the audit trail system
-    AuditLogger::LogOperation(operation, keyId, "system", true, 
-                            "Duration: " + std::to_string(duration) + "ms");
-}
-
-void CryptoOperations::RecordPerformanceMetric(const std::string& operation, double duration, size_t dataSize) {
-    // This would integrate with the performance monitoring system
-    // Implementation would track metrics for monitoring and optimization
+    
+    for (size_t i = 0; i < (expectTag ? 4u : 3u); i++) {
+        if (!info[i].IsBuffer()) {
+            Napi::TypeError::New(env, "Arguments must be Buffers").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    
+    if (info[1].As<Napi::Buffer<uint8_t>>().Length() != 32) {
+        Napi::TypeError::New(env, "Key must be 32 bytes for AES-256").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    if (info[2].As<Napi::Buffer<uint8_t>>().Length() != 12) {
+        Napi::TypeError::New(env, "IV must be 12 bytes for GCM").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    if (expectTag && info[3].As<Napi::Buffer<uint8_t>>().Length() != 16) {
+        Napi::TypeError::New(env, "Tag must be 16 bytes for GCM").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    return true;
 }
 
-// Placeholder implementations for other methods
-Napi::Value CryptoOperations::GenerateKeyPair(const Napi::CallbackInfo& info) {
+// Validate (out, offset, input, key, iv[, tag]) for the *Into entry points
+bool CryptoOperations::ValidateAES256GCMIntoArgs(const Napi::CallbackInfo& info, bool expectTag, size_t& offset) {
     Napi::Env env = info.Env();
-    // Implementation would generate RSA or EC key pairs
-    return Napi::Object::New(env);
+    
+    if (info.Length() < (expectTag ? 6u : 5u) || !info[0].IsBuffer() || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, expectTag ? "Expected out, offset, ciphertext, key, iv, and tag"
+                                            : "Expected out, offset, data, key, and iv").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    for (size_t i = 2; i < (expectTag ? 6u : 5u); i++) {
+        if (!info[i].IsBuffer()) {
+            Napi::TypeError::New(env, "Arguments must be Buffers").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    
+    if (info[3].As<Napi::Buffer<uint8_t>>().Length() != 32) {
+        Napi::TypeError::New(env, "Key must be 32 bytes for AES-256").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    if (info[4].As<Napi::Buffer<uint8_t>>().Length() != 12) {
+        Napi::TypeError::New(env, "IV must be 12 bytes for GCM").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    if (expectTag && info[5].As<Napi::Buffer<uint8_t>>().Length() != 16) {
+        Napi::TypeError::New(env, "Tag must be 16 bytes for GCM").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    double requestedOffset = info[1].As<Napi::Number>().DoubleValue();
+    Napi::Buffer<uint8_t> out = info[0].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> input = info[2].As<Napi::Buffer<uint8_t>>();
+    if (requestedOffset < 0 || requestedOffset != static_cast<double>(static_cast<size_t>(requestedOffset)) ||
+        static_cast<size_t>(requestedOffset) > out.Length() ||
+        out.Length() - static_cast<size_t>(requestedOffset) < input.Length()) {
+        Napi::RangeError::New(env, "Output buffer too small for offset and input length").ThrowAsJavaScriptException();
+        return false;
+    }
+    offset = static_cast<size_t>(requestedOffset);
+    
+    // EVP supports exactly in-place operation, but not partial overlap
+    const uint8_t* dst = out.Data() + offset;
+    const uint8_t* src = input.Data();
+    if (dst != src && dst < src + input.Length() && src < dst + input.Length()) {
+        Napi::RangeError::New(env, "Output range must not partially overlap the input").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    return true;
 }
 
-Napi::Value CryptoOperations::GenerateSecretKey(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // Implementation would generate secret keys
-    return Napi::Object::New(env);
+// Encrypt dataLength bytes into ciphertext (same length) and write the 16-byte tag
+bool CryptoOperations::RunAES256GCMEncrypt(const uint8_t* key, const uint8_t* iv,
+                                           const uint8_t* data, size_t dataLength,
+                                           uint8_t* ciphertext, uint8_t* tag, std::string& error) {
+    // Initialize OpenSSL context
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        error = "Failed to create cipher context";
+        return false;
+    }
+    
+    // Expand the key schedule
+    if (EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, key, nullptr) != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        error = "Failed to initialize encryption";
+        return false;
+    }
+    
+    bool ok = EncryptWithContext(ctx, iv, data, dataLength, ciphertext, tag, error);
+    EVP_CIPHER_CTX_free(ctx);
+    return ok;
 }
 
-Napi::Value CryptoOperations::SignData(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // Implementation would sign data
-    return Napi::Object::New(env);
+// Decrypt and authenticate ciphertextLength bytes into plaintext (same length)
+bool CryptoOperations::RunAES256GCMDecrypt(const uint8_t* key, const uint8_t* iv,
+                                           const uint8_t* ciphertext, size_t ciphertextLength,
+                                           const uint8_t* tag, uint8_t* plaintext, std::string& error) {
+    // Initialize OpenSSL context
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        error = "Failed to create cipher context";
+        return false;
+    }
+    
+    // Expand the key schedule
+    if (EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, key, nullptr) != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        error = "Failed to initialize decryption";
+        return false;
+    }
+    
+    bool ok = DecryptWithContext(ctx, iv, ciphertext, ciphertextLength, tag, plaintext, error);
+    EVP_CIPHER_CTX_free(ctx);
+    return ok;
 }
 
-Napi::Value CryptoOperations::VerifySignature(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // Implementation would verify signatures
-    return Napi::Object::New(env);
+// One GCM encryption on a context whose key schedule is already expanded;
+// only the IV is (re)initialised, so the context can be reused afterwards
+bool CryptoOperations::EncryptWithContext(EVP_CIPHER_CTX* ctx, const uint8_t* iv,
+                                          const uint8_t* data, size_t dataLength,
+                                          uint8_t* ciphertext, uint8_t* tag, std::string& error) {
+    if (EVP_EncryptInit_ex(ctx, nullptr, nullptr, nullptr, iv) != 1) {
+        error = "Failed to initialize encryption";
+        return false;
+    }
+    
+    // Encrypt data
+    int len = 0;
+    if (EVP_EncryptUpdate(ctx, ciphertext, &len, data, static_cast<int>(dataLength)) != 1) {
+        error = "Failed to encrypt data";
+        return false;
+    }
+    
+    // Finalize encryption (GCM emits no trailing block)
+    int finalLen = 0;
+    if (EVP_EncryptFinal_ex(ctx, ciphertext + len, &finalLen) != 1) {
+        error = "Failed to finalize encryption";
+        return false;
+    }
+    
+    // Get authentication tag
+    if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, 16, tag) != 1) {
+        error = "Failed to get authentication tag";
+        return false;
+    }
+    
+    return true;
 }
 
-Napi::Value CryptoOperations::HashData(const Napi::CallbackInfo& info) {
+// One GCM decryption on a pre-keyed context; see EncryptWithContext
+bool CryptoOperations::DecryptWithContext(EVP_CIPHER_CTX* ctx, const uint8_t* iv,
+                                          const uint8_t* ciphertext, size_t ciphertextLength,
+                                          const uint8_t* tag, uint8_t* plaintext, std::string& error) {
+    if (EVP_DecryptInit_ex(ctx, nullptr, nullptr, nullptr, iv) != 1) {
+        error = "Failed to initialize decryption";
+        return false;
+    }
+    
+    // Set authentication tag
+    if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, 16, const_cast<uint8_t*>(tag)) != 1) {
+        error = "Failed to set authentication tag";
+        return false;
+    }
+    
+    // Decrypt data
+    int len = 0;
+    if (EVP_DecryptUpdate(ctx, plaintext, &len, ciphertext, static_cast<int>(ciphertextLength)) != 1) {
+        error = "Failed to decrypt data";
+        return false;
+    }
+    
+    // Finalize decryption
+    int finalLen = 0;
+    if (EVP_DecryptFinal_ex(ctx, plaintext + len, &finalLen) != 1) {
+        // Never leave unauthenticated plaintext behind in the output buffer
+        OPENSSL_cleanse(plaintext, ciphertextLength);
+        error = "Failed to finalize decryption - authentication failed";
+        return false;
+    }
+    
+    return true;
+}
+
+// Shared body of generateRandomBytes/generateSecureRandom: random bytes from
+// the buffered pool wrapped in the RandomResult shape
+Napi::Value CryptoOperations::CreateRandomResult(const Napi::CallbackInfo& info, bool secret, const char* operation) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected length parameter").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    int length = info[0].As<Napi::Number>().Int32Value();
+    if (length <= 0 || length > 1024 * 1024) { // Max 1MB
+        Napi::TypeError::New(env, "Length must be between 1 and 1048576").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> randomBytes = Napi::Buffer<uint8_t>::New(env, length);
+    if (!RandomPool::Fill(randomBytes.Data(), length, secret)) {
+        Napi::Error::New(env, "Failed to generate random bytes").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Calculate performance metrics
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    RecordPerformanceMetric(operation, duration, length);
+    LogCryptoOperation(operation, "system", duration);
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("randomBytes", randomBytes);
+    result.Set("length", length);
+    result.Set("entropy", "high");
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", duration);
+    performance.Set("dataSize", length);
+    result.Set("performance", performance);
+    
+    return result;
+}
+
+// Read an optional integer option, falling back to defaultValue when absent
+template <typename T>
+bool CryptoOperations::ReadKdfOption(Napi::Object options, const char* name, uint64_t defaultValue,
+                                     uint64_t minValue, uint64_t maxValue, T& out) {
+    double value = options.Has(name) ? options.Get(name).ToNumber().DoubleValue() : static_cast<double>(defaultValue);
+    if (!(value >= static_cast<double>(minValue) && value <= static_cast<double>(maxValue)) ||
+        value != static_cast<double>(static_cast<uint64_t>(value))) {
+        return false;
+    }
+    out = static_cast<T>(value);
+    return true;
+}
+
+// Validate (data, key[, ...], algorithm at algorithmIndex) for the HMAC entry points
+bool CryptoOperations::ValidateHMACArgs(const Napi::CallbackInfo& info, size_t algorithmIndex,
+                                        const EVP_MD*& md, std::string& algorithm) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected data and key buffers").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    algorithm = info.Length() > algorithmIndex && info[algorithmIndex].IsString()
+        ? info[algorithmIndex].As<Napi::String>().Utf8Value() : "hmac-sha256";
+    md = HashEngine::ResolveDigest(algorithm);
+    if (!md) {
+        Napi::TypeError::New(env, "Unsupported HMAC algorithm: " + algorithm).ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    return true;
+}
+
+// Validate (data, offsets) where offsets is a Uint32Array of recordCount + 1
+// non-decreasing boundaries into data; throws on failure
+bool CryptoOperations::ValidateBatchOffsets(const Napi::CallbackInfo& info, size_t& recordCount) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected data buffer and offsets").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    if (!info[1].IsTypedArray() ||
+        info[1].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array) {
+        Napi::TypeError::New(env, "Offsets must be a Uint32Array").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    Napi::Uint32Array offsets = info[1].As<Napi::Uint32Array>();
+    if (offsets.ElementLength() < 1) {
+        Napi::TypeError::New(env, "Offsets must contain at least one entry").ThrowAsJavaScriptException();
+        return false;
+    }
+    recordCount = offsets.ElementLength() - 1;
+    
+    const uint32_t* bounds = offsets.Data();
+    size_t dataLength = info[0].As<Napi::Buffer<uint8_t>>().Length();
+    if (bounds[0] != 0 || bounds[recordCount] > dataLength) {
+        Napi::RangeError::New(env, "Offsets out of range for data buffer").ThrowAsJavaScriptException();
+        return false;
+    }
+    for (size_t i = 0; i < recordCount; i++) {
+        if (bounds[i] > bounds[i + 1]) {
+            Napi::RangeError::New(env, "Offsets must be non-decreasing").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Validate batch arguments (data, offsets, key, ivs[, tags]); throws on failure
+bool CryptoOperations::ValidateAES256GCMBatchArgs(const Napi::CallbackInfo& info, bool expectTags,
+                                                  size_t& recordCount) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < (expectTags ? 5u : 4u)) {
+        Napi::TypeError::New(env, expectTags ? "Expected ciphertext, offsets, key, ivs, and tags"
+                                             : "Expected data, offsets, key, and ivs").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    if (!info[0].IsBuffer() || !info[2].IsBuffer() || !info[3].IsBuffer() ||
+        (expectTags && !info[4].IsBuffer())) {
+        Napi::TypeError::New(env, "Data, key, ivs and tags must be Buffers").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    if (info[2].As<Napi::Buffer<uint8_t>>().Length() != 32) {
+        Napi::TypeError::New(env, "Key must be 32 bytes for AES-256").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    if (!ValidateBatchOffsets(info, recordCount)) {
+        return false;
+    }
+    
+    if (info[3].As<Napi::Buffer<uint8_t>>().Length() != recordCount * 12) {
+        Napi::TypeError::New(env, "IVs must be 12 bytes per record for GCM").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    if (expectTags && info[4].As<Napi::Buffer<uint8_t>>().Length() != recordCount * 16) {
+        Napi::TypeError::New(env, "Tags must be 16 bytes per record for GCM").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    return true;
+}
+
+// Run AES-256-GCM over every record of a batch with one cipher context. The key
+// schedule is expanded once; each record only re-initialises the IV. Encryption
+// writes tags; decryption reads them and records per-record auth failures.
+// Returns false only for errors that invalidate the whole batch.
+bool CryptoOperations::RunAES256GCMBatch(bool decrypt, const uint8_t* key,
+                                         const uint8_t* input, const uint32_t* offsets, size_t recordCount,
+                                         const uint8_t* ivs, uint8_t* output, uint8_t* tags,
+                                         uint8_t* failures, size_t& failedCount, std::string& error) {
+    failedCount = 0;
+    
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        error = "Failed to create cipher context";
+        return false;
+    }
+    
+    // Expand the key schedule once for the whole batch
+    int initialized = decrypt
+        ? EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, key, nullptr)
+        : EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, key, nullptr);
+    if (initialized != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        error = decrypt ? "Failed to initialize decryption" : "Failed to initialize encryption";
+        return false;
+    }
+    
+    for (size_t i = 0; i < recordCount; i++) {
+        const uint8_t* in = input + offsets[i];
+        uint8_t* out = output + offsets[i];
+        size_t recordLength = offsets[i + 1] - offsets[i];
+        
+        if (decrypt) {
+            std::string recordError;
+            bool ok = DecryptWithContext(ctx, ivs + i * 12, in, recordLength, tags + i * 16, out, recordError);
+            failures[i] = ok ? 0 : 1;
+            if (!ok) {
+                // Never hand back unauthenticated plaintext
+                OPENSSL_cleanse(out, recordLength);
+                failedCount++;
+            }
+        } else if (!EncryptWithContext(ctx, ivs + i * 12, in, recordLength, out, tags + i * 16, error)) {
+            EVP_CIPHER_CTX_free(ctx);
+            error += " (record " + std::to_string(i) + ")";
+            return false;
+        }
+    }
+    
+    EVP_CIPHER_CTX_free(ctx);
+    return true;
+}
+
+std::string CryptoOperations::GetKeyId(const uint8_t* key, size_t keyLength) {
+    return "key_" + std::to_string(std::hash<std::string>{}(std::string(key, key + keyLength)));
+}
+
+Napi::Object CryptoOperations::CreateEncryptionResult(Napi::Env env, Napi::Buffer<uint8_t> ciphertext,
+                                                      const uint8_t* tag, Napi::Buffer<uint8_t> iv,
+                                                      const std::string& keyId, double duration, size_t dataSize) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("ciphertext", ciphertext);
+    result.Set("tag", Napi::Buffer<uint8_t>::Copy(env, tag, 16));
+    result.Set("iv", iv);
+    result.Set("algorithm", "aes-256-gcm");
+    result.Set("keyId", keyId);
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", duration);
+    performance.Set("dataSize", dataSize);
+    result.Set("performance", performance);
+    
+    return result;
+}
+
+Napi::Object CryptoOperations::CreateDecryptionResult(Napi::Env env, Napi::Buffer<uint8_t> plaintext,
+                                                      const std::string& keyId, double duration, size_t dataSize) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("plaintext", plaintext);
+    result.Set("algorithm", "aes-256-gcm");
+    result.Set("keyId", keyId);
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", duration);
+    performance.Set("dataSize", dataSize);
+    result.Set("performance", performance);
+    
+    return result;
+}
+
+bool CryptoOperations::ValidateKeyStrength(int keySize, const std::string& algorithm) {
+    if (algorithm == "aes-256-gcm") {
+        return keySize == 256;
+    } else if (algorithm == "rsa-2048") {
+        return keySize == 2048;
+    } else if (algorithm == "ec-p256") {
+        return keySize == 256;
+    }
+    return false;
+}
+
+void CryptoOperations::LogCryptoOperation(const std::string& operation, const std::string& keyId, double duration) {
+    // Duration goes in its own field; no details string to format per call
+    AuditTrail::LogOperation(operation, keyId, "system", true, "", "", "", "", duration);
+}
+
+// AuditLogger is the crypto-side facade over the process-wide AuditTrail
+void AuditLogger::LogOperation(const std::string& operation, 
+                               const std::string& keyId, 
+                               const std::string& userId,
+                               bool success,
+                               const std::string& details) {
+    AuditTrail::LogOperation(operation, keyId, userId, success, details);
+}
+
+// Feed the process-wide PerformanceMonitor; duration in milliseconds
+void CryptoOperations::RecordPerformanceMetric(const std::string& operation, double duration, size_t dataSize) {
+    PerformanceMonitor::RecordOperation(operation, duration, dataSize);
+}
+
+void CryptoOperations::RecordPerformanceMetric(uint32_t slot, double duration, size_t dataSize) {
+    PerformanceMonitor::RecordOperation(slot, duration > 0 ? static_cast<uint64_t>(duration * 1e6) : 0, dataSize);
+}
+
+// Placeholder implementations for other methods
+Napi::Value CryptoOperations::GenerateKeyPair(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    // Implementation would hash data
+    // Implementation would generate RSA or EC key pairs
     return Napi::Object::New(env);
 }
 
-Napi::Value CryptoOperations::HMACData(const Napi::CallbackInfo& info) {
+Napi::Value CryptoOperations::GenerateSecretKey(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    // Implementation would compute HMAC
+    // Implementation would generate secret keys
     return Napi::Object::New(env);
 }
 
+// signData(data, privateKey, algorithm = 'ed25519'); ES256 signatures are JOSE r||s
+Napi::Value CryptoOperations::SignData(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected data and private key buffers").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string algorithmName = info.Length() > 2 && info[2].IsString()
+        ? info[2].As<Napi::String>().Utf8Value() : "ed25519";
+    SignatureEngine::Algorithm algorithm = SignatureEngine::ParseAlgorithm(algorithmName);
+    if (algorithm == SignatureEngine::Unknown) {
+        Napi::TypeError::New(env, "Unsupported signature algorithm").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    Napi::Buffer<uint8_t> data = info[0].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> keyData = info[1].As<Napi::Buffer<uint8_t>>();
+    
+    std::string error;
+    SignatureEngine::KeyPtr key = SignatureEngine::GetInlineKey(keyData.Data(), keyData.Length(), algorithm, true, error);
+    std::vector<uint8_t> signature;
+    if (!key || !SignatureEngine::Sign(key.get(), algorithm, data.Data(), data.Length(), signature, error)) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    std::string keyId = GetKeyId(keyData.Data(), keyData.Length());
+    
+    RecordPerformanceMetric(kSignDataMetric, duration, data.Length());
+    LogCryptoOperation("signData", keyId, duration);
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", true);
+    result.Set("signature", Napi::Buffer<uint8_t>::Copy(env, signature.data(), signature.size()));
+    result.Set("algorithm", SignatureEngine::AlgorithmName(algorithm));
+    result.Set("keyId", keyId);
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", duration);
+    performance.Set("dataSize", data.Length());
+    result.Set("performance", performance);
+    
+    return result;
+}
+
+// verifySignature(data, signature, publicKey | keyId, algorithm = 'ed25519').
+// A string key refers to a key added with registerPublicKey and carries its
+// own algorithm.
+Napi::Value CryptoOperations::VerifySignature(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 3 || !info[0].IsBuffer() || !info[1].IsBuffer() ||
+        !(info[2].IsBuffer() || info[2].IsString())) {
+        Napi::TypeError::New(env, "Expected data, signature, and public key buffer or keyId").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    Napi::Buffer<uint8_t> data = info[0].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> signature = info[1].As<Napi::Buffer<uint8_t>>();
+    
+    SignatureEngine::Algorithm algorithm = SignatureEngine::Unknown;
+    SignatureEngine::KeyPtr key;
+    std::string keyId;
+    
+    if (info[2].IsString()) {
+        keyId = info[2].As<Napi::String>().Utf8Value();
+        key = SignatureEngine::GetRegisteredKey(keyId, algorithm);
+        if (!key) {
+            Napi::Error::New(env, "Unknown keyId: " + keyId).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    } else {
+        std::string algorithmName = info.Length() > 3 && info[3].IsString()
+            ? info[3].As<Napi::String>().Utf8Value() : "ed25519";
+        algorithm = SignatureEngine::ParseAlgorithm(algorithmName);
+        if (algorithm == SignatureEngine::Unknown) {
+            Napi::TypeError::New(env, "Unsupported signature algorithm").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        
+        Napi::Buffer<uint8_t> keyData = info[2].As<Napi::Buffer<uint8_t>>();
+        std::string error;
+        key = SignatureEngine::GetInlineKey(keyData.Data(), keyData.Length(), algorithm, false, error);
+        if (!key) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        keyId = GetKeyId(keyData.Data(), keyData.Length());
+    }
+    
+    bool valid = SignatureEngine::Verify(key.get(), algorithm, data.Data(), data.Length(),
+                                         signature.Data(), signature.Length());
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    RecordPerformanceMetric(kVerifySignatureMetric, duration, data.Length());
+    LogCryptoOperation("verifySignature", keyId, duration);
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", true);
+    result.Set("valid", valid);
+    result.Set("algorithm", SignatureEngine::AlgorithmName(algorithm));
+    result.Set("keyId", keyId);
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", duration);
+    performance.Set("dataSize", data.Length());
+    result.Set("performance", performance);
+    
+    return result;
+}
+
+// One-shot digest: hashData(data, algorithm = 'sha256')
+Napi::Value CryptoOperations::HashData(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected data buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string algorithm = info.Length() > 1 && info[1].IsString() ? info[1].As<Napi::String>().Utf8Value() : "sha256";
+    const EVP_MD* md = HashEngine::ResolveDigest(algorithm);
+    if (!md) {
+        Napi::TypeError::New(env, "Unsupported hash algorithm: " + algorithm).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    Napi::Buffer<uint8_t> data = info[0].As<Napi::Buffer<uint8_t>>();
+    size_t digestLength = static_cast<size_t>(EVP_MD_get_size(md));
+    Napi::Buffer<uint8_t> hash = Napi::Buffer<uint8_t>::New(env, digestLength);
+    
+    // One context per thread, reinitialised for every digest
+    static thread_local std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    std::string error;
+    if (!ctx || !HashEngine::Digest(ctx.get(), md, data.Data(), data.Length(), hash.Data(), error)) {
+        Napi::Error::New(env, error.empty() ? "Failed to create digest context" : error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    RecordPerformanceMetric(kHashDataMetric, duration, data.Length());
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", true);
+    result.Set("hash", hash);
+    result.Set("algorithm", algorithm);
+    result.Set("length", digestLength);
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", duration);
+    performance.Set("dataSize", data.Length());
+    result.Set("performance", performance);
+    
+    return result;
+}
+
+// One-shot HMAC: hmacData(data, key, algorithm = 'hmac-sha256')
+Napi::Value CryptoOperations::HMACData(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    const EVP_MD* md = nullptr;
+    std::string algorithm;
+    if (!ValidateHMACArgs(info, 2, md, algorithm)) {
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    Napi::Buffer<uint8_t> data = info[0].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> key = info[1].As<Napi::Buffer<uint8_t>>();
+    size_t macLength = static_cast<size_t>(EVP_MD_get_size(md));
+    Napi::Buffer<uint8_t> hmac = Napi::Buffer<uint8_t>::New(env, macLength);
+    
+    std::string error;
+    EVP_MAC_CTX* ctx = HashEngine::AcquireHMAC(md, key.Data(), key.Length(), error);
+    bool ok = ctx && HashEngine::ComputeHMAC(ctx, data.Data(), data.Length(), hmac.Data(), macLength, error);
+    EVP_MAC_CTX_free(ctx);
+    if (!ok) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    RecordPerformanceMetric(kHmacDataMetric, duration, data.Length());
+    std::string keyId = GetKeyId(key.Data(), key.Length());
+    LogCryptoOperation("hmacData", keyId, duration);
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", true);
+    result.Set("hmac", hmac);
+    result.Set("algorithm", algorithm);
+    result.Set("keyId", keyId);
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", duration);
+    performance.Set("dataSize", data.Length());
+    result.Set("performance", performance);
+    
+    return result;
+}
+
+// Constant-time HMAC check: verifyHMAC(data, key, expected, algorithm = 'hmac-sha256')
+Napi::Value CryptoOperations::VerifyHMAC(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    const EVP_MD* md = nullptr;
+    std::string algorithm;
+    if (!ValidateHMACArgs(info, 3, md, algorithm)) {
+        return env.Null();
+    }
+    
+    if (!info[2].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected HMAC buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    Napi::Buffer<uint8_t> data = info[0].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> key = info[1].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> expected = info[2].As<Napi::Buffer<uint8_t>>();
+    
+    uint8_t mac[EVP_MAX_MD_SIZE];
+    size_t macLength = static_cast<size_t>(EVP_MD_get_size(md));
+    std::string error;
+    EVP_MAC_CTX* ctx = HashEngine::AcquireHMAC(md, key.Data(), key.Length(), error);
+    bool ok = ctx && HashEngine::ComputeHMAC(ctx, data.Data(), data.Length(), mac, sizeof(mac), error);
+    EVP_MAC_CTX_free(ctx);
+    if (!ok) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    bool valid = expected.Length() == macLength && CRYPTO_memcmp(mac, expected.Data(), macLength) == 0;
+    OPENSSL_cleanse(mac, sizeof(mac));
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    RecordPerformanceMetric(kVerifyHMACMetric, duration, data.Length());
+    
+    return Napi::Boolean::New(env, valid);
+}
+
+// Batched digest: hashDataBatch(data, offsets, algorithm = 'sha256').
+// Digests come back packed, digestLength bytes per record.
+Napi::Value CryptoOperations::HashDataBatch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    size_t recordCount = 0;
+    if (!ValidateBatchOffsets(info, recordCount)) {
+        return env.Null();
+    }
+    
+    std::string algorithm = info.Length() > 2 && info[2].IsString() ? info[2].As<Napi::String>().Utf8Value() : "sha256";
+    const EVP_MD* md = HashEngine::ResolveDigest(algorithm);
+    if (!md) {
+        Napi::TypeError::New(env, "Unsupported hash algorithm: " + algorithm).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    Napi::Buffer<uint8_t> data = info[0].As<Napi::Buffer<uint8_t>>();
+    const uint32_t* offsets = info[1].As<Napi::Uint32Array>().Data();
+    size_t digestLength = static_cast<size_t>(EVP_MD_get_size(md));
+    Napi::Buffer<uint8_t> digests = Napi::Buffer<uint8_t>::New(env, recordCount * digestLength);
+    
+    // One context for the whole batch; only the digest state is reset per record
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    std::string error = ctx ? "" : "Failed to create digest context";
+    for (size_t i = 0; ctx && error.empty() && i < recordCount; i++) {
+        HashEngine::Digest(ctx, md, data.Data() + offsets[i], offsets[i + 1] - offsets[i],
+                           digests.Data() + i * digestLength, error);
+    }
+    EVP_MD_CTX_free(ctx);
+    if (!error.empty()) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    RecordPerformanceMetric(kHashDataBatchMetric, duration, offsets[recordCount]);
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("digests", digests);
+    result.Set("digestLength", digestLength);
+    result.Set("recordCount", recordCount);
+    result.Set("algorithm", algorithm);
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", duration);
+    performance.Set("dataSize", offsets[recordCount]);
+    result.Set("performance", performance);
+    
+    return result;
+}
+
+// Batched HMAC under one key: hmacDataBatch(data, offsets, key, algorithm = 'hmac-sha256')
+Napi::Value CryptoOperations::HMACDataBatch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    size_t recordCount = 0;
+    if (!ValidateBatchOffsets(info, recordCount)) {
+        return env.Null();
+    }
+    
+    if (info.Length() < 3 || !info[2].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected HMAC key buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string algorithm = info.Length() > 3 && info[3].IsString() ? info[3].As<Napi::String>().Utf8Value() : "hmac-sha256";
+    const EVP_MD* md = HashEngine::ResolveDigest(algorithm);
+    if (!md) {
+        Napi::TypeError::New(env, "Unsupported HMAC algorithm: " + algorithm).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    Napi::Buffer<uint8_t> data = info[0].As<Napi::Buffer<uint8_t>>();
+    const uint32_t* offsets = info[1].As<Napi::Uint32Array>().Data();
+    Napi::Buffer<uint8_t> key = info[2].As<Napi::Buffer<uint8_t>>();
+    size_t macLength = static_cast<size_t>(EVP_MD_get_size(md));
+    Napi::Buffer<uint8_t> macs = Napi::Buffer<uint8_t>::New(env, recordCount * macLength);
+    
+    // The key is expanded once; each record rewinds the same context
+    std::string error;
+    EVP_MAC_CTX* ctx = HashEngine::AcquireHMAC(md, key.Data(), key.Length(), error);
+    for (size_t i = 0; ctx && error.empty() && i < recordCount; i++) {
+        HashEngine::ComputeHMAC(ctx, data.Data() + offsets[i], offsets[i + 1] - offsets[i],
+                                macs.Data() + i * macLength, macLength, error);
+    }
+    EVP_MAC_CTX_free(ctx);
+    if (!error.empty()) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    RecordPerformanceMetric(kHmacDataBatchMetric, duration, offsets[recordCount]);
+    std::string keyId = GetKeyId(key.Data(), key.Length());
+    LogCryptoOperation("hmacDataBatch", keyId, duration);
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("macs", macs);
+    result.Set("digestLength", macLength);
+    result.Set("recordCount", recordCount);
+    result.Set("algorithm", algorithm);
+    result.Set("keyId", keyId);
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", duration);
+    performance.Set("dataSize", offsets[recordCount]);
+    result.Set("performance", performance);
+    
+    return result;
+}
+
+// HKDF on the KDF pool: deriveKey(ikm, salt, info?, keyLength = 32, digest = 'sha256')
 Napi::Value CryptoOperations::DeriveKey(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    // Implementation would derive keys
-    return Napi::Object::New(env);
+    
+    if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected input key material and salt").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() > 2 && !info[2].IsUndefined() && !info[2].IsBuffer()) {
+        Napi::TypeError::New(env, "HKDF info must be a Buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::unique_ptr<KdfJob> job(new KdfJob(env, KdfJob::HKDF));
+    Napi::Buffer<uint8_t> ikm = info[0].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> salt = info[1].As<Napi::Buffer<uint8_t>>();
+    job->secret.assign(ikm.Data(), ikm.Data() + ikm.Length());
+    job->salt.assign(salt.Data(), salt.Data() + salt.Length());
+    job->saltRef = Napi::Persistent(salt);
+    if (info.Length() > 2 && info[2].IsBuffer()) {
+        Napi::Buffer<uint8_t> context = info[2].As<Napi::Buffer<uint8_t>>();
+        job->info.assign(context.Data(), context.Data() + context.Length());
+    }
+    
+    job->keyLength = info.Length() > 3 && info[3].IsNumber() ? info[3].As<Napi::Number>().Uint32Value() : 32;
+    job->digest = info.Length() > 4 && info[4].IsString() ? info[4].As<Napi::String>().Utf8Value() : "sha256";
+    
+    const EVP_MD* md = HashEngine::ResolveDigest(job->digest);
+    if (!md) {
+        Napi::TypeError::New(env, "Unsupported HKDF digest: " + job->digest).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // RFC 5869 caps the output at 255 hash blocks
+    if (job->keyLength < 1 || job->keyLength > 255 * static_cast<size_t>(EVP_MD_get_size(md))) {
+        Napi::RangeError::New(env, "HKDF key length out of range for digest").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return KdfPool::Submit(env, std::move(job));
 }
 
+// Password hashing on the KDF pool: deriveKeyFromPassword(password, salt, options?)
+// options.algorithm is 'pbkdf2' (default), 'scrypt' or 'argon2id'
+//   pbkdf2:   iterations = 600000, digest = 'sha256'
+//   scrypt:   N = 16384, r = 8, p = 1, maxmem = 64 MiB
+//   argon2id: iterations (passes) = 2, memoryCost = 19456 KiB, parallelism = 1
+// and keyLength = 32 for all of them.
 Napi::Value CryptoOperations::DeriveKeyFromPassword(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    // Implementation would derive keys from passwords
-    return Napi::Object::New(env);
+    
+    if (info.Length() < 2 || !(info[0].IsBuffer() || info[0].IsString()) || !info[1].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected password and salt").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object options = info.Length() > 2 && info[2].IsObject() ? info[2].As<Napi::Object>() : Napi::Object::New(env);
+    std::string algorithm = options.Has("algorithm") ? options.Get("algorithm").ToString().Utf8Value() : "pbkdf2";
+    
+    KdfJob::Algorithm kind;
+    if (algorithm == "pbkdf2") {
+        kind = KdfJob::PBKDF2;
+    } else if (algorithm == "scrypt") {
+        kind = KdfJob::Scrypt;
+    } else if (algorithm == "argon2id") {
+        kind = KdfJob::Argon2id;
+    } else {
+        Napi::TypeError::New(env, "Unsupported password KDF: " + algorithm).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> salt = info[1].As<Napi::Buffer<uint8_t>>();
+    if (salt.Length() < 8) {
+        Napi::TypeError::New(env, "Salt must be at least 8 bytes").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::unique_ptr<KdfJob> job(new KdfJob(env, kind));
+    if (info[0].IsBuffer()) {
+        Napi::Buffer<uint8_t> password = info[0].As<Napi::Buffer<uint8_t>>();
+        job->secret.assign(password.Data(), password.Data() + password.Length());
+    } else {
+        std::string password = info[0].As<Napi::String>().Utf8Value();
+        job->secret.assign(password.begin(), password.end());
+        OPENSSL_cleanse(&password[0], password.size());
+    }
+    job->salt.assign(salt.Data(), salt.Data() + salt.Length());
+    job->saltRef = Napi::Persistent(salt);
+    
+    bool valid = ReadKdfOption(options, "keyLength", 32, 1, 1024, job->keyLength);
+    switch (kind) {
+        case KdfJob::PBKDF2:
+            valid = valid && ReadKdfOption(options, "iterations", 600000, 1, INT_MAX, job->iterations);
+            job->digest = options.Has("digest") ? options.Get("digest").ToString().Utf8Value() : "sha256";
+            if (valid && !HashEngine::ResolveDigest(job->digest)) {
+                Napi::TypeError::New(env, "Unsupported PBKDF2 digest: " + job->digest).ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            break;
+        case KdfJob::Scrypt:
+            valid = valid && ReadKdfOption(options, "N", 16384, 2, uint64_t(1) << 32, job->costN) &&
+                    ReadKdfOption(options, "r", 8, 1, 1024, job->blockSize) &&
+                    ReadKdfOption(options, "p", 1, 1, 1024, job->parallelization) &&
+                    ReadKdfOption(options, "maxmem", 64ull * 1024 * 1024, 1024 * 1024, uint64_t(1) << 40, job->maxMemory);
+            if (valid && (job->costN & (job->costN - 1)) != 0) {
+                Napi::RangeError::New(env, "scrypt N must be a power of two").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            break;
+        case KdfJob::Argon2id:
+            valid = valid && ReadKdfOption(options, "iterations", 2, 1, UINT32_MAX, job->iterations) &&
+                    ReadKdfOption(options, "parallelism", 1, 1, 255, job->parallelization) &&
+                    ReadKdfOption(options, "memoryCost", 19456, 8 * job->parallelization, UINT32_MAX, job->memoryCost);
+            break;
+        default:
+            break;
+    }
+    
+    if (!valid) {
+        Napi::RangeError::New(env, "Invalid " + algorithm + " parameters").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return KdfPool::Submit(env, std::move(job));
 }
 
+// Random bytes for secrets (keys, session tokens), drawn from the private DRBG
 Napi::Value CryptoOperations::GenerateSecureRandom(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // Implementation would generate secure random data
-    return Napi::Object::New(env);
+    return CreateRandomResult(info, true, "generateSecureRandom");
 }
 
 Napi::Value CryptoOperations::RotateKey(const Napi::CallbackInfo& info) {
@@ -423,22 +1598,43 @@ Napi::Value CryptoOperations::ExportKey(const Napi::CallbackInfo& info) {
     return Napi::Object::New(env);
 }
 
+// Import raw key material as an opaque KeyHandle
 Napi::Value CryptoOperations::ImportKey(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    // Implementation would import keys
-    return Napi::Object::New(env);
+    
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected key data buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string format = info.Length() > 1 && info[1].IsString()
+        ? info[1].As<Napi::String>().Utf8Value() : "raw";
+    if (format != "raw") {
+        Napi::TypeError::New(env, "Unsupported key format: " + format).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return KeyHandle::NewInstance(env, info[0]);
 }
 
-Napi::Value CryptoOperations::GetPerformanceMetrics(const Napi::CallbackInfo& info) {
+// Create a KeyHandle from a raw 32-byte AES-256 key
+Napi::Value CryptoOperations::CreateKeyHandle(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    // Implementation would return performance metrics
-    return Napi::Object::New(env);
+    
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected key buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return KeyHandle::NewInstance(env, info[0]);
+}
+
+Napi::Value CryptoOperations::GetPerformanceMetrics(const Napi::CallbackInfo& info) {
+    return PerformanceMonitor::GetPerformanceMetrics(info);
 }
 
 Napi::Value CryptoOperations::ResetPerformanceMetrics(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    // Implementation would reset performance metrics
-    return Napi::Object::New(env);
+    return PerformanceMonitor::ResetMetrics(info);
 }
 
 Napi::Value CryptoOperations::ConstantTimeCompare(const Napi::CallbackInfo& info) {
@@ -15,6 +15,9 @@
 
 namespace EnterpriseCrypto {
 
+class AES256GCMWorker;
+class KeyHandle;
+
 // Enhanced crypto operations with enterprise features
 class CryptoOperations {
 public:
@@ -24,6 +27,18 @@ public:
     static Napi::Value EncryptAES256GCM(const Napi::CallbackInfo& info);
     static Napi::Value DecryptAES256GCM(const Napi::CallbackInfo& info);
     
+    // Promise-returning variants that run the cipher on the libuv threadpool
+    static Napi::Value EncryptAES256GCMAsync(const Napi::CallbackInfo& info);
+    static Napi::Value DecryptAES256GCMAsync(const Napi::CallbackInfo& info);
+    
+    // Write the result into a caller-owned buffer at an offset (reusable slabs)
+    static Napi::Value EncryptAES256GCMInto(const Napi::CallbackInfo& info);
+    static Napi::Value DecryptAES256GCMInto(const Napi::CallbackInfo& info);
+    
+    // Batched AEAD: many records per native call sharing one key schedule
+    static Napi::Value EncryptAES256GCMBatch(const Napi::CallbackInfo& info);
+    static Napi::Value DecryptAES256GCMBatch(const Napi::CallbackInfo& info);
+    
     // Enhanced key generation
     static Napi::Value GenerateKeyPair(const Napi::CallbackInfo& info);
     static Napi::Value GenerateSecretKey(const Napi::CallbackInfo& info);
@@ -35,12 +50,15 @@ public:
     // Hash operations with performance metrics
     static Napi::Value HashData(const Napi::CallbackInfo& info);
     static Napi::Value HMACData(const Napi::CallbackInfo& info);
+    static Napi::Value VerifyHMAC(const Napi::CallbackInfo& info);
+    static Napi::Value HashDataBatch(const Napi::CallbackInfo& info);
+    static Napi::Value HMACDataBatch(const Napi::CallbackInfo& info);
     
-    // Key derivation with enterprise features
+    // Key derivation on the dedicated KDF pool; both return promises
     static Napi::Value DeriveKey(const Napi::CallbackInfo& info);
     static Napi::Value DeriveKeyFromPassword(const Napi::CallbackInfo& info);
     
-    // Random number generation with entropy monitoring
+    // Random number generation from the buffered per-thread pool
     static Napi::Value GenerateRandomBytes(const Napi::CallbackInfo& info);
     static Napi::Value GenerateSecureRandom(const Napi::CallbackInfo& info);
     
@@ -49,6 +67,7 @@ public:
     static Napi::Value ValidateKey(const Napi::CallbackInfo& info);
     static Napi::Value ExportKey(const Napi::CallbackInfo& info);
     static Napi::Value ImportKey(const Napi::CallbackInfo& info);
+    static Napi::Value CreateKeyHandle(const Napi::CallbackInfo& info);
     
     // Performance monitoring
     static Napi::Value GetPerformanceMetrics(const Napi::CallbackInfo& info);
@@ -58,12 +77,54 @@ public:
     static Napi::Value TimingSafeEqual(const Napi::CallbackInfo& info);
     static Napi::Value ConstantTimeCompare(const Napi::CallbackInfo& info);
     
+    // Shared with the other native classes in this addon
+    static std::string GetKeyId(const uint8_t* key, size_t keyLength);
+    static void LogCryptoOperation(const std::string& operation, const std::string& keyId, double duration);
+    static void RecordPerformanceMetric(const std::string& operation, double duration, size_t dataSize);
+    static void RecordPerformanceMetric(uint32_t slot, double duration, size_t dataSize);
+    
 private:
+    friend class AES256GCMWorker;
+    friend class KeyHandle;
+    friend class BenchmarkWorkload;
+    
+    // AES-256-GCM core shared by the sync and async entry points. These never
+    // touch the JS heap, so they are safe to call from worker threads.
+    static bool ValidateAES256GCMArgs(const Napi::CallbackInfo& info, bool expectTag);
+    static bool ValidateAES256GCMIntoArgs(const Napi::CallbackInfo& info, bool expectTag, size_t& offset);
+    static bool RunAES256GCMEncrypt(const uint8_t* key, const uint8_t* iv,
+                                    const uint8_t* data, size_t dataLength,
+                                    uint8_t* ciphertext, uint8_t* tag, std::string& error);
+    static bool RunAES256GCMDecrypt(const uint8_t* key, const uint8_t* iv,
+                                    const uint8_t* ciphertext, size_t ciphertextLength,
+                                    const uint8_t* tag, uint8_t* plaintext, std::string& error);
+    static bool EncryptWithContext(EVP_CIPHER_CTX* ctx, const uint8_t* iv,
+                                   const uint8_t* data, size_t dataLength,
+                                   uint8_t* ciphertext, uint8_t* tag, std::string& error);
+    static bool DecryptWithContext(EVP_CIPHER_CTX* ctx, const uint8_t* iv,
+                                   const uint8_t* ciphertext, size_t ciphertextLength,
+                                   const uint8_t* tag, uint8_t* plaintext, std::string& error);
+    static bool ValidateHMACArgs(const Napi::CallbackInfo& info, size_t algorithmIndex,
+                                 const EVP_MD*& md, std::string& algorithm);
+    static bool ValidateBatchOffsets(const Napi::CallbackInfo& info, size_t& recordCount);
+    static Napi::Value CreateRandomResult(const Napi::CallbackInfo& info, bool secret, const char* operation);
+    template <typename T>
+    static bool ReadKdfOption(Napi::Object options, const char* name, uint64_t defaultValue,
+                              uint64_t minValue, uint64_t maxValue, T& out);
+    static bool ValidateAES256GCMBatchArgs(const Napi::CallbackInfo& info, bool expectTags, size_t& recordCount);
+    static bool RunAES256GCMBatch(bool decrypt, const uint8_t* key,
+                                  const uint8_t* input, const uint32_t* offsets, size_t recordCount,
+                                  const uint8_t* ivs, uint8_t* output, uint8_t* tags,
+                                  uint8_t* failures, size_t& failedCount, std::string& error);
+    static Napi::Object CreateEncryptionResult(Napi::Env env, Napi::Buffer<uint8_t> ciphertext,
+                                               const uint8_t* tag, Napi::Buffer<uint8_t> iv,
+                                               const std::string& keyId, double duration, size_t dataSize);
+    static Napi::Object CreateDecryptionResult(Napi::Env env, Napi::Buffer<uint8_t> plaintext,
+                                               const std::string& keyId, double duration, size_t dataSize);
+    
     // Internal helper methods
     static std::string GetAlgorithmName(int algorithm);
     static bool ValidateKeyStrength(int keySize, const std::string& algorithm);
-    static void LogCryptoOperation(const std::string& operation, const std::string& keyId, double duration);
-    static void RecordPerformanceMetric(const std::string& operation, double duration, size_t dataSize);
 };
 
 // Key management utilities
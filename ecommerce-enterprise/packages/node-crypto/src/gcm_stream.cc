@@ -0,0 +1,298 @@
+#include "gcm_stream.h"
+#include "crypto_operations.h"
+#include "performance_monitor.h"
+#include <algorithm>
+#include <climits>
+
+namespace EnterpriseCrypto {
+
+// EVP_*Update takes an int length; larger chunks are fed in slices
+static const size_t kMaxUpdateSlice = static_cast<size_t>(INT_MAX) & ~static_cast<size_t>(15);
+
+static const uint32_t kGcmEncryptorFinalMetric = PerformanceMonitor::RegisterOperation("gcmEncryptor.final");
+static const uint32_t kGcmDecryptorFinalMetric = PerformanceMonitor::RegisterOperation("gcmDecryptor.final");
+
+GcmStreamState::GcmStreamState()
+    : ctx(nullptr), decrypt(false), finalized(false), updated(false), bytesProcessed(0) {}
+
+GcmStreamState::~GcmStreamState() {
+    // A stream dropped before final() never completed; don't time it
+    span.Cancel();
+    // Also cleanses the expanded key schedule
+    EVP_CIPHER_CTX_free(ctx);
+}
+
+// Validate (key, iv) and key the context
+bool GcmStreamState::Init(const Napi::CallbackInfo& info, bool decrypt) {
+    Napi::Env env = info.Env();
+    this->decrypt = decrypt;
+    
+    if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected key and iv").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    Napi::Buffer<uint8_t> key = info[0].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> iv = info[1].As<Napi::Buffer<uint8_t>>();
+    
+    if (key.Length() != 32) {
+        Napi::TypeError::New(env, "Key must be 32 bytes for AES-256").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    if (iv.Length() != 12) {
+        Napi::TypeError::New(env, "IV must be 12 bytes for GCM").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        Napi::Error::New(env, "Failed to create cipher context").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    int initialized = decrypt
+        ? EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, key.Data(), iv.Data())
+        : EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, key.Data(), iv.Data());
+    if (initialized != 1) {
+        Napi::Error::New(env, decrypt ? "Failed to initialize decryption"
+                                      : "Failed to initialize encryption").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    keyId = CryptoOperations::GetKeyId(key.Data(), key.Length());
+    span = PerformanceSpan(decrypt ? kGcmDecryptorFinalMetric : kGcmEncryptorFinalMetric);
+    return true;
+}
+
+bool GcmStreamState::CheckActive(Napi::Env env) const {
+    if (!ctx || finalized) {
+        Napi::Error::New(env, "Cipher stream has already been finalized").ThrowAsJavaScriptException();
+        return false;
+    }
+    return true;
+}
+
+// Additional authenticated data; must precede the first update()
+Napi::Value GcmStreamState::SetAAD(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!CheckActive(env)) {
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected aad buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (updated) {
+        Napi::Error::New(env, "AAD must be set before the first update()").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> aad = info[0].As<Napi::Buffer<uint8_t>>();
+    int len = 0;
+    int ok = decrypt
+        ? EVP_DecryptUpdate(ctx, nullptr, &len, aad.Data(), static_cast<int>(aad.Length()))
+        : EVP_EncryptUpdate(ctx, nullptr, &len, aad.Data(), static_cast<int>(aad.Length()));
+    if (ok != 1) {
+        Napi::Error::New(env, "Failed to set additional authenticated data").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return env.Undefined();
+}
+
+// Process one chunk straight into a Buffer of the same size
+Napi::Value GcmStreamState::Update(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!CheckActive(env)) {
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected chunk buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> chunk = info[0].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> output = Napi::Buffer<uint8_t>::New(env, chunk.Length());
+    
+    size_t offset = 0;
+    while (offset < chunk.Length()) {
+        size_t slice = std::min(chunk.Length() - offset, kMaxUpdateSlice);
+        int len = 0;
+        int ok = decrypt
+            ? EVP_DecryptUpdate(ctx, output.Data() + offset, &len, chunk.Data() + offset, static_cast<int>(slice))
+            : EVP_EncryptUpdate(ctx, output.Data() + offset, &len, chunk.Data() + offset, static_cast<int>(slice));
+        if (ok != 1) {
+            Napi::Error::New(env, decrypt ? "Failed to decrypt data" : "Failed to encrypt data").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        offset += slice;
+    }
+    
+    updated = true;
+    bytesProcessed += chunk.Length();
+    return output;
+}
+
+// Finish the GCM pass and record one metric/audit entry for the whole stream.
+// For decryption this is where authentication happens.
+bool GcmStreamState::Finalize(Napi::Env env) {
+    if (!CheckActive(env)) {
+        return false;
+    }
+    
+    // GCM never produces a trailing block, but EVP still wants an output pointer
+    uint8_t trailing[16];
+    int len = 0;
+    int ok = decrypt ? EVP_DecryptFinal_ex(ctx, trailing, &len) : EVP_EncryptFinal_ex(ctx, trailing, &len);
+    finalized = true;
+    
+    const char* operation = decrypt ? "gcmDecryptor.final" : "gcmEncryptor.final";
+    span.SetDataSize(bytesProcessed);
+    double duration = span.End(ok == 1);
+    
+    if (ok != 1) {
+        Napi::Error::New(env, decrypt ? "Failed to finalize decryption - authentication failed"
+                                      : "Failed to finalize encryption").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    CryptoOperations::LogCryptoOperation(operation, keyId, duration);
+    return true;
+}
+
+// Register the GcmEncryptor class
+void GcmEncryptor::Init(Napi::Env env, Napi::Object exports) {
+    Napi::Function func = DefineClass(env, "GcmEncryptor", {
+        InstanceMethod("setAAD", &GcmEncryptor::SetAAD),
+        InstanceMethod("update", &GcmEncryptor::Update),
+        InstanceMethod("final", &GcmEncryptor::Final),
+        InstanceMethod("getTag", &GcmEncryptor::GetTag),
+    });
+    exports.Set("GcmEncryptor", func);
+}
+
+GcmEncryptor::GcmEncryptor(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<GcmEncryptor>(info) {
+    state.Init(info, false);
+}
+
+Napi::Value GcmEncryptor::SetAAD(const Napi::CallbackInfo& info) {
+    return state.SetAAD(info);
+}
+
+Napi::Value GcmEncryptor::Update(const Napi::CallbackInfo& info) {
+    return state.Update(info);
+}
+
+Napi::Value GcmEncryptor::Final(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!state.Finalize(env)) {
+        return env.Null();
+    }
+    
+    if (EVP_CIPHER_CTX_ctrl(state.Context(), EVP_CTRL_GCM_GET_TAG, 16, tag) != 1) {
+        Napi::Error::New(env, "Failed to get authentication tag").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Buffer<uint8_t>::New(env, 0);
+}
+
+Napi::Value GcmEncryptor::GetTag(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!state.IsFinalized()) {
+        Napi::Error::New(env, "Authentication tag is only available after final()").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Buffer<uint8_t>::Copy(env, tag, 16);
+}
+
+// Register the GcmDecryptor class
+void GcmDecryptor::Init(Napi::Env env, Napi::Object exports) {
+    Napi::Function func = DefineClass(env, "GcmDecryptor", {
+        InstanceMethod("setAAD", &GcmDecryptor::SetAAD),
+        InstanceMethod("setAuthTag", &GcmDecryptor::SetAuthTag),
+        InstanceMethod("update", &GcmDecryptor::Update),
+        InstanceMethod("final", &GcmDecryptor::Final),
+    });
+    exports.Set("GcmDecryptor", func);
+}
+
+GcmDecryptor::GcmDecryptor(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<GcmDecryptor>(info), hasTag(false) {
+    if (state.Init(info, true) && info.Length() > 2 && !info[2].IsUndefined()) {
+        ApplyTag(info.Env(), info[2]);
+    }
+}
+
+bool GcmDecryptor::ApplyTag(Napi::Env env, Napi::Value value) {
+    if (!value.IsBuffer() || value.As<Napi::Buffer<uint8_t>>().Length() != 16) {
+        Napi::TypeError::New(env, "Tag must be 16 bytes for GCM").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    Napi::Buffer<uint8_t> tag = value.As<Napi::Buffer<uint8_t>>();
+    if (EVP_CIPHER_CTX_ctrl(state.Context(), EVP_CTRL_GCM_SET_TAG, 16, tag.Data()) != 1) {
+        Napi::Error::New(env, "Failed to set authentication tag").ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    hasTag = true;
+    return true;
+}
+
+Napi::Value GcmDecryptor::SetAAD(const Napi::CallbackInfo& info) {
+    return state.SetAAD(info);
+}
+
+// The tag may arrive after the ciphertext (e.g. trailing a backup file), so
+// it can be supplied any time before final()
+Napi::Value GcmDecryptor::SetAuthTag(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (state.IsFinalized()) {
+        Napi::Error::New(env, "Cipher stream has already been finalized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "Expected tag buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!ApplyTag(env, info[0])) {
+        return env.Null();
+    }
+    
+    return env.Undefined();
+}
+
+Napi::Value GcmDecryptor::Update(const Napi::CallbackInfo& info) {
+    return state.Update(info);
+}
+
+Napi::Value GcmDecryptor::Final(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!hasTag) {
+        Napi::Error::New(env, "Authentication tag must be set before final()").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!state.Finalize(env)) {
+        return env.Null();
+    }
+    
+    return Napi::Buffer<uint8_t>::New(env, 0);
+}
+
+} // namespace EnterpriseCrypto
@@ -0,0 +1,79 @@
+#ifndef GCM_STREAM_H
+#define GCM_STREAM_H
+
+#include "performance_monitor.h"
+#include <napi.h>
+#include <string>
+#include <openssl/evp.h>
+
+namespace EnterpriseCrypto {
+
+// Incremental AES-256-GCM state shared by GcmEncryptor and GcmDecryptor.
+// One EVP_CIPHER_CTX lives for the whole stream, and update() returns exactly
+// as many bytes as it was given, so multi-GB payloads stream through in
+// constant memory instead of being buffered whole.
+class GcmStreamState {
+public:
+    GcmStreamState();
+    ~GcmStreamState();
+    
+    // Each of these validates its arguments and throws into JS on failure
+    bool Init(const Napi::CallbackInfo& info, bool decrypt);
+    Napi::Value SetAAD(const Napi::CallbackInfo& info);
+    Napi::Value Update(const Napi::CallbackInfo& info);
+    bool Finalize(Napi::Env env);
+    
+    bool IsFinalized() const { return finalized; }
+    EVP_CIPHER_CTX* Context() const { return ctx; }
+    
+private:
+    bool CheckActive(Napi::Env env) const;
+    
+    EVP_CIPHER_CTX* ctx;
+    bool decrypt;
+    bool finalized;
+    bool updated;
+    size_t bytesProcessed;
+    std::string keyId;
+    PerformanceSpan span; // from Init() to Finalize()
+};
+
+// new GcmEncryptor(key, iv): setAAD(aad) / update(chunk) / final() / getTag()
+class GcmEncryptor : public Napi::ObjectWrap<GcmEncryptor> {
+public:
+    static void Init(Napi::Env env, Napi::Object exports);
+    GcmEncryptor(const Napi::CallbackInfo& info);
+    
+private:
+    Napi::Value SetAAD(const Napi::CallbackInfo& info);
+    Napi::Value Update(const Napi::CallbackInfo& info);
+    Napi::Value Final(const Napi::CallbackInfo& info);
+    Napi::Value GetTag(const Napi::CallbackInfo& info);
+    
+    GcmStreamState state;
+    uint8_t tag[16];
+};
+
+// new GcmDecryptor(key, iv[, tag]): setAAD(aad) / setAuthTag(tag) /
+// update(chunk) / final(). Output from update() is unauthenticated until
+// final() succeeds; callers must discard it if final() throws.
+class GcmDecryptor : public Napi::ObjectWrap<GcmDecryptor> {
+public:
+    static void Init(Napi::Env env, Napi::Object exports);
+    GcmDecryptor(const Napi::CallbackInfo& info);
+    
+private:
+    Napi::Value SetAAD(const Napi::CallbackInfo& info);
+    Napi::Value SetAuthTag(const Napi::CallbackInfo& info);
+    Napi::Value Update(const Napi::CallbackInfo& info);
+    Napi::Value Final(const Napi::CallbackInfo& info);
+    
+    bool ApplyTag(Napi::Env env, Napi::Value tag);
+    
+    GcmStreamState state;
+    bool hasTag;
+};
+
+} // namespace EnterpriseCrypto
+
+#endif // GCM_STREAM_H
@@ -0,0 +1,309 @@
+#include "hash_engine.h"
+#include "crypto_operations.h"
+#include "performance_monitor.h"
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <openssl/core_names.h>
+#include <openssl/crypto.h>
+
+namespace EnterpriseCrypto {
+
+namespace {
+
+const uint32_t kHasherDigestMetric = PerformanceMonitor::RegisterOperation("hasher.digest");
+const uint32_t kHasherHmacMetric = PerformanceMonitor::RegisterOperation("hasher.hmac");
+
+struct DigestEntry {
+    const char* algorithm;
+    const char* providerName;
+    EVP_MD* md;
+};
+
+// Fetched lazily and kept for the life of the process
+DigestEntry digestTable[] = {
+    { "sha256", "SHA2-256", nullptr },
+    { "sha384", "SHA2-384", nullptr },
+    { "sha512", "SHA2-512", nullptr },
+    { "sha3-256", "SHA3-256", nullptr },
+    { "sha3-384", "SHA3-384", nullptr },
+    { "sha3-512", "SHA3-512", nullptr },
+    { "blake2b512", "BLAKE2B-512", nullptr },
+    { "blake2s256", "BLAKE2S-256", nullptr },
+};
+std::mutex digestMutex;
+
+struct HMACCacheEntry {
+    EVP_MAC_CTX* ctx;
+    uint64_t lastUsed;
+};
+
+EVP_MAC* hmacAlgorithm = nullptr;
+std::unordered_map<std::string, HMACCacheEntry> hmacCache;
+uint64_t hmacClock = 0;
+std::mutex hmacMutex;
+
+} // namespace
+
+const EVP_MD* HashEngine::ResolveDigest(const std::string& algorithm) {
+    std::string name = algorithm.compare(0, 5, "hmac-") == 0 ? algorithm.substr(5) : algorithm;
+    
+    std::lock_guard<std::mutex> lock(digestMutex);
+    for (DigestEntry& entry : digestTable) {
+        if (name == entry.algorithm) {
+            if (!entry.md) {
+                entry.md = EVP_MD_fetch(nullptr, entry.providerName, nullptr);
+            }
+            return entry.md;
+        }
+    }
+    return nullptr;
+}
+
+bool HashEngine::Digest(EVP_MD_CTX* ctx, const EVP_MD* md, const uint8_t* data, size_t length,
+                        uint8_t* out, std::string& error) {
+    if (EVP_DigestInit_ex2(ctx, md, nullptr) != 1 ||
+        EVP_DigestUpdate(ctx, data, length) != 1 ||
+        EVP_DigestFinal_ex(ctx, out, nullptr) != 1) {
+        error = "Failed to compute digest";
+        return false;
+    }
+    return true;
+}
+
+EVP_MAC_CTX* HashEngine::AcquireHMAC(const EVP_MD* md, const uint8_t* key, size_t keyLength, std::string& error) {
+    // Cache by digest name plus SHA-256 of the key so raw keys are never used
+    // as map keys
+    uint8_t fingerprint[32];
+    unsigned int fingerprintLength = 0;
+    if (EVP_Digest(key, keyLength, fingerprint, &fingerprintLength, ResolveDigest("sha256"), nullptr) != 1) {
+        error = "Failed to fingerprint HMAC key";
+        return nullptr;
+    }
+    std::string cacheKey = std::string(EVP_MD_get0_name(md)) + '\0' +
+                           std::string(reinterpret_cast<char*>(fingerprint), fingerprintLength);
+    
+    std::lock_guard<std::mutex> lock(hmacMutex);
+    
+    auto it = hmacCache.find(cacheKey);
+    if (it == hmacCache.end()) {
+        if (!hmacAlgorithm) {
+            hmacAlgorithm = EVP_MAC_fetch(nullptr, "HMAC", nullptr);
+        }
+        
+        EVP_MAC_CTX* keyed = hmacAlgorithm ? EVP_MAC_CTX_new(hmacAlgorithm) : nullptr;
+        OSSL_PARAM params[] = {
+            OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>(EVP_MD_get0_name(md)), 0),
+            OSSL_PARAM_construct_end()
+        };
+        if (!keyed || EVP_MAC_init(keyed, key, keyLength, params) != 1) {
+            EVP_MAC_CTX_free(keyed);
+            error = "Failed to initialize HMAC";
+            return nullptr;
+        }
+        
+        // Evict the least recently used key once the cache is full
+        if (hmacCache.size() >= kMaxCachedHMACKeys) {
+            auto oldest = hmacCache.begin();
+            for (auto entry = hmacCache.begin(); entry != hmacCache.end(); ++entry) {
+                if (entry->second.lastUsed < oldest->second.lastUsed) {
+                    oldest = entry;
+                }
+            }
+            EVP_MAC_CTX_free(oldest->second.ctx);
+            hmacCache.erase(oldest);
+        }
+        
+        it = hmacCache.emplace(cacheKey, HMACCacheEntry{ keyed, 0 }).first;
+    }
+    
+    it->second.lastUsed = ++hmacClock;
+    EVP_MAC_CTX* ctx = EVP_MAC_CTX_dup(it->second.ctx);
+    if (!ctx) {
+        error = "Failed to copy HMAC context";
+    }
+    return ctx;
+}
+
+bool HashEngine::ComputeHMAC(EVP_MAC_CTX* ctx, const uint8_t* data, size_t length,
+                             uint8_t* out, size_t outSize, std::string& error) {
+    size_t written = 0;
+    if (EVP_MAC_update(ctx, data, length) != 1 ||
+        EVP_MAC_final(ctx, out, &written, outSize) != 1) {
+        error = "Failed to compute HMAC";
+        return false;
+    }
+    
+    // A NULL key re-arms HMAC with the key it already holds
+    if (EVP_MAC_init(ctx, nullptr, 0, nullptr) != 1) {
+        error = "Failed to reset HMAC";
+        return false;
+    }
+    return true;
+}
+
+void HashEngine::ClearHMACCache() {
+    std::lock_guard<std::mutex> lock(hmacMutex);
+    for (auto& entry : hmacCache) {
+        EVP_MAC_CTX_free(entry.second.ctx);
+    }
+    hmacCache.clear();
+}
+
+// Register the Hasher class
+void Hasher::Init(Napi::Env env, Napi::Object exports) {
+    Napi::Function func = DefineClass(env, "Hasher", {
+        InstanceMethod("update", &Hasher::Update),
+        InstanceMethod("digest", &Hasher::Digest),
+        InstanceMethod("reset", &Hasher::Reset),
+        InstanceAccessor("algorithm", &Hasher::GetAlgorithm, nullptr),
+        InstanceAccessor("digestLength", &Hasher::GetDigestLength, nullptr),
+    });
+    exports.Set("Hasher", func);
+}
+
+Hasher::Hasher(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<Hasher>(info),
+      md(nullptr),
+      mdCtx(nullptr),
+      macCtx(nullptr),
+      finalized(false),
+      bytesProcessed(0) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected algorithm name").ThrowAsJavaScriptException();
+        return;
+    }
+    
+    algorithm = info[0].As<Napi::String>().Utf8Value();
+    md = HashEngine::ResolveDigest(algorithm);
+    if (!md) {
+        Napi::TypeError::New(env, "Unsupported hash algorithm: " + algorithm).ThrowAsJavaScriptException();
+        return;
+    }
+    
+    std::string error;
+    if (info.Length() > 1 && !info[1].IsUndefined()) {
+        if (!info[1].IsBuffer()) {
+            Napi::TypeError::New(env, "HMAC key must be a Buffer").ThrowAsJavaScriptException();
+            return;
+        }
+        Napi::Buffer<uint8_t> key = info[1].As<Napi::Buffer<uint8_t>>();
+        macCtx = HashEngine::AcquireHMAC(md, key.Data(), key.Length(), error);
+        if (!macCtx) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
+            return;
+        }
+        keyId = CryptoOperations::GetKeyId(key.Data(), key.Length());
+    } else {
+        mdCtx = EVP_MD_CTX_new();
+        if (!mdCtx || EVP_DigestInit_ex2(mdCtx, md, nullptr) != 1) {
+            Napi::Error::New(env, "Failed to initialize digest").ThrowAsJavaScriptException();
+            return;
+        }
+    }
+}
+
+Hasher::~Hasher() {
+    EVP_MD_CTX_free(mdCtx);
+    EVP_MAC_CTX_free(macCtx);
+}
+
+bool Hasher::Begin(Napi::Env env) {
+    if (!mdCtx && !macCtx) {
+        Napi::Error::New(env, "Hasher is not initialized").ThrowAsJavaScriptException();
+        return false;
+    }
+    if (finalized) {
+        Napi::Error::New(env, "Digest already called; use reset() to start over").ThrowAsJavaScriptException();
+        return false;
+    }
+    return true;
+}
+
+Napi::Value Hasher::Update(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!Begin(env)) {
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected data buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> data = info[0].As<Napi::Buffer<uint8_t>>();
+    int ok = macCtx ? EVP_MAC_update(macCtx, data.Data(), data.Length())
+                    : EVP_DigestUpdate(mdCtx, data.Data(), data.Length());
+    if (ok != 1) {
+        Napi::Error::New(env, "Failed to update digest").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    bytesProcessed += data.Length();
+    return info.This();
+}
+
+Napi::Value Hasher::Digest(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!Begin(env)) {
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    size_t digestLength = static_cast<size_t>(EVP_MD_get_size(md));
+    Napi::Buffer<uint8_t> output = Napi::Buffer<uint8_t>::New(env, digestLength);
+    size_t written = 0;
+    int ok = macCtx ? EVP_MAC_final(macCtx, output.Data(), &written, digestLength)
+                    : EVP_DigestFinal_ex(mdCtx, output.Data(), nullptr);
+    finalized = true;
+    
+    if (ok != 1) {
+        Napi::Error::New(env, "Failed to finalize digest").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    CryptoOperations::RecordPerformanceMetric(macCtx ? kHasherHmacMetric : kHasherDigestMetric, duration, bytesProcessed);
+    if (macCtx) {
+        CryptoOperations::LogCryptoOperation("hasher.hmac", keyId, duration);
+    }
+    
+    return output;
+}
+
+Napi::Value Hasher::Reset(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    int ok = 0;
+    if (macCtx) {
+        ok = EVP_MAC_init(macCtx, nullptr, 0, nullptr);
+    } else if (mdCtx) {
+        ok = EVP_DigestInit_ex2(mdCtx, md, nullptr);
+    }
+    if (ok != 1) {
+        Napi::Error::New(env, "Failed to reset hasher").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    finalized = false;
+    bytesProcessed = 0;
+    return info.This();
+}
+
+Napi::Value Hasher::GetAlgorithm(const Napi::CallbackInfo& info) {
+    return Napi::String::New(info.Env(), algorithm);
+}
+
+Napi::Value Hasher::GetDigestLength(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), md ? EVP_MD_get_size(md) : 0);
+}
+
+} // namespace EnterpriseCrypto
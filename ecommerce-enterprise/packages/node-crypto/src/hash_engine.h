@@ -0,0 +1,73 @@
+#ifndef HASH_ENGINE_H
+#define HASH_ENGINE_H
+
+#include <napi.h>
+#include <string>
+#include <openssl/evp.h>
+
+namespace EnterpriseCrypto {
+
+// Digest and HMAC core shared by hashData/hmacData, the batch entry points and
+// the incremental Hasher. Supported algorithms: sha256, sha384, sha512,
+// sha3-256, sha3-384, sha3-512, blake2b512, blake2s256 (an "hmac-" prefix is
+// accepted and ignored).
+//
+// EVP_MD implementations are fetched once per algorithm. HMAC keys are
+// expanded once and kept in a small LRU cache keyed by a fingerprint of the
+// key, so a MAC over a short message only costs a context copy plus the
+// message blocks instead of a provider fetch and two key-pad compressions.
+class HashEngine {
+public:
+    static const size_t kMaxCachedHMACKeys = 64;
+    
+    // Returns nullptr for unsupported algorithm names
+    static const EVP_MD* ResolveDigest(const std::string& algorithm);
+    
+    // One-shot digest into out (EVP_MD_get_size(md) bytes) on a reusable ctx
+    static bool Digest(EVP_MD_CTX* ctx, const EVP_MD* md, const uint8_t* data, size_t length,
+                       uint8_t* out, std::string& error);
+    
+    // HMAC context keyed with key and ready for EVP_MAC_update. The caller owns
+    // the returned context and frees it with EVP_MAC_CTX_free.
+    static EVP_MAC_CTX* AcquireHMAC(const EVP_MD* md, const uint8_t* key, size_t keyLength, std::string& error);
+    
+    // MAC data with a context from AcquireHMAC, then rewind it to the same key
+    static bool ComputeHMAC(EVP_MAC_CTX* ctx, const uint8_t* data, size_t length,
+                            uint8_t* out, size_t outSize, std::string& error);
+    
+    // Drop all cached HMAC keys (e.g. after key rotation)
+    static void ClearHMACCache();
+};
+
+// new Hasher(algorithm[, hmacKey]) - incremental digest or HMAC.
+//   update(data) -> this
+//   digest()     -> Buffer, finishes the hasher
+//   reset()      -> this, starts over with the same algorithm and key
+class Hasher : public Napi::ObjectWrap<Hasher> {
+public:
+    static void Init(Napi::Env env, Napi::Object exports);
+    
+    Hasher(const Napi::CallbackInfo& info);
+    ~Hasher();
+    
+private:
+    Napi::Value Update(const Napi::CallbackInfo& info);
+    Napi::Value Digest(const Napi::CallbackInfo& info);
+    Napi::Value Reset(const Napi::CallbackInfo& info);
+    Napi::Value GetAlgorithm(const Napi::CallbackInfo& info);
+    Napi::Value GetDigestLength(const Napi::CallbackInfo& info);
+    
+    bool Begin(Napi::Env env);
+    
+    const EVP_MD* md;
+    EVP_MD_CTX* mdCtx;
+    EVP_MAC_CTX* macCtx;
+    std::string algorithm;
+    std::string keyId;
+    bool finalized;
+    size_t bytesProcessed;
+};
+
+} // namespace EnterpriseCrypto
+
+#endif // HASH_ENGINE_H
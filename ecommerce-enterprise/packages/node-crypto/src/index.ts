@@ -23,6 +23,8 @@ import {
   HashAlgorithm,
   HashResult,
   HMACAlgorithm,
+  AuditFsyncMode,
+  ComplianceReport,
   HMACResult,
   KeyDerivationResult,
   RandomResult,
@@ -43,21 +45,84 @@ export interface NativeCryptoAddon {
   // Core crypto operations
   encryptAES256GCM(data: Buffer, key: Buffer, iv: Buffer): EncryptionResult;
   decryptAES256GCM(ciphertext: Buffer, key: Buffer, iv: Buffer, tag: Buffer): DecryptionResult;
+  encryptAES256GCMAsync(data: Buffer, key: Buffer, iv: Buffer): Promise<EncryptionResult>;
+  decryptAES256GCMAsync(ciphertext: Buffer, key: Buffer, iv: Buffer, tag: Buffer): Promise<DecryptionResult>;
+  // Write into out[offset..]; lets callers reuse preallocated slabs
+  encryptAES256GCMInto(out: Buffer, offset: number, data: Buffer, key: Buffer, iv: Buffer): {
+    bytesWritten: number;
+    tag: Buffer;
+    iv: Buffer;
+    algorithm: string;
+    keyId: string;
+  };
+  decryptAES256GCMInto(out: Buffer, offset: number, ciphertext: Buffer, key: Buffer, iv: Buffer, tag: Buffer): {
+    bytesWritten: number;
+    algorithm: string;
+    keyId: string;
+  };
+  encryptAES256GCMBatch(data: Buffer, offsets: Uint32Array, key: Buffer, ivs: Buffer): {
+    output: Buffer; // ciphertexts at `offsets`, then recordCount 16-byte tags
+    tagOffset: number;
+    recordCount: number;
+    algorithm: string;
+    keyId: string;
+  };
+  decryptAES256GCMBatch(ciphertext: Buffer, offsets: Uint32Array, key: Buffer, ivs: Buffer, tags: Buffer): {
+    plaintext: Buffer;
+    failures: Uint8Array; // 1 where the record failed authentication
+    failedCount: number;
+    recordCount: number;
+    algorithm: string;
+    keyId: string;
+  };
   generateKeyPair(algorithm: AsymmetricAlgorithm, keySize?: number): KeyPair;
   generateSecretKey(algorithm: SymmetricAlgorithm, keySize?: number): SecretKey;
-  signData(data: Buffer, privateKey: Buffer, algorithm: string): SignatureResult;
-  verifySignature(data: Buffer, signature: Buffer, publicKey: Buffer, algorithm: string): VerificationResult;
+  signData(data: Buffer, privateKey: Buffer, algorithm?: SignatureAlgorithm): SignatureResult;
+  // String publicKey refers to a key added with registerPublicKey
+  verifySignature(data: Buffer, signature: Buffer, publicKey: Buffer | string, algorithm?: SignatureAlgorithm): VerificationResult;
+  registerPublicKey(keyId: string, publicKey: Buffer, algorithm: SignatureAlgorithm): string;
+  unregisterPublicKey(keyId: string): boolean;
+  verifyBatch(items: SignatureBatchItem[]): {
+    bitmap: Buffer; // bit i (LSB first) set when items[i] verified
+    validCount: number;
+    count: number;
+  };
   hashData(data: Buffer, algorithm: HashAlgorithm): HashResult;
   hmacData(data: Buffer, key: Buffer, algorithm: HMACAlgorithm): HMACResult;
-  deriveKey(password: string, salt: Buffer, iterations: number, keyLength: number): KeyDerivationResult;
+  verifyHMAC(data: Buffer, key: Buffer, expected: Buffer, algorithm: HMACAlgorithm): boolean;
+  hashDataBatch(data: Buffer, offsets: Uint32Array, algorithm: HashAlgorithm): {
+    digests: Buffer; // recordCount digests of digestLength bytes, packed
+    digestLength: number;
+    recordCount: number;
+    algorithm: string;
+  };
+  hmacDataBatch(data: Buffer, offsets: Uint32Array, key: Buffer, algorithm: HMACAlgorithm): {
+    macs: Buffer;
+    digestLength: number;
+    recordCount: number;
+    algorithm: string;
+    keyId: string;
+  };
+  Hasher: new (algorithm: HashAlgorithm | HMACAlgorithm, hmacKey?: Buffer) => NativeHasher;
+  // Both run on the addon's dedicated KDF pool, not the libuv threadpool
+  deriveKey(ikm: Buffer, salt: Buffer, info?: Buffer, keyLength?: number, digest?: HashAlgorithm): Promise<KeyDerivationResult>;
+  deriveKeyFromPassword(password: Buffer | string, salt: Buffer, options?: PasswordKdfOptions): Promise<KeyDerivationResult>;
+  configureKdfPool(options: { maxConcurrency?: number; maxQueueDepth?: number }): KdfPoolStats;
+  getKdfPoolStats(): KdfPoolStats;
   generateRandomBytes(length: number): RandomResult;
   generateSecureRandom(length: number): RandomResult;
+  // Lean fast path: bare Buffers, no result object or audit entry
+  fillRandom(buffer: Buffer, offset?: number, length?: number): Buffer;
+  randomIV(length?: number): Buffer;
   
   // Key management
   rotateKey(keyId: string): KeyPair | SecretKey;
   validateKey(key: Buffer, algorithm: string): boolean;
   exportKey(key: Buffer, format: 'pem' | 'der' | 'jwk'): string | Buffer;
-  importKey(keyData: string | Buffer, format: 'pem' | 'der' | 'jwk'): Buffer;
+  importKey(keyData: Buffer, format?: 'raw'): NativeKeyHandle;
+  createKeyHandle(key: Buffer): NativeKeyHandle;
+  GcmEncryptor: new (key: Buffer, iv: Buffer) => NativeGcmEncryptor;
+  GcmDecryptor: new (key: Buffer, iv: Buffer, tag?: Buffer) => NativeGcmDecryptor;
   
   // Performance monitoring
   getPerformanceMetrics(): Record<string, PerformanceMetric>;
@@ -65,22 +130,69 @@ export interface NativeCryptoAddon {
   getOverallMetrics(): {
     totalOperations: number;
     totalCalls: number;
+    totalFailures: number;
     totalDuration: number;
     averageDuration: number;
     totalDataSize: number;
   };
   resetMetrics(): boolean;
+  registerOperation(operation: string): number;
+  startSpan(): number; // monotonic start stamp, in ns
+  endSpan(operation: string | number, start: number, dataSize?: number, success?: boolean): number;
+  exportPerformanceData(options?: PerformanceExportFormat | PerformanceExportOptions): unknown;
+  generatePerformanceReport(): string;
+  getPerformanceTrends(): Record<string, PerformanceTrend>;
+  
+  // Real-time monitoring
+  startRealTimeMonitoring(options?: { interval?: number }, onAlert?: (event: PerformanceAlertEvent) => void): boolean;
+  stopRealTimeMonitoring(): boolean;
+  getRealTimeMetrics(): RealTimeMetrics;
+  setMonitoringInterval(intervalMs: number): number;
+  setPerformanceAlert(operation: string, thresholds: PerformanceAlertThresholds | null): boolean;
+  getActiveAlerts(): PerformanceAlertEvent[];
+  clearAlerts(): boolean;
+  
+  // Native benchmark harness
+  benchmarkOperation(operation: BenchmarkOperationName, options?: BenchmarkOptions): Promise<BenchmarkResult>;
+  compareOperations(operations: Array<BenchmarkOperationName | ({ operation: BenchmarkOperationName } & BenchmarkOptions)>,
+                    options?: BenchmarkOptions): Promise<Array<BenchmarkResult & { relative: number }>>;
+  runStressTest(operation: BenchmarkOperationName, options?: StressTestOptions): Promise<Array<BenchmarkResult & { scalingEfficiency: number }>>;
+  benchmarkNoop(): void;
+  getBenchmarkResults(): Record<string, BenchmarkResult>;
+  getBenchmarkHistory(operation?: BenchmarkOperationName): BenchmarkResult[];
+  exportBenchmarkData(format?: 'json' | 'csv'): { timestamp: number; results: BenchmarkResult[] } | string;
   
   // Audit trail
   logOperation(operation: string, keyId: string, userId: string, success: boolean, details?: string): void;
   recordOperation(operation: string, duration: number, success: boolean, dataSize?: number): void;
   getAuditLog(): AuditEntry[];
-  getAuditLogByUser(userId: string): AuditEntry[];
-  getAuditLogByKey(keyId: string): AuditEntry[];
-  getAuditLogByOperation(operation: string): AuditEntry[];
-  getAuditLogByTimeRange(startTime: string, endTime: string): AuditEntry[];
+  getAuditLogByUser(userId: string, options?: AuditQueryOptions): AuditEntry[];
+  getAuditLogByKey(keyId: string, options?: AuditQueryOptions): AuditEntry[];
+  getAuditLogByOperation(operation: string, options?: AuditQueryOptions): AuditEntry[];
+  getAuditLogByTimeRange(startTime: string | number, endTime: string | number, options?: AuditQueryOptions): AuditEntry[];
+  queryAuditLog(query?: AuditQueryOptions): AuditQueryResult;
   exportAuditLogCSV(): string;
   exportAuditLogJSON(): AuditEntry[];
+  // Streams the full history (segments included) to a file
+  exportAuditLog(path: string, options?: { format?: 'csv' | 'ndjson'; from?: string | number; to?: string | number }): {
+    path: string;
+    records: number;
+    bytes: number;
+  };
+  generateComplianceReport(standard?: ComplianceReport['standard'], options?: ComplianceReportOptions): ComplianceReport;
+  generateSOXReport(options?: ComplianceReportOptions): ComplianceReport;
+  generateGDPRReport(options?: ComplianceReportOptions): ComplianceReport;
+  generateHIPAAReport(options?: ComplianceReportOptions): ComplianceReport;
+  generatePCIDSSReport(options?: ComplianceReportOptions): ComplianceReport;
+  listAuditSegments(): Array<{
+    path: string;
+    sealed: boolean;
+    records: number;
+    firstTimestamp: string;
+    lastTimestamp: string;
+    bytes: number;
+    blocks: number;
+  }>;
   getAuditLogStats(): {
     totalEntries: number;
     successCount: number;
@@ -90,6 +202,41 @@ export interface NativeCryptoAddon {
     totalDataSize: number;
     operationCounts: Record<string, number>;
     userCounts: Record<string, number>;
+    capacity: number; // in-memory ring size
+    totalLogged: number; // entries logged since start, including overwritten ones
+    internedStrings: number;
+    internedStringCapacity: number;
+    droppedStrings: number; // operation/key/user values not stored because the table was full
+    truncatedEntries: number; // entries logged with a field cut or dropped
+    queueDepth: number; // entries not yet written to the audit file
+    droppedEntries: number;
+    writtenEntries: number;
+    writeBatches: number;
+    fsyncCount: number;
+    writeErrors: number;
+    segmentsSealed: number;
+  };
+  setAuditConfig(config: {
+    fileLogging?: boolean;
+    filePath?: string;
+    maxMemoryEntries?: number;
+    fsync?: AuditFsyncMode;
+    fsyncIntervalMs?: number;
+    flushIntervalMs?: number;
+    format?: 'text' | 'binary';
+    segmentDirectory?: string;
+    maxSegmentBytes?: number;
+  }): boolean;
+  getAuditConfig(): {
+    fileLogging: boolean;
+    filePath: string;
+    maxMemoryEntries: number;
+    fsync: AuditFsyncMode;
+    fsyncIntervalMs: number;
+    flushIntervalMs: number;
+    format: 'text' | 'binary';
+    segmentDirectory: string;
+    maxSegmentBytes: number;
   };
   
   // Security utilities
@@ -97,6 +244,207 @@ export interface NativeCryptoAddon {
   constantTimeCompare(a: Buffer, b: Buffer): boolean;
 }
 
+// Opaque native AES-256-GCM key with a pre-expanded key schedule
+export interface NativeKeyHandle {
+  readonly keyId: string;
+  readonly destroyed: boolean;
+  encrypt(data: Buffer, iv: Buffer): EncryptionResult;
+  decrypt(ciphertext: Buffer, iv: Buffer, tag: Buffer): DecryptionResult;
+  destroy(): void;
+}
+
+// Incremental AES-256-GCM ciphers that keep one native context per stream
+export interface NativeGcmEncryptor {
+  setAAD(aad: Buffer): void;
+  update(chunk: Buffer): Buffer;
+  final(): Buffer;
+  getTag(): Buffer;
+}
+
+export interface NativeGcmDecryptor {
+  setAAD(aad: Buffer): void;
+  setAuthTag(tag: Buffer): void;
+  update(chunk: Buffer): Buffer;
+  final(): Buffer;
+}
+
+export interface NativeHasher {
+  readonly algorithm: string;
+  readonly digestLength: number;
+  update(data: Buffer): NativeHasher;
+  digest(): Buffer;
+  reset(): NativeHasher;
+}
+
+// Indexed audit queries. 'memory' covers the retained in-memory entries;
+// 'history' also reads the binary segments on disk.
+export interface AuditQueryOptions {
+  userId?: string;
+  keyId?: string;
+  operation?: string;
+  success?: boolean;
+  from?: string | number; // ISO 8601 or epoch milliseconds
+  to?: string | number;
+  offset?: number;
+  limit?: number; // queryAuditLog defaults to 100
+  source?: 'memory' | 'history';
+}
+
+export interface AuditQueryResult {
+  entries: AuditEntry[];
+  count: number;
+  nextOffset: number | null;
+}
+
+// 'openmetrics' is text exposition for Prometheus; 'snapshot' is a compact
+// binary form, a delta from the previous snapshot unless full is set
+export type PerformanceExportFormat = 'json' | 'openmetrics' | 'snapshot';
+
+export interface PerformanceExportOptions {
+  format?: PerformanceExportFormat;
+  target?: Buffer; // write into this and return the byte count needed
+  full?: boolean;
+}
+
+// Rolling windows kept by the native real-time sampler
+export type MonitoringWindow = '1s' | '10s' | '60s';
+
+export interface WindowMetrics {
+  calls: number;
+  failures: number;
+  seconds: number;
+  complete: boolean; // false while the window is still filling after start
+  throughput: number; // calls per second
+  bytesPerSecond: number;
+  errorRate: number;
+  averageDuration: number;
+  p50Duration: number;
+  p90Duration: number;
+  p99Duration: number;
+}
+
+export interface RealTimeMetrics {
+  monitoring: boolean;
+  interval: number;
+  droppedEvents: number;
+  timestamp: string | null;
+  operations: Record<string, Record<MonitoringWindow, WindowMetrics>>;
+}
+
+export interface PerformanceTrend {
+  throughput: Record<MonitoringWindow, number>;
+  p99Duration: Record<MonitoringWindow, number>;
+  throughputTrend: 'rising' | 'falling' | 'stable';
+  latencyTrend: 'rising' | 'falling' | 'stable';
+}
+
+// Limits for one operation, or '*' for every operation without its own
+export interface PerformanceAlertThresholds {
+  p99Ms?: number;
+  minThroughput?: number;
+  maxThroughput?: number;
+  maxErrorRate?: number; // percent
+  minCalls?: number;
+  window?: MonitoringWindow; // default '10s'
+}
+
+export interface PerformanceAlertEvent {
+  type: 'alert' | 'resolved';
+  operation: string;
+  metric: 'p99' | 'throughput' | 'errorRate';
+  window: MonitoringWindow;
+  value: number;
+  threshold: number;
+  timestamp: string;
+  message: string;
+}
+
+export type BenchmarkOperationName =
+  | 'aes-256-gcm-encrypt' | 'aes-256-gcm-decrypt'
+  | 'hash' | 'hmac'
+  | 'pbkdf2' | 'scrypt' | 'argon2id' | 'hkdf'
+  | 'sign' | 'verify'
+  | 'audit-log' | 'metrics-record';
+
+export interface BenchmarkOptions {
+  payloadSize?: number; // bytes; the password / IKM length for KDFs, the details length for audit-log
+  threads?: number;
+  iterations?: number; // per thread; selects fixed-iteration mode
+  durationMs?: number; // fixed-time mode (default 1000) when iterations is not set
+  warmupIterations?: number; // per thread, untimed
+  algorithm?: string; // digest, HMAC or signature algorithm
+  kdf?: Omit<PasswordKdfOptions, 'algorithm'>;
+}
+
+export interface StressTestOptions extends Omit<BenchmarkOptions, 'payloadSize' | 'threads'> {
+  payloadSizes?: number | number[];
+  threads?: number | number[];
+}
+
+export interface BenchmarkResult {
+  operation: BenchmarkOperationName;
+  algorithm: string;
+  mode: 'iterations' | 'time';
+  payloadSize: number;
+  threads: number;
+  warmupIterations: number;
+  operations: number;
+  durationMs: number;
+  nsPerOp: number;
+  opsPerSecond: number;
+  mbPerSecond: number;
+  latencyNs: { min: number; p50: number; p90: number; p99: number; p999: number; max: number };
+  timestamp: number;
+}
+
+export interface CallOverheadResult {
+  payloadSize: number;
+  crossingNs: number; // empty call into the addon
+  bindingNs: number; // hashData() timed from JavaScript
+  primitiveNs: number; // the same digest run natively
+  overheadNs: number; // bindingNs - primitiveNs: call plus marshalling
+}
+
+export interface ComplianceReportOptions {
+  from?: string | number; // ISO 8601 or epoch milliseconds
+  to?: string | number;
+  maxViolations?: number;
+}
+
+// ES256 signatures are JOSE r||s (64 bytes); DER is also accepted on verify
+export type SignatureAlgorithm = 'ed25519' | 'es256';
+
+export interface SignatureBatchItem {
+  msg: Buffer;
+  sig: Buffer;
+  keyId: string;
+}
+
+export interface PasswordKdfOptions {
+  algorithm?: 'pbkdf2' | 'scrypt' | 'argon2id';
+  keyLength?: number;
+  iterations?: number; // PBKDF2 iterations or Argon2id passes
+  digest?: HashAlgorithm; // PBKDF2
+  N?: number; // scrypt
+  r?: number;
+  p?: number;
+  maxmem?: number;
+  memoryCost?: number; // Argon2id, KiB
+  parallelism?: number;
+}
+
+export interface KdfPoolStats {
+  maxConcurrency: number;
+  maxQueueDepth: number;
+  threads: number;
+  running: number;
+  queued: number;
+  submitted: number;
+  completed: number;
+  failed: number;
+  rejected: number;
+}
+
 // Load the native addon
 let nativeAddon: NativeCryptoAddon;
 
@@ -124,6 +472,7 @@ export class EnhancedCryptoService {
       maxMemoryEntries: 10000,
       ...config,
     };
+    this.applyAuditConfig();
   }
 
   // Core encryption methods
@@ -140,7 +489,9 @@ export class EnhancedCryptoService {
       const iv = options.iv || this.generateIV(algorithm);
       
       if (algorithm === 'aes-256-gcm') {
-        const result = nativeAddon.encryptAES256GCM?.(dataBuffer, key, iv) || this.fallbackEncrypt(dataBuffer, key, iv);
+        const result = await nativeAddon.encryptAES256GCMAsync?.(dataBuffer, key, iv)
+          || nativeAddon.encryptAES256GCM?.(dataBuffer, key, iv)
+          || this.fallbackEncrypt(dataBuffer, key, iv);
         
         if (this.config.auditLogging) {
           this.logOperation('encrypt', this.getKeyId(key), 'system', true, 
@@ -168,7 +519,8 @@ export class EnhancedCryptoService {
     const startTime = performance.now();
     
     try {
-      const result = nativeAddon.decryptAES256GCM?.(encryptedData.ciphertext, key, encryptedData.iv, encryptedData.tag) 
+      const result = await nativeAddon.decryptAES256GCMAsync?.(encryptedData.ciphertext, key, encryptedData.iv, encryptedData.tag)
+        || nativeAddon.decryptAES256GCM?.(encryptedData.ciphertext, key, encryptedData.iv, encryptedData.tag)
         || this.fallbackDecrypt(encryptedData, key);
       
       if (this.config.auditLogging) {
@@ -241,6 +593,30 @@ export class EnhancedCryptoService {
     }
   }
 
+  // Password hashing runs on the native KDF pool so login bursts cannot
+  // starve the libuv threadpool; a full pool rejects with ERR_KDF_QUEUE_FULL
+  async deriveKeyFromPassword(password: Buffer | string, salt: Buffer, options: PasswordKdfOptions = {}): Promise<KeyDerivationResult> {
+    const startTime = performance.now();
+    const algorithm = options.algorithm || 'pbkdf2';
+    
+    try {
+      const result = await (nativeAddon.deriveKeyFromPassword?.(password, salt, options)
+        || this.fallbackDeriveKeyFromPassword(password, salt, options));
+      
+      if (this.config.performanceMonitoring) {
+        this.recordPerformance('deriveKeyFromPassword', performance.now() - startTime, result.derivedKey.length);
+      }
+      
+      return result;
+    } catch (error) {
+      if (this.config.auditLogging) {
+        this.logOperation('deriveKeyFromPassword', 'unknown', 'system', false, 
+          `Algorithm: ${algorithm}, Error: ${error instanceof Error ? error.message : 'Unknown error'}`);
+      }
+      throw error;
+    }
+  }
+
   // Performance monitoring
   getPerformanceMetrics(): Record<string, PerformanceMetric> {
     return nativeAddon.getPerformanceMetrics?.() || {};
@@ -281,8 +657,107 @@ export class EnhancedCryptoService {
     };
   }
 
+  // Scrape native metrics without building per-operation JS objects
+  exportMetrics(format: 'openmetrics'): string | null;
+  exportMetrics(format: 'snapshot', options?: { full?: boolean }): Buffer | null;
+  exportMetrics(format: 'openmetrics' | 'snapshot', options: { full?: boolean } = {}): string | Buffer | null {
+    if (!nativeAddon.exportPerformanceData) {
+      return null;
+    }
+    return nativeAddon.exportPerformanceData({ format, full: options.full }) as string | Buffer;
+  }
+
+  getPerformanceReport(): string {
+    return nativeAddon.generatePerformanceReport?.() || '';
+  }
+
+  // Alerts are pushed from the native sampler; no polling needed
+  startRealTimeMonitoring(onAlert?: (event: PerformanceAlertEvent) => void, intervalMs?: number): boolean {
+    return nativeAddon.startRealTimeMonitoring?.({ interval: intervalMs }, onAlert) ?? false;
+  }
+
+  stopRealTimeMonitoring(): boolean {
+    return nativeAddon.stopRealTimeMonitoring?.() ?? false;
+  }
+
+  getRealTimeMetrics(): RealTimeMetrics | null {
+    return nativeAddon.getRealTimeMetrics?.() ?? null;
+  }
+
+  setPerformanceAlert(operation: string, thresholds: PerformanceAlertThresholds | null): boolean {
+    return nativeAddon.setPerformanceAlert?.(operation, thresholds) ?? false;
+  }
+
+  // Benchmarks run natively, off the event loop
+  async benchmark(operation: BenchmarkOperationName, options: BenchmarkOptions = {}): Promise<BenchmarkResult> {
+    if (!nativeAddon.benchmarkOperation) {
+      throw new Error('Native benchmark harness is not available');
+    }
+    return nativeAddon.benchmarkOperation(operation, options);
+  }
+
+  async runStressTest(operation: BenchmarkOperationName, options: StressTestOptions = {}): Promise<Array<BenchmarkResult & { scalingEfficiency: number }>> {
+    if (!nativeAddon.runStressTest) {
+      throw new Error('Native benchmark harness is not available');
+    }
+    return nativeAddon.runStressTest(operation, options);
+  }
+
+  // Splits the cost of one hashData() call into the native digest and the
+  // N-API call plus marshalling around it, so a regression can be pinned on
+  // one or the other
+  async measureCallOverhead(options: { payloadSize?: number; iterations?: number } = {}): Promise<CallOverheadResult> {
+    const payloadSize = options.payloadSize ?? 64;
+    const iterations = options.iterations ?? 100000;
+    if (!nativeAddon.benchmarkNoop || !nativeAddon.benchmarkOperation) {
+      throw new Error('Native benchmark harness is not available');
+    }
+
+    const payload: Buffer = require('crypto').randomBytes(payloadSize);
+    const timeLoop = (fn: () => void): number => {
+      for (let i = 0; i < Math.min(iterations, 1000); i++) {
+        fn();
+      }
+      const start = process.hrtime.bigint();
+      for (let i = 0; i < iterations; i++) {
+        fn();
+      }
+      return Number(process.hrtime.bigint() - start) / iterations;
+    };
+
+    const crossingNs = timeLoop(() => nativeAddon.benchmarkNoop());
+    const bindingNs = timeLoop(() => nativeAddon.hashData(payload, 'sha256'));
+    const native = await nativeAddon.benchmarkOperation('hash', { algorithm: 'sha256', payloadSize, iterations });
+
+    return {
+      payloadSize,
+      crossingNs,
+      bindingNs,
+      primitiveNs: native.nsPerOp,
+      overheadNs: Math.max(0, bindingNs - native.nsPerOp),
+    };
+  }
+
+  getBenchmarkHistory(operation?: BenchmarkOperationName): BenchmarkResult[] {
+    return nativeAddon.getBenchmarkHistory?.(operation) ?? [];
+  }
+
   // Audit trail
   getAuditLog(filter?: AuditFilter): AuditEntry[] {
+    // Filtered reads go through the native indexes when available
+    if (filter && nativeAddon.queryAuditLog) {
+      return nativeAddon.queryAuditLog({
+        userId: filter.userId,
+        keyId: filter.keyId,
+        operation: filter.operation,
+        success: filter.success,
+        from: filter.startTime,
+        to: filter.endTime,
+        offset: filter.offset,
+        limit: filter.limit ?? Number.MAX_SAFE_INTEGER,
+      }).entries;
+    }
+
     let entries = nativeAddon.getAuditLog?.() || [];
     
     if (filter) {
@@ -325,6 +800,7 @@ export class EnhancedCryptoService {
   // Configuration
   updateConfig(newConfig: Partial<EnhancedCryptoServiceConfig>): void {
     this.config = { ...this.config, ...newConfig };
+    this.applyAuditConfig();
   }
 
   getConfig(): EnhancedCryptoServiceConfig {
@@ -352,10 +828,10 @@ export class EnhancedCryptoService {
     switch (algorithm) {
       case 'aes-256-gcm':
       case 'aes-128-gcm':
-        return this.generateRandomBytes(12);
+        return nativeAddon.randomIV?.(12) ?? this.generateRandomBytes(12);
       case 'aes-256-cbc':
       case 'aes-128-cbc':
-        return this.generateRandomBytes(16);
+        return nativeAddon.randomIV?.(16) ?? this.generateRandomBytes(16);
       default:
         throw new Error(`Unsupported algorithm: ${algorithm}`);
     }
@@ -363,15 +839,37 @@ export class EnhancedCryptoService {
 
   // Public methods
   generateRandomBytes(length: number): Buffer {
-    const result = nativeAddon.generateRandomBytes?.(length);
-    if (result?.randomBytes) {
-      return result.randomBytes;
+    const result = nativeAddon.fillRandom?.(Buffer.allocUnsafe(length));
+    if (result) {
+      return result;
     }
     // Fallback to Node.js crypto
     const crypto = require('crypto');
     return crypto.randomBytes(length);
   }
 
+  hash(data: BufferLike, algorithm: HashAlgorithm = 'sha256'): Buffer {
+    const dataBuffer = this.toBuffer(data);
+    return nativeAddon.hashData?.(dataBuffer, algorithm)?.hash
+      ?? require('crypto').createHash(algorithm).update(dataBuffer).digest();
+  }
+
+  hmac(data: BufferLike, key: Buffer, algorithm: HMACAlgorithm = 'hmac-sha256'): Buffer {
+    const dataBuffer = this.toBuffer(data);
+    return nativeAddon.hmacData?.(dataBuffer, key, algorithm)?.hmac
+      ?? require('crypto').createHmac(algorithm.replace(/^hmac-/, ''), key).update(dataBuffer).digest();
+  }
+
+  verifyHMAC(data: BufferLike, key: Buffer, expected: Buffer, algorithm: HMACAlgorithm = 'hmac-sha256'): boolean {
+    const dataBuffer = this.toBuffer(data);
+    const native = nativeAddon.verifyHMAC?.(dataBuffer, key, expected, algorithm);
+    if (native !== undefined) {
+      return native;
+    }
+    const actual = this.hmac(dataBuffer, key, algorithm);
+    return actual.length === expected.length && this.fallbackTimingSafeEqual(actual, expected);
+  }
+
   timingSafeEqual(a: Buffer, b: Buffer): boolean {
     return nativeAddon.timingSafeEqual?.(a, b) ?? this.fallbackTimingSafeEqual(a, b);
   }
@@ -389,6 +887,42 @@ export class EnhancedCryptoService {
     return nativeAddon.getAuditLogStats?.() ?? this.fallbackGetAuditLogStats();
   }
 
+  private applyAuditConfig(): void {
+    nativeAddon.setAuditConfig?.({
+      fileLogging: this.config.fileLogging,
+      filePath: this.config.auditFilePath,
+      maxMemoryEntries: this.config.maxMemoryEntries,
+      fsync: this.config.auditFsync,
+      fsyncIntervalMs: this.config.auditFsyncIntervalMs,
+      format: this.config.auditFormat,
+      segmentDirectory: this.config.auditSegmentDirectory,
+    });
+  }
+
+  private fallbackDeriveKeyFromPassword(password: Buffer | string, salt: Buffer, options: PasswordKdfOptions): Promise<KeyDerivationResult> {
+    const crypto = require('crypto');
+    const keyLength = options.keyLength || 32;
+    
+    return new Promise((resolve, reject) => {
+      const done = (error: Error | null, derivedKey: Buffer) => error
+        ? reject(error)
+        : resolve({ success: true, derivedKey, algorithm: options.algorithm || 'pbkdf2', salt, iterations: options.iterations });
+      
+      switch (options.algorithm || 'pbkdf2') {
+        case 'pbkdf2':
+          crypto.pbkdf2(password, salt, options.iterations || 600000, keyLength, options.digest || 'sha256', done);
+          break;
+        case 'scrypt':
+          crypto.scrypt(password, salt, keyLength, {
+            N: options.N || 16384, r: options.r || 8, p: options.p || 1, maxmem: options.maxmem || 64 * 1024 * 1024,
+          }, done);
+          break;
+        default:
+          reject(new Error(`Unsupported password KDF without native addon: ${options.algorithm}`));
+      }
+    });
+  }
+
   private fallbackTimingSafeEqual(a: Buffer, b: Buffer): boolean {
     const crypto = require('crypto');
     return crypto.timingSafeEqual(a, b);
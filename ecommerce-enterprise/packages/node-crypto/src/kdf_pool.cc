@@ -0,0 +1,347 @@
+#include "kdf_pool.h"
+#include "hash_engine.h"
+#include "performance_monitor.h"
+#include <algorithm>
+#include <climits>
+#include <openssl/core_names.h>
+#include <openssl/crypto.h>
+#include <openssl/kdf.h>
+
+namespace EnterpriseCrypto {
+
+std::mutex KdfPool::mutex;
+std::condition_variable KdfPool::available;
+std::deque<KdfJob*> KdfPool::queue;
+std::vector<std::thread> KdfPool::workers;
+size_t KdfPool::maxConcurrency = std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 2));
+size_t KdfPool::maxQueueDepth = 256;
+size_t KdfPool::running = 0;
+size_t KdfPool::envCount = 0;
+bool KdfPool::stopping = false;
+std::atomic<uint64_t> KdfPool::submitted(0);
+std::atomic<uint64_t> KdfPool::completed(0);
+std::atomic<uint64_t> KdfPool::failed(0);
+std::atomic<uint64_t> KdfPool::rejected(0);
+
+KdfParams::KdfParams(Algorithm algorithm)
+    : algorithm(algorithm),
+      digest("sha256"),
+      iterations(0),
+      costN(0),
+      blockSize(0),
+      parallelization(0),
+      maxMemory(0),
+      memoryCost(0),
+      keyLength(32) {}
+
+KdfParams::~KdfParams() {
+    OPENSSL_cleanse(secret.data(), secret.size());
+}
+
+KdfJob::KdfJob(Napi::Env env, Algorithm algorithm)
+    : KdfParams(algorithm),
+      queueWait(0.0),
+      compute(0.0),
+      deferred(Napi::Promise::Deferred::New(env)) {}
+
+KdfJob::~KdfJob() {
+    OPENSSL_cleanse(output.data(), output.size());
+}
+
+// Register pool management functions
+void KdfPool::Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("configureKdfPool", Napi::Function::New(env, Configure));
+    exports.Set("getKdfPoolStats", Napi::Function::New(env, GetStats));
+    
+    // Worker threads are joined when the last environment using the addon goes away
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        envCount++;
+        stopping = false;
+    }
+    napi_add_env_cleanup_hook(env, Shutdown, nullptr);
+}
+
+const char* KdfPool::AlgorithmName(KdfJob::Algorithm algorithm) {
+    switch (algorithm) {
+        case KdfJob::PBKDF2: return "pbkdf2";
+        case KdfJob::Scrypt: return "scrypt";
+        case KdfJob::Argon2id: return "argon2id";
+        case KdfJob::HKDF: return "hkdf";
+        default: return "unknown";
+    }
+}
+
+Napi::Value KdfPool::Submit(Napi::Env env, std::unique_ptr<KdfJob> job) {
+    Napi::Promise promise = job->deferred.Promise();
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    // Queued jobs a free worker is about to take do not count against
+    // maxQueueDepth, so a depth of 0 still admits work that can run now
+    if (running + queue.size() >= maxConcurrency + maxQueueDepth) {
+        lock.unlock();
+        rejected++;
+        Napi::Error error = Napi::Error::New(env, "Key derivation queue is full");
+        error.Set("code", Napi::String::New(env, "ERR_KDF_QUEUE_FULL"));
+        job->deferred.Reject(error.Value());
+        return promise;
+    }
+    
+    // Keeps the event loop alive until the result has been delivered
+    job->completion = Napi::ThreadSafeFunction::New(
+        env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}), "kdfPool", 0, 1);
+    job->queuedAt = std::chrono::steady_clock::now();
+    queue.push_back(job.release());
+    submitted++;
+    
+    // Threads are started lazily, one per unit of allowed concurrency
+    if (workers.size() < maxConcurrency && running + queue.size() > workers.size()) {
+        workers.emplace_back(WorkerLoop);
+    }
+    
+    lock.unlock();
+    available.notify_one();
+    return promise;
+}
+
+void KdfPool::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    while (true) {
+        available.wait(lock, [] { return stopping || (!queue.empty() && running < maxConcurrency); });
+        if (stopping) {
+            return;
+        }
+        
+        KdfJob* job = queue.front();
+        queue.pop_front();
+        running++;
+        lock.unlock();
+        
+        Run(*job);
+        
+        // Settle on the JS thread. If the environment is already closing the
+        // callback never runs: the job's secrets and buffers are freed here,
+        // but its salt reference is left to die with the environment, since
+        // deleting it would call into N-API off the JS thread.
+        Napi::ThreadSafeFunction completion = job->completion;
+        napi_status status = completion.BlockingCall(job, [](Napi::Env env, Napi::Function, KdfJob* job) {
+            Settle(env, job);
+        });
+        if (status != napi_ok) {
+            job->saltRef.SuppressDestruct();
+            delete job;
+        }
+        completion.Release();
+        
+        lock.lock();
+        running--;
+        lock.unlock();
+        available.notify_one();
+        lock.lock();
+    }
+}
+
+bool KdfPool::Derive(const KdfParams& params, uint8_t* output, std::string& error) {
+    bool ok = false;
+    switch (params.algorithm) {
+        case KdfParams::PBKDF2: {
+            const EVP_MD* md = HashEngine::ResolveDigest(params.digest);
+            ok = md && PKCS5_PBKDF2_HMAC(reinterpret_cast<const char*>(params.secret.data()),
+                                         static_cast<int>(params.secret.size()),
+                                         params.salt.data(), static_cast<int>(params.salt.size()),
+                                         static_cast<int>(params.iterations), md,
+                                         static_cast<int>(params.keyLength), output) == 1;
+            break;
+        }
+        case KdfParams::Scrypt:
+            ok = EVP_PBE_scrypt(reinterpret_cast<const char*>(params.secret.data()), params.secret.size(),
+                                params.salt.data(), params.salt.size(), params.costN, params.blockSize,
+                                params.parallelization, params.maxMemory, output, params.keyLength) == 1;
+            break;
+        case KdfParams::Argon2id:
+        case KdfParams::HKDF: {
+            // Argon2id is only provided by OpenSSL 3.2+; fetch fails cleanly on older builds
+            bool argon = params.algorithm == KdfParams::Argon2id;
+            EVP_KDF* kdf = EVP_KDF_fetch(nullptr, argon ? "ARGON2ID" : "HKDF", nullptr);
+            EVP_KDF_CTX* ctx = kdf ? EVP_KDF_CTX_new(kdf) : nullptr;
+            if (!ctx) {
+                error = argon ? "Argon2id is not available in this OpenSSL build (requires 3.2+)"
+                              : "HKDF is not available";
+            } else {
+                uint32_t passes = static_cast<uint32_t>(params.iterations);
+                uint32_t lanes = static_cast<uint32_t>(params.parallelization);
+                uint32_t memoryCost = static_cast<uint32_t>(params.memoryCost);
+                uint32_t threads = 1;
+                std::string digestName = params.digest;
+                const EVP_MD* md = argon ? nullptr : HashEngine::ResolveDigest(params.digest);
+                if (md) {
+                    digestName = EVP_MD_get0_name(md);
+                }
+                
+                std::vector<OSSL_PARAM> settings;
+                if (argon) {
+                    settings.push_back(OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_PASSWORD, params.secret.data(), params.secret.size()));
+                    settings.push_back(OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SALT, params.salt.data(), params.salt.size()));
+                    settings.push_back(OSSL_PARAM_construct_uint32(OSSL_KDF_PARAM_ITER, &passes));
+                    settings.push_back(OSSL_PARAM_construct_uint32("lanes", &lanes));
+                    settings.push_back(OSSL_PARAM_construct_uint32("memcost", &memoryCost));
+                    settings.push_back(OSSL_PARAM_construct_uint32("threads", &threads));
+                } else {
+                    settings.push_back(OSSL_PARAM_construct_utf8_string(OSSL_KDF_PARAM_DIGEST, &digestName[0], 0));
+                    settings.push_back(OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_KEY, params.secret.data(), params.secret.size()));
+                    settings.push_back(OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SALT, params.salt.data(), params.salt.size()));
+                    settings.push_back(OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_INFO, params.info.data(), params.info.size()));
+                }
+                settings.push_back(OSSL_PARAM_construct_end());
+                
+                ok = (argon || md) && EVP_KDF_derive(ctx, output, params.keyLength, settings.data()) == 1;
+            }
+            EVP_KDF_CTX_free(ctx);
+            EVP_KDF_free(kdf);
+            break;
+        }
+    }
+    
+    if (!ok && error.empty()) {
+        error = std::string("Key derivation failed (") + AlgorithmName(params.algorithm) + ")";
+    }
+    return ok;
+}
+
+// Runs on a pool thread - no N-API calls allowed here
+void KdfPool::Run(KdfJob& job) {
+    auto start = std::chrono::steady_clock::now();
+    job.queueWait = std::chrono::duration<double, std::milli>(start - job.queuedAt).count();
+    job.output.resize(job.keyLength);
+    
+    bool ok = Derive(job, job.output.data(), job.error);
+    
+    auto end = std::chrono::steady_clock::now();
+    job.compute = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    std::string prefix = std::string("kdf.") + AlgorithmName(job.algorithm);
+    PerformanceMonitor::RecordOperation(prefix + ".queueWait", job.queueWait);
+    PerformanceMonitor::RecordOperation(prefix + ".compute", job.compute, job.keyLength);
+    (ok ? completed : failed)++;
+}
+
+// Runs on the JS thread; resolves or rejects the job's promise and frees it
+void KdfPool::Settle(Napi::Env env, KdfJob* job) {
+    std::unique_ptr<KdfJob> owned(job);
+    
+    if (!env) {
+        return;
+    }
+    
+    if (!job->error.empty()) {
+        job->deferred.Reject(Napi::Error::New(env, job->error).Value());
+        return;
+    }
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", true);
+    result.Set("derivedKey", Napi::Buffer<uint8_t>::Copy(env, job->output.data(), job->output.size()));
+    result.Set("algorithm", AlgorithmName(job->algorithm));
+    result.Set("salt", job->saltRef.IsEmpty()
+        ? Napi::Buffer<uint8_t>::Copy(env, job->salt.data(), job->salt.size())
+        : job->saltRef.Value());
+    if (job->algorithm == KdfJob::PBKDF2 || job->algorithm == KdfJob::Argon2id) {
+        result.Set("iterations", static_cast<double>(job->iterations));
+    }
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", job->compute);
+    performance.Set("queueWait", job->queueWait);
+    performance.Set("dataSize", job->keyLength);
+    result.Set("performance", performance);
+    
+    job->deferred.Resolve(result);
+}
+
+Napi::Value KdfPool::Configure(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Expected pool options").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object options = info[0].As<Napi::Object>();
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    if (options.Has("maxConcurrency")) {
+        double value = options.Get("maxConcurrency").ToNumber().DoubleValue();
+        if (!(value >= 1 && value <= 256)) {
+            lock.unlock();
+            Napi::RangeError::New(env, "maxConcurrency must be between 1 and 256").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        maxConcurrency = static_cast<size_t>(value);
+    }
+    
+    if (options.Has("maxQueueDepth")) {
+        double value = options.Get("maxQueueDepth").ToNumber().DoubleValue();
+        if (!(value >= 0 && value <= 1e6)) {
+            lock.unlock();
+            Napi::RangeError::New(env, "maxQueueDepth must be between 0 and 1000000").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        maxQueueDepth = static_cast<size_t>(value);
+    }
+    
+    // Raising the limit may need more threads for work that is already queued
+    while (workers.size() < maxConcurrency && running + queue.size() > workers.size()) {
+        workers.emplace_back(WorkerLoop);
+    }
+    
+    lock.unlock();
+    available.notify_all();
+    return GetStats(info);
+}
+
+Napi::Value KdfPool::GetStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object stats = Napi::Object::New(env);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.Set("maxConcurrency", maxConcurrency);
+    stats.Set("maxQueueDepth", maxQueueDepth);
+    stats.Set("threads", workers.size());
+    stats.Set("running", running);
+    stats.Set("queued", queue.size());
+    stats.Set("submitted", static_cast<double>(submitted.load()));
+    stats.Set("completed", static_cast<double>(completed.load()));
+    stats.Set("failed", static_cast<double>(failed.load()));
+    stats.Set("rejected", static_cast<double>(rejected.load()));
+    
+    return stats;
+}
+
+// Environment cleanup hook: drop queued work and join the workers once the
+// last environment goes away
+void KdfPool::Shutdown(void*) {
+    std::vector<std::thread> joinable;
+    std::deque<KdfJob*> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--envCount > 0) {
+            return;
+        }
+        stopping = true;
+        joinable.swap(workers);
+        abandoned.swap(queue);
+    }
+    available.notify_all();
+    
+    for (std::thread& worker : joinable) {
+        worker.join();
+    }
+    for (KdfJob* job : abandoned) {
+        job->completion.Release();
+        delete job;
+    }
+}
+
+} // namespace EnterpriseCrypto
@@ -0,0 +1,105 @@
+#ifndef KDF_POOL_H
+#define KDF_POOL_H
+
+#include <napi.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <atomic>
+
+namespace EnterpriseCrypto {
+
+// Algorithm and inputs of one key derivation
+struct KdfParams {
+    enum Algorithm { PBKDF2, Scrypt, Argon2id, HKDF };
+    
+    explicit KdfParams(Algorithm algorithm);
+    ~KdfParams();
+    
+    Algorithm algorithm;
+    std::vector<uint8_t> secret;    // password, or input key material for HKDF
+    std::vector<uint8_t> salt;
+    std::vector<uint8_t> info;      // HKDF only
+    std::string digest;             // PBKDF2 and HKDF
+    uint64_t iterations;            // PBKDF2 iterations / Argon2id passes
+    uint64_t costN;                 // scrypt
+    uint64_t blockSize;             // scrypt r
+    uint64_t parallelization;       // scrypt p / Argon2id lanes
+    uint64_t maxMemory;             // scrypt
+    uint64_t memoryCost;            // Argon2id, KiB
+    size_t keyLength;
+};
+
+// One queued derivation: parameters and result. Owned by KdfPool from
+// Submit until it is settled on the JS thread.
+struct KdfJob : KdfParams {
+    KdfJob(Napi::Env env, Algorithm algorithm);
+    ~KdfJob();
+    
+    std::vector<uint8_t> output;
+    std::string error;
+    double queueWait;
+    double compute;
+    std::chrono::steady_clock::time_point queuedAt;
+    
+    Napi::Promise::Deferred deferred;
+    Napi::ThreadSafeFunction completion;
+    Napi::Reference<Napi::Buffer<uint8_t>> saltRef;
+};
+
+// Dedicated, bounded worker pool for password hashing and key derivation.
+// It is deliberately separate from the libuv threadpool so a burst of logins
+// cannot starve fs, DNS or zlib work. At most maxConcurrency derivations run
+// at once and at most maxQueueDepth wait behind them; beyond that Submit
+// fails immediately so callers can shed load instead of queueing unbounded.
+//
+// Queue wait and compute time are reported to PerformanceMonitor per
+// algorithm as "kdf.<algorithm>.queueWait" and "kdf.<algorithm>.compute".
+class KdfPool {
+public:
+    static void Init(Napi::Env env, Napi::Object exports);
+    
+    // Queue job and return its promise. When the queue is full the promise is
+    // rejected right away with code ERR_KDF_QUEUE_FULL.
+    static Napi::Value Submit(Napi::Env env, std::unique_ptr<KdfJob> job);
+    
+    // configureKdfPool({ maxConcurrency, maxQueueDepth })
+    static Napi::Value Configure(const Napi::CallbackInfo& info);
+    static Napi::Value GetStats(const Napi::CallbackInfo& info);
+    
+    static const char* AlgorithmName(KdfJob::Algorithm algorithm);
+    
+    // Derive params.keyLength bytes into output. Touches no JS state and is
+    // safe on any thread; the pool and the benchmark harness both use it.
+    static bool Derive(const KdfParams& params, uint8_t* output, std::string& error);
+    
+private:
+    static void WorkerLoop();
+    static void Run(KdfJob& job);
+    static void Settle(Napi::Env env, KdfJob* job);
+    static void Shutdown(void* arg);
+    
+    static std::mutex mutex;
+    static std::condition_variable available;
+    static std::deque<KdfJob*> queue;
+    static std::vector<std::thread> workers;
+    static size_t maxConcurrency;
+    static size_t maxQueueDepth;
+    static size_t running;
+    static size_t envCount;
+    static bool stopping;
+    
+    static std::atomic<uint64_t> submitted;
+    static std::atomic<uint64_t> completed;
+    static std::atomic<uint64_t> failed;
+    static std::atomic<uint64_t> rejected;
+};
+
+} // namespace EnterpriseCrypto
+
+#endif // KDF_POOL_H
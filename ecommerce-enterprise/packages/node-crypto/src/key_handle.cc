@@ -0,0 +1,248 @@
+#include "key_handle.h"
+#include "crypto_operations.h"
+#include "performance_monitor.h"
+#include <chrono>
+
+namespace EnterpriseCrypto {
+
+namespace {
+
+const uint32_t kKeyHandleEncryptMetric = PerformanceMonitor::RegisterOperation("keyHandle.encrypt");
+const uint32_t kKeyHandleDecryptMetric = PerformanceMonitor::RegisterOperation("keyHandle.decrypt");
+
+} // namespace
+
+Napi::FunctionReference KeyHandle::constructor;
+
+// Register the KeyHandle class
+void KeyHandle::Init(Napi::Env env, Napi::Object exports) {
+    Napi::Function func = DefineClass(env, "KeyHandle", {
+        InstanceMethod("encrypt", &KeyHandle::Encrypt),
+        InstanceMethod("decrypt", &KeyHandle::Decrypt),
+        InstanceMethod("destroy", &KeyHandle::Destroy),
+        InstanceAccessor("keyId", &KeyHandle::GetKeyId, nullptr),
+        InstanceAccessor("destroyed", &KeyHandle::IsDestroyed, nullptr),
+    });
+    
+    constructor = Napi::Persistent(func);
+    constructor.SuppressDestruct();
+    
+    exports.Set("KeyHandle", func);
+}
+
+// Create a KeyHandle from native code (importKey / createKeyHandle)
+Napi::Object KeyHandle::NewInstance(Napi::Env env, Napi::Value key) {
+    return constructor.New({ key });
+}
+
+// new KeyHandle(key: Buffer) - key must be 32 bytes
+KeyHandle::KeyHandle(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<KeyHandle>(info),
+      encryptTemplate(nullptr),
+      decryptTemplate(nullptr),
+      destroyed(true) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected key buffer").ThrowAsJavaScriptException();
+        return;
+    }
+    
+    Napi::Buffer<uint8_t> key = info[0].As<Napi::Buffer<uint8_t>>();
+    if (key.Length() != 32) {
+        Napi::TypeError::New(env, "Key must be 32 bytes for AES-256").ThrowAsJavaScriptException();
+        return;
+    }
+    
+    // Expand the key schedule once for each direction
+    encryptTemplate = EVP_CIPHER_CTX_new();
+    decryptTemplate = EVP_CIPHER_CTX_new();
+    if (!encryptTemplate || !decryptTemplate ||
+        EVP_EncryptInit_ex(encryptTemplate, EVP_aes_256_gcm(), nullptr, key.Data(), nullptr) != 1 ||
+        EVP_DecryptInit_ex(decryptTemplate, EVP_aes_256_gcm(), nullptr, key.Data(), nullptr) != 1) {
+        Wipe();
+        Napi::Error::New(env, "Failed to initialize key schedule").ThrowAsJavaScriptException();
+        return;
+    }
+    
+    keyId = CryptoOperations::GetKeyId(key.Data(), key.Length());
+    destroyed = false;
+}
+
+KeyHandle::~KeyHandle() {
+    Wipe();
+}
+
+// Free every context; EVP_CIPHER_CTX_free cleanses the expanded key schedule
+void KeyHandle::Wipe() {
+    std::lock_guard<std::mutex> lock(contextMutex);
+    
+    for (EVP_CIPHER_CTX* ctx : encryptContexts) {
+        EVP_CIPHER_CTX_free(ctx);
+    }
+    for (EVP_CIPHER_CTX* ctx : decryptContexts) {
+        EVP_CIPHER_CTX_free(ctx);
+    }
+    encryptContexts.clear();
+    decryptContexts.clear();
+    
+    EVP_CIPHER_CTX_free(encryptTemplate);
+    EVP_CIPHER_CTX_free(decryptTemplate);
+    encryptTemplate = nullptr;
+    decryptTemplate = nullptr;
+    destroyed = true;
+}
+
+EVP_CIPHER_CTX* KeyHandle::AcquireContext(bool decrypt) {
+    std::lock_guard<std::mutex> lock(contextMutex);
+    
+    if (destroyed) {
+        return nullptr;
+    }
+    
+    std::vector<EVP_CIPHER_CTX*>& freeList = decrypt ? decryptContexts : encryptContexts;
+    if (!freeList.empty()) {
+        EVP_CIPHER_CTX* ctx = freeList.back();
+        freeList.pop_back();
+        return ctx;
+    }
+    
+    // First use on this thread (or more concurrent users than before):
+    // copy the template, which duplicates the expanded key schedule
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (ctx && EVP_CIPHER_CTX_copy(ctx, decrypt ? decryptTemplate : encryptTemplate) != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        ctx = nullptr;
+    }
+    return ctx;
+}
+
+void KeyHandle::ReleaseContext(EVP_CIPHER_CTX* ctx, bool decrypt) {
+    std::lock_guard<std::mutex> lock(contextMutex);
+    
+    // Handle destroyed while the context was borrowed
+    if (destroyed) {
+        EVP_CIPHER_CTX_free(ctx);
+        return;
+    }
+    
+    (decrypt ? decryptContexts : encryptContexts).push_back(ctx);
+}
+
+// handle.encrypt(data, iv) - same result shape as encryptAES256GCM
+Napi::Value KeyHandle::Encrypt(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected data and iv").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> data = info[0].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> iv = info[1].As<Napi::Buffer<uint8_t>>();
+    
+    if (iv.Length() != 12) {
+        Napi::TypeError::New(env, "IV must be 12 bytes for GCM").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    EVP_CIPHER_CTX* ctx = AcquireContext(false);
+    if (!ctx) {
+        Napi::Error::New(env, destroyed ? "Key handle has been destroyed"
+                                        : "Failed to create cipher context").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> output = Napi::Buffer<uint8_t>::New(env, data.Length());
+    uint8_t tag[16];
+    std::string error;
+    bool ok = CryptoOperations::EncryptWithContext(ctx, iv.Data(), data.Data(), data.Length(),
+                                                   output.Data(), tag, error);
+    ReleaseContext(ctx, false);
+    
+    if (!ok) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    CryptoOperations::RecordPerformanceMetric(kKeyHandleEncryptMetric, duration, data.Length());
+    CryptoOperations::LogCryptoOperation("keyHandle.encrypt", keyId, duration);
+    
+    return CryptoOperations::CreateEncryptionResult(env, output, tag, iv, keyId, duration, data.Length());
+}
+
+// handle.decrypt(ciphertext, iv, tag) - same result shape as decryptAES256GCM
+Napi::Value KeyHandle::Decrypt(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 3 || !info[0].IsBuffer() || !info[1].IsBuffer() || !info[2].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected ciphertext, iv, and tag").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> ciphertext = info[0].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> iv = info[1].As<Napi::Buffer<uint8_t>>();
+    Napi::Buffer<uint8_t> tag = info[2].As<Napi::Buffer<uint8_t>>();
+    
+    if (iv.Length() != 12) {
+        Napi::TypeError::New(env, "IV must be 12 bytes for GCM").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (tag.Length() != 16) {
+        Napi::TypeError::New(env, "Tag must be 16 bytes for GCM").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    EVP_CIPHER_CTX* ctx = AcquireContext(true);
+    if (!ctx) {
+        Napi::Error::New(env, destroyed ? "Key handle has been destroyed"
+                                        : "Failed to create cipher context").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> output = Napi::Buffer<uint8_t>::New(env, ciphertext.Length());
+    std::string error;
+    bool ok = CryptoOperations::DecryptWithContext(ctx, iv.Data(), ciphertext.Data(), ciphertext.Length(),
+                                                   tag.Data(), output.Data(), error);
+    ReleaseContext(ctx, true);
+    
+    if (!ok) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    CryptoOperations::RecordPerformanceMetric(kKeyHandleDecryptMetric, duration, ciphertext.Length());
+    CryptoOperations::LogCryptoOperation("keyHandle.decrypt", keyId, duration);
+    
+    return CryptoOperations::CreateDecryptionResult(env, output, keyId, duration, ciphertext.Length());
+}
+
+// handle.destroy() - wipe the key schedule now instead of waiting for GC
+Napi::Value KeyHandle::Destroy(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Wipe();
+    CryptoOperations::LogCryptoOperation("keyHandle.destroy", keyId, 0.0);
+    return env.Undefined();
+}
+
+Napi::Value KeyHandle::GetKeyId(const Napi::CallbackInfo& info) {
+    return Napi::String::New(info.Env(), keyId);
+}
+
+Napi::Value KeyHandle::IsDestroyed(const Napi::CallbackInfo& info) {
+    std::lock_guard<std::mutex> lock(contextMutex);
+    return Napi::Boolean::New(info.Env(), destroyed);
+}
+
+} // namespace EnterpriseCrypto
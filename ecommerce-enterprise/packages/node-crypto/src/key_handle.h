@@ -0,0 +1,56 @@
+#ifndef KEY_HANDLE_H
+#define KEY_HANDLE_H
+
+#include <napi.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <openssl/evp.h>
+
+namespace EnterpriseCrypto {
+
+// Opaque native handle for a hot AES-256-GCM data-encryption key.
+// The key schedule is expanded once into a pair of template contexts. Each
+// thread that uses the handle borrows its own pre-keyed copy from a free list
+// (so the list settles at one context per concurrent thread) and an
+// encrypt/decrypt only sets the IV and runs update/final. Raw key bytes are
+// never retained; the expanded schedules are wiped by destroy() or on GC.
+class KeyHandle : public Napi::ObjectWrap<KeyHandle> {
+public:
+    static void Init(Napi::Env env, Napi::Object exports);
+    static Napi::Object NewInstance(Napi::Env env, Napi::Value key);
+    
+    KeyHandle(const Napi::CallbackInfo& info);
+    ~KeyHandle();
+    
+    // Borrow/return a pre-keyed context; safe to call from any thread.
+    // AcquireContext returns nullptr once the handle has been destroyed.
+    EVP_CIPHER_CTX* AcquireContext(bool decrypt);
+    void ReleaseContext(EVP_CIPHER_CTX* ctx, bool decrypt);
+    
+    const std::string& KeyId() const { return keyId; }
+    
+private:
+    static Napi::FunctionReference constructor;
+    
+    // JS methods
+    Napi::Value Encrypt(const Napi::CallbackInfo& info);
+    Napi::Value Decrypt(const Napi::CallbackInfo& info);
+    Napi::Value Destroy(const Napi::CallbackInfo& info);
+    Napi::Value GetKeyId(const Napi::CallbackInfo& info);
+    Napi::Value IsDestroyed(const Napi::CallbackInfo& info);
+    
+    void Wipe();
+    
+    std::mutex contextMutex;
+    EVP_CIPHER_CTX* encryptTemplate;
+    EVP_CIPHER_CTX* decryptTemplate;
+    std::vector<EVP_CIPHER_CTX*> encryptContexts;
+    std::vector<EVP_CIPHER_CTX*> decryptContexts;
+    std::string keyId;
+    bool destroyed;
+};
+
+} // namespace EnterpriseCrypto
+
+#endif // KEY_HANDLE_H
@@ -0,0 +1,891 @@
+#include "performance_monitor.h"
+#include "audit_trail.h"
+#include "crypto_operations.h"
+#include "hash_engine.h"
+#include "kdf_pool.h"
+#include "signature_engine.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+namespace EnterpriseCrypto {
+
+std::map<std::string, std::vector<BenchmarkResult>> PerformanceBenchmark::benchmarkResults;
+std::mutex PerformanceBenchmark::benchmarkMutex;
+
+namespace {
+
+enum BenchmarkKind { kAesGcmEncrypt, kAesGcmDecrypt, kHash, kHmac, kKdf, kSign, kVerify, kAuditLog, kMetricsRecord };
+
+const uint64_t kMaxPayloadSize = 64ull * 1024 * 1024;
+const uint64_t kMaxIterations = 1000000000ull;
+const uint64_t kMaxDurationMs = 60000;
+const uint32_t kMaxThreads = 64;
+const uint64_t kDefaultPayloadSize = 1024;
+const uint64_t kDefaultKdfPayloadSize = 32;
+const uint64_t kDefaultDurationMs = 1000;
+const uint64_t kDefaultWarmupIterations = 16;
+
+// Audit runs log under this operation name; the live ring holds as many
+// records as the private one, so wraparound costs are the same
+const char* const kBenchmarkRecordName = "benchmark";
+const size_t kBenchmarkRingCapacity = 16384;
+
+// Metrics runs record into this slot of their private table
+const uint32_t kBenchmarkMetricsSlot = 1;
+
+int64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// One benchmark as requested from JS, validated on the JS thread
+struct BenchmarkSpec {
+    BenchmarkSpec()
+        : kind(kHash),
+          payloadSize(kDefaultPayloadSize),
+          threads(1),
+          warmupIterations(kDefaultWarmupIterations),
+          iterations(0),
+          durationMs(kDefaultDurationMs),
+          md(nullptr),
+          signature(SignatureEngine::Ed25519),
+          kdf(KdfParams::PBKDF2) {}
+    
+    std::string operation;
+    std::string algorithm;
+    BenchmarkKind kind;
+    uint64_t payloadSize;
+    uint32_t threads;
+    uint64_t warmupIterations;  // per thread
+    uint64_t iterations;        // per thread; 0 selects fixed-time mode
+    uint64_t durationMs;
+    const EVP_MD* md;
+    SignatureEngine::Algorithm signature;
+    KdfParams kdf;              // secret and salt are filled per thread
+};
+
+// Private stand-ins for the audit trail and metrics registry, shared by the
+// threads of one run. Benchmarks never write to the process-wide instances,
+// so they cannot evict real audit entries or show up in exported metrics.
+struct BenchmarkSinks {
+    explicit BenchmarkSinks(BenchmarkKind kind) {
+        if (kind == kAuditLog) {
+            auditRing.reset(new AuditRing(kBenchmarkRingCapacity));
+            auditStrings.reset(new AuditStringTable());
+        } else if (kind == kMetricsRecord) {
+            metrics.reset(new MetricTable());
+        }
+    }
+    
+    std::unique_ptr<AuditRing> auditRing;
+    std::unique_ptr<AuditStringTable> auditStrings;
+    std::unique_ptr<MetricTable> metrics;
+};
+
+// Per-thread inputs, outputs and keyed contexts for one run, so the timed
+// loop calls nothing but the primitive
+class BenchmarkWorkload {
+public:
+    BenchmarkWorkload(const BenchmarkSpec& spec, BenchmarkSinks& sinks)
+        : spec(spec), sinks(sinks), kdf(spec.kdf), digestContext(nullptr), macContext(nullptr),
+          metricsSequence(0) {}
+    
+    ~BenchmarkWorkload() {
+        EVP_MD_CTX_free(digestContext);
+        EVP_MAC_CTX_free(macContext);
+    }
+    
+    // Allocate buffers, generate keys and produce any input the operation
+    // consumes (ciphertext for decrypt, a signature for verify)
+    bool Prepare(std::string& error) {
+        input.resize(spec.payloadSize);
+        key.resize(32);
+        if (RAND_bytes(key.data(), static_cast<int>(key.size())) != 1 ||
+            RAND_bytes(iv, sizeof(iv)) != 1 ||
+            (!input.empty() && RAND_bytes(input.data(), static_cast<int>(input.size())) != 1)) {
+            error = "Failed to generate benchmark input";
+            return false;
+        }
+        
+        switch (spec.kind) {
+            case kAesGcmEncrypt:
+                output.resize(std::max<size_t>(input.size(), 1));
+                return true;
+            case kAesGcmDecrypt:
+                output.resize(std::max<size_t>(input.size(), 1));
+                sealed.resize(output.size());
+                return CryptoOperations::RunAES256GCMEncrypt(key.data(), iv, input.data(), input.size(),
+                                                             sealed.data(), tag, error);
+            case kHash:
+                output.resize(EVP_MAX_MD_SIZE);
+                digestContext = EVP_MD_CTX_new();
+                if (!digestContext) {
+                    error = "Failed to create digest context";
+                    return false;
+                }
+                return true;
+            case kHmac:
+                output.resize(EVP_MAX_MD_SIZE);
+                macContext = HashEngine::AcquireHMAC(spec.md, key.data(), key.size(), error);
+                return macContext != nullptr;
+            case kKdf:
+                output.resize(kdf.keyLength);
+                kdf.secret = input;
+                kdf.salt.assign(key.begin(), key.begin() + 16);
+                return true;
+            case kSign:
+            case kVerify: {
+                EVP_PKEY* generated = spec.signature == SignatureEngine::ES256
+                    ? EVP_PKEY_Q_keygen(nullptr, nullptr, "EC", "P-256")
+                    : EVP_PKEY_Q_keygen(nullptr, nullptr, "ED25519");
+                if (!generated) {
+                    error = "Failed to generate signing key";
+                    return false;
+                }
+                signingKey = SignatureEngine::KeyPtr(generated, EVP_PKEY_free);
+                return spec.kind == kSign ||
+                       SignatureEngine::Sign(signingKey.get(), spec.signature, input.data(), input.size(),
+                                             signature, error);
+            }
+            case kAuditLog:
+                // payloadSize is the details length; the record keeps the
+                // first kDetailsCapacity bytes as any caller's would
+                details.assign(spec.payloadSize, 'x');
+                return true;
+            case kMetricsRecord:
+                return true;
+        }
+        return false;
+    }
+    
+    // One operation; runs inside the timed loop
+    bool Run(std::string& error) {
+        switch (spec.kind) {
+            case kAesGcmEncrypt:
+                return CryptoOperations::RunAES256GCMEncrypt(key.data(), iv, input.data(), input.size(),
+                                                             output.data(), tag, error);
+            case kAesGcmDecrypt:
+                return CryptoOperations::RunAES256GCMDecrypt(key.data(), iv, sealed.data(), input.size(),
+                                                             tag, output.data(), error);
+            case kHash:
+                return HashEngine::Digest(digestContext, spec.md, input.data(), input.size(), output.data(), error);
+            case kHmac:
+                return HashEngine::ComputeHMAC(macContext, input.data(), input.size(),
+                                               output.data(), output.size(), error);
+            case kKdf:
+                return KdfPool::Derive(kdf, output.data(), error);
+            case kSign:
+                return SignatureEngine::Sign(signingKey.get(), spec.signature, input.data(), input.size(),
+                                             signature, error);
+            case kVerify:
+                if (!SignatureEngine::Verify(signingKey.get(), spec.signature, input.data(), input.size(),
+                                             signature.data(), signature.size())) {
+                    error = "Signature verification failed";
+                    return false;
+                }
+                return true;
+            case kAuditLog:
+                AuditTrail::EncodeRecord(*sinks.auditStrings, kBenchmarkRecordName, "benchmark-key", "benchmark-user",
+                                         true, details, "", "", "", 0.0, spec.payloadSize, record);
+                sinks.auditRing->Append(record);
+                return true;
+            case kMetricsRecord:
+                sinks.metrics->Record(kBenchmarkMetricsSlot, ++metricsSequence & 0xFFFF, spec.payloadSize);
+                return true;
+        }
+        return false;
+    }
+
+private:
+    const BenchmarkSpec& spec;
+    BenchmarkSinks& sinks;
+    KdfParams kdf;
+    std::vector<uint8_t> input;
+    std::vector<uint8_t> output;
+    std::vector<uint8_t> sealed;
+    std::vector<uint8_t> key;
+    std::vector<uint8_t> signature;
+    uint8_t iv[12];
+    uint8_t tag[16];
+    EVP_MD_CTX* digestContext;
+    EVP_MAC_CTX* macContext;
+    SignatureEngine::KeyPtr signingKey;
+    std::string details;
+    AuditRecord record;
+    uint64_t metricsSequence;       // varies the recorded duration across buckets
+};
+
+namespace {
+
+// Lets every thread finish setup and warm-up before any of them is timed
+struct StartGate {
+    StartGate() : arrived(0), open(false), deadlineNs(0), abort(false) {}
+    
+    std::mutex mutex;
+    std::condition_variable changed;
+    uint32_t arrived;
+    bool open;
+    uint64_t deadlineNs;            // fixed-time mode
+    std::atomic<bool> abort;        // set when any thread fails
+};
+
+struct ThreadOutcome {
+    ThreadOutcome()
+        : latency(LogLinearHistogram::kBucketCount, 0),
+          operations(0), startNs(0), endNs(0), minNs(UINT64_MAX), maxNs(0) {}
+    
+    std::vector<uint64_t> latency;
+    uint64_t operations;
+    uint64_t startNs;
+    uint64_t endNs;
+    uint64_t minNs;
+    uint64_t maxNs;
+    std::string error;
+};
+
+void MeasureThread(const BenchmarkSpec& spec, BenchmarkSinks& sinks, StartGate& gate, ThreadOutcome& outcome) {
+    BenchmarkWorkload workload(spec, sinks);
+    bool ok = workload.Prepare(outcome.error);
+    for (uint64_t i = 0; ok && i < spec.warmupIterations; i++) {
+        ok = workload.Run(outcome.error);
+    }
+    if (!ok) {
+        gate.abort.store(true, std::memory_order_relaxed);
+    }
+    
+    uint64_t deadlineNs;
+    {
+        std::unique_lock<std::mutex> lock(gate.mutex);
+        gate.arrived++;
+        gate.changed.notify_all();
+        gate.changed.wait(lock, [&gate] { return gate.open; });
+        deadlineNs = gate.deadlineNs;
+    }
+    if (!ok || gate.abort.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    // One clock read per operation: each stamp ends one operation and starts
+    // the next, so tiny payloads are not dominated by timer overhead
+    uint64_t last = PerformanceSpan::NowNs();
+    outcome.startNs = last;
+    while (!gate.abort.load(std::memory_order_relaxed)) {
+        if (!workload.Run(outcome.error)) {
+            gate.abort.store(true, std::memory_order_relaxed);
+            break;
+        }
+        uint64_t now = PerformanceSpan::NowNs();
+        uint64_t elapsed = now - last;
+        last = now;
+        
+        outcome.latency[LogLinearHistogram::BucketOf(elapsed)]++;
+        outcome.minNs = std::min(outcome.minNs, elapsed);
+        outcome.maxNs = std::max(outcome.maxNs, elapsed);
+        outcome.operations++;
+        
+        if (spec.iterations ? outcome.operations >= spec.iterations : now >= deadlineNs) {
+            break;
+        }
+    }
+    outcome.endNs = last;
+}
+
+// Run spec on its own threads and summarize; false (with error) if any
+// thread failed to prepare or run
+bool RunBenchmark(const BenchmarkSpec& spec, BenchmarkResult& result, std::string& error) {
+    BenchmarkSinks sinks(spec.kind);
+    StartGate gate;
+    std::vector<ThreadOutcome> outcomes(spec.threads);
+    std::vector<std::thread> threads;
+    threads.reserve(spec.threads);
+    for (uint32_t i = 0; i < spec.threads; i++) {
+        threads.emplace_back(MeasureThread, std::cref(spec), std::ref(sinks), std::ref(gate), std::ref(outcomes[i]));
+    }
+    
+    {
+        std::unique_lock<std::mutex> lock(gate.mutex);
+        gate.changed.wait(lock, [&gate, &spec] { return gate.arrived == spec.threads; });
+        gate.deadlineNs = PerformanceSpan::NowNs() + spec.durationMs * 1000000ull;
+        gate.open = true;
+    }
+    gate.changed.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    
+    for (const ThreadOutcome& outcome : outcomes) {
+        if (!outcome.error.empty()) {
+            error = spec.operation + ": " + outcome.error;
+            return false;
+        }
+    }
+    
+    std::vector<uint64_t> merged(LogLinearHistogram::kBucketCount, 0);
+    uint64_t operations = 0;
+    uint64_t busyNs = 0;
+    uint64_t startNs = UINT64_MAX;
+    uint64_t endNs = 0;
+    result.minNs = UINT64_MAX;
+    result.maxNs = 0;
+    for (const ThreadOutcome& outcome : outcomes) {
+        for (uint32_t bucket = 0; bucket < LogLinearHistogram::kBucketCount; bucket++) {
+            merged[bucket] += outcome.latency[bucket];
+        }
+        operations += outcome.operations;
+        busyNs += outcome.endNs - outcome.startNs;
+        startNs = std::min(startNs, outcome.startNs);
+        endNs = std::max(endNs, outcome.endNs);
+        result.minNs = std::min(result.minNs, outcome.minNs);
+        result.maxNs = std::max(result.maxNs, outcome.maxNs);
+    }
+    
+    double wallSeconds = static_cast<double>(endNs - startNs) / 1e9;
+    result.operation = spec.operation;
+    result.algorithm = spec.algorithm;
+    result.mode = spec.iterations ? "iterations" : "time";
+    result.payloadSize = spec.payloadSize;
+    result.threads = spec.threads;
+    result.warmupIterations = spec.warmupIterations;
+    result.operations = operations;
+    result.wallMs = wallSeconds * 1000.0;
+    result.nsPerOp = operations ? static_cast<double>(busyNs) / static_cast<double>(operations) : 0.0;
+    result.opsPerSecond = wallSeconds > 0 ? static_cast<double>(operations) / wallSeconds : 0.0;
+    result.mbPerSecond = result.opsPerSecond * static_cast<double>(spec.payloadSize) / 1e6;
+    result.p50Ns = LogLinearHistogram::ValueAtPercentile(merged.data(), operations, 50.0);
+    result.p90Ns = LogLinearHistogram::ValueAtPercentile(merged.data(), operations, 90.0);
+    result.p99Ns = LogLinearHistogram::ValueAtPercentile(merged.data(), operations, 99.0);
+    result.p999Ns = LogLinearHistogram::ValueAtPercentile(merged.data(), operations, 99.9);
+    if (!operations) {
+        result.minNs = 0;
+    }
+    result.timestampUs = NowUs();
+    return true;
+}
+
+// Option lookup across layers (per-operation options first, then shared ones)
+Napi::Value FindOption(const std::vector<Napi::Object>& layers, const char* name) {
+    for (const Napi::Object& layer : layers) {
+        if (layer.Has(name)) {
+            Napi::Value value = layer.Get(name);
+            if (!value.IsUndefined()) {
+                return value;
+            }
+        }
+    }
+    return Napi::Value();
+}
+
+bool ReadOption(const std::vector<Napi::Object>& layers, const char* name, uint64_t defaultValue,
+                uint64_t minValue, uint64_t maxValue, uint64_t& out) {
+    Napi::Value value = FindOption(layers, name);
+    double number = value.IsEmpty() ? static_cast<double>(defaultValue)
+                  : value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : -1.0;
+    if (!(number >= static_cast<double>(minValue) && number <= static_cast<double>(maxValue)) ||
+        number != static_cast<double>(static_cast<uint64_t>(number))) {
+        return false;
+    }
+    out = static_cast<uint64_t>(number);
+    return true;
+}
+
+// KDF costs under options.kdf, named as for deriveKeyFromPassword
+bool ReadKdfOptions(Napi::Object options, KdfParams& kdf) {
+    std::vector<Napi::Object> layers(1, options);
+    uint64_t keyLength = 0;
+    bool valid = ReadOption(layers, "keyLength", 32, 1, 1024, keyLength);
+    kdf.keyLength = static_cast<size_t>(keyLength);
+    switch (kdf.algorithm) {
+        case KdfParams::PBKDF2:
+            return valid && ReadOption(layers, "iterations", 600000, 1, INT_MAX, kdf.iterations);
+        case KdfParams::Scrypt:
+            return valid && ReadOption(layers, "N", 16384, 2, uint64_t(1) << 32, kdf.costN) &&
+                   (kdf.costN & (kdf.costN - 1)) == 0 &&
+                   ReadOption(layers, "r", 8, 1, 1024, kdf.blockSize) &&
+                   ReadOption(layers, "p", 1, 1, 1024, kdf.parallelization) &&
+                   ReadOption(layers, "maxmem", 64ull * 1024 * 1024, 1024 * 1024, uint64_t(1) << 40, kdf.maxMemory);
+        case KdfParams::Argon2id:
+            return valid && ReadOption(layers, "iterations", 2, 1, UINT32_MAX, kdf.iterations) &&
+                   ReadOption(layers, "parallelism", 1, 1, 255, kdf.parallelization) &&
+                   ReadOption(layers, "memoryCost", 19456, 8 * kdf.parallelization, UINT32_MAX, kdf.memoryCost);
+        case KdfParams::HKDF:
+            return valid;
+    }
+    return false;
+}
+
+// Build a spec for operation from option layers; throws and returns false
+// when the operation or an option is invalid
+bool ParseSpec(Napi::Env env, const std::string& operation, const std::vector<Napi::Object>& layers,
+               BenchmarkSpec& spec) {
+    spec.operation = operation;
+    
+    Napi::Value algorithmValue = FindOption(layers, "algorithm");
+    spec.algorithm = !algorithmValue.IsEmpty() && algorithmValue.IsString()
+        ? algorithmValue.As<Napi::String>().Utf8Value() : "";
+    
+    if (operation == "aes-256-gcm-encrypt" || operation == "aes-256-gcm-decrypt") {
+        spec.kind = operation == "aes-256-gcm-encrypt" ? kAesGcmEncrypt : kAesGcmDecrypt;
+        spec.algorithm = "aes-256-gcm";
+    } else if (operation == "hash" || operation == "hmac") {
+        spec.kind = operation == "hash" ? kHash : kHmac;
+        if (spec.algorithm.empty()) {
+            spec.algorithm = operation == "hash" ? "sha256" : "hmac-sha256";
+        }
+        spec.md = HashEngine::ResolveDigest(spec.algorithm);
+        if (!spec.md) {
+            Napi::TypeError::New(env, "Unsupported " + operation + " algorithm: " + spec.algorithm).ThrowAsJavaScriptException();
+            return false;
+        }
+    } else if (operation == "pbkdf2" || operation == "scrypt" || operation == "argon2id" || operation == "hkdf") {
+        spec.kind = kKdf;
+        spec.kdf.algorithm = operation == "pbkdf2" ? KdfParams::PBKDF2
+                           : operation == "scrypt" ? KdfParams::Scrypt
+                           : operation == "argon2id" ? KdfParams::Argon2id : KdfParams::HKDF;
+        if (spec.kdf.algorithm == KdfParams::PBKDF2 || spec.kdf.algorithm == KdfParams::HKDF) {
+            spec.kdf.digest = spec.algorithm.empty() ? "sha256" : spec.algorithm;
+            spec.algorithm = spec.kdf.digest;
+            if (!HashEngine::ResolveDigest(spec.kdf.digest)) {
+                Napi::TypeError::New(env, "Unsupported " + operation + " digest: " + spec.kdf.digest).ThrowAsJavaScriptException();
+                return false;
+            }
+        } else {
+            spec.algorithm = operation;
+        }
+        Napi::Value kdfOptions = FindOption(layers, "kdf");
+        if (!ReadKdfOptions(!kdfOptions.IsEmpty() && kdfOptions.IsObject() ? kdfOptions.As<Napi::Object>()
+                                                                           : Napi::Object::New(env), spec.kdf)) {
+            Napi::RangeError::New(env, "Invalid " + operation + " parameters").ThrowAsJavaScriptException();
+            return false;
+        }
+    } else if (operation == "sign" || operation == "verify") {
+        spec.kind = operation == "sign" ? kSign : kVerify;
+        spec.signature = SignatureEngine::ParseAlgorithm(spec.algorithm.empty() ? "ed25519" : spec.algorithm);
+        if (spec.signature == SignatureEngine::Unknown) {
+            Napi::TypeError::New(env, "Unsupported signature algorithm: " + spec.algorithm).ThrowAsJavaScriptException();
+            return false;
+        }
+        spec.algorithm = SignatureEngine::AlgorithmName(spec.signature);
+    } else if (operation == "audit-log" || operation == "metrics-record") {
+        spec.kind = operation == "audit-log" ? kAuditLog : kMetricsRecord;
+        spec.algorithm = operation;
+    } else {
+        Napi::TypeError::New(env, "Unknown benchmark operation: " + operation).ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    uint64_t threads = 1;
+    bool valid = ReadOption(layers, "payloadSize", spec.kind == kKdf ? kDefaultKdfPayloadSize : kDefaultPayloadSize,
+                            0, kMaxPayloadSize, spec.payloadSize) &&
+                 ReadOption(layers, "threads", 1, 1, kMaxThreads, threads) &&
+                 ReadOption(layers, "warmupIterations", kDefaultWarmupIterations, 0, kMaxIterations, spec.warmupIterations) &&
+                 ReadOption(layers, "iterations", 0, 0, kMaxIterations, spec.iterations) &&
+                 ReadOption(layers, "durationMs", kDefaultDurationMs, 1, kMaxDurationMs, spec.durationMs);
+    if (!valid) {
+        Napi::RangeError::New(env, "Invalid benchmark options for " + operation).ThrowAsJavaScriptException();
+        return false;
+    }
+    spec.threads = static_cast<uint32_t>(threads);
+    return true;
+}
+
+// Sizes or thread counts for a stress test: a number, an array of numbers
+// or the defaults
+bool ReadList(Napi::Object options, const char* name, const std::vector<uint64_t>& defaults,
+              uint64_t minValue, uint64_t maxValue, std::vector<uint64_t>& out) {
+    Napi::Value value = options.Has(name) ? options.Get(name) : Napi::Value();
+    if (value.IsEmpty() || value.IsUndefined()) {
+        out = defaults;
+        return true;
+    }
+    
+    std::vector<Napi::Value> items;
+    if (value.IsArray()) {
+        Napi::Array array = value.As<Napi::Array>();
+        for (uint32_t i = 0; i < array.Length(); i++) {
+            items.push_back(array.Get(i));
+        }
+    } else {
+        items.push_back(value);
+    }
+    
+    for (const Napi::Value& item : items) {
+        double number = item.IsNumber() ? item.As<Napi::Number>().DoubleValue() : -1.0;
+        if (!(number >= static_cast<double>(minValue) && number <= static_cast<double>(maxValue)) ||
+            number != static_cast<double>(static_cast<uint64_t>(number))) {
+            return false;
+        }
+        out.push_back(static_cast<uint64_t>(number));
+    }
+    return !out.empty();
+}
+
+} // namespace
+
+// Runs a list of specs back to back off the JS thread and settles one
+// promise with the results, shaped for the entry point that queued it.
+//
+// Runs are serialized so two benchmarks never compete for the same cores.
+// The queue lives on the JS thread and the next run is only handed to the
+// threadpool once the previous one completes, so a waiting run never holds
+// a threadpool thread. Each environment has its own JS thread and queue.
+class BenchmarkWorker : public Napi::AsyncWorker {
+public:
+    enum Reply { kSingle, kCompare, kStress };
+    
+    BenchmarkWorker(Napi::Env env, Reply reply, std::vector<BenchmarkSpec> specs)
+        : Napi::AsyncWorker(env, "benchmarkOperation"),
+          deferred(Napi::Promise::Deferred::New(env)),
+          reply(reply),
+          specs(std::move(specs)) {}
+    
+    Napi::Promise GetPromise() const {
+        return deferred.Promise();
+    }
+    
+    // Start worker now, or behind the runs already queued from this thread
+    static void Schedule(BenchmarkWorker* worker) {
+        if (inFlight) {
+            pending.push_back(worker);
+            return;
+        }
+        inFlight = true;
+        worker->Queue();
+    }
+
+protected:
+    // Runs on a threadpool thread - no N-API calls allowed here
+    void Execute() override {
+        results.resize(specs.size());
+        for (size_t i = 0; i < specs.size(); i++) {
+            std::string error;
+            if (!RunBenchmark(specs[i], results[i], error)) {
+                SetError(error);
+                return;
+            }
+        }
+    }
+    
+    void OnOK() override {
+        Napi::Env env = Env();
+        StartNext();
+        
+        for (const BenchmarkResult& result : results) {
+            PerformanceBenchmark::StoreResult(result);
+        }
+        
+        if (reply == kSingle) {
+            deferred.Resolve(PerformanceBenchmark::ResultToObject(env, results[0]));
+            return;
+        }
+        
+        Napi::Array array = Napi::Array::New(env, results.size());
+        for (size_t i = 0; i < results.size(); i++) {
+            Napi::Object entry = PerformanceBenchmark::ResultToObject(env, results[i]);
+            if (reply == kCompare) {
+                // Mean latency relative to the first operation
+                double baseline = results[0].nsPerOp;
+                entry.Set("relative", baseline > 0 ? results[i].nsPerOp / baseline : 0.0);
+            } else {
+                // Throughput gained per added thread, against the first thread
+                // count run for the same payload size (1.0 = linear scaling)
+                const BenchmarkResult* base = &results[i];
+                for (const BenchmarkResult& other : results) {
+                    if (other.payloadSize == results[i].payloadSize) {
+                        base = &other;
+                        break;
+                    }
+                }
+                double expected = base->opsPerSecond * results[i].threads / base->threads;
+                entry.Set("scalingEfficiency", expected > 0 ? results[i].opsPerSecond / expected : 0.0);
+            }
+            array.Set(static_cast<uint32_t>(i), entry);
+        }
+        deferred.Resolve(array);
+    }
+    
+    void OnError(const Napi::Error& error) override {
+        StartNext();
+        deferred.Reject(error.Value());
+    }
+
+private:
+    // This run is done with the threadpool; hand it to the next one
+    static void StartNext() {
+        if (pending.empty()) {
+            inFlight = false;
+            return;
+        }
+        BenchmarkWorker* next = pending.front();
+        pending.pop_front();
+        next->Queue();
+    }
+    
+    static thread_local std::deque<BenchmarkWorker*> pending;
+    static thread_local bool inFlight;
+    
+    Napi::Promise::Deferred deferred;
+    Reply reply;
+    std::vector<BenchmarkSpec> specs;
+    std::vector<BenchmarkResult> results;
+};
+
+thread_local std::deque<BenchmarkWorker*> BenchmarkWorker::pending;
+thread_local bool BenchmarkWorker::inFlight = false;
+
+// Register benchmark functions
+void PerformanceBenchmark::Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("benchmarkOperation", Napi::Function::New(env, BenchmarkOperation));
+    exports.Set("compareOperations", Napi::Function::New(env, CompareOperations));
+    exports.Set("runStressTest", Napi::Function::New(env, RunStressTest));
+    exports.Set("benchmarkNoop", Napi::Function::New(env, BenchmarkNoop));
+    exports.Set("getBenchmarkResults", Napi::Function::New(env, GetBenchmarkResults));
+    exports.Set("exportBenchmarkData", Napi::Function::New(env, ExportBenchmarkData));
+    exports.Set("getBenchmarkHistory", Napi::Function::New(env, GetBenchmarkHistory));
+}
+
+// benchmarkOperation(operation, { payloadSize, threads, iterations | durationMs,
+//                                 warmupIterations, algorithm, kdf })
+Napi::Value PerformanceBenchmark::BenchmarkOperation(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected operation name").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::vector<Napi::Object> layers;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        layers.push_back(info[1].As<Napi::Object>());
+    }
+    
+    std::vector<BenchmarkSpec> specs(1);
+    if (!ParseSpec(env, info[0].As<Napi::String>().Utf8Value(), layers, specs[0])) {
+        return env.Null();
+    }
+    
+    BenchmarkWorker* worker = new BenchmarkWorker(env, BenchmarkWorker::kSingle, std::move(specs));
+    Napi::Promise promise = worker->GetPromise();
+    BenchmarkWorker::Schedule(worker);
+    return promise;
+}
+
+// compareOperations([operation | { operation, ...options }], sharedOptions)
+// runs each under the same conditions; results carry nsPerOp relative to
+// the first
+Napi::Value PerformanceBenchmark::CompareOperations(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsArray() || info[0].As<Napi::Array>().Length() == 0) {
+        Napi::TypeError::New(env, "Expected a non-empty array of operations").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Array operations = info[0].As<Napi::Array>();
+    std::vector<BenchmarkSpec> specs(operations.Length());
+    for (uint32_t i = 0; i < operations.Length(); i++) {
+        Napi::Value item = operations.Get(i);
+        std::vector<Napi::Object> layers;
+        std::string operation;
+        if (item.IsString()) {
+            operation = item.As<Napi::String>().Utf8Value();
+        } else if (item.IsObject() && item.As<Napi::Object>().Get("operation").IsString()) {
+            layers.push_back(item.As<Napi::Object>());
+            operation = layers[0].Get("operation").As<Napi::String>().Utf8Value();
+        } else {
+            Napi::TypeError::New(env, "Each operation must be a name or { operation, ...options }").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (info.Length() > 1 && info[1].IsObject()) {
+            layers.push_back(info[1].As<Napi::Object>());
+        }
+        if (!ParseSpec(env, operation, layers, specs[i])) {
+            return env.Null();
+        }
+    }
+    
+    BenchmarkWorker* worker = new BenchmarkWorker(env, BenchmarkWorker::kCompare, std::move(specs));
+    Napi::Promise promise = worker->GetPromise();
+    BenchmarkWorker::Schedule(worker);
+    return promise;
+}
+
+// runStressTest(operation, { payloadSizes, threads, ...options }) benchmarks
+// every size x thread-count pair; results carry scalingEfficiency
+Napi::Value PerformanceBenchmark::RunStressTest(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected operation name").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string operation = info[0].As<Napi::String>().Utf8Value();
+    Napi::Object options = info.Length() > 1 && info[1].IsObject() ? info[1].As<Napi::Object>() : Napi::Object::New(env);
+    
+    std::vector<uint64_t> defaultThreads = { 1, 2, 4 };
+    uint64_t hardware = std::min<uint64_t>(std::thread::hardware_concurrency(), kMaxThreads);
+    if (hardware > 4) {
+        defaultThreads.push_back(hardware);
+    }
+    
+    std::vector<uint64_t> payloadSizes;
+    std::vector<uint64_t> threadCounts;
+    if (!ReadList(options, "payloadSizes", { 64, 1024, 16384, 1024 * 1024 }, 0, kMaxPayloadSize, payloadSizes) ||
+        !ReadList(options, "threads", defaultThreads, 1, kMaxThreads, threadCounts)) {
+        Napi::RangeError::New(env, "Invalid payloadSizes or threads").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Per-run options other than the two axes are shared by every run
+    std::vector<Napi::Object> layers(1, options);
+    std::vector<BenchmarkSpec> specs;
+    for (uint64_t payloadSize : payloadSizes) {
+        for (uint64_t threads : threadCounts) {
+            Napi::Object run = Napi::Object::New(env);
+            run.Set("payloadSize", static_cast<double>(payloadSize));
+            run.Set("threads", static_cast<double>(threads));
+            layers.insert(layers.begin(), run);
+            specs.emplace_back();
+            bool valid = ParseSpec(env, operation, layers, specs.back());
+            layers.erase(layers.begin());
+            if (!valid) {
+                return env.Null();
+            }
+        }
+    }
+    
+    BenchmarkWorker* worker = new BenchmarkWorker(env, BenchmarkWorker::kStress, std::move(specs));
+    Napi::Promise promise = worker->GetPromise();
+    BenchmarkWorker::Schedule(worker);
+    return promise;
+}
+
+// Does nothing. Timing a loop of these from JS gives the bare cost of a call
+// into the addon, to separate from marshalling and from the primitive.
+Napi::Value PerformanceBenchmark::BenchmarkNoop(const Napi::CallbackInfo& info) {
+    return info.Env().Undefined();
+}
+
+void PerformanceBenchmark::StoreResult(const BenchmarkResult& result) {
+    std::string key = result.operation + "/" + result.algorithm + "/" +
+                      std::to_string(result.payloadSize) + "/" + std::to_string(result.threads);
+    
+    std::lock_guard<std::mutex> lock(benchmarkMutex);
+    std::vector<BenchmarkResult>& history = benchmarkResults[key];
+    if (history.size() >= kMaxHistory) {
+        history.erase(history.begin());
+    }
+    history.push_back(result);
+}
+
+Napi::Object PerformanceBenchmark::ResultToObject(Napi::Env env, const BenchmarkResult& result) {
+    Napi::Object object = Napi::Object::New(env);
+    object.Set("operation", result.operation);
+    object.Set("algorithm", result.algorithm);
+    object.Set("mode", result.mode);
+    object.Set("payloadSize", static_cast<double>(result.payloadSize));
+    object.Set("threads", static_cast<double>(result.threads));
+    object.Set("warmupIterations", static_cast<double>(result.warmupIterations));
+    object.Set("operations", static_cast<double>(result.operations));
+    object.Set("durationMs", result.wallMs);
+    object.Set("nsPerOp", result.nsPerOp);
+    object.Set("opsPerSecond", result.opsPerSecond);
+    object.Set("mbPerSecond", result.mbPerSecond);
+    
+    Napi::Object latency = Napi::Object::New(env);
+    latency.Set("min", static_cast<double>(result.minNs));
+    latency.Set("p50", static_cast<double>(result.p50Ns));
+    latency.Set("p90", static_cast<double>(result.p90Ns));
+    latency.Set("p99", static_cast<double>(result.p99Ns));
+    latency.Set("p999", static_cast<double>(result.p999Ns));
+    latency.Set("max", static_cast<double>(result.maxNs));
+    object.Set("latencyNs", latency);
+    
+    object.Set("timestamp", static_cast<double>(result.timestampUs / 1000));
+    return object;
+}
+
+// Latest result per operation/algorithm/size/threads
+Napi::Value PerformanceBenchmark::GetBenchmarkResults(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object results = Napi::Object::New(env);
+    
+    std::lock_guard<std::mutex> lock(benchmarkMutex);
+    for (const auto& entry : benchmarkResults) {
+        results.Set(entry.first, ResultToObject(env, entry.second.back()));
+    }
+    return results;
+}
+
+// getBenchmarkHistory(operation?) - stored runs, oldest first per configuration
+Napi::Value PerformanceBenchmark::GetBenchmarkHistory(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::string operation = info.Length() > 0 && info[0].IsString() ? info[0].As<Napi::String>().Utf8Value() : "";
+    Napi::Array history = Napi::Array::New(env);
+    
+    std::lock_guard<std::mutex> lock(benchmarkMutex);
+    uint32_t index = 0;
+    for (const auto& entry : benchmarkResults) {
+        for (const BenchmarkResult& result : entry.second) {
+            if (operation.empty() || result.operation == operation) {
+                history.Set(index++, ResultToObject(env, result));
+            }
+        }
+    }
+    return history;
+}
+
+// exportBenchmarkData('json' | 'csv') - every stored run
+Napi::Value PerformanceBenchmark::ExportBenchmarkData(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::string format = info.Length() > 0 && info[0].IsString() ? info[0].As<Napi::String>().Utf8Value() : "json";
+    
+    if (format != "json" && format != "csv") {
+        Napi::TypeError::New(env, "Unsupported benchmark export format: " + format).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::lock_guard<std::mutex> lock(benchmarkMutex);
+    
+    if (format == "json") {
+        Napi::Array results = Napi::Array::New(env);
+        uint32_t index = 0;
+        for (const auto& entry : benchmarkResults) {
+            for (const BenchmarkResult& result : entry.second) {
+                results.Set(index++, ResultToObject(env, result));
+            }
+        }
+        Napi::Object data = Napi::Object::New(env);
+        data.Set("timestamp", static_cast<double>(NowUs() / 1000));
+        data.Set("results", results);
+        return data;
+    }
+    
+    std::string csv = "timestamp,operation,algorithm,mode,payloadSize,threads,operations,durationMs,"
+                      "nsPerOp,opsPerSecond,mbPerSecond,minNs,p50Ns,p90Ns,p99Ns,p999Ns,maxNs\n";
+    char line[512];
+    for (const auto& entry : benchmarkResults) {
+        for (const BenchmarkResult& result : entry.second) {
+            snprintf(line, sizeof(line), "%lld,%s,%s,%s,%llu,%u,%llu,%.3f,%.1f,%.1f,%.3f,%llu,%llu,%llu,%llu,%llu,%llu\n",
+                     static_cast<long long>(result.timestampUs / 1000), result.operation.c_str(),
+                     result.algorithm.c_str(), result.mode.c_str(),
+                     static_cast<unsigned long long>(result.payloadSize), result.threads,
+                     static_cast<unsigned long long>(result.operations), result.wallMs,
+                     result.nsPerOp, result.opsPerSecond, result.mbPerSecond,
+                     static_cast<unsigned long long>(result.minNs), static_cast<unsigned long long>(result.p50Ns),
+                     static_cast<unsigned long long>(result.p90Ns), static_cast<unsigned long long>(result.p99Ns),
+                     static_cast<unsigned long long>(result.p999Ns), static_cast<unsigned long long>(result.maxNs));
+            csv += line;
+        }
+    }
+    return Napi::String::New(env, csv);
+}
+
+} // namespace EnterpriseCrypto
@@ -3,53 +3,327 @@
 #include <numeric>
 #include <sstream>
 #include <iomanip>
+#include <limits>
+#include <cmath>
+#include <unordered_map>
+#include <memory>
+#include <cstring>
+#include <cstdio>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace EnterpriseCrypto {
 
 // Static member definitions
-std::map<std::string, PerformanceMetric> PerformanceMonitor::metrics;
-std::map<std::string, std::chrono::high_resolution_clock::time_point> PerformanceMonitor::activeTimers;
-std::mutex PerformanceMonitor::metricsMutex;
 std::map<std::string, double> PerformanceMonitor::performanceThresholds;
 
 std::atomic<bool> RealTimeMonitor::isMonitoring{false};
-std::chrono::milliseconds RealTimeMonitor::monitoringInterval{1000};
-std::map<std::string, double> RealTimeMonitor::alertThresholds;
-std::vector<std::string> RealTimeMonitor::activeAlerts;
+std::atomic<int64_t> RealTimeMonitor::monitoringIntervalMs{1000};
+std::map<std::string, AlertThreshold> RealTimeMonitor::alertThresholds;
+std::map<std::string, AlertEvent> RealTimeMonitor::activeAlerts;
 std::mutex RealTimeMonitor::alertMutex;
 
-std::map<std::string, std::vector<double>> PerformanceBenchmark::benchmarkResults;
-std::mutex PerformanceBenchmark::benchmarkMutex;
+namespace {
+
+const uint32_t kMaxOperations = MetricTable::kSlotCount;
+const uint32_t kMaxShards = MetricTable::kShardCount;
+
+// Slot 0 collects names registered after the table is full
+const uint32_t kOverflowSlot = 0;
+
+// Exposed duration buckets: powers of two from ~1us to ~17s. Each is a
+// log-linear group boundary, so everything below one is exact. OpenMetrics
+// `le` is inclusive, but a duration equal to the bound shares a bucket with
+// larger ones, so those hits are counted on the side.
+const uint32_t kFirstBoundBits = 10;
+const uint32_t kLastBoundBits = 34;
+const uint32_t kBoundCount = kLastBoundBits - kFirstBoundBits + 1;
+
+// One operation's counters in one shard
+struct OperationCounters {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> totalBytes{0};
+    std::atomic<uint64_t> minNs{UINT64_MAX};
+    std::atomic<uint64_t> maxNs{0};
+    std::atomic<int64_t> firstCallUs{0};
+    std::atomic<int64_t> lastCallUs{0};
+    LogLinearHistogram latency; // nanoseconds
+    LogLinearHistogram size;    // bytes
+    std::atomic<uint64_t> onBound[kBoundCount] = {}; // durations of exactly 2^(kFirstBoundBits + i) ns
+    
+    void Reset() {
+        count.store(0, std::memory_order_relaxed);
+        failures.store(0, std::memory_order_relaxed);
+        totalNs.store(0, std::memory_order_relaxed);
+        totalBytes.store(0, std::memory_order_relaxed);
+        minNs.store(UINT64_MAX, std::memory_order_relaxed);
+        maxNs.store(0, std::memory_order_relaxed);
+        firstCallUs.store(0, std::memory_order_relaxed);
+        lastCallUs.store(0, std::memory_order_relaxed);
+        latency.Reset();
+        size.Reset();
+        for (std::atomic<uint64_t>& hits : onBound) {
+            hits.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+} // namespace
+
+// Threads take shards round-robin, so up to kMaxShards recording threads
+// never write the same cache lines. Past that, threads share shards and the
+// atomics keep the counts exact. Counters are allocated on a thread's first
+// record of an operation and live as long as the table.
+struct MetricTable::Shard {
+    std::atomic<OperationCounters*> operations[kMaxOperations] = {};
+};
+
+namespace {
+
+// Shared by every table, so a thread keeps one shard index everywhere
+std::atomic<uint32_t> nextShard{0};
+
+// The table behind PerformanceMonitor. Never destroyed: worker and sampler
+// threads may still record while the process exits.
+MetricTable& GlobalMetrics() {
+    static MetricTable* table = new MetricTable();
+    return *table;
+}
+
+// Names are only appended; a slot's name is published before its id
+struct OperationRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, uint32_t> slots;
+    std::string names[kMaxOperations];
+    std::atomic<uint32_t> count{1};
+    
+    OperationRegistry() {
+        names[kOverflowSlot] = "other";
+        slots.emplace(names[kOverflowSlot], kOverflowSlot);
+    }
+};
+
+// Function-local so other files can register slots during static init
+OperationRegistry& Registry() {
+    static OperationRegistry registry;
+    return registry;
+}
+
+// Only ids handed out by RegisterOperation; anything else would record into
+// a slot no export reads
+bool SlotRegistered(uint32_t slot) {
+    return slot < Registry().count.load(std::memory_order_acquire);
+}
+
+bool FindSlot(const std::string& operation, uint32_t& slot) {
+    OperationRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.slots.find(operation);
+    if (it == registry.slots.end()) {
+        return false;
+    }
+    slot = it->second;
+    return true;
+}
+
+OperationCounters* ShardCounters(MetricTable::Shard& shard, uint32_t slot) {
+    OperationCounters* counters = shard.operations[slot].load(std::memory_order_acquire);
+    if (counters) {
+        return counters;
+    }
+    
+    OperationCounters* fresh = new OperationCounters();
+    if (shard.operations[slot].compare_exchange_strong(counters, fresh, std::memory_order_acq_rel)) {
+        return fresh;
+    }
+    delete fresh;
+    return counters;
+}
+
+// One slot's counters summed over every shard
+struct MergedCounters {
+    uint64_t count;
+    uint64_t failures;
+    uint64_t totalNs;
+    uint64_t totalBytes;
+    uint64_t minNs;
+    uint64_t maxNs;
+    int64_t firstUs;
+    int64_t lastUs;
+    uint64_t latency[LogLinearHistogram::kBucketCount];
+    uint64_t size[LogLinearHistogram::kBucketCount];
+    uint64_t onBound[kBoundCount];
+};
+
+// Shards are read while being written, so totals may trail the histograms
+// by a few in-flight calls
+void MergeSlot(uint32_t slot, MergedCounters& merged) {
+    std::memset(&merged, 0, sizeof(merged));
+    merged.minNs = UINT64_MAX;
+    
+    for (uint32_t i = 0; i < kMaxShards; i++) {
+        const OperationCounters* counters = GlobalMetrics().ShardAt(i).operations[slot].load(std::memory_order_acquire);
+        if (!counters || counters->count.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        merged.count += counters->count.load(std::memory_order_relaxed);
+        merged.failures += counters->failures.load(std::memory_order_relaxed);
+        merged.totalNs += counters->totalNs.load(std::memory_order_relaxed);
+        merged.totalBytes += counters->totalBytes.load(std::memory_order_relaxed);
+        merged.minNs = std::min(merged.minNs, counters->minNs.load(std::memory_order_relaxed));
+        merged.maxNs = std::max(merged.maxNs, counters->maxNs.load(std::memory_order_relaxed));
+        int64_t first = counters->firstCallUs.load(std::memory_order_relaxed);
+        if (first != 0 && (merged.firstUs == 0 || first < merged.firstUs)) {
+            merged.firstUs = first;
+        }
+        merged.lastUs = std::max(merged.lastUs, counters->lastCallUs.load(std::memory_order_relaxed));
+        counters->latency.MergeInto(merged.latency);
+        counters->size.MergeInto(merged.size);
+        for (uint32_t i = 0; i < kBoundCount; i++) {
+            merged.onBound[i] += counters->onBound[i].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+int64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string FormatIso(std::chrono::system_clock::time_point time) {
+    auto time_t = std::chrono::system_clock::to_time_t(time);
+    std::stringstream ss;
+    ss << std::put_time(std::gmtime(&time_t), "%Y-%m-%dT%H:%M:%SZ");
+    return ss.str();
+}
+
+} // namespace
+
+void LogLinearHistogram::Reset() {
+    for (std::atomic<uint64_t>& count : counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LogLinearHistogram::MergeInto(uint64_t* merged) const {
+    for (uint32_t i = 0; i < kBucketCount; i++) {
+        merged[i] += counts[i].load(std::memory_order_relaxed);
+    }
+}
+
+uint32_t LogLinearHistogram::BucketOf(uint64_t value) {
+    if (value < kSubBucketCount) {
+        return static_cast<uint32_t>(value);
+    }
+    value = std::min<uint64_t>(value, (1ull << kMaxValueBits) - 1);
+    
+#ifdef _MSC_VER
+    unsigned long top;
+    _BitScanReverse64(&top, value);
+#else
+    uint32_t top = 63 - __builtin_clzll(value);
+#endif
+    // The kSubBucketBits bits below the leading one pick the sub-bucket
+    uint32_t shift = static_cast<uint32_t>(top) - kSubBucketBits;
+    uint32_t sub = static_cast<uint32_t>(value >> shift) - kSubBucketCount;
+    return (shift + 1) * kSubBucketCount + sub;
+}
+
+uint64_t LogLinearHistogram::BucketLowerBound(uint32_t bucket) {
+    uint32_t group = bucket / kSubBucketCount;
+    uint64_t sub = bucket % kSubBucketCount;
+    return group == 0 ? sub : (kSubBucketCount + sub) << (group - 1);
+}
+
+// Midpoint of the bucket holding the value at that rank
+uint64_t LogLinearHistogram::ValueAtPercentile(const uint64_t* merged, uint64_t total, double percentile) {
+    if (total == 0) {
+        return 0;
+    }
+    
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total)));
+    rank = std::max<uint64_t>(1, std::min(rank, total));
+    
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < kBucketCount; i++) {
+        seen += merged[i];
+        if (seen >= rank) {
+            uint32_t group = i / kSubBucketCount;
+            uint64_t width = group == 0 ? 1 : 1ull << (group - 1);
+            return BucketLowerBound(i) + width / 2;
+        }
+    }
+    return BucketLowerBound(kBucketCount - 1);
+}
 
 // Initialize performance monitoring system
 void PerformanceMonitor::Init(Napi::Env env, Napi::Object exports) {
-    // Core performance tracking
-    exports.Set("recordOperation", Napi::Function::New(env, [](const Napi::CallbackInfo& info) {
-        if (info.Length() >= 2) {
+    // Core performance tracking; accepts (operation, duration, dataSize) and
+    // (operation, duration, success, dataSize)
+    exports.Set("recordOperation", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+        if (info.Length() >= 2 && info[0].IsString() && info[1].IsNumber()) {
             std::string operation = info[0].As<Napi::String>().Utf8Value();
             double duration = info[1].As<Napi::Number>().DoubleValue();
-            size_t dataSize = info.Length() > 2 ? info[2].As<Napi::Number>().Uint32Value() : 0;
+            bool success = true;
+            size_t sizeIndex = 2;
+            if (info.Length() > 2 && info[2].IsBoolean()) {
+                success = info[2].As<Napi::Boolean>().Value();
+                sizeIndex = 3;
+            }
+            size_t dataSize = info.Length() > sizeIndex && info[sizeIndex].IsNumber()
+                ? static_cast<size_t>(info[sizeIndex].As<Napi::Number>().Int64Value()) : 0;
             
-            RecordOperation(operation, duration, dataSize);
+            RecordOperation(operation, duration, dataSize, success);
         }
-        return env.Undefined();
+        return info.Env().Undefined();
     }));
     
-    exports.Set("startTimer", Napi::Function::New(env, [](const Napi::CallbackInfo& info) {
-        if (info.Length() >= 1) {
-            std::string operation = info[0].As<Napi::String>().Utf8Value();
-            StartTimer(operation);
+    // Slot for an operation name, accepted by endSpan() in place of the name
+    exports.Set("registerOperation", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "Expected operation name").ThrowAsJavaScriptException();
+            return env.Null();
         }
-        return env.Undefined();
+        return Napi::Number::New(env, RegisterOperation(info[0].As<Napi::String>().Utf8Value()));
     }));
     
-    exports.Set("endTimer", Napi::Function::New(env, [](const Napi::CallbackInfo& info) {
-        if (info.Length() >= 1) {
-            std::string operation = info[0].As<Napi::String>().Utf8Value();
-            size_t dataSize = info.Length() > 1 ? info[1].As<Napi::Number>().Uint32Value() : 0;
-            EndTimer(operation, dataSize);
+    // Start stamp in nanoseconds from the monotonic clock. The caller keeps
+    // it, so overlapping spans of one operation don't collide, and it stays
+    // valid in worker threads of the same process.
+    exports.Set("startSpan", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+        return Napi::Number::New(info.Env(), static_cast<double>(PerformanceSpan::NowNs()));
+    }));
+    
+    // (operation | slot, startStamp, dataSize, success) -> duration in ms
+    exports.Set("endSpan", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+        Napi::Env env = info.Env();
+        uint64_t endNs = PerformanceSpan::NowNs();
+        
+        if (info.Length() < 2 || !(info[0].IsString() || info[0].IsNumber()) || !info[1].IsNumber()) {
+            Napi::TypeError::New(env, "Expected operation and start stamp").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        
+        uint32_t slot = info[0].IsString()
+            ? RegisterOperation(info[0].As<Napi::String>().Utf8Value())
+            : info[0].As<Napi::Number>().Uint32Value();
+        if (!SlotRegistered(slot)) {
+            Napi::RangeError::New(env, "Unknown operation slot; use registerOperation()").ThrowAsJavaScriptException();
+            return env.Null();
         }
-        return env.Undefined();
+        double startNs = info[1].As<Napi::Number>().DoubleValue();
+        uint64_t durationNs = startNs > 0 && startNs < static_cast<double>(endNs)
+            ? endNs - static_cast<uint64_t>(startNs) : 0;
+        uint64_t dataSize = info.Length() > 2 && info[2].IsNumber()
+            ? static_cast<uint64_t>(std::max<int64_t>(0, info[2].As<Napi::Number>().Int64Value())) : 0;
+        bool success = info.Length() <= 3 || !info[3].IsBoolean() || info[3].As<Napi::Boolean>().Value();
+        
+        RecordOperation(slot, durationNs, dataSize, success);
+        return Napi::Number::New(env, durationNs / 1e6);
     }));
     
     // Performance metrics retrieval
@@ -75,89 +349,217 @@ void PerformanceMonitor::Init(Napi::Env env, Napi::Object exports) {
     exports.Set("getPerformanceAlerts", Napi::Function::New(env, GetPerformanceAlerts));
 }
 
-// Record a performance metric
-void PerformanceMonitor::RecordOperation(const std::string& operation, double duration, size_t dataSize) {
-    std::lock_guard<std::mutex> lock(metricsMutex);
-    UpdateMetric(operation, duration, dataSize);
+// Slot for an operation name, registering it on first sight
+uint32_t PerformanceMonitor::RegisterOperation(const std::string& operation) {
+    // Ids never change, so the per-thread cache never goes stale
+    thread_local std::unordered_map<std::string, uint32_t> cache;
+    auto cached = cache.find(operation);
+    if (cached != cache.end()) {
+        return cached->second;
+    }
+    
+    OperationRegistry& registry = Registry();
+    uint32_t slot;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto it = registry.slots.find(operation);
+        if (it != registry.slots.end()) {
+            slot = it->second;
+        } else {
+            slot = registry.count.load(std::memory_order_relaxed);
+            if (slot >= kMaxOperations) {
+                return kOverflowSlot;
+            }
+            registry.names[slot] = operation;
+            registry.slots.emplace(operation, slot);
+            registry.count.store(slot + 1, std::memory_order_release);
+        }
+    }
+    
+    cache.emplace(operation, slot);
+    return slot;
+}
+
+void PerformanceMonitor::RecordOperation(uint32_t slot, uint64_t durationNs, uint64_t dataSize, bool success) {
+    if (SlotRegistered(slot)) {
+        GlobalMetrics().Record(slot, durationNs, dataSize, success);
+    }
+}
+
+MetricTable::MetricTable() : shards(new Shard[kShardCount]) {}
+
+MetricTable::~MetricTable() {
+    for (uint32_t i = 0; i < kShardCount; i++) {
+        for (std::atomic<OperationCounters*>& slot : shards[i].operations) {
+            delete slot.load(std::memory_order_acquire);
+        }
+    }
 }
 
-// Start a performance timer
-void PerformanceMonitor::StartTimer(const std::string& operation) {
-    std::lock_guard<std::mutex> lock(metricsMutex);
-    activeTimers[operation] = std::chrono::high_resolution_clock::now();
+MetricTable::Shard& MetricTable::ShardAt(uint32_t index) {
+    return shards[index];
 }
 
-// End a performance timer and record the metric
-void PerformanceMonitor::EndTimer(const std::string& operation, size_t dataSize) {
-    std::lock_guard<std::mutex> lock(metricsMutex);
+// Hot path: relaxed updates to this thread's shard, no locks
+void MetricTable::Record(uint32_t slot, uint64_t durationNs, uint64_t dataSize, bool success) {
+    if (slot >= kSlotCount) {
+        return;
+    }
     
-    auto it = activeTimers.find(operation);
-    if (it != activeTimers.end()) {
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration<double, std::milli>(endTime - it->second).count();
-        
-        UpdateMetric(operation, duration, dataSize);
-        activeTimers.erase(it);
+    thread_local uint32_t shardIndex = nextShard.fetch_add(1, std::memory_order_relaxed) % kMaxShards;
+    OperationCounters* counters = ShardCounters(shards[shardIndex], slot);
+    counters->count.fetch_add(1, std::memory_order_relaxed);
+    if (!success) {
+        counters->failures.fetch_add(1, std::memory_order_relaxed);
+    }
+    counters->totalNs.fetch_add(durationNs, std::memory_order_relaxed);
+    counters->totalBytes.fetch_add(dataSize, std::memory_order_relaxed);
+    
+    uint64_t seen = counters->minNs.load(std::memory_order_relaxed);
+    while (durationNs < seen && !counters->minNs.compare_exchange_weak(seen, durationNs, std::memory_order_relaxed)) {}
+    seen = counters->maxNs.load(std::memory_order_relaxed);
+    while (durationNs > seen && !counters->maxNs.compare_exchange_weak(seen, durationNs, std::memory_order_relaxed)) {}
+    
+    int64_t nowUs = NowUs();
+    if (counters->firstCallUs.load(std::memory_order_relaxed) == 0) {
+        int64_t unset = 0;
+        counters->firstCallUs.compare_exchange_strong(unset, nowUs, std::memory_order_relaxed);
+    }
+    counters->lastCallUs.store(nowUs, std::memory_order_relaxed);
+    
+    counters->latency.Record(durationNs);
+    counters->size.Record(dataSize);
+    if ((durationNs & (durationNs - 1)) == 0 && durationNs >= (1ull << kFirstBoundBits) &&
+        durationNs <= (1ull << kLastBoundBits)) {
+        uint32_t bits = kFirstBoundBits;
+        while ((1ull << bits) < durationNs) {
+            bits++;
+        }
+        counters->onBound[bits - kFirstBoundBits].fetch_add(1, std::memory_order_relaxed);
     }
 }
 
-// Update performance metric
-void PerformanceMonitor::UpdateMetric(const std::string& operation, double duration, size_t dataSize) {
-    auto it = metrics.find(operation);
-    if (it == metrics.end()) {
-        // Create new metric
+// Record a performance metric (duration in milliseconds)
+void PerformanceMonitor::RecordOperation(const std::string& operation, double duration, size_t dataSize, bool success) {
+    uint64_t durationNs = duration > 0 ? static_cast<uint64_t>(duration * 1e6) : 0;
+    RecordOperation(RegisterOperation(operation), durationNs, dataSize, success);
+}
+
+PerformanceSpan::PerformanceSpan(uint32_t slot, uint64_t dataSize)
+    : slot(slot), startNs(NowNs()), dataSize(dataSize), active(true) {}
+
+PerformanceSpan::PerformanceSpan(PerformanceSpan&& other) noexcept
+    : slot(other.slot), startNs(other.startNs), dataSize(other.dataSize), active(other.active) {
+    other.active = false;
+}
+
+PerformanceSpan& PerformanceSpan::operator=(PerformanceSpan&& other) noexcept {
+    if (this != &other) {
+        End();
+        slot = other.slot;
+        startNs = other.startNs;
+        dataSize = other.dataSize;
+        active = other.active;
+        other.active = false;
+    }
+    return *this;
+}
+
+PerformanceSpan::~PerformanceSpan() {
+    End();
+}
+
+double PerformanceSpan::End(bool success) {
+    if (!active) {
+        return 0;
+    }
+    active = false;
+    
+    uint64_t now = NowNs();
+    uint64_t durationNs = now > startNs ? now - startNs : 0;
+    PerformanceMonitor::RecordOperation(slot, durationNs, dataSize, success);
+    return durationNs / 1e6;
+}
+
+// Merge every shard's counters for one slot; false if it has no calls
+bool PerformanceMonitor::CollectMetric(uint32_t slot, PerformanceMetric& metric) {
+    std::unique_ptr<MergedCounters> merged(new MergedCounters());
+    MergeSlot(slot, *merged);
+    uint64_t count = merged->count;
+    if (count == 0) {
+        return false;
+    }
+    
+    // Rank against what was merged, not against count
+    const uint64_t* latency = merged->latency;
+    const uint64_t* size = merged->size;
+    uint64_t latencyTotal = std::accumulate(latency, latency + LogLinearHistogram::kBucketCount, uint64_t(0));
+    uint64_t sizeTotal = std::accumulate(size, size + LogLinearHistogram::kBucketCount, uint64_t(0));
+    auto latencyMs = [&](double percentile) {
+        return LogLinearHistogram::ValueAtPercentile(latency, latencyTotal, percentile) / 1e6;
+    };
+    
+    metric.operation = Registry().names[slot];
+    metric.callCount = count;
+    metric.failureCount = merged->failures;
+    metric.totalDuration = merged->totalNs / 1e6;
+    metric.averageDuration = metric.totalDuration / count;
+    metric.minDuration = merged->minNs == UINT64_MAX ? 0.0 : merged->minNs / 1e6;
+    metric.maxDuration = merged->maxNs / 1e6;
+    metric.totalDataSize = merged->totalBytes;
+    metric.averageDataSize = static_cast<double>(merged->totalBytes) / count;
+    metric.firstCall = std::chrono::system_clock::time_point(std::chrono::microseconds(merged->firstUs));
+    metric.lastCall = std::chrono::system_clock::time_point(std::chrono::microseconds(merged->lastUs));
+    metric.p50Duration = latencyMs(50);
+    metric.p90Duration = latencyMs(90);
+    metric.p99Duration = latencyMs(99);
+    metric.p999Duration = latencyMs(99.9);
+    metric.p50DataSize = static_cast<double>(LogLinearHistogram::ValueAtPercentile(size, sizeTotal, 50));
+    metric.p99DataSize = static_cast<double>(LogLinearHistogram::ValueAtPercentile(size, sizeTotal, 99));
+    return true;
+}
+
+std::vector<PerformanceMetric> PerformanceMonitor::CollectMetrics() {
+    std::vector<PerformanceMetric> collected;
+    uint32_t count = Registry().count.load(std::memory_order_acquire);
+    for (uint32_t slot = 0; slot < count; slot++) {
         PerformanceMetric metric;
-        metric.operation = operation;
-        metric.totalDuration = duration;
-        metric.callCount = 1;
-        metric.averageDuration = duration;
-        metric.minDuration = duration;
-        metric.maxDuration = duration;
-        metric.totalDataSize = dataSize;
-        metric.averageDataSize = dataSize;
-        metric.lastCall = std::chrono::system_clock::now();
-        metric.firstCall = std::chrono::system_clock::now();
-        
-        metrics[operation] = metric;
-    } else {
-        // Update existing metric
-        PerformanceMetric& metric = it->second;
-        metric.totalDuration += duration;
-        metric.callCount++;
-        metric.averageDuration = metric.totalDuration / metric.callCount;
-        metric.minDuration = std::min(metric.minDuration, duration);
-        metric.maxDuration = std::max(metric.maxDuration, duration);
-        metric.totalDataSize += dataSize;
-        metric.averageDataSize = metric.totalDataSize / metric.callCount;
-        metric.lastCall = std::chrono::system_clock::now();
+        if (CollectMetric(slot, metric)) {
+            collected.push_back(metric);
+        }
     }
+    return collected;
+}
+
+Napi::Object PerformanceMonitor::MetricToObject(Napi::Env env, const PerformanceMetric& metric) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("operation", metric.operation);
+    result.Set("totalDuration", metric.totalDuration);
+    result.Set("callCount", static_cast<double>(metric.callCount));
+    result.Set("failureCount", static_cast<double>(metric.failureCount));
+    result.Set("averageDuration", metric.averageDuration);
+    result.Set("minDuration", metric.minDuration);
+    result.Set("maxDuration", metric.maxDuration);
+    result.Set("p50Duration", metric.p50Duration);
+    result.Set("p90Duration", metric.p90Duration);
+    result.Set("p99Duration", metric.p99Duration);
+    result.Set("p999Duration", metric.p999Duration);
+    result.Set("totalDataSize", static_cast<double>(metric.totalDataSize));
+    result.Set("averageDataSize", metric.averageDataSize);
+    result.Set("p50DataSize", metric.p50DataSize);
+    result.Set("p99DataSize", metric.p99DataSize);
+    result.Set("firstCall", FormatIso(metric.firstCall));
+    result.Set("lastCall", FormatIso(metric.lastCall));
+    return result;
 }
 
 // Get performance metrics for all operations
 Napi::Value PerformanceMonitor::GetPerformanceMetrics(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(metricsMutex);
     
     Napi::Object result = Napi::Object::New(env);
-    
-    for (const auto& pair : metrics) {
-        Napi::Object metric = Napi::Object::New(env);
-        metric.Set("operation", pair.second.operation);
-        metric.Set("totalDuration", pair.second.totalDuration);
-        metric.Set("callCount", pair.second.callCount);
-        metric.Set("averageDuration", pair.second.averageDuration);
-        metric.Set("minDuration", pair.second.minDuration);
-        metric.Set("maxDuration", pair.second.maxDuration);
-        metric.Set("totalDataSize", pair.second.totalDataSize);
-        metric.Set("averageDataSize", pair.second.averageDataSize);
-        
-        // Convert timestamps to ISO strings
-        auto time_t = std::chrono::system_clock::to_time_t(pair.second.lastCall);
-        std::stringstream ss;
-        ss << std::put_time(std::gmtime(&time_t), "%Y-%m-%dT%H:%M:%SZ");
-        metric.Set("lastCall", ss.str());
-        
-        result.Set(pair.first, metric);
+    for (const PerformanceMetric& metric : CollectMetrics()) {
+        result.Set(metric.operation, MetricToObject(env, metric));
     }
     
     return result;
@@ -167,42 +569,24 @@ Napi::Value PerformanceMonitor::GetPerformanceMetrics(const Napi::CallbackInfo&
 Napi::Value PerformanceMonitor::GetOperationMetrics(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1) {
+    if (info.Length() < 1 || !info[0].IsString()) {
         Napi::TypeError::New(env, "Expected operation parameter").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    std::string operation = info[0].As<Napi::String>().Utf8Value();
-    std::lock_guard<std::mutex> lock(metricsMutex);
-    
-    auto it = metrics.find(operation);
-    if (it == metrics.end()) {
+    uint32_t slot;
+    PerformanceMetric metric;
+    if (!FindSlot(info[0].As<Napi::String>().Utf8Value(), slot) || !CollectMetric(slot, metric)) {
         return env.Null();
     }
     
-    Napi::Object metric = Napi::Object::New(env);
-    metric.Set("operation", it->second.operation);
-    metric.Set("totalDuration", it->second.totalDuration);
-    metric.Set("callCount", it->second.callCount);
-    metric.Set("averageDuration", it->second.averageDuration);
-    metric.Set("minDuration", it->second.minDuration);
-    metric.Set("maxDuration", it->second.maxDuration);
-    metric.Set("totalDataSize", it->second.totalDataSize);
-    metric.Set("averageDataSize", it->second.averageDataSize);
-    
-    // Convert timestamps to ISO strings
-    auto time_t = std::chrono::system_clock::to_time_t(it->second.lastCall);
-    std::stringstream ss;
-    ss << std::put_time(std::gmtime(&time_t), "%Y-%m-%dT%H:%M:%SZ");
-    metric.Set("lastCall", ss.str());
-    
-    return metric;
+    return MetricToObject(env, metric);
 }
 
 // Get overall performance metrics
 Napi::Value PerformanceMonitor::GetOverallMetrics(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(metricsMutex);
+    std::vector<PerformanceMetric> metrics = CollectMetrics();
     
     Napi::Object result = Napi::Object::New(env);
     
@@ -216,26 +600,29 @@ Napi::Value PerformanceMonitor::GetOverallMetrics(const Napi::CallbackInfo& info
     
     double totalDuration = 0.0;
     size_t totalCalls = 0;
+    size_t totalFailures = 0;
     size_t totalDataSize = 0;
     double minDuration = std::numeric_limits<double>::max();
     double maxDuration = 0.0;
     
-    for (const auto& pair : metrics) {
-        totalDuration += pair.second.totalDuration;
-        totalCalls += pair.second.callCount;
-        totalDataSize += pair.second.totalDataSize;
-        minDuration = std::min(minDuration, pair.second.minDuration);
-        maxDuration = std::max(maxDuration, pair.second.maxDuration);
+    for (const auto& metric : metrics) {
+        totalDuration += metric.totalDuration;
+        totalCalls += metric.callCount;
+        totalFailures += metric.failureCount;
+        totalDataSize += metric.totalDataSize;
+        minDuration = std::min(minDuration, metric.minDuration);
+        maxDuration = std::max(maxDuration, metric.maxDuration);
     }
     
     result.Set("totalOperations", metrics.size());
-    result.Set("totalCalls", totalCalls);
+    result.Set("totalCalls", static_cast<double>(totalCalls));
+    result.Set("totalFailures", static_cast<double>(totalFailures));
     result.Set("totalDuration", totalDuration);
     result.Set("averageDuration", totalCalls > 0 ? totalDuration / totalCalls : 0.0);
     result.Set("minDuration", minDuration);
     result.Set("maxDuration", maxDuration);
-    result.Set("totalDataSize", totalDataSize);
-    result.Set("averageDataSize", totalCalls > 0 ? totalDataSize / totalCalls : 0.0);
+    result.Set("totalDataSize", static_cast<double>(totalDataSize));
+    result.Set("averageDataSize", totalCalls > 0 ? static_cast<double>(totalDataSize) / totalCalls : 0.0);
     
     return result;
 }
@@ -243,14 +630,14 @@ Napi::Value PerformanceMonitor::GetOverallMetrics(const Napi::CallbackInfo& info
 // Analyze performance and detect issues
 Napi::Value PerformanceMonitor::AnalyzePerformance(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(metricsMutex);
+    std::vector<PerformanceMetric> metrics = CollectMetrics();
     
     Napi::Object analysis = Napi::Object::New(env);
     
     // Find slowest operations
     std::vector<std::pair<std::string, double>> slowestOps;
-    for (const auto& pair : metrics) {
-        slowestOps.push_back({pair.first, pair.second.averageDuration});
+    for (const auto& metric : metrics) {
+        slowestOps.push_back({metric.operation, metric.averageDuration});
     }
     
     std::sort(slowestOps.begin(), slowestOps.end(), 
@@ -267,8 +654,8 @@ Napi::Value PerformanceMonitor::AnalyzePerformance(const Napi::CallbackInfo& inf
     
     // Find most frequent operations
     std::vector<std::pair<std::string, size_t>> frequentOps;
-    for (const auto& pair : metrics) {
-        frequentOps.push_back({pair.first, pair.second.callCount});
+    for (const auto& metric : metrics) {
+        frequentOps.push_back({metric.operation, metric.callCount});
     }
     
     std::sort(frequentOps.begin(), frequentOps.end(), 
@@ -278,7 +665,7 @@ Napi::Value PerformanceMonitor::AnalyzePerformance(const Napi::CallbackInfo& inf
     for (int i = 0; i < std::min(5, (int)frequentOps.size()); i++) {
         Napi::Object op = Napi::Object::New(env);
         op.Set("operation", frequentOps[i].first);
-        op.Set("callCount", frequentOps[i].second);
+        op.Set("callCount", static_cast<double>(frequentOps[i].second));
         frequentArray.Set(i, op);
     }
     analysis.Set("mostFrequentOperations", frequentArray);
@@ -286,12 +673,13 @@ Napi::Value PerformanceMonitor::AnalyzePerformance(const Napi::CallbackInfo& inf
     // Performance issues
     Napi::Array issuesArray = Napi::Array::New(env, 0);
     int issueCount = 0;
-    for (const auto& pair : metrics) {
-        if (IsPerformanceIssue(pair.second)) {
+    for (const auto& metric : metrics) {
+        if (IsPerformanceIssue(metric)) {
             Napi::Object issue = Napi::Object::New(env);
-            issue.Set("operation", pair.first);
+            issue.Set("operation", metric.operation);
             issue.Set("issue", "High average duration");
-            issue.Set("averageDuration", pair.second.averageDuration);
+            issue.Set("averageDuration", metric.averageDuration);
+            issue.Set("p99Duration", metric.p99Duration);
             issuesArray.Set(issueCount++, issue);
         }
     }
@@ -303,20 +691,20 @@ Napi::Value PerformanceMonitor::AnalyzePerformance(const Napi::CallbackInfo& inf
 // Detect performance issues
 Napi::Value PerformanceMonitor::DetectPerformanceIssues(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(metricsMutex);
     
     Napi::Array issues = Napi::Array::New(env, 0);
     int issueCount = 0;
     
-    for (const auto& pair : metrics) {
-        if (IsPerformanceIssue(pair.second)) {
+    for (const auto& metric : CollectMetrics()) {
+        if (IsPerformanceIssue(metric)) {
             Napi::Object issue = Napi::Object::New(env);
-            issue.Set("operation", pair.first);
+            issue.Set("operation", metric.operation);
             issue.Set("type", "performance");
             issue.Set("severity", "warning");
             issue.Set("message", "Operation has high average duration");
-            issue.Set("averageDuration", pair.second.averageDuration);
-            issue.Set("recommendation", GetPerformanceRecommendation(pair.second));
+            issue.Set("averageDuration", metric.averageDuration);
+            issue.Set("p99Duration", metric.p99Duration);
+            issue.Set("recommendation", GetPerformanceRecommendation(metric));
             issues.Set(issueCount++, issue);
         }
     }
@@ -327,16 +715,15 @@ Napi::Value PerformanceMonitor::DetectPerformanceIssues(const Napi::CallbackInfo
 // Get performance recommendations
 Napi::Value PerformanceMonitor::GetPerformanceRecommendations(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(metricsMutex);
     
     Napi::Array recommendations = Napi::Array::New(env, 0);
     int recCount = 0;
     
-    for (const auto& pair : metrics) {
-        std::string recommendation = GetPerformanceRecommendation(pair.second);
+    for (const auto& metric : CollectMetrics()) {
+        std::string recommendation = GetPerformanceRecommendation(metric);
         if (!recommendation.empty()) {
             Napi::Object rec = Napi::Object::New(env);
-            rec.Set("operation", pair.first);
+            rec.Set("operation", metric.operation);
             rec.Set("recommendation", recommendation);
             rec.Set("priority", "medium");
             recommendations.Set(recCount++, rec);
@@ -346,13 +733,18 @@ Napi::Value PerformanceMonitor::GetPerformanceRecommendations(const Napi::Callba
     return recommendations;
 }
 
-// Reset all performance metrics
+// Reset all performance metrics. Slots stay registered so cached ids stay
+// valid; calls racing with the reset may survive it.
 Napi::Value PerformanceMonitor::ResetMetrics(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(metricsMutex);
     
-    metrics.clear();
-    activeTimers.clear();
+    for (uint32_t i = 0; i < kMaxShards; i++) {
+        for (std::atomic<OperationCounters*>& slot : GlobalMetrics().ShardAt(i).operations) {
+            if (OperationCounters* counters = slot.load(std::memory_order_acquire)) {
+                counters->Reset();
+            }
+        }
+    }
     
     return Napi::Boolean::New(env, true);
 }
@@ -361,21 +753,24 @@ Napi::Value PerformanceMonitor::ResetMetrics(const Napi::CallbackInfo& info) {
 Napi::Value PerformanceMonitor::ClearOperationMetrics(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1) {
+    if (info.Length() < 1 || !info[0].IsString()) {
         Napi::TypeError::New(env, "Expected operation parameter").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    std::string operation = info[0].As<Napi::String>().Utf8Value();
-    std::lock_guard<std::mutex> lock(metricsMutex);
+    uint32_t slot;
+    PerformanceMetric metric;
+    if (!FindSlot(info[0].As<Napi::String>().Utf8Value(), slot) || !CollectMetric(slot, metric)) {
+        return Napi::Boolean::New(env, false);
+    }
     
-    auto it = metrics.find(operation);
-    if (it != metrics.end()) {
-        metrics.erase(it);
-        return Napi::Boolean::New(env, true);
+    for (uint32_t i = 0; i < kMaxShards; i++) {
+        if (OperationCounters* counters = GlobalMetrics().ShardAt(i).operations[slot].load(std::memory_order_acquire)) {
+            counters->Reset();
+        }
     }
     
-    return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, true);
 }
 
 // Helper methods
@@ -395,12 +790,329 @@ std::string PerformanceMonitor::GetPerformanceRecommendation(const PerformanceMe
     return "";
 }
 
-// Placeholder implementations for other methods
-Napi::Value PerformanceMonitor::GetPerformanceTrends(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    return Napi::Object::New(env);
+namespace {
+
+const char kSnapshotMagic[4] = { 'E', 'C', 'M', 'S' };
+const uint8_t kSnapshotVersion = 1;
+
+enum SnapshotKind : uint8_t {
+    kFullSnapshot = 0,
+    kDeltaSnapshot = 1
+};
+
+enum SnapshotEntryFlags : uint8_t {
+    kEntryHasName = 1,  // slot had no calls in the base snapshot
+    kEntryAbsolute = 2  // values replace the consumer's (full snapshot, or counters were reset)
+};
+
+// Scrape state shared by every env. Buffers and merge scratch are kept
+// between scrapes, so a steady-state scrape allocates nothing natively and
+// at most one string or Buffer on the JS heap.
+struct MetricsExporter {
+    std::mutex mutex;
+    std::string text;
+    std::string binary;
+    std::vector<std::unique_ptr<MergedCounters>> current;
+    std::vector<std::unique_ptr<MergedCounters>> baseline; // as of the last committed snapshot
+    uint64_t sequence = 0;
+    
+    // Merge every registered slot into current
+    uint32_t Collect() {
+        uint32_t slots = Registry().count.load(std::memory_order_acquire);
+        if (current.size() < slots) {
+            current.resize(slots);
+        }
+        for (uint32_t slot = 0; slot < slots; slot++) {
+            if (!current[slot]) {
+                current[slot].reset(new MergedCounters());
+            }
+            MergeSlot(slot, *current[slot]);
+        }
+        return slots;
+    }
+    
+    // The snapshot just encoded from current becomes the delta base
+    void Commit() {
+        current.swap(baseline);
+        sequence++;
+    }
+};
+
+MetricsExporter& Exporter() {
+    static MetricsExporter exporter;
+    return exporter;
+}
+
+void AppendUnsigned(std::string& out, uint64_t value) {
+    char digits[24];
+    int length = std::snprintf(digits, sizeof(digits), "%llu", static_cast<unsigned long long>(value));
+    out.append(digits, length);
+}
+
+void AppendDouble(std::string& out, double value) {
+    char digits[32];
+    int length = std::snprintf(digits, sizeof(digits), "%.9g", value);
+    out.append(digits, length);
+}
+
+// Label values escape backslash, double quote and newline
+void AppendLabel(std::string& out, const std::string& value) {
+    out += "{operation=\"";
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+void AppendFamily(std::string& out, const char* name, const char* type, const char* unit, const char* help) {
+    out += "# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+    if (unit) {
+        out += "# UNIT ";
+        out += name;
+        out += ' ';
+        out += unit;
+        out += '\n';
+    }
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += '\n';
+}
+
+// OpenMetrics text for the slots merged into exporter.current
+void RenderOpenMetrics(MetricsExporter& exporter, uint32_t slots, std::string& out) {
+    static const std::vector<std::string> bounds = [] {
+        std::vector<std::string> labels;
+        for (uint32_t bits = kFirstBoundBits; bits <= kLastBoundBits; bits++) {
+            std::string label;
+            AppendDouble(label, static_cast<double>(1ull << bits) / 1e9);
+            labels.push_back(label);
+        }
+        return labels;
+    }();
+    const OperationRegistry& registry = Registry();
+    const char* duration = "enterprise_crypto_operation_duration_seconds";
+    const char* failures = "enterprise_crypto_operation_failures";
+    const char* bytes = "enterprise_crypto_operation_bytes";
+    
+    out.clear();
+    AppendFamily(out, duration, "histogram", "seconds", "Wall time of native crypto operations.");
+    for (uint32_t slot = 0; slot < slots; slot++) {
+        const MergedCounters& merged = *exporter.current[slot];
+        if (merged.count == 0) {
+            continue;
+        }
+        
+        uint64_t cumulative = 0;
+        uint32_t bucket = 0;
+        for (uint32_t bits = kFirstBoundBits; bits <= kLastBoundBits; bits++) {
+            while (bucket < LogLinearHistogram::kBucketCount && LogLinearHistogram::BucketLowerBound(bucket) < (1ull << bits)) {
+                cumulative += merged.latency[bucket++];
+            }
+            out += duration;
+            out += "_bucket";
+            AppendLabel(out, registry.names[slot]);
+            out += ",le=\"";
+            out += bounds[bits - kFirstBoundBits];
+            out += "\"} ";
+            AppendUnsigned(out, cumulative + merged.onBound[bits - kFirstBoundBits]);
+            out += '\n';
+        }
+        while (bucket < LogLinearHistogram::kBucketCount) {
+            cumulative += merged.latency[bucket++];
+        }
+        
+        // _count has to agree with the +Inf bucket, so both use the histogram total
+        out += duration;
+        out += "_bucket";
+        AppendLabel(out, registry.names[slot]);
+        out += ",le=\"+Inf\"} ";
+        AppendUnsigned(out, cumulative);
+        out += '\n';
+        out += duration;
+        out += "_count";
+        AppendLabel(out, registry.names[slot]);
+        out += "} ";
+        AppendUnsigned(out, cumulative);
+        out += '\n';
+        out += duration;
+        out += "_sum";
+        AppendLabel(out, registry.names[slot]);
+        out += "} ";
+        AppendDouble(out, merged.totalNs / 1e9);
+        out += '\n';
+    }
+    
+    AppendFamily(out, failures, "counter", nullptr, "Native crypto operations that failed.");
+    for (uint32_t slot = 0; slot < slots; slot++) {
+        const MergedCounters& merged = *exporter.current[slot];
+        if (merged.count == 0) {
+            continue;
+        }
+        out += failures;
+        out += "_total";
+        AppendLabel(out, registry.names[slot]);
+        out += "} ";
+        AppendUnsigned(out, merged.failures);
+        out += '\n';
+    }
+    
+    AppendFamily(out, bytes, "counter", "bytes", "Bytes processed by native crypto operations.");
+    for (uint32_t slot = 0; slot < slots; slot++) {
+        const MergedCounters& merged = *exporter.current[slot];
+        if (merged.count == 0) {
+            continue;
+        }
+        out += bytes;
+        out += "_total";
+        AppendLabel(out, registry.names[slot]);
+        out += "} ";
+        AppendUnsigned(out, merged.totalBytes);
+        out += '\n';
+    }
+    
+    out += "# EOF\n";
+}
+
+// LEB128
+void AppendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+// Sparse (bucket gap, count) pairs; base is null for absolute counts
+void AppendHistogram(std::string& out, const uint64_t* counts, const uint64_t* base) {
+    uint32_t nonZero = 0;
+    for (uint32_t i = 0; i < LogLinearHistogram::kBucketCount; i++) {
+        nonZero += counts[i] != (base ? base[i] : 0);
+    }
+    AppendVarint(out, nonZero);
+    
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < LogLinearHistogram::kBucketCount; i++) {
+        uint64_t value = counts[i] - (base ? base[i] : 0);
+        if (value != 0) {
+            AppendVarint(out, i - next);
+            AppendVarint(out, value);
+            next = i + 1;
+        }
+    }
+}
+
+bool Regressed(const MergedCounters& merged, const MergedCounters& base) {
+    if (merged.count < base.count || merged.failures < base.failures ||
+        merged.totalNs < base.totalNs || merged.totalBytes < base.totalBytes) {
+        return true;
+    }
+    for (uint32_t i = 0; i < LogLinearHistogram::kBucketCount; i++) {
+        if (merged.latency[i] < base.latency[i] || merged.size[i] < base.size[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Unchanged(const MergedCounters& merged, const MergedCounters& base) {
+    return merged.count == base.count && merged.failures == base.failures &&
+           merged.totalNs == base.totalNs && merged.totalBytes == base.totalBytes &&
+           std::memcmp(merged.latency, base.latency, sizeof(merged.latency)) == 0 &&
+           std::memcmp(merged.size, base.size, sizeof(merged.size)) == 0;
+}
+
+// Binary snapshot of exporter.current, as a delta from the last committed
+// snapshot unless full. Layout (integers are LEB128 varints):
+//
+//   "ECMS"  u8 version  u8 kind (0 full, 1 delta)
+//   sequence  baseSequence (0 for full)  timestampUs  entryCount
+//   entry: slot  u8 flags  [nameLength name]
+//          count failures totalNs totalBytes   (deltas unless kEntryAbsolute)
+//          minNs maxNs                         (always absolute, 0 if no calls)
+//          latency histogram, size histogram:  nonZero, nonZero x (bucketGap, count)
+//
+// Delta snapshots carry only slots that changed. A consumer whose last
+// sequence is not baseSequence has missed one and should ask for a full one.
+void EncodeSnapshot(MetricsExporter& exporter, uint32_t slots, bool full, std::string& out) {
+    const OperationRegistry& registry = Registry();
+    full = full || exporter.sequence == 0;
+    
+    out.clear();
+    out.append(kSnapshotMagic, sizeof(kSnapshotMagic));
+    out += static_cast<char>(kSnapshotVersion);
+    out += static_cast<char>(full ? kFullSnapshot : kDeltaSnapshot);
+    AppendVarint(out, exporter.sequence + 1);
+    AppendVarint(out, full ? 0 : exporter.sequence);
+    AppendVarint(out, static_cast<uint64_t>(NowUs()));
+    
+    // kMaxOperations fits in two varint bytes; patch the count in once known
+    size_t countOffset = out.size();
+    out.append(2, '\0');
+    uint32_t entries = 0;
+    
+    for (uint32_t slot = 0; slot < slots; slot++) {
+        const MergedCounters& merged = *exporter.current[slot];
+        const MergedCounters* base = !full && slot < exporter.baseline.size()
+            ? exporter.baseline[slot].get() : nullptr;
+        
+        if (base ? Unchanged(merged, *base) : merged.count == 0) {
+            continue;
+        }
+        
+        uint8_t flags = !base || base->count == 0 ? kEntryHasName : 0;
+        if (base && Regressed(merged, *base)) {
+            base = nullptr;
+        }
+        if (!base) {
+            flags |= kEntryAbsolute;
+        }
+        
+        AppendVarint(out, slot);
+        out += static_cast<char>(flags);
+        if (flags & kEntryHasName) {
+            AppendVarint(out, registry.names[slot].size());
+            out += registry.names[slot];
+        }
+        AppendVarint(out, merged.count - (base ? base->count : 0));
+        AppendVarint(out, merged.failures - (base ? base->failures : 0));
+        AppendVarint(out, merged.totalNs - (base ? base->totalNs : 0));
+        AppendVarint(out, merged.totalBytes - (base ? base->totalBytes : 0));
+        AppendVarint(out, merged.count ? merged.minNs : 0);
+        AppendVarint(out, merged.maxNs);
+        AppendHistogram(out, merged.latency, base ? base->latency : nullptr);
+        AppendHistogram(out, merged.size, base ? base->size : nullptr);
+        entries++;
+    }
+    
+    // Two-byte varint, padded form for values under 128
+    out[countOffset] = static_cast<char>((entries & 0x7F) | 0x80);
+    out[countOffset + 1] = static_cast<char>(entries >> 7);
+}
+
+// Copy into target if it fits. Returns the bytes needed either way.
+Napi::Value WriteToTarget(Napi::Env env, const std::string& data, Napi::Buffer<uint8_t> target) {
+    if (data.size() <= target.Length()) {
+        std::memcpy(target.Data(), data.data(), data.size());
+    }
+    return Napi::Number::New(env, static_cast<double>(data.size()));
 }
 
+} // namespace
+
+// Placeholder implementations for other methods
 Napi::Value PerformanceMonitor::SetPerformanceThresholds(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     return Napi::Boolean::New(env, true);
@@ -411,19 +1123,773 @@ Napi::Value PerformanceMonitor::GetPerformanceThresholds(const Napi::CallbackInf
     return Napi::Object::New(env);
 }
 
+// Plain-text table of every operation with calls, slowest p99 first
 Napi::Value PerformanceMonitor::GeneratePerformanceReport(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    return Napi::String::New(env, "Performance report not implemented");
+    std::vector<PerformanceMetric> metrics = CollectMetrics();
+    std::sort(metrics.begin(), metrics.end(),
+              [](const PerformanceMetric& a, const PerformanceMetric& b) { return a.p99Duration > b.p99Duration; });
+    
+    std::string report = "Performance report " + FormatIso(std::chrono::system_clock::now()) + "\n";
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-32s %10s %8s %10s %10s %10s %10s %12s\n",
+                  "operation", "calls", "failed", "avg ms", "p50 ms", "p99 ms", "p99.9 ms", "MB");
+    report += line;
+    for (const PerformanceMetric& metric : metrics) {
+        std::snprintf(line, sizeof(line), "%-32.32s %10zu %8zu %10.3f %10.3f %10.3f %10.3f %12.2f\n",
+                      metric.operation.c_str(), metric.callCount, metric.failureCount, metric.averageDuration,
+                      metric.p50Duration, metric.p99Duration, metric.p999Duration, metric.totalDataSize / 1e6);
+        report += line;
+    }
+    if (metrics.empty()) {
+        report += "no operations recorded\n";
+    }
+    
+    return Napi::String::New(env, report);
 }
 
+// exportPerformanceData(format | { format, target, full })
+//   'json' (default): { timestamp, metrics } as getPerformanceMetrics()
+//   'openmetrics':    OpenMetrics text exposition
+//   'snapshot':       binary snapshot, delta from the previous one unless full
+// With a target Buffer the output is written into it and the byte count is
+// returned instead; if it does not fit nothing is written (and a snapshot is
+// not consumed), so callers can grow the buffer and retry.
 Napi::Value PerformanceMonitor::ExportPerformanceData(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    return Napi::Object::New(env);
+    
+    std::string format = "json";
+    bool full = false;
+    Napi::Value target = env.Undefined();
+    if (info.Length() > 0 && info[0].IsString()) {
+        format = info[0].As<Napi::String>().Utf8Value();
+    } else if (info.Length() > 0 && info[0].IsObject()) {
+        Napi::Object options = info[0].As<Napi::Object>();
+        if (options.Has("format") && options.Get("format").IsString()) {
+            format = options.Get("format").As<Napi::String>().Utf8Value();
+        }
+        if (options.Has("full") && options.Get("full").IsBoolean()) {
+            full = options.Get("full").As<Napi::Boolean>().Value();
+        }
+        if (options.Has("target")) {
+            target = options.Get("target");
+        }
+    }
+    if (!target.IsUndefined() && !target.IsBuffer()) {
+        Napi::TypeError::New(env, "target must be a Buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (format == "json") {
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("timestamp", FormatIso(std::chrono::system_clock::now()));
+        result.Set("metrics", GetPerformanceMetrics(info));
+        return result;
+    }
+    
+    if (format != "openmetrics" && format != "snapshot") {
+        Napi::TypeError::New(env, "Unknown export format: " + format).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    MetricsExporter& exporter = Exporter();
+    std::lock_guard<std::mutex> lock(exporter.mutex);
+    uint32_t slots = exporter.Collect();
+    
+    if (format == "openmetrics") {
+        RenderOpenMetrics(exporter, slots, exporter.text);
+        if (target.IsBuffer()) {
+            return WriteToTarget(env, exporter.text, target.As<Napi::Buffer<uint8_t>>());
+        }
+        return Napi::String::New(env, exporter.text);
+    }
+    
+    EncodeSnapshot(exporter, slots, full, exporter.binary);
+    if (target.IsBuffer()) {
+        Napi::Buffer<uint8_t> buffer = target.As<Napi::Buffer<uint8_t>>();
+        if (exporter.binary.size() <= buffer.Length()) {
+            exporter.Commit();
+        }
+        return WriteToTarget(env, exporter.binary, buffer);
+    }
+    exporter.Commit();
+    return Napi::Buffer<uint8_t>::Copy(env, reinterpret_cast<const uint8_t*>(exporter.binary.data()),
+                                       exporter.binary.size());
 }
 
 Napi::Value PerformanceMonitor::GetPerformanceAlerts(const Napi::CallbackInfo& info) {
+    return RealTimeMonitor::GetActiveAlerts(info);
+}
+
+namespace {
+
+const uint32_t kWindowCount = 3;
+const int64_t kWindowMs[kWindowCount] = { 1000, 10000, 60000 };
+const char* const kWindowNames[kWindowCount] = { "1s", "10s", "60s" };
+const int64_t kMinIntervalMs = 100;
+const int64_t kMaxIntervalMs = 10000;
+
+// Latency counts over a run of ticks
+struct WindowCounts {
+    uint64_t count;
+    uint64_t failures;
+    uint64_t totalNs;
+    uint64_t totalBytes;
+    uint64_t latency[LogLinearHistogram::kBucketCount];
+};
+
+// What one tick added; latency buckets are sparse since a tick rarely
+// touches more than a few dozen
+struct TickDelta {
+    uint64_t count = 0;
+    uint64_t failures = 0;
+    uint64_t totalNs = 0;
+    uint64_t totalBytes = 0;
+    std::vector<std::pair<uint32_t, uint64_t>> latency;
+};
+
+// Per operation: the cumulative counters at the last tick, a ring of the
+// last 60s of tick deltas and a running sum per window. Each tick adds its
+// delta to every window and subtracts the tick that fell out of it.
+struct SlotWindows {
+    MergedCounters previous;
+    std::vector<TickDelta> ring;
+    size_t head = 0;
+    size_t filled = 0;
+    WindowCounts windows[kWindowCount];
+};
+
+struct WindowStats {
+    uint64_t calls;
+    uint64_t failures;
+    double seconds;
+    bool complete; // covers the whole window, not just the time since start
+    double throughput;
+    double bytesPerSecond;
+    double errorRate;
+    double averageMs;
+    double p50Ms;
+    double p90Ms;
+    double p99Ms;
+};
+
+struct OperationStats {
+    std::string operation;
+    WindowStats windows[kWindowCount];
+};
+
+struct Subscriber {
+    napi_env env;
+    bool hasCallback;
+    Napi::ThreadSafeFunction callback;
+};
+
+struct Sampler {
+    // Thread control and subscribers. A generation bump tells the running
+    // loop to exit, so a restart never races a loop that is still stopping.
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread thread;
+    uint64_t generation = 0;
+    std::vector<Subscriber> subscribers;
+    uint64_t droppedEvents = 0;
+    
+    // Window state, touched by one tick at a time
+    std::mutex tickMutex;
+    std::vector<std::unique_ptr<SlotWindows>> slots;
+    std::unique_ptr<MergedCounters> scratch;
+    int64_t intervalMs = 0; // 0 until configured by the first tick
+    uint32_t windowTicks[kWindowCount];
+    
+    // Published after every tick for the JS thread
+    std::mutex statsMutex;
+    std::vector<OperationStats> stats;
+    int64_t statsUs = 0;
+};
+
+Sampler& GetSampler() {
+    static Sampler sampler;
+    return sampler;
+}
+
+void ClearWindows(SlotWindows& state) {
+    for (TickDelta& tick : state.ring) {
+        tick.latency.clear();
+    }
+    state.head = 0;
+    state.filled = 0;
+    std::memset(state.windows, 0, sizeof(state.windows));
+}
+
+void Subtract(WindowCounts& window, const TickDelta& tick) {
+    window.count -= tick.count;
+    window.failures -= tick.failures;
+    window.totalNs -= tick.totalNs;
+    window.totalBytes -= tick.totalBytes;
+    for (const auto& bucket : tick.latency) {
+        window.latency[bucket.first] -= bucket.second;
+    }
+}
+
+void Add(WindowCounts& window, const TickDelta& tick) {
+    window.count += tick.count;
+    window.failures += tick.failures;
+    window.totalNs += tick.totalNs;
+    window.totalBytes += tick.totalBytes;
+    for (const auto& bucket : tick.latency) {
+        window.latency[bucket.first] += bucket.second;
+    }
+}
+
+// Fold the counters since the last tick into the windows and publish stats.
+// Reads every shard once per operation no matter how many calls were made.
+void Tick(Sampler& sampler, int64_t intervalMs, int64_t nowUs) {
+    std::lock_guard<std::mutex> lock(sampler.tickMutex);
+    const OperationRegistry& registry = Registry();
+    uint32_t slotCount = registry.count.load(std::memory_order_acquire);
+    
+    if (!sampler.scratch) {
+        sampler.scratch.reset(new MergedCounters());
+    }
+    
+    // New interval (or first tick): resize the windows and start them empty
+    // from the current counters
+    bool configure = intervalMs != sampler.intervalMs;
+    if (configure) {
+        sampler.intervalMs = intervalMs;
+        for (uint32_t w = 0; w < kWindowCount; w++) {
+            sampler.windowTicks[w] = static_cast<uint32_t>(std::max<int64_t>(1, (kWindowMs[w] + intervalMs - 1) / intervalMs));
+        }
+        sampler.slots.clear();
+    }
+    uint32_t ringTicks = sampler.windowTicks[kWindowCount - 1];
+    
+    std::vector<OperationStats> stats;
+    for (uint32_t slot = 0; slot < slotCount; slot++) {
+        MergedCounters& current = *sampler.scratch;
+        MergeSlot(slot, current);
+        
+        // Slots registered after configuration start from zero
+        if (slot >= sampler.slots.size()) {
+            sampler.slots.resize(slot + 1);
+        }
+        std::unique_ptr<SlotWindows>& state = sampler.slots[slot];
+        if (!state) {
+            state.reset(new SlotWindows());
+            state->ring.resize(ringTicks);
+            std::memset(state->windows, 0, sizeof(state->windows));
+            if (configure) {
+                state->previous = current;
+            } else {
+                std::memset(&state->previous, 0, sizeof(state->previous));
+            }
+        }
+        
+        // Counters reset since the last tick; restart this slot's windows
+        MergedCounters& previous = state->previous;
+        bool regressed = current.count < previous.count || current.failures < previous.failures ||
+                         current.totalNs < previous.totalNs || current.totalBytes < previous.totalBytes;
+        for (uint32_t i = 0; i < LogLinearHistogram::kBucketCount && !regressed; i++) {
+            regressed = current.latency[i] < previous.latency[i];
+        }
+        if (regressed) {
+            ClearWindows(*state);
+            previous = current;
+            continue;
+        }
+        
+        for (uint32_t w = 0; w < kWindowCount; w++) {
+            if (state->filled >= sampler.windowTicks[w]) {
+                Subtract(state->windows[w], state->ring[(state->head + ringTicks - sampler.windowTicks[w]) % ringTicks]);
+            }
+        }
+        
+        TickDelta& tick = state->ring[state->head];
+        tick.count = current.count - previous.count;
+        tick.failures = current.failures - previous.failures;
+        tick.totalNs = current.totalNs - previous.totalNs;
+        tick.totalBytes = current.totalBytes - previous.totalBytes;
+        tick.latency.clear();
+        for (uint32_t i = 0; i < LogLinearHistogram::kBucketCount; i++) {
+            if (current.latency[i] != previous.latency[i]) {
+                tick.latency.emplace_back(i, current.latency[i] - previous.latency[i]);
+            }
+        }
+        for (WindowCounts& window : state->windows) {
+            Add(window, tick);
+        }
+        state->head = (state->head + 1) % ringTicks;
+        state->filled = std::min<size_t>(state->filled + 1, ringTicks);
+        std::memcpy(&previous, &current, sizeof(previous));
+        
+        if (current.count == 0) {
+            continue;
+        }
+        
+        OperationStats entry;
+        entry.operation = registry.names[slot];
+        for (uint32_t w = 0; w < kWindowCount; w++) {
+            const WindowCounts& window = state->windows[w];
+            WindowStats& result = entry.windows[w];
+            uint64_t ticks = std::min<uint64_t>(state->filled, sampler.windowTicks[w]);
+            uint64_t total = std::accumulate(window.latency, window.latency + LogLinearHistogram::kBucketCount, uint64_t(0));
+            result.calls = window.count;
+            result.failures = window.failures;
+            result.seconds = ticks * intervalMs / 1000.0;
+            result.complete = ticks == sampler.windowTicks[w];
+            result.throughput = result.seconds > 0 ? window.count / result.seconds : 0.0;
+            result.bytesPerSecond = result.seconds > 0 ? window.totalBytes / result.seconds : 0.0;
+            result.errorRate = window.count > 0 ? 100.0 * window.failures / window.count : 0.0;
+            result.averageMs = window.count > 0 ? window.totalNs / 1e6 / window.count : 0.0;
+            result.p50Ms = LogLinearHistogram::ValueAtPercentile(window.latency, total, 50) / 1e6;
+            result.p90Ms = LogLinearHistogram::ValueAtPercentile(window.latency, total, 90) / 1e6;
+            result.p99Ms = LogLinearHistogram::ValueAtPercentile(window.latency, total, 99) / 1e6;
+        }
+        stats.push_back(std::move(entry));
+    }
+    
+    std::lock_guard<std::mutex> statsLock(sampler.statsMutex);
+    sampler.stats.swap(stats);
+    sampler.statsUs = nowUs;
+}
+
+Napi::Object WindowToObject(Napi::Env env, const WindowStats& window) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("calls", static_cast<double>(window.calls));
+    result.Set("failures", static_cast<double>(window.failures));
+    result.Set("seconds", window.seconds);
+    result.Set("complete", window.complete);
+    result.Set("throughput", window.throughput);
+    result.Set("bytesPerSecond", window.bytesPerSecond);
+    result.Set("errorRate", window.errorRate);
+    result.Set("averageDuration", window.averageMs);
+    result.Set("p50Duration", window.p50Ms);
+    result.Set("p90Duration", window.p90Ms);
+    result.Set("p99Duration", window.p99Ms);
+    return result;
+}
+
+Napi::Object AlertToObject(Napi::Env env, const AlertEvent& event) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("type", event.resolved ? "resolved" : "alert");
+    result.Set("operation", event.operation);
+    result.Set("metric", event.type);
+    result.Set("window", event.window);
+    result.Set("value", event.value);
+    result.Set("threshold", event.threshold);
+    result.Set("timestamp", FormatIso(std::chrono::system_clock::time_point(std::chrono::microseconds(event.timestampUs))));
+    result.Set("message", event.message);
+    return result;
+}
+
+int64_t ClampInterval(int64_t intervalMs) {
+    return std::max(kMinIntervalMs, std::min(kMaxIntervalMs, intervalMs));
+}
+
+} // namespace
+
+// Register real-time monitoring functions
+void RealTimeMonitor::Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("startRealTimeMonitoring", Napi::Function::New(env, StartRealTimeMonitoring));
+    exports.Set("stopRealTimeMonitoring", Napi::Function::New(env, StopRealTimeMonitoring));
+    exports.Set("getRealTimeMetrics", Napi::Function::New(env, GetRealTimeMetrics));
+    exports.Set("setMonitoringInterval", Napi::Function::New(env, SetMonitoringInterval));
+    exports.Set("setPerformanceAlert", Napi::Function::New(env, SetPerformanceAlert));
+    exports.Set("getActiveAlerts", Napi::Function::New(env, GetActiveAlerts));
+    exports.Set("clearAlerts", Napi::Function::New(env, ClearAlerts));
+}
+
+// startRealTimeMonitoring([{ interval }], [onAlert]). Each environment has at
+// most one callback; calling again replaces it. The callback does not keep
+// the event loop alive.
+Napi::Value RealTimeMonitor::StartRealTimeMonitoring(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    return Napi::Array::New(env, 0);
+    
+    Napi::Value callback = env.Undefined();
+    for (size_t i = 0; i < info.Length() && i < 2; i++) {
+        if (info[i].IsFunction()) {
+            callback = info[i];
+        } else if (info[i].IsObject()) {
+            Napi::Object options = info[i].As<Napi::Object>();
+            if (options.Has("interval") && options.Get("interval").IsNumber()) {
+                monitoringIntervalMs.store(ClampInterval(options.Get("interval").As<Napi::Number>().Int64Value()));
+            }
+        }
+    }
+    
+    Sampler& sampler = GetSampler();
+    std::lock_guard<std::mutex> lock(sampler.mutex);
+    
+    auto it = std::find_if(sampler.subscribers.begin(), sampler.subscribers.end(),
+                           [&](const Subscriber& subscriber) { return subscriber.env == env; });
+    if (it == sampler.subscribers.end()) {
+        sampler.subscribers.push_back(Subscriber{ env, false, Napi::ThreadSafeFunction() });
+        it = sampler.subscribers.end() - 1;
+        napi_add_env_cleanup_hook(env, RemoveEnv, env);
+    } else if (it->hasCallback) {
+        it->callback.Release();
+        it->hasCallback = false;
+    }
+    
+    if (callback.IsFunction()) {
+        it->callback = Napi::ThreadSafeFunction::New(env, callback.As<Napi::Function>(), "realTimeMonitor", 64, 1);
+        it->callback.Unref(env);
+        it->hasCallback = true;
+    }
+    
+    if (!sampler.thread.joinable()) {
+        sampler.thread = std::thread(MonitoringLoop);
+    }
+    isMonitoring = true;
+    
+    return Napi::Boolean::New(env, true);
+}
+
+// Stop this environment's monitoring; the sampler stops with the last one
+Napi::Value RealTimeMonitor::StopRealTimeMonitoring(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    Sampler& sampler = GetSampler();
+    bool last;
+    {
+        std::lock_guard<std::mutex> lock(sampler.mutex);
+        auto it = std::find_if(sampler.subscribers.begin(), sampler.subscribers.end(),
+                               [&](const Subscriber& subscriber) { return subscriber.env == env; });
+        if (it == sampler.subscribers.end()) {
+            return Napi::Boolean::New(env, false);
+        }
+        if (it->hasCallback) {
+            it->callback.Release();
+        }
+        sampler.subscribers.erase(it);
+        napi_remove_env_cleanup_hook(env, RemoveEnv, env);
+        last = sampler.subscribers.empty();
+    }
+    
+    if (last) {
+        StopSampler();
+    }
+    return Napi::Boolean::New(env, true);
+}
+
+// Environment cleanup hook for an env that never stopped monitoring
+void RealTimeMonitor::RemoveEnv(void* env) {
+    Sampler& sampler = GetSampler();
+    bool last;
+    {
+        std::lock_guard<std::mutex> lock(sampler.mutex);
+        auto it = std::find_if(sampler.subscribers.begin(), sampler.subscribers.end(),
+                               [&](const Subscriber& subscriber) { return subscriber.env == env; });
+        if (it == sampler.subscribers.end()) {
+            return;
+        }
+        if (it->hasCallback) {
+            it->callback.Release();
+        }
+        sampler.subscribers.erase(it);
+        last = sampler.subscribers.empty();
+    }
+    
+    if (last) {
+        StopSampler();
+    }
+}
+
+void RealTimeMonitor::StopSampler() {
+    Sampler& sampler = GetSampler();
+    std::thread joinable;
+    {
+        std::lock_guard<std::mutex> lock(sampler.mutex);
+        sampler.generation++;
+        joinable.swap(sampler.thread);
+    }
+    sampler.wake.notify_all();
+    if (joinable.joinable()) {
+        joinable.join();
+    }
+    
+    isMonitoring = false;
+    {
+        std::lock_guard<std::mutex> lock(sampler.tickMutex);
+        sampler.slots.clear();
+        sampler.intervalMs = 0;
+    }
+    std::lock_guard<std::mutex> lock(sampler.statsMutex);
+    sampler.stats.clear();
+}
+
+// Sampler thread: one tick per interval on a fixed cadence. After a stall
+// (e.g. a suspended VM) the cadence restarts rather than bursting ticks.
+void RealTimeMonitor::MonitoringLoop() {
+    Sampler& sampler = GetSampler();
+    std::unique_lock<std::mutex> lock(sampler.mutex);
+    uint64_t generation = sampler.generation;
+    auto next = std::chrono::steady_clock::now();
+    
+    while (true) {
+        int64_t intervalMs = monitoringIntervalMs.load();
+        next += std::chrono::milliseconds(intervalMs);
+        sampler.wake.wait_until(lock, next, [&] { return sampler.generation != generation; });
+        if (sampler.generation != generation) {
+            return;
+        }
+        lock.unlock();
+        
+        int64_t nowUs = NowUs();
+        Tick(sampler, intervalMs, nowUs);
+        CheckPerformanceAlerts(nowUs);
+        
+        auto now = std::chrono::steady_clock::now();
+        if (now > next + std::chrono::milliseconds(intervalMs)) {
+            next = now;
+        }
+        lock.lock();
+    }
+}
+
+// Edge-triggered: an alert is pushed when a limit is first crossed and a
+// resolution when it no longer is; nothing is pushed while the state holds
+void RealTimeMonitor::CheckPerformanceAlerts(int64_t nowUs) {
+    Sampler& sampler = GetSampler();
+    std::vector<AlertEvent> events;
+    {
+        std::lock_guard<std::mutex> statsLock(sampler.statsMutex);
+        std::lock_guard<std::mutex> lock(alertMutex);
+        if (alertThresholds.empty()) {
+            return;
+        }
+        
+        for (const OperationStats& stats : sampler.stats) {
+            auto rule = alertThresholds.find(stats.operation);
+            if (rule == alertThresholds.end()) {
+                rule = alertThresholds.find("*");
+            }
+            if (rule == alertThresholds.end()) {
+                continue;
+            }
+            
+            const AlertThreshold& threshold = rule->second;
+            const WindowStats& window = stats.windows[threshold.window];
+            
+            auto evaluate = [&](const char* type, bool checked, bool crossed, double value, double limit, const char* what) {
+                std::string key = stats.operation + '\n' + type;
+                auto active = activeAlerts.find(key);
+                if (!checked || crossed == (active != activeAlerts.end())) {
+                    return;
+                }
+                
+                AlertEvent event;
+                event.resolved = !crossed;
+                event.operation = stats.operation;
+                event.type = type;
+                event.window = kWindowNames[threshold.window];
+                event.value = value;
+                event.threshold = limit;
+                event.timestampUs = nowUs;
+                std::ostringstream message;
+                message << stats.operation << ' ' << what << ' ' << std::fixed << std::setprecision(2) << value
+                        << (crossed ? " crossed " : " back within ") << limit << " over " << event.window;
+                event.message = message.str();
+                
+                if (crossed) {
+                    activeAlerts.emplace(key, event);
+                } else {
+                    activeAlerts.erase(active);
+                }
+                events.push_back(event);
+            };
+            
+            bool enoughCalls = window.calls >= threshold.minCalls;
+            evaluate("p99", threshold.p99Ms > 0 && enoughCalls, window.p99Ms > threshold.p99Ms,
+                     window.p99Ms, threshold.p99Ms, "p99 ms");
+            evaluate("errorRate", threshold.maxErrorRate > 0 && enoughCalls, window.errorRate > threshold.maxErrorRate,
+                     window.errorRate, threshold.maxErrorRate, "error rate %");
+            
+            // A window still filling up would read as a throughput drop
+            bool low = threshold.minThroughput > 0 && window.throughput < threshold.minThroughput;
+            bool high = threshold.maxThroughput > 0 && window.throughput > threshold.maxThroughput;
+            evaluate("throughput", (threshold.minThroughput > 0 || threshold.maxThroughput > 0) && window.complete,
+                     low || high, window.throughput, high ? threshold.maxThroughput : threshold.minThroughput,
+                     "calls/s");
+        }
+    }
+    
+    for (const AlertEvent& event : events) {
+        TriggerAlert(event);
+    }
+}
+
+// Queue the event for every subscribed callback. Never blocks the sampler:
+// events for a callback whose queue is full are dropped and counted.
+void RealTimeMonitor::TriggerAlert(const AlertEvent& event) {
+    Sampler& sampler = GetSampler();
+    std::lock_guard<std::mutex> lock(sampler.mutex);
+    
+    for (Subscriber& subscriber : sampler.subscribers) {
+        if (!subscriber.hasCallback) {
+            continue;
+        }
+        AlertEvent* copy = new AlertEvent(event);
+        napi_status status = subscriber.callback.NonBlockingCall(copy, [](Napi::Env env, Napi::Function callback, AlertEvent* event) {
+            if (env != nullptr && !callback.IsEmpty()) {
+                callback.Call({ AlertToObject(env, *event) });
+            }
+            delete event;
+        });
+        if (status != napi_ok) {
+            delete copy;
+            sampler.droppedEvents++;
+        }
+    }
+}
+
+// Rolling-window stats from the last tick, keyed by operation
+Napi::Value RealTimeMonitor::GetRealTimeMetrics(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Sampler& sampler = GetSampler();
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("monitoring", isMonitoring.load());
+    result.Set("interval", static_cast<double>(monitoringIntervalMs.load()));
+    {
+        std::lock_guard<std::mutex> lock(sampler.mutex);
+        result.Set("droppedEvents", static_cast<double>(sampler.droppedEvents));
+    }
+    
+    std::lock_guard<std::mutex> lock(sampler.statsMutex);
+    result.Set("timestamp", sampler.statsUs
+        ? Napi::Value(Napi::String::New(env, FormatIso(std::chrono::system_clock::time_point(std::chrono::microseconds(sampler.statsUs)))))
+        : env.Null());
+    
+    Napi::Object operations = Napi::Object::New(env);
+    for (const OperationStats& stats : sampler.stats) {
+        Napi::Object windows = Napi::Object::New(env);
+        for (uint32_t w = 0; w < kWindowCount; w++) {
+            windows.Set(kWindowNames[w], WindowToObject(env, stats.windows[w]));
+        }
+        operations.Set(stats.operation, windows);
+    }
+    result.Set("operations", operations);
+    
+    return result;
+}
+
+// setMonitoringInterval(ms): clamped to 100ms..10s. Windows keep their
+// 1s / 10s / 60s spans and restart on the next tick.
+Napi::Value RealTimeMonitor::SetMonitoringInterval(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected interval in milliseconds").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int64_t intervalMs = ClampInterval(info[0].As<Napi::Number>().Int64Value());
+    monitoringIntervalMs.store(intervalMs);
+    return Napi::Number::New(env, static_cast<double>(intervalMs));
+}
+
+// setPerformanceAlert(operation | '*', { p99Ms, minThroughput, maxThroughput,
+// maxErrorRate, minCalls, window: '1s' | '10s' | '60s' }); null removes it
+Napi::Value RealTimeMonitor::SetPerformanceAlert(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected operation and thresholds").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string operation = info[0].As<Napi::String>().Utf8Value();
+    if (info[1].IsNull() || info[1].IsUndefined()) {
+        std::lock_guard<std::mutex> lock(alertMutex);
+        return Napi::Boolean::New(env, alertThresholds.erase(operation) > 0);
+    }
+    if (!info[1].IsObject()) {
+        Napi::TypeError::New(env, "Thresholds must be an object").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object options = info[1].As<Napi::Object>();
+    AlertThreshold threshold;
+    auto number = [&](const char* name, double& field) {
+        if (options.Has(name) && options.Get(name).IsNumber()) {
+            field = std::max(0.0, options.Get(name).As<Napi::Number>().DoubleValue());
+        }
+    };
+    number("p99Ms", threshold.p99Ms);
+    number("minThroughput", threshold.minThroughput);
+    number("maxThroughput", threshold.maxThroughput);
+    number("maxErrorRate", threshold.maxErrorRate);
+    if (options.Has("minCalls") && options.Get("minCalls").IsNumber()) {
+        threshold.minCalls = static_cast<uint64_t>(std::max<int64_t>(0, options.Get("minCalls").As<Napi::Number>().Int64Value()));
+    }
+    if (options.Has("window")) {
+        std::string window = options.Get("window").ToString().Utf8Value();
+        auto found = std::find(kWindowNames, kWindowNames + kWindowCount, window);
+        if (found == kWindowNames + kWindowCount) {
+            Napi::TypeError::New(env, "window must be '1s', '10s' or '60s'").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        threshold.window = static_cast<uint32_t>(found - kWindowNames);
+    }
+    
+    std::lock_guard<std::mutex> lock(alertMutex);
+    alertThresholds[operation] = threshold;
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value RealTimeMonitor::GetActiveAlerts(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(alertMutex);
+    
+    Napi::Array alerts = Napi::Array::New(env, activeAlerts.size());
+    uint32_t index = 0;
+    for (const auto& entry : activeAlerts) {
+        alerts.Set(index++, AlertToObject(env, entry.second));
+    }
+    return alerts;
+}
+
+// Forget active alerts; any still crossed are raised again on the next tick
+Napi::Value RealTimeMonitor::ClearAlerts(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> lock(alertMutex);
+    activeAlerts.clear();
+    return Napi::Boolean::New(env, true);
+}
+
+// Compare the 10s window against the 60s one. Needs real-time monitoring;
+// empty otherwise.
+Napi::Value PerformanceMonitor::GetPerformanceTrends(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Sampler& sampler = GetSampler();
+    std::lock_guard<std::mutex> lock(sampler.statsMutex);
+    
+    auto direction = [](double recent, double baseline) {
+        if (baseline <= 0) {
+            return recent > 0 ? "rising" : "stable";
+        }
+        double ratio = recent / baseline;
+        return ratio > 1.2 ? "rising" : ratio < 0.8 ? "falling" : "stable";
+    };
+    
+    Napi::Object trends = Napi::Object::New(env);
+    for (const OperationStats& stats : sampler.stats) {
+        Napi::Object trend = Napi::Object::New(env);
+        Napi::Object throughput = Napi::Object::New(env);
+        Napi::Object p99 = Napi::Object::New(env);
+        for (uint32_t w = 0; w < kWindowCount; w++) {
+            throughput.Set(kWindowNames[w], stats.windows[w].throughput);
+            p99.Set(kWindowNames[w], stats.windows[w].p99Ms);
+        }
+        trend.Set("throughput", throughput);
+        trend.Set("p99Duration", p99);
+        trend.Set("throughputTrend", direction(stats.windows[1].throughput, stats.windows[2].throughput));
+        trend.Set("latencyTrend", direction(stats.windows[1].p99Ms, stats.windows[2].p99Ms));
+        trends.Set(stats.operation, trend);
+    }
+    
+    return trends;
 }
 
 } // namespace EnterpriseCrypto
@@ -4,10 +4,14 @@
 #include <napi.h>
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 #include <chrono>
 #include <mutex>
 #include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
 
 namespace EnterpriseCrypto {
 
@@ -23,6 +27,109 @@ struct PerformanceMetric {
     double averageDataSize;
     std::chrono::system_clock::time_point lastCall;
     std::chrono::system_clock::time_point firstCall;
+    size_t failureCount;
+    double p50Duration;
+    double p90Duration;
+    double p99Duration;
+    double p999Duration;
+    double p50DataSize;
+    double p99DataSize;
+};
+
+// Log-linear (HDR-style) histogram of non-negative integers. Values are
+// bucketed by power of two, each power split into kSubBucketCount linear
+// sub-buckets, so a reported value is within about 3% of the true one at
+// any magnitude. Buckets are relaxed atomics; any thread may record.
+class LogLinearHistogram {
+public:
+    static constexpr uint32_t kSubBucketBits = 4;
+    static constexpr uint32_t kSubBucketCount = 1u << kSubBucketBits;
+    static constexpr uint32_t kMaxValueBits = 40; // larger values share the last bucket
+    static constexpr uint32_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+    
+    LogLinearHistogram() { Reset(); }
+    
+    void Record(uint64_t value) {
+        counts[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // Add this histogram's counts to merged (kBucketCount entries)
+    void MergeInto(uint64_t* merged) const;
+    void Reset();
+    
+    static uint32_t BucketOf(uint64_t value);
+    static uint64_t BucketLowerBound(uint32_t bucket);
+    
+    // Representative value at percentile (0-100) of merged counts
+    static uint64_t ValueAtPercentile(const uint64_t* merged, uint64_t total, double percentile);
+    
+private:
+    std::atomic<uint64_t> counts[kBucketCount];
+};
+
+// Timing token for one operation. The start stamp is carried by the span
+// instead of a shared name-keyed map, so concurrent calls of the same
+// operation cannot overwrite each other, and a span can be moved to the
+// thread that finishes the work (e.g. from an AsyncWorker's constructor to
+// OnOK). Records into the operation's histograms when ended or destroyed.
+class PerformanceSpan {
+public:
+    PerformanceSpan() : slot(0), startNs(0), dataSize(0), active(false) {}
+    explicit PerformanceSpan(uint32_t slot, uint64_t dataSize = 0);
+    PerformanceSpan(PerformanceSpan&& other) noexcept;
+    PerformanceSpan& operator=(PerformanceSpan&& other) noexcept;
+    ~PerformanceSpan();
+    
+    PerformanceSpan(const PerformanceSpan&) = delete;
+    PerformanceSpan& operator=(const PerformanceSpan&) = delete;
+    
+    void SetDataSize(uint64_t bytes) { dataSize = bytes; }
+    
+    // Record the span; returns its duration in milliseconds. Only the first
+    // call records, later ones return 0.
+    double End(bool success = true);
+    
+    // Drop the span without recording it
+    void Cancel() { active = false; }
+    
+    bool IsActive() const { return active; }
+    uint64_t StartNs() const { return startNs; }
+    
+    // Monotonic process-wide clock; stamps taken on any thread compare
+    static uint64_t NowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    
+private:
+    uint32_t slot;
+    uint64_t startNs;
+    uint64_t dataSize;
+    bool active;
+};
+
+// Sharded per-thread counters and histograms for up to kSlotCount operation
+// slots. PerformanceMonitor records into one process-wide table; benchmarks
+// record into their own so their traffic never reaches exported metrics.
+class MetricTable {
+public:
+    static constexpr uint32_t kSlotCount = 256;
+    static constexpr uint32_t kShardCount = 16;
+    
+    struct Shard; // defined in the .cc
+    
+    MetricTable();
+    ~MetricTable();
+    
+    MetricTable(const MetricTable&) = delete;
+    MetricTable& operator=(const MetricTable&) = delete;
+    
+    // Slots at or above kSlotCount are ignored
+    void Record(uint32_t slot, uint64_t durationNs, uint64_t dataSize, bool success = true);
+    Shard& ShardAt(uint32_t index);
+    
+private:
+    std::unique_ptr<Shard[]> shards;
 };
 
 // Performance monitoring for crypto operations
@@ -30,10 +137,11 @@ class PerformanceMonitor {
 public:
     static void Init(Napi::Env env, Napi::Object exports);
     
-    // Core performance tracking
-    static void RecordOperation(const std::string& operation, double duration, size_t dataSize = 0);
-    static void StartTimer(const std::string& operation);
-    static void EndTimer(const std::string& operation, size_t dataSize = 0);
+    // Core performance tracking. Operation names resolve once to integer
+    // slots; hot paths keep the slot and record through it.
+    static uint32_t RegisterOperation(const std::string& operation);
+    static void RecordOperation(uint32_t slot, uint64_t durationNs, uint64_t dataSize, bool success = true);
+    static void RecordOperation(const std::string& operation, double duration, size_t dataSize = 0, bool success = true);
     
     // Performance metrics retrieval
     static Napi::Value GetPerformanceMetrics(const Napi::CallbackInfo& info);
@@ -58,15 +166,14 @@ public:
     static Napi::Value GetPerformanceAlerts(const Napi::CallbackInfo& info);
     
 private:
-    // Internal storage
-    static std::map<std::string, PerformanceMetric> metrics;
-    static std::map<std::string, std::chrono::high_resolution_clock::time_point> activeTimers;
-    static std::mutex metricsMutex;
+    // Internal storage. Counters and histograms live in per-thread shards
+    // (see the .cc); readers merge the shards of a slot on demand.
     static std::map<std::string, double> performanceThresholds;
     
     // Helper methods
-    static void UpdateMetric(const std::string& operation, double duration, size_t dataSize);
-    static double CalculatePercentile(const std::vector<double>& values, double percentile);
+    static bool CollectMetric(uint32_t slot, PerformanceMetric& metric);
+    static std::vector<PerformanceMetric> CollectMetrics();
+    static Napi::Object MetricToObject(Napi::Env env, const PerformanceMetric& metric);
     static std::string FormatDuration(double duration);
     static bool IsPerformanceIssue(const PerformanceMetric& metric);
     static std::string GetPerformanceRecommendation(const PerformanceMetric& metric);
@@ -79,7 +186,34 @@ private:
     static std::vector<std::string> GetMostFrequentOperations(int limit = 10);
 };
 
-// Real-time performance monitoring
+// Alert limits for one operation ("*" matches every operation). A zero
+// limit is not checked. Evaluated against one rolling window.
+struct AlertThreshold {
+    double p99Ms = 0;         // alert when the window p99 exceeds this
+    double minThroughput = 0; // calls per second
+    double maxThroughput = 0;
+    double maxErrorRate = 0;  // percent of calls in the window
+    uint64_t minCalls = 1;    // p99 and error rate need this many calls
+    uint32_t window = 1;      // index into the 1s / 10s / 60s windows
+};
+
+// Raised when a limit is first crossed, resolved when it no longer is
+struct AlertEvent {
+    bool resolved;
+    std::string operation;
+    std::string type;         // "p99", "throughput" or "errorRate"
+    std::string window;
+    double value;
+    double threshold;
+    int64_t timestampUs;
+    std::string message;
+};
+
+// Real-time performance monitoring. A background sampler merges the
+// metric shards once per interval, keeps 1s / 10s / 60s rolling windows,
+// checks alert thresholds against them and pushes alert events to the JS
+// callbacks given to startRealTimeMonitoring. Its cost depends on the number
+// of operations and the interval, not on the request rate.
 class RealTimeMonitor {
 public:
     static void Init(Napi::Env env, Napi::Object exports);
@@ -97,14 +231,16 @@ public:
     
 private:
     static std::atomic<bool> isMonitoring;
-    static std::chrono::milliseconds monitoringInterval;
-    static std::map<std::string, double> alertThresholds;
-    static std::vector<std::string> activeAlerts;
+    static std::atomic<int64_t> monitoringIntervalMs;
+    static std::map<std::string, AlertThreshold> alertThresholds;
+    static std::map<std::string, AlertEvent> activeAlerts; // by operation and type
     static std::mutex alertMutex;
     
     static void MonitoringLoop();
-    static void CheckPerformanceAlerts();
-    static void TriggerAlert(const std::string& operation, const std::string& reason);
+    static void CheckPerformanceAlerts(int64_t nowUs);
+    static void TriggerAlert(const AlertEvent& event);
+    static void StopSampler();
+    static void RemoveEnv(void* env);
 };
 
 // Performance optimization utilities
@@ -129,7 +265,32 @@ private:
     static void ApplyPerformanceTuning(const std::string& operation, const std::string& suggestion);
 };
 
-// Performance benchmarking
+// Summary of one benchmark run. Latencies are per operation, in ns.
+struct BenchmarkResult {
+    std::string operation;
+    std::string algorithm;
+    std::string mode;           // "iterations" or "time"
+    uint64_t payloadSize;
+    uint32_t threads;
+    uint64_t warmupIterations;  // per thread
+    uint64_t operations;        // measured, all threads
+    double wallMs;
+    double nsPerOp;             // mean latency
+    double opsPerSecond;        // aggregate over all threads
+    double mbPerSecond;         // payload bytes, 10^6 per MB
+    uint64_t minNs;
+    uint64_t p50Ns;
+    uint64_t p90Ns;
+    uint64_t p99Ns;
+    uint64_t p999Ns;
+    uint64_t maxNs;
+    int64_t timestampUs;
+};
+
+// In-addon benchmark harness. Primitives run natively on dedicated threads,
+// so results exclude N-API marshalling; benchmarkNoop() gives JS callers the
+// bare call cost to compare against. Runs are serialized per environment
+// and executed off the JS thread; each settles a promise.
 class PerformanceBenchmark {
 public:
     static void Init(Napi::Env env, Napi::Object exports);
@@ -138,19 +299,23 @@ public:
     static Napi::Value BenchmarkOperation(const Napi::CallbackInfo& info);
     static Napi::Value CompareOperations(const Napi::CallbackInfo& info);
     static Napi::Value RunStressTest(const Napi::CallbackInfo& info);
+    static Napi::Value BenchmarkNoop(const Napi::CallbackInfo& info);
     
     // Benchmark results
     static Napi::Value GetBenchmarkResults(const Napi::CallbackInfo& info);
     static Napi::Value ExportBenchmarkData(const Napi::CallbackInfo& info);
     static Napi::Value GetBenchmarkHistory(const Napi::CallbackInfo& info);
     
+    // Called by the benchmark worker; keeps the last kMaxHistory runs per
+    // operation/algorithm/size/threads
+    static void StoreResult(const BenchmarkResult& result);
+    static Napi::Object ResultToObject(Napi::Env env, const BenchmarkResult& result);
+    
+    static const size_t kMaxHistory = 64;
+    
 private:
-    static std::map<std::string, std::vector<double>> benchmarkResults;
+    static std::map<std::string, std::vector<BenchmarkResult>> benchmarkResults;
     static std::mutex benchmarkMutex;
-    
-    static double RunSingleBenchmark(const std::string& operation, int iterations);
-    static std::vector<double> RunMultipleBenchmarks(const std::string& operation, int iterations, int runs);
-    static std::map<std::string, double> CalculateBenchmarkStats(const std::vector<double>& results);
 };
 
 } // namespace EnterpriseCrypto
@@ -0,0 +1,130 @@
+#include "random_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace EnterpriseCrypto {
+
+namespace {
+
+// Bumped in the child after fork(); blocks from an older generation are stale
+std::atomic<uint64_t> forkGeneration(0);
+std::once_flag forkHandlerOnce;
+
+void OnForkChild() {
+    forkGeneration++;
+}
+
+struct RandomBlock {
+    uint8_t data[RandomPool::kBlockSize];
+    size_t remaining;
+    uint64_t generation;
+    
+    RandomBlock() : remaining(0), generation(0) {}
+    ~RandomBlock() { OPENSSL_cleanse(data, sizeof(data)); }
+};
+
+thread_local RandomBlock publicBlock;
+thread_local RandomBlock privateBlock;
+
+} // namespace
+
+// Register the fast-path random functions
+void RandomPool::Init(Napi::Env env, Napi::Object exports) {
+#ifndef _WIN32
+    std::call_once(forkHandlerOnce, [] { pthread_atfork(nullptr, nullptr, OnForkChild); });
+#endif
+    
+    exports.Set("fillRandom", Napi::Function::New(env, FillRandom));
+    exports.Set("randomIV", Napi::Function::New(env, RandomIV));
+}
+
+bool RandomPool::Fill(uint8_t* out, size_t length, bool secret) {
+    if (length >= kDirectThreshold) {
+        return (secret ? RAND_priv_bytes(out, static_cast<int>(length))
+                       : RAND_bytes(out, static_cast<int>(length))) == 1;
+    }
+    
+    RandomBlock& block = secret ? privateBlock : publicBlock;
+    uint64_t generation = forkGeneration.load(std::memory_order_relaxed);
+    if (block.generation != generation) {
+        OPENSSL_cleanse(block.data, sizeof(block.data));
+        block.remaining = 0;
+        block.generation = generation;
+    }
+    
+    while (length > 0) {
+        if (block.remaining == 0) {
+            int ok = secret ? RAND_priv_bytes(block.data, sizeof(block.data))
+                            : RAND_bytes(block.data, sizeof(block.data));
+            if (ok != 1) {
+                return false;
+            }
+            block.remaining = sizeof(block.data);
+        }
+        
+        // Hand out from the tail and wipe what was taken
+        size_t take = std::min(length, block.remaining);
+        uint8_t* slice = block.data + block.remaining - take;
+        std::memcpy(out, slice, take);
+        OPENSSL_cleanse(slice, take);
+        block.remaining -= take;
+        out += take;
+        length -= take;
+    }
+    
+    return true;
+}
+
+Napi::Value RandomPool::FillRandom(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+    double offset = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().DoubleValue() : 0;
+    double length = info.Length() > 2 && info[2].IsNumber() ? info[2].As<Napi::Number>().DoubleValue()
+                                                            : static_cast<double>(buffer.Length()) - offset;
+    
+    if (!(offset >= 0 && length >= 0 && offset + length <= static_cast<double>(buffer.Length())) ||
+        length > static_cast<double>(INT32_MAX)) {
+        Napi::RangeError::New(env, "Offset and length out of range for buffer").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!Fill(buffer.Data() + static_cast<size_t>(offset), static_cast<size_t>(length))) {
+        Napi::Error::New(env, "Failed to generate random bytes").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return buffer;
+}
+
+Napi::Value RandomPool::RandomIV(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    uint32_t length = info.Length() > 0 && info[0].IsNumber() ? info[0].As<Napi::Number>().Uint32Value() : 12;
+    if (length < 1 || length > 64) {
+        Napi::RangeError::New(env, "IV length must be between 1 and 64").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> iv = Napi::Buffer<uint8_t>::New(env, length);
+    if (!Fill(iv.Data(), length)) {
+        Napi::Error::New(env, "Failed to generate random bytes").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return iv;
+}
+
+} // namespace EnterpriseCrypto
@@ -0,0 +1,40 @@
+#ifndef RANDOM_POOL_H
+#define RANDOM_POOL_H
+
+#include <napi.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace EnterpriseCrypto {
+
+// Per-thread buffered CSPRNG. Small requests (IVs, nonces, tokens) are served
+// from a block refilled from the OpenSSL DRBG kBlockSize bytes at a time, so
+// a 12-byte IV costs a memcpy instead of a DRBG round trip. Bytes are wiped
+// from the block as they are handed out, and every block is discarded in a
+// forked child so parent and child never return the same bytes.
+//
+// The public pool draws from RAND_bytes and is meant for values that are
+// sent in the clear; the private pool draws from RAND_priv_bytes and backs
+// generateSecureRandom (keys, session tokens).
+class RandomPool {
+public:
+    static const size_t kBlockSize = 4096;
+    
+    // Requests at least this large bypass the buffer and go to the DRBG directly
+    static const size_t kDirectThreshold = kBlockSize / 4;
+    
+    static void Init(Napi::Env env, Napi::Object exports);
+    
+    // Fill out with length random bytes; false only if the DRBG fails
+    static bool Fill(uint8_t* out, size_t length, bool secret = false);
+    
+    // fillRandom(buffer[, offset[, length]]) -> buffer
+    static Napi::Value FillRandom(const Napi::CallbackInfo& info);
+    
+    // randomIV(length = 12) -> Buffer, no result object or audit entry
+    static Napi::Value RandomIV(const Napi::CallbackInfo& info);
+};
+
+} // namespace EnterpriseCrypto
+
+#endif // RANDOM_POOL_H
@@ -0,0 +1,499 @@
+#include "signature_engine.h"
+#include "crypto_operations.h"
+#include "performance_monitor.h"
+#include "hash_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <openssl/bio.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+namespace EnterpriseCrypto {
+
+namespace {
+
+const uint32_t kVerifyBatchMetric = PerformanceMonitor::RegisterOperation("verifyBatch");
+
+struct RegisteredKey {
+    SignatureEngine::KeyPtr key;
+    SignatureEngine::Algorithm algorithm;
+};
+
+std::shared_mutex keysMutex;
+std::unordered_map<std::string, RegisteredKey> registeredKeys;
+
+// Keys passed inline, by fingerprint. Bounded; cleared wholesale when full
+// since inline keys are the cold path compared to registered ones.
+const size_t kMaxInlineKeys = 256;
+std::unordered_map<std::string, SignatureEngine::KeyPtr> inlineKeys;
+
+// Fixed set of threads that split one batch at a time. The caller runs
+// items too, so a pool of N threads gives N + 1 way parallelism.
+class VerifyPool {
+public:
+    static VerifyPool& Instance() {
+        static VerifyPool pool;
+        return pool;
+    }
+    
+    void AddEnv() {
+        std::lock_guard<std::mutex> lock(mutex);
+        envCount++;
+    }
+    
+    // Run fn(i) for i in [0, count); returns when all calls have finished
+    void Run(size_t count, const std::function<void(size_t)>& fn) {
+        std::lock_guard<std::mutex> runLock(runMutex);
+        
+        std::unique_lock<std::mutex> lock(mutex);
+        if (workers.empty() && !stopping) {
+            unsigned hardware = std::max(2u, std::min(5u, std::thread::hardware_concurrency()));
+            size_t threads = hardware - 1;
+            for (size_t i = 0; i < threads; i++) {
+                workers.emplace_back([this] { WorkerLoop(); });
+            }
+        }
+        task = &fn;
+        total = count;
+        next = 0;
+        busy = workers.size();
+        generation++;
+        lock.unlock();
+        start.notify_all();
+        
+        Drain();
+        
+        lock.lock();
+        done.wait(lock, [this] { return busy == 0; });
+        task = nullptr;
+    }
+    
+    // Env cleanup hook: join the workers once the last environment goes away
+    static void Shutdown(void*) {
+        VerifyPool& pool = Instance();
+        std::vector<std::thread> joinable;
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if (--pool.envCount > 0) {
+                return;
+            }
+            pool.stopping = true;
+            joinable.swap(pool.workers);
+        }
+        pool.start.notify_all();
+        for (std::thread& worker : joinable) {
+            worker.join();
+        }
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.stopping = false;
+    }
+    
+private:
+    void Drain() {
+        size_t i;
+        while ((i = next.fetch_add(1, std::memory_order_relaxed)) < total) {
+            (*task)(i);
+        }
+    }
+    
+    void WorkerLoop() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            start.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            lock.unlock();
+            
+            Drain();
+            
+            lock.lock();
+            if (--busy == 0) {
+                done.notify_one();
+            }
+        }
+    }
+    
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable start;
+    std::condition_variable done;
+    std::vector<std::thread> workers;
+    const std::function<void(size_t)>* task = nullptr;
+    size_t total = 0;
+    std::atomic<size_t> next{0};
+    size_t busy = 0;
+    uint64_t generation = 0;
+    size_t envCount = 0;
+    bool stopping = false;
+};
+
+// Batches smaller than this are verified inline on the calling thread
+const size_t kParallelThreshold = 8;
+
+} // namespace
+
+// Register key management and batch verification
+void SignatureEngine::Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("registerPublicKey", Napi::Function::New(env, RegisterPublicKey));
+    exports.Set("unregisterPublicKey", Napi::Function::New(env, UnregisterPublicKey));
+    exports.Set("verifyBatch", Napi::Function::New(env, VerifyBatch));
+    
+    VerifyPool::Instance().AddEnv();
+    napi_add_env_cleanup_hook(env, VerifyPool::Shutdown, nullptr);
+}
+
+SignatureEngine::Algorithm SignatureEngine::ParseAlgorithm(const std::string& name) {
+    if (name == "ed25519") {
+        return Ed25519;
+    }
+    if (name == "es256" || name == "ecdsa-p256" || name == "ec-p256") {
+        return ES256;
+    }
+    return Unknown;
+}
+
+const char* SignatureEngine::AlgorithmName(Algorithm algorithm) {
+    return algorithm == Ed25519 ? "ed25519" : algorithm == ES256 ? "es256" : "unknown";
+}
+
+// Accepts PEM, DER (SPKI / PKCS#8) or, for Ed25519, the raw 32-byte key
+SignatureEngine::KeyPtr SignatureEngine::ParseKey(const uint8_t* data, size_t length, Algorithm algorithm,
+                                                  bool isPrivate, std::string& error) {
+    EVP_PKEY* key = nullptr;
+    
+    if (algorithm == Ed25519 && length == 32) {
+        key = isPrivate ? EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, nullptr, data, length)
+                        : EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, nullptr, data, length);
+    } else if (length > 10 && std::memcmp(data, "-----BEGIN", 10) == 0) {
+        BIO* bio = BIO_new_mem_buf(data, static_cast<int>(length));
+        if (bio) {
+            key = isPrivate ? PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr)
+                            : PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
+            BIO_free(bio);
+        }
+    } else {
+        const unsigned char* cursor = data;
+        key = isPrivate ? d2i_AutoPrivateKey(nullptr, &cursor, static_cast<long>(length))
+                        : d2i_PUBKEY(nullptr, &cursor, static_cast<long>(length));
+    }
+    
+    if (!key) {
+        error = isPrivate ? "Failed to parse private key" : "Failed to parse public key";
+        return KeyPtr();
+    }
+    
+    KeyPtr owned(key, EVP_PKEY_free);
+    
+    bool matches = false;
+    if (algorithm == Ed25519) {
+        matches = EVP_PKEY_get_base_id(key) == EVP_PKEY_ED25519;
+    } else if (algorithm == ES256) {
+        char group[32] = { 0 };
+        size_t groupLength = 0;
+        matches = EVP_PKEY_get_base_id(key) == EVP_PKEY_EC &&
+                  EVP_PKEY_get_group_name(key, group, sizeof(group), &groupLength) == 1 &&
+                  std::string(group, groupLength) == "prime256v1";
+    }
+    
+    if (!matches) {
+        error = std::string("Key does not match algorithm ") + AlgorithmName(algorithm);
+        return KeyPtr();
+    }
+    
+    return owned;
+}
+
+SignatureEngine::KeyPtr SignatureEngine::GetInlineKey(const uint8_t* data, size_t length, Algorithm algorithm,
+                                                      bool isPrivate, std::string& error) {
+    // SHA-256 of the key material, as the HMAC key cache does; a short
+    // non-cryptographic id could hand one key's EVP_PKEY to another
+    uint8_t fingerprint[32];
+    unsigned int fingerprintLength = 0;
+    if (EVP_Digest(data, length, fingerprint, &fingerprintLength, HashEngine::ResolveDigest("sha256"), nullptr) != 1) {
+        error = "Failed to fingerprint key";
+        return KeyPtr();
+    }
+    std::string cacheKey = std::string(isPrivate ? "priv:" : "pub:") + AlgorithmName(algorithm) + ":" +
+                           std::string(reinterpret_cast<char*>(fingerprint), fingerprintLength);
+    
+    {
+        std::shared_lock<std::shared_mutex> lock(keysMutex);
+        auto it = inlineKeys.find(cacheKey);
+        if (it != inlineKeys.end()) {
+            return it->second;
+        }
+    }
+    
+    KeyPtr key = ParseKey(data, length, algorithm, isPrivate, error);
+    if (!key) {
+        return key;
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(keysMutex);
+    if (inlineKeys.size() >= kMaxInlineKeys) {
+        inlineKeys.clear();
+    }
+    inlineKeys[cacheKey] = key;
+    return key;
+}
+
+SignatureEngine::KeyPtr SignatureEngine::GetRegisteredKey(const std::string& keyId, Algorithm& algorithm) {
+    std::shared_lock<std::shared_mutex> lock(keysMutex);
+    auto it = registeredKeys.find(keyId);
+    if (it == registeredKeys.end()) {
+        return KeyPtr();
+    }
+    algorithm = it->second.algorithm;
+    return it->second.key;
+}
+
+bool SignatureEngine::Sign(EVP_PKEY* key, Algorithm algorithm, const uint8_t* data, size_t length,
+                           std::vector<uint8_t>& signature, std::string& error) {
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    const EVP_MD* md = algorithm == ES256 ? HashEngine::ResolveDigest("sha256") : nullptr;
+    size_t signatureLength = 0;
+    
+    bool ok = ctx &&
+              EVP_DigestSignInit(ctx, nullptr, md, nullptr, key) == 1 &&
+              EVP_DigestSign(ctx, nullptr, &signatureLength, data, length) == 1;
+    if (ok) {
+        signature.resize(signatureLength);
+        ok = EVP_DigestSign(ctx, signature.data(), &signatureLength, data, length) == 1;
+        signature.resize(signatureLength);
+    }
+    EVP_MD_CTX_free(ctx);
+    
+    if (!ok) {
+        error = "Failed to sign data";
+        return false;
+    }
+    
+    // DER -> JOSE r||s
+    if (algorithm == ES256) {
+        const unsigned char* cursor = signature.data();
+        ECDSA_SIG* sig = d2i_ECDSA_SIG(nullptr, &cursor, static_cast<long>(signature.size()));
+        if (!sig) {
+            error = "Failed to encode ES256 signature";
+            return false;
+        }
+        std::vector<uint8_t> raw(64);
+        BN_bn2binpad(ECDSA_SIG_get0_r(sig), raw.data(), 32);
+        BN_bn2binpad(ECDSA_SIG_get0_s(sig), raw.data() + 32, 32);
+        ECDSA_SIG_free(sig);
+        signature.swap(raw);
+    }
+    
+    return true;
+}
+
+bool SignatureEngine::Verify(EVP_PKEY* key, Algorithm algorithm, const uint8_t* data, size_t length,
+                             const uint8_t* signature, size_t signatureLength) {
+    // JOSE r||s -> DER for OpenSSL
+    std::vector<uint8_t> der;
+    if (algorithm == ES256 && signatureLength == 64) {
+        ECDSA_SIG* sig = ECDSA_SIG_new();
+        BIGNUM* r = BN_bin2bn(signature, 32, nullptr);
+        BIGNUM* s = BN_bin2bn(signature + 32, 32, nullptr);
+        if (!sig || !r || !s || ECDSA_SIG_set0(sig, r, s) != 1) {
+            BN_free(r);
+            BN_free(s);
+            ECDSA_SIG_free(sig);
+            return false;
+        }
+        int derLength = i2d_ECDSA_SIG(sig, nullptr);
+        if (derLength > 0) {
+            der.resize(derLength);
+            unsigned char* cursor = der.data();
+            i2d_ECDSA_SIG(sig, &cursor);
+        }
+        ECDSA_SIG_free(sig);
+        if (der.empty()) {
+            return false;
+        }
+        signature = der.data();
+        signatureLength = der.size();
+    }
+    
+    // One digest context per thread, reset after every verification
+    static thread_local std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    if (!ctx) {
+        return false;
+    }
+    
+    const EVP_MD* md = algorithm == ES256 ? HashEngine::ResolveDigest("sha256") : nullptr;
+    bool valid = EVP_DigestVerifyInit(ctx.get(), nullptr, md, nullptr, key) == 1 &&
+                 EVP_DigestVerify(ctx.get(), signature, signatureLength, data, length) == 1;
+    EVP_MD_CTX_reset(ctx.get());
+    return valid;
+}
+
+// registerPublicKey(keyId, key, algorithm) - parse once, verify by id afterwards
+Napi::Value SignatureEngine::RegisterPublicKey(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 3 || !info[0].IsString() || !info[1].IsBuffer() || !info[2].IsString()) {
+        Napi::TypeError::New(env, "Expected keyId, public key buffer, and algorithm").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string keyId = info[0].As<Napi::String>().Utf8Value();
+    Algorithm algorithm = ParseAlgorithm(info[2].As<Napi::String>().Utf8Value());
+    if (algorithm == Unknown) {
+        Napi::TypeError::New(env, "Unsupported signature algorithm").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Buffer<uint8_t> keyData = info[1].As<Napi::Buffer<uint8_t>>();
+    std::string error;
+    KeyPtr key = ParseKey(keyData.Data(), keyData.Length(), algorithm, false, error);
+    if (!key) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    {
+        std::unique_lock<std::shared_mutex> lock(keysMutex);
+        registeredKeys[keyId] = RegisteredKey{ key, algorithm };
+    }
+    
+    CryptoOperations::LogCryptoOperation("registerPublicKey", keyId, 0.0);
+    return Napi::String::New(env, keyId);
+}
+
+Napi::Value SignatureEngine::UnregisterPublicKey(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected keyId").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::string keyId = info[0].As<Napi::String>().Utf8Value();
+    std::unique_lock<std::shared_mutex> lock(keysMutex);
+    return Napi::Boolean::New(env, registeredKeys.erase(keyId) > 0);
+}
+
+// verifyBatch(items: { msg: Buffer, sig: Buffer, keyId: string }[])
+//   -> { bitmap: Buffer, validCount, count }
+// Items with an unknown keyId or malformed fields count as invalid.
+Napi::Value SignatureEngine::VerifyBatch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "Expected array of { msg, sig, keyId }").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    struct Item {
+        const uint8_t* msg;
+        size_t msgLength;
+        const uint8_t* sig;
+        size_t sigLength;
+        KeyPtr key;
+        Algorithm algorithm;
+    };
+    
+    // Gather raw pointers on the JS thread. The Buffers stay alive and
+    // unmoved because JS cannot run until this call returns.
+    Napi::Array items = info[0].As<Napi::Array>();
+    uint32_t count = items.Length();
+    std::vector<Item> work(count);
+    std::string cachedKeyId;
+    KeyPtr cachedKey;
+    Algorithm cachedAlgorithm = Unknown;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        Item& item = work[i];
+        item.algorithm = Unknown;
+        
+        Napi::Value value = items.Get(i);
+        if (!value.IsObject()) {
+            continue;
+        }
+        Napi::Object entry = value.As<Napi::Object>();
+        Napi::Value msg = entry.Get("msg");
+        Napi::Value sig = entry.Get("sig");
+        Napi::Value keyId = entry.Get("keyId");
+        if (!msg.IsBuffer() || !sig.IsBuffer() || !keyId.IsString()) {
+            continue;
+        }
+        
+        // Bursts are usually dominated by one or two keys
+        std::string id = keyId.As<Napi::String>().Utf8Value();
+        if (id != cachedKeyId || !cachedKey) {
+            cachedKeyId = id;
+            cachedKey = GetRegisteredKey(id, cachedAlgorithm);
+        }
+        if (!cachedKey) {
+            continue;
+        }
+        
+        item.msg = msg.As<Napi::Buffer<uint8_t>>().Data();
+        item.msgLength = msg.As<Napi::Buffer<uint8_t>>().Length();
+        item.sig = sig.As<Napi::Buffer<uint8_t>>().Data();
+        item.sigLength = sig.As<Napi::Buffer<uint8_t>>().Length();
+        item.key = cachedKey;
+        item.algorithm = cachedAlgorithm;
+    }
+    
+    std::vector<uint8_t> results(count, 0);
+    std::function<void(size_t)> verifyOne = [&](size_t i) {
+        const Item& item = work[i];
+        if (item.algorithm != Unknown) {
+            results[i] = Verify(item.key.get(), item.algorithm, item.msg, item.msgLength,
+                                item.sig, item.sigLength) ? 1 : 0;
+        }
+    };
+    
+    if (count < kParallelThreshold) {
+        for (size_t i = 0; i < count; i++) {
+            verifyOne(i);
+        }
+    } else {
+        VerifyPool::Instance().Run(count, verifyOne);
+    }
+    
+    Napi::Buffer<uint8_t> bitmap = Napi::Buffer<uint8_t>::New(env, (count + 7) / 8);
+    std::memset(bitmap.Data(), 0, bitmap.Length());
+    size_t validCount = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (results[i]) {
+            bitmap.Data()[i >> 3] |= static_cast<uint8_t>(1u << (i & 7));
+            validCount++;
+        }
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    CryptoOperations::RecordPerformanceMetric(kVerifyBatchMetric, duration, count);
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("bitmap", bitmap);
+    result.Set("validCount", validCount);
+    result.Set("count", count);
+    
+    Napi::Object performance = Napi::Object::New(env);
+    performance.Set("duration", duration);
+    performance.Set("dataSize", count);
+    result.Set("performance", performance);
+    
+    return result;
+}
+
+} // namespace EnterpriseCrypto
@@ -0,0 +1,59 @@
+#ifndef SIGNATURE_ENGINE_H
+#define SIGNATURE_ENGINE_H
+
+#include <napi.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <openssl/evp.h>
+
+namespace EnterpriseCrypto {
+
+// Ed25519 and ES256 (ECDSA P-256 / SHA-256) signing and verification.
+//
+// Parsed keys are cached as EVP_PKEY handles so the hot path never re-parses
+// PEM/DER: keys registered with registerPublicKey(keyId, key, algorithm) are
+// looked up by id, and keys passed inline to signData/verifySignature are
+// cached under their fingerprint. ES256 signatures use the JOSE r||s form
+// (64 bytes) on output; on input both r||s and DER are accepted.
+//
+// verifyBatch([{ msg, sig, keyId }]) checks a whole burst in one call,
+// spreading the work over a small persistent thread pool (the calling thread
+// takes part), and returns a bitmap with bit i set when item i verified.
+class SignatureEngine {
+public:
+    enum Algorithm { Ed25519, ES256, Unknown };
+    
+    typedef std::shared_ptr<EVP_PKEY> KeyPtr;
+    
+    static void Init(Napi::Env env, Napi::Object exports);
+    
+    static Algorithm ParseAlgorithm(const std::string& name);
+    static const char* AlgorithmName(Algorithm algorithm);
+    
+    // Parsed key for inline key material, cached by SHA-256 fingerprint
+    static KeyPtr GetInlineKey(const uint8_t* data, size_t length, Algorithm algorithm,
+                               bool isPrivate, std::string& error);
+    
+    // Registered public key; algorithm receives the algorithm it was registered with
+    static KeyPtr GetRegisteredKey(const std::string& keyId, Algorithm& algorithm);
+    
+    static bool Sign(EVP_PKEY* key, Algorithm algorithm, const uint8_t* data, size_t length,
+                     std::vector<uint8_t>& signature, std::string& error);
+    
+    // Thread-safe; used from pool threads
+    static bool Verify(EVP_PKEY* key, Algorithm algorithm, const uint8_t* data, size_t length,
+                       const uint8_t* signature, size_t signatureLength);
+    
+    static Napi::Value RegisterPublicKey(const Napi::CallbackInfo& info);
+    static Napi::Value UnregisterPublicKey(const Napi::CallbackInfo& info);
+    static Napi::Value VerifyBatch(const Napi::CallbackInfo& info);
+    
+private:
+    static KeyPtr ParseKey(const uint8_t* data, size_t length, Algorithm algorithm,
+                           bool isPrivate, std::string& error);
+};
+
+} // namespace EnterpriseCrypto
+
+#endif // SIGNATURE_ENGINE_H
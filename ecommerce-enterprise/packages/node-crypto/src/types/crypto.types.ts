@@ -141,6 +141,7 @@ export interface AuditEntry {
   userAgent?: string;
   duration: number;
   dataSize: number;
+  truncated?: boolean; // a field was cut to its inline capacity or dropped
 }
 
 export interface AuditLog {
@@ -178,6 +179,14 @@ export interface PerformanceMetric {
   averageDataSize: number;
   lastCall: string;
   firstCall: string;
+  failureCount: number;
+  // Latency percentiles in milliseconds, from log-linear histograms (~3% precision)
+  p50Duration: number;
+  p90Duration: number;
+  p99Duration: number;
+  p999Duration: number;
+  p50DataSize: number;
+  p99DataSize: number;
 }
 
 export interface PerformanceAnalysis {
@@ -223,8 +232,16 @@ export interface CryptoConfig {
   fileLogging: boolean;
   auditFilePath: string;
   maxMemoryEntries: number;
+  auditFsync?: AuditFsyncMode;
+  auditFsyncIntervalMs?: number;
+  auditFormat?: 'text' | 'binary'; // binary writes mmap-readable audit segments
+  auditSegmentDirectory?: string;
 }
 
+// Durability of the audit file: never fsync, fsync on an interval, or fsync
+// after every group commit (SOX)
+export type AuditFsyncMode = 'none' | 'interval' | 'batch';
+
 export type EnhancedCryptoServiceConfig = CryptoConfig;
 
 export interface PerformanceThresholds {
@@ -322,8 +339,8 @@ export class AuditError extends Error implements CryptoError {
 // Algorithm Types
 export type SymmetricAlgorithm = 'aes-256-gcm' | 'aes-128-gcm' | 'aes-256-cbc' | 'aes-128-cbc';
 export type AsymmetricAlgorithm = 'rsa-2048' | 'rsa-4096' | 'ec-p256' | 'ec-p384' | 'ec-p521';
-export type HashAlgorithm = 'sha256' | 'sha384' | 'sha512' | 'sha3-256' | 'sha3-384' | 'sha3-512';
-export type HMACAlgorithm = 'hmac-sha256' | 'hmac-sha384' | 'hmac-sha512';
+export type HashAlgorithm = 'sha256' | 'sha384' | 'sha512' | 'sha3-256' | 'sha3-384' | 'sha3-512' | 'blake2b512' | 'blake2s256';
+export type HMACAlgorithm = 'hmac-sha256' | 'hmac-sha384' | 'hmac-sha512' | 'hmac-sha3-256' | 'hmac-sha3-512' | 'hmac-blake2b512';
 
 // Utility Types
 export type BufferLike = Buffer | Uint8Array | ArrayBuffer | string;
@@ -0,0 +1,135 @@
+#!/usr/bin/env node
+
+// Benchmarks for node_streams_addon, written as an addon-bench/1 report.
+//
+//   npm run bench -- [--out results.json] [--duration 1000] [--quick]
+//   node ../../scripts/compare-benchmarks.js baseline.json results.json
+//
+// Native rows come from the node_streams_bench binary (chunk ring and
+// codecs without N-API); node rows time the same engines through the
+// addon's classes, per call and batched.
+
+const crypto = require('crypto');
+const path = require('path');
+const {
+  parseBenchArgs, createReport, timeCalls, addResult, runNativeBench, writeReport,
+} = require('../../../scripts/bench-report');
+
+const release = path.join(__dirname, '..', 'build', 'Release');
+const addon = require(path.join(release, 'node_streams_addon.node'));
+const { version } = require('../package.json');
+
+const options = parseBenchArgs(process.argv.slice(2));
+const payloadSizes = options.quick ? [1024, 1024 * 1024] : [64, 1024, 16384, 1024 * 1024];
+const batchSizes = options.quick ? [64] : [16, 256];
+
+// Largest FrameMux window, so credit never limits the frame benchmarks
+const kWindow = 4294967295;
+
+function nativeArgs() {
+  return ['--duration', String(options.durationMs), ...(options.quick ? ['--quick'] : [])];
+}
+
+// Compressible like the native bench payload: short JSON records
+function makePayload(payloadSize) {
+  const records = [];
+  let length = 0;
+  while (length < payloadSize) {
+    const record = JSON.stringify({ id: length, sku: crypto.randomBytes(3).toString('hex'), qty: length % 7 });
+    records.push(record);
+    length += record.length + 1;
+  }
+  return Buffer.from(records.join(',')).subarray(0, payloadSize);
+}
+
+function benchCompression(report) {
+  for (const algorithm of addon.getCompressionBackends()) {
+    for (const payloadSize of payloadSizes) {
+      const payload = makePayload(payloadSize);
+      const compressor = new addon.CompressedStream({ compressionAlgorithm: algorithm });
+      const decompressor = new addon.CompressedStream({ compressionAlgorithm: algorithm, mode: 'decompress' });
+      const compressed = compressor.process(payload);
+      const callsPerRound = payloadSize >= 1024 * 1024 ? 1 : 16;
+      const timing = { ...options, payloadSize, callsPerRound };
+      addResult(report, `CompressedStream.${algorithm}.compress`, 'node', { payloadSize, threads: 1 },
+                timeCalls(() => compressor.process(payload), timing));
+      addResult(report, `CompressedStream.${algorithm}.decompress`, 'node', { payloadSize, threads: 1 },
+                timeCalls(() => decompressor.process(compressed), timing));
+
+      // Matches the native zstd worker rows
+      if (algorithm === 'zstd' && payloadSize >= 1024 * 1024) {
+        for (const workers of [2, 4]) {
+          const parallel = new addon.CompressedStream({ compressionAlgorithm: algorithm, workers, parallelThreshold: 0 });
+          addResult(report, `CompressedStream.${algorithm}.compress`, 'node', { payloadSize, threads: workers },
+                    timeCalls(() => parallel.process(payload), timing));
+        }
+      }
+    }
+  }
+}
+
+// Frames written then flushed as one Buffer set, and the same bytes parsed
+// back; operations are frames
+function benchFrameMux(report) {
+  for (const payloadSize of payloadSizes.filter(size => size <= 16384)) {
+    const chunk = crypto.randomBytes(payloadSize);
+    for (const batch of batchSizes) {
+      // Nothing carries credit back to the sender, so it is replaced before
+      // any channel runs out of window
+      let sender = new addon.FrameMux({ initialWindow: kWindow });
+      let sent = 0;
+      const receiver = new addon.FrameMux({ initialWindow: kWindow });
+      const timing = { ...options, payloadSize, opsPerCall: batch, callsPerRound: 4 };
+      let flushed = [];
+      addResult(report, 'FrameMux.writeFlush', 'node', { payloadSize, batch }, timeCalls(() => {
+        if (sent > kWindow / 2) {
+          sender = new addon.FrameMux({ initialWindow: kWindow });
+          sent = 0;
+        }
+        for (let i = 0; i < batch; i++) {
+          sender.write(i & 7, chunk);
+        }
+        sent += batch * payloadSize;
+        flushed = sender.flush();
+      }, timing));
+      const wire = Buffer.concat(flushed);
+      addResult(report, 'FrameMux.receive', 'node', { payloadSize, batch }, timeCalls(() => {
+        receiver.receive(wire);
+        for (let channel = 0; channel < 8; channel++) {
+          receiver.consume(channel, wire.length);
+        }
+      }, timing));
+    }
+  }
+}
+
+function benchRateLimiter(report) {
+  const limiter = new addon.RateLimiter({ maxRequests: 1e9, windowMs: 1000 });
+  const keys = Array.from({ length: 1024 }, (_, i) => `client-${i}`);
+  let next = 0;
+  addResult(report, 'RateLimiter.tryAcquire', 'node', {}, timeCalls(() => {
+    limiter.tryAcquire(keys[next++ & 1023]);
+  }, options));
+  for (const batch of batchSizes) {
+    const slice = keys.slice(0, batch);
+    const out = new Uint8Array(batch);
+    addResult(report, 'RateLimiter.tryAcquireMany', 'node', { batch },
+              timeCalls(() => limiter.tryAcquireMany(slice, 1, out), { ...options, opsPerCall: batch, callsPerRound: 8 }));
+  }
+}
+
+function main() {
+  const report = createReport('node-streams', version);
+  runNativeBench(report, path.join(release, 'node_streams_bench'), nativeArgs());
+  benchCompression(report);
+  benchFrameMux(report);
+  benchRateLimiter(report);
+  writeReport(report, options.out);
+}
+
+try {
+  main();
+} catch (error) {
+  console.error(error);
+  process.exit(1);
+}
@@ -0,0 +1,310 @@
+// Standalone microbenchmarks for the napi-free engines of node_streams_addon:
+// the chunk ring that feeds pipeline threads and the compression codecs.
+// Built by the node_streams_bench target in binding.gyp and run by
+// bench/harness.js, which folds the JSON array printed on stdout into its
+// addon-bench/1 report.
+//
+//   node_streams_bench [--duration ms] [--quick]
+
+#include "../src/chunk_ring.h"
+#include "../src/compression_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+uint64_t NowNs() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct BenchResult {
+  BenchResult() : operations(0), elapsedNs(0), payloadSize(0) {}
+
+  std::string name;
+  std::vector<std::pair<std::string, double>> params;
+  uint64_t operations;
+  uint64_t elapsedNs;
+  size_t payloadSize;
+  std::vector<double> samples;  // mean ns per operation of each round
+};
+
+double Percentile(std::vector<double>& sorted, double percentile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  size_t index = static_cast<size_t>(percentile / 100.0 * static_cast<double>(sorted.size()));
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void PrintResults(std::vector<BenchResult>& results) {
+  std::printf("[\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    BenchResult& result = results[i];
+    std::sort(result.samples.begin(), result.samples.end());
+    double seconds = static_cast<double>(result.elapsedNs) / 1e9;
+    double opsPerSecond = seconds > 0 ? static_cast<double>(result.operations) / seconds : 0;
+
+    std::string params;
+    for (const std::pair<std::string, double>& param : result.params) {
+      char value[64];
+      std::snprintf(value, sizeof(value), "%s\"%s\": %.17g", params.empty() ? "" : ", ",
+                    param.first.c_str(), param.second);
+      params += value;
+    }
+    std::printf("  { \"name\": \"%s\", \"params\": { %s }, \"operations\": %llu, \"nsPerOp\": %.3f, "
+                "\"opsPerSecond\": %.3f, \"mbPerSecond\": %.3f, \"p50Ns\": %.3f, \"p99Ns\": %.3f }%s\n",
+                result.name.c_str(), params.c_str(), static_cast<unsigned long long>(result.operations),
+                result.operations ? static_cast<double>(result.elapsedNs) / static_cast<double>(result.operations) : 0.0,
+                opsPerSecond, opsPerSecond * static_cast<double>(result.payloadSize) / 1e6,
+                Percentile(result.samples, 50), Percentile(result.samples, 99),
+                i + 1 < results.size() ? "," : "");
+  }
+  std::printf("]\n");
+}
+
+// Call round() until durationMs has passed; each call returns how many
+// operations it did and becomes one latency sample
+template <typename Round>
+void MeasureRounds(BenchResult& result, uint64_t durationMs, Round round) {
+  uint64_t warmupEnd = NowNs() + std::min<uint64_t>(100, durationMs / 4) * 1000000ull;
+  while (NowNs() < warmupEnd) {
+    round();
+  }
+
+  uint64_t start = NowNs();
+  uint64_t deadline = start + durationMs * 1000000ull;
+  uint64_t last = start;
+  while (last < deadline) {
+    uint64_t operations = round();
+    uint64_t now = NowNs();
+    result.samples.push_back(static_cast<double>(now - last) / static_cast<double>(std::max<uint64_t>(operations, 1)));
+    result.operations += operations;
+    last = now;
+  }
+  result.elapsedNs = last - start;
+}
+
+struct Chunk {
+  explicit Chunk(size_t length) : length(length) {}
+  size_t length;
+};
+
+// Fill and drain on one thread: the uncontended cost of a push plus a pop
+BenchResult BenchRingLocal(size_t capacity, uint64_t durationMs) {
+  BenchResult result;
+  result.name = "ChunkRing.pushPop";
+  result.params = { { "capacity", static_cast<double>(capacity) }, { "threads", 1 } };
+
+  SpscRing<Chunk> ring(capacity);
+  std::vector<std::unique_ptr<Chunk>> items;
+  for (size_t i = 0; i < ring.Capacity(); i++) {
+    items.emplace_back(new Chunk(i));
+  }
+  MeasureRounds(result, durationMs, [&]() -> uint64_t {
+    for (std::unique_ptr<Chunk>& item : items) {
+      ring.TryPush(item);
+    }
+    for (std::unique_ptr<Chunk>& item : items) {
+      ring.TryPop(item);
+    }
+    return items.size();
+  });
+  return result;
+}
+
+// Producer and consumer threads. Items travel back on a second ring so the
+// run measures hand-offs and not the allocator; operations are items the
+// consumer received.
+BenchResult BenchRingTransfer(size_t capacity, uint64_t durationMs) {
+  BenchResult result;
+  result.name = "ChunkRing.transfer";
+  result.params = { { "capacity", static_cast<double>(capacity) }, { "threads", 2 } };
+
+  SpscRing<Chunk> forward(capacity);
+  SpscRing<Chunk> back(capacity);
+  for (size_t i = 0; i < forward.Capacity(); i++) {
+    std::unique_ptr<Chunk> item(new Chunk(i));
+    back.TryPush(item);
+  }
+
+  std::atomic<bool> stop(false);
+  std::thread producer([&]() {
+    std::unique_ptr<Chunk> item;
+    while (!stop.load(std::memory_order_relaxed)) {
+      if (!item && !back.TryPop(item)) {
+        std::this_thread::yield();
+        continue;
+      }
+      if (!forward.TryPush(item)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  const uint64_t kRound = 4096;
+  std::unique_ptr<Chunk> item;
+  MeasureRounds(result, durationMs, [&]() -> uint64_t {
+    uint64_t received = 0;
+    while (received < kRound) {
+      if (!forward.TryPop(item)) {
+        std::this_thread::yield();
+        continue;
+      }
+      received++;
+      while (!back.TryPush(item)) {
+        std::this_thread::yield();
+      }
+    }
+    return received;
+  });
+  stop.store(true, std::memory_order_relaxed);
+  producer.join();
+  return result;
+}
+
+// Output kept in one reused vector, as a pipeline stage would
+class VectorSink : public CompressionSink {
+public:
+  uint8_t* Reserve(size_t minimum, size_t& available) override {
+    if (bytes.size() - size < minimum) {
+      bytes.resize(size + std::max(minimum, bytes.size()));
+    }
+    available = bytes.size() - size;
+    return bytes.data() + size;
+  }
+
+  void Commit(size_t written) override { size += written; }
+
+  std::vector<uint8_t> bytes;
+  size_t size = 0;
+};
+
+// JSON-like records: compressible the way API payloads are, without being
+// one repeated byte
+std::vector<uint8_t> MakePayload(size_t length) {
+  static const char* const kFields[] = { "\"id\":", "\"sku\":\"", "\"price\":", "\"qty\":", "\"tags\":[\"" };
+  std::vector<uint8_t> payload;
+  payload.reserve(length);
+  uint32_t state = 2463534242u;
+  while (payload.size() < length) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    const char* field = kFields[state % 5];
+    payload.insert(payload.end(), field, field + std::strlen(field));
+    for (int digits = 0; digits < 6; digits++) {
+      payload.push_back(static_cast<uint8_t>('0' + (state >> (digits * 4)) % 10));
+    }
+    payload.push_back(',');
+  }
+  payload.resize(length);
+  return payload;
+}
+
+bool BenchCodec(const std::string& algorithm, bool decompress, size_t payloadSize, int workers,
+                uint64_t durationMs, BenchResult& result, std::string& error) {
+  std::vector<uint8_t> payload = MakePayload(payloadSize);
+
+  CompressionOptions options;
+  options.algorithm = algorithm;
+  options.workers = workers;
+  std::unique_ptr<CompressionCodec> codec = CompressionCodec::Create(options, error);
+  if (!codec) {
+    return false;
+  }
+  codec->SetParallel(workers > 0);
+
+  VectorSink compressed;
+  if (!codec->Process(payload.data(), payload.size(), compressed, error)) {
+    return false;
+  }
+
+  if (decompress) {
+    options.decompress = true;
+    codec = CompressionCodec::Create(options, error);
+    if (!codec) {
+      return false;
+    }
+  }
+
+  const uint8_t* input = decompress ? compressed.bytes.data() : payload.data();
+  size_t inputLength = decompress ? compressed.size : payload.size();
+  VectorSink sink;
+  bool ok = true;
+  result.name = "CompressionCodec." + algorithm + (decompress ? ".decompress" : ".compress");
+  result.params = { { "payloadSize", static_cast<double>(payloadSize) }, { "threads", static_cast<double>(std::max(workers, 1)) } };
+  result.payloadSize = payloadSize;
+  MeasureRounds(result, durationMs, [&]() -> uint64_t {
+    sink.size = 0;
+    ok = ok && codec->Process(input, inputLength, sink, error);
+    return 1;
+  });
+  return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint64_t durationMs = 1000;
+  bool quick = false;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+      durationMs = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--quick") == 0) {
+      quick = true;
+    } else {
+      std::fprintf(stderr, "usage: %s [--duration ms] [--quick]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (quick) {
+    durationMs = std::min<uint64_t>(durationMs, 200);
+  }
+  durationMs = std::max<uint64_t>(durationMs, 1);
+
+  std::vector<BenchResult> results;
+  std::vector<size_t> capacities = quick ? std::vector<size_t>{ 1024 } : std::vector<size_t>{ 64, 1024 };
+  for (size_t capacity : capacities) {
+    results.push_back(BenchRingLocal(capacity, durationMs));
+    results.push_back(BenchRingTransfer(capacity, durationMs));
+  }
+
+  std::vector<size_t> payloadSizes = quick ? std::vector<size_t>{ 1024, 1024 * 1024 }
+                                           : std::vector<size_t>{ 64, 1024, 16384, 1024 * 1024 };
+  for (const std::string& algorithm : CompressionCodec::Available()) {
+    for (size_t payloadSize : payloadSizes) {
+      // zstd's worker pool only engages on large frames
+      std::vector<int> workerCounts = { 0 };
+      if (algorithm == "zstd" && payloadSize >= 1024 * 1024) {
+        workerCounts.push_back(2);
+        workerCounts.push_back(4);
+      }
+      for (int workers : workerCounts) {
+        for (bool decompress : { false, true }) {
+          if (decompress && workers > 0) {
+            continue;
+          }
+          BenchResult result;
+          std::string error;
+          if (!BenchCodec(algorithm, decompress, payloadSize, workers, durationMs, result, error)) {
+            std::fprintf(stderr, "%s: %s\n", algorithm.c_str(), error.c_str());
+            return 1;
+          }
+          results.push_back(std::move(result));
+        }
+      }
+    }
+  }
+
+  PrintResults(results);
+  return 0;
+}
@@ -1,11 +1,24 @@
 {
+  "variables": {
+    "with_zstd%": "<!(node -e \"try{require('child_process').execSync('pkg-config --exists libzstd');console.log('true')}catch(e){console.log('false')}\")",
+    "with_lz4%": "<!(node -e \"try{require('child_process').execSync('pkg-config --exists liblz4');console.log('true')}catch(e){console.log('false')}\")"
+  },
   "targets": [
     {
       "target_name": "node_streams_addon",
       "sources": [
         "src/addon.cc",
         "src/stream_operations.cc",
+        "src/encrypted_stream.cc",
+        "src/gcm_cipher.cc",
+        "src/transform_pipeline.cc",
+        "src/compression_engine.cc",
+        "src/compressed_stream.cc",
         "src/flow_control.cc",
+        "src/rate_limiter.cc",
+        "src/circuit_breaker.cc",
+        "src/frame_mux.cc",
+        "src/stream_checkpoint.cc",
         "src/performance_monitor.cc"
       ],
       "include_dirs": [
@@ -24,7 +37,53 @@
         "VCCLCompilerTool": {
           "ExceptionHandling": 1
         }
-      }
+      },
+      "conditions": [
+        ["with_zstd=='true'", {
+          "defines": [ "STREAMS_WITH_ZSTD" ],
+          "cflags_cc": [ "<!@(pkg-config --cflags libzstd)" ],
+          "xcode_settings": { "OTHER_CFLAGS": [ "<!@(pkg-config --cflags libzstd)" ] },
+          "libraries": [ "<!@(pkg-config --libs libzstd)" ]
+        }],
+        ["with_lz4=='true'", {
+          "defines": [ "STREAMS_WITH_LZ4" ],
+          "cflags_cc": [ "<!@(pkg-config --cflags liblz4)" ],
+          "xcode_settings": { "OTHER_CFLAGS": [ "<!@(pkg-config --cflags liblz4)" ] },
+          "libraries": [ "<!@(pkg-config --libs liblz4)" ]
+        }]
+      ]
+    },
+    {
+      "target_name": "node_streams_bench",
+      "type": "executable",
+      "sources": [
+        "bench/native_bench.cc",
+        "src/compression_engine.cc"
+      ],
+      "cflags!": [ "-fno-exceptions" ],
+      "cflags_cc!": [ "-fno-exceptions" ],
+      "xcode_settings": {
+        "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+        "CLANG_CXX_LIBRARY": "libc++",
+        "MACOSX_DEPLOYMENT_TARGET": "10.15"
+      },
+      "conditions": [
+        ["OS!='win'", {
+          "libraries": [ "-lz", "-lpthread" ]
+        }],
+        ["with_zstd=='true'", {
+          "defines": [ "STREAMS_WITH_ZSTD" ],
+          "cflags_cc": [ "<!@(pkg-config --cflags libzstd)" ],
+          "xcode_settings": { "OTHER_CFLAGS": [ "<!@(pkg-config --cflags libzstd)" ] },
+          "libraries": [ "<!@(pkg-config --libs libzstd)" ]
+        }],
+        ["with_lz4=='true'", {
+          "defines": [ "STREAMS_WITH_LZ4" ],
+          "cflags_cc": [ "<!@(pkg-config --cflags liblz4)" ],
+          "xcode_settings": { "OTHER_CFLAGS": [ "<!@(pkg-config --cflags liblz4)" ] },
+          "libraries": [ "<!@(pkg-config --libs liblz4)" ]
+        }]
+      ]
     }
   ]
 }
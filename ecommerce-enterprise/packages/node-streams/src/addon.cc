@@ -2,6 +2,12 @@
 #include "stream_operations.h"
 #include "flow_control.h"
 #include "performance_monitor.h"
+#include "encrypted_stream.h"
+#include "compressed_stream.h"
+#include "transform_pipeline.h"
+#include "rate_limiter.h"
+#include "circuit_breaker.h"
+#include "frame_mux.h"
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
   // Core stream operations
@@ -17,6 +23,14 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set(Napi::String::New(env, "createSplitterStream"), Napi::Function::New(env, CreateSplitterStream));
   exports.Set(Napi::String::New(env, "createMergerStream"), Napi::Function::New(env, CreateMergerStream));
   
+  // Native stream engines
+  EncryptedStream::Init(env, exports);
+  CompressedStream::Init(env, exports);
+  TransformPipeline::Init(env, exports);
+  RateLimiter::Init(env, exports);
+  CircuitBreaker::Init(env, exports);
+  FrameMux::Init(env, exports);
+  
   // Performance operations
   exports.Set(Napi::String::New(env, "optimizeStream"), Napi::Function::New(env, OptimizeStream));
   exports.Set(Napi::String::New(env, "monitorStream"), Napi::Function::New(env, MonitorStream));
@@ -37,11 +51,14 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set(Napi::String::New(env, "stopMonitoring"), Napi::Function::New(env, StopMonitoring));
   exports.Set(Napi::String::New(env, "getMetrics"), Napi::Function::New(env, GetMetrics));
   exports.Set(Napi::String::New(env, "getHealthCheck"), Napi::Function::New(env, GetHealthCheck));
+  exports.Set(Napi::String::New(env, "exportMetrics"), Napi::Function::New(env, ExportMetrics));
   
   // Utility operations
   exports.Set(Napi::String::New(env, "validateStream"), Napi::Function::New(env, ValidateStream));
   exports.Set(Napi::String::New(env, "serializeStream"), Napi::Function::New(env, SerializeStream));
   exports.Set(Napi::String::New(env, "deserializeStream"), Napi::Function::New(env, DeserializeStream));
+  exports.Set(Napi::String::New(env, "inspectCheckpoint"), Napi::Function::New(env, InspectStreamCheckpoint));
+  exports.Set(Napi::String::New(env, "openCheckpoint"), Napi::Function::New(env, OpenCheckpoint));
   
   return exports;
 }
@@ -0,0 +1,144 @@
+#ifndef CHUNK_RING_H
+#define CHUNK_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded single-producer / single-consumer ring of owned items. Each side
+// keeps a cached copy of the other's index, so a push or pop only touches
+// shared cache lines when the cached view says the ring is full or empty.
+// The two sides may be different threads over time as long as hand-offs
+// between them are ordered (e.g. through a scheduler's mutex).
+template <typename T>
+class SpscRing {
+public:
+  // Capacity is rounded up to a power of two
+  explicit SpscRing(size_t capacity)
+    : head_(0), tailCache_(0), tail_(0), headCache_(0) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    mask_ = size - 1;
+    slots_.reset(new std::unique_ptr<T>[size]);
+  }
+
+  size_t Capacity() const { return mask_ + 1; }
+
+  // Producer side. Leaves item alone and returns false when the ring is full.
+  bool TryPush(std::unique_ptr<T>& item) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - headCache_ > mask_) {
+      headCache_ = head_.load(std::memory_order_acquire);
+      if (tail - headCache_ > mask_) {
+        return false;
+      }
+    }
+    slots_[tail & mask_] = std::move(item);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  bool TryPop(std::unique_ptr<T>& item) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tailCache_) {
+      tailCache_ = tail_.load(std::memory_order_acquire);
+      if (head == tailCache_) {
+        return false;
+      }
+    }
+    item = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Items queued; exact on either side for its own operations
+  size_t Size() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+private:
+  std::unique_ptr<std::unique_ptr<T>[]> slots_;
+  size_t mask_;
+
+  alignas(64) std::atomic<size_t> head_;  // written by the consumer
+  size_t tailCache_;
+  alignas(64) std::atomic<size_t> tail_;  // written by the producer
+  size_t headCache_;
+};
+
+// Queued-byte accounting with hysteresis for one producer. The producer is
+// paused once high bytes are queued and only resumed when the queue has
+// fallen to low, so it is not woken for every chunk that completes. Time
+// spent paused is accumulated for metrics. Not thread-safe; every call
+// comes from the thread that owns the producer.
+class BackpressureGauge {
+public:
+  BackpressureGauge(size_t high, size_t low)
+    : high_(high), low_(low), bytes_(0), paused_(false), pausedAtNs_(0), blockedNs_(0), pauses_(0) {}
+
+  void Configure(size_t high, size_t low) {
+    high_ = high;
+    low_ = low;
+  }
+
+  // false once the producer should stop writing
+  bool Add(size_t bytes, uint64_t nowNs) {
+    bytes_ += bytes;
+    if (bytes_ >= high_) {
+      Pause(nowNs);
+    }
+    return !paused_;
+  }
+
+  void Release(size_t bytes) { bytes_ -= bytes; }
+
+  // Also for limits other than bytes, e.g. a full ring
+  void Pause(uint64_t nowNs) {
+    if (!paused_) {
+      paused_ = true;
+      pausedAtNs_ = nowNs;
+      pauses_++;
+    }
+  }
+
+  // Resume if paused and drained to the low watermark; returns how long
+  // the producer was paused, or 0 if it stays as it is
+  uint64_t TryResume(uint64_t nowNs) {
+    if (!paused_ || bytes_ > low_) {
+      return 0;
+    }
+    paused_ = false;
+    uint64_t blocked = std::max<uint64_t>(1, nowNs - pausedAtNs_);
+    blockedNs_ += blocked;
+    return blocked;
+  }
+
+  bool Paused() const { return paused_; }
+  size_t Bytes() const { return bytes_; }
+  size_t High() const { return high_; }
+  size_t Low() const { return low_; }
+  uint64_t Pauses() const { return pauses_; }
+
+  // Including the pause in progress
+  uint64_t BlockedNs(uint64_t nowNs) const {
+    return blockedNs_ + (paused_ ? nowNs - pausedAtNs_ : 0);
+  }
+
+private:
+  size_t high_;
+  size_t low_;
+  size_t bytes_;
+  bool paused_;
+  uint64_t pausedAtNs_;
+  uint64_t blockedNs_;
+  uint64_t pauses_;
+};
+
+#endif // CHUNK_RING_H
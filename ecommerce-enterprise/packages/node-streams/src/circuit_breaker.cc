@@ -0,0 +1,373 @@
+#include "circuit_breaker.h"
+#include "flow_control.h"
+#include "performance_monitor.h"
+#include <algorithm>
+
+namespace {
+
+// Bucket word: epoch (24 bits) | failures (20) | successes (20)
+const uint64_t kCountMask = (1ull << 20) - 1;
+const uint64_t kEpochMask = (1ull << 24) - 1;
+
+inline uint64_t EpochOf(uint64_t word) { return word >> 40; }
+inline uint32_t FailuresOf(uint64_t word) { return static_cast<uint32_t>((word >> 20) & kCountMask); }
+inline uint32_t SuccessesOf(uint64_t word) { return static_cast<uint32_t>(word & kCountMask); }
+
+inline uint32_t Millis(uint64_t nowNs) {
+  return static_cast<uint32_t>(nowNs / 1000000);
+}
+
+const char* PhaseName(CircuitPhase phase) {
+  switch (phase) {
+    case CircuitPhase::kOpen:
+      return "open";
+    case CircuitPhase::kHalfOpen:
+      return "half-open";
+    default:
+      return "closed";
+  }
+}
+
+const double kDefaultMonitoringPeriodMs = 10000;
+
+} // namespace
+
+Circuit::Circuit(uint32_t failureThreshold, uint64_t recoveryTimeoutNs, uint64_t monitoringPeriodNs,
+                 uint32_t halfOpenMaxCalls, uint32_t successThreshold)
+  : failureThreshold_(failureThreshold),
+    recoveryTimeoutMs_(static_cast<uint32_t>(recoveryTimeoutNs / 1000000)),
+    bucketNs_(std::max<uint64_t>(1000000, monitoringPeriodNs / kBuckets)),
+    halfOpenMaxCalls_(std::min(halfOpenMaxCalls, kMaxProbes)),
+    successThreshold_(std::min(successThreshold, kMaxProbes)),
+    hasListener_(false) {
+  state_.store(Pack(CircuitPhase::kClosed, 0, 0, OperationSpan::NowNs()), std::memory_order_relaxed);
+  ClearWindow();
+}
+
+uint64_t Circuit::Pack(CircuitPhase phase, uint32_t probes, uint32_t successes, uint64_t nowNs) {
+  return static_cast<uint64_t>(phase) | (static_cast<uint64_t>(probes) << 2) |
+         (static_cast<uint64_t>(successes) << 17) | (static_cast<uint64_t>(Millis(nowNs)) << 32);
+}
+
+bool Circuit::AllowSlow(uint64_t word, uint64_t nowNs) {
+  while (true) {
+    switch (PhaseOf(word)) {
+      case CircuitPhase::kClosed:
+        return true;
+      
+      case CircuitPhase::kOpen:
+        // Wrapping subtraction: correct for opens younger than 49 days
+        if (Millis(nowNs) - SinceOf(word) < recoveryTimeoutMs_) {
+          rejected.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        // The caller that moves the circuit to half-open is its first probe
+        if (Transition(word, Pack(CircuitPhase::kHalfOpen, 1, 0, nowNs), nowNs)) {
+          return true;
+        }
+        break;
+      
+      case CircuitPhase::kHalfOpen:
+        if (ProbesOf(word) >= halfOpenMaxCalls_) {
+          rejected.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        if (state_.compare_exchange_weak(word, word + (1ull << 2), std::memory_order_acq_rel)) {
+          return true;
+        }
+        break;
+    }
+  }
+}
+
+void Circuit::Record(bool success, uint64_t nowNs) {
+  uint64_t index = nowNs / bucketNs_;
+  uint64_t epoch = index & kEpochMask;
+  std::atomic<uint64_t>& bucket = buckets_[index % kBuckets];
+  
+  // A bucket left over from an earlier lap of the ring starts again from zero
+  uint64_t current = bucket.load(std::memory_order_relaxed);
+  while (true) {
+    uint64_t next = EpochOf(current) == epoch ? current : epoch << 40;
+    if (success ? SuccessesOf(next) < kCountMask : FailuresOf(next) < kCountMask) {
+      next += success ? 1 : (1ull << 20);
+    }
+    if (bucket.compare_exchange_weak(current, next, std::memory_order_relaxed)) {
+      break;
+    }
+  }
+  
+  uint64_t word = state_.load(std::memory_order_acquire);
+  while (true) {
+    switch (PhaseOf(word)) {
+      case CircuitPhase::kClosed: {
+        if (success) {
+          return;
+        }
+        // Only failures can trip the circuit, so only they sum the window
+        uint32_t failures;
+        uint32_t successes;
+        WindowCounts(nowNs, failures, successes);
+        if (failures < failureThreshold_ ||
+            Transition(word, Pack(CircuitPhase::kOpen, 0, 0, nowNs), nowNs)) {
+          return;
+        }
+        break;
+      }
+      
+      case CircuitPhase::kOpen:
+        // Calls admitted before the trip finishing late
+        return;
+      
+      case CircuitPhase::kHalfOpen: {
+        if (!success) {
+          if (Transition(word, Pack(CircuitPhase::kOpen, 0, 0, nowNs), nowNs)) {
+            return;
+          }
+          break;
+        }
+        uint32_t successes = ProbeSuccessesOf(word) + 1;
+        if (successes < successThreshold_) {
+          if (state_.compare_exchange_weak(word, word + (1ull << 17), std::memory_order_acq_rel)) {
+            return;
+          }
+          break;
+        }
+        // Failures from before the trip must not count against the new
+        // closed period
+        ClearWindow();
+        if (Transition(word, Pack(CircuitPhase::kClosed, 0, 0, nowNs), nowNs)) {
+          return;
+        }
+        break;
+      }
+    }
+  }
+}
+
+void Circuit::Reset(uint64_t nowNs) {
+  ClearWindow();
+  uint64_t word = state_.load(std::memory_order_acquire);
+  while (PhaseOf(word) != CircuitPhase::kClosed &&
+         !Transition(word, Pack(CircuitPhase::kClosed, 0, 0, nowNs), nowNs)) {}
+}
+
+uint64_t Circuit::RetryAfterNs(uint64_t nowNs) const {
+  uint64_t word = state_.load(std::memory_order_relaxed);
+  if (PhaseOf(word) != CircuitPhase::kOpen) {
+    return 0;
+  }
+  uint32_t elapsed = Millis(nowNs) - SinceOf(word);
+  return elapsed < recoveryTimeoutMs_ ? static_cast<uint64_t>(recoveryTimeoutMs_ - elapsed) * 1000000 : 0;
+}
+
+void Circuit::WindowCounts(uint64_t nowNs, uint32_t& failures, uint32_t& successes) const {
+  uint64_t epoch = (nowNs / bucketNs_) & kEpochMask;
+  failures = 0;
+  successes = 0;
+  for (const std::atomic<uint64_t>& bucket : buckets_) {
+    uint64_t word = bucket.load(std::memory_order_relaxed);
+    if (((epoch - EpochOf(word)) & kEpochMask) < kBuckets) {
+      failures += FailuresOf(word);
+      successes += SuccessesOf(word);
+    }
+  }
+}
+
+void Circuit::ClearWindow() {
+  // An epoch one lap behind the current one is never inside the window
+  uint64_t stale = ((OperationSpan::NowNs() / bucketNs_ - kBuckets) & kEpochMask) << 40;
+  for (std::atomic<uint64_t>& bucket : buckets_) {
+    bucket.store(stale, std::memory_order_relaxed);
+  }
+}
+
+bool Circuit::Transition(uint64_t& word, uint64_t next, uint64_t nowNs) {
+  CircuitPhase from = PhaseOf(word);
+  if (!state_.compare_exchange_strong(word, next, std::memory_order_acq_rel)) {
+    return false;
+  }
+  
+  CircuitPhase to = PhaseOf(next);
+  if (to == CircuitPhase::kOpen) {
+    trips.fetch_add(1, std::memory_order_relaxed);
+  }
+  
+  std::lock_guard<std::mutex> lock(listenerMutex_);
+  if (hasListener_) {
+    CircuitTransition* transition = new CircuitTransition();
+    transition->from = from;
+    transition->to = to;
+    WindowCounts(nowNs, transition->failures, transition->successes);
+    transition->timestamp = GetCurrentTimestampMs();
+    
+    napi_status status = listener_.NonBlockingCall(transition,
+      [](Napi::Env env, Napi::Function callback, CircuitTransition* transition) {
+        if (env != nullptr && callback != nullptr) {
+          Napi::Object event = Napi::Object::New(env);
+          event.Set("state", Napi::String::New(env, PhaseName(transition->to)));
+          event.Set("previous", Napi::String::New(env, PhaseName(transition->from)));
+          event.Set("failures", Napi::Number::New(env, transition->failures));
+          event.Set("successes", Napi::Number::New(env, transition->successes));
+          event.Set("timestamp", Napi::Number::New(env, static_cast<double>(transition->timestamp)));
+          callback.Call({ event });
+        }
+        delete transition;
+      });
+    if (status != napi_ok) {
+      delete transition;
+    }
+  }
+  return true;
+}
+
+void Circuit::SetListener(Napi::ThreadSafeFunction listener) {
+  std::lock_guard<std::mutex> lock(listenerMutex_);
+  listener_ = listener;
+  hasListener_ = true;
+}
+
+void Circuit::ReleaseListener() {
+  std::lock_guard<std::mutex> lock(listenerMutex_);
+  if (hasListener_) {
+    hasListener_ = false;
+    listener_.Release();
+  }
+}
+
+Napi::FunctionReference CircuitBreaker::constructor;
+
+void CircuitBreaker::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "CircuitBreaker", {
+    InstanceMethod("allow", &CircuitBreaker::Allow),
+    InstanceMethod("success", &CircuitBreaker::Success),
+    InstanceMethod("failure", &CircuitBreaker::Failure),
+    InstanceMethod("reset", &CircuitBreaker::Reset),
+    InstanceAccessor("state", &CircuitBreaker::GetState, nullptr),
+    InstanceAccessor("retryAfter", &CircuitBreaker::GetRetryAfter, nullptr),
+    InstanceAccessor("stats", &CircuitBreaker::GetStats, nullptr),
+  });
+  
+  constructor = Napi::Persistent(func);
+  constructor.SuppressDestruct();
+  
+  exports.Set(Napi::String::New(env, "CircuitBreaker"), func);
+}
+
+Napi::Object CircuitBreaker::NewInstance(Napi::Env env, Napi::Object config) {
+  return constructor.New({ config });
+}
+
+CircuitBreaker::CircuitBreaker(const Napi::CallbackInfo& info)
+  : Napi::ObjectWrap<CircuitBreaker>(info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "Expected circuit breaker config").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  Napi::Object config = info[0].As<Napi::Object>();
+  if (!config.Get("failureThreshold").IsNumber() || !config.Get("recoveryTimeout").IsNumber()) {
+    Napi::TypeError::New(env, "failureThreshold and recoveryTimeout are required").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  double failureThreshold = config.Get("failureThreshold").As<Napi::Number>().DoubleValue();
+  double recoveryTimeout = config.Get("recoveryTimeout").As<Napi::Number>().DoubleValue();
+  double monitoringPeriod = config.Get("monitoringPeriod").IsNumber()
+    ? config.Get("monitoringPeriod").As<Napi::Number>().DoubleValue() : kDefaultMonitoringPeriodMs;
+  double halfOpenMaxCalls = config.Get("halfOpenMaxCalls").IsNumber()
+    ? config.Get("halfOpenMaxCalls").As<Napi::Number>().DoubleValue() : 1;
+  // By default every probe has to succeed before the circuit closes
+  double successThreshold = config.Get("successThreshold").IsNumber()
+    ? config.Get("successThreshold").As<Napi::Number>().DoubleValue() : halfOpenMaxCalls;
+  
+  if (!(failureThreshold >= 1 && failureThreshold <= kCountMask)) {
+    Napi::RangeError::New(env, "failureThreshold must be between 1 and " + std::to_string(kCountMask))
+      .ThrowAsJavaScriptException();
+    return;
+  }
+  // Both periods are kept in 32-bit milliseconds
+  if (!(recoveryTimeout >= 0 && recoveryTimeout < 2147483648.0) ||
+      !(monitoringPeriod >= 1 && monitoringPeriod < 2147483648.0)) {
+    Napi::RangeError::New(env, "recoveryTimeout and monitoringPeriod must be between 0 and 2^31 ms")
+      .ThrowAsJavaScriptException();
+    return;
+  }
+  if (!(halfOpenMaxCalls >= 1 && halfOpenMaxCalls <= Circuit::kMaxProbes) ||
+      !(successThreshold >= 1 && successThreshold <= halfOpenMaxCalls)) {
+    Napi::RangeError::New(env, "halfOpenMaxCalls must be between 1 and " + std::to_string(Circuit::kMaxProbes) +
+                          ", and successThreshold between 1 and halfOpenMaxCalls").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  circuit_ = std::make_shared<Circuit>(static_cast<uint32_t>(failureThreshold),
+                                       static_cast<uint64_t>(recoveryTimeout * 1e6),
+                                       static_cast<uint64_t>(monitoringPeriod * 1e6),
+                                       static_cast<uint32_t>(halfOpenMaxCalls),
+                                       static_cast<uint32_t>(successThreshold));
+  
+  // Transitions can happen on any thread, so the listener always runs
+  // through the event loop; it never keeps the process alive on its own
+  if (config.Get("onStateChange").IsFunction()) {
+    Napi::ThreadSafeFunction listener = Napi::ThreadSafeFunction::New(
+      env, config.Get("onStateChange").As<Napi::Function>(), "CircuitBreaker", 0, 1);
+    listener.Unref(env);
+    circuit_->SetListener(listener);
+  }
+  
+  Napi::Object self = Value();
+  self.Set("failureThreshold", Napi::Number::New(env, failureThreshold));
+  self.Set("recoveryTimeout", Napi::Number::New(env, recoveryTimeout));
+  self.Set("monitoringPeriod", Napi::Number::New(env, monitoringPeriod));
+  self.Set("halfOpenMaxCalls", Napi::Number::New(env, halfOpenMaxCalls));
+}
+
+CircuitBreaker::~CircuitBreaker() {
+  if (circuit_) {
+    circuit_->ReleaseListener();
+  }
+}
+
+Napi::Value CircuitBreaker::Allow(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), circuit_->Allow(OperationSpan::NowNs()));
+}
+
+Napi::Value CircuitBreaker::Success(const Napi::CallbackInfo& info) {
+  circuit_->Record(true, OperationSpan::NowNs());
+  return info.Env().Undefined();
+}
+
+Napi::Value CircuitBreaker::Failure(const Napi::CallbackInfo& info) {
+  circuit_->Record(false, OperationSpan::NowNs());
+  return info.Env().Undefined();
+}
+
+Napi::Value CircuitBreaker::Reset(const Napi::CallbackInfo& info) {
+  circuit_->Reset(OperationSpan::NowNs());
+  return info.Env().Undefined();
+}
+
+Napi::Value CircuitBreaker::GetState(const Napi::CallbackInfo& info) {
+  return Napi::String::New(info.Env(), PhaseName(circuit_->Phase()));
+}
+
+Napi::Value CircuitBreaker::GetRetryAfter(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(circuit_->RetryAfterNs(OperationSpan::NowNs()) / 1000000));
+}
+
+Napi::Value CircuitBreaker::GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  uint32_t failures;
+  uint32_t successes;
+  circuit_->WindowCounts(OperationSpan::NowNs(), failures, successes);
+  
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("state", Napi::String::New(env, PhaseName(circuit_->Phase())));
+  stats.Set("failures", Napi::Number::New(env, failures));
+  stats.Set("successes", Napi::Number::New(env, successes));
+  stats.Set("rejected", Napi::Number::New(env, static_cast<double>(circuit_->rejected.load(std::memory_order_relaxed))));
+  stats.Set("trips", Napi::Number::New(env, static_cast<double>(circuit_->trips.load(std::memory_order_relaxed))));
+  return stats;
+}
@@ -0,0 +1,133 @@
+#ifndef CIRCUIT_BREAKER_H
+#define CIRCUIT_BREAKER_H
+
+#include <napi.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+enum class CircuitPhase : uint32_t {
+  kClosed = 0,
+  kOpen = 1,
+  kHalfOpen = 2,
+};
+
+// Delivered to the state listener after every transition
+struct CircuitTransition {
+  CircuitPhase from;
+  CircuitPhase to;
+  uint32_t failures;    // in the rolling window when it happened
+  uint32_t successes;
+  long long timestamp;  // wall clock, ms
+};
+
+// Closed / open / half-open breaker for one target. The state lives in a
+// single word, so allow() on a closed circuit is one relaxed load and every
+// transition is one CAS, made by exactly one caller. Outcomes go into a
+// ring of time buckets covering monitoringPeriod; each bucket is also one
+// word (epoch and both counts), so recording never locks. Safe to use from
+// any thread.
+class Circuit {
+public:
+  static const uint32_t kBuckets = 10;
+  static const uint32_t kMaxProbes = 0x7FFF;
+
+  Circuit(uint32_t failureThreshold, uint64_t recoveryTimeoutNs, uint64_t monitoringPeriodNs,
+          uint32_t halfOpenMaxCalls, uint32_t successThreshold);
+
+  // May a call go ahead? Open circuits admit nothing until recoveryTimeout
+  // has passed, then up to halfOpenMaxCalls probes.
+  bool Allow(uint64_t nowNs) {
+    uint64_t word = state_.load(std::memory_order_relaxed);
+    if (PhaseOf(word) == CircuitPhase::kClosed) {
+      return true;
+    }
+    return AllowSlow(word, nowNs);
+  }
+
+  void Record(bool success, uint64_t nowNs);
+
+  // Back to closed with an empty window
+  void Reset(uint64_t nowNs);
+
+  CircuitPhase Phase() const { return PhaseOf(state_.load(std::memory_order_relaxed)); }
+
+  // ns until an open circuit admits a probe; 0 otherwise
+  uint64_t RetryAfterNs(uint64_t nowNs) const;
+
+  // Totals in the rolling window
+  void WindowCounts(uint64_t nowNs, uint32_t& failures, uint32_t& successes) const;
+
+  // Called on the JS thread after each transition; Release() before the
+  // function's environment goes away
+  void SetListener(Napi::ThreadSafeFunction listener);
+  void ReleaseListener();
+
+  std::atomic<uint64_t> rejected{0};
+  std::atomic<uint64_t> trips{0};
+
+private:
+  // State word: phase (2 bits) | probes admitted (15) | probe successes (15) |
+  // ms since the last transition, on a wrapping 32-bit clock
+  static CircuitPhase PhaseOf(uint64_t word) { return static_cast<CircuitPhase>(word & 3); }
+  static uint32_t ProbesOf(uint64_t word) { return static_cast<uint32_t>(word >> 2) & kMaxProbes; }
+  static uint32_t ProbeSuccessesOf(uint64_t word) { return static_cast<uint32_t>(word >> 17) & kMaxProbes; }
+  static uint32_t SinceOf(uint64_t word) { return static_cast<uint32_t>(word >> 32); }
+  static uint64_t Pack(CircuitPhase phase, uint32_t probes, uint32_t successes, uint64_t nowNs);
+
+  bool AllowSlow(uint64_t word, uint64_t nowNs);
+  bool Transition(uint64_t& word, uint64_t next, uint64_t nowNs);
+  void ClearWindow();
+
+  std::atomic<uint64_t> state_;
+  std::atomic<uint64_t> buckets_[kBuckets];
+
+  uint32_t failureThreshold_;
+  uint32_t recoveryTimeoutMs_;
+  uint64_t bucketNs_;
+  uint32_t halfOpenMaxCalls_;
+  uint32_t successThreshold_;
+
+  std::mutex listenerMutex_;
+  Napi::ThreadSafeFunction listener_;
+  bool hasListener_;
+};
+
+// Native breaker behind enableCircuitBreaker.
+//
+//   new CircuitBreaker({ failureThreshold, recoveryTimeout, monitoringPeriod?,
+//                        halfOpenMaxCalls?, successThreshold?, onStateChange? })
+//   allow()          -> boolean   call before each outbound request
+//   success()                     report an outcome
+//   failure()
+//   reset()                       force closed and forget the window
+//   state            'closed' | 'open' | 'half-open'
+//   retryAfter       ms until an open circuit admits a probe
+//   stats            { state, failures, successes, rejected, trips }
+//
+// onStateChange({ state, previous, failures, successes, timestamp }) runs
+// asynchronously after each transition.
+class CircuitBreaker : public Napi::ObjectWrap<CircuitBreaker> {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(Napi::Env env, Napi::Object config);
+
+  CircuitBreaker(const Napi::CallbackInfo& info);
+  ~CircuitBreaker();
+
+private:
+  static Napi::FunctionReference constructor;
+
+  Napi::Value Allow(const Napi::CallbackInfo& info);
+  Napi::Value Success(const Napi::CallbackInfo& info);
+  Napi::Value Failure(const Napi::CallbackInfo& info);
+  Napi::Value Reset(const Napi::CallbackInfo& info);
+  Napi::Value GetState(const Napi::CallbackInfo& info);
+  Napi::Value GetRetryAfter(const Napi::CallbackInfo& info);
+  Napi::Value GetStats(const Napi::CallbackInfo& info);
+
+  std::shared_ptr<Circuit> circuit_;
+};
+
+#endif // CIRCUIT_BREAKER_H
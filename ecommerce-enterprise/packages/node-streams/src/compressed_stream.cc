@@ -0,0 +1,328 @@
+#include "compressed_stream.h"
+#include "performance_monitor.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const size_t kDefaultParallelThreshold = 1024 * 1024;
+const size_t kDefaultDictionarySize = 112640; // what the zstd CLI trains by default
+
+// Output is handed over zero-copy only when the unused space behind it is
+// at most this and no larger than the output itself; codecs reserve 16 KiB
+// at a time, so small results are copied rather than pinning the block
+const size_t kMaxSlack = 4 * 1024;
+
+double ReadNumber(Napi::Object config, const char* name, double fallback) {
+  Napi::Value value = config.Get(name);
+  return value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : fallback;
+}
+
+// Trains a dictionary off the JS thread; samples are copied first
+class TrainDictionaryWorker : public Napi::AsyncWorker {
+public:
+  TrainDictionaryWorker(Napi::Env env, std::vector<std::string> samples, size_t maxSize)
+    : Napi::AsyncWorker(env), deferred_(Napi::Promise::Deferred::New(env)),
+      samples_(std::move(samples)), maxSize_(maxSize) {}
+  
+  Napi::Promise GetPromise() { return deferred_.Promise(); }
+
+protected:
+  void Execute() override {
+    std::string error;
+    if (!CompressionCodec::TrainDictionary(samples_, maxSize_, dictionary_, error)) {
+      SetError(error);
+    }
+  }
+  
+  void OnOK() override {
+    Napi::Env env = Env();
+    deferred_.Resolve(Napi::Buffer<uint8_t>::Copy(env, dictionary_.data(), dictionary_.size()));
+  }
+  
+  void OnError(const Napi::Error& error) override {
+    deferred_.Reject(error.Value());
+  }
+
+private:
+  Napi::Promise::Deferred deferred_;
+  std::vector<std::string> samples_;
+  size_t maxSize_;
+  std::vector<uint8_t> dictionary_;
+};
+
+// trainCompressionDictionary(samples: Buffer[], maxSize?) -> Promise<Buffer>
+Napi::Value TrainCompressionDictionary(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected an array of sample buffers").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  Napi::Array list = info[0].As<Napi::Array>();
+  std::vector<std::string> samples;
+  samples.reserve(list.Length());
+  for (uint32_t i = 0; i < list.Length(); i++) {
+    Napi::Value sample = list.Get(i);
+    if (!sample.IsBuffer()) {
+      Napi::TypeError::New(env, "Dictionary samples must be Buffers").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    Napi::Buffer<char> buffer = sample.As<Napi::Buffer<char>>();
+    samples.emplace_back(buffer.Data(), buffer.Length());
+  }
+  
+  double maxSize = info.Length() > 1 && info[1].IsNumber()
+    ? info[1].As<Napi::Number>().DoubleValue() : static_cast<double>(kDefaultDictionarySize);
+  if (maxSize < 256 || maxSize > 16 * 1024 * 1024) {
+    Napi::RangeError::New(env, "Dictionary size must be between 256 bytes and 16 MiB").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  TrainDictionaryWorker* worker = new TrainDictionaryWorker(env, std::move(samples), static_cast<size_t>(maxSize));
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+  return promise;
+}
+
+// Backends compiled into this build
+Napi::Value GetCompressionBackends(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::vector<std::string> algorithms = CompressionCodec::Available();
+  Napi::Array result = Napi::Array::New(env, algorithms.size());
+  for (size_t i = 0; i < algorithms.size(); i++) {
+    result.Set(static_cast<uint32_t>(i), Napi::String::New(env, algorithms[i]));
+  }
+  return result;
+}
+
+} // namespace
+
+// Growable output that becomes a Buffer without another copy
+class BufferSink : public CompressionSink {
+public:
+  explicit BufferSink(size_t hint) : storage_(new uint8_t[std::max<size_t>(hint, 64)]),
+                                     capacity_(std::max<size_t>(hint, 64)), length_(0) {}
+  
+  uint8_t* Reserve(size_t minimum, size_t& available) override {
+    if (capacity_ - length_ < minimum) {
+      size_t capacity = std::max(length_ + minimum, capacity_ * 2);
+      std::unique_ptr<uint8_t[]> grown(new uint8_t[capacity]);
+      std::memcpy(grown.get(), storage_.get(), length_);
+      storage_ = std::move(grown);
+      capacity_ = capacity;
+    }
+    available = capacity_ - length_;
+    return storage_.get() + length_;
+  }
+  
+  void Commit(size_t written) override {
+    length_ += written;
+  }
+  
+  size_t Length() const { return length_; }
+  
+  Napi::Buffer<uint8_t> ToBuffer(Napi::Env env) {
+    size_t slack = capacity_ - length_;
+    if (slack > kMaxSlack || slack > length_) {
+      return Napi::Buffer<uint8_t>::Copy(env, storage_.get(), length_);
+    }
+    size_t length = length_;
+    length_ = 0;
+    return Napi::Buffer<uint8_t>::New(env, storage_.release(), length,
+                                      [](Napi::Env, uint8_t* data) { delete[] data; });
+  }
+
+private:
+  std::unique_ptr<uint8_t[]> storage_;
+  size_t capacity_;
+  size_t length_;
+};
+
+Napi::FunctionReference CompressedStream::constructor;
+
+void CompressedStream::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "CompressedStream", {
+    InstanceMethod("update", &CompressedStream::Update),
+    InstanceMethod("flush", &CompressedStream::Flush),
+    InstanceMethod("final", &CompressedStream::Final),
+    InstanceMethod("process", &CompressedStream::Process),
+    InstanceMethod("reset", &CompressedStream::Reset),
+    InstanceAccessor("stats", &CompressedStream::GetStats, nullptr),
+  });
+  
+  constructor = Napi::Persistent(func);
+  constructor.SuppressDestruct();
+  
+  exports.Set(Napi::String::New(env, "CompressedStream"), func);
+  exports.Set(Napi::String::New(env, "trainCompressionDictionary"), Napi::Function::New(env, TrainCompressionDictionary));
+  exports.Set(Napi::String::New(env, "getCompressionBackends"), Napi::Function::New(env, GetCompressionBackends));
+}
+
+Napi::Object CompressedStream::NewInstance(Napi::Env env, Napi::Object config) {
+  return constructor.New({ config });
+}
+
+CompressedStream::CompressedStream(const Napi::CallbackInfo& info)
+  : Napi::ObjectWrap<CompressedStream>(info),
+    metric_(0),
+    decompress_(false),
+    parallelThreshold_(kDefaultParallelThreshold),
+    bytesIn_(0),
+    bytesOut_(0),
+    busyNs_(0) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "Expected compression config").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  Napi::Object config = info[0].As<Napi::Object>();
+  if (!config.Get("compressionAlgorithm").IsString()) {
+    Napi::TypeError::New(env, "compressionAlgorithm is required").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  CompressionOptions options;
+  options.algorithm = config.Get("compressionAlgorithm").As<Napi::String>().Utf8Value();
+  options.decompress = config.Get("mode").IsString() &&
+                       config.Get("mode").As<Napi::String>().Utf8Value() == "decompress";
+  if (config.Get("compressionLevel").IsNumber()) {
+    options.level = config.Get("compressionLevel").As<Napi::Number>().Int32Value();
+  }
+  options.windowLog = static_cast<int>(ReadNumber(config, "windowLog", 0));
+  options.workers = std::max(0, std::min(64, static_cast<int>(ReadNumber(config, "workers", 0))));
+  parallelThreshold_ = static_cast<size_t>(std::max(0.0, ReadNumber(config, "parallelThreshold",
+                                                                    static_cast<double>(kDefaultParallelThreshold))));
+  
+  Napi::Value dictionary = config.Get("dictionary");
+  if (dictionary.IsBuffer()) {
+    Napi::Buffer<uint8_t> buffer = dictionary.As<Napi::Buffer<uint8_t>>();
+    options.dictionary.assign(buffer.Data(), buffer.Data() + buffer.Length());
+  } else if (!dictionary.IsUndefined() && !dictionary.IsNull()) {
+    Napi::TypeError::New(env, "dictionary must be a Buffer").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  std::string error;
+  codec_ = CompressionCodec::Create(options, error);
+  if (!codec_) {
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return;
+  }
+  
+  decompress_ = options.decompress;
+  metric_ = PerformanceMonitor::GetInstance().RegisterOperation(
+    "CompressedStream." + options.algorithm + (decompress_ ? ".decompress" : ".compress"));
+  
+  Napi::Object self = Value();
+  self.Set("algorithm", Napi::String::New(env, options.algorithm));
+  self.Set("mode", Napi::String::New(env, decompress_ ? "decompress" : "compress"));
+}
+
+Napi::Value CompressedStream::Complete(Napi::Env env, uint64_t startNs, size_t bytesIn, bool ok,
+                                       const std::string& error, BufferSink& sink) {
+  uint64_t now = OperationSpan::NowNs();
+  uint64_t elapsed = now > startNs ? now - startNs : 0;
+  PerformanceMonitor& monitor = PerformanceMonitor::GetInstance();
+  monitor.RecordOperation(metric_, elapsed, ok);
+  monitor.RecordBytes(metric_, bytesIn, sink.Length());
+  
+  busyNs_ += elapsed;
+  bytesIn_ += bytesIn;
+  bytesOut_ += sink.Length();
+  
+  if (!ok) {
+    codec_->Reset();
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return sink.ToBuffer(env);
+}
+
+// update(chunk) feeds the current frame
+Napi::Value CompressedStream::Update(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsBuffer()) {
+    Napi::TypeError::New(env, "Expected chunk buffer").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  uint64_t startNs = OperationSpan::NowNs();
+  Napi::Buffer<uint8_t> chunk = info[0].As<Napi::Buffer<uint8_t>>();
+  BufferSink sink(codec_->OutputHint(chunk.Length()));
+  std::string error;
+  bool ok = codec_->Update(chunk.Data(), chunk.Length(), false, sink, error);
+  return Complete(env, startNs, chunk.Length(), ok, error, sink);
+}
+
+// flush() ends the current block so the peer can decode everything so far
+Napi::Value CompressedStream::Flush(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  uint64_t startNs = OperationSpan::NowNs();
+  BufferSink sink(1024);
+  std::string error;
+  bool ok = codec_->Update(nullptr, 0, true, sink, error);
+  return Complete(env, startNs, 0, ok, error, sink);
+}
+
+// final() closes the frame; when decompressing, fails on a truncated one
+Napi::Value CompressedStream::Final(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  uint64_t startNs = OperationSpan::NowNs();
+  BufferSink sink(1024);
+  std::string error;
+  bool ok = codec_->Finish(sink, error);
+  if (ok) {
+    codec_->Reset();
+  }
+  return Complete(env, startNs, 0, ok, error, sink);
+}
+
+// process(payload) compresses or decompresses one whole frame on the same
+// context; a frame in progress is abandoned
+Napi::Value CompressedStream::Process(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsBuffer()) {
+    Napi::TypeError::New(env, "Expected payload buffer").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  uint64_t startNs = OperationSpan::NowNs();
+  Napi::Buffer<uint8_t> payload = info[0].As<Napi::Buffer<uint8_t>>();
+  BufferSink sink(codec_->OutputHint(payload.Length()));
+  std::string error;
+  
+  codec_->SetParallel(payload.Length() >= parallelThreshold_);
+  bool ok = codec_->Process(payload.Data(), payload.Length(), sink, error);
+  // Streamed frames are assumed large
+  codec_->SetParallel(true);
+  codec_->Reset();
+  
+  return Complete(env, startNs, payload.Length(), ok, error, sink);
+}
+
+Napi::Value CompressedStream::Reset(const Napi::CallbackInfo& info) {
+  codec_->Reset();
+  return info.Env().Undefined();
+}
+
+Napi::Value CompressedStream::GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  double compressed = decompress_ ? bytesIn_ : bytesOut_;
+  double uncompressed = decompress_ ? bytesOut_ : bytesIn_;
+  
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("bytesIn", Napi::Number::New(env, bytesIn_));
+  stats.Set("bytesOut", Napi::Number::New(env, bytesOut_));
+  // Uncompressed over compressed, whichever direction this stream runs
+  stats.Set("ratio", Napi::Number::New(env, compressed > 0 ? uncompressed / compressed : 0));
+  // Input MB per second of time spent in the codec
+  stats.Set("throughput", Napi::Number::New(env, busyNs_ > 0 ? bytesIn_ * 1e3 / busyNs_ : 0));
+  return stats;
+}
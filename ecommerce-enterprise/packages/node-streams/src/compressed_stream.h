@@ -0,0 +1,55 @@
+#ifndef COMPRESSED_STREAM_H
+#define COMPRESSED_STREAM_H
+
+#include <napi.h>
+#include <memory>
+#include <string>
+#include "compression_engine.h"
+
+class BufferSink;
+
+// Native codec behind createCompressedStream. The compression context is
+// created once and kept for the life of the stream, so consecutive chunks,
+// frames and one-shot payloads all reuse it (and its dictionary).
+//
+//   update(chunk)    -> Buffer   output so far; may be empty
+//   flush()          -> Buffer   everything written so far becomes decodable
+//   final()          -> Buffer   close the frame; the next update() starts a new one
+//   process(payload) -> Buffer   one complete frame, e.g. a single JSON document
+//   reset()                      abandon the frame in progress
+//   stats                        { bytesIn, bytesOut, ratio, throughput }
+//
+// Config: { compressionAlgorithm, compressionLevel?, mode?: 'compress' | 'decompress',
+//           windowLog?, workers?, parallelThreshold?, dictionary? }
+class CompressedStream : public Napi::ObjectWrap<CompressedStream> {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(Napi::Env env, Napi::Object config);
+  
+  CompressedStream(const Napi::CallbackInfo& info);
+
+private:
+  static Napi::FunctionReference constructor;
+  
+  Napi::Value Update(const Napi::CallbackInfo& info);
+  Napi::Value Flush(const Napi::CallbackInfo& info);
+  Napi::Value Final(const Napi::CallbackInfo& info);
+  Napi::Value Process(const Napi::CallbackInfo& info);
+  Napi::Value Reset(const Napi::CallbackInfo& info);
+  Napi::Value GetStats(const Napi::CallbackInfo& info);
+  
+  // Record timing and sizes for one call and hand back its output; on
+  // failure throw and reset, so the stream can be reused
+  Napi::Value Complete(Napi::Env env, uint64_t startNs, size_t bytesIn, bool ok, const std::string& error,
+                       BufferSink& sink);
+  
+  std::unique_ptr<CompressionCodec> codec_;
+  uint32_t metric_;
+  bool decompress_;
+  size_t parallelThreshold_;
+  double bytesIn_;
+  double bytesOut_;
+  uint64_t busyNs_;
+};
+
+#endif // COMPRESSED_STREAM_H
@@ -0,0 +1,647 @@
+#include "compression_engine.h"
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+#ifdef STREAMS_WITH_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
+#ifdef STREAMS_WITH_LZ4
+#include <lz4.h>
+#include <lz4frame.h>
+// The lz4 dictionary API is only exported by shared builds from 1.10 on
+#define STREAMS_LZ4_DICTIONARY (LZ4_VERSION_NUMBER >= 11000)
+#endif
+
+namespace {
+
+const size_t kMinReserve = 16 * 1024;
+
+// lz4 output is bounded per block, so input is fed in slices of this size
+const size_t kLz4Slice = 64 * 1024;
+
+// zlib counts in uInt
+const size_t kMaxZlibSlice = UINT_MAX;
+
+// deflate, gzip and raw deflate through zlib
+class DeflateCodec : public CompressionCodec {
+public:
+  DeflateCodec(bool decompress, int windowBits, const std::vector<uint8_t>& dictionary)
+    : decompress_(decompress), windowBits_(windowBits), initialized_(false),
+      seen_(false), ended_(false), dictionary_(dictionary) {
+    std::memset(&stream_, 0, sizeof(stream_));
+  }
+  
+  ~DeflateCodec() override {
+    if (initialized_) {
+      decompress_ ? inflateEnd(&stream_) : deflateEnd(&stream_);
+    }
+  }
+  
+  bool Init(int level, std::string& error) {
+    if (decompress_) {
+      initialized_ = inflateInit2(&stream_, windowBits_) == Z_OK;
+    } else {
+      initialized_ = deflateInit2(&stream_, level, Z_DEFLATED, windowBits_, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+    if (!initialized_) {
+      error = "Failed to initialize zlib";
+      return false;
+    }
+    if (!ApplyDictionary()) {
+      error = "Failed to set compression dictionary";
+      return false;
+    }
+    return true;
+  }
+  
+  bool Update(const uint8_t* input, size_t length, bool flush, CompressionSink& sink, std::string& error) override {
+    seen_ = seen_ || length > 0;
+    size_t consumed = 0;
+    
+    while (true) {
+      if (stream_.avail_in == 0 && consumed < length) {
+        size_t slice = std::min(length - consumed, kMaxZlibSlice);
+        // zlib never writes through next_in
+        stream_.next_in = const_cast<Bytef*>(input + consumed);
+        stream_.avail_in = static_cast<uInt>(slice);
+        consumed += slice;
+      }
+      
+      size_t available = 0;
+      uint8_t* out = sink.Reserve(kMinReserve, available);
+      size_t room = std::min(available, kMaxZlibSlice);
+      stream_.next_out = out;
+      stream_.avail_out = static_cast<uInt>(room);
+      
+      int ret;
+      if (decompress_) {
+        ret = inflate(&stream_, Z_NO_FLUSH);
+        if (ret == Z_NEED_DICT) {
+          ret = dictionary_.empty() ? Z_DATA_ERROR
+                                    : inflateSetDictionary(&stream_, dictionary_.data(), static_cast<uInt>(dictionary_.size()));
+        }
+      } else {
+        ret = deflate(&stream_, consumed < length || !flush ? Z_NO_FLUSH : Z_SYNC_FLUSH);
+      }
+      sink.Commit(room - stream_.avail_out);
+      
+      if (ret == Z_STREAM_END) {
+        ended_ = true;
+        if (stream_.avail_in == 0 && consumed == length) {
+          return true;
+        }
+        // gzip may carry several members back to back
+        if (decompress_ && windowBits_ > 15) {
+          inflateReset(&stream_);
+          ended_ = false;
+          continue;
+        }
+        error = "Unexpected data after the end of the compressed stream";
+        return false;
+      }
+      // Z_BUF_ERROR only means no progress was possible with this input
+      if (ret != Z_OK && ret != Z_BUF_ERROR) {
+        error = decompress_ ? std::string("Invalid compressed data") + (stream_.msg ? ": " + std::string(stream_.msg) : "")
+                            : "Compression failed";
+        return false;
+      }
+      if (stream_.avail_in == 0 && consumed == length && stream_.avail_out != 0) {
+        return true;
+      }
+    }
+  }
+  
+  bool Finish(CompressionSink& sink, std::string& error) override {
+    if (decompress_) {
+      if (seen_ && !ended_) {
+        error = "Compressed stream is truncated";
+        return false;
+      }
+      return true;
+    }
+    
+    stream_.avail_in = 0;
+    while (true) {
+      size_t available = 0;
+      uint8_t* out = sink.Reserve(64, available);
+      size_t room = std::min(available, kMaxZlibSlice);
+      stream_.next_out = out;
+      stream_.avail_out = static_cast<uInt>(room);
+      int ret = deflate(&stream_, Z_FINISH);
+      sink.Commit(room - stream_.avail_out);
+      if (ret == Z_STREAM_END) {
+        return true;
+      }
+      if (ret != Z_OK && ret != Z_BUF_ERROR) {
+        error = "Compression failed";
+        return false;
+      }
+    }
+  }
+  
+  void Reset() override {
+    decompress_ ? inflateReset(&stream_) : deflateReset(&stream_);
+    // A reset forgets the dictionary
+    ApplyDictionary();
+    seen_ = false;
+    ended_ = false;
+  }
+  
+  size_t OutputHint(size_t length) const override {
+    return decompress_ ? std::max(length * 4, kMinReserve)
+                       : static_cast<size_t>(deflateBound(const_cast<z_stream*>(&stream_), static_cast<uLong>(length)));
+  }
+
+private:
+  // zlib-wrapped inflate asks for the dictionary itself (Z_NEED_DICT)
+  bool ApplyDictionary() {
+    if (dictionary_.empty() || (decompress_ && windowBits_ > 0)) {
+      return true;
+    }
+    uInt size = static_cast<uInt>(dictionary_.size());
+    return (decompress_ ? inflateSetDictionary(&stream_, dictionary_.data(), size)
+                        : deflateSetDictionary(&stream_, dictionary_.data(), size)) == Z_OK;
+  }
+  
+  z_stream stream_;
+  bool decompress_;
+  int windowBits_;
+  bool initialized_;
+  bool seen_;
+  bool ended_;
+  std::vector<uint8_t> dictionary_;
+};
+
+#ifdef STREAMS_WITH_ZSTD
+
+class ZstdCodec : public CompressionCodec {
+public:
+  explicit ZstdCodec(bool decompress)
+    : decompress_(decompress), cctx_(nullptr), dctx_(nullptr), workers_(0), parallel_(false),
+      seen_(false), ended_(true) {}
+  
+  ~ZstdCodec() override {
+    ZSTD_freeCCtx(cctx_);
+    ZSTD_freeDCtx(dctx_);
+  }
+  
+  bool Init(const CompressionOptions& options, std::string& error) {
+    size_t ret = 0;
+    if (decompress_) {
+      dctx_ = ZSTD_createDCtx();
+      if (!dctx_) {
+        error = "Failed to create zstd context";
+        return false;
+      }
+      // Frames with a larger window than this are refused rather than
+      // allowed to allocate whatever they ask for
+      if (options.windowLog) {
+        ret = ZSTD_DCtx_setParameter(dctx_, ZSTD_d_windowLogMax, options.windowLog);
+      }
+      if (!ZSTD_isError(ret) && !options.dictionary.empty()) {
+        ret = ZSTD_DCtx_loadDictionary(dctx_, options.dictionary.data(), options.dictionary.size());
+      }
+    } else {
+      cctx_ = ZSTD_createCCtx();
+      if (!cctx_) {
+        error = "Failed to create zstd context";
+        return false;
+      }
+      int level = options.level == CompressionOptions::kDefaultLevel ? ZSTD_CLEVEL_DEFAULT : options.level;
+      if (level < ZSTD_minCLevel() || level > ZSTD_maxCLevel()) {
+        error = "zstd level must be between " + std::to_string(ZSTD_minCLevel()) + " and " +
+                std::to_string(ZSTD_maxCLevel());
+        return false;
+      }
+      ret = ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel, level);
+      if (!ZSTD_isError(ret) && options.windowLog) {
+        ret = ZSTD_CCtx_setParameter(cctx_, ZSTD_c_windowLog, options.windowLog);
+      }
+      // Sticky: loaded once and reused by every later frame
+      if (!ZSTD_isError(ret) && !options.dictionary.empty()) {
+        ret = ZSTD_CCtx_loadDictionary(cctx_, options.dictionary.data(), options.dictionary.size());
+      }
+      workers_ = options.workers;
+      parallel_ = workers_ > 0;
+      ApplyWorkers();
+    }
+    
+    if (ZSTD_isError(ret)) {
+      error = std::string("Invalid zstd options: ") + ZSTD_getErrorName(ret);
+      return false;
+    }
+    return true;
+  }
+  
+  bool Update(const uint8_t* input, size_t length, bool flush, CompressionSink& sink, std::string& error) override {
+    seen_ = seen_ || length > 0;
+    ZSTD_inBuffer in = { input, length, 0 };
+    
+    while (true) {
+      size_t available = 0;
+      uint8_t* out = sink.Reserve(kMinReserve, available);
+      ZSTD_outBuffer output = { out, available, 0 };
+      
+      size_t ret;
+      if (decompress_) {
+        size_t before = in.pos;
+        ret = ZSTD_decompressStream(dctx_, &output, &in);
+        if (!ZSTD_isError(ret)) {
+          // 0 means a frame just ended; another one may follow
+          ended_ = ret == 0 ? true : ended_ && in.pos == before;
+        }
+      } else {
+        ret = ZSTD_compressStream2(cctx_, &output, &in, flush ? ZSTD_e_flush : ZSTD_e_continue);
+      }
+      sink.Commit(output.pos);
+      
+      if (ZSTD_isError(ret)) {
+        error = std::string(decompress_ ? "Invalid compressed data: " : "Compression failed: ") + ZSTD_getErrorName(ret);
+        return false;
+      }
+      if (in.pos < in.size) {
+        continue;
+      }
+      if (decompress_ ? output.pos < output.size : !flush || ret == 0) {
+        return true;
+      }
+    }
+  }
+  
+  bool Finish(CompressionSink& sink, std::string& error) override {
+    if (decompress_) {
+      if (seen_ && !ended_) {
+        error = "Compressed stream is truncated";
+        return false;
+      }
+      return true;
+    }
+    
+    ZSTD_inBuffer in = { nullptr, 0, 0 };
+    while (true) {
+      size_t available = 0;
+      uint8_t* out = sink.Reserve(ZSTD_CStreamOutSize(), available);
+      ZSTD_outBuffer output = { out, available, 0 };
+      size_t remaining = ZSTD_compressStream2(cctx_, &output, &in, ZSTD_e_end);
+      sink.Commit(output.pos);
+      if (ZSTD_isError(remaining)) {
+        error = std::string("Compression failed: ") + ZSTD_getErrorName(remaining);
+        return false;
+      }
+      if (remaining == 0) {
+        return true;
+      }
+    }
+  }
+  
+  // Level, window and dictionary survive a session reset
+  void Reset() override {
+    if (decompress_) {
+      ZSTD_DCtx_reset(dctx_, ZSTD_reset_session_only);
+    } else {
+      ZSTD_CCtx_reset(cctx_, ZSTD_reset_session_only);
+      ApplyWorkers();
+    }
+    seen_ = false;
+    ended_ = true;
+  }
+  
+  size_t OutputHint(size_t length) const override {
+    return decompress_ ? std::max(length * 4, kMinReserve) : std::max(length / 2, kMinReserve);
+  }
+  
+  void SetParallel(bool parallel) override {
+    parallel_ = parallel && workers_ > 0;
+  }
+
+private:
+  void ApplyWorkers() {
+    // Fails on a libzstd built without threads; that just means one thread
+    ZSTD_CCtx_setParameter(cctx_, ZSTD_c_nbWorkers, parallel_ ? workers_ : 0);
+  }
+  
+  bool decompress_;
+  ZSTD_CCtx* cctx_;
+  ZSTD_DCtx* dctx_;
+  int workers_;
+  bool parallel_;
+  bool seen_;
+  bool ended_;
+};
+
+#endif // STREAMS_WITH_ZSTD
+
+#ifdef STREAMS_WITH_LZ4
+
+// lz4 frame format; the window option picks the block size
+class Lz4Codec : public CompressionCodec {
+public:
+  explicit Lz4Codec(bool decompress)
+    : decompress_(decompress), cctx_(nullptr), dctx_(nullptr),
+      started_(false), seen_(false), ended_(true) {
+    std::memset(&preferences_, 0, sizeof(preferences_));
+  }
+  
+  ~Lz4Codec() override {
+    LZ4F_freeCompressionContext(cctx_);
+    LZ4F_freeDecompressionContext(dctx_);
+#if STREAMS_LZ4_DICTIONARY
+    LZ4F_freeCDict(cdict_);
+#endif
+  }
+  
+  bool Init(const CompressionOptions& options, std::string& error) {
+    dictionary_ = options.dictionary;
+#if !STREAMS_LZ4_DICTIONARY
+    if (!dictionary_.empty()) {
+      error = "lz4 dictionaries need liblz4 1.10 or newer";
+      return false;
+    }
+#endif
+    
+    if (decompress_) {
+      if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx_, LZ4F_VERSION))) {
+        error = "Failed to create lz4 context";
+        return false;
+      }
+      return true;
+    }
+    
+    int level = options.level == CompressionOptions::kDefaultLevel ? 0 : options.level;
+    if (level > LZ4F_compressionLevel_max()) {
+      error = "lz4 level must be at most " + std::to_string(LZ4F_compressionLevel_max());
+      return false;
+    }
+    if (options.windowLog && (options.windowLog < 16 || options.windowLog > 22)) {
+      error = "lz4 window must be between 16 (64 KiB blocks) and 22 (4 MiB blocks)";
+      return false;
+    }
+    
+    preferences_.compressionLevel = level;
+    preferences_.frameInfo.blockMode = LZ4F_blockLinked;
+    preferences_.frameInfo.blockSizeID = options.windowLog == 0 || options.windowLog <= 16 ? LZ4F_max64KB
+                                       : options.windowLog <= 18 ? LZ4F_max256KB
+                                       : options.windowLog <= 20 ? LZ4F_max1MB : LZ4F_max4MB;
+    
+    if (LZ4F_isError(LZ4F_createCompressionContext(&cctx_, LZ4F_VERSION))) {
+      error = "Failed to create lz4 context";
+      return false;
+    }
+#if STREAMS_LZ4_DICTIONARY
+    // Digested once, shared by every frame this codec writes
+    if (!dictionary_.empty()) {
+      cdict_ = LZ4F_createCDict(dictionary_.data(), dictionary_.size());
+      if (!cdict_) {
+        error = "Failed to load lz4 dictionary";
+        return false;
+      }
+    }
+#endif
+    return true;
+  }
+  
+  bool Update(const uint8_t* input, size_t length, bool flush, CompressionSink& sink, std::string& error) override {
+    seen_ = seen_ || length > 0;
+    return decompress_ ? Decompress(input, length, sink, error) : Compress(input, length, flush, sink, error);
+  }
+  
+  bool Finish(CompressionSink& sink, std::string& error) override {
+    if (decompress_) {
+      if (seen_ && !ended_) {
+        error = "Compressed stream is truncated";
+        return false;
+      }
+      return true;
+    }
+    
+    if (!Begin(sink, error)) {
+      return false;
+    }
+    size_t available = 0;
+    uint8_t* out = sink.Reserve(LZ4F_compressBound(0, &preferences_), available);
+    size_t written = LZ4F_compressEnd(cctx_, out, available, nullptr);
+    if (LZ4F_isError(written)) {
+      error = std::string("Compression failed: ") + LZ4F_getErrorName(written);
+      return false;
+    }
+    sink.Commit(written);
+    started_ = false;
+    return true;
+  }
+  
+  void Reset() override {
+    if (decompress_) {
+      LZ4F_resetDecompressionContext(dctx_);
+    }
+    started_ = false;
+    seen_ = false;
+    ended_ = true;
+  }
+  
+  size_t OutputHint(size_t length) const override {
+    return decompress_ ? std::max(length * 4, kMinReserve)
+                       : LZ4F_compressBound(std::min(length, kLz4Slice), &preferences_) + LZ4F_HEADER_SIZE_MAX;
+  }
+
+private:
+  // The frame header is written lazily so Reset() costs nothing
+  bool Begin(CompressionSink& sink, std::string& error) {
+    if (started_) {
+      return true;
+    }
+    size_t available = 0;
+    uint8_t* out = sink.Reserve(LZ4F_HEADER_SIZE_MAX, available);
+#if STREAMS_LZ4_DICTIONARY
+    size_t written = LZ4F_compressBegin_usingCDict(cctx_, out, available, cdict_, &preferences_);
+#else
+    size_t written = LZ4F_compressBegin(cctx_, out, available, &preferences_);
+#endif
+    if (LZ4F_isError(written)) {
+      error = std::string("Compression failed: ") + LZ4F_getErrorName(written);
+      return false;
+    }
+    sink.Commit(written);
+    started_ = true;
+    return true;
+  }
+  
+  bool Compress(const uint8_t* input, size_t length, bool flush, CompressionSink& sink, std::string& error) {
+    if (!Begin(sink, error)) {
+      return false;
+    }
+    
+    for (size_t offset = 0; offset < length; offset += kLz4Slice) {
+      size_t slice = std::min(length - offset, kLz4Slice);
+      size_t available = 0;
+      uint8_t* out = sink.Reserve(LZ4F_compressBound(slice, &preferences_), available);
+      size_t written = LZ4F_compressUpdate(cctx_, out, available, input + offset, slice, nullptr);
+      if (LZ4F_isError(written)) {
+        error = std::string("Compression failed: ") + LZ4F_getErrorName(written);
+        return false;
+      }
+      sink.Commit(written);
+    }
+    
+    if (flush) {
+      size_t available = 0;
+      uint8_t* out = sink.Reserve(LZ4F_compressBound(0, &preferences_), available);
+      size_t written = LZ4F_flush(cctx_, out, available, nullptr);
+      if (LZ4F_isError(written)) {
+        error = std::string("Compression failed: ") + LZ4F_getErrorName(written);
+        return false;
+      }
+      sink.Commit(written);
+    }
+    return true;
+  }
+  
+  bool Decompress(const uint8_t* input, size_t length, CompressionSink& sink, std::string& error) {
+    size_t consumed = 0;
+    while (true) {
+      size_t available = 0;
+      uint8_t* out = sink.Reserve(kMinReserve, available);
+      size_t produced = available;
+      size_t read = length - consumed;
+#if STREAMS_LZ4_DICTIONARY
+      size_t hint = LZ4F_decompress_usingDict(dctx_, out, &produced, input + consumed, &read,
+                                              dictionary_.empty() ? nullptr : dictionary_.data(),
+                                              dictionary_.size(), nullptr);
+#else
+      size_t hint = LZ4F_decompress(dctx_, out, &produced, input + consumed, &read, nullptr);
+#endif
+      if (LZ4F_isError(hint)) {
+        error = std::string("Invalid compressed data: ") + LZ4F_getErrorName(hint);
+        return false;
+      }
+      sink.Commit(produced);
+      consumed += read;
+      // 0 means a frame just ended; the context is ready for another
+      ended_ = hint == 0 ? true : ended_ && read == 0 && produced == 0;
+      
+      if (consumed == length && produced < available) {
+        return true;
+      }
+    }
+  }
+  
+  bool decompress_;
+  LZ4F_cctx* cctx_;
+  LZ4F_dctx* dctx_;
+#if STREAMS_LZ4_DICTIONARY
+  LZ4F_CDict* cdict_ = nullptr;
+#endif
+  LZ4F_preferences_t preferences_;
+  std::vector<uint8_t> dictionary_;
+  bool started_;
+  bool seen_;
+  bool ended_;
+};
+
+#endif // STREAMS_WITH_LZ4
+
+} // namespace
+
+std::unique_ptr<CompressionCodec> CompressionCodec::Create(const CompressionOptions& options, std::string& error) {
+  const std::string& algorithm = options.algorithm;
+  
+  if (algorithm == "gzip" || algorithm == "deflate" || algorithm == "raw") {
+    int level = options.level == CompressionOptions::kDefaultLevel ? Z_DEFAULT_COMPRESSION : options.level;
+    if (level < Z_DEFAULT_COMPRESSION || level > Z_BEST_COMPRESSION) {
+      error = "Compression level must be between -1 and 9";
+      return nullptr;
+    }
+    int windowBits = options.windowLog ? options.windowLog : 15;
+    if (windowBits < 9 || windowBits > 15) {
+      error = "zlib window must be between 9 and 15";
+      return nullptr;
+    }
+    if (algorithm == "gzip" && !options.dictionary.empty()) {
+      error = "gzip does not support dictionaries; use deflate, raw or zstd";
+      return nullptr;
+    }
+    
+    windowBits = algorithm == "gzip" ? windowBits + 16 : algorithm == "raw" ? -windowBits : windowBits;
+    std::unique_ptr<DeflateCodec> codec(new DeflateCodec(options.decompress, windowBits, options.dictionary));
+    if (!codec->Init(level, error)) {
+      return nullptr;
+    }
+    return codec;
+  }
+  
+  if (algorithm == "zstd") {
+#ifdef STREAMS_WITH_ZSTD
+    std::unique_ptr<ZstdCodec> codec(new ZstdCodec(options.decompress));
+    if (!codec->Init(options, error)) {
+      return nullptr;
+    }
+    return codec;
+#else
+    error = "zstd support is not compiled into this build";
+    return nullptr;
+#endif
+  }
+  
+  if (algorithm == "lz4") {
+#ifdef STREAMS_WITH_LZ4
+    std::unique_ptr<Lz4Codec> codec(new Lz4Codec(options.decompress));
+    if (!codec->Init(options, error)) {
+      return nullptr;
+    }
+    return codec;
+#else
+    error = "lz4 support is not compiled into this build";
+    return nullptr;
+#endif
+  }
+  
+  error = "Unsupported compression algorithm: " + algorithm;
+  return nullptr;
+}
+
+std::vector<std::string> CompressionCodec::Available() {
+  std::vector<std::string> algorithms = { "gzip", "deflate", "raw" };
+#ifdef STREAMS_WITH_ZSTD
+  algorithms.push_back("zstd");
+#endif
+#ifdef STREAMS_WITH_LZ4
+  algorithms.push_back("lz4");
+#endif
+  return algorithms;
+}
+
+bool CompressionCodec::TrainDictionary(const std::vector<std::string>& samples, size_t maxSize,
+                                       std::vector<uint8_t>& dictionary, std::string& error) {
+#ifdef STREAMS_WITH_ZSTD
+  std::string joined;
+  std::vector<size_t> sizes;
+  sizes.reserve(samples.size());
+  for (const std::string& sample : samples) {
+    joined += sample;
+    sizes.push_back(sample.size());
+  }
+  
+  dictionary.resize(maxSize);
+  size_t size = ZDICT_trainFromBuffer(dictionary.data(), maxSize, joined.data(), sizes.data(),
+                                      static_cast<unsigned>(sizes.size()));
+  if (ZDICT_isError(size)) {
+    // Usually too few samples, or samples too similar to learn from
+    error = std::string("Dictionary training failed: ") + ZDICT_getErrorName(size);
+    dictionary.clear();
+    return false;
+  }
+  dictionary.resize(size);
+  return true;
+#else
+  (void)samples;
+  (void)maxSize;
+  (void)dictionary;
+  error = "Dictionary training requires zstd support";
+  return false;
+#endif
+}
+
+bool CompressionCodec::Process(const uint8_t* input, size_t length, CompressionSink& sink, std::string& error) {
+  Reset();
+  return Update(input, length, false, sink, error) && Finish(sink, error);
+}
@@ -0,0 +1,73 @@
+#ifndef COMPRESSION_ENGINE_H
+#define COMPRESSION_ENGINE_H
+
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Where a codec writes its output. Letting the caller own the storage means
+// the result can become a Buffer or a pipeline chunk without another copy.
+class CompressionSink {
+public:
+  virtual ~CompressionSink() {}
+  
+  // Writable space after the current output, at least minimum bytes
+  virtual uint8_t* Reserve(size_t minimum, size_t& available) = 0;
+  virtual void Commit(size_t written) = 0;
+};
+
+struct CompressionOptions {
+  static const int kDefaultLevel = INT_MIN;
+  
+  CompressionOptions() : level(kDefaultLevel), windowLog(0), workers(0), decompress(false) {}
+  
+  std::string algorithm;            // 'gzip' | 'deflate' | 'raw' | 'zstd' | 'lz4'
+  int level;                        // kDefaultLevel picks the codec's default
+  int windowLog;                    // log2 of the window (lz4: block size); 0 = default
+  int workers;                      // zstd compression threads; 0 = single-threaded
+  bool decompress;
+  std::vector<uint8_t> dictionary;  // shared by both ends; see TrainDictionary
+};
+
+// Streaming compressor or decompressor. One context is created per codec
+// and reused for every frame: Reset() starts a new frame but keeps the
+// level, window and dictionary, which is what makes many small payloads
+// cheap. Not thread-safe; one caller at a time.
+class CompressionCodec {
+public:
+  static std::unique_ptr<CompressionCodec> Create(const CompressionOptions& options, std::string& error);
+  
+  // Backends compiled into this build
+  static std::vector<std::string> Available();
+  
+  // zstd dictionary from sample payloads (raw content dictionaries work for
+  // every backend, but trained ones need zstd)
+  static bool TrainDictionary(const std::vector<std::string>& samples, size_t maxSize,
+                              std::vector<uint8_t>& dictionary, std::string& error);
+  
+  virtual ~CompressionCodec() {}
+  
+  // Consume all of input. With flush, everything written so far can be
+  // decoded by the other end without waiting for more.
+  virtual bool Update(const uint8_t* input, size_t length, bool flush, CompressionSink& sink, std::string& error) = 0;
+  
+  // Close the frame; when decompressing, fail if it was truncated
+  virtual bool Finish(CompressionSink& sink, std::string& error) = 0;
+  
+  // Drop the current frame and start a new one on the same context
+  virtual void Reset() = 0;
+  
+  // Expected output for length input bytes, for sizing the first Reserve
+  virtual size_t OutputHint(size_t length) const = 0;
+  
+  // Single-frame helper: Reset, Update, Finish
+  bool Process(const uint8_t* input, size_t length, CompressionSink& sink, std::string& error);
+  
+  // Large payloads only; the zstd worker pool costs more than it saves on
+  // small ones. Applies from the next frame.
+  virtual void SetParallel(bool /*parallel*/) {}
+};
+
+#endif // COMPRESSION_ENGINE_H
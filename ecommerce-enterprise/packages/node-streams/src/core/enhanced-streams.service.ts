@@ -21,6 +21,11 @@ import {
   StreamSplitterConfig,
   StreamMergerConfig,
   StreamConfiguration,
+  StreamRateLimiterConfig,
+  StreamBackpressureConfig,
+  StreamCircuitBreakerConfig,
+  CircuitBreakerState,
+  CircuitBreakerStateChange,
 } from '../types/streams.types';
 import { once } from 'events';
 import { Readable, Writable } from 'stream';
@@ -47,14 +52,19 @@ export interface NativeStreamsAddon {
   // Core stream operations
   createReadableStream(config: StreamConfig): ReadableStream;
   createWritableStream(config: StreamConfig): WritableStream;
+  createTransformStream(config: NativeTransformPipelineConfig): NativeTransformPipeline;
   createTransformStream(config: StreamConfig): TransformStream;
   createDuplexStream(config: StreamConfig): DuplexStream;
   
   // Enhanced stream operations
-  createEncryptedStream(config: EncryptedStreamConfig): EncryptedStream;
-  createCompressedStream(config: CompressedStreamConfig): CompressedStream;
-  createMultiplexedStream(config: MultiplexedStreamConfig): MultiplexedStream;
+  createEncryptedStream(config: EncryptedStreamConfig): NativeCipherStream;
+  createCompressedStream(config: CompressedStreamConfig): NativeCompressedStream;
+  trainCompressionDictionary(samples: Buffer[], maxSize?: number): Promise<Buffer>;
+  getCompressionBackends(): string[];
+  createMultiplexedStream(config: MultiplexedStreamConfig): NativeFrameMux;
+  createSplitterStream(config: StreamSplitterConfig & { splitStrategy: 'channel' }): NativeFrameMux;
   createSplitterStream(config: StreamSplitterConfig): SplitterStream;
+  createMergerStream(config: StreamMergerConfig & { mergeStrategy: 'channel' }): NativeFrameMux;
   createMergerStream(config: StreamMergerConfig): MergerStream;
   
   // Performance operations
@@ -63,9 +73,9 @@ export interface NativeStreamsAddon {
   analyzeStream(stream: BaseStream): StreamPerformanceAnalysis;
   
   // Flow control
-  enableBackpressure(stream: BaseStream, config: StreamConfig): void;
-  enableRateLimiting(stream: BaseStream, config: StreamConfig): void;
-  enableCircuitBreaker(stream: BaseStream, config: StreamConfig): void;
+  enableBackpressure(pipeline: NativeTransformPipeline, config: Partial<StreamBackpressureConfig>): NativeBackpressureResult;
+  enableRateLimiting(streamId: string, config: StreamRateLimiterConfig): NativeRateLimiter;
+  enableCircuitBreaker(streamId: string, config: NativeCircuitBreakerConfig): NativeCircuitBreaker;
   
   // Security operations
   enableEncryption(stream: BaseStream, config: EncryptedStreamConfig): void;
@@ -77,11 +87,201 @@ export interface NativeStreamsAddon {
   stopMonitoring(stream: BaseStream): void;
   getMetrics(stream: BaseStream): StreamMetrics;
   getHealthCheck(stream: BaseStream): HealthStatus;
+  exportMetrics(options?: NativeMetricsExportFormat | NativeMetricsExportOptions): string | Buffer | number;
   
   // Utility operations
   validateStream(stream: BaseStream): ValidationResult;
-  serializeStream(stream: BaseStream): Buffer;
-  deserializeStream(buffer: Buffer): BaseStream;
+  serializeStream(state: StreamCheckpointState | StreamCheckpointState[]): Buffer;
+  serializeStream(state: StreamCheckpointState | StreamCheckpointState[], target: Buffer): number;
+  deserializeStream(checkpoint: Uint8Array): StreamCheckpointState | StreamCheckpointState[];
+  deserializeStream(checkpoint: Uint8Array, index: number): StreamCheckpointState;
+  inspectCheckpoint(checkpoint: Uint8Array): NativeCheckpointInfo;
+  openCheckpoint(path: string): Buffer;
+}
+
+// Incremental AES-GCM cipher returned by the native createEncryptedStream
+export interface NativeCipherStream {
+  readonly streamId: string;
+  readonly iv: Buffer;
+  readonly mode: 'encrypt' | 'decrypt';
+  readonly bytesProcessed: number;
+  update(chunk: Buffer): Buffer;
+  final(): Buffer;
+  getAuthTag(): Buffer;
+  setAuthTag(tag: Buffer): void;
+}
+
+// Native codec returned by createCompressedStream; the context (and any
+// dictionary) is reused across chunks, frames and process() calls
+export interface NativeCompressedStream {
+  readonly streamId: string;
+  readonly algorithm: string;
+  readonly mode: 'compress' | 'decompress';
+  readonly stats: { bytesIn: number; bytesOut: number; ratio: number; throughput: number };
+  update(chunk: Buffer): Buffer;
+  flush(): Buffer;
+  final(): Buffer;
+  process(payload: Buffer): Buffer;
+  reset(): void;
+}
+
+// Keyed GCRA limiter returned by the native enableRateLimiting
+export interface NativeRateLimiter {
+  readonly streamId: string;
+  readonly maxRequests: number;
+  readonly windowMs: number;
+  readonly burst: number;
+  readonly retryAfter: number; // ms until the last denied request would have passed
+  readonly stats: { allowed: number; denied: number; keys: number; evictions: number; capacity: number };
+  tryAcquire(key: string | number, cost?: number): boolean;
+  tryAcquireMany(keys: Array<string | number>, cost?: number, out?: Uint8Array): number;
+  reset(key: string | number): void;
+}
+
+export interface NativeCircuitBreakerConfig extends StreamCircuitBreakerConfig {
+  onStateChange?(change: CircuitBreakerStateChange): void; // async, after each transition
+}
+
+// Breaker for one outbound target returned by the native enableCircuitBreaker;
+// call allow() before each request and report its outcome
+export interface NativeCircuitBreaker {
+  readonly streamId: string;
+  readonly state: CircuitBreakerState;
+  readonly retryAfter: number; // ms until an open circuit admits a probe
+  readonly stats: { state: CircuitBreakerState; failures: number; successes: number; rejected: number; trips: number };
+  allow(): boolean;
+  success(): void;
+  failure(): void;
+  reset(): void;
+}
+
+// Stages of a native transform pipeline, applied in order to every chunk
+export type TransformPipelineStage =
+  | { type: 'encrypt' | 'decrypt'; key: Buffer; iv?: Buffer; aad?: Buffer; authTag?: Buffer; algorithm?: 'aes-256-gcm' | 'aes-128-gcm' }
+  | {
+      type: 'compress' | 'decompress';
+      algorithm?: 'deflate' | 'gzip' | 'raw' | 'zstd' | 'lz4';
+      level?: number;
+      windowLog?: number;
+      workers?: number;
+      dictionary?: Buffer;
+      flush?: 'none' | 'sync';
+    }
+  | { type: 'hash'; algorithm?: string }
+  | { type: 'frame' }; // 4-byte big-endian length before every chunk
+
+// Reported once all stages have been flushed
+export interface TransformPipelineSummary {
+  bytesIn: number;
+  bytesOut: number;
+  chunksIn: number;
+  chunksOut: number;
+  iv?: Buffer;
+  authTag?: Buffer;
+  digest?: Buffer;
+  digestAlgorithm?: string;
+}
+
+export interface NativeTransformPipelineConfig {
+  stages: TransformPipelineStage[];
+  highWaterMark?: number;
+  lowWaterMark?: number; // onDrain waits for the queue to fall this far; default highWaterMark / 2
+  maxQueuedBytes?: number;
+  maxQueuedChunks?: number;
+  onData(chunk: Buffer): void;
+  onEnd?(summary: TransformPipelineSummary): void;
+  onError?(error: Error): void;
+  onDrain?(): void;
+}
+
+// Chunked pipeline returned by the native createTransformStream({ stages });
+// chunks are processed off the JS thread and come back through onData
+export interface NativeTransformPipeline {
+  readonly streamId: string;
+  readonly iv?: Buffer;
+  readonly stats: {
+    bytesIn: number;
+    bytesOut: number;
+    chunksIn: number;
+    chunksOut: number;
+    queuedBytes: number;
+    queuedChunks: number;
+    highWaterMark: number;
+    lowWaterMark: number;
+    paused: boolean;
+    pauses: number;
+    blockedMs: number; // time writers have spent waiting for onDrain
+  };
+  write(chunk: Buffer): boolean; // throws past maxQueuedBytes
+  end(): void;
+  destroy(): void;
+}
+
+export interface NativeBackpressureResult {
+  success: boolean;
+  streamId: string;
+  backpressureEnabled: boolean;
+  highWaterMark: number;
+  lowWaterMark: number;
+}
+
+// Credit-based framer for many channels over one byte stream, returned by
+// the native createMultiplexedStream and the 'channel' splitter / merger
+export interface NativeFrameMux {
+  readonly streamId: string;
+  readonly initialWindow: number;
+  readonly maxFrameSize: number;
+  readonly maxChannels: number;
+  readonly pendingBytes: number; // output waiting for flush()
+  readonly stats: {
+    channels: number;
+    framesIn: number;
+    framesOut: number;
+    bytesIn: number;
+    bytesOut: number;
+    queuedBytes: number;
+    blockedChannels: number; // channels waiting for credit
+    flushes: number;
+  };
+  write(channel: number, chunk: Buffer): boolean; // false: wait for the channel's drain
+  end(channel: number): void;
+  consume(channel: number, bytes: number): void;
+  flush(): Buffer[];
+  // Flat [channel, kind, payload] triples; kind 0 data, 1 drain, 2 end
+  receive(chunk: Buffer): Array<number | Uint8Array | undefined>;
+}
+
+// Native operation metrics for scrapers. 'snapshot' is the compact binary
+// form, a delta from the previous snapshot unless full is set.
+export type NativeMetricsExportFormat = 'openmetrics' | 'snapshot';
+
+export interface NativeMetricsExportOptions {
+  format?: NativeMetricsExportFormat;
+  target?: Buffer; // write into this and return the byte count needed
+  full?: boolean;
+}
+
+// Plain data checkpointed for one stream: descriptor fields, pipeline
+// configuration and buffered chunks. Functions and undefined properties are
+// dropped; bytes come back as Uint8Array views into the checkpoint.
+export type StreamCheckpointValue =
+  | null
+  | boolean
+  | number
+  | string
+  | Date
+  | Uint8Array
+  | StreamCheckpointValue[]
+  | { [key: string]: StreamCheckpointValue | undefined };
+
+export type StreamCheckpointState = { [key: string]: StreamCheckpointValue | undefined };
+
+export interface NativeCheckpointInfo {
+  valid: boolean; // header readable and checksum intact
+  version?: number;
+  count?: number;
+  byteLength?: number;
+  error?: string;
 }
 
 // Load the native addon
@@ -101,6 +301,7 @@ export class EnhancedStreamsService {
   private streams: Map<string, BaseStream> = new Map();
   private metrics: Map<string, StreamMetrics> = new Map();
   private auditLog: StreamAuditEntry[] = [];
+  private pipelines = new WeakMap<TransformStream, NativeTransformPipeline>();
 
   constructor(config: Partial<StreamConfiguration> = {}) {
     this.config = {
@@ -211,9 +412,13 @@ export class EnhancedStreamsService {
     return stream;
   }
 
-  createTransformStream(config: Partial<StreamConfig> = {}): TransformStream {
-    const streamConfig = { ...this.config.global, ...config };
-    const stream = nativeAddon.createTransformStream?.(streamConfig) || this.fallbackCreateTransformStream(streamConfig);
+  createTransformStream(
+    config: Partial<StreamConfig> & { stages?: TransformPipelineStage[]; backpressure?: Partial<StreamBackpressureConfig> } = {}
+  ): TransformStream {
+    const { stages, backpressure, ...streamConfig } = { ...this.config.global, ...config };
+    const stream = stages
+      ? this.createNativeTransformPipeline(streamConfig, stages, backpressure)
+      : nativeAddon.createTransformStream?.(streamConfig) || this.fallbackCreateTransformStream(streamConfig);
     
     if (this.config.monitoring.enableMetrics) {
       this.startStreamMonitoring(stream);
@@ -235,7 +440,8 @@ export class EnhancedStreamsService {
 
   // Enhanced stream creation methods
   createEncryptedStream(config: EncryptedStreamConfig): EncryptedStream {
-    const stream = nativeAddon.createEncryptedStream?.(config) || this.fallbackCreateEncryptedStream(config);
+    const cipher = nativeAddon.createEncryptedStream?.(config);
+    const stream = cipher ? this.wrapNativeCipherStream(cipher, config) : this.fallbackCreateEncryptedStream(config);
     
     if (this.config.monitoring.enableMetrics) {
       this.startStreamMonitoring(stream);
@@ -245,7 +451,10 @@ export class EnhancedStreamsService {
   }
 
   createCompressedStream(config: CompressedStreamConfig): CompressedStream {
-    const stream = nativeAddon.createCompressedStream?.(config) || this.fallbackCreateCompressedStream(config);
+    const codec = this.supportsNativeCompression(config.compressionAlgorithm)
+      ? nativeAddon.createCompressedStream(config)
+      : undefined;
+    const stream = codec ? this.wrapNativeCompressedStream(codec, config) : this.fallbackCreateCompressedStream(config);
     
     if (this.config.monitoring.enableMetrics) {
       this.startStreamMonitoring(stream);
@@ -255,7 +464,8 @@ export class EnhancedStreamsService {
   }
 
   createMultiplexedStream(config: MultiplexedStreamConfig): MultiplexedStream {
-    const stream = nativeAddon.createMultiplexedStream?.(config) || this.fallbackCreateMultiplexedStream(config);
+    const mux = nativeAddon.createMultiplexedStream?.(config);
+    const stream = mux ? this.wrapNativeMux<MultiplexedStream>(mux, config) : this.fallbackCreateMultiplexedStream(config);
     
     if (this.config.monitoring.enableMetrics) {
       this.startStreamMonitoring(stream);
@@ -265,7 +475,9 @@ export class EnhancedStreamsService {
   }
 
   createSplitterStream(config: StreamSplitterConfig): SplitterStream {
-    const stream = nativeAddon.createSplitterStream?.(config) || this.fallbackCreateSplitterStream(config);
+    const stream = config.splitStrategy === 'channel'
+      ? this.wrapNativeMux<SplitterStream>(this.requireNativeMux(nativeAddon.createSplitterStream?.({ ...config, splitStrategy: 'channel' })), config)
+      : nativeAddon.createSplitterStream?.(config) || this.fallbackCreateSplitterStream(config);
     
     if (this.config.monitoring.enableMetrics) {
       this.startStreamMonitoring(stream);
@@ -275,7 +487,9 @@ export class EnhancedStreamsService {
   }
 
   createMergerStream(config: StreamMergerConfig): MergerStream {
-    const stream = nativeAddon.createMergerStream?.(config) || this.fallbackCreateMergerStream(config);
+    const stream = config.mergeStrategy === 'channel'
+      ? this.wrapNativeMux<MergerStream>(this.requireNativeMux(nativeAddon.createMergerStream?.({ ...config, mergeStrategy: 'channel' })), config)
+      : nativeAddon.createMergerStream?.(config) || this.fallbackCreateMergerStream(config);
     
     if (this.config.monitoring.enableMetrics) {
       this.startStreamMonitoring(stream);
@@ -284,6 +498,42 @@ export class EnhancedStreamsService {
     return stream;
   }
 
+  // Flow control
+  // Retune the input queue of a stream from createTransformStream({ stages })
+  enableBackpressure(stream: TransformStream, config: Partial<StreamBackpressureConfig>): NativeBackpressureResult {
+    const pipeline = this.pipelines.get(stream);
+    if (!pipeline || !nativeAddon.enableBackpressure) {
+      throw new Error('Backpressure limits apply to native transform pipelines only');
+    }
+    return nativeAddon.enableBackpressure(pipeline, config);
+  }
+
+  createRateLimiter(streamId: string, config: StreamRateLimiterConfig): NativeRateLimiter {
+    return nativeAddon.enableRateLimiting?.(streamId, config) || this.fallbackCreateRateLimiter(streamId, config);
+  }
+
+  createCircuitBreaker(streamId: string, config: NativeCircuitBreakerConfig): NativeCircuitBreaker {
+    if (!nativeAddon.enableCircuitBreaker) {
+      throw new Error('Circuit breakers require the native streams addon');
+    }
+    return nativeAddon.enableCircuitBreaker(streamId, config);
+  }
+
+  // Run fn through the breaker, recording its outcome
+  async callWithCircuitBreaker<T>(breaker: NativeCircuitBreaker, fn: () => Promise<T>): Promise<T> {
+    if (!breaker.allow()) {
+      throw new Error(`Circuit ${breaker.streamId} is open; retry in ${breaker.retryAfter}ms`);
+    }
+    try {
+      const result = await fn();
+      breaker.success();
+      return result;
+    } catch (error) {
+      breaker.failure();
+      throw error;
+    }
+  }
+
   // Performance monitoring
   getStreamMetrics(streamId: string): StreamMetrics | null {
     return this.metrics.get(streamId) || null;
@@ -308,6 +558,33 @@ export class EnhancedStreamsService {
     return nativeAddon.analyzeStream?.(stream!) || this.fallbackAnalyzeStream(metrics);
   }
 
+  // Native operation timings as OpenMetrics text or a binary snapshot;
+  // null when the addon is not built
+  exportNativeMetrics(options?: NativeMetricsExportFormat | NativeMetricsExportOptions): string | Buffer | number | null {
+    return nativeAddon.exportMetrics?.(options) ?? null;
+  }
+
+  // Checkpoint stream state for a restart. With a target Buffer the
+  // checkpoint is written into it and the byte count needed is returned.
+  checkpointStreams(states: StreamCheckpointState[], target?: Buffer): Buffer | number {
+    if (!nativeAddon.serializeStream) {
+      throw new Error('Stream checkpoints require the native streams addon');
+    }
+    return target ? nativeAddon.serializeStream(states, target) : nativeAddon.serializeStream(states);
+  }
+
+  // Read a checkpoint back from a Buffer or, mapped rather than read, from a
+  // file. Chunks stay views into it; pass index to decode one stream only.
+  restoreCheckpoint(source: Uint8Array | string, index?: number): StreamCheckpointState[] | StreamCheckpointState {
+    if (!nativeAddon.deserializeStream) {
+      throw new Error('Stream checkpoints require the native streams addon');
+    }
+    const checkpoint = typeof source === 'string' ? nativeAddon.openCheckpoint(source) : source;
+    return index === undefined
+      ? nativeAddon.deserializeStream(checkpoint)
+      : nativeAddon.deserializeStream(checkpoint, index);
+  }
+
   // Audit trail
   getAuditLog(filter?: StreamFilter): StreamAuditEntry[] {
     let entries = [...this.auditLog];
@@ -514,6 +791,114 @@ export class EnhancedStreamsService {
     return new Duplex(config);
   }
 
+  // Drive the native cipher from a Transform: each chunk is processed as it
+  // arrives and the tag is produced (or checked) once in flush
+  private wrapNativeCipherStream(cipher: NativeCipherStream, config: EncryptedStreamConfig): EncryptedStream {
+    const { Transform } = require('stream');
+    
+    if (cipher.mode === 'decrypt' && config.authTag) {
+      cipher.setAuthTag(config.authTag);
+    }
+    
+    const stream = new Transform({
+      ...config,
+      transform(chunk: Buffer, _encoding: string, callback: (error?: Error | null, data?: Buffer) => void) {
+        try {
+          callback(null, cipher.update(chunk));
+        } catch (error) {
+          callback(error instanceof Error ? error : new Error('Encryption failed'));
+        }
+      },
+      flush(callback: (error?: Error | null) => void) {
+        try {
+          cipher.final();
+          if (cipher.mode === 'encrypt') {
+            stream.emit('authTag', cipher.getAuthTag());
+          }
+          callback();
+        } catch (error) {
+          callback(error instanceof Error ? error : new Error('Encryption failed'));
+        }
+      },
+    });
+    
+    stream.streamId = cipher.streamId;
+    stream.iv = cipher.iv;
+    stream.setAuthTag = (tag: Buffer) => cipher.setAuthTag(tag);
+    stream.getAuthTag = () => cipher.getAuthTag();
+    return stream;
+  }
+
+  // Feed a native pipeline from a Transform. A write that fills the pipeline
+  // holds its callback until onDrain, so backpressure reaches the writer;
+  // flush waits for onEnd and re-emits the summary.
+  private createNativeTransformPipeline(
+    config: StreamConfig,
+    stages: TransformPipelineStage[],
+    backpressure: Partial<StreamBackpressureConfig> = {}
+  ): TransformStream {
+    if (!nativeAddon.createTransformStream) {
+      // Silently passing data through would drop encryption, so refuse instead
+      throw new Error('Transform pipelines require the native streams addon');
+    }
+    
+    const { Transform } = require('stream');
+    let waiting: ((error?: Error | null) => void) | null = null;
+    let pipeline: NativeTransformPipeline;
+    
+    const stream = new Transform({
+      ...config,
+      transform(chunk: Buffer, _encoding: string, callback: (error?: Error | null) => void) {
+        try {
+          if (pipeline.write(chunk)) {
+            callback();
+          } else {
+            waiting = callback;
+          }
+        } catch (error) {
+          callback(error instanceof Error ? error : new Error('Transform pipeline write failed'));
+        }
+      },
+      flush(callback: (error?: Error | null) => void) {
+        try {
+          waiting = callback;
+          pipeline.end();
+        } catch (error) {
+          callback(error instanceof Error ? error : new Error('Transform pipeline flush failed'));
+        }
+      },
+      destroy(error: Error | null, callback: (error?: Error | null) => void) {
+        pipeline.destroy();
+        callback(error);
+      },
+    });
+    
+    const resume = (error?: Error) => {
+      const callback = waiting;
+      waiting = null;
+      callback?.(error);
+    };
+    
+    pipeline = nativeAddon.createTransformStream({
+      stages,
+      highWaterMark: backpressure.highWaterMark ?? config.highWaterMark,
+      lowWaterMark: backpressure.lowWaterMark,
+      maxQueuedBytes: backpressure.maxQueuedBytes,
+      onData: (chunk: Buffer) => stream.push(chunk),
+      onDrain: () => resume(),
+      onEnd: (summary: TransformPipelineSummary) => {
+        stream.emit('summary', summary);
+        resume();
+      },
+      onError: (error: Error) => (waiting ? resume(error) : stream.destroy(error)),
+    });
+    
+    stream.streamId = pipeline.streamId;
+    stream.iv = pipeline.iv;
+    this.pipelines.set(stream, pipeline);
+    return stream;
+  }
+
   private fallbackCreateEncryptedStream(config: EncryptedStreamConfig): EncryptedStream {
     const { Transform } = require('stream');
     const crypto = require('crypto');
@@ -532,21 +917,254 @@ export class EnhancedStreamsService {
     });
   }
 
-  private fallbackCreateCompressedStream(config: CompressedStreamConfig): CompressedStream {
+  // Algorithms the native build lacks (brotli, or zstd/lz4 built without
+  // their libraries) go through the zlib fallback
+  private supportsNativeCompression(algorithm: string): boolean {
+    return !!nativeAddon.createCompressedStream && (nativeAddon.getCompressionBackends?.() ?? []).includes(algorithm);
+  }
+
+  // One frame per stream: chunks go through update() as they arrive and the
+  // frame is closed in flush. Ratio and throughput are re-emitted as 'stats'.
+  private wrapNativeCompressedStream(codec: NativeCompressedStream, config: CompressedStreamConfig): CompressedStream {
     const { Transform } = require('stream');
-    const zlib = require('zlib');
     
-    return new Transform({
+    const stream = new Transform({
       ...config,
       transform(chunk: Buffer, _encoding: string, callback: (error?: Error | null, data?: Buffer) => void) {
         try {
-          const compressed = zlib.gzipSync(chunk);
-          callback(null, compressed);
+          callback(null, codec.update(chunk));
+        } catch (error) {
+          callback(error instanceof Error ? error : new Error('Compression failed'));
+        }
+      },
+      flush(callback: (error?: Error | null, data?: Buffer) => void) {
+        try {
+          const trailer = codec.final();
+          stream.emit('stats', codec.stats);
+          callback(null, trailer);
         } catch (error) {
           callback(error instanceof Error ? error : new Error('Compression failed'));
         }
       },
     });
+    
+    stream.streamId = codec.streamId;
+    stream.algorithm = codec.algorithm;
+    stream.level = config.compressionLevel;
+    stream.compressionConfig = config;
+    stream.codec = codec;
+    return stream;
+  }
+
+  // zstd dictionary from representative payloads, for many small documents
+  async trainCompressionDictionary(samples: Buffer[], maxSize?: number): Promise<Buffer> {
+    if (!nativeAddon.trainCompressionDictionary) {
+      throw new Error('Dictionary training requires the native streams addon');
+    }
+    return nativeAddon.trainCompressionDictionary(samples, maxSize);
+  }
+
+  private fallbackCreateCompressedStream(config: CompressedStreamConfig): CompressedStream {
+    const zlib = require('zlib');
+    const decompress = config.mode === 'decompress';
+    
+    switch (config.compressionAlgorithm) {
+      case 'brotli':
+        return decompress ? zlib.createBrotliDecompress() : zlib.createBrotliCompress();
+      case 'deflate':
+        return decompress ? zlib.createInflate() : zlib.createDeflate({ level: config.compressionLevel });
+      case 'gzip':
+        return decompress ? zlib.createGunzip() : zlib.createGzip({ level: config.compressionLevel });
+      default:
+        // zstd and lz4 output must not silently turn into gzip
+        throw new Error(`${config.compressionAlgorithm} compression requires the native streams addon`);
+    }
+  }
+
+  // Same GCRA as the native limiter, without sharing or eviction
+  private fallbackCreateRateLimiter(streamId: string, config: StreamRateLimiterConfig): NativeRateLimiter {
+    const interval = config.windowMs / config.maxRequests;
+    const burst = config.burst ?? config.maxRequests;
+    const tolerance = burst * interval;
+    const arrivals = new Map<string | number, number>();
+    let allowed = 0;
+    let denied = 0;
+    let retryAfter = 0;
+
+    const tryAcquire = (key: string | number, cost = 1): boolean => {
+      const now = Date.now();
+      const next = Math.max(arrivals.get(key) ?? 0, now) + cost * interval;
+      if (next - now > tolerance) {
+        retryAfter = Math.ceil(next - now - tolerance);
+        denied++;
+        return false;
+      }
+      arrivals.set(key, next);
+      allowed++;
+      return true;
+    };
+
+    return {
+      streamId,
+      maxRequests: config.maxRequests,
+      windowMs: config.windowMs,
+      burst,
+      get retryAfter() {
+        return retryAfter;
+      },
+      get stats() {
+        return { allowed, denied, keys: arrivals.size, evictions: 0, capacity: Infinity };
+      },
+      tryAcquire,
+      tryAcquireMany: (keys, cost = 1, out) => {
+        let granted = 0;
+        keys.forEach((key, i) => {
+          const ok = tryAcquire(key, cost);
+          granted += ok ? 1 : 0;
+          if (out) out[i] = ok ? 1 : 0;
+        });
+        return granted;
+      },
+      reset: (key) => {
+        arrivals.delete(key);
+      },
+    };
+  }
+
+  private requireNativeMux(mux: NativeFrameMux | undefined): NativeFrameMux {
+    if (!mux) {
+      // Peers speak the native frame format, so there is nothing to fall back to
+      throw new Error('Channel multiplexing requires the native streams addon');
+    }
+    return mux;
+  }
+
+  // Carry many channels over one transport Duplex: pipe the socket into it
+  // and it into the socket. Frames written during a tick leave as one flush.
+  // channel(id) (or the 'channel' event, for ones the peer opens) is a Duplex
+  // whose writes wait for the peer's credit; credit is granted back as its
+  // reader consumes data, so a slow channel never stalls the others.
+  private wrapNativeMux<T extends BaseStream>(mux: NativeFrameMux, config: StreamConfig): T {
+    const { Duplex } = require('stream');
+    const channels = new Map<number, { stream: any; received(payload: Uint8Array): void; resume(): void }>();
+    let flushing = false;
+    
+    const flush = () => {
+      flushing = false;
+      for (const buffer of mux.flush()) {
+        transport.push(buffer);
+      }
+    };
+    const scheduleFlush = () => {
+      if (!flushing && mux.pendingBytes > 0) {
+        flushing = true;
+        setImmediate(flush);
+      }
+    };
+    
+    const open = (id: number, remote: boolean) => {
+      const existing = channels.get(id);
+      if (existing) {
+        return existing;
+      }
+      
+      let waiting: ((error?: Error | null) => void) | null = null;
+      let unconsumed = 0;
+      const grant = () => {
+        if (unconsumed > 0) {
+          mux.consume(id, unconsumed);
+          unconsumed = 0;
+          scheduleFlush();
+        }
+      };
+      
+      const stream = new Duplex({
+        write(chunk: Buffer, _encoding: string, callback: (error?: Error | null) => void) {
+          try {
+            const sent = mux.write(id, chunk);
+            scheduleFlush();
+            if (sent) {
+              callback();
+            } else {
+              waiting = callback;
+            }
+          } catch (error) {
+            callback(error instanceof Error ? error : new Error('Channel write failed'));
+          }
+        },
+        final(callback: (error?: Error | null) => void) {
+          try {
+            mux.end(id);
+            scheduleFlush();
+            callback();
+          } catch (error) {
+            callback(error instanceof Error ? error : new Error('Channel end failed'));
+          }
+        },
+        read: grant,
+      });
+      
+      const state = {
+        stream,
+        received(payload: Uint8Array) {
+          unconsumed += payload.byteLength;
+          if (stream.push(Buffer.from(payload.buffer, payload.byteOffset, payload.byteLength))) {
+            grant();
+          }
+        },
+        resume() {
+          const callback = waiting;
+          waiting = null;
+          callback?.();
+        },
+      };
+      channels.set(id, state);
+      stream.once('close', () => channels.delete(id));
+      if (remote) {
+        transport.emit('channel', id, stream);
+      }
+      return state;
+    };
+    
+    const transport = new Duplex({
+      ...config,
+      write(chunk: Buffer, _encoding: string, callback: (error?: Error | null) => void) {
+        try {
+          const events = mux.receive(chunk);
+          for (let i = 0; i < events.length; i += 3) {
+            const state = open(events[i] as number, true);
+            switch (events[i + 1]) {
+              case 0:
+                state.received(events[i + 2] as Uint8Array);
+                break;
+              case 1:
+                state.resume();
+                break;
+              default:
+                state.stream.push(null);
+            }
+          }
+          scheduleFlush();
+          callback();
+        } catch (error) {
+          callback(error instanceof Error ? error : new Error('Malformed multiplexed frame'));
+        }
+      },
+      read() {},
+      destroy(error: Error | null, callback: (error?: Error | null) => void) {
+        for (const state of channels.values()) {
+          state.stream.destroy(error ?? undefined);
+        }
+        callback(error);
+      },
+    });
+    
+    transport.streamId = mux.streamId;
+    transport.maxStreams = mux.maxChannels;
+    transport.mux = mux;
+    transport.channel = (id: number) => open(id, false).stream;
+    Object.defineProperty(transport, 'subStreams', { get: () => [...channels.values()].map((state) => state.stream) });
+    return transport;
   }
 
   private fallbackCreateMultiplexedStream(config: MultiplexedStreamConfig): MultiplexedStream {
@@ -0,0 +1,179 @@
+#include "encrypted_stream.h"
+#include "performance_monitor.h"
+
+Napi::FunctionReference EncryptedStream::constructor;
+
+void EncryptedStream::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "EncryptedStream", {
+    InstanceMethod("update", &EncryptedStream::Update),
+    InstanceMethod("final", &EncryptedStream::Final),
+    InstanceMethod("getAuthTag", &EncryptedStream::GetAuthTag),
+    InstanceMethod("setAuthTag", &EncryptedStream::SetAuthTag),
+    InstanceAccessor("bytesProcessed", &EncryptedStream::GetBytesProcessed, nullptr),
+  });
+  
+  constructor = Napi::Persistent(func);
+  constructor.SuppressDestruct();
+  
+  exports.Set(Napi::String::New(env, "EncryptedStream"), func);
+}
+
+Napi::Object EncryptedStream::NewInstance(Napi::Env env, Napi::Object config) {
+  return constructor.New({ config });
+}
+
+// new EncryptedStream({ encryptionKey, encryptionAlgorithm, iv?, aad?, mode? })
+// mode is 'encrypt' (default) or 'decrypt'; an IV is generated when
+// encrypting without one and exposed as `iv` on the instance.
+EncryptedStream::EncryptedStream(const Napi::CallbackInfo& info)
+  : Napi::ObjectWrap<EncryptedStream>(info),
+    finalized_(false),
+    bytesProcessed_(0) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "Expected encrypted stream config").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  Napi::Object config = info[0].As<Napi::Object>();
+  std::string algorithm = config.Has("encryptionAlgorithm") && config.Get("encryptionAlgorithm").IsString()
+    ? config.Get("encryptionAlgorithm").As<Napi::String>().Utf8Value() : "aes-256-gcm";
+  bool decrypt = config.Has("mode") && config.Get("mode").IsString() &&
+                 config.Get("mode").As<Napi::String>().Utf8Value() == "decrypt";
+  
+  Napi::Value keyValue = config.Get("encryptionKey");
+  if (!keyValue.IsBuffer()) {
+    Napi::TypeError::New(env, "encryptionKey must be a Buffer").ThrowAsJavaScriptException();
+    return;
+  }
+  Napi::Buffer<unsigned char> key = keyValue.As<Napi::Buffer<unsigned char>>();
+  
+  Napi::Value ivValue = config.Get("iv");
+  Napi::Buffer<unsigned char> iv;
+  if (ivValue.IsBuffer()) {
+    iv = ivValue.As<Napi::Buffer<unsigned char>>();
+  }
+  
+  std::string error;
+  if (!cipher_.Init(algorithm, decrypt, key.Data(), key.Length(),
+                    ivValue.IsBuffer() ? iv.Data() : nullptr, ivValue.IsBuffer() ? iv.Length() : 0, error)) {
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return;
+  }
+  
+  Napi::Value aadValue = config.Get("aad");
+  if (aadValue.IsBuffer()) {
+    Napi::Buffer<unsigned char> aad = aadValue.As<Napi::Buffer<unsigned char>>();
+    if (!cipher_.SetAad(aad.Data(), aad.Length(), error)) {
+      Napi::Error::New(env, error).ThrowAsJavaScriptException();
+      return;
+    }
+  }
+  
+  Value().Set("iv", ivValue.IsBuffer() ? iv : Napi::Buffer<unsigned char>::Copy(env, cipher_.Iv(), GcmCipher::kIvLength));
+  Value().Set("mode", Napi::String::New(env, decrypt ? "decrypt" : "encrypt"));
+}
+
+bool EncryptedStream::CheckActive(Napi::Env env) const {
+  if (!cipher_.Initialized() || finalized_) {
+    Napi::Error::New(env, "Encrypted stream has already been finalized").ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+Napi::Value EncryptedStream::Update(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (!CheckActive(env)) {
+    return env.Null();
+  }
+  
+  if (info.Length() < 1 || !info[0].IsBuffer()) {
+    Napi::TypeError::New(env, "Expected chunk buffer").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  Napi::Buffer<unsigned char> chunk = info[0].As<Napi::Buffer<unsigned char>>();
+  Napi::Buffer<unsigned char> output = Napi::Buffer<unsigned char>::New(env, chunk.Length());
+  
+  std::string error;
+  if (!cipher_.Update(chunk.Data(), chunk.Length(), output.Data(), error)) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  bytesProcessed_ += chunk.Length();
+  return output;
+}
+
+Napi::Value EncryptedStream::Final(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (!CheckActive(env)) {
+    return env.Null();
+  }
+  
+  if (cipher_.Decrypting() && !cipher_.HasTag()) {
+    Napi::Error::New(env, "Authentication tag must be set before final()").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  static const uint32_t kFinalMetric = PerformanceMonitor::GetInstance().RegisterOperation("EncryptedStream.final");
+  OperationSpan span(kFinalMetric);
+  
+  std::string error;
+  bool ok = cipher_.Final(error);
+  finalized_ = true;
+  span.End(ok);
+  
+  if (!ok) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  return Napi::Buffer<unsigned char>::New(env, 0);
+}
+
+Napi::Value EncryptedStream::GetAuthTag(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (cipher_.Decrypting() || !finalized_ || !cipher_.HasTag()) {
+    Napi::Error::New(env, "Authentication tag is only available after final() when encrypting").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  return Napi::Buffer<unsigned char>::Copy(env, cipher_.Tag(), GcmCipher::kTagLength);
+}
+
+Napi::Value EncryptedStream::SetAuthTag(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (!CheckActive(env)) {
+    return env.Null();
+  }
+  
+  if (!cipher_.Decrypting()) {
+    Napi::Error::New(env, "setAuthTag is only valid when decrypting").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  if (info.Length() < 1 || !info[0].IsBuffer() || info[0].As<Napi::Buffer<unsigned char>>().Length() != 16) {
+    Napi::TypeError::New(env, "Tag must be a 16-byte Buffer").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  Napi::Buffer<unsigned char> tag = info[0].As<Napi::Buffer<unsigned char>>();
+  std::string error;
+  if (!cipher_.SetTag(tag.Data(), tag.Length(), error)) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  return env.Undefined();
+}
+
+Napi::Value EncryptedStream::GetBytesProcessed(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(bytesProcessed_));
+}
@@ -0,0 +1,39 @@
+#ifndef ENCRYPTED_STREAM_H
+#define ENCRYPTED_STREAM_H
+
+#include <napi.h>
+#include <string>
+#include "gcm_cipher.h"
+
+// Native AES-GCM cipher behind createEncryptedStream. One GcmCipher is
+// kept alive for the life of the stream so chunks are processed incrementally
+// and memory stays constant regardless of payload size.
+//
+//   update(chunk) -> Buffer   same length as chunk
+//   final()       -> Buffer   empty; authenticates when decrypting
+//   getAuthTag()  -> Buffer   encrypt only, after final()
+//   setAuthTag(t)             decrypt only, before final()
+class EncryptedStream : public Napi::ObjectWrap<EncryptedStream> {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(Napi::Env env, Napi::Object config);
+
+  EncryptedStream(const Napi::CallbackInfo& info);
+
+private:
+  static Napi::FunctionReference constructor;
+
+  Napi::Value Update(const Napi::CallbackInfo& info);
+  Napi::Value Final(const Napi::CallbackInfo& info);
+  Napi::Value GetAuthTag(const Napi::CallbackInfo& info);
+  Napi::Value SetAuthTag(const Napi::CallbackInfo& info);
+  Napi::Value GetBytesProcessed(const Napi::CallbackInfo& info);
+
+  bool CheckActive(Napi::Env env) const;
+
+  GcmCipher cipher_;
+  bool finalized_;
+  size_t bytesProcessed_;
+};
+
+#endif // ENCRYPTED_STREAM_H
@@ -1,30 +1,46 @@
 #include "flow_control.h"
 #include "performance_monitor.h"
+#include "rate_limiter.h"
+#include "circuit_breaker.h"
+#include "transform_pipeline.h"
 #include <iomanip>
 #include <sstream>
+#include <cstring>
+#include <cstdint>
 
 // Flow control operations
 Napi::Value EnableBackpressure(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("EnableBackpressure");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("EnableBackpressure");
+  OperationSpan span(kMetric);
   
   try {
-    std::string streamId = info[0].As<Napi::String>().Utf8Value();
+    // Watermarks live on the native pipeline itself
+    TransformPipeline* pipeline = info.Length() > 0 ? TransformPipeline::FromValue(info[0]) : nullptr;
+    if (!pipeline || info.Length() < 2 || !info[1].IsObject()) {
+      span.End(false);
+      Napi::TypeError::New(env, "Expected a native transform pipeline and backpressure config").ThrowAsJavaScriptException();
+      return env.Null();
+    }
     Napi::Object config = info[1].As<Napi::Object>();
+    if (!pipeline->SetBackpressure(env, config)) {
+      span.End(false);
+      return env.Null();
+    }
     
-    // Create backpressure result
+    Napi::Object stats = info[0].As<Napi::Object>().Get("stats").As<Napi::Object>();
     Napi::Object result = Napi::Object::New(env);
     result.Set("success", Napi::Boolean::New(env, true));
-    result.Set("streamId", Napi::String::New(env, streamId));
+    result.Set("streamId", info[0].As<Napi::Object>().Get("streamId"));
     result.Set("backpressureEnabled", Napi::Boolean::New(env, true));
-    result.Set("highWaterMark", config.Get("highWaterMark"));
-    result.Set("lowWaterMark", config.Get("lowWaterMark"));
+    result.Set("highWaterMark", stats.Get("highWaterMark"));
+    result.Set("lowWaterMark", stats.Get("lowWaterMark"));
     
-    PerformanceMonitor::GetInstance().EndOperation("EnableBackpressure");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("EnableBackpressure");
+    span.End(false);
     Napi::Error::New(env, "Failed to enable backpressure: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -32,25 +48,30 @@ Napi::Value EnableBackpressure(const Napi::CallbackInfo& info) {
 
 Napi::Value EnableRateLimiting(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("EnableRateLimiting");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("EnableRateLimiting");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
     Napi::Object config = info[1].As<Napi::Object>();
     
-    // Create rate limiting result
-    Napi::Object result = Napi::Object::New(env);
+    // The limiter itself is the result; it throws on invalid limits
+    Napi::Object result = RateLimiter::NewInstance(env, config);
+    if (env.IsExceptionPending()) {
+      span.End(false);
+      return env.Null();
+    }
     result.Set("success", Napi::Boolean::New(env, true));
     result.Set("streamId", Napi::String::New(env, streamId));
     result.Set("rateLimitingEnabled", Napi::Boolean::New(env, true));
     result.Set("maxRequests", config.Get("maxRequests"));
     result.Set("windowMs", config.Get("windowMs"));
     
-    PerformanceMonitor::GetInstance().EndOperation("EnableRateLimiting");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("EnableRateLimiting");
+    span.End(false);
     Napi::Error::New(env, "Failed to enable rate limiting: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -58,25 +79,30 @@ Napi::Value EnableRateLimiting(const Napi::CallbackInfo& info) {
 
 Napi::Value EnableCircuitBreaker(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("EnableCircuitBreaker");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("EnableCircuitBreaker");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
     Napi::Object config = info[1].As<Napi::Object>();
     
-    // Create circuit breaker result
-    Napi::Object result = Napi::Object::New(env);
+    // The breaker itself is the result; it throws on invalid thresholds
+    Napi::Object result = CircuitBreaker::NewInstance(env, config);
+    if (env.IsExceptionPending()) {
+      span.End(false);
+      return env.Null();
+    }
     result.Set("success", Napi::Boolean::New(env, true));
     result.Set("streamId", Napi::String::New(env, streamId));
     result.Set("circuitBreakerEnabled", Napi::Boolean::New(env, true));
     result.Set("failureThreshold", config.Get("failureThreshold"));
     result.Set("recoveryTimeout", config.Get("recoveryTimeout"));
     
-    PerformanceMonitor::GetInstance().EndOperation("EnableCircuitBreaker");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("EnableCircuitBreaker");
+    span.End(false);
     Napi::Error::New(env, "Failed to enable circuit breaker: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -85,7 +111,8 @@ Napi::Value EnableCircuitBreaker(const Napi::CallbackInfo& info) {
 // Monitoring operations
 Napi::Value StartMonitoring(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("StartMonitoring");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("StartMonitoring");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -97,11 +124,11 @@ Napi::Value StartMonitoring(const Napi::CallbackInfo& info) {
     result.Set("monitoringEnabled", Napi::Boolean::New(env, true));
     result.Set("startedAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("StartMonitoring");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("StartMonitoring");
+    span.End(false);
     Napi::Error::New(env, "Failed to start monitoring: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -109,7 +136,8 @@ Napi::Value StartMonitoring(const Napi::CallbackInfo& info) {
 
 Napi::Value StopMonitoring(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("StopMonitoring");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("StopMonitoring");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -121,11 +149,11 @@ Napi::Value StopMonitoring(const Napi::CallbackInfo& info) {
     result.Set("monitoringEnabled", Napi::Boolean::New(env, false));
     result.Set("stoppedAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("StopMonitoring");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("StopMonitoring");
+    span.End(false);
     Napi::Error::New(env, "Failed to stop monitoring: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -133,7 +161,8 @@ Napi::Value StopMonitoring(const Napi::CallbackInfo& info) {
 
 Napi::Value GetMetrics(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("GetMetrics");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("GetMetrics");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -153,11 +182,11 @@ Napi::Value GetMetrics(const Napi::CallbackInfo& info) {
     result.Set("successRate", Napi::Number::New(env, 100.0));
     result.Set("timestamp", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("GetMetrics");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("GetMetrics");
+    span.End(false);
     Napi::Error::New(env, "Failed to get metrics: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -165,7 +194,8 @@ Napi::Value GetMetrics(const Napi::CallbackInfo& info) {
 
 Napi::Value GetHealthCheck(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("GetHealthCheck");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("GetHealthCheck");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -197,16 +227,74 @@ Napi::Value GetHealthCheck(const Napi::CallbackInfo& info) {
     
     result.Set("checks", checks);
     
-    PerformanceMonitor::GetInstance().EndOperation("GetHealthCheck");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("GetHealthCheck");
+    span.End(false);
     Napi::Error::New(env, "Failed to get health check: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
 }
 
+// exportMetrics(format | { format, target, full }), format 'openmetrics'
+// (default) or 'snapshot'. Scraping is not timed itself so a scrape never
+// shows up in the next one. With a target Buffer the output is written into
+// it and the byte count is returned; if it does not fit nothing is written
+// and a snapshot is not consumed, so the caller can grow the buffer and retry.
+Napi::Value ExportMetrics(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  std::string format = "openmetrics";
+  bool full = false;
+  Napi::Value target = env.Undefined();
+  if (info.Length() > 0 && info[0].IsString()) {
+    format = info[0].As<Napi::String>().Utf8Value();
+  } else if (info.Length() > 0 && info[0].IsObject()) {
+    Napi::Object options = info[0].As<Napi::Object>();
+    if (options.Has("format") && options.Get("format").IsString()) {
+      format = options.Get("format").As<Napi::String>().Utf8Value();
+    }
+    if (options.Has("full") && options.Get("full").IsBoolean()) {
+      full = options.Get("full").As<Napi::Boolean>().Value();
+    }
+    if (options.Has("target")) {
+      target = options.Get("target");
+    }
+  }
+  
+  if (!target.IsUndefined() && !target.IsBuffer()) {
+    Napi::TypeError::New(env, "target must be a Buffer").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (format != "openmetrics" && format != "snapshot") {
+    Napi::TypeError::New(env, "Unknown export format: " + format).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  // Per thread, so worker_threads scraping in parallel don't share a buffer,
+  // and kept between calls so their capacity is reused
+  thread_local std::string buffer;
+  size_t limit = target.IsBuffer() ? target.As<Napi::Buffer<uint8_t>>().Length() : SIZE_MAX;
+  
+  if (format == "openmetrics") {
+    PerformanceMonitor::GetInstance().RenderOpenMetrics(buffer);
+  } else {
+    PerformanceMonitor::GetInstance().EncodeSnapshot(buffer, full, limit);
+  }
+  
+  if (target.IsBuffer()) {
+    if (buffer.size() <= limit) {
+      std::memcpy(target.As<Napi::Buffer<uint8_t>>().Data(), buffer.data(), buffer.size());
+    }
+    return Napi::Number::New(env, static_cast<double>(buffer.size()));
+  }
+  if (format == "openmetrics") {
+    return Napi::String::New(env, buffer);
+  }
+  return Napi::Buffer<uint8_t>::Copy(env, reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size());
+}
+
 // Helper functions
 std::string GetCurrentTimestamp() {
   auto now = std::chrono::system_clock::now();
@@ -17,6 +17,7 @@ Napi::Value StartMonitoring(const Napi::CallbackInfo& info);
 Napi::Value StopMonitoring(const Napi::CallbackInfo& info);
 Napi::Value GetMetrics(const Napi::CallbackInfo& info);
 Napi::Value GetHealthCheck(const Napi::CallbackInfo& info);
+Napi::Value ExportMetrics(const Napi::CallbackInfo& info);
 
 // Helper functions
 std::string GetCurrentTimestamp();
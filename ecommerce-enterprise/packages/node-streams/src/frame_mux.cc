@@ -0,0 +1,586 @@
+#include "frame_mux.h"
+#include "performance_monitor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const uint64_t kDefaultInitialWindow = 256 * 1024;
+const uint64_t kDefaultMaxFrameSize = 64 * 1024;
+const uint64_t kMaxFrameSizeLimit = 16 * 1024 * 1024;
+const size_t kDefaultMaxChannels = 1024;
+const size_t kDefaultZeroCopyThreshold = 8 * 1024;
+const size_t kSegmentReserve = 16 * 1024;
+const size_t kMaxHeaderSize = 20;       // two 10-byte varints
+const double kMaxChannelId = 9007199254740991.0;  // channels travel as JS numbers
+
+inline void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+// 1 with value and its size, 0 if more bytes are needed, -1 if malformed
+inline int GetVarint(const uint8_t* data, size_t length, uint64_t& value, size_t& size) {
+  value = 0;
+  for (size_t i = 0; i < length && i < 10; i++) {
+    value |= static_cast<uint64_t>(data[i] & 0x7F) << (7 * i);
+    if (!(data[i] & 0x80)) {
+      size = i + 1;
+      return 1;
+    }
+  }
+  return length >= 10 ? -1 : 0;
+}
+
+int ParseHeader(const uint8_t* data, size_t length, FrameHeader& header) {
+  uint64_t tag;
+  size_t tagSize;
+  int status = GetVarint(data, length, tag, tagSize);
+  if (status <= 0) {
+    return status;
+  }
+  size_t lengthSize;
+  status = GetVarint(data + tagSize, length - tagSize, header.length, lengthSize);
+  if (status <= 0) {
+    return status;
+  }
+  if ((tag & 3) > static_cast<uint64_t>(FrameType::kEnd)) {
+    return -1;
+  }
+  header.channel = tag >> 2;
+  header.type = static_cast<FrameType>(tag & 3);
+  header.size = tagSize + lengthSize;
+  return 1;
+}
+
+inline size_t FrameSize(const FrameHeader& header) {
+  return header.size + (header.type == FrameType::kData ? static_cast<size_t>(header.length) : 0);
+}
+
+bool ReadChannel(Napi::Env env, Napi::Value value, uint64_t& channel) {
+  double number = value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : -1;
+  if (!(number >= 0 && number <= kMaxChannelId) || std::floor(number) != number) {
+    Napi::TypeError::New(env, "Channel must be a non-negative integer").ThrowAsJavaScriptException();
+    return false;
+  }
+  channel = static_cast<uint64_t>(number);
+  return true;
+}
+
+// Config sizes, within [minimum, maximum], or fallback when unset
+bool ReadSize(Napi::Env env, Napi::Object config, const char* name, double minimum, double maximum,
+              uint64_t fallback, uint64_t& value) {
+  Napi::Value setting = config.Get(name);
+  if (!setting.IsNumber()) {
+    value = fallback;
+    return true;
+  }
+  double number = setting.As<Napi::Number>().DoubleValue();
+  if (!(number >= minimum && number <= maximum)) {
+    Napi::RangeError::New(env, std::string(name) + " must be between " + std::to_string(static_cast<uint64_t>(minimum)) +
+                          " and " + std::to_string(static_cast<uint64_t>(maximum))).ThrowAsJavaScriptException();
+    return false;
+  }
+  value = static_cast<uint64_t>(number);
+  return true;
+}
+
+} // namespace
+
+Napi::FunctionReference FrameMux::constructor;
+
+void FrameMux::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "FrameMux", {
+    InstanceMethod("write", &FrameMux::Write),
+    InstanceMethod("end", &FrameMux::End),
+    InstanceMethod("consume", &FrameMux::Consume),
+    InstanceMethod("flush", &FrameMux::Flush),
+    InstanceMethod("receive", &FrameMux::Receive),
+    InstanceAccessor("pendingBytes", &FrameMux::GetPendingBytes, nullptr),
+    InstanceAccessor("stats", &FrameMux::GetStats, nullptr),
+  });
+  
+  constructor = Napi::Persistent(func);
+  constructor.SuppressDestruct();
+  
+  exports.Set(Napi::String::New(env, "FrameMux"), func);
+}
+
+Napi::Object FrameMux::NewInstance(Napi::Env env, Napi::Object config) {
+  return constructor.New({ config });
+}
+
+FrameMux::FrameMux(const Napi::CallbackInfo& info)
+  : Napi::ObjectWrap<FrameMux>(info),
+    initialWindow_(kDefaultInitialWindow),
+    maxFrameSize_(kDefaultMaxFrameSize),
+    maxChannels_(kDefaultMaxChannels),
+    zeroCopyThreshold_(kDefaultZeroCopyThreshold),
+    pendingBytes_(0),
+    queuedBytes_(0),
+    framesIn_(0),
+    framesOut_(0),
+    bytesIn_(0),
+    bytesOut_(0),
+    flushes_(0) {
+  Napi::Env env = info.Env();
+  
+  Napi::Object config = info.Length() > 0 && info[0].IsObject() ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+  // maxStreams is the name MultiplexedStreamConfig already uses
+  Napi::Value maxStreams = config.Get("maxStreams");
+  uint64_t maxChannels;
+  uint64_t zeroCopyThreshold;
+  if (!ReadSize(env, config, "initialWindow", 1, 4294967295.0, kDefaultInitialWindow, initialWindow_) ||
+      !ReadSize(env, config, "maxFrameSize", 1, kMaxFrameSizeLimit, kDefaultMaxFrameSize, maxFrameSize_) ||
+      !ReadSize(env, config, config.Get("maxChannels").IsNumber() || !maxStreams.IsNumber() ? "maxChannels" : "maxStreams",
+                1, 1 << 24, kDefaultMaxChannels, maxChannels) ||
+      !ReadSize(env, config, "zeroCopyThreshold", 0, kMaxFrameSizeLimit, kDefaultZeroCopyThreshold, zeroCopyThreshold)) {
+    return;
+  }
+  maxChannels_ = static_cast<size_t>(maxChannels);
+  zeroCopyThreshold_ = static_cast<size_t>(zeroCopyThreshold);
+  
+  Napi::Object self = Value();
+  self.Set("initialWindow", Napi::Number::New(env, static_cast<double>(initialWindow_)));
+  self.Set("maxFrameSize", Napi::Number::New(env, static_cast<double>(maxFrameSize_)));
+  self.Set("maxChannels", Napi::Number::New(env, static_cast<double>(maxChannels_)));
+}
+
+MuxChannel* FrameMux::Open(Napi::Env env, uint64_t id) {
+  auto found = channels_.find(id);
+  if (found != channels_.end()) {
+    return &found->second;
+  }
+  if (channels_.size() >= maxChannels_) {
+    Napi::RangeError::New(env, "More than maxChannels (" + std::to_string(maxChannels_) + ") channels are open")
+      .ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  return &channels_.emplace(id, MuxChannel(initialWindow_)).first->second;
+}
+
+// Both directions are closed; forget the channel so the table stays small,
+// but remember the id so late frames cannot bring it back
+void FrameMux::Retire(uint64_t id, MuxChannel& channel) {
+  if (!channel.sentEnd || !channel.receivedEnd) {
+    return;
+  }
+  channels_.erase(id);
+  
+  auto next = retired_.upper_bound(id);
+  if (next != retired_.begin()) {
+    auto previous = std::prev(next);
+    if (previous->second + 1 == id) {
+      previous->second = id;
+      if (next != retired_.end() && next->first == id + 1) {
+        previous->second = next->second;
+        retired_.erase(next);
+      }
+      return;
+    }
+  }
+  if (next != retired_.end() && next->first == id + 1) {
+    uint64_t last = next->second;
+    retired_.erase(next);
+    retired_.emplace(id, last);
+    return;
+  }
+  retired_.emplace(id, id);
+}
+
+bool FrameMux::IsRetired(uint64_t id) const {
+  auto next = retired_.upper_bound(id);
+  return next != retired_.begin() && id <= std::prev(next)->second;
+}
+
+std::vector<uint8_t>& FrameMux::Tail() {
+  if (output_.empty() || !output_.back().bytes) {
+    Segment segment;
+    segment.bytes.reset(new std::vector<uint8_t>());
+    segment.bytes->reserve(kSegmentReserve);
+    output_.push_back(std::move(segment));
+  }
+  return *output_.back().bytes;
+}
+
+void FrameMux::EmitHeader(FrameType type, uint64_t channel, uint64_t length) {
+  std::vector<uint8_t>& out = Tail();
+  size_t before = out.size();
+  PutVarint(out, (channel << 2) | static_cast<uint64_t>(type));
+  PutVarint(out, length);
+  pendingBytes_ += out.size() - before;
+  framesOut_++;
+}
+
+void FrameMux::EmitData(uint64_t channel, const uint8_t* data, size_t length) {
+  while (length > 0) {
+    size_t frame = static_cast<size_t>(std::min<uint64_t>(length, maxFrameSize_));
+    EmitHeader(FrameType::kData, channel, frame);
+    std::vector<uint8_t>& out = Tail();
+    out.insert(out.end(), data, data + frame);
+    pendingBytes_ += frame;
+    data += frame;
+    length -= frame;
+  }
+}
+
+bool FrameMux::SendQueued(uint64_t id, MuxChannel& channel) {
+  size_t waiting = channel.queued.size() - channel.queuedOffset;
+  size_t sending = static_cast<size_t>(std::min<uint64_t>(waiting, channel.sendCredit));
+  EmitData(id, reinterpret_cast<const uint8_t*>(channel.queued.data()) + channel.queuedOffset, sending);
+  channel.sendCredit -= sending;
+  channel.queuedOffset += sending;
+  queuedBytes_ -= sending;
+  
+  if (channel.queuedOffset < channel.queued.size()) {
+    // Compact once the sent prefix dominates
+    if (channel.queuedOffset > channel.queued.size() / 2) {
+      channel.queued.erase(0, channel.queuedOffset);
+      channel.queuedOffset = 0;
+    }
+    return false;
+  }
+  
+  std::string().swap(channel.queued);
+  channel.queuedOffset = 0;
+  if (channel.endQueued) {
+    channel.endQueued = false;
+    channel.sentEnd = true;
+    EmitHeader(FrameType::kEnd, id, 0);
+  }
+  return true;
+}
+
+// write(channel, chunk) frames what the channel's credit allows and queues
+// the rest; false means wait for the channel's drain event
+Napi::Value FrameMux::Write(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  uint64_t id;
+  if (info.Length() < 2 || !ReadChannel(env, info[0], id)) {
+    if (!env.IsExceptionPending()) {
+      Napi::TypeError::New(env, "Expected channel and chunk").ThrowAsJavaScriptException();
+    }
+    return env.Null();
+  }
+  if (!info[1].IsBuffer()) {
+    Napi::TypeError::New(env, "Expected chunk buffer").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  if (IsRetired(id)) {
+    Napi::Error::New(env, "write after end on channel " + std::to_string(id)).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  MuxChannel* channel = Open(env, id);
+  if (!channel) {
+    return env.Null();
+  }
+  if (channel->sentEnd || channel->endQueued) {
+    Napi::Error::New(env, "write after end on channel " + std::to_string(id)).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  Napi::Buffer<uint8_t> buffer = info[1].As<Napi::Buffer<uint8_t>>();
+  const uint8_t* data = buffer.Data();
+  size_t length = buffer.Length();
+  
+  // Keep order behind data that is already waiting for credit
+  if (channel->queued.size() > channel->queuedOffset) {
+    channel->queued.append(reinterpret_cast<const char*>(data), length);
+    queuedBytes_ += length;
+    return Napi::Boolean::New(env, false);
+  }
+  
+  size_t sending = static_cast<size_t>(std::min<uint64_t>(length, channel->sendCredit));
+  if (sending == length && length >= zeroCopyThreshold_ && length <= maxFrameSize_ && length > 0) {
+    // Big enough to be worth its own iovec: pass the caller's Buffer through
+    EmitHeader(FrameType::kData, id, length);
+    Segment segment;
+    segment.buffer = Napi::Persistent(buffer);
+    output_.push_back(std::move(segment));
+    pendingBytes_ += length;
+  } else {
+    EmitData(id, data, sending);
+  }
+  channel->sendCredit -= sending;
+  
+  if (sending < length) {
+    channel->queued.append(reinterpret_cast<const char*>(data) + sending, length - sending);
+    queuedBytes_ += length - sending;
+    return Napi::Boolean::New(env, false);
+  }
+  return Napi::Boolean::New(env, true);
+}
+
+// end(channel) closes our direction once queued data has been sent
+Napi::Value FrameMux::End(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  uint64_t id;
+  if (info.Length() < 1 || !ReadChannel(env, info[0], id)) {
+    return env.Null();
+  }
+  if (IsRetired(id)) {
+    return env.Undefined();
+  }
+  MuxChannel* channel = Open(env, id);
+  if (!channel) {
+    return env.Null();
+  }
+  if (channel->sentEnd || channel->endQueued) {
+    return env.Undefined();
+  }
+  
+  if (channel->queued.size() > channel->queuedOffset) {
+    channel->endQueued = true;
+  } else {
+    channel->sentEnd = true;
+    EmitHeader(FrameType::kEnd, id, 0);
+    Retire(id, *channel);
+  }
+  return env.Undefined();
+}
+
+// consume(channel, bytes): the application has taken bytes off the channel.
+// Credit goes back in batches of half a window, not one frame per read.
+Napi::Value FrameMux::Consume(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  uint64_t id;
+  if (info.Length() < 2 || !ReadChannel(env, info[0], id) || !info[1].IsNumber()) {
+    if (!env.IsExceptionPending()) {
+      Napi::TypeError::New(env, "Expected channel and byte count").ThrowAsJavaScriptException();
+    }
+    return env.Null();
+  }
+  
+  auto found = channels_.find(id);
+  if (found == channels_.end() || found->second.receivedEnd) {
+    return env.Undefined();
+  }
+  MuxChannel& channel = found->second;
+  
+  // Never grant more than has actually been received
+  double bytes = std::max(0.0, info[1].As<Napi::Number>().DoubleValue());
+  uint64_t outstanding = initialWindow_ - channel.receiveWindow - channel.ungranted;
+  channel.ungranted += std::min<uint64_t>(outstanding, static_cast<uint64_t>(bytes));
+  
+  if (channel.ungranted > 0 && channel.ungranted >= initialWindow_ / 2) {
+    EmitHeader(FrameType::kCredit, id, channel.ungranted);
+    channel.receiveWindow += channel.ungranted;
+    channel.ungranted = 0;
+  }
+  return env.Undefined();
+}
+
+// flush() -> Buffer[]: one Buffer per run of small frames, plus passed-through
+// payloads; hand them to socket.cork() / write() / uncork() for one writev
+Napi::Value FrameMux::Flush(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("FrameMux.flush");
+  OperationSpan span(kMetric);
+  
+  Napi::Array result = Napi::Array::New(env, output_.size());
+  uint32_t index = 0;
+  for (Segment& segment : output_) {
+    if (segment.bytes) {
+      if (segment.bytes->empty()) {
+        continue;
+      }
+      // The Buffer takes over the vector's storage
+      std::vector<uint8_t>* bytes = segment.bytes.release();
+      result.Set(index++, Napi::Buffer<uint8_t>::New(
+        env, bytes->data(), bytes->size(),
+        [](Napi::Env, uint8_t*, std::vector<uint8_t>* owned) { delete owned; }, bytes));
+    } else {
+      result.Set(index++, segment.buffer.Value());
+      segment.buffer.Reset();
+    }
+  }
+  output_.clear();
+  
+  PerformanceMonitor::GetInstance().RecordBytes(kMetric, pendingBytes_, pendingBytes_);
+  bytesOut_ += pendingBytes_;
+  pendingBytes_ = 0;
+  flushes_++;
+  span.End();
+  return result;
+}
+
+bool FrameMux::Dispatch(Napi::Env env, const FrameHeader& header, Napi::Value payload,
+                        Napi::Array& events, uint32_t& count) {
+  framesIn_++;
+  uint64_t id = header.channel;
+  
+  MuxChannel* channel;
+  auto found = channels_.find(id);
+  if (found != channels_.end()) {
+    channel = &found->second;
+  } else if (header.type == FrameType::kCredit) {
+    // Credit for a channel we have retired (or never had) grants nothing
+    return true;
+  } else if (IsRetired(id)) {
+    Napi::Error::New(env, (header.type == FrameType::kData ? "DATA after END on channel " : "Invalid END frame on channel ") +
+                     std::to_string(id)).ThrowAsJavaScriptException();
+    return false;
+  } else if (!(channel = Open(env, id))) {
+    return false;
+  }
+  
+  switch (header.type) {
+    case FrameType::kData:
+      if (channel->receivedEnd) {
+        Napi::Error::New(env, "DATA after END on channel " + std::to_string(id)).ThrowAsJavaScriptException();
+        return false;
+      }
+      if (header.length > channel->receiveWindow) {
+        Napi::Error::New(env, "Channel " + std::to_string(id) + " exceeded its flow-control window")
+          .ThrowAsJavaScriptException();
+        return false;
+      }
+      channel->receiveWindow -= header.length;
+      events.Set(count++, Napi::Number::New(env, static_cast<double>(id)));
+      events.Set(count++, Napi::Number::New(env, 0));
+      events.Set(count++, payload);
+      return true;
+    
+    case FrameType::kCredit:
+      channel->sendCredit += header.length;
+      if (channel->queued.size() > channel->queuedOffset && SendQueued(id, *channel)) {
+        events.Set(count++, Napi::Number::New(env, static_cast<double>(id)));
+        events.Set(count++, Napi::Number::New(env, 1));
+        events.Set(count++, env.Undefined());
+        Retire(id, *channel);
+      }
+      return true;
+    
+    case FrameType::kEnd:
+      if (header.length != 0 || channel->receivedEnd) {
+        Napi::Error::New(env, "Invalid END frame on channel " + std::to_string(id)).ThrowAsJavaScriptException();
+        return false;
+      }
+      channel->receivedEnd = true;
+      events.Set(count++, Napi::Number::New(env, static_cast<double>(id)));
+      events.Set(count++, Napi::Number::New(env, 2));
+      events.Set(count++, env.Undefined());
+      Retire(id, *channel);
+      return true;
+  }
+  return true;
+}
+
+// receive(chunk) parses every complete frame in chunk. Credit frames are
+// handled here and may leave output for flush().
+Napi::Value FrameMux::Receive(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("FrameMux.receive");
+  OperationSpan span(kMetric);
+  
+  if (info.Length() < 1 || !info[0].IsBuffer()) {
+    span.End(false);
+    Napi::TypeError::New(env, "Expected chunk buffer").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  Napi::Buffer<uint8_t> chunk = info[0].As<Napi::Buffer<uint8_t>>();
+  const uint8_t* data = chunk.Data();
+  size_t length = chunk.Length();
+  size_t offset = 0;
+  bytesIn_ += length;
+  
+  Napi::Array events = Napi::Array::New(env);
+  uint32_t count = 0;
+  FrameHeader header;
+  
+  auto fail = [&](const std::string& message) -> Napi::Value {
+    span.End(false);
+    if (!env.IsExceptionPending()) {
+      Napi::Error::New(env, message).ThrowAsJavaScriptException();
+    }
+    carry_.clear();
+    return env.Null();
+  };
+  
+  // Finish a frame that started in an earlier chunk; it is copied out
+  while (!carry_.empty()) {
+    int status = ParseHeader(carry_.data(), carry_.size(), header);
+    if (status < 0 || (status == 1 && header.type == FrameType::kData && header.length > maxFrameSize_)) {
+      return fail("Malformed frame");
+    }
+    size_t needed = status == 1 ? FrameSize(header) : kMaxHeaderSize;
+    if (carry_.size() < needed) {
+      if (offset == length) {
+        span.End();
+        return events;
+      }
+      size_t taking = std::min(needed - carry_.size(), length - offset);
+      carry_.insert(carry_.end(), data + offset, data + offset + taking);
+      offset += taking;
+      continue;
+    }
+    
+    Napi::Value payload = header.type == FrameType::kData
+      ? Napi::Buffer<uint8_t>::Copy(env, carry_.data() + header.size, static_cast<size_t>(header.length))
+      : env.Undefined();
+    if (!Dispatch(env, header, payload, events, count)) {
+      return fail("");
+    }
+    // Header probing may have pulled in the start of the next frame
+    carry_.erase(carry_.begin(), carry_.begin() + needed);
+  }
+  
+  // Frames wholly inside this chunk are views, not copies
+  Napi::ArrayBuffer backing = chunk.ArrayBuffer();
+  size_t base = chunk.ByteOffset();
+  while (offset < length) {
+    int status = ParseHeader(data + offset, length - offset, header);
+    if (status < 0 || (status == 1 && header.type == FrameType::kData && header.length > maxFrameSize_)) {
+      return fail("Malformed frame");
+    }
+    if (status == 0 || FrameSize(header) > length - offset) {
+      carry_.assign(data + offset, data + length);
+      break;
+    }
+    
+    Napi::Value payload = header.type == FrameType::kData
+      ? Napi::Uint8Array::New(env, static_cast<size_t>(header.length), backing, base + offset + header.size)
+      : env.Undefined();
+    if (!Dispatch(env, header, payload, events, count)) {
+      return fail("");
+    }
+    offset += FrameSize(header);
+  }
+  
+  PerformanceMonitor::GetInstance().RecordBytes(kMetric, length, length);
+  span.End();
+  return events;
+}
+
+Napi::Value FrameMux::GetPendingBytes(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(pendingBytes_));
+}
+
+Napi::Value FrameMux::GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  size_t blocked = 0;
+  for (const auto& entry : channels_) {
+    if (entry.second.queued.size() > entry.second.queuedOffset) {
+      blocked++;
+    }
+  }
+  
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("channels", Napi::Number::New(env, static_cast<double>(channels_.size())));
+  stats.Set("framesIn", Napi::Number::New(env, framesIn_));
+  stats.Set("framesOut", Napi::Number::New(env, framesOut_));
+  stats.Set("bytesIn", Napi::Number::New(env, bytesIn_));
+  stats.Set("bytesOut", Napi::Number::New(env, bytesOut_));
+  stats.Set("queuedBytes", Napi::Number::New(env, static_cast<double>(queuedBytes_)));
+  stats.Set("blockedChannels", Napi::Number::New(env, static_cast<double>(blocked)));
+  stats.Set("flushes", Napi::Number::New(env, flushes_));
+  return stats;
+}
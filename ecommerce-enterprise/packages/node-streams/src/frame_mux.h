@@ -0,0 +1,136 @@
+#ifndef FRAME_MUX_H
+#define FRAME_MUX_H
+
+#include <napi.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Wire format. Every frame is
+//
+//   varint((channel << 2) | type)  varint(length)  payload
+//
+// DATA carries length payload bytes. CREDIT has no payload; length is the
+// number of further DATA bytes the sender of the frame will accept on the
+// channel. END (length 0) closes the sending direction of the channel.
+enum class FrameType : uint8_t {
+  kData = 0,
+  kCredit = 1,
+  kEnd = 2,
+};
+
+struct FrameHeader {
+  uint64_t channel;
+  FrameType type;
+  uint64_t length;
+  size_t size;  // encoded header bytes
+};
+
+// Credit-based flow control for one logical channel, both directions
+struct MuxChannel {
+  explicit MuxChannel(uint64_t window)
+    : sendCredit(window), receiveWindow(window), ungranted(0), queuedOffset(0),
+      endQueued(false), sentEnd(false), receivedEnd(false) {}
+
+  uint64_t sendCredit;     // DATA bytes the peer still accepts from us
+  uint64_t receiveWindow;  // DATA bytes we still accept from the peer
+  uint64_t ungranted;      // consumed by the application, not yet granted back
+  std::string queued;      // written beyond sendCredit; sent as credit arrives
+  size_t queuedOffset;
+  bool endQueued;          // end() called while data was still queued
+  bool sentEnd;
+  bool receivedEnd;
+};
+
+// Native length-prefixed framing for many logical channels over one byte
+// stream, behind createMultiplexedStream (and the 'channel' strategy of
+// createSplitterStream / createMergerStream).
+//
+//   new FrameMux({ initialWindow?, maxFrameSize?, maxChannels?, zeroCopyThreshold? })
+//   write(channel, chunk) -> boolean   false once the channel is out of credit;
+//                                      its 'drain' event follows new credit
+//   end(channel)
+//   consume(channel, bytes)            application has taken bytes; grants credit
+//   flush() -> Buffer[]                frames since the last flush, coalesced
+//   receive(chunk) -> Array            flat [channel, kind, payload] triples;
+//                                      kind 0 data, 1 drain, 2 end
+//   pendingBytes                       output waiting for flush()
+//   stats                              { channels, framesIn, framesOut, bytesIn, bytesOut,
+//                                        queuedBytes, blockedChannels, flushes }
+//
+// A channel is retired once both directions have ended, and its id is not
+// reused: late CREDIT for it is ignored and DATA or END is a protocol error,
+// as on an open channel that has seen END. Only DATA or END on an id neither
+// side has used opens a channel from the peer's side; CREDIT never does.
+//
+// Frames written during one tick go out as one Buffer. Payloads of
+// zeroCopyThreshold bytes or more that fit in a single frame are passed
+// through as their own Buffer instead of being copied, so flush() is
+// writev-ready. Received payloads are views into the input chunk unless a
+// frame straddled two chunks.
+class FrameMux : public Napi::ObjectWrap<FrameMux> {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(Napi::Env env, Napi::Object config);
+
+  FrameMux(const Napi::CallbackInfo& info);
+
+private:
+  static Napi::FunctionReference constructor;
+
+  // Output since the last flush: coalesced bytes, or a caller's Buffer
+  struct Segment {
+    std::unique_ptr<std::vector<uint8_t>> bytes;
+    Napi::Reference<Napi::Buffer<uint8_t>> buffer;
+  };
+
+  Napi::Value Write(const Napi::CallbackInfo& info);
+  Napi::Value End(const Napi::CallbackInfo& info);
+  Napi::Value Consume(const Napi::CallbackInfo& info);
+  Napi::Value Flush(const Napi::CallbackInfo& info);
+  Napi::Value Receive(const Napi::CallbackInfo& info);
+  Napi::Value GetPendingBytes(const Napi::CallbackInfo& info);
+  Napi::Value GetStats(const Napi::CallbackInfo& info);
+
+  // nullptr (with a JS exception) past maxChannels
+  MuxChannel* Open(Napi::Env env, uint64_t id);
+  void Retire(uint64_t id, MuxChannel& channel);
+  bool IsRetired(uint64_t id) const;
+
+  std::vector<uint8_t>& Tail();
+  void EmitHeader(FrameType type, uint64_t channel, uint64_t length);
+  void EmitData(uint64_t channel, const uint8_t* data, size_t length);
+
+  // Send as much queued data as the channel's credit allows; true once
+  // the queue is empty
+  bool SendQueued(uint64_t id, MuxChannel& channel);
+
+  // One complete frame; false (with a JS exception) on protocol errors
+  bool Dispatch(Napi::Env env, const FrameHeader& header, Napi::Value payload,
+                Napi::Array& events, uint32_t& count);
+
+  std::unordered_map<uint64_t, MuxChannel> channels_;
+  // Retired ids as disjoint [first, last] ranges keyed by first; ids used
+  // in sequence collapse into one entry
+  std::map<uint64_t, uint64_t> retired_;
+  std::vector<Segment> output_;
+  std::vector<uint8_t> carry_;  // start of a frame split across receive() calls
+
+  uint64_t initialWindow_;
+  uint64_t maxFrameSize_;
+  size_t maxChannels_;
+  size_t zeroCopyThreshold_;
+
+  size_t pendingBytes_;
+  size_t queuedBytes_;
+  double framesIn_;
+  double framesOut_;
+  double bytesIn_;
+  double bytesOut_;
+  double flushes_;
+};
+
+#endif // FRAME_MUX_H
@@ -0,0 +1,38 @@
+import * as path from 'path';
+
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const addon = require(path.join(__dirname, '..', 'build', 'Release', 'node_streams_addon.node'));
+
+describe('FrameMux', () => {
+  const deliver = (from: any, to: any): unknown[] => {
+    const events: unknown[] = [];
+    for (const buffer of from.flush()) {
+      events.push(...to.receive(buffer));
+    }
+    return events;
+  };
+
+  it('should not reopen a channel for CREDIT that trails both ENDs', () => {
+    const a = new addon.FrameMux({ initialWindow: 64, maxChannels: 1 });
+    const b = new addon.FrameMux({ initialWindow: 64, maxChannels: 1 });
+
+    a.write(1, Buffer.alloc(64));
+    deliver(a, b);
+
+    // b ends first, then grants credit for what it read: CREDIT goes out after END
+    b.end(1);
+    b.consume(1, 64);
+    a.end(1);
+    deliver(a, b);
+    expect(b.stats.channels).toBe(0);
+
+    expect(() => deliver(b, a)).not.toThrow();
+    expect(a.stats.channels).toBe(0);
+
+    // The retired id stays closed, and a fresh one still opens
+    expect(() => a.receive(Buffer.from([0x05, 0x40]))).not.toThrow();
+    expect(a.stats.channels).toBe(0);
+    expect(a.write(2, Buffer.alloc(1))).toBe(true);
+    expect(a.stats.channels).toBe(1);
+  });
+});
@@ -0,0 +1,134 @@
+#include "gcm_cipher.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <openssl/rand.h>
+
+// EVP_*Update takes an int length; larger chunks are fed in slices
+static const size_t kMaxUpdateSlice = static_cast<size_t>(INT_MAX) & ~static_cast<size_t>(15);
+
+GcmCipher::GcmCipher() : ctx_(EVP_CIPHER_CTX_new()), initialized_(false), decrypt_(false), hasTag_(false) {
+  std::memset(iv_, 0, sizeof(iv_));
+  std::memset(tag_, 0, sizeof(tag_));
+}
+
+GcmCipher::~GcmCipher() {
+  // Also cleanses the expanded key schedule
+  EVP_CIPHER_CTX_free(ctx_);
+}
+
+bool GcmCipher::Init(const std::string& algorithm, bool decrypt, const uint8_t* key, size_t keyLength,
+                     const uint8_t* iv, size_t ivLength, std::string& error) {
+  const EVP_CIPHER* cipher = nullptr;
+  size_t expectedKeyLength = 0;
+  if (algorithm == "aes-256-gcm") {
+    cipher = EVP_aes_256_gcm();
+    expectedKeyLength = 32;
+  } else if (algorithm == "aes-128-gcm") {
+    cipher = EVP_aes_128_gcm();
+    expectedKeyLength = 16;
+  } else {
+    error = "Unsupported encryption algorithm: " + algorithm;
+    return false;
+  }
+
+  if (keyLength != expectedKeyLength) {
+    error = "Key must be " + std::to_string(expectedKeyLength) + " bytes for " + algorithm;
+    return false;
+  }
+
+  decrypt_ = decrypt;
+  if (iv) {
+    if (ivLength != kIvLength) {
+      error = "iv must be 12 bytes for GCM";
+      return false;
+    }
+    std::memcpy(iv_, iv, kIvLength);
+  } else if (!decrypt_) {
+    if (RAND_bytes(iv_, static_cast<int>(kIvLength)) != 1) {
+      error = "Failed to generate IV";
+      return false;
+    }
+  } else {
+    error = "iv is required for decryption";
+    return false;
+  }
+
+  int ok = ctx_ == nullptr ? 0 : decrypt_
+    ? EVP_DecryptInit_ex(ctx_, cipher, nullptr, key, iv_)
+    : EVP_EncryptInit_ex(ctx_, cipher, nullptr, key, iv_);
+  if (ok != 1) {
+    error = "Failed to initialize cipher";
+    return false;
+  }
+  initialized_ = true;
+  return true;
+}
+
+bool GcmCipher::SetAad(const uint8_t* aad, size_t length, std::string& error) {
+  int len = 0;
+  int ok = length > static_cast<size_t>(INT_MAX) ? 0 : decrypt_
+    ? EVP_DecryptUpdate(ctx_, nullptr, &len, aad, static_cast<int>(length))
+    : EVP_EncryptUpdate(ctx_, nullptr, &len, aad, static_cast<int>(length));
+  if (ok != 1) {
+    error = "Failed to set additional authenticated data";
+    return false;
+  }
+  return true;
+}
+
+bool GcmCipher::SetTag(const uint8_t* tag, size_t length, std::string& error) {
+  if (!decrypt_ || length != kTagLength) {
+    error = "Tag must be 16 bytes and is only set when decrypting";
+    return false;
+  }
+  if (EVP_CIPHER_CTX_ctrl(ctx_, EVP_CTRL_GCM_SET_TAG, static_cast<int>(kTagLength),
+                          const_cast<uint8_t*>(tag)) != 1) {
+    error = "Failed to set authentication tag";
+    return false;
+  }
+  hasTag_ = true;
+  return true;
+}
+
+bool GcmCipher::Update(const uint8_t* input, size_t length, uint8_t* output, std::string& error) {
+  size_t offset = 0;
+  while (offset < length) {
+    size_t slice = std::min(length - offset, kMaxUpdateSlice);
+    int len = 0;
+    int ok = decrypt_
+      ? EVP_DecryptUpdate(ctx_, output + offset, &len, input + offset, static_cast<int>(slice))
+      : EVP_EncryptUpdate(ctx_, output + offset, &len, input + offset, static_cast<int>(slice));
+    if (ok != 1) {
+      error = decrypt_ ? "Failed to decrypt chunk" : "Failed to encrypt chunk";
+      return false;
+    }
+    offset += slice;
+  }
+  return true;
+}
+
+bool GcmCipher::Final(std::string& error) {
+  if (decrypt_ && !hasTag_) {
+    error = "Authentication tag must be set before final()";
+    return false;
+  }
+
+  // GCM never produces a trailing block, but EVP still wants an output pointer
+  uint8_t trailing[16];
+  int len = 0;
+  int ok = decrypt_ ? EVP_DecryptFinal_ex(ctx_, trailing, &len) : EVP_EncryptFinal_ex(ctx_, trailing, &len);
+  if (ok != 1) {
+    error = decrypt_ ? "Failed to finalize decryption - authentication failed" : "Failed to finalize encryption";
+    return false;
+  }
+
+  if (!decrypt_) {
+    if (EVP_CIPHER_CTX_ctrl(ctx_, EVP_CTRL_GCM_GET_TAG, static_cast<int>(kTagLength), tag_) != 1) {
+      error = "Failed to get authentication tag";
+      return false;
+    }
+    hasTag_ = true;
+  }
+  return true;
+}
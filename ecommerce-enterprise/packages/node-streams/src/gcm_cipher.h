@@ -0,0 +1,51 @@
+#ifndef GCM_CIPHER_H
+#define GCM_CIPHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <openssl/evp.h>
+
+// One AES-GCM encryption or decryption, fed incrementally. Shared by
+// EncryptedStream and the pipeline's cipher stage; no N-API, so errors come
+// back as strings for the caller to throw or report. Not thread-safe.
+//
+//   Init -> SetAad? -> SetTag (decrypt) -> Update* -> Final -> Tag (encrypt)
+class GcmCipher {
+public:
+  static const size_t kIvLength = 12;
+  static const size_t kTagLength = 16;
+
+  GcmCipher();
+  ~GcmCipher();
+
+  GcmCipher(const GcmCipher&) = delete;
+  GcmCipher& operator=(const GcmCipher&) = delete;
+
+  // algorithm is 'aes-256-gcm' or 'aes-128-gcm'. Without an IV, encryption
+  // generates one; decryption requires it.
+  bool Init(const std::string& algorithm, bool decrypt, const uint8_t* key, size_t keyLength,
+            const uint8_t* iv, size_t ivLength, std::string& error);
+  bool SetAad(const uint8_t* aad, size_t length, std::string& error);
+  bool SetTag(const uint8_t* tag, size_t length, std::string& error);
+
+  // output may equal input; writes exactly length bytes
+  bool Update(const uint8_t* input, size_t length, uint8_t* output, std::string& error);
+  bool Final(std::string& error);
+
+  bool Initialized() const { return initialized_; }
+  bool Decrypting() const { return decrypt_; }
+  bool HasTag() const { return hasTag_; }
+  const uint8_t* Iv() const { return iv_; }
+  const uint8_t* Tag() const { return tag_; }   // encrypt, after Final
+
+private:
+  EVP_CIPHER_CTX* ctx_;
+  bool initialized_;
+  bool decrypt_;
+  bool hasTag_;
+  uint8_t iv_[kIvLength];
+  uint8_t tag_[kTagLength];
+};
+
+#endif // GCM_CIPHER_H
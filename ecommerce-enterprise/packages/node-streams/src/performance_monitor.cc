@@ -1,50 +1,483 @@
 #include "performance_monitor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Exposed duration buckets: powers of two from ~1us to ~17s, each on a
+// log-linear group boundary so cumulative counts are exact
+const uint32_t kFirstBoundBits = 10;
+const uint32_t kLastBoundBits = 34;
+
+const char kSnapshotMagic[4] = { 'E', 'C', 'M', 'S' };
+const uint8_t kSnapshotVersion = 1;
+const uint8_t kEntryHasName = 1;
+const uint8_t kEntryAbsolute = 2;
+
+void AppendUnsigned(std::string& out, uint64_t value) {
+  char digits[24];
+  int length = std::snprintf(digits, sizeof(digits), "%llu", static_cast<unsigned long long>(value));
+  out.append(digits, length);
+}
+
+void AppendDouble(std::string& out, double value) {
+  char digits[32];
+  int length = std::snprintf(digits, sizeof(digits), "%.9g", value);
+  out.append(digits, length);
+}
+
+void AppendSample(std::string& out, const char* name, const char* suffix, const std::string& operation) {
+  out += name;
+  out += suffix;
+  out += "{operation=\"";
+  for (char c : operation) {
+    if (c == '\\' || c == '"') {
+      out += '\\';
+      out += c;
+    } else if (c == '\n') {
+      out += "\\n";
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+void AppendVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+void AppendHistogram(std::string& out, const uint64_t* counts, const uint64_t* base) {
+  uint32_t nonZero = 0;
+  for (uint32_t i = 0; i < LatencyHistogram::kBucketCount; i++) {
+    nonZero += counts[i] != (base ? base[i] : 0);
+  }
+  AppendVarint(out, nonZero);
+  
+  uint32_t next = 0;
+  for (uint32_t i = 0; i < LatencyHistogram::kBucketCount; i++) {
+    uint64_t value = counts[i] - (base ? base[i] : 0);
+    if (value != 0) {
+      AppendVarint(out, i - next);
+      AppendVarint(out, value);
+      next = i + 1;
+    }
+  }
+}
+
+} // namespace
+
+void LatencyHistogram::Reset() {
+  for (auto& count : counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::CopyTo(uint64_t* out) const {
+  for (uint32_t i = 0; i < kBucketCount; i++) {
+    out[i] = counts_[i].load(std::memory_order_relaxed);
+  }
+}
+
+uint32_t LatencyHistogram::BucketOf(uint64_t value) {
+  if (value < kSubBucketCount) {
+    return static_cast<uint32_t>(value);
+  }
+  value = std::min<uint64_t>(value, (1ull << kMaxValueBits) - 1);
+  
+  uint32_t top = 63;
+  while (!(value >> top)) {
+    top--;
+  }
+  // The kSubBucketBits bits below the leading one pick the sub-bucket
+  uint32_t shift = top - kSubBucketBits;
+  uint32_t sub = static_cast<uint32_t>(value >> shift) - kSubBucketCount;
+  return (shift + 1) * kSubBucketCount + sub;
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(uint32_t bucket) {
+  uint32_t group = bucket / kSubBucketCount;
+  uint64_t sub = bucket % kSubBucketCount;
+  return group == 0 ? sub : (kSubBucketCount + sub) << (group - 1);
+}
+
+// Midpoint of the bucket holding the value at that rank
+uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+  uint64_t snapshot[kBucketCount];
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < kBucketCount; i++) {
+    snapshot[i] = counts_[i].load(std::memory_order_relaxed);
+    total += snapshot[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+  
+  uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total)));
+  rank = std::max<uint64_t>(1, std::min(rank, total));
+  
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < kBucketCount; i++) {
+    seen += snapshot[i];
+    if (seen >= rank) {
+      uint32_t group = i / kSubBucketCount;
+      uint64_t width = group == 0 ? 1 : 1ull << (group - 1);
+      return BucketLowerBound(i) + width / 2;
+    }
+  }
+  return BucketLowerBound(kBucketCount - 1);
+}
+
+OperationSpan::OperationSpan(uint32_t slot) : slot_(slot), startNs_(NowNs()), active_(true) {}
+
+OperationSpan::OperationSpan(OperationSpan&& other) noexcept
+  : slot_(other.slot_), startNs_(other.startNs_), active_(other.active_) {
+  other.active_ = false;
+}
+
+OperationSpan& OperationSpan::operator=(OperationSpan&& other) noexcept {
+  if (this != &other) {
+    End();
+    slot_ = other.slot_;
+    startNs_ = other.startNs_;
+    active_ = other.active_;
+    other.active_ = false;
+  }
+  return *this;
+}
+
+OperationSpan::~OperationSpan() {
+  End();
+}
+
+long long OperationSpan::End(bool success) {
+  if (!active_) {
+    return 0;
+  }
+  active_ = false;
+  
+  uint64_t now = NowNs();
+  uint64_t elapsed = now > startNs_ ? now - startNs_ : 0;
+  PerformanceMonitor::GetInstance().RecordOperation(slot_, elapsed, success);
+  return static_cast<long long>(elapsed / 1000);
+}
 
 PerformanceMonitor& PerformanceMonitor::GetInstance() {
   static PerformanceMonitor instance;
   return instance;
 }
 
-void PerformanceMonitor::StartOperation(const std::string& operationName) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  startTimes_[operationName] = std::chrono::high_resolution_clock::now();
+PerformanceMonitor::PerformanceMonitor() : snapshotSequence_(0) {
+  // Slot 0 collects names registered after the table is full
+  names_[0] = "other";
+  counters_[0].reset(new Counters());
+  slots_.emplace(names_[0], 0);
+  operationCount_.store(1, std::memory_order_release);
 }
 
-void PerformanceMonitor::EndOperation(const std::string& operationName) {
+uint32_t PerformanceMonitor::RegisterOperation(const std::string& operationName) {
   std::lock_guard<std::mutex> lock(mutex_);
-  auto endTime = std::chrono::high_resolution_clock::now();
+  auto it = slots_.find(operationName);
+  if (it != slots_.end()) {
+    return it->second;
+  }
   
-  if (startTimes_.count(operationName)) {
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
-      endTime - startTimes_[operationName]
-    ).count();
-    
-    OperationMetrics& metric = metrics_[operationName];
-    metric.totalDuration += duration;
-    metric.callCount++;
+  uint32_t slot = operationCount_.load(std::memory_order_relaxed);
+  if (slot >= kMaxOperations) {
+    return 0;
+  }
+  names_[slot] = operationName;
+  counters_[slot].reset(new Counters());
+  slots_.emplace(operationName, slot);
+  operationCount_.store(slot + 1, std::memory_order_release);
+  return slot;
+}
+
+void PerformanceMonitor::RecordOperation(uint32_t slot, uint64_t durationNs, bool success) {
+  if (slot >= operationCount_.load(std::memory_order_acquire)) {
+    return;
+  }
+  
+  Counters& counters = *counters_[slot];
+  counters.callCount.fetch_add(1, std::memory_order_relaxed);
+  if (!success) {
+    counters.errorCount.fetch_add(1, std::memory_order_relaxed);
+  }
+  counters.totalNs.fetch_add(durationNs, std::memory_order_relaxed);
+  
+  uint64_t seen = counters.minNs.load(std::memory_order_relaxed);
+  while (durationNs < seen && !counters.minNs.compare_exchange_weak(seen, durationNs, std::memory_order_relaxed)) {}
+  seen = counters.maxNs.load(std::memory_order_relaxed);
+  while (durationNs > seen && !counters.maxNs.compare_exchange_weak(seen, durationNs, std::memory_order_relaxed)) {}
+  
+  counters.latency.Record(durationNs);
+}
+
+void PerformanceMonitor::RecordBytes(uint32_t slot, uint64_t bytesIn, uint64_t bytesOut) {
+  if (slot >= operationCount_.load(std::memory_order_acquire)) {
+    return;
+  }
+  
+  Counters& counters = *counters_[slot];
+  counters.bytesIn.fetch_add(bytesIn, std::memory_order_relaxed);
+  counters.bytesOut.fetch_add(bytesOut, std::memory_order_relaxed);
+}
+
+std::map<std::string, OperationMetrics> PerformanceMonitor::GetMetrics() const {
+  std::map<std::string, OperationMetrics> result;
+  uint32_t count = operationCount_.load(std::memory_order_acquire);
+  
+  for (uint32_t slot = 0; slot < count; slot++) {
+    const Counters& counters = *counters_[slot];
+    uint64_t calls = counters.callCount.load(std::memory_order_relaxed);
+    if (calls == 0) {
+      continue;
+    }
     
-    if (metric.minDuration == -1 || duration < metric.minDuration) {
-      metric.minDuration = duration;
+    OperationMetrics& metric = result[names_[slot]];
+    uint64_t errors = counters.errorCount.load(std::memory_order_relaxed);
+    metric.callCount = static_cast<int>(calls);
+    metric.errorCount = static_cast<int>(errors);
+    metric.totalDuration = static_cast<long long>(counters.totalNs.load(std::memory_order_relaxed) / 1000);
+    metric.minDuration = static_cast<long long>(counters.minNs.load(std::memory_order_relaxed) / 1000);
+    metric.maxDuration = static_cast<long long>(counters.maxNs.load(std::memory_order_relaxed) / 1000);
+    metric.averageDuration = static_cast<double>(metric.totalDuration) / calls;
+    metric.successRate = (calls - std::min(errors, calls)) / static_cast<double>(calls) * 100.0;
+    metric.p50Duration = static_cast<long long>(counters.latency.ValueAtPercentile(50) / 1000);
+    metric.p90Duration = static_cast<long long>(counters.latency.ValueAtPercentile(90) / 1000);
+    metric.p99Duration = static_cast<long long>(counters.latency.ValueAtPercentile(99) / 1000);
+    metric.p999Duration = static_cast<long long>(counters.latency.ValueAtPercentile(99.9) / 1000);
+    metric.bytesIn = static_cast<long long>(counters.bytesIn.load(std::memory_order_relaxed));
+    metric.bytesOut = static_cast<long long>(counters.bytesOut.load(std::memory_order_relaxed));
+  }
+  
+  return result;
+}
+
+// Slots stay registered so cached ids stay valid
+void PerformanceMonitor::ResetMetrics() {
+  uint32_t count = operationCount_.load(std::memory_order_acquire);
+  for (uint32_t slot = 0; slot < count; slot++) {
+    Counters& counters = *counters_[slot];
+    counters.callCount.store(0, std::memory_order_relaxed);
+    counters.errorCount.store(0, std::memory_order_relaxed);
+    counters.totalNs.store(0, std::memory_order_relaxed);
+    counters.minNs.store(UINT64_MAX, std::memory_order_relaxed);
+    counters.maxNs.store(0, std::memory_order_relaxed);
+    counters.bytesIn.store(0, std::memory_order_relaxed);
+    counters.bytesOut.store(0, std::memory_order_relaxed);
+    counters.latency.Reset();
+  }
+}
+
+// Copy every registered slot into current_; caller holds exportMutex_
+uint32_t PerformanceMonitor::CollectSnapshots() {
+  uint32_t count = operationCount_.load(std::memory_order_acquire);
+  if (current_.size() < count) {
+    current_.resize(count);
+  }
+  
+  for (uint32_t slot = 0; slot < count; slot++) {
+    if (!current_[slot]) {
+      current_[slot].reset(new Snapshot());
     }
-    if (duration > metric.maxDuration) {
-      metric.maxDuration = duration;
+    const Counters& counters = *counters_[slot];
+    Snapshot& snapshot = *current_[slot];
+    snapshot.callCount = counters.callCount.load(std::memory_order_relaxed);
+    snapshot.errorCount = counters.errorCount.load(std::memory_order_relaxed);
+    snapshot.totalNs = counters.totalNs.load(std::memory_order_relaxed);
+    snapshot.minNs = counters.minNs.load(std::memory_order_relaxed);
+    snapshot.maxNs = counters.maxNs.load(std::memory_order_relaxed);
+    snapshot.bytesIn = counters.bytesIn.load(std::memory_order_relaxed);
+    snapshot.bytesOut = counters.bytesOut.load(std::memory_order_relaxed);
+    counters.latency.CopyTo(snapshot.latency);
+  }
+  return count;
+}
+
+void PerformanceMonitor::RenderOpenMetrics(std::string& out) {
+  static const std::vector<std::string> bounds = [] {
+    std::vector<std::string> labels;
+    for (uint32_t bits = kFirstBoundBits; bits <= kLastBoundBits; bits++) {
+      std::string label;
+      AppendDouble(label, static_cast<double>(1ull << bits) / 1e9);
+      labels.push_back(label);
+    }
+    return labels;
+  }();
+  const char* duration = "enterprise_streams_operation_duration_seconds";
+  const char* errors = "enterprise_streams_operation_errors";
+  const struct {
+    const char* name;
+    const char* help;
+    uint64_t Snapshot::*value;
+  } byteCounters[] = {
+    { "enterprise_streams_operation_input_bytes", "Payload bytes consumed by native stream operations.", &Snapshot::bytesIn },
+    { "enterprise_streams_operation_output_bytes", "Payload bytes produced by native stream operations.", &Snapshot::bytesOut },
+  };
+  
+  std::lock_guard<std::mutex> lock(exportMutex_);
+  uint32_t count = CollectSnapshots();
+  
+  out.clear();
+  out += "# TYPE enterprise_streams_operation_duration_seconds histogram\n";
+  out += "# UNIT enterprise_streams_operation_duration_seconds seconds\n";
+  out += "# HELP enterprise_streams_operation_duration_seconds Wall time of native stream operations.\n";
+  for (uint32_t slot = 0; slot < count; slot++) {
+    const Snapshot& snapshot = *current_[slot];
+    if (snapshot.callCount == 0) {
+      continue;
     }
     
-    metric.averageDuration = static_cast<double>(metric.totalDuration) / metric.callCount;
-    metric.successRate = metric.callCount > 0 ? 
-      ((metric.callCount - metric.errorCount) / static_cast<double>(metric.callCount)) * 100.0 : 100.0;
+    uint64_t cumulative = 0;
+    uint32_t bucket = 0;
+    for (uint32_t bits = kFirstBoundBits; bits <= kLastBoundBits; bits++) {
+      while (bucket < LatencyHistogram::kBucketCount && LatencyHistogram::BucketLowerBound(bucket) < (1ull << bits)) {
+        cumulative += snapshot.latency[bucket++];
+      }
+      AppendSample(out, duration, "_bucket", names_[slot]);
+      out += ",le=\"";
+      out += bounds[bits - kFirstBoundBits];
+      out += "\"} ";
+      AppendUnsigned(out, cumulative);
+      out += '\n';
+    }
+    while (bucket < LatencyHistogram::kBucketCount) {
+      cumulative += snapshot.latency[bucket++];
+    }
     
-    startTimes_.erase(operationName); // Clear start time
+    // _count has to agree with the +Inf bucket
+    AppendSample(out, duration, "_bucket", names_[slot]);
+    out += ",le=\"+Inf\"} ";
+    AppendUnsigned(out, cumulative);
+    out += '\n';
+    AppendSample(out, duration, "_count", names_[slot]);
+    out += "} ";
+    AppendUnsigned(out, cumulative);
+    out += '\n';
+    AppendSample(out, duration, "_sum", names_[slot]);
+    out += "} ";
+    AppendDouble(out, snapshot.totalNs / 1e9);
+    out += '\n';
   }
+  
+  out += "# TYPE enterprise_streams_operation_errors counter\n";
+  out += "# HELP enterprise_streams_operation_errors Native stream operations that failed.\n";
+  for (uint32_t slot = 0; slot < count; slot++) {
+    const Snapshot& snapshot = *current_[slot];
+    if (snapshot.callCount == 0) {
+      continue;
+    }
+    AppendSample(out, errors, "_total", names_[slot]);
+    out += "} ";
+    AppendUnsigned(out, snapshot.errorCount);
+    out += '\n';
+  }
+  
+  // Only operations that report payload sizes (codecs, pipelines)
+  for (const auto& counter : byteCounters) {
+    out += "# TYPE ";
+    out += counter.name;
+    out += " counter\n# UNIT ";
+    out += counter.name;
+    out += " bytes\n# HELP ";
+    out += counter.name;
+    out += ' ';
+    out += counter.help;
+    out += '\n';
+    for (uint32_t slot = 0; slot < count; slot++) {
+      const Snapshot& snapshot = *current_[slot];
+      if (snapshot.callCount == 0 || (snapshot.bytesIn == 0 && snapshot.bytesOut == 0)) {
+        continue;
+      }
+      AppendSample(out, counter.name, "_total", names_[slot]);
+      out += "} ";
+      AppendUnsigned(out, snapshot.*counter.value);
+      out += '\n';
+    }
+  }
+  
+  out += "# EOF\n";
 }
 
-std::map<std::string, OperationMetrics> PerformanceMonitor::GetMetrics() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return metrics_;
-}
-
-void PerformanceMonitor::ResetMetrics() {
-  std::lock_guard<std::mutex> lock(mutex_);
-  metrics_.clear();
-  startTimes_.clear();
+void PerformanceMonitor::EncodeSnapshot(std::string& out, bool full, size_t limit) {
+  std::lock_guard<std::mutex> lock(exportMutex_);
+  uint32_t count = CollectSnapshots();
+  full = full || snapshotSequence_ == 0;
+  
+  uint64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count();
+  
+  out.clear();
+  out.append(kSnapshotMagic, sizeof(kSnapshotMagic));
+  out += static_cast<char>(kSnapshotVersion);
+  out += static_cast<char>(full ? 0 : 1);
+  AppendVarint(out, snapshotSequence_ + 1);
+  AppendVarint(out, full ? 0 : snapshotSequence_);
+  AppendVarint(out, nowUs);
+  
+  // kMaxOperations fits in two varint bytes; patched in below
+  size_t countOffset = out.size();
+  out.append(2, '\0');
+  uint32_t entries = 0;
+  
+  for (uint32_t slot = 0; slot < count; slot++) {
+    const Snapshot& snapshot = *current_[slot];
+    const Snapshot* base = !full && slot < baseline_.size() ? baseline_[slot].get() : nullptr;
+    
+    bool unchanged = base
+      ? snapshot.callCount == base->callCount && snapshot.errorCount == base->errorCount &&
+        snapshot.totalNs == base->totalNs && snapshot.bytesIn == base->bytesIn &&
+        std::memcmp(snapshot.latency, base->latency, sizeof(snapshot.latency)) == 0
+      : snapshot.callCount == 0;
+    if (unchanged) {
+      continue;
+    }
+    
+    uint8_t flags = !base || base->callCount == 0 ? kEntryHasName : 0;
+    if (base) {
+      // A reset since the base makes deltas meaningless; send absolutes
+      bool regressed = snapshot.callCount < base->callCount || snapshot.errorCount < base->errorCount ||
+                       snapshot.totalNs < base->totalNs || snapshot.bytesIn < base->bytesIn;
+      for (uint32_t i = 0; i < LatencyHistogram::kBucketCount && !regressed; i++) {
+        regressed = snapshot.latency[i] < base->latency[i];
+      }
+      if (regressed) {
+        base = nullptr;
+      }
+    }
+    if (!base) {
+      flags |= kEntryAbsolute;
+    }
+    
+    AppendVarint(out, slot);
+    out += static_cast<char>(flags);
+    if (flags & kEntryHasName) {
+      AppendVarint(out, names_[slot].size());
+      out += names_[slot];
+    }
+    AppendVarint(out, snapshot.callCount - (base ? base->callCount : 0));
+    AppendVarint(out, snapshot.errorCount - (base ? base->errorCount : 0));
+    AppendVarint(out, snapshot.totalNs - (base ? base->totalNs : 0));
+    AppendVarint(out, snapshot.bytesIn - (base ? base->bytesIn : 0));
+    AppendVarint(out, snapshot.callCount ? snapshot.minNs : 0);
+    AppendVarint(out, snapshot.maxNs);
+    AppendHistogram(out, snapshot.latency, base ? base->latency : nullptr);
+    AppendVarint(out, 0); // empty size histogram
+    entries++;
+  }
+  
+  out[countOffset] = static_cast<char>((entries & 0x7F) | 0x80);
+  out[countOffset + 1] = static_cast<char>(entries >> 7);
+  
+  if (out.size() <= limit) {
+    current_.swap(baseline_);
+    snapshotSequence_++;
+  }
 }
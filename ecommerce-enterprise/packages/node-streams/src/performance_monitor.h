@@ -6,6 +6,11 @@
 #include <map>
 #include <chrono>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
 
 struct OperationMetrics {
   long long totalDuration = 0; // in microseconds
@@ -15,25 +20,146 @@ struct OperationMetrics {
   double averageDuration = 0.0;
   int errorCount = 0;
   double successRate = 100.0;
+  long long p50Duration = 0;   // percentiles in microseconds
+  long long p90Duration = 0;
+  long long p99Duration = 0;
+  long long p999Duration = 0;
+  long long bytesIn = 0;       // payload bytes, for operations that report them
+  long long bytesOut = 0;
+};
+
+// Log-linear (HDR-style) latency histogram in nanoseconds: 16 linear
+// sub-buckets per power of two, so percentiles are within about 3%.
+// Buckets are relaxed atomics and may be recorded from any thread.
+class LatencyHistogram {
+public:
+  static constexpr uint32_t kSubBucketBits = 4;
+  static constexpr uint32_t kSubBucketCount = 1u << kSubBucketBits;
+  static constexpr uint32_t kMaxValueBits = 40;
+  static constexpr uint32_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+  
+  LatencyHistogram() { Reset(); }
+  
+  void Record(uint64_t value) {
+    counts_[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+  }
+  
+  void Reset();
+  void CopyTo(uint64_t* out) const;
+  uint64_t ValueAtPercentile(double percentile) const;
+  
+  static uint32_t BucketOf(uint64_t value);
+  static uint64_t BucketLowerBound(uint32_t bucket);
+  
+private:
+  std::atomic<uint64_t> counts_[kBucketCount];
+};
+
+// Timing token for one operation. The start stamp lives in the span rather
+// than in a shared map, so overlapping calls never collide, and a span can
+// be moved to another thread and ended there (an async op that starts on
+// the JS thread and finishes on a worker). Ends on destruction if End()
+// was not called.
+class OperationSpan {
+public:
+  explicit OperationSpan(uint32_t slot);
+  OperationSpan(OperationSpan&& other) noexcept;
+  OperationSpan& operator=(OperationSpan&& other) noexcept;
+  ~OperationSpan();
+  
+  OperationSpan(const OperationSpan&) = delete;
+  OperationSpan& operator=(const OperationSpan&) = delete;
+  
+  // Record the elapsed time; returns it in microseconds. Later calls are no-ops.
+  long long End(bool success = true);
+  
+  // Steady, process-wide clock shared by spans and JS start stamps
+  static uint64_t NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+  }
+  
+private:
+  uint32_t slot_;
+  uint64_t startNs_;
+  bool active_;
 };
 
 class PerformanceMonitor {
 public:
+  static constexpr uint32_t kMaxOperations = 256;
+  
   static PerformanceMonitor& GetInstance();
-  void StartOperation(const std::string& operationName);
-  void EndOperation(const std::string& operationName);
+  
+  // Slot for an operation name. Lookups take a lock; callers resolve their
+  // names once (e.g. into a function-local static) and keep the slot.
+  uint32_t RegisterOperation(const std::string& operationName);
+  
+  // Lock-free; durationNs goes into the slot's counters and histogram
+  void RecordOperation(uint32_t slot, uint64_t durationNs, bool success = true);
+  
+  // Lock-free; payload consumed and produced, e.g. by a codec, so ratio and
+  // throughput can be derived per operation
+  void RecordBytes(uint32_t slot, uint64_t bytesIn, uint64_t bytesOut);
+  
   std::map<std::string, OperationMetrics> GetMetrics() const;
   void ResetMetrics();
   
+  // OpenMetrics text exposition of every operation with calls
+  void RenderOpenMetrics(std::string& out);
+  
+  // Binary snapshot, as a delta from the last committed one unless full.
+  // Same layout as node-crypto's exportPerformanceData('snapshot'); the byte
+  // counter carries input bytes and the size histogram is always empty. The
+  // snapshot becomes the next delta base only if it fits in limit bytes, so a
+  // caller whose buffer was too small can retry without losing counts.
+  void EncodeSnapshot(std::string& out, bool full, size_t limit);
+  
   // Delete copy constructor and assignment operator to enforce singleton
   PerformanceMonitor(const PerformanceMonitor&) = delete;
   PerformanceMonitor& operator=(const PerformanceMonitor&) = delete;
 
 private:
-  PerformanceMonitor() = default;
-  std::map<std::string, std::chrono::high_resolution_clock::time_point> startTimes_;
-  std::map<std::string, OperationMetrics> metrics_;
-  mutable std::mutex mutex_; // Mutex for thread-safe access
+  struct Counters {
+    std::atomic<uint64_t> callCount{0};
+    std::atomic<uint64_t> errorCount{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> minNs{UINT64_MAX};
+    std::atomic<uint64_t> maxNs{0};
+    std::atomic<uint64_t> bytesIn{0};
+    std::atomic<uint64_t> bytesOut{0};
+    LatencyHistogram latency;
+  };
+  
+  // One slot's counters as of a scrape
+  struct Snapshot {
+    uint64_t callCount;
+    uint64_t errorCount;
+    uint64_t totalNs;
+    uint64_t minNs;
+    uint64_t maxNs;
+    uint64_t bytesIn;
+    uint64_t bytesOut;
+    uint64_t latency[LatencyHistogram::kBucketCount];
+  };
+  
+  PerformanceMonitor();
+  
+  uint32_t CollectSnapshots();
+  
+  // Counters are allocated with their slot and never freed; names are
+  // published before the slot count that makes them visible
+  std::unique_ptr<Counters> counters_[kMaxOperations];
+  std::string names_[kMaxOperations];
+  std::atomic<uint32_t> operationCount_{0};
+  std::unordered_map<std::string, uint32_t> slots_;
+  mutable std::mutex mutex_; // Guards registration only
+  
+  // Scrape state; buffers are reused so steady-state scrapes don't allocate
+  std::mutex exportMutex_;
+  std::vector<std::unique_ptr<Snapshot>> current_;
+  std::vector<std::unique_ptr<Snapshot>> baseline_;
+  uint64_t snapshotSequence_;
 };
 
 #endif // PERFORMANCE_MONITOR_H
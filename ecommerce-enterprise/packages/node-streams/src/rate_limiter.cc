@@ -0,0 +1,415 @@
+#include "rate_limiter.h"
+#include "performance_monitor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+
+namespace {
+
+const size_t kDefaultMaxKeys = 65536;
+const size_t kMaxKeys = 1u << 26;
+const size_t kMaxInlineKey = 256;   // longer keys are hashed from a std::string
+
+const uint64_t kTagSeed = 0x243F6A8885A308D3ull;
+const uint64_t kCheckSeed = 0x13198A2E03707344ull;
+const uint64_t kNumberSeed = 0xA4093822299F31D0ull;
+
+inline uint64_t Rotl(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+// Murmur3-style 64-bit hash; tag and check use independent seeds, so a
+// false match needs both 64-bit values to collide
+uint64_t HashKey(const char* data, size_t length, uint64_t seed) {
+  uint64_t h = seed ^ (length * 0x9E3779B97F4A7C15ull);
+  while (length >= 8) {
+    uint64_t k;
+    std::memcpy(&k, data, 8);
+    k *= 0x87c37b91114253d5ull;
+    k = Rotl(k, 31);
+    k *= 0x4cf5ad432745937full;
+    h ^= k;
+    h = Rotl(h, 27) * 5 + 0x52dce729;
+    data += 8;
+    length -= 8;
+  }
+  if (length) {
+    uint64_t k = 0;
+    std::memcpy(&k, data, length);
+    k *= 0x87c37b91114253d5ull;
+    k = Rotl(k, 31);
+    k *= 0x4cf5ad432745937full;
+    h ^= k;
+  }
+  return Mix(h);
+}
+
+size_t NextPowerOfTwo(size_t value) {
+  size_t power = 1;
+  while (power < value) {
+    power <<= 1;
+  }
+  return power;
+}
+
+// Limiters created with a name share their table across environments
+std::mutex registryMutex;
+std::map<std::string, std::weak_ptr<RateLimitTable>> registry;
+
+} // namespace
+
+RateLimitTable::RateLimitTable(double maxRequests, double windowMs, double burst, size_t maxKeys)
+  : maxRequests(maxRequests), windowMs(windowMs), burst(burst), maxKeys(maxKeys) {
+  intervalNs_ = std::max<uint64_t>(1, static_cast<uint64_t>(windowMs * 1e6 / maxRequests));
+  toleranceNs_ = static_cast<uint64_t>(burst * static_cast<double>(intervalNs_));
+  
+  // Half full at maxKeys, so probe windows rarely fill up
+  size_t perShard = NextPowerOfTwo(std::max<size_t>(kProbeLimit, maxKeys * 2 / kShardCount));
+  shardMask_ = perShard - 1;
+  for (Shard& shard : shards) {
+    shard.slots.reset(new RateLimitSlot[perShard]);
+  }
+}
+
+// Lock-free. A chain ends at the first never-used slot, because slots are
+// recycled in place and never emptied.
+RateLimitSlot* RateLimitTable::Find(Shard& shard, uint64_t tag, uint64_t check) {
+  for (uint32_t i = 0; i < kProbeLimit; i++) {
+    RateLimitSlot& slot = shard.slots[(tag + i) & shardMask_];
+    uint64_t current = slot.tag.load(std::memory_order_acquire);
+    if (current == tag && slot.check.load(std::memory_order_relaxed) == check) {
+      return &slot;
+    }
+    if (current == 0) {
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+// Caller holds shard.mutex
+RateLimitSlot* RateLimitTable::Insert(Shard& shard, uint64_t tag, uint64_t check) {
+  while (true) {
+    RateLimitSlot* oldest = nullptr;
+    uint64_t oldestTat = kLocked;
+    
+    for (uint32_t i = 0; i < kProbeLimit; i++) {
+      RateLimitSlot& slot = shard.slots[(tag + i) & shardMask_];
+      if (slot.tag.load(std::memory_order_relaxed) == 0) {
+        slot.check.store(check, std::memory_order_relaxed);
+        slot.tat.store(0, std::memory_order_relaxed);
+        slot.tag.store(tag, std::memory_order_release);
+        shard.keys.fetch_add(1, std::memory_order_relaxed);
+        return &slot;
+      }
+      uint64_t tat = slot.tat.load(std::memory_order_relaxed);
+      if (tat < oldestTat) {
+        oldest = &slot;
+        oldestTat = tat;
+      }
+    }
+    
+    if (!oldest) {
+      continue;
+    }
+    
+    // Lock the slot's word first: an acquire racing with us either lands
+    // before this (and we see a changed TAT and look again) or fails its CAS
+    // and comes back through the lock
+    if (!oldest->tat.compare_exchange_strong(oldestTat, kLocked, std::memory_order_acquire)) {
+      continue;
+    }
+    oldest->check.store(check, std::memory_order_relaxed);
+    oldest->tag.store(tag, std::memory_order_relaxed);
+    oldest->tat.store(0, std::memory_order_release);
+    shard.evictions.fetch_add(1, std::memory_order_relaxed);
+    return oldest;
+  }
+}
+
+bool RateLimitTable::TryAcquire(uint64_t tag, uint64_t check, double cost, uint64_t nowNs, uint64_t& retryAfterNs) {
+  Shard& shard = shards[check >> 60];
+  uint64_t increment = static_cast<uint64_t>(cost * static_cast<double>(intervalNs_));
+  
+  RateLimitSlot* slot = Find(shard, tag, check);
+  while (true) {
+    if (!slot) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      slot = Find(shard, tag, check);
+      if (!slot) {
+        slot = Insert(shard, tag, check);
+      }
+    }
+    
+    uint64_t tat = slot->tat.load(std::memory_order_acquire);
+    // Recycled (or being recycled) for another key since we found it
+    if (tat == kLocked || slot->tag.load(std::memory_order_relaxed) != tag ||
+        slot->check.load(std::memory_order_relaxed) != check) {
+      slot = nullptr;
+      continue;
+    }
+    
+    // GCRA: grant if the arrival time after this request stays within the
+    // burst tolerance of now; a denied request changes nothing
+    uint64_t next = std::max(tat, nowNs) + increment;
+    if (next - nowNs > toleranceNs_) {
+      retryAfterNs = next - nowNs - toleranceNs_;
+      shard.denied.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (slot->tat.compare_exchange_weak(tat, next, std::memory_order_acq_rel)) {
+      shard.allowed.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+}
+
+void RateLimitTable::Reset(uint64_t tag, uint64_t check) {
+  Shard& shard = shards[check >> 60];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  RateLimitSlot* slot = Find(shard, tag, check);
+  if (slot) {
+    uint64_t tat = slot->tat.load(std::memory_order_relaxed);
+    while (tat != kLocked && !slot->tat.compare_exchange_weak(tat, 0, std::memory_order_acq_rel)) {}
+  }
+}
+
+Napi::FunctionReference RateLimiter::constructor;
+
+void RateLimiter::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "RateLimiter", {
+    InstanceMethod("tryAcquire", &RateLimiter::TryAcquire),
+    InstanceMethod("tryAcquireMany", &RateLimiter::TryAcquireMany),
+    InstanceMethod("reset", &RateLimiter::Reset),
+    InstanceAccessor("retryAfter", &RateLimiter::GetRetryAfter, nullptr),
+    InstanceAccessor("stats", &RateLimiter::GetStats, nullptr),
+  });
+  
+  constructor = Napi::Persistent(func);
+  constructor.SuppressDestruct();
+  
+  exports.Set(Napi::String::New(env, "RateLimiter"), func);
+}
+
+Napi::Object RateLimiter::NewInstance(Napi::Env env, Napi::Object config) {
+  return constructor.New({ config });
+}
+
+RateLimiter::RateLimiter(const Napi::CallbackInfo& info)
+  : Napi::ObjectWrap<RateLimiter>(info), retryAfterNs_(0) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "Expected rate limiter config").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  Napi::Object config = info[0].As<Napi::Object>();
+  if (!config.Get("maxRequests").IsNumber() || !config.Get("windowMs").IsNumber()) {
+    Napi::TypeError::New(env, "maxRequests and windowMs are required").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  double maxRequests = config.Get("maxRequests").As<Napi::Number>().DoubleValue();
+  double windowMs = config.Get("windowMs").As<Napi::Number>().DoubleValue();
+  // By default a fresh key may spend its whole window at once
+  double burst = config.Get("burst").IsNumber() ? config.Get("burst").As<Napi::Number>().DoubleValue() : maxRequests;
+  double maxKeys = config.Get("maxKeys").IsNumber() ? config.Get("maxKeys").As<Napi::Number>().DoubleValue()
+                                                    : static_cast<double>(kDefaultMaxKeys);
+  
+  if (!(maxRequests > 0) || !(windowMs > 0) || !(burst >= 1) || !std::isfinite(maxRequests + windowMs + burst)) {
+    Napi::RangeError::New(env, "maxRequests and windowMs must be positive and burst at least 1").ThrowAsJavaScriptException();
+    return;
+  }
+  if (!(maxKeys >= 1) || maxKeys > kMaxKeys) {
+    Napi::RangeError::New(env, "maxKeys must be between 1 and " + std::to_string(kMaxKeys)).ThrowAsJavaScriptException();
+    return;
+  }
+  
+  std::string name = config.Get("name").IsString() ? config.Get("name").As<Napi::String>().Utf8Value() : "";
+  if (name.empty()) {
+    table_ = std::make_shared<RateLimitTable>(maxRequests, windowMs, burst, static_cast<size_t>(maxKeys));
+  } else {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::weak_ptr<RateLimitTable>& entry = registry[name];
+    table_ = entry.lock();
+    if (!table_) {
+      table_ = std::make_shared<RateLimitTable>(maxRequests, windowMs, burst, static_cast<size_t>(maxKeys));
+      entry = table_;
+    } else if (table_->maxRequests != maxRequests || table_->windowMs != windowMs || table_->burst != burst) {
+      table_.reset();
+      Napi::TypeError::New(env, "Rate limiter '" + name + "' already exists with different limits").ThrowAsJavaScriptException();
+      return;
+    }
+  }
+  
+  Napi::Object self = Value();
+  self.Set("maxRequests", Napi::Number::New(env, maxRequests));
+  self.Set("windowMs", Napi::Number::New(env, windowMs));
+  self.Set("burst", Napi::Number::New(env, burst));
+}
+
+// Hash a key without copying it to the heap unless it is very long
+static bool HashValue(Napi::Env env, Napi::Value key, uint64_t& tag, uint64_t& check) {
+  if (key.IsString()) {
+    // napi stops short of a UTF-8 sequence that does not fit, dropping up
+    // to 3 bytes, so only a copy shorter than kMaxInlineKey is the whole key
+    char inline_[kMaxInlineKey + 4];
+    size_t length = 0;
+    napi_get_value_string_utf8(env, key, inline_, sizeof(inline_), &length);
+    if (length < kMaxInlineKey) {
+      tag = HashKey(inline_, length, kTagSeed);
+      check = HashKey(inline_, length, kCheckSeed);
+    } else {
+      std::string full = key.As<Napi::String>().Utf8Value();
+      tag = HashKey(full.data(), full.size(), kTagSeed);
+      check = HashKey(full.data(), full.size(), kCheckSeed);
+    }
+  } else if (key.IsNumber()) {
+    double number = key.As<Napi::Number>().DoubleValue();
+    uint64_t bits;
+    std::memcpy(&bits, &number, sizeof(bits));
+    tag = Mix(bits ^ kNumberSeed ^ kTagSeed);
+    check = Mix(bits ^ kNumberSeed ^ kCheckSeed);
+  } else {
+    Napi::TypeError::New(env, "Rate limit keys must be strings or numbers").ThrowAsJavaScriptException();
+    return false;
+  }
+  
+  // 0 marks a never-used slot
+  tag |= 1;
+  return true;
+}
+
+bool RateLimiter::Acquire(Napi::Env env, Napi::Value key, double cost, uint64_t nowNs, bool& ok) {
+  uint64_t tag;
+  uint64_t check;
+  if (!HashValue(env, key, tag, check)) {
+    return false;
+  }
+  ok = table_->TryAcquire(tag, check, cost, nowNs, retryAfterNs_);
+  return true;
+}
+
+static bool ReadCost(Napi::Env env, const Napi::CallbackInfo& info, size_t index, double& cost) {
+  cost = 1;
+  if (info.Length() > index && !info[index].IsUndefined()) {
+    if (!info[index].IsNumber() || !(info[index].As<Napi::Number>().DoubleValue() >= 0)) {
+      Napi::TypeError::New(env, "cost must be a non-negative number").ThrowAsJavaScriptException();
+      return false;
+    }
+    cost = info[index].As<Napi::Number>().DoubleValue();
+  }
+  return true;
+}
+
+// tryAcquire(key, cost = 1) -> boolean
+Napi::Value RateLimiter::TryAcquire(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  double cost;
+  
+  if (info.Length() < 1 || !ReadCost(env, info, 1, cost)) {
+    if (!env.IsExceptionPending()) {
+      Napi::TypeError::New(env, "Expected a key").ThrowAsJavaScriptException();
+    }
+    return env.Null();
+  }
+  
+  bool ok = false;
+  if (!Acquire(env, info[0], cost, OperationSpan::NowNs(), ok)) {
+    return env.Null();
+  }
+  return Napi::Boolean::New(env, ok);
+}
+
+// tryAcquireMany(keys, cost = 1, out?) -> number of keys granted. One clock
+// read covers the batch; results go to out (a Uint8Array) when given.
+Napi::Value RateLimiter::TryAcquireMany(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  double cost;
+  
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected an array of keys").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (!ReadCost(env, info, 1, cost)) {
+    return env.Null();
+  }
+  
+  Napi::Array keys = info[0].As<Napi::Array>();
+  uint32_t count = keys.Length();
+  uint8_t* results = nullptr;
+  if (info.Length() > 2 && !info[2].IsUndefined()) {
+    if (!info[2].IsTypedArray() || info[2].As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array ||
+        info[2].As<Napi::Uint8Array>().ElementLength() < count) {
+      Napi::TypeError::New(env, "out must be a Uint8Array with room for every key").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    results = info[2].As<Napi::Uint8Array>().Data();
+  }
+  
+  uint64_t nowNs = OperationSpan::NowNs();
+  uint32_t granted = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    bool ok = false;
+    if (!Acquire(env, keys.Get(i), cost, nowNs, ok)) {
+      return env.Null();
+    }
+    granted += ok;
+    if (results) {
+      results[i] = ok ? 1 : 0;
+    }
+  }
+  return Napi::Number::New(env, granted);
+}
+
+Napi::Value RateLimiter::Reset(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  uint64_t tag;
+  uint64_t check;
+  if (info.Length() < 1 || !HashValue(env, info[0], tag, check)) {
+    if (!env.IsExceptionPending()) {
+      Napi::TypeError::New(env, "Expected a key").ThrowAsJavaScriptException();
+    }
+    return env.Null();
+  }
+  table_->Reset(tag, check);
+  return env.Undefined();
+}
+
+Napi::Value RateLimiter::GetRetryAfter(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), std::ceil(static_cast<double>(retryAfterNs_) / 1e6));
+}
+
+Napi::Value RateLimiter::GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  uint64_t allowed = 0;
+  uint64_t denied = 0;
+  uint64_t keys = 0;
+  uint64_t evictions = 0;
+  for (const RateLimitTable::Shard& shard : table_->shards) {
+    allowed += shard.allowed.load(std::memory_order_relaxed);
+    denied += shard.denied.load(std::memory_order_relaxed);
+    keys += shard.keys.load(std::memory_order_relaxed);
+    evictions += shard.evictions.load(std::memory_order_relaxed);
+  }
+  
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("allowed", Napi::Number::New(env, static_cast<double>(allowed)));
+  stats.Set("denied", Napi::Number::New(env, static_cast<double>(denied)));
+  stats.Set("keys", Napi::Number::New(env, static_cast<double>(keys)));
+  stats.Set("evictions", Napi::Number::New(env, static_cast<double>(evictions)));
+  stats.Set("capacity", Napi::Number::New(env, static_cast<double>(table_->Capacity())));
+  return stats;
+}
@@ -0,0 +1,102 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <napi.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Per-key GCRA (generic cell rate algorithm) state. The whole bucket is one
+// word: the theoretical arrival time (TAT) of the next request. Refill is
+// implicit in the clock, so idle keys cost nothing until they are used.
+// Two slots share a cache line.
+struct alignas(32) RateLimitSlot {
+  std::atomic<uint64_t> tag{0};    // key hash; 0 = never used
+  std::atomic<uint64_t> check{0};  // independent second hash of the key
+  std::atomic<uint64_t> tat{0};    // ns on OperationSpan's clock; kLocked while recycled
+};
+
+// Sharded open-addressing table of GCRA slots. Acquires on known keys are a
+// probe plus one CAS; only new keys take the shard lock, and they recycle
+// slots whose bucket has refilled completely (losing nothing) or else the
+// most refilled one in their probe window. Safe to share between threads.
+class RateLimitTable {
+public:
+  static const uint64_t kLocked = UINT64_MAX;
+  static const uint32_t kShardCount = 16;
+  static const uint32_t kProbeLimit = 16;
+
+  RateLimitTable(double maxRequests, double windowMs, double burst, size_t maxKeys);
+
+  // true if cost units were granted; otherwise retryAfterNs says when they would be
+  bool TryAcquire(uint64_t tag, uint64_t check, double cost, uint64_t nowNs, uint64_t& retryAfterNs);
+
+  // Forget a key; its next request starts with a full bucket
+  void Reset(uint64_t tag, uint64_t check);
+
+  uint64_t EmissionIntervalNs() const { return intervalNs_; }
+  size_t Capacity() const { return static_cast<size_t>(kShardCount) * (shardMask_ + 1); }
+
+  // Configuration, to check limiters that share a name agree
+  double maxRequests;
+  double windowMs;
+  double burst;
+  size_t maxKeys;
+
+  struct alignas(64) Shard {
+    std::mutex mutex;                     // inserts and evictions only
+    std::unique_ptr<RateLimitSlot[]> slots;
+    std::atomic<uint64_t> allowed{0};
+    std::atomic<uint64_t> denied{0};
+    std::atomic<uint64_t> keys{0};
+    std::atomic<uint64_t> evictions{0};
+  };
+
+  Shard shards[kShardCount];
+
+private:
+  RateLimitSlot* Find(Shard& shard, uint64_t tag, uint64_t check);
+  RateLimitSlot* Insert(Shard& shard, uint64_t tag, uint64_t check);
+
+  uint64_t intervalNs_;   // window / maxRequests: one request's worth of time
+  uint64_t toleranceNs_;  // burst * interval: how far TAT may run ahead of now
+  size_t shardMask_;
+};
+
+// Native limiter behind enableRateLimiting.
+//
+//   new RateLimiter({ maxRequests, windowMs, burst?, maxKeys?, name? })
+//   tryAcquire(key, cost = 1)              -> boolean
+//   tryAcquireMany(keys, cost = 1, out?)   -> number granted; out[i] is 1 or 0
+//   retryAfter                             ms until the last denied request would pass
+//   reset(key)
+//   stats                                  { allowed, denied, keys, evictions, capacity }
+//
+// Keys are strings or numbers. Limiters created with the same name share one
+// table, so worker threads enforce a single limit. Neither acquire path
+// allocates for string keys up to 256 UTF-8 bytes or when out is supplied.
+class RateLimiter : public Napi::ObjectWrap<RateLimiter> {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(Napi::Env env, Napi::Object config);
+
+  RateLimiter(const Napi::CallbackInfo& info);
+
+private:
+  static Napi::FunctionReference constructor;
+
+  Napi::Value TryAcquire(const Napi::CallbackInfo& info);
+  Napi::Value TryAcquireMany(const Napi::CallbackInfo& info);
+  Napi::Value Reset(const Napi::CallbackInfo& info);
+  Napi::Value GetRetryAfter(const Napi::CallbackInfo& info);
+  Napi::Value GetStats(const Napi::CallbackInfo& info);
+
+  bool Acquire(Napi::Env env, Napi::Value key, double cost, uint64_t nowNs, bool& ok);
+
+  std::shared_ptr<RateLimitTable> table_;
+  uint64_t retryAfterNs_;
+};
+
+#endif // RATE_LIMITER_H
@@ -0,0 +1,20 @@
+import * as path from 'path';
+
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const addon = require(path.join(__dirname, '..', 'build', 'Release', 'node_streams_addon.node'));
+
+describe('RateLimiter', () => {
+  it('should give clients with long non-ASCII keys separate cells', () => {
+    const limiter = new addon.RateLimiter({ maxRequests: 1, windowMs: 60000 });
+    // 86 three-byte characters (258 bytes), so the keys differ only after byte 256
+    const prefix = '€'.repeat(86);
+    const first = prefix + 'a';
+    const second = prefix + 'b';
+
+    expect(Buffer.byteLength(prefix)).toBeGreaterThan(256);
+    expect(limiter.tryAcquire(first)).toBe(true);
+    expect(limiter.tryAcquire(second)).toBe(true);
+    expect(limiter.tryAcquire(first)).toBe(false);
+    expect(limiter.tryAcquire(second)).toBe(false);
+  });
+});
@@ -0,0 +1,765 @@
+#include "stream_checkpoint.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The walk uses the N-API C functions directly: a checkpoint visits every
+// property of every open stream, and one call per step without wrapper
+// temporaries is what keeps 10k streams well inside a restart budget.
+
+namespace {
+
+enum ValueTag : uint8_t {
+  kTagNull = 0,
+  kTagFalse = 1,
+  kTagTrue = 2,
+  kTagInteger = 3,
+  kTagDouble = 4,
+  kTagString = 5,
+  kTagBytes = 6,
+  kTagDate = 7,
+  kTagArray = 8,
+  kTagObject = 9,
+};
+
+const uint32_t kMaxDepth = 64;
+const double kMaxSafeInteger = 9007199254740991.0;
+const size_t kShortString = 64;  // UTF-16 units, terminator included
+
+inline uint64_t ZigZag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t UnZigZag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline uint64_t LoadLE(const uint8_t* data, size_t length) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < length; i++) {
+    value |= static_cast<uint64_t>(data[i]) << (8 * i);
+  }
+  return value;
+}
+
+bool Throw(napi_env env, const std::string& message) {
+  bool pending = false;
+  napi_is_exception_pending(env, &pending);
+  if (!pending) {
+    napi_throw_range_error(env, nullptr, message.c_str());
+  }
+  return false;
+}
+
+size_t ElementSize(napi_typedarray_type type) {
+  switch (type) {
+    case napi_int16_array:
+    case napi_uint16_array:
+      return 2;
+    case napi_int32_array:
+    case napi_uint32_array:
+    case napi_float32_array:
+      return 4;
+    case napi_float64_array:
+    case napi_bigint64_array:
+    case napi_biguint64_array:
+      return 8;
+    default:
+      return 1;
+  }
+}
+
+// Most names and values are short ASCII. Those are fetched as UTF-16, a
+// plain widening copy, and narrowed here instead of being transcoded; the
+// rest is measured and transcoded to UTF-8 by V8.
+void PutString(napi_env env, napi_value value, CheckpointWriter& out) {
+  char16_t units[kShortString];
+  size_t copied = 0;
+  napi_get_value_string_utf16(env, value, units, kShortString, &copied);
+  if (copied + 1 < kShortString) {
+    char16_t bits = 0;
+    for (size_t i = 0; i < copied; i++) {
+      bits |= units[i];
+    }
+    if (bits < 0x80) {
+      out.PutVarint(copied);
+      if (uint8_t* room = out.Room(copied)) {
+        for (size_t i = 0; i < copied; i++) {
+          room[i] = static_cast<uint8_t>(units[i]);
+        }
+      }
+      out.Advance(copied);
+      return;
+    }
+  }
+  
+  size_t length = 0;
+  napi_get_value_string_utf8(env, value, nullptr, 0, &length);
+  out.PutVarint(length);
+  if (uint8_t* target = out.Room(length + 1)) {  // the copy is NUL-terminated
+    napi_get_value_string_utf8(env, value, reinterpret_cast<char*>(target), length + 1, &copied);
+  } else if (uint8_t* exact = out.Room(length)) {
+    std::string copy(length + 1, '\0');
+    napi_get_value_string_utf8(env, value, &copy[0], length + 1, &copied);
+    std::memcpy(exact, copy.data(), length);
+  }
+  out.Advance(length);
+}
+
+bool EncodeValue(napi_env env, napi_value value, napi_valuetype type, CheckpointWriter& out, uint32_t depth);
+
+bool EncodeValue(napi_env env, napi_value value, CheckpointWriter& out, uint32_t depth) {
+  napi_valuetype type;
+  if (napi_typeof(env, value, &type) != napi_ok) {
+    return Throw(env, "Unreadable stream state");
+  }
+  return EncodeValue(env, value, type, out, depth);
+}
+
+bool EncodeValue(napi_env env, napi_value value, napi_valuetype type, CheckpointWriter& out, uint32_t depth) {
+  switch (type) {
+    case napi_boolean: {
+      bool flag = false;
+      napi_get_value_bool(env, value, &flag);
+      out.PutByte(flag ? kTagTrue : kTagFalse);
+      return true;
+    }
+    
+    case napi_number: {
+      double number = 0;
+      napi_get_value_double(env, value, &number);
+      if (std::trunc(number) == number && std::fabs(number) <= kMaxSafeInteger &&
+          !(number == 0 && std::signbit(number))) {
+        out.PutByte(kTagInteger);
+        out.PutVarint(ZigZag(static_cast<int64_t>(number)));
+      } else {
+        out.PutByte(kTagDouble);
+        out.PutDouble(number);
+      }
+      return true;
+    }
+    
+    case napi_string:
+      out.PutByte(kTagString);
+      PutString(env, value, out);
+      return true;
+    
+    case napi_bigint:
+      return Throw(env, "BigInt values cannot be checkpointed");
+    
+    case napi_object:
+      break;
+    
+    default:
+      // null, undefined, and functions or symbols inside arrays
+      out.PutByte(kTagNull);
+      return true;
+  }
+  
+  if (depth >= kMaxDepth) {
+    return Throw(env, "Stream state nests deeper than " + std::to_string(kMaxDepth) + " levels; is it cyclic?");
+  }
+  
+  bool is = false;
+  napi_is_typedarray(env, value, &is);
+  if (is) {
+    napi_typedarray_type arrayType;
+    size_t length = 0;
+    void* data = nullptr;
+    napi_get_typedarray_info(env, value, &arrayType, &length, &data, nullptr, nullptr);
+    size_t bytes = length * ElementSize(arrayType);
+    out.PutByte(kTagBytes);
+    out.PutVarint(bytes);
+    out.PutBytes(data, bytes);
+    return true;
+  }
+  
+  napi_is_arraybuffer(env, value, &is);
+  if (is) {
+    void* data = nullptr;
+    size_t bytes = 0;
+    napi_get_arraybuffer_info(env, value, &data, &bytes);
+    out.PutByte(kTagBytes);
+    out.PutVarint(bytes);
+    out.PutBytes(data, bytes);
+    return true;
+  }
+  
+  napi_is_date(env, value, &is);
+  if (is) {
+    double time = 0;
+    napi_get_date_value(env, value, &time);
+    out.PutByte(kTagDate);
+    out.PutDouble(time);
+    return true;
+  }
+  
+  napi_is_array(env, value, &is);
+  if (is) {
+    uint32_t length = 0;
+    napi_get_array_length(env, value, &length);
+    out.PutByte(kTagArray);
+    out.PutU32(length);
+    for (uint32_t i = 0; i < length; i++) {
+      napi_value element;
+      napi_get_element(env, value, i, &element);
+      if (!EncodeValue(env, element, out, depth + 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  
+  // Own enumerable string keys, so prototypes and native accessors stay out
+  napi_value keys;
+  if (napi_get_all_property_names(env, value, napi_key_own_only,
+                                  static_cast<napi_key_filter>(napi_key_enumerable | napi_key_skip_symbols),
+                                  napi_key_numbers_to_strings, &keys) != napi_ok) {
+    return Throw(env, "Unreadable stream state");
+  }
+  uint32_t length = 0;
+  napi_get_array_length(env, keys, &length);
+  
+  out.PutByte(kTagObject);
+  size_t countAt = out.Size();
+  out.PutU32(0);
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < length; i++) {
+    napi_value key;
+    napi_value property;
+    napi_get_element(env, keys, i, &key);
+    napi_valuetype type;
+    if (napi_get_property(env, value, key, &property) != napi_ok || napi_typeof(env, property, &type) != napi_ok) {
+      return Throw(env, "Unreadable stream state");
+    }
+    // Left out, as JSON.stringify would
+    if (type == napi_undefined || type == napi_function || type == napi_symbol) {
+      continue;
+    }
+    PutString(env, key, out);
+    if (!EncodeValue(env, property, type, out, depth + 1)) {
+      return false;
+    }
+    count++;
+  }
+  out.PatchU32(countAt, count);
+  return true;
+}
+
+// Bounds-checked cursor over one record; every failure is a corrupt file
+class Reader {
+public:
+  Reader(const uint8_t* data, size_t begin, size_t end) : data_(data), offset_(begin), end_(end) {}
+  
+  bool Byte(uint8_t& value) {
+    if (offset_ >= end_) {
+      return false;
+    }
+    value = data_[offset_++];
+    return true;
+  }
+  
+  bool Varint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 70 && offset_ < end_; shift += 7) {
+      uint8_t byte = data_[offset_++];
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  
+  bool Fixed(size_t length, uint64_t& value) {
+    if (end_ - offset_ < length) {
+      return false;
+    }
+    value = LoadLE(data_ + offset_, length);
+    offset_ += length;
+    return true;
+  }
+  
+  bool Span(uint64_t length, size_t& at) {
+    if (end_ - offset_ < length) {
+      return false;
+    }
+    at = offset_;
+    offset_ += static_cast<size_t>(length);
+    return true;
+  }
+  
+  size_t Offset() const { return offset_; }
+  size_t Remaining() const { return end_ - offset_; }
+
+private:
+  const uint8_t* data_;
+  size_t offset_;
+  size_t end_;
+};
+
+// The checkpoint's bytes and where its views are created from
+struct Source {
+  const uint8_t* data;
+  size_t length;
+  napi_value arrayBuffer;
+  size_t byteOffset;
+};
+
+bool Corrupt(napi_env env, const Reader& in) {
+  return Throw(env, "Corrupt checkpoint at byte " + std::to_string(in.Offset()));
+}
+
+// Property names repeat across every stream, so each distinct name is made
+// once per read; V8 then also finds it already internalised on every set.
+// Direct-mapped: a collision only costs a fresh string.
+class KeyCache {
+public:
+  KeyCache() : entries_() {}
+  
+  napi_value Get(napi_env env, const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length && i < kHashedBytes; i++) {
+      hash = (hash ^ data[i]) * 16777619u;
+    }
+    Entry& entry = entries_[(hash ^ static_cast<uint32_t>(length)) & (kSlots - 1)];
+    if (entry.value && entry.length == length && std::memcmp(entry.data, data, length) == 0) {
+      return entry.value;
+    }
+    napi_value key;
+    napi_create_string_utf8(env, reinterpret_cast<const char*>(data), length, &key);
+    if (length <= kMaxCachedLength) {
+      entry.data = data;
+      entry.length = length;
+      entry.value = key;
+    }
+    return key;
+  }
+
+private:
+  static const size_t kSlots = 256;
+  static const size_t kHashedBytes = 16;
+  static const size_t kMaxCachedLength = 64;
+  
+  struct Entry {
+    const uint8_t* data;  // into the checkpoint being read
+    size_t length;
+    napi_value value;
+  };
+  
+  Entry entries_[kSlots];
+};
+
+bool DecodeKey(napi_env env, const Source& source, KeyCache& keys, Reader& in, napi_value& result) {
+  uint64_t length;
+  size_t at;
+  if (!in.Varint(length) || !in.Span(length, at)) {
+    return Corrupt(env, in);
+  }
+  result = keys.Get(env, source.data + at, static_cast<size_t>(length));
+  return true;
+}
+
+bool DecodeString(napi_env env, const Source& source, Reader& in, napi_value& result) {
+  uint64_t length;
+  size_t at;
+  if (!in.Varint(length) || !in.Span(length, at)) {
+    return Corrupt(env, in);
+  }
+  napi_create_string_utf8(env, reinterpret_cast<const char*>(source.data + at), static_cast<size_t>(length), &result);
+  return true;
+}
+
+bool DecodeValue(napi_env env, const Source& source, KeyCache& keys, Reader& in, uint32_t depth,
+                 napi_value& result) {
+  uint8_t tag;
+  if (!in.Byte(tag)) {
+    return Corrupt(env, in);
+  }
+  
+  uint64_t word;
+  switch (tag) {
+    case kTagNull:
+      napi_get_null(env, &result);
+      return true;
+    
+    case kTagFalse:
+    case kTagTrue:
+      napi_get_boolean(env, tag == kTagTrue, &result);
+      return true;
+    
+    case kTagInteger:
+      if (!in.Varint(word)) {
+        return Corrupt(env, in);
+      }
+      napi_create_double(env, static_cast<double>(UnZigZag(word)), &result);
+      return true;
+    
+    case kTagDouble:
+    case kTagDate: {
+      if (!in.Fixed(8, word)) {
+        return Corrupt(env, in);
+      }
+      double number;
+      std::memcpy(&number, &word, sizeof(number));
+      if (tag == kTagDate) {
+        napi_create_date(env, number, &result);
+      } else {
+        napi_create_double(env, number, &result);
+      }
+      return true;
+    }
+    
+    case kTagString:
+      return DecodeString(env, source, in, result);
+    
+    case kTagBytes: {
+      size_t at;
+      if (!in.Varint(word) || !in.Span(word, at)) {
+        return Corrupt(env, in);
+      }
+      napi_create_typedarray(env, napi_uint8_array, static_cast<size_t>(word), source.arrayBuffer,
+                             source.byteOffset + at, &result);
+      return true;
+    }
+    
+    case kTagArray:
+    case kTagObject: {
+      // Every element takes at least a byte, which bounds corrupt counts
+      if (depth >= kMaxDepth || !in.Fixed(4, word) || word > in.Remaining()) {
+        return Corrupt(env, in);
+      }
+      uint32_t count = static_cast<uint32_t>(word);
+      if (tag == kTagArray) {
+        napi_create_array_with_length(env, count, &result);
+      } else {
+        napi_create_object(env, &result);
+      }
+      for (uint32_t i = 0; i < count; i++) {
+        napi_value key = nullptr;
+        napi_value element;
+        if ((tag == kTagObject && !DecodeKey(env, source, keys, in, key)) ||
+            !DecodeValue(env, source, keys, in, depth + 1, element)) {
+          return false;
+        }
+        if (tag == kTagArray) {
+          napi_set_element(env, result, i, element);
+        } else {
+          napi_set_property(env, result, key, element);
+        }
+      }
+      return true;
+    }
+    
+    default:
+      return Corrupt(env, in);
+  }
+}
+
+bool GetSource(napi_env env, napi_value checkpoint, Source& source) {
+  bool isTypedArray = false;
+  napi_is_typedarray(env, checkpoint, &isTypedArray);
+  napi_typedarray_type type;
+  void* data = nullptr;
+  if (!isTypedArray ||
+      napi_get_typedarray_info(env, checkpoint, &type, &source.length, &data, &source.arrayBuffer,
+                               &source.byteOffset) != napi_ok ||
+      type != napi_uint8_array) {
+    napi_throw_type_error(env, nullptr, "Expected checkpoint buffer");
+    return false;
+  }
+  source.data = static_cast<const uint8_t*>(data);
+  return true;
+}
+
+uint32_t Checksum(const uint8_t* data, size_t length) {
+  uLong crc = crc32(0L, Z_NULL, 0);
+  // zlib takes 32-bit lengths
+  while (length > 0) {
+    uInt chunk = static_cast<uInt>(std::min<size_t>(length, 1u << 30));
+    crc = crc32(crc, data, chunk);
+    data += chunk;
+    length -= chunk;
+  }
+  return static_cast<uint32_t>(crc);
+}
+
+bool ReadRecord(napi_env env, const Source& source, KeyCache& keys, const CheckpointHeader& header, uint32_t index,
+                napi_value& result) {
+  uint64_t offset = LoadLE(source.data + header.indexOffset + 8 * static_cast<size_t>(index), 8);
+  if (offset < kCheckpointHeaderSize || offset >= header.indexOffset) {
+    return Throw(env, "Corrupt checkpoint index entry " + std::to_string(index));
+  }
+  Reader in(source.data, static_cast<size_t>(offset), static_cast<size_t>(header.indexOffset));
+  return DecodeValue(env, source, keys, in, 0, result);
+}
+
+} // namespace
+
+CheckpointWriter::CheckpointWriter(uint8_t* target, size_t capacity)
+  : data_(target), capacity_(capacity), size_(0), owned_(false) {}
+
+CheckpointWriter::CheckpointWriter(size_t initialCapacity)
+  : data_(static_cast<uint8_t*>(std::malloc(std::max<size_t>(initialCapacity, 4096)))),
+    capacity_(data_ ? std::max<size_t>(initialCapacity, 4096) : 0),
+    size_(0),
+    owned_(true) {}
+
+CheckpointWriter::~CheckpointWriter() {
+  if (owned_) {
+    std::free(data_);
+  }
+}
+
+bool CheckpointWriter::Grow(size_t n) {
+  if (!owned_ || size_ > capacity_) {
+    return false;
+  }
+  size_t capacity = std::max(capacity_ * 2, size_ + n);
+  uint8_t* data = static_cast<uint8_t*>(std::realloc(data_, capacity));
+  if (!data) {
+    return false;
+  }
+  data_ = data;
+  capacity_ = capacity;
+  return true;
+}
+
+uint8_t* CheckpointWriter::Release() {
+  uint8_t* data = data_;
+  data_ = nullptr;
+  capacity_ = 0;
+  owned_ = false;
+  return data;
+}
+
+bool ParseCheckpointHeader(const uint8_t* data, size_t length, CheckpointHeader& header, std::string& error) {
+  if (length < kCheckpointHeaderSize || LoadLE(data, 4) != kCheckpointMagic) {
+    error = "Not a stream checkpoint";
+    return false;
+  }
+  header.version = static_cast<uint16_t>(LoadLE(data + 4, 2));
+  header.flags = static_cast<uint16_t>(LoadLE(data + 6, 2));
+  header.count = static_cast<uint32_t>(LoadLE(data + 8, 4));
+  header.crc = static_cast<uint32_t>(LoadLE(data + 12, 4));
+  header.byteLength = LoadLE(data + 16, 8);
+  header.indexOffset = LoadLE(data + 24, 8);
+  
+  if (header.version == 0 || header.version > kCheckpointVersion) {
+    error = "Unsupported checkpoint version " + std::to_string(header.version);
+    return false;
+  }
+  if (header.byteLength > length || header.indexOffset < kCheckpointHeaderSize || header.indexOffset % 8 != 0 ||
+      header.indexOffset > header.byteLength || (header.byteLength - header.indexOffset) / 8 < header.count) {
+    error = "Truncated checkpoint";
+    return false;
+  }
+  return true;
+}
+
+bool WriteCheckpoint(napi_env env, napi_value states, CheckpointWriter& writer) {
+  // The header goes in last, so a target that was too small never holds
+  // something that looks like a checkpoint
+  static const uint8_t kBlankHeader[kCheckpointHeaderSize] = {};
+  writer.PutBytes(kBlankHeader, sizeof(kBlankHeader));
+  
+  bool isArray = false;
+  napi_is_array(env, states, &isArray);
+  uint32_t count = 1;
+  if (isArray) {
+    napi_get_array_length(env, states, &count);
+  }
+  
+  std::vector<uint64_t> offsets;
+  offsets.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    // Handles from the walk are dropped per stream rather than piling up
+    // in the caller's scope
+    napi_handle_scope scope;
+    napi_open_handle_scope(env, &scope);
+    napi_value state = states;
+    if (isArray) {
+      napi_get_element(env, states, i, &state);
+    }
+    offsets.push_back(writer.Size());
+    bool encoded = EncodeValue(env, state, writer, 0);
+    napi_close_handle_scope(env, scope);
+    if (!encoded) {
+      return false;
+    }
+  }
+  
+  while (writer.Size() % 8 != 0) {
+    writer.PutByte(0);
+  }
+  size_t indexOffset = writer.Size();
+  for (uint64_t offset : offsets) {
+    writer.PutU64(offset);
+  }
+  
+  if (writer.Fits()) {
+    uint8_t* data = writer.Data();
+    size_t size = writer.Size();
+    writer.PatchU32(0, kCheckpointMagic);
+    writer.PatchU32(4, kCheckpointVersion | static_cast<uint32_t>(isArray ? 0 : kCheckpointSingle) << 16);
+    writer.PatchU32(8, count);
+    writer.PatchU32(12, Checksum(data + kCheckpointHeaderSize, size - kCheckpointHeaderSize));
+    writer.PatchU64(16, size);
+    writer.PatchU64(24, indexOffset);
+  }
+  return true;
+}
+
+napi_value ReadCheckpoint(napi_env env, napi_value checkpoint, int64_t index) {
+  Source source;
+  if (!GetSource(env, checkpoint, source)) {
+    return nullptr;
+  }
+  CheckpointHeader header;
+  std::string error;
+  if (!ParseCheckpointHeader(source.data, source.length, header, error)) {
+    Throw(env, error);
+    return nullptr;
+  }
+  
+  KeyCache keys;
+  napi_value result = nullptr;
+  if (index >= 0) {
+    if (index >= header.count) {
+      Throw(env, "Checkpoint has " + std::to_string(header.count) + " records, not " + std::to_string(index + 1));
+      return nullptr;
+    }
+    return ReadRecord(env, source, keys, header, static_cast<uint32_t>(index), result) ? result : nullptr;
+  }
+  
+  if (Checksum(source.data + kCheckpointHeaderSize, static_cast<size_t>(header.byteLength) - kCheckpointHeaderSize) !=
+      header.crc) {
+    Throw(env, "Checkpoint checksum mismatch");
+    return nullptr;
+  }
+  if ((header.flags & kCheckpointSingle) && header.count == 1) {
+    return ReadRecord(env, source, keys, header, 0, result) ? result : nullptr;
+  }
+  
+  napi_create_array_with_length(env, header.count, &result);
+  for (uint32_t i = 0; i < header.count; i++) {
+    napi_value state;
+    if (!ReadRecord(env, source, keys, header, i, state)) {
+      return nullptr;
+    }
+    napi_set_element(env, result, i, state);
+  }
+  return result;
+}
+
+napi_value InspectCheckpoint(napi_env env, napi_value checkpoint) {
+  Source source;
+  if (!GetSource(env, checkpoint, source)) {
+    return nullptr;
+  }
+  
+  CheckpointHeader header;
+  std::string error;
+  bool valid = ParseCheckpointHeader(source.data, source.length, header, error);
+  if (valid && Checksum(source.data + kCheckpointHeaderSize, static_cast<size_t>(header.byteLength) - kCheckpointHeaderSize) !=
+      header.crc) {
+    valid = false;
+    error = "Checkpoint checksum mismatch";
+  }
+  
+  napi_value result;
+  napi_value field;
+  napi_create_object(env, &result);
+  napi_get_boolean(env, valid, &field);
+  napi_set_named_property(env, result, "valid", field);
+  if (!valid) {
+    napi_create_string_utf8(env, error.data(), error.size(), &field);
+    napi_set_named_property(env, result, "error", field);
+  }
+  if (valid || error == "Checkpoint checksum mismatch") {
+    napi_create_uint32(env, header.version, &field);
+    napi_set_named_property(env, result, "version", field);
+    napi_create_uint32(env, header.count, &field);
+    napi_set_named_property(env, result, "count", field);
+    napi_create_double(env, static_cast<double>(header.byteLength), &field);
+    napi_set_named_property(env, result, "byteLength", field);
+  }
+  return result;
+}
+
+#ifdef _WIN32
+
+napi_value MapCheckpointFile(napi_env env, const std::string& path) {
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    napi_throw_error(env, nullptr, ("Cannot open checkpoint " + path).c_str());
+    return nullptr;
+  }
+  LARGE_INTEGER size;
+  HANDLE mapping = nullptr;
+  void* data = nullptr;
+  if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+    mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  }
+  if (mapping) {
+    data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+  }
+  CloseHandle(file);
+  if (!data) {
+    napi_throw_error(env, nullptr, ("Cannot map checkpoint " + path).c_str());
+    return nullptr;
+  }
+  
+  napi_value buffer;
+  napi_create_external_buffer(env, static_cast<size_t>(size.QuadPart), data,
+                              [](napi_env, void* mapped, void*) { UnmapViewOfFile(mapped); }, nullptr, &buffer);
+  return buffer;
+}
+
+#else
+
+napi_value MapCheckpointFile(napi_env env, const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    napi_throw_error(env, nullptr, ("Cannot open checkpoint " + path + ": " + std::strerror(errno)).c_str());
+    return nullptr;
+  }
+  struct stat info;
+  void* data = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    // Private and writable: a stray write to the Buffer copies the page
+    // instead of faulting or reaching the file
+    data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (data == MAP_FAILED) {
+    napi_throw_error(env, nullptr, ("Cannot map checkpoint " + path).c_str());
+    return nullptr;
+  }
+  
+  size_t* length = new size_t(static_cast<size_t>(info.st_size));
+  napi_value buffer;
+  napi_create_external_buffer(env, *length, data,
+                              [](napi_env, void* mapped, void* hint) {
+                                size_t* length = static_cast<size_t*>(hint);
+                                munmap(mapped, *length);
+                                delete length;
+                              }, length, &buffer);
+  return buffer;
+}
+
+#endif
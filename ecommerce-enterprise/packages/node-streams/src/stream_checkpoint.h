@@ -0,0 +1,155 @@
+#ifndef STREAM_CHECKPOINT_H
+#define STREAM_CHECKPOINT_H
+
+#include <napi.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Binary checkpoint of stream state: descriptors, pipeline configurations
+// and the chunks they still buffer, so a restarted process can pick its
+// streams back up.
+//
+//   header   'NSCP' | version u16 | flags u16 | count u32 | crc32 u32 |
+//            byteLength u64 | indexOffset u64                     (32 bytes)
+//   records  one tagged value per stream, back to back
+//   index    count u64 record offsets, 8-byte aligned
+//
+// Integers are little-endian and crc32 covers everything after the header.
+// A value is a tag byte and then: nothing (null, false, true), a zigzag
+// varint (integer), 8 bytes (double, date), a varint length and the data
+// (string, bytes) or a u32 count and the elements / key-value pairs (array,
+// object). Functions, symbols and undefined properties are left out; typed
+// arrays and ArrayBuffers are stored as bytes. Readers reject versions
+// newer than their own, so a new tag means a new version.
+const uint32_t kCheckpointMagic = 0x5043534E;  // "NSCP"
+const uint16_t kCheckpointVersion = 1;
+const size_t kCheckpointHeaderSize = 32;
+const uint16_t kCheckpointSingle = 1;  // flag: written from one state, not an array
+
+struct CheckpointHeader {
+  uint16_t version;
+  uint16_t flags;
+  uint32_t count;
+  uint32_t crc;
+  uint64_t byteLength;
+  uint64_t indexOffset;
+};
+
+// Output of one serialisation pass: a caller's fixed buffer, or storage
+// that grows. A fixed target that turns out too small keeps counting, so
+// the same pass tells the caller how much room it needs.
+class CheckpointWriter {
+public:
+  CheckpointWriter(uint8_t* target, size_t capacity);
+  explicit CheckpointWriter(size_t initialCapacity);
+  ~CheckpointWriter();
+
+  CheckpointWriter(const CheckpointWriter&) = delete;
+  CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+  // Writable space for n bytes at the end, or nullptr once a fixed target is
+  // full; either way the caller then moves on with Advance(n)
+  uint8_t* Room(size_t n) {
+    if (size_ <= capacity_ && n <= capacity_ - size_) {
+      return data_ + size_;
+    }
+    return Grow(n) ? data_ + size_ : nullptr;
+  }
+
+  void Advance(size_t n) { size_ += n; }
+
+  void PutByte(uint8_t value) {
+    if (uint8_t* room = Room(1)) {
+      *room = value;
+    }
+    size_++;
+  }
+
+  void PutVarint(uint64_t value) {
+    uint8_t bytes[10];
+    size_t length = 0;
+    while (value >= 0x80) {
+      bytes[length++] = static_cast<uint8_t>(value) | 0x80;
+      value >>= 7;
+    }
+    bytes[length++] = static_cast<uint8_t>(value);
+    PutBytes(bytes, length);
+  }
+
+  void PutU32(uint32_t value) { PutBytes(StoreLE(value).data, 4); }
+  void PutU64(uint64_t value) { PutBytes(StoreLE(value).data, 8); }
+
+  void PutDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    PutU64(bits);
+  }
+
+  void PutBytes(const void* data, size_t length) {
+    if (uint8_t* room = Room(length)) {
+      std::memcpy(room, data, length);
+    }
+    size_ += length;
+  }
+
+  // Overwrite bytes already reserved; ignored for offsets past a full target
+  void PatchU32(size_t offset, uint32_t value) { Patch(offset, StoreLE(value).data, 4); }
+  void PatchU64(size_t offset, uint64_t value) { Patch(offset, StoreLE(value).data, 8); }
+
+  size_t Size() const { return size_; }
+  size_t Available() const { return size_ <= capacity_ ? capacity_ - size_ : 0; }
+  bool Fits() const { return size_ <= capacity_; }
+  uint8_t* Data() const { return data_; }
+
+  // Hand grown storage to the caller, who frees it with free()
+  uint8_t* Release();
+
+private:
+  struct Bytes {
+    uint8_t data[8];
+  };
+
+  static Bytes StoreLE(uint64_t value) {
+    Bytes bytes;
+    for (int i = 0; i < 8; i++) {
+      bytes.data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    return bytes;
+  }
+
+  void Patch(size_t offset, const uint8_t* data, size_t length) {
+    if (offset + length <= capacity_) {
+      std::memcpy(data_ + offset, data, length);
+    }
+  }
+
+  bool Grow(size_t n);
+
+  uint8_t* data_;
+  size_t capacity_;
+  size_t size_;
+  bool owned_;
+};
+
+// false with a reason unless data starts with a checkpoint this build reads
+bool ParseCheckpointHeader(const uint8_t* data, size_t length, CheckpointHeader& header, std::string& error);
+
+// Append the header, one record per state (states may be an array or one
+// object) and the index. false with a pending JS exception on values that
+// cannot be stored; otherwise writer.Fits() says whether the output is valid.
+bool WriteCheckpoint(napi_env env, napi_value states, CheckpointWriter& writer);
+
+// Decode every record (index < 0) or just record index. Bytes come back as
+// Uint8Array views into the checkpoint's own ArrayBuffer, so a Buffer from
+// MapCheckpointFile is read in place. Only full reads verify the checksum.
+napi_value ReadCheckpoint(napi_env env, napi_value checkpoint, int64_t index);
+
+// { valid, version, count, byteLength, error? }, checksum included
+napi_value InspectCheckpoint(napi_env env, napi_value checkpoint);
+
+// The file as a copy-on-write Buffer backed by the page cache; unmapped
+// once the Buffer and every view from ReadCheckpoint are collected
+napi_value MapCheckpointFile(napi_env env, const std::string& path);
+
+#endif // STREAM_CHECKPOINT_H
@@ -1,6 +1,12 @@
 #include "stream_operations.h"
 #include "flow_control.h"
 #include "performance_monitor.h"
+#include "encrypted_stream.h"
+#include "compressed_stream.h"
+#include "transform_pipeline.h"
+#include "frame_mux.h"
+#include "stream_checkpoint.h"
+#include <cstdlib>
 #include <random>
 #include <sstream>
 #include <iomanip>
@@ -8,7 +14,8 @@
 // Core stream operations
 Napi::Value CreateReadableStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("CreateReadableStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("CreateReadableStream");
+  OperationSpan span(kMetric);
   
   try {
     // Parse configuration
@@ -38,11 +45,11 @@ Napi::Value CreateReadableStream(const Napi::CallbackInfo& info) {
     result.Set("status", Napi::String::New(env, "active"));
     result.Set("createdAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("CreateReadableStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("CreateReadableStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to create readable stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -50,7 +57,8 @@ Napi::Value CreateReadableStream(const Napi::CallbackInfo& info) {
 
 Napi::Value CreateWritableStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("CreateWritableStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("CreateWritableStream");
+  OperationSpan span(kMetric);
   
   try {
     // Parse configuration
@@ -80,11 +88,11 @@ Napi::Value CreateWritableStream(const Napi::CallbackInfo& info) {
     result.Set("status", Napi::String::New(env, "active"));
     result.Set("createdAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("CreateWritableStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("CreateWritableStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to create writable stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -92,11 +100,32 @@ Napi::Value CreateWritableStream(const Napi::CallbackInfo& info) {
 
 Napi::Value CreateTransformStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("CreateTransformStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("CreateTransformStream");
+  OperationSpan span(kMetric);
   
   try {
     // Parse configuration
     Napi::Object config = info[0].As<Napi::Object>();
+    
+    // With a stage list the data path itself is native
+    if (config.Has("stages")) {
+      Napi::Object result = TransformPipeline::NewInstance(env, config);
+      if (env.IsExceptionPending()) {
+        span.End(false);
+        return env.Null();
+      }
+      
+      // Add stream descriptor
+      result.Set("streamId", Napi::String::New(env, GenerateStreamId()));
+      result.Set("type", Napi::String::New(env, "transform"));
+      result.Set("metrics", CreateMetricsObject(env, 0, 0, 0, 0));
+      result.Set("status", Napi::String::New(env, "active"));
+      result.Set("createdAt", Napi::String::New(env, GetCurrentTimestamp()));
+      
+      span.End();
+      return result;
+    }
+    
     std::string algorithm = config.Get("algorithm").As<Napi::String>().Utf8Value();
     bool enableEncryption = config.Get("enableEncryption").As<Napi::Boolean>().Value();
     bool enableCompression = config.Get("enableCompression").As<Napi::Boolean>().Value();
@@ -122,11 +151,11 @@ Napi::Value CreateTransformStream(const Napi::CallbackInfo& info) {
     result.Set("status", Napi::String::New(env, "active"));
     result.Set("createdAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("CreateTransformStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("CreateTransformStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to create transform stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -134,7 +163,8 @@ Napi::Value CreateTransformStream(const Napi::CallbackInfo& info) {
 
 Napi::Value CreateDuplexStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("CreateDuplexStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("CreateDuplexStream");
+  OperationSpan span(kMetric);
   
   try {
     // Parse configuration
@@ -164,11 +194,11 @@ Napi::Value CreateDuplexStream(const Napi::CallbackInfo& info) {
     result.Set("status", Napi::String::New(env, "active"));
     result.Set("createdAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("CreateDuplexStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("CreateDuplexStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to create duplex stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -177,25 +207,28 @@ Napi::Value CreateDuplexStream(const Napi::CallbackInfo& info) {
 // Enhanced stream operations
 Napi::Value CreateEncryptedStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("CreateEncryptedStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("CreateEncryptedStream");
+  OperationSpan span(kMetric);
   
   try {
     // Parse configuration
     Napi::Object config = info[0].As<Napi::Object>();
     std::string algorithm = config.Get("encryptionAlgorithm").As<Napi::String>().Utf8Value();
-    Napi::Buffer<uint8_t> keyBuffer = config.Get("encryptionKey").As<Napi::Buffer<uint8_t>>();
     bool enableIntegrityCheck = config.Get("enableIntegrityCheck").As<Napi::Boolean>().Value();
     
-    // Generate stream ID
-    std::string streamId = GenerateStreamId();
-    
-    // Create stream result
-    Napi::Object result = CreateStreamResult(env, streamId, "encrypted", algorithm);
+    // Create the native cipher; it validates the key/IV and keeps its own
+    // reference to the key schedule, so the key is not echoed back
+    Napi::Object result = EncryptedStream::NewInstance(env, config);
+    if (env.IsExceptionPending()) {
+      span.End(false);
+      return env.Null();
+    }
     
-    // Add encryption configuration
-    result.Set("encryptionKey", keyBuffer);
-    result.Set("enableIntegrityCheck", Napi::Boolean::New(env, enableIntegrityCheck));
+    // Add stream descriptor
+    result.Set("streamId", Napi::String::New(env, GenerateStreamId()));
+    result.Set("type", Napi::String::New(env, "encrypted"));
     result.Set("algorithm", Napi::String::New(env, algorithm));
+    result.Set("enableIntegrityCheck", Napi::Boolean::New(env, enableIntegrityCheck));
     
     // Add metrics
     Napi::Object metrics = CreateMetricsObject(env, 0, 0, 0, 0);
@@ -205,11 +238,11 @@ Napi::Value CreateEncryptedStream(const Napi::CallbackInfo& info) {
     result.Set("status", Napi::String::New(env, "active"));
     result.Set("createdAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("CreateEncryptedStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("CreateEncryptedStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to create encrypted stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -217,25 +250,27 @@ Napi::Value CreateEncryptedStream(const Napi::CallbackInfo& info) {
 
 Napi::Value CreateCompressedStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("CreateCompressedStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("CreateCompressedStream");
+  OperationSpan span(kMetric);
   
   try {
     // Parse configuration
     Napi::Object config = info[0].As<Napi::Object>();
-    std::string algorithm = config.Get("compressionAlgorithm").As<Napi::String>().Utf8Value();
-    int compressionLevel = config.Get("compressionLevel").As<Napi::Number>().Int32Value();
-    bool enableDictionary = config.Get("enableDictionary").As<Napi::Boolean>().Value();
-    
-    // Generate stream ID
-    std::string streamId = GenerateStreamId();
+    bool enableDictionary = config.Get("enableDictionary").IsBoolean() &&
+                            config.Get("enableDictionary").As<Napi::Boolean>().Value();
     
-    // Create stream result
-    Napi::Object result = CreateStreamResult(env, streamId, "compressed", algorithm);
+    // Create the native codec; it validates algorithm, level and window
+    Napi::Object result = CompressedStream::NewInstance(env, config);
+    if (env.IsExceptionPending()) {
+      span.End(false);
+      return env.Null();
+    }
     
-    // Add compression configuration
-    result.Set("compressionLevel", Napi::Number::New(env, compressionLevel));
-    result.Set("enableDictionary", Napi::Boolean::New(env, enableDictionary));
-    result.Set("algorithm", Napi::String::New(env, algorithm));
+    // Add stream descriptor
+    result.Set("streamId", Napi::String::New(env, GenerateStreamId()));
+    result.Set("type", Napi::String::New(env, "compressed"));
+    result.Set("compressionLevel", config.Get("compressionLevel"));
+    result.Set("enableDictionary", Napi::Boolean::New(env, enableDictionary || config.Get("dictionary").IsBuffer()));
     
     // Add metrics
     Napi::Object metrics = CreateMetricsObject(env, 0, 0, 0, 0);
@@ -245,11 +280,11 @@ Napi::Value CreateCompressedStream(const Napi::CallbackInfo& info) {
     result.Set("status", Napi::String::New(env, "active"));
     result.Set("createdAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("CreateCompressedStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("CreateCompressedStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to create compressed stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -257,7 +292,8 @@ Napi::Value CreateCompressedStream(const Napi::CallbackInfo& info) {
 
 Napi::Value CreateMultiplexedStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("CreateMultiplexedStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("CreateMultiplexedStream");
+  OperationSpan span(kMetric);
   
   try {
     // Parse configuration
@@ -266,11 +302,17 @@ Napi::Value CreateMultiplexedStream(const Napi::CallbackInfo& info) {
     bool enableLoadBalancing = config.Get("enableLoadBalancing").As<Napi::Boolean>().Value();
     bool enableFailover = config.Get("enableFailover").As<Napi::Boolean>().Value();
     
-    // Generate stream ID
-    std::string streamId = GenerateStreamId();
+    // Create the native framer; maxStreams bounds its open channels
+    Napi::Object result = FrameMux::NewInstance(env, config);
+    if (env.IsExceptionPending()) {
+      span.End(false);
+      return env.Null();
+    }
     
-    // Create stream result
-    Napi::Object result = CreateStreamResult(env, streamId, "multiplexed", "multiplexed");
+    // Add stream descriptor
+    result.Set("streamId", Napi::String::New(env, GenerateStreamId()));
+    result.Set("type", Napi::String::New(env, "multiplexed"));
+    result.Set("algorithm", Napi::String::New(env, "multiplexed"));
     
     // Add multiplexing configuration
     result.Set("maxStreams", Napi::Number::New(env, maxStreams));
@@ -285,11 +327,11 @@ Napi::Value CreateMultiplexedStream(const Napi::CallbackInfo& info) {
     result.Set("status", Napi::String::New(env, "active"));
     result.Set("createdAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("CreateMultiplexedStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("CreateMultiplexedStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to create multiplexed stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -297,7 +339,8 @@ Napi::Value CreateMultiplexedStream(const Napi::CallbackInfo& info) {
 
 Napi::Value CreateSplitterStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("CreateSplitterStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("CreateSplitterStream");
+  OperationSpan span(kMetric);
   
   try {
     // Parse configuration
@@ -310,7 +353,18 @@ Napi::Value CreateSplitterStream(const Napi::CallbackInfo& info) {
     std::string streamId = GenerateStreamId();
     
     // Create stream result
-    Napi::Object result = CreateStreamResult(env, streamId, "splitter", "splitter");
+    Napi::Object result = splitStrategy == "channel"
+      ? FrameMux::NewInstance(env, config)
+      : CreateStreamResult(env, streamId, "splitter", "splitter");
+    if (env.IsExceptionPending()) {
+      span.End(false);
+      return env.Null();
+    }
+    if (splitStrategy == "channel") {
+      result.Set("streamId", Napi::String::New(env, streamId));
+      result.Set("type", Napi::String::New(env, "splitter"));
+      result.Set("algorithm", Napi::String::New(env, "splitter"));
+    }
     
     // Add splitting configuration
     result.Set("splitStrategy", Napi::String::New(env, splitStrategy));
@@ -325,11 +379,11 @@ Napi::Value CreateSplitterStream(const Napi::CallbackInfo& info) {
     result.Set("status", Napi::String::New(env, "active"));
     result.Set("createdAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("CreateSplitterStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("CreateSplitterStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to create splitter stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -337,7 +391,8 @@ Napi::Value CreateSplitterStream(const Napi::CallbackInfo& info) {
 
 Napi::Value CreateMergerStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("CreateMergerStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("CreateMergerStream");
+  OperationSpan span(kMetric);
   
   try {
     // Parse configuration
@@ -348,7 +403,18 @@ Napi::Value CreateMergerStream(const Napi::CallbackInfo& info) {
     std::string streamId = GenerateStreamId();
     
     // Create stream result
-    Napi::Object result = CreateStreamResult(env, streamId, "merger", "merger");
+    Napi::Object result = mergeStrategy == "channel"
+      ? FrameMux::NewInstance(env, config)
+      : CreateStreamResult(env, streamId, "merger", "merger");
+    if (env.IsExceptionPending()) {
+      span.End(false);
+      return env.Null();
+    }
+    if (mergeStrategy == "channel") {
+      result.Set("streamId", Napi::String::New(env, streamId));
+      result.Set("type", Napi::String::New(env, "merger"));
+      result.Set("algorithm", Napi::String::New(env, "merger"));
+    }
     
     // Add merging configuration
     result.Set("mergeStrategy", Napi::String::New(env, mergeStrategy));
@@ -361,11 +427,11 @@ Napi::Value CreateMergerStream(const Napi::CallbackInfo& info) {
     result.Set("status", Napi::String::New(env, "active"));
     result.Set("createdAt", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("CreateMergerStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("CreateMergerStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to create merger stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -374,7 +440,8 @@ Napi::Value CreateMergerStream(const Napi::CallbackInfo& info) {
 // Performance operations
 Napi::Value OptimizeStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("OptimizeStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("OptimizeStream");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -387,11 +454,11 @@ Napi::Value OptimizeStream(const Napi::CallbackInfo& info) {
     result.Set("optimizations", Napi::Array::New(env, 0));
     result.Set("performanceGain", Napi::Number::New(env, 25.0)); // 25% improvement
     
-    PerformanceMonitor::GetInstance().EndOperation("OptimizeStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("OptimizeStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to optimize stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -399,7 +466,8 @@ Napi::Value OptimizeStream(const Napi::CallbackInfo& info) {
 
 Napi::Value MonitorStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("MonitorStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("MonitorStream");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -412,11 +480,11 @@ Napi::Value MonitorStream(const Napi::CallbackInfo& info) {
     result.Set("streamId", Napi::String::New(env, streamId));
     result.Set("timestamp", Napi::String::New(env, GetCurrentTimestamp()));
     
-    PerformanceMonitor::GetInstance().EndOperation("MonitorStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("MonitorStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to monitor stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -424,7 +492,8 @@ Napi::Value MonitorStream(const Napi::CallbackInfo& info) {
 
 Napi::Value AnalyzeStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("AnalyzeStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("AnalyzeStream");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -437,11 +506,11 @@ Napi::Value AnalyzeStream(const Napi::CallbackInfo& info) {
     result.Set("performanceIssues", Napi::Array::New(env, 0));
     result.Set("recommendations", Napi::Array::New(env, 0));
     
-    PerformanceMonitor::GetInstance().EndOperation("AnalyzeStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("AnalyzeStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to analyze stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -450,7 +519,8 @@ Napi::Value AnalyzeStream(const Napi::CallbackInfo& info) {
 // Security operations
 Napi::Value EnableEncryption(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("EnableEncryption");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("EnableEncryption");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -462,11 +532,11 @@ Napi::Value EnableEncryption(const Napi::CallbackInfo& info) {
     result.Set("streamId", Napi::String::New(env, streamId));
     result.Set("encryptionEnabled", Napi::Boolean::New(env, true));
     
-    PerformanceMonitor::GetInstance().EndOperation("EnableEncryption");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("EnableEncryption");
+    span.End(false);
     Napi::Error::New(env, "Failed to enable encryption: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -474,7 +544,8 @@ Napi::Value EnableEncryption(const Napi::CallbackInfo& info) {
 
 Napi::Value EnableAuthentication(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("EnableAuthentication");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("EnableAuthentication");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -486,11 +557,11 @@ Napi::Value EnableAuthentication(const Napi::CallbackInfo& info) {
     result.Set("streamId", Napi::String::New(env, streamId));
     result.Set("authenticationEnabled", Napi::Boolean::New(env, true));
     
-    PerformanceMonitor::GetInstance().EndOperation("EnableAuthentication");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("EnableAuthentication");
+    span.End(false);
     Napi::Error::New(env, "Failed to enable authentication: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -498,7 +569,8 @@ Napi::Value EnableAuthentication(const Napi::CallbackInfo& info) {
 
 Napi::Value EnableAuthorization(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("EnableAuthorization");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("EnableAuthorization");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -510,11 +582,11 @@ Napi::Value EnableAuthorization(const Napi::CallbackInfo& info) {
     result.Set("streamId", Napi::String::New(env, streamId));
     result.Set("authorizationEnabled", Napi::Boolean::New(env, true));
     
-    PerformanceMonitor::GetInstance().EndOperation("EnableAuthorization");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("EnableAuthorization");
+    span.End(false);
     Napi::Error::New(env, "Failed to enable authorization: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -523,7 +595,8 @@ Napi::Value EnableAuthorization(const Napi::CallbackInfo& info) {
 // Utility operations
 Napi::Value ValidateStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("ValidateStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("ValidateStream");
+  OperationSpan span(kMetric);
   
   try {
     std::string streamId = info[0].As<Napi::String>().Utf8Value();
@@ -535,62 +608,137 @@ Napi::Value ValidateStream(const Napi::CallbackInfo& info) {
     result.Set("validatedAt", Napi::String::New(env, GetCurrentTimestamp()));
     result.Set("issues", Napi::Array::New(env, 0));
     
-    PerformanceMonitor::GetInstance().EndOperation("ValidateStream");
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("ValidateStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to validate stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
 }
 
+// serializeStream(state | state[], target?) checkpoints plain stream state
+// (see stream_checkpoint.h). Without a target the result is a new Buffer;
+// with one the checkpoint is written into it and the byte count needed is
+// returned, and a target that was too small does not hold a checkpoint.
 Napi::Value SerializeStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("SerializeStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("SerializeStream");
+  OperationSpan span(kMetric);
   
   try {
-    std::string streamId = info[0].As<Napi::String>().Utf8Value();
-    
-    // Create serialization result
-    Napi::Object result = Napi::Object::New(env);
-    result.Set("success", Napi::Boolean::New(env, true));
-    result.Set("streamId", Napi::String::New(env, streamId));
-    result.Set("serializedData", Napi::Buffer<uint8_t>::New(env, 0));
-    
-    PerformanceMonitor::GetInstance().EndOperation("SerializeStream");
+    if (info.Length() < 1 || !info[0].IsObject()) {
+      span.End(false);
+      Napi::TypeError::New(env, "Expected stream state or an array of stream states").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (info.Length() > 1 && !info[1].IsUndefined() && !info[1].IsBuffer()) {
+      span.End(false);
+      Napi::TypeError::New(env, "target must be a Buffer").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    
+    if (info.Length() > 1 && info[1].IsBuffer()) {
+      Napi::Buffer<uint8_t> target = info[1].As<Napi::Buffer<uint8_t>>();
+      CheckpointWriter writer(target.Data(), target.Length());
+      if (!WriteCheckpoint(env, info[0], writer)) {
+        span.End(false);
+        return env.Null();
+      }
+      PerformanceMonitor::GetInstance().RecordBytes(kMetric, writer.Size(), writer.Fits() ? writer.Size() : 0);
+      span.End();
+      return Napi::Number::New(env, static_cast<double>(writer.Size()));
+    }
+    
+    // Start from the size of this thread's last checkpoint, so steady-state
+    // checkpoints are written without growing
+    thread_local size_t lastSize = 0;
+    CheckpointWriter writer(lastSize + lastSize / 8);
+    if (!WriteCheckpoint(env, info[0], writer)) {
+      span.End(false);
+      return env.Null();
+    }
+    if (!writer.Fits()) {
+      span.End(false);
+      Napi::Error::New(env, "Out of memory writing checkpoint").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    lastSize = writer.Size();
+    PerformanceMonitor::GetInstance().RecordBytes(kMetric, lastSize, lastSize);
+    
+    // The Buffer takes over the writer's storage
+    uint8_t* data = writer.Release();
+    Napi::Buffer<uint8_t> result = Napi::Buffer<uint8_t>::New(env, data, lastSize, [](Napi::Env, uint8_t* data) {
+      std::free(data);
+    });
+    
+    span.End();
     return result;
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("SerializeStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to serialize stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
 }
 
+// deserializeStream(checkpoint, index?) returns the states (or the single
+// state it was written from), or only record index. Bytes are Uint8Array
+// views into checkpoint, which may be a Buffer from openCheckpoint().
 Napi::Value DeserializeStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  PerformanceMonitor::GetInstance().StartOperation("DeserializeStream");
+  static const uint32_t kMetric = PerformanceMonitor::GetInstance().RegisterOperation("DeserializeStream");
+  OperationSpan span(kMetric);
   
   try {
-    Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
-    
-    // Create deserialization result
-    Napi::Object result = Napi::Object::New(env);
-    result.Set("success", Napi::Boolean::New(env, true));
-    result.Set("streamId", Napi::String::New(env, GenerateStreamId()));
-    result.Set("deserializedData", Napi::Object::New(env));
-    
-    PerformanceMonitor::GetInstance().EndOperation("DeserializeStream");
-    return result;
+    int64_t index = -1;
+    if (info.Length() > 1 && !info[1].IsUndefined()) {
+      double number = info[1].IsNumber() ? info[1].As<Napi::Number>().DoubleValue() : -1;
+      if (!(number >= 0 && number < 4294967296.0) || number != static_cast<double>(static_cast<int64_t>(number))) {
+        span.End(false);
+        Napi::TypeError::New(env, "index must be a non-negative integer").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      index = static_cast<int64_t>(number);
+    }
+    
+    napi_value result = ReadCheckpoint(env, info.Length() > 0 ? info[0] : env.Undefined(), index);
+    if (!result) {
+      span.End(false);
+      return env.Null();
+    }
+    
+    size_t length = info[0].As<Napi::Buffer<uint8_t>>().Length();
+    PerformanceMonitor::GetInstance().RecordBytes(kMetric, length, length);
+    span.End();
+    return Napi::Value(env, result);
     
   } catch (const std::exception& e) {
-    PerformanceMonitor::GetInstance().EndOperation("DeserializeStream");
+    span.End(false);
     Napi::Error::New(env, "Failed to deserialize stream: " + std::string(e.what())).ThrowAsJavaScriptException();
     return env.Null();
   }
 }
 
+// inspectCheckpoint(checkpoint) -> { valid, version, count, byteLength, error? }
+Napi::Value InspectStreamCheckpoint(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  napi_value result = InspectCheckpoint(env, info.Length() > 0 ? info[0] : env.Undefined());
+  return result ? Napi::Value(env, result) : env.Null();
+}
+
+// openCheckpoint(path) maps a checkpoint file for deserializeStream
+Napi::Value OpenCheckpoint(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected checkpoint path").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  napi_value result = MapCheckpointFile(env, info[0].As<Napi::String>().Utf8Value());
+  return result ? Napi::Value(env, result) : env.Null();
+}
+
 // Helper functions
 std::string GenerateStreamId() {
   std::random_device rd;
@@ -34,6 +34,8 @@ Napi::Value EnableAuthorization(const Napi::CallbackInfo& info);
 Napi::Value ValidateStream(const Napi::CallbackInfo& info);
 Napi::Value SerializeStream(const Napi::CallbackInfo& info);
 Napi::Value DeserializeStream(const Napi::CallbackInfo& info);
+Napi::Value InspectStreamCheckpoint(const Napi::CallbackInfo& info);
+Napi::Value OpenCheckpoint(const Napi::CallbackInfo& info);
 
 // Helper functions
 std::string GenerateStreamId();
@@ -0,0 +1,970 @@
+#include "transform_pipeline.h"
+#include "performance_monitor.h"
+#include "compression_engine.h"
+#include "chunk_ring.h"
+#include "gcm_cipher.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <openssl/evp.h>
+
+namespace {
+
+const size_t kDefaultHighWaterMark = 1024 * 1024;
+const size_t kDefaultMaxQueuedChunks = 1024;
+const size_t kMaxBatch = 32;                // chunks per turn before the thread moves on
+const size_t kFrameHeaderSize = 4;
+
+// Byte limits for the input queue: write() returns false at highWaterMark,
+// onDrain waits for lowWaterMark (default half of it), and writes past
+// maxQueuedBytes (default twice it) are refused. Unset fields keep the
+// values passed in, except that a new highWaterMark re-derives the defaults.
+bool ReadWatermarks(Napi::Object config, size_t& high, size_t& low, size_t& limit, std::string& error) {
+  Napi::Value highValue = config.Get("highWaterMark");
+  Napi::Value lowValue = config.Get("lowWaterMark");
+  Napi::Value limitValue = config.Get("maxQueuedBytes");
+  
+  if (highValue.IsNumber()) {
+    double value = highValue.As<Napi::Number>().DoubleValue();
+    if (!(value >= 1)) {
+      error = "highWaterMark must be at least 1 byte";
+      return false;
+    }
+    high = static_cast<size_t>(value);
+    low = high / 2;
+    limit = high * 2;
+  }
+  if (lowValue.IsNumber()) {
+    double value = lowValue.As<Napi::Number>().DoubleValue();
+    if (!(value >= 0) || value >= static_cast<double>(high)) {
+      error = "lowWaterMark must be below highWaterMark";
+      return false;
+    }
+    low = static_cast<size_t>(value);
+  }
+  if (limitValue.IsNumber()) {
+    double value = limitValue.As<Napi::Number>().DoubleValue();
+    if (!(value >= static_cast<double>(high))) {
+      error = "maxQueuedBytes must be at least highWaterMark";
+      return false;
+    }
+    limit = static_cast<size_t>(value);
+  }
+  return true;
+}
+
+} // namespace
+
+// One chunk moving through the stages. The payload is
+// storage[offset, offset + length); kHeadroom bytes are reserved in front so
+// framing can prepend a header without moving the payload.
+struct PipelineChunk {
+  static const size_t kHeadroom = 16;
+  
+  PipelineChunk() : capacity(0), offset(0), length(0) {}
+  
+  void Allocate(size_t size) {
+    storage.reset(new uint8_t[kHeadroom + size]);
+    capacity = kHeadroom + size;
+    offset = kHeadroom;
+    length = 0;
+  }
+  
+  uint8_t* Data() { return storage.get() + offset; }
+  size_t Tailroom() const { return capacity - offset - length; }
+  
+  // Make room for at least extra more bytes after the payload
+  void Grow(size_t extra) {
+    size_t size = length + std::max(extra, length);
+    std::unique_ptr<uint8_t[]> grown(new uint8_t[kHeadroom + size]);
+    if (length) {
+      std::memcpy(grown.get() + kHeadroom, Data(), length);
+    }
+    storage = std::move(grown);
+    capacity = kHeadroom + size;
+    offset = kHeadroom;
+  }
+  
+  std::unique_ptr<uint8_t[]> storage;
+  size_t capacity;
+  size_t offset;
+  size_t length;
+};
+
+// Results stages report once the pipeline has been flushed
+struct PipelineSummary {
+  std::vector<uint8_t> iv;
+  std::vector<uint8_t> authTag;
+  std::vector<uint8_t> digest;
+  std::string digestAlgorithm;
+};
+
+// One link of the chain. Process and Finish run on a pool thread, one call
+// at a time per pipeline, and must not touch the JS heap.
+class PipelineStage {
+public:
+  virtual ~PipelineStage() {}
+  
+  // Transform chunk in place, or swap new storage into it
+  virtual bool Process(PipelineChunk& chunk, std::string& error) = 0;
+  
+  // Write any trailing output into tail (empty, allocated) and record results
+  virtual bool Finish(PipelineChunk& /*tail*/, PipelineSummary& /*summary*/, std::string& /*error*/) {
+    return true;
+  }
+};
+
+// Batch of results handed from a pool thread to the JS thread
+struct PipelineDelivery {
+  explicit PipelineDelivery(TransformPipeline* owner)
+    : owner(owner), inputs(0), consumedBytes(0), finished(false) {}
+  
+  TransformPipeline* owner;
+  std::vector<std::unique_ptr<PipelineChunk>> chunks;
+  size_t inputs;          // writes and end() completed by this batch
+  size_t consumedBytes;   // input bytes released by this batch
+  bool finished;          // end() was processed
+  std::string error;
+  PipelineSummary summary;
+};
+
+// Worker-side state of one pipeline, shared by the JS object and the pool
+struct PipelineState {
+  PipelineState() : owner(nullptr), scheduled(false), cancelled(false), failed(false) {}
+  
+  // JS thread only; the caller has checked there is a free slot
+  static void Enqueue(const std::shared_ptr<PipelineState>& state, std::unique_ptr<PipelineChunk> chunk);
+  
+  // Run up to kMaxBatch queued items and deliver the results; true when
+  // more items are waiting
+  bool Drain();
+  
+  bool RunStages(PipelineChunk& chunk, size_t first, std::string& error);
+  bool FinishStages(PipelineDelivery& delivery);
+  
+  std::vector<std::unique_ptr<PipelineStage>> stages;
+  TransformPipeline* owner;
+  Napi::ThreadSafeFunction delivery;
+  
+  // Produced by the JS thread, consumed by whichever pool thread runs the
+  // pipeline. nullptr marks end().
+  std::unique_ptr<SpscRing<PipelineChunk>> queue;
+  std::atomic<bool> scheduled;                       // queued on, or running in, the pool
+  std::atomic<bool> cancelled;
+  bool failed;                                       // pool thread only
+};
+
+namespace {
+
+// Shared pool running ready pipelines. A pipeline is queued here at most
+// once, so its stages never run on two threads at the same time.
+class PipelineScheduler {
+public:
+  static PipelineScheduler& Instance() {
+    // Never destroyed; threads are joined by the env cleanup hook
+    static PipelineScheduler* scheduler = new PipelineScheduler();
+    return *scheduler;
+  }
+  
+  void Schedule(std::shared_ptr<PipelineState> state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      return;
+    }
+    ready_.push_back(std::move(state));
+    // Threads are started lazily, up to one per core (at most four)
+    if (workers_.size() < maxThreads_ && busy_ + ready_.size() > workers_.size()) {
+      workers_.emplace_back(&PipelineScheduler::WorkerLoop, this);
+    }
+    available_.notify_one();
+  }
+  
+  void AddEnv() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    envCount_++;
+    stopping_ = false;
+  }
+  
+  // Joins the workers once the last environment using the addon goes away
+  void RemoveEnv() {
+    std::vector<std::thread> workers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--envCount_ > 0) {
+        return;
+      }
+      stopping_ = true;
+      ready_.clear();
+      workers.swap(workers_);
+    }
+    available_.notify_all();
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+private:
+  PipelineScheduler()
+    : maxThreads_(std::max(1u, std::min(4u, std::thread::hardware_concurrency()))),
+      busy_(0),
+      envCount_(0),
+      stopping_(false) {}
+  
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    while (true) {
+      available_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+      if (stopping_) {
+        return;
+      }
+      
+      std::shared_ptr<PipelineState> state = std::move(ready_.front());
+      ready_.pop_front();
+      busy_++;
+      lock.unlock();
+      
+      bool more = state->Drain();
+      
+      lock.lock();
+      busy_--;
+      if (more && !stopping_) {
+        // Back of the line, so one busy pipeline cannot starve the others
+        ready_.push_back(std::move(state));
+      }
+    }
+  }
+  
+  std::mutex mutex_;
+  std::condition_variable available_;
+  std::deque<std::shared_ptr<PipelineState>> ready_;
+  std::vector<std::thread> workers_;
+  size_t maxThreads_;
+  size_t busy_;
+  size_t envCount_;
+  bool stopping_;
+};
+
+// AES-GCM over the chunk in place; the tag is produced or checked in Finish
+class CipherStage : public PipelineStage {
+public:
+  explicit CipherStage(bool decrypt) : decrypt_(decrypt) {}
+  
+  // Runs on the JS thread. A generated IV is exposed as `iv` on instance.
+  bool Init(Napi::Object config, Napi::Object instance, std::string& error) {
+    std::string algorithm = config.Has("algorithm") && config.Get("algorithm").IsString()
+      ? config.Get("algorithm").As<Napi::String>().Utf8Value() : "aes-256-gcm";
+    
+    Napi::Value keyValue = config.Get("key");
+    if (!keyValue.IsBuffer()) {
+      error = "key must be a Buffer";
+      return false;
+    }
+    Napi::Buffer<unsigned char> key = keyValue.As<Napi::Buffer<unsigned char>>();
+    
+    Napi::Value ivValue = config.Get("iv");
+    Napi::Buffer<unsigned char> iv;
+    if (ivValue.IsBuffer()) {
+      iv = ivValue.As<Napi::Buffer<unsigned char>>();
+    }
+    if (!cipher_.Init(algorithm, decrypt_, key.Data(), key.Length(),
+                      ivValue.IsBuffer() ? iv.Data() : nullptr, ivValue.IsBuffer() ? iv.Length() : 0, error)) {
+      return false;
+    }
+    if (!ivValue.IsBuffer() && !instance.Has("iv")) {
+      instance.Set("iv", Napi::Buffer<unsigned char>::Copy(instance.Env(), cipher_.Iv(), GcmCipher::kIvLength));
+    }
+    
+    Napi::Value aadValue = config.Get("aad");
+    if (aadValue.IsBuffer()) {
+      Napi::Buffer<unsigned char> aad = aadValue.As<Napi::Buffer<unsigned char>>();
+      if (!cipher_.SetAad(aad.Data(), aad.Length(), error)) {
+        return false;
+      }
+    }
+    
+    Napi::Value tagValue = config.Get("authTag");
+    if (tagValue.IsBuffer()) {
+      Napi::Buffer<unsigned char> tag = tagValue.As<Napi::Buffer<unsigned char>>();
+      if (!decrypt_ || !cipher_.SetTag(tag.Data(), tag.Length(), error)) {
+        error = "authTag must be a 16-byte Buffer on a decrypt stage";
+        return false;
+      }
+    } else if (decrypt_) {
+      error = "authTag is required for decryption";
+      return false;
+    }
+    
+    return true;
+  }
+  
+  bool Process(PipelineChunk& chunk, std::string& error) override {
+    return cipher_.Update(chunk.Data(), chunk.length, chunk.Data(), error);
+  }
+  
+  bool Finish(PipelineChunk& /*tail*/, PipelineSummary& summary, std::string& error) override {
+    if (!cipher_.Final(error)) {
+      return false;
+    }
+    
+    summary.iv.assign(cipher_.Iv(), cipher_.Iv() + GcmCipher::kIvLength);
+    if (!decrypt_) {
+      summary.authTag.assign(cipher_.Tag(), cipher_.Tag() + GcmCipher::kTagLength);
+    }
+    return true;
+  }
+
+private:
+  GcmCipher cipher_;
+  bool decrypt_;
+};
+
+// Appends codec output to a chunk, growing it as needed
+class ChunkSink : public CompressionSink {
+public:
+  explicit ChunkSink(PipelineChunk& chunk) : chunk_(chunk) {}
+  
+  uint8_t* Reserve(size_t minimum, size_t& available) override {
+    if (chunk_.Tailroom() < minimum) {
+      chunk_.Grow(minimum);
+    }
+    available = chunk_.Tailroom();
+    return chunk_.Data() + chunk_.length;
+  }
+  
+  void Commit(size_t written) override {
+    chunk_.length += written;
+  }
+
+private:
+  PipelineChunk& chunk_;
+};
+
+// Any CompressionCodec backend. Output goes to fresh storage that is swapped
+// into the chunk; the chunk's old storage is kept as the next output buffer.
+class CompressStage : public PipelineStage {
+public:
+  explicit CompressStage(bool decompress) : decompress_(decompress), flush_(false), spareCapacity_(0) {}
+  
+  // Runs on the JS thread
+  bool Init(Napi::Object config, std::string& error) {
+    CompressionOptions options;
+    options.algorithm = config.Has("algorithm") && config.Get("algorithm").IsString()
+      ? config.Get("algorithm").As<Napi::String>().Utf8Value() : "deflate";
+    options.decompress = decompress_;
+    if (config.Get("level").IsNumber()) {
+      options.level = config.Get("level").As<Napi::Number>().Int32Value();
+    }
+    if (config.Get("windowLog").IsNumber()) {
+      options.windowLog = config.Get("windowLog").As<Napi::Number>().Int32Value();
+    }
+    if (config.Get("workers").IsNumber()) {
+      options.workers = std::max(0, std::min(64, config.Get("workers").As<Napi::Number>().Int32Value()));
+    }
+    if (config.Get("dictionary").IsBuffer()) {
+      Napi::Buffer<uint8_t> dictionary = config.Get("dictionary").As<Napi::Buffer<uint8_t>>();
+      options.dictionary.assign(dictionary.Data(), dictionary.Data() + dictionary.Length());
+    }
+    // 'sync' makes every output chunk decodable on its own, at some cost in ratio
+    flush_ = !decompress_ && config.Get("flush").IsString() &&
+             config.Get("flush").As<Napi::String>().Utf8Value() == "sync";
+    
+    codec_ = CompressionCodec::Create(options, error);
+    return codec_ != nullptr;
+  }
+  
+  bool Process(PipelineChunk& chunk, std::string& error) override {
+    PipelineChunk output;
+    TakeSpare(output, codec_->OutputHint(chunk.length));
+    
+    ChunkSink sink(output);
+    if (!codec_->Update(chunk.Data(), chunk.length, flush_, sink, error)) {
+      return false;
+    }
+    
+    spare_ = std::move(chunk.storage);
+    spareCapacity_ = chunk.capacity;
+    chunk = std::move(output);
+    return true;
+  }
+  
+  bool Finish(PipelineChunk& tail, PipelineSummary& /*summary*/, std::string& error) override {
+    ChunkSink sink(tail);
+    return codec_->Finish(sink, error);
+  }
+
+private:
+  void TakeSpare(PipelineChunk& output, size_t size) {
+    if (spare_ && spareCapacity_ >= PipelineChunk::kHeadroom + size) {
+      output.storage = std::move(spare_);
+      output.capacity = spareCapacity_;
+      output.offset = PipelineChunk::kHeadroom;
+      output.length = 0;
+    } else {
+      output.Allocate(size);
+    }
+    spareCapacity_ = 0;
+  }
+  
+  std::unique_ptr<CompressionCodec> codec_;
+  bool decompress_;
+  bool flush_;
+  std::unique_ptr<uint8_t[]> spare_;
+  size_t spareCapacity_;
+};
+
+// Running digest over everything that passes; the data is not changed
+class HashStage : public PipelineStage {
+public:
+  HashStage() : ctx_(EVP_MD_CTX_new()) {}
+  
+  ~HashStage() override {
+    EVP_MD_CTX_free(ctx_);
+  }
+  
+  // Runs on the JS thread
+  bool Init(Napi::Object config, std::string& error) {
+    algorithm_ = config.Has("algorithm") && config.Get("algorithm").IsString()
+      ? config.Get("algorithm").As<Napi::String>().Utf8Value() : "sha256";
+    const EVP_MD* md = EVP_get_digestbyname(algorithm_.c_str());
+    if (!md) {
+      error = "Unsupported hash algorithm: " + algorithm_;
+      return false;
+    }
+    if (!ctx_ || EVP_DigestInit_ex(ctx_, md, nullptr) != 1) {
+      error = "Failed to initialize digest";
+      return false;
+    }
+    return true;
+  }
+  
+  bool Process(PipelineChunk& chunk, std::string& error) override {
+    if (EVP_DigestUpdate(ctx_, chunk.Data(), chunk.length) != 1) {
+      error = "Failed to update digest";
+      return false;
+    }
+    return true;
+  }
+  
+  bool Finish(PipelineChunk& /*tail*/, PipelineSummary& summary, std::string& error) override {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digestLength = 0;
+    if (EVP_DigestFinal_ex(ctx_, digest, &digestLength) != 1) {
+      error = "Failed to finalize digest";
+      return false;
+    }
+    summary.digest.assign(digest, digest + digestLength);
+    summary.digestAlgorithm = algorithm_;
+    return true;
+  }
+
+private:
+  EVP_MD_CTX* ctx_;
+  std::string algorithm_;
+};
+
+// Length-prefix framing, written into the chunk's headroom
+class FrameStage : public PipelineStage {
+public:
+  bool Process(PipelineChunk& chunk, std::string& error) override {
+    if (chunk.length > UINT32_MAX) {
+      error = "Chunk is too large to frame";
+      return false;
+    }
+    if (chunk.offset < kFrameHeaderSize) {
+      PipelineChunk moved;
+      moved.Allocate(chunk.length);
+      std::memcpy(moved.Data(), chunk.Data(), chunk.length);
+      moved.length = chunk.length;
+      chunk = std::move(moved);
+    }
+    
+    uint32_t length = static_cast<uint32_t>(chunk.length);
+    chunk.offset -= kFrameHeaderSize;
+    chunk.length += kFrameHeaderSize;
+    uint8_t* header = chunk.Data();
+    header[0] = static_cast<uint8_t>(length >> 24);
+    header[1] = static_cast<uint8_t>(length >> 16);
+    header[2] = static_cast<uint8_t>(length >> 8);
+    header[3] = static_cast<uint8_t>(length);
+    return true;
+  }
+};
+
+// Build one stage from its config; runs on the JS thread
+std::unique_ptr<PipelineStage> CreateStage(Napi::Object config, Napi::Object instance, std::string& error) {
+  std::string type = config.Has("type") && config.Get("type").IsString()
+    ? config.Get("type").As<Napi::String>().Utf8Value() : "";
+  
+  if (type == "encrypt" || type == "decrypt") {
+    std::unique_ptr<CipherStage> stage(new CipherStage(type == "decrypt"));
+    if (!stage->Init(config, instance, error)) {
+      return nullptr;
+    }
+    return stage;
+  }
+  
+  if (type == "compress" || type == "decompress") {
+    std::unique_ptr<CompressStage> stage(new CompressStage(type == "decompress"));
+    if (!stage->Init(config, error)) {
+      return nullptr;
+    }
+    return stage;
+  }
+  
+  if (type == "hash") {
+    std::unique_ptr<HashStage> stage(new HashStage());
+    if (!stage->Init(config, error)) {
+      return nullptr;
+    }
+    return stage;
+  }
+  
+  if (type == "frame") {
+    return std::unique_ptr<PipelineStage>(new FrameStage());
+  }
+  
+  error = "Unknown pipeline stage: " + type;
+  return nullptr;
+}
+
+// TSFN callback; owns the delivery
+void CallDeliver(Napi::Env env, Napi::Function onData, PipelineDelivery* delivery) {
+  std::unique_ptr<PipelineDelivery> owned(delivery);
+  if (!env) {
+    return;
+  }
+  owned->owner->Deliver(env, onData, *owned);
+}
+
+void RemoveEnv(void*) {
+  PipelineScheduler::Instance().RemoveEnv();
+}
+
+} // namespace
+
+void PipelineState::Enqueue(const std::shared_ptr<PipelineState>& state, std::unique_ptr<PipelineChunk> chunk) {
+  state->queue->TryPush(chunk);
+  // Pairs with the fence in Drain: either it sees this chunk or we see
+  // scheduled cleared and schedule the pipeline again
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!state->scheduled.exchange(true)) {
+    PipelineScheduler::Instance().Schedule(state);
+  }
+}
+
+bool PipelineState::RunStages(PipelineChunk& chunk, size_t first, std::string& error) {
+  for (size_t i = first; i < stages.size() && chunk.length > 0; i++) {
+    if (!stages[i]->Process(chunk, error)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Flush stages in order; trailing output of one stage still runs through
+// the stages after it
+bool PipelineState::FinishStages(PipelineDelivery& delivery) {
+  for (size_t i = 0; i < stages.size(); i++) {
+    std::unique_ptr<PipelineChunk> tail(new PipelineChunk());
+    tail->Allocate(64);
+    if (!stages[i]->Finish(*tail, delivery.summary, delivery.error) ||
+        !RunStages(*tail, i + 1, delivery.error)) {
+      return false;
+    }
+    if (tail->length) {
+      delivery.chunks.push_back(std::move(tail));
+    }
+  }
+  return true;
+}
+
+// Runs on a pool thread - no N-API calls allowed here
+bool PipelineState::Drain() {
+  static const uint32_t kProcessMetric = PerformanceMonitor::GetInstance().RegisterOperation("TransformPipeline.process");
+  static const uint32_t kFinishMetric = PerformanceMonitor::GetInstance().RegisterOperation("TransformPipeline.finish");
+  
+  std::vector<std::unique_ptr<PipelineChunk>> batch;
+  std::unique_ptr<PipelineChunk> next;
+  while (batch.size() < kMaxBatch && queue->TryPop(next)) {
+    batch.push_back(std::move(next));
+  }
+  
+  std::unique_ptr<PipelineDelivery> result(new PipelineDelivery(owner));
+  for (std::unique_ptr<PipelineChunk>& item : batch) {
+    result->inputs++;
+    
+    if (!item) {
+      result->finished = true;
+      if (!failed && !cancelled.load(std::memory_order_relaxed)) {
+        OperationSpan span(kFinishMetric);
+        failed = !FinishStages(*result);
+        span.End(!failed);
+      }
+      continue;
+    }
+    
+    result->consumedBytes += item->length;
+    if (failed || cancelled.load(std::memory_order_relaxed)) {
+      continue;
+    }
+    
+    OperationSpan span(kProcessMetric);
+    if (!RunStages(*item, 0, result->error)) {
+      failed = true;
+      span.End(false);
+      continue;
+    }
+    span.End();
+    if (item->length) {
+      result->chunks.push_back(std::move(item));
+    }
+  }
+  
+  // An unbounded queue, so this never blocks; it only fails while the
+  // environment is shutting down, and then the results are dropped here
+  if (delivery.NonBlockingCall(result.get(), CallDeliver) == napi_ok) {
+    result.release();
+  }
+  
+  scheduled.store(false);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  // Anything pushed before the JS thread saw scheduled cleared is ours
+  return !queue->Empty() && !scheduled.exchange(true);
+}
+
+Napi::FunctionReference TransformPipeline::constructor;
+
+void TransformPipeline::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(env, "TransformPipeline", {
+    InstanceMethod("write", &TransformPipeline::Write),
+    InstanceMethod("end", &TransformPipeline::End),
+    InstanceMethod("destroy", &TransformPipeline::Destroy),
+    InstanceAccessor("stats", &TransformPipeline::GetStats, nullptr),
+  });
+  
+  constructor = Napi::Persistent(func);
+  constructor.SuppressDestruct();
+  
+  exports.Set(Napi::String::New(env, "TransformPipeline"), func);
+  
+  PipelineScheduler::Instance().AddEnv();
+  napi_add_env_cleanup_hook(env, RemoveEnv, nullptr);
+}
+
+Napi::Object TransformPipeline::NewInstance(Napi::Env env, Napi::Object config) {
+  return constructor.New({ config });
+}
+
+TransformPipeline::TransformPipeline(const Napi::CallbackInfo& info)
+  : Napi::ObjectWrap<TransformPipeline>(info),
+    state_(std::make_shared<PipelineState>()),
+    gauge_(kDefaultHighWaterMark, kDefaultHighWaterMark / 2),
+    maxQueuedBytes_(kDefaultHighWaterMark * 2),
+    maxQueuedChunks_(kDefaultMaxQueuedChunks),
+    pending_(0),
+    ended_(false),
+    closed_(true),
+    released_(true),
+    bytesIn_(0),
+    bytesOut_(0),
+    chunksIn_(0),
+    chunksOut_(0) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "Expected pipeline config").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  Napi::Object config = info[0].As<Napi::Object>();
+  if (!config.Get("onData").IsFunction()) {
+    Napi::TypeError::New(env, "onData callback is required").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  Napi::Value stages = config.Get("stages");
+  if (!stages.IsArray()) {
+    Napi::TypeError::New(env, "stages must be an array").ThrowAsJavaScriptException();
+    return;
+  }
+  
+  Napi::Array list = stages.As<Napi::Array>();
+  for (uint32_t i = 0; i < list.Length(); i++) {
+    Napi::Value stageConfig = list.Get(i);
+    std::string error = "Pipeline stage must be an object";
+    std::unique_ptr<PipelineStage> stage = stageConfig.IsObject()
+      ? CreateStage(stageConfig.As<Napi::Object>(), Value(), error) : nullptr;
+    if (!stage) {
+      Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+      return;
+    }
+    state_->stages.push_back(std::move(stage));
+  }
+  
+  size_t high = gauge_.High();
+  size_t low = gauge_.Low();
+  std::string error;
+  if (!ReadWatermarks(config, high, low, maxQueuedBytes_, error)) {
+    Napi::RangeError::New(env, error).ThrowAsJavaScriptException();
+    return;
+  }
+  gauge_.Configure(high, low);
+  
+  // One slot is always left for end()
+  Napi::Value maxQueuedChunks = config.Get("maxQueuedChunks");
+  if (maxQueuedChunks.IsNumber()) {
+    double value = maxQueuedChunks.As<Napi::Number>().DoubleValue();
+    if (!(value >= 1 && value <= (1 << 20))) {
+      Napi::RangeError::New(env, "maxQueuedChunks must be between 1 and 2^20").ThrowAsJavaScriptException();
+      return;
+    }
+    maxQueuedChunks_ = static_cast<size_t>(value);
+  }
+  state_->queue.reset(new SpscRing<PipelineChunk>(maxQueuedChunks_ + 1));
+  
+  if (config.Get("onEnd").IsFunction()) {
+    onEnd_ = Napi::Persistent(config.Get("onEnd").As<Napi::Function>());
+  }
+  if (config.Get("onError").IsFunction()) {
+    onError_ = Napi::Persistent(config.Get("onError").As<Napi::Function>());
+  }
+  if (config.Get("onDrain").IsFunction()) {
+    onDrain_ = Napi::Persistent(config.Get("onDrain").As<Napi::Function>());
+  }
+  
+  // Only keeps the event loop alive while chunks are in flight (see Hold)
+  state_->owner = this;
+  state_->delivery = Napi::ThreadSafeFunction::New(env, config.Get("onData").As<Napi::Function>(),
+                                                   "TransformPipeline", 0, 1);
+  state_->delivery.Unref(env);
+  closed_ = false;
+  released_ = false;
+}
+
+TransformPipeline::~TransformPipeline() {
+  // Only collectable while nothing is in flight, so no delivery can follow
+  state_->cancelled = true;
+  if (!released_) {
+    state_->delivery.Release();
+  }
+}
+
+void TransformPipeline::Hold(Napi::Env env) {
+  if (pending_++ == 0) {
+    Ref();
+    state_->delivery.Ref(env);
+  }
+}
+
+void TransformPipeline::Unhold(Napi::Env env) {
+  if (closed_ && !released_) {
+    released_ = true;
+    state_->delivery.Release();
+  } else if (!released_) {
+    state_->delivery.Unref(env);
+  }
+  Unref();
+}
+
+// write(chunk) copies the chunk and queues it; returns false once
+// highWaterMark input bytes (or maxQueuedChunks chunks) are waiting, and
+// refuses chunks beyond maxQueuedBytes until onDrain
+Napi::Value TransformPipeline::Write(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (closed_ || ended_) {
+    Napi::Error::New(env, ended_ ? "write after end" : "Pipeline is closed").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  if (info.Length() < 1 || !info[0].IsBuffer()) {
+    Napi::TypeError::New(env, "Expected chunk buffer").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+  // Memory is bounded by configuration, whatever the producer does; a
+  // single oversized chunk is still accepted into an empty queue
+  if (state_->queue->Size() >= maxQueuedChunks_ ||
+      (gauge_.Bytes() > 0 && gauge_.Bytes() + buffer.Length() > maxQueuedBytes_)) {
+    Napi::Error::New(env, "Pipeline queue is full; wait for onDrain").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  std::unique_ptr<PipelineChunk> chunk(new PipelineChunk());
+  chunk->Allocate(buffer.Length());
+  if (buffer.Length()) {
+    std::memcpy(chunk->Data(), buffer.Data(), buffer.Length());
+  }
+  chunk->length = buffer.Length();
+  
+  bytesIn_ += buffer.Length();
+  chunksIn_++;
+  uint64_t nowNs = OperationSpan::NowNs();
+  bool accepting = gauge_.Add(buffer.Length(), nowNs);
+  Hold(env);
+  PipelineState::Enqueue(state_, std::move(chunk));
+  
+  if (state_->queue->Size() >= maxQueuedChunks_) {
+    gauge_.Pause(nowNs);
+    accepting = false;
+  }
+  return Napi::Boolean::New(env, accepting);
+}
+
+// end() flushes every stage; onEnd(summary) follows the last onData
+Napi::Value TransformPipeline::End(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (closed_ || ended_) {
+    Napi::Error::New(env, ended_ ? "end() has already been called" : "Pipeline is closed").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  ended_ = true;
+  Hold(env);
+  PipelineState::Enqueue(state_, nullptr);
+  return env.Undefined();
+}
+
+// destroy() drops queued chunks; in-flight results are discarded
+Napi::Value TransformPipeline::Destroy(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (!closed_) {
+    closed_ = true;
+    state_->cancelled = true;
+    if (pending_ == 0 && !released_) {
+      released_ = true;
+      state_->delivery.Release();
+    }
+  }
+  return env.Undefined();
+}
+
+Napi::Value TransformPipeline::GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("bytesIn", Napi::Number::New(env, bytesIn_));
+  stats.Set("bytesOut", Napi::Number::New(env, bytesOut_));
+  stats.Set("chunksIn", Napi::Number::New(env, chunksIn_));
+  stats.Set("chunksOut", Napi::Number::New(env, chunksOut_));
+  stats.Set("queuedBytes", Napi::Number::New(env, static_cast<double>(gauge_.Bytes())));
+  stats.Set("queuedChunks", Napi::Number::New(env, static_cast<double>(state_->queue->Size())));
+  stats.Set("highWaterMark", Napi::Number::New(env, static_cast<double>(gauge_.High())));
+  stats.Set("lowWaterMark", Napi::Number::New(env, static_cast<double>(gauge_.Low())));
+  stats.Set("paused", Napi::Boolean::New(env, gauge_.Paused()));
+  stats.Set("pauses", Napi::Number::New(env, static_cast<double>(gauge_.Pauses())));
+  stats.Set("blockedMs", Napi::Number::New(env, static_cast<double>(gauge_.BlockedNs(OperationSpan::NowNs())) / 1e6));
+  return stats;
+}
+
+void TransformPipeline::Deliver(Napi::Env env, Napi::Function onData, PipelineDelivery& delivery) {
+  Napi::HandleScope scope(env);
+  
+  gauge_.Release(delivery.consumedBytes);
+  pending_ -= delivery.inputs;
+  
+  for (std::unique_ptr<PipelineChunk>& chunk : delivery.chunks) {
+    bytesOut_ += chunk->length;
+    chunksOut_++;
+    if (closed_ || env.IsExceptionPending()) {
+      continue;
+    }
+    
+    // The Buffer takes over the chunk's storage; no copy on the way out
+    uint8_t* storage = chunk->storage.release();
+    Napi::Buffer<uint8_t> output = Napi::Buffer<uint8_t>::New(
+      env, storage + chunk->offset, chunk->length,
+      [](Napi::Env, uint8_t*, uint8_t* base) { delete[] base; }, storage);
+    onData.Call(Value(), { output });
+  }
+  
+  if (!closed_ && !env.IsExceptionPending()) {
+    if (!delivery.error.empty()) {
+      closed_ = true;
+      Napi::Error error = Napi::Error::New(env, delivery.error);
+      if (onError_.IsEmpty()) {
+        // Like an 'error' event without a listener
+        error.ThrowAsJavaScriptException();
+      } else {
+        onError_.Call(Value(), { error.Value() });
+      }
+    } else if (delivery.finished) {
+      closed_ = true;
+      if (!onEnd_.IsEmpty()) {
+        const PipelineSummary& summary = delivery.summary;
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("bytesIn", Napi::Number::New(env, bytesIn_));
+        result.Set("bytesOut", Napi::Number::New(env, bytesOut_));
+        result.Set("chunksIn", Napi::Number::New(env, chunksIn_));
+        result.Set("chunksOut", Napi::Number::New(env, chunksOut_));
+        if (!summary.iv.empty()) {
+          result.Set("iv", Napi::Buffer<uint8_t>::Copy(env, summary.iv.data(), summary.iv.size()));
+        }
+        if (!summary.authTag.empty()) {
+          result.Set("authTag", Napi::Buffer<uint8_t>::Copy(env, summary.authTag.data(), summary.authTag.size()));
+        }
+        if (!summary.digest.empty()) {
+          result.Set("digest", Napi::Buffer<uint8_t>::Copy(env, summary.digest.data(), summary.digest.size()));
+          result.Set("digestAlgorithm", Napi::String::New(env, summary.digestAlgorithm));
+        }
+        onEnd_.Call(Value(), { result });
+      }
+    } else {
+      MaybeResume();
+    }
+  }
+  
+  if (pending_ == 0) {
+    Unhold(env);
+  }
+}
+
+// Wake a paused writer once the queue has drained to the low watermark and
+// half the chunk slots; the gap to highWaterMark stops it thrashing
+void TransformPipeline::MaybeResume() {
+  static const uint32_t kBlockedMetric = PerformanceMonitor::GetInstance().RegisterOperation("TransformPipeline.blocked");
+  
+  if (!gauge_.Paused() || state_->queue->Size() > maxQueuedChunks_ / 2) {
+    return;
+  }
+  uint64_t blockedNs = gauge_.TryResume(OperationSpan::NowNs());
+  if (blockedNs == 0) {
+    return;
+  }
+  PerformanceMonitor::GetInstance().RecordOperation(kBlockedMetric, blockedNs, true);
+  if (!onDrain_.IsEmpty()) {
+    onDrain_.Call(Value(), {});
+  }
+}
+
+TransformPipeline* TransformPipeline::FromValue(Napi::Value value) {
+  if (!value.IsObject() || !value.As<Napi::Object>().InstanceOf(constructor.Value())) {
+    return nullptr;
+  }
+  return Napi::ObjectWrap<TransformPipeline>::Unwrap(value.As<Napi::Object>());
+}
+
+bool TransformPipeline::SetBackpressure(Napi::Env env, Napi::Object config) {
+  size_t high = gauge_.High();
+  size_t low = gauge_.Low();
+  size_t limit = maxQueuedBytes_;
+  std::string error;
+  if (!ReadWatermarks(config, high, low, limit, error)) {
+    Napi::RangeError::New(env, error).ThrowAsJavaScriptException();
+    return false;
+  }
+  
+  gauge_.Configure(high, low);
+  maxQueuedBytes_ = limit;
+  // Raised limits may release a writer that is waiting now
+  if (!closed_) {
+    MaybeResume();
+  }
+  return !env.IsExceptionPending();
+}
@@ -0,0 +1,85 @@
+#ifndef TRANSFORM_PIPELINE_H
+#define TRANSFORM_PIPELINE_H
+
+#include <napi.h>
+#include <memory>
+#include <string>
+#include "chunk_ring.h"
+
+struct PipelineState;
+struct PipelineDelivery;
+
+// Native chain of transform stages behind createTransformStream({ stages }).
+// Chunks are copied once on write(), run through every stage on a shared
+// worker pool (one pipeline runs on one thread at a time, so chunk order is
+// kept) and handed back to JS as Buffers over the same storage. Stages work
+// in place where they can: encryption rewrites the chunk, hashing reads it,
+// framing writes its header into reserved headroom, and (de)compression
+// (any CompressionCodec backend) swaps in its output instead of copying.
+//
+//   new TransformPipeline({ stages, onData, onEnd?, onError?, onDrain?, highWaterMark?,
+//                           lowWaterMark?, maxQueuedBytes?, maxQueuedChunks? })
+//   write(chunk) -> boolean   false once highWaterMark input bytes (or maxQueuedChunks
+//                             chunks) are queued; onDrain fires once the queue is back
+//                             to lowWaterMark. Throws past maxQueuedBytes.
+//   end()                     flush all stages; onEnd(summary) follows the last onData
+//   destroy()                 drop queued chunks; no further callbacks
+//   stats                     { bytesIn, bytesOut, chunksIn, chunksOut, queuedBytes, queuedChunks,
+//                               highWaterMark, lowWaterMark, paused, pauses, blockedMs }
+//
+// Input waits in a bounded single-producer / single-consumer ring between
+// the JS thread and the pool, so queued memory is capped by configuration.
+//
+// Stages: { type: 'encrypt' | 'decrypt', key, iv?, aad?, authTag?, algorithm? }
+//         { type: 'compress' | 'decompress', algorithm?, level?, windowLog?, workers?, dictionary?, flush? }
+//         { type: 'hash', algorithm? }
+//         { type: 'frame' }   4-byte big-endian length before every chunk
+class TransformPipeline : public Napi::ObjectWrap<TransformPipeline> {
+public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(Napi::Env env, Napi::Object config);
+
+  TransformPipeline(const Napi::CallbackInfo& info);
+  ~TransformPipeline();
+
+  // Runs on the JS thread for every batch the worker hands back
+  void Deliver(Napi::Env env, Napi::Function onData, PipelineDelivery& delivery);
+
+  // The pipeline behind value, or nullptr if it is not one
+  static TransformPipeline* FromValue(Napi::Value value);
+
+  // Change watermarks on a live pipeline (enableBackpressure); throws and
+  // returns false on invalid limits
+  bool SetBackpressure(Napi::Env env, Napi::Object config);
+
+private:
+  static Napi::FunctionReference constructor;
+
+  Napi::Value Write(const Napi::CallbackInfo& info);
+  Napi::Value End(const Napi::CallbackInfo& info);
+  Napi::Value Destroy(const Napi::CallbackInfo& info);
+  Napi::Value GetStats(const Napi::CallbackInfo& info);
+
+  // Keep this object and the event loop alive while chunks are in flight
+  void Hold(Napi::Env env);
+  void Unhold(Napi::Env env);
+  void MaybeResume();
+
+  std::shared_ptr<PipelineState> state_;
+  Napi::FunctionReference onEnd_;
+  Napi::FunctionReference onError_;
+  Napi::FunctionReference onDrain_;
+  BackpressureGauge gauge_;  // input bytes not yet delivered back to JS
+  size_t maxQueuedBytes_;
+  size_t maxQueuedChunks_;
+  size_t pending_;      // writes and end() not yet delivered
+  bool ended_;
+  bool closed_;         // ended, failed or destroyed; no more callbacks
+  bool released_;
+  double bytesIn_;
+  double bytesOut_;
+  double chunksIn_;
+  double chunksOut_;
+};
+
+#endif // TRANSFORM_PIPELINE_H
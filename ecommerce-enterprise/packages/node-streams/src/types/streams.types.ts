@@ -129,22 +129,34 @@ export interface EncryptedStreamConfig extends StreamConfig {
   encryptionKey: Buffer;
   encryptionAlgorithm: 'aes-256-gcm' | 'aes-128-gcm';
   enableIntegrityCheck: boolean;
+  mode?: 'encrypt' | 'decrypt';
+  iv?: Buffer;
+  aad?: Buffer;
+  authTag?: Buffer;
 }
 
 export interface CompressedStreamConfig extends StreamConfig {
-  compressionAlgorithm: 'gzip' | 'brotli' | 'lz4' | 'zstd';
+  compressionAlgorithm: 'gzip' | 'deflate' | 'brotli' | 'lz4' | 'zstd';
   compressionLevel: number;
   enableDictionary: boolean;
+  mode?: 'compress' | 'decompress';
+  windowLog?: number;          // log2 of the window; lz4 maps it to a block size
+  workers?: number;            // zstd compression threads
+  parallelThreshold?: number;  // payload size from which process() uses the workers
+  dictionary?: Buffer;         // e.g. from trainCompressionDictionary()
 }
 
 export interface MultiplexedStreamConfig extends StreamConfig {
-  maxStreams?: number;
+  maxStreams?: number;          // open channels; also accepted as maxChannels
+  initialWindow?: number;       // per-channel credit in bytes, default 256 KiB
+  maxFrameSize?: number;        // default 64 KiB
+  zeroCopyThreshold?: number;   // payloads from this size are not copied, default 8 KiB
   enableLoadBalancing?: boolean;
   enableFailover?: boolean;
 }
 
 export interface StreamSplitterConfig extends StreamConfig {
-  splitStrategy?: 'size' | 'time' | 'pattern' | 'custom';
+  splitStrategy?: 'size' | 'time' | 'pattern' | 'custom' | 'channel'; // 'channel': native framed channels
   splitSize?: number;
   splitInterval?: number;
   splitPattern?: RegExp;
@@ -152,7 +164,7 @@ export interface StreamSplitterConfig extends StreamConfig {
 }
 
 export interface StreamMergerConfig extends StreamConfig {
-  mergeStrategy?: 'round-robin' | 'priority' | 'custom';
+  mergeStrategy?: 'round-robin' | 'priority' | 'custom' | 'channel';
   priorities?: Map<string, number>;
   customMerger?: (streams: BaseStream[]) => BaseStream;
 }
@@ -162,11 +174,25 @@ export interface StreamCircuitBreakerConfig {
   recoveryTimeout: number;
   monitoringPeriod: number;
   halfOpenMaxCalls: number;
+  successThreshold?: number; // probe successes needed to close; defaults to halfOpenMaxCalls
+}
+
+export type CircuitBreakerState = 'closed' | 'open' | 'half-open';
+
+export interface CircuitBreakerStateChange {
+  state: CircuitBreakerState;
+  previous: CircuitBreakerState;
+  failures: number;
+  successes: number;
+  timestamp: number;
 }
 
 export interface StreamRateLimiterConfig {
   maxRequests: number;
   windowMs: number;
+  burst?: number; // requests a fresh key may make at once; defaults to maxRequests
+  maxKeys?: number; // keys tracked before the most refilled ones are recycled
+  name?: string; // limiters with the same name share their state across workers
   skipSuccessfulRequests?: boolean;
   skipFailedRequests?: boolean;
   keyGenerator?: (req: StreamContext) => string;
@@ -175,6 +201,7 @@ export interface StreamRateLimiterConfig {
 export interface StreamBackpressureConfig {
   highWaterMark: number;
   lowWaterMark: number;
+  maxQueuedBytes?: number; // native pipelines refuse writes past this; defaults to 2 * highWaterMark
   enableAutomaticDrain?: boolean;
   drainStrategy?: 'immediate' | 'gradual' | 'custom';
   customDrainStrategy?: (stream: BaseStream) => void;
@@ -0,0 +1,193 @@
+// Shared pieces of the native addon benchmark harnesses: option parsing,
+// a timing loop for JS-level calls and the addon-bench/1 report that
+// compare-benchmarks.js diffs.
+//
+// Report layout:
+//   { schema, suite, version, timestamp, environment: { node, platform, arch, cpus, cpuModel },
+//     results: [{ name, layer: 'native' | 'node', params: { payloadSize?, threads?, batch?, ... },
+//                 operations, nsPerOp, opsPerSecond, mbPerSecond, p50Ns, p99Ns }] }
+//
+// opsPerSecond always counts logical operations (one record of a batch, one
+// queue transfer), so per-call and batch rows of the same work line up.
+
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const os = require('os');
+
+const SCHEMA = 'addon-bench/1';
+
+// --out <file>, --duration <ms>, --quick (shorter runs, fewer sizes)
+function parseBenchArgs(argv) {
+  const options = { out: null, durationMs: 1000, quick: false };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    if (arg === '--out') {
+      options.out = argv[++i];
+    } else if (arg === '--duration') {
+      options.durationMs = Number(argv[++i]);
+    } else if (arg === '--quick') {
+      options.quick = true;
+    } else {
+      throw new Error(`Unknown option ${arg}`);
+    }
+  }
+  if (!(options.durationMs > 0)) {
+    throw new Error('--duration must be a positive number of milliseconds');
+  }
+  if (options.quick) {
+    options.durationMs = Math.min(options.durationMs, 200);
+  }
+  return options;
+}
+
+function createReport(suite, version) {
+  const cpus = os.cpus();
+  return {
+    schema: SCHEMA,
+    suite,
+    version,
+    timestamp: new Date().toISOString(),
+    environment: {
+      node: process.version,
+      platform: process.platform,
+      arch: process.arch,
+      cpus: cpus.length,
+      cpuModel: cpus.length ? cpus[0].model : 'unknown',
+    },
+    results: [],
+  };
+}
+
+function percentile(sorted, p) {
+  if (!sorted.length) {
+    return 0;
+  }
+  return sorted[Math.min(sorted.length - 1, Math.floor((p / 100) * sorted.length))];
+}
+
+// Call fn (which performs opsPerCall logical operations) in rounds of
+// callsPerRound for durationMs after a short warm-up. Latency percentiles
+// are per operation, taken from the round means; throughput is over the
+// whole run.
+function timeCalls(fn, { durationMs, opsPerCall = 1, callsPerRound = 64, payloadSize = 0 }) {
+  const warmupEnd = Date.now() + Math.min(100, durationMs / 4);
+  while (Date.now() < warmupEnd) {
+    fn();
+  }
+
+  const samples = [];
+  let calls = 0;
+  const start = process.hrtime.bigint();
+  const deadline = start + BigInt(Math.round(durationMs * 1e6));
+  let now = start;
+  while (now < deadline) {
+    for (let i = 0; i < callsPerRound; i++) {
+      fn();
+    }
+    const end = process.hrtime.bigint();
+    samples.push(Number(end - now) / (callsPerRound * opsPerCall));
+    calls += callsPerRound;
+    now = end;
+  }
+
+  const elapsedNs = Number(now - start);
+  const operations = calls * opsPerCall;
+  samples.sort((a, b) => a - b);
+  return summarize(operations, elapsedNs, payloadSize, percentile(samples, 50), percentile(samples, 99));
+}
+
+// Same, for a function returning a promise; concurrency calls are kept in
+// flight
+async function timeAsyncCalls(fn, { durationMs, opsPerCall = 1, concurrency = 1, payloadSize = 0 }) {
+  const samples = [];
+  let calls = 0;
+  const start = process.hrtime.bigint();
+  const deadline = start + BigInt(Math.round(durationMs * 1e6));
+  const lane = async () => {
+    while (process.hrtime.bigint() < deadline) {
+      const begin = process.hrtime.bigint();
+      await fn();
+      samples.push(Number(process.hrtime.bigint() - begin) / opsPerCall);
+      calls++;
+    }
+  };
+  await Promise.all(Array.from({ length: concurrency }, lane));
+
+  const elapsedNs = Number(process.hrtime.bigint() - start);
+  samples.sort((a, b) => a - b);
+  return summarize(calls * opsPerCall, elapsedNs, payloadSize, percentile(samples, 50), percentile(samples, 99));
+}
+
+function summarize(operations, elapsedNs, payloadSize, p50Ns, p99Ns) {
+  const opsPerSecond = elapsedNs > 0 ? (operations * 1e9) / elapsedNs : 0;
+  return {
+    operations,
+    nsPerOp: operations ? elapsedNs / operations : 0,
+    opsPerSecond,
+    mbPerSecond: (opsPerSecond * payloadSize) / 1e6,
+    p50Ns,
+    p99Ns,
+  };
+}
+
+function addResult(report, name, layer, params, measurement) {
+  const result = {
+    name,
+    layer,
+    params,
+    operations: measurement.operations,
+    nsPerOp: measurement.nsPerOp,
+    opsPerSecond: measurement.opsPerSecond,
+    mbPerSecond: measurement.mbPerSecond,
+    p50Ns: measurement.p50Ns,
+    p99Ns: measurement.p99Ns,
+  };
+  report.results.push(result);
+  const size = params.payloadSize !== undefined ? ` ${params.payloadSize}B` : '';
+  const threads = params.threads !== undefined ? ` x${params.threads}` : '';
+  const batch = params.batch !== undefined ? ` batch ${params.batch}` : '';
+  console.error(`${layer.padEnd(6)} ${name}${size}${threads}${batch}: ` +
+                `${Math.round(result.opsPerSecond)} ops/s, ${result.nsPerOp.toFixed(0)} ns/op`);
+  return result;
+}
+
+// Run a standalone native microbenchmark (the *_bench targets in
+// binding.gyp) and fold its results into report. Such binaries print one
+// JSON array of results on stdout; a missing binary is skipped with a note,
+// so the harness still works against an addon built without bench targets.
+function runNativeBench(report, binary, args = []) {
+  if (!fs.existsSync(binary)) {
+    console.error(`Skipping native microbenchmarks: ${binary} not built`);
+    return;
+  }
+  const child = spawnSync(binary, args, { encoding: 'utf8', stdio: ['ignore', 'pipe', 'inherit'], maxBuffer: 64 * 1024 * 1024 });
+  if (child.status !== 0) {
+    throw new Error(`${binary} exited with ${child.status === null ? child.signal : child.status}`);
+  }
+  for (const result of JSON.parse(child.stdout)) {
+    addResult(report, result.name, 'native', result.params || {}, result);
+  }
+}
+
+// JSON goes to --out or stdout; progress lines went to stderr, so stdout
+// can be redirected straight into a file
+function writeReport(report, out) {
+  const json = JSON.stringify(report, null, 2) + '\n';
+  if (out) {
+    fs.writeFileSync(out, json);
+    console.error(`Wrote ${report.results.length} results to ${out}`);
+  } else {
+    process.stdout.write(json);
+  }
+}
+
+module.exports = {
+  SCHEMA,
+  parseBenchArgs,
+  createReport,
+  timeCalls,
+  timeAsyncCalls,
+  addResult,
+  runNativeBench,
+  writeReport,
+};
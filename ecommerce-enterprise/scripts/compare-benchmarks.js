@@ -0,0 +1,142 @@
+#!/usr/bin/env node
+
+// Compare two benchmark reports written by the native addon harnesses
+// (packages/node-crypto/bench, packages/node-streams/bench and
+// fastify/addons/bench) and fail when any shared result got slower.
+//
+//   node scripts/compare-benchmarks.js baseline.json current.json [--threshold 10] [--json]
+//
+// Results are matched on name + params. A result regresses when its
+// opsPerSecond drops by more than threshold percent; p99Ns is reported
+// alongside but only throughput decides the exit code, since tail latency
+// on shared CI machines is too noisy to gate on.
+
+const fs = require('fs');
+
+const SCHEMA = 'addon-bench/1';
+
+function usage(message) {
+  if (message) {
+    console.error(message);
+  }
+  console.error('Usage: compare-benchmarks.js <baseline.json> <current.json> [--threshold <percent>] [--json]');
+  process.exit(2);
+}
+
+function parseArgs(argv) {
+  const options = { files: [], threshold: 10, json: false };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    if (arg === '--threshold') {
+      options.threshold = Number(argv[++i]);
+      if (!(options.threshold >= 0)) {
+        usage('--threshold must be a non-negative number');
+      }
+    } else if (arg === '--json') {
+      options.json = true;
+    } else if (arg.startsWith('--')) {
+      usage(`Unknown option ${arg}`);
+    } else {
+      options.files.push(arg);
+    }
+  }
+  if (options.files.length !== 2) {
+    usage();
+  }
+  return options;
+}
+
+function loadReport(file) {
+  let report;
+  try {
+    report = JSON.parse(fs.readFileSync(file, 'utf8'));
+  } catch (error) {
+    usage(`Cannot read ${file}: ${error.message}`);
+  }
+  if (report.schema !== SCHEMA || !Array.isArray(report.results)) {
+    usage(`${file} is not an ${SCHEMA} report`);
+  }
+  return report;
+}
+
+// Stable key: params are sorted so { threads, payloadSize } and
+// { payloadSize, threads } match
+function resultKey(result) {
+  const params = result.params || {};
+  const parts = Object.keys(params).sort().map(name => `${name}=${params[name]}`);
+  return `${result.name}[${parts.join(',')}]`;
+}
+
+function indexResults(report) {
+  const results = new Map();
+  for (const result of report.results) {
+    results.set(resultKey(result), result);
+  }
+  return results;
+}
+
+function percentChange(before, after) {
+  return before > 0 ? ((after - before) / before) * 100 : 0;
+}
+
+function compare(baseline, current, threshold) {
+  const before = indexResults(baseline);
+  const after = indexResults(current);
+  const rows = [];
+  for (const [key, result] of after) {
+    const previous = before.get(key);
+    if (!previous) {
+      rows.push({ key, status: 'new', opsPerSecond: result.opsPerSecond });
+      continue;
+    }
+    const throughput = percentChange(previous.opsPerSecond, result.opsPerSecond);
+    const p99 = previous.p99Ns && result.p99Ns ? percentChange(previous.p99Ns, result.p99Ns) : null;
+    rows.push({
+      key,
+      status: throughput < -threshold ? 'regressed' : throughput > threshold ? 'improved' : 'unchanged',
+      baselineOpsPerSecond: previous.opsPerSecond,
+      opsPerSecond: result.opsPerSecond,
+      throughputChange: throughput,
+      p99Change: p99,
+    });
+  }
+  for (const key of before.keys()) {
+    if (!after.has(key)) {
+      rows.push({ key, status: 'missing' });
+    }
+  }
+  return rows;
+}
+
+function formatPercent(value) {
+  return value === null || value === undefined ? '' : `${value >= 0 ? '+' : ''}${value.toFixed(1)}%`;
+}
+
+function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const baseline = loadReport(options.files[0]);
+  const current = loadReport(options.files[1]);
+  if (baseline.suite !== current.suite) {
+    console.warn(`Comparing different suites: ${baseline.suite} vs ${current.suite}`);
+  }
+
+  const rows = compare(baseline, current, options.threshold);
+  const regressions = rows.filter(row => row.status === 'regressed');
+
+  if (options.json) {
+    console.log(JSON.stringify({ threshold: options.threshold, regressions: regressions.length, rows }, null, 2));
+  } else {
+    console.log(`${current.suite}: ${baseline.version || '?'} -> ${current.version || '?'} (threshold ${options.threshold}%)`);
+    for (const row of rows) {
+      const detail = row.status === 'new' || row.status === 'missing'
+        ? ''
+        : `${formatPercent(row.throughputChange).padStart(8)} ops/s  ${formatPercent(row.p99Change).padStart(8)} p99`;
+      console.log(`  ${row.status.padEnd(9)} ${detail}  ${row.key}`);
+    }
+    console.log(`${regressions.length} regression(s)`);
+  }
+
+  process.exit(regressions.length ? 1 : 0);
+}
+
+main();
@@ -0,0 +1,219 @@
+/**
+ * Benchmarks for silicon_valley_addon, written as an addon-bench/1 report
+ * (the layout ecommerce-enterprise/scripts/compare-benchmarks.js diffs).
+ *
+ *   node-gyp rebuild
+ *   BENCH_VERSION=1.2.0 node bench/harness.mjs [--out results.json] [--duration 1000] [--quick]
+ *
+ * Native rows come from the silicon_valley_bench binary (engines without
+ * V8); node rows time the exported functions per call and batched, across
+ * payload sizes and stream worker counts.
+ */
+
+import { spawnSync } from 'child_process';
+import { createRequire } from 'module';
+import fs from 'fs';
+import os from 'os';
+import path from 'path';
+import { fileURLToPath } from 'url';
+
+const require = createRequire(import.meta.url);
+const release = path.join(path.dirname(fileURLToPath(import.meta.url)), '..', 'build', 'Release');
+const addon = require(path.join(release, 'silicon_valley_addon.node'));
+
+function parseArgs(argv) {
+  const options = { out: null, durationMs: 1000, quick: false };
+  for (let i = 0; i < argv.length; i++) {
+    if (argv[i] === '--out') {
+      options.out = argv[++i];
+    } else if (argv[i] === '--duration') {
+      options.durationMs = Number(argv[++i]);
+    } else if (argv[i] === '--quick') {
+      options.quick = true;
+    } else {
+      throw new Error(`Unknown option ${argv[i]}`);
+    }
+  }
+  if (!(options.durationMs > 0)) {
+    throw new Error('--duration must be a positive number of milliseconds');
+  }
+  if (options.quick) {
+    options.durationMs = Math.min(options.durationMs, 200);
+  }
+  return options;
+}
+
+const options = parseArgs(process.argv.slice(2));
+const payloadSizes = options.quick ? [1024, 1 << 20] : [64, 1024, 16384, 1 << 20];
+const workerCounts = options.quick ? [1, 2] : [1, 2, 4];
+const batchSizes = options.quick ? [64] : [16, 256];
+
+const cpus = os.cpus();
+const report = {
+  schema: 'addon-bench/1',
+  suite: 'silicon-valley-addon',
+  version: process.env.BENCH_VERSION || null, // no package.json here; set it to tag a release run
+  timestamp: new Date().toISOString(),
+  environment: {
+    node: process.version,
+    platform: process.platform,
+    arch: process.arch,
+    cpus: cpus.length,
+    cpuModel: cpus.length ? cpus[0].model : 'unknown'
+  },
+  results: []
+};
+
+function percentile(sorted, p) {
+  return sorted.length ? sorted[Math.min(sorted.length - 1, Math.floor((p / 100) * sorted.length))] : 0;
+}
+
+function summarize(operations, elapsedNs, payloadSize, samples) {
+  samples.sort((a, b) => a - b);
+  const opsPerSecond = elapsedNs > 0 ? (operations * 1e9) / elapsedNs : 0;
+  return {
+    operations,
+    nsPerOp: operations ? elapsedNs / operations : 0,
+    opsPerSecond,
+    mbPerSecond: (opsPerSecond * payloadSize) / 1e6,
+    p50Ns: percentile(samples, 50),
+    p99Ns: percentile(samples, 99)
+  };
+}
+
+function addResult(name, layer, params, measurement) {
+  const { operations, nsPerOp, opsPerSecond, mbPerSecond, p50Ns, p99Ns } = measurement;
+  report.results.push({ name, layer, params, operations, nsPerOp, opsPerSecond, mbPerSecond, p50Ns, p99Ns });
+  const detail = Object.entries(params).map(([key, value]) => `${key}=${value}`).join(' ');
+  console.error(`${layer.padEnd(6)} ${name} ${detail}: ${Math.round(opsPerSecond)} ops/s, ${nsPerOp.toFixed(0)} ns/op`);
+}
+
+// fn does opsPerCall operations; timed in rounds of callsPerRound, each
+// round one latency sample
+function timeCalls(fn, { opsPerCall = 1, callsPerRound = 64, payloadSize = 0 } = {}) {
+  const warmupEnd = Date.now() + Math.min(100, options.durationMs / 4);
+  while (Date.now() < warmupEnd) {
+    fn();
+  }
+  const samples = [];
+  let calls = 0;
+  const start = process.hrtime.bigint();
+  const deadline = start + BigInt(Math.round(options.durationMs * 1e6));
+  let now = start;
+  while (now < deadline) {
+    for (let i = 0; i < callsPerRound; i++) {
+      fn();
+    }
+    const end = process.hrtime.bigint();
+    samples.push(Number(end - now) / (callsPerRound * opsPerCall));
+    calls += callsPerRound;
+    now = end;
+  }
+  return summarize(calls * opsPerCall, Number(now - start), payloadSize, samples);
+}
+
+// fn returns a promise; concurrency calls stay in flight
+async function timeAsyncCalls(fn, { opsPerCall = 1, concurrency = 1, payloadSize = 0 } = {}) {
+  const samples = [];
+  let calls = 0;
+  const start = process.hrtime.bigint();
+  const deadline = start + BigInt(Math.round(options.durationMs * 1e6));
+  const lane = async () => {
+    while (process.hrtime.bigint() < deadline) {
+      const begin = process.hrtime.bigint();
+      await fn();
+      samples.push(Number(process.hrtime.bigint() - begin) / opsPerCall);
+      calls++;
+    }
+  };
+  await Promise.all(Array.from({ length: concurrency }, lane));
+  return summarize(calls * opsPerCall, Number(process.hrtime.bigint() - start), payloadSize, samples);
+}
+
+function runNativeBench() {
+  const binary = path.join(release, 'silicon_valley_bench');
+  if (!fs.existsSync(binary)) {
+    console.error(`Skipping native microbenchmarks: ${binary} not built`);
+    return;
+  }
+  const args = ['--duration', String(options.durationMs), ...(options.quick ? ['--quick'] : [])];
+  const child = spawnSync(binary, args, { encoding: 'utf8', stdio: ['ignore', 'pipe', 'inherit'], maxBuffer: 64 * 1024 * 1024 });
+  if (child.status !== 0) {
+    throw new Error(`${binary} exited with ${child.status === null ? child.signal : child.status}`);
+  }
+  for (const result of JSON.parse(child.stdout)) {
+    addResult(result.name, 'native', result.params, result);
+  }
+}
+
+// Request-shaped text, so processString and the matcher have tokens to find
+function makeText(payloadSize) {
+  const line = 'GET /api/v1/orders HTTP/1.1\r\nContent-Type: application/json\r\nUser-Agent: loadgen\r\n\r\n';
+  return line.repeat(Math.ceil(payloadSize / line.length)).slice(0, payloadSize);
+}
+
+function benchStrings() {
+  const matcher = new addon.PatternMatcher(['GET', 'POST', 'application/json', 'Authorization', 'User-Agent']);
+  for (const payloadSize of payloadSizes) {
+    const text = makeText(payloadSize);
+    const buffer = Buffer.from(text);
+    const callsPerRound = payloadSize >= 1 << 20 ? 1 : 64;
+    addResult('processString', 'node', { payloadSize },
+              timeCalls(() => addon.processString(text), { payloadSize, callsPerRound }));
+    addResult('PatternMatcher.scan', 'node', { payloadSize },
+              timeCalls(() => matcher.scan(buffer), { payloadSize, callsPerRound }));
+    addResult('PatternMatcher.count', 'node', { payloadSize },
+              timeCalls(() => matcher.count(buffer), { payloadSize, callsPerRound }));
+  }
+}
+
+// Per-call cost includes creating the Buffer and its finalizer; collection
+// returns the block later, so this is allocation throughput under GC
+function benchAllocate() {
+  for (const payloadSize of [64, 1024, 16384]) {
+    addResult('allocateMemory', 'node', { payloadSize },
+              timeCalls(() => addon.allocateMemory(payloadSize), { payloadSize }));
+  }
+}
+
+async function benchStreams() {
+  for (const workers of workerCounts) {
+    addon.initialize({ workers, queueCapacity: 4096 });
+    for (const payloadSize of payloadSizes) {
+      const input = Buffer.from(makeText(payloadSize));
+      addResult('processStream', 'node', { payloadSize, threads: workers, batch: 1 },
+                await timeAsyncCalls(() => addon.processStream(input), { payloadSize }));
+      addResult('processStream.concurrent', 'node', { payloadSize, threads: workers, batch: 1 },
+                await timeAsyncCalls(() => addon.processStream(input), { payloadSize, concurrency: 64 }));
+      if (payloadSize > 16384) {
+        continue;
+      }
+      for (const batch of batchSizes) {
+        const inputs = Array.from({ length: batch }, () => input);
+        addResult('processStream', 'node', { payloadSize, threads: workers, batch },
+                  await timeAsyncCalls(() => addon.processStream(inputs), { payloadSize, opsPerCall: batch }));
+      }
+    }
+  }
+}
+
+async function main() {
+  runNativeBench();
+  addon.initialize();
+  benchStrings();
+  benchAllocate();
+  await benchStreams();
+
+  const json = JSON.stringify(report, null, 2) + '\n';
+  if (options.out) {
+    fs.writeFileSync(options.out, json);
+    console.error(`Wrote ${report.results.length} results to ${options.out}`);
+  } else {
+    process.stdout.write(json);
+  }
+}
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
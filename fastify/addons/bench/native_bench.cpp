@@ -0,0 +1,393 @@
+/**
+ * Standalone microbenchmarks for the Silicon Valley add-on engines: the
+ * MPMC ring, the work-stealing deque, the pattern matcher, string hashing
+ * and the slab memory pool. Built by the silicon_valley_bench target in
+ * binding.gyp and run by bench/harness.mjs, which folds the JSON array
+ * printed on stdout into its addon-bench/1 report.
+ *
+ *   silicon_valley_bench [--duration ms] [--quick]
+ */
+
+#include "../highPerformanceEngines.h"
+#include <chrono>
+#include <cstdio>
+#include <utility>
+
+using namespace SiliconValleyAddon;
+
+static uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct BenchResult {
+    std::string name;
+    std::vector<std::pair<std::string, double>> params;
+    uint64_t operations = 0;
+    uint64_t elapsedNs = 0;
+    size_t payloadSize = 0;
+    std::vector<double> samples;  // mean ns per operation of each round
+};
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size()));
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static void printResults(std::vector<BenchResult>& results) {
+    std::printf("[\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        BenchResult& result = results[i];
+        std::sort(result.samples.begin(), result.samples.end());
+        double seconds = static_cast<double>(result.elapsedNs) / 1e9;
+        double opsPerSecond = seconds > 0 ? static_cast<double>(result.operations) / seconds : 0;
+
+        std::string params;
+        for (const auto& param : result.params) {
+            char value[64];
+            std::snprintf(value, sizeof(value), "%s\"%s\": %.17g", params.empty() ? "" : ", ",
+                          param.first.c_str(), param.second);
+            params += value;
+        }
+        std::printf("  { \"name\": \"%s\", \"params\": { %s }, \"operations\": %llu, \"nsPerOp\": %.3f, "
+                    "\"opsPerSecond\": %.3f, \"mbPerSecond\": %.3f, \"p50Ns\": %.3f, \"p99Ns\": %.3f }%s\n",
+                    result.name.c_str(), params.c_str(), static_cast<unsigned long long>(result.operations),
+                    result.operations ? static_cast<double>(result.elapsedNs) / static_cast<double>(result.operations) : 0.0,
+                    opsPerSecond, opsPerSecond * static_cast<double>(result.payloadSize) / 1e6,
+                    percentile(result.samples, 50), percentile(result.samples, 99),
+                    i + 1 < results.size() ? "," : "");
+    }
+    std::printf("]\n");
+}
+
+// Run round(thread) on every thread until durationMs has passed, after a
+// short warm-up. Each call returns how many operations it did and becomes
+// one latency sample (threads that only feed the others return 0);
+// throughput is over the slowest thread's time. A round that times its own
+// useful work adds it to (*busyNs)[thread], which then replaces the wall
+// time for that thread.
+template<typename Round>
+static void measure(BenchResult& result, size_t threads, uint64_t durationMs, Round round,
+                    std::vector<uint64_t>* busyNs = nullptr) {
+    std::atomic<size_t> ready(0);
+    std::atomic<uint64_t> start(0);
+    std::vector<std::vector<double>> samples(threads);
+    std::vector<uint64_t> operations(threads, 0);
+    std::vector<uint64_t> elapsed(threads, 0);
+
+    auto body = [&](size_t thread) {
+        uint64_t warmupEnd = nowNs() + std::min<uint64_t>(100, durationMs / 4) * 1000000ull;
+        while (nowNs() < warmupEnd) {
+            round(thread);
+        }
+        // Every thread starts its timed loop at once
+        if (ready.fetch_add(1) + 1 == threads) {
+            start.store(nowNs());
+        }
+        while (start.load() == 0) {
+            std::this_thread::yield();
+        }
+        uint64_t begin = start.load();
+        if (busyNs) {
+            (*busyNs)[thread] = 0;
+        }
+        uint64_t deadline = begin + durationMs * 1000000ull;
+        uint64_t last = nowNs();
+        while (last < deadline) {
+            uint64_t done = round(thread);
+            uint64_t now = nowNs();
+            if (done) {
+                samples[thread].push_back(static_cast<double>(now - last) / static_cast<double>(done));
+            }
+            operations[thread] += done;
+            last = now;
+        }
+        elapsed[thread] = busyNs ? (*busyNs)[thread] : last - begin;
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(body, t);
+    }
+    body(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (size_t t = 0; t < threads; ++t) {
+        result.operations += operations[t];
+        result.elapsedNs = std::max(result.elapsedNs, elapsed[t]);
+        result.samples.insert(result.samples.end(), samples[t].begin(), samples[t].end());
+    }
+}
+
+// Ring and Deque
+
+static BenchResult benchRingLocal(size_t batch, uint64_t durationMs) {
+    BenchResult result;
+    result.name = batch > 1 ? "MpmcRing.batch" : "MpmcRing.enqueueDequeue";
+    result.params = { { "threads", 1 }, { "batch", static_cast<double>(batch) } };
+
+    MpmcRing<uintptr_t> ring(1024);
+    std::vector<uintptr_t> values(batch);
+    for (size_t i = 0; i < batch; ++i) {
+        values[i] = i + 1;
+    }
+    measure(result, 1, durationMs, [&](size_t) -> uint64_t {
+        for (int i = 0; i < 64; ++i) {
+            if (batch > 1) {
+                ring.enqueueBatch(values.data(), batch);
+                ring.dequeueBatch(values.data(), batch);
+            } else {
+                ring.tryEnqueue(values[0]);
+                ring.tryDequeue(values[0]);
+            }
+        }
+        return 64 * batch;
+    });
+    return result;
+}
+
+// Half the threads produce and half consume, as the stream workers do
+// with their submitters; operations are items dequeued
+static BenchResult benchRingTransfer(size_t threads, uint64_t durationMs) {
+    BenchResult result;
+    result.name = "MpmcRing.transfer";
+    result.params = { { "threads", static_cast<double>(threads) }, { "batch", 1 } };
+
+    MpmcRing<uintptr_t> ring(1024);
+    measure(result, threads, durationMs, [&](size_t thread) -> uint64_t {
+        uintptr_t value = thread + 1;
+        uint64_t done = 0;
+        for (int i = 0; i < 256; ++i) {
+            if (thread % 2 == 0) {
+                if (!ring.tryEnqueue(value)) {
+                    std::this_thread::yield();
+                }
+            } else if (ring.tryDequeue(value)) {
+                ++done;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        return thread % 2 == 0 ? 0 : done;
+    });
+    return result;
+}
+
+static BenchResult benchDequeLocal(uint64_t durationMs) {
+    BenchResult result;
+    result.name = "WorkStealingDeque.pushPop";
+    result.params = { { "threads", 1 } };
+
+    WorkStealingDeque<uintptr_t> deque(256);
+    measure(result, 1, durationMs, [&](size_t) -> uint64_t {
+        uintptr_t item = 0;
+        for (uintptr_t i = 1; i <= 128; ++i) {
+            deque.push(i);
+        }
+        for (int i = 0; i < 128; ++i) {
+            deque.pop(item);
+        }
+        return 128;
+    });
+    return result;
+}
+
+// Thread 0 owns the deque and keeps it full; every other thread steals in
+// bursts that end at the first miss. Operations are successful steals, and
+// elapsed time is the longest any thief spent in bursts that took
+// something, so time spent waiting on an empty deque is left out.
+static BenchResult benchDequeSteal(size_t threads, uint64_t durationMs) {
+    BenchResult result;
+    result.name = "WorkStealingDeque.steal";
+    result.params = { { "threads", static_cast<double>(threads) } };
+
+    WorkStealingDeque<uintptr_t> deque(1024);
+    std::vector<uint64_t> busyNs(threads, 0);
+    measure(result, threads, durationMs, [&](size_t thread) -> uint64_t {
+        if (thread == 0) {
+            for (uintptr_t i = 1; i <= 256; ++i) {
+                if (!deque.push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+            return 0;
+        }
+        uint64_t stolen = 0;
+        uintptr_t item = 0;
+        uint64_t begin = nowNs();
+        while (stolen < 64 && deque.steal(item)) {
+            ++stolen;
+        }
+        if (stolen) {
+            busyNs[thread] += nowNs() - begin;
+        }
+        return stolen;
+    }, &busyNs);
+    return result;
+}
+
+// Matching
+
+static const char* const kHttpLine =
+    "GET /api/v1/orders?limit=50 HTTP/1.1\r\nHost: shop.example.com\r\n"
+    "User-Agent: loadgen/2.1\r\nAccept: application/json\r\nContent-Type: text/plain\r\n"
+    "Authorization: Bearer 3q2+7w==\r\n\r\n{\"sku\":\"A-1043\",\"qty\":2}\n";
+
+// Request-like text full of candidates, or lowercase text none of the HTTP
+// tokens can start in, which is what the prefilter skips over
+static std::string makeText(size_t length, bool sparse) {
+    std::string text;
+    text.reserve(length + 256);
+    uint32_t state = 2463534242u;
+    while (text.size() < length) {
+        if (sparse) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            text.push_back(static_cast<char>('a' + state % 26));
+        } else {
+            text += kHttpLine;
+        }
+    }
+    text.resize(length);
+    return text;
+}
+
+static std::vector<std::string> makeWords(size_t count) {
+    std::vector<std::string> words;
+    uint32_t state = 88172645u;
+    for (size_t i = 0; i < count; ++i) {
+        std::string word;
+        size_t length = 4 + i % 9;
+        for (size_t j = 0; j < length; ++j) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            word.push_back(static_cast<char>('A' + state % 26));
+        }
+        words.push_back(word);
+    }
+    return words;
+}
+
+static BenchResult benchScan(const PatternMatcher& matcher, const char* name, size_t patterns,
+                             size_t payloadSize, bool sparse, uint64_t durationMs) {
+    BenchResult result;
+    result.name = name;
+    result.params = { { "payloadSize", static_cast<double>(payloadSize) }, { "patterns", static_cast<double>(patterns) } };
+    result.payloadSize = payloadSize;
+
+    std::string text = makeText(payloadSize, sparse);
+    std::vector<PatternMatch> matches;
+    matches.reserve(4096);
+    measure(result, 1, durationMs, [&](size_t) -> uint64_t {
+        matches.clear();
+        matcher.scan(reinterpret_cast<const uint8_t*>(text.data()), text.size(), matches);
+        return 1;
+    });
+    return result;
+}
+
+static BenchResult benchHash(size_t payloadSize, uint64_t durationMs) {
+    BenchResult result;
+    result.name = "StringProcessor.hashString";
+    result.params = { { "payloadSize", static_cast<double>(payloadSize) } };
+    result.payloadSize = payloadSize;
+
+    StringProcessor processor;
+    std::string text = makeText(payloadSize, false);
+    volatile uint64_t sink = 0;
+    measure(result, 1, durationMs, [&](size_t) -> uint64_t {
+        sink = sink + processor.hashString(text);
+        return 1;
+    });
+    return result;
+}
+
+// Allocation
+
+// Each round allocates a burst of blocks and frees them newest first, the
+// pattern of a request handler building and dropping buffers. Operations
+// are allocate + deallocate pairs.
+static BenchResult benchPool(MemoryPool& pool, size_t blockSize, size_t threads, uint64_t durationMs) {
+    BenchResult result;
+    result.name = "MemoryPool.allocateFree";
+    result.params = { { "payloadSize", static_cast<double>(blockSize) }, { "threads", static_cast<double>(threads) } };
+
+    const size_t burst = blockSize > (size_t(64) << 10) ? 4 : 64;
+    std::vector<std::vector<void*>> blocks(threads, std::vector<void*>(burst));
+    measure(result, threads, durationMs, [&](size_t thread) -> uint64_t {
+        std::vector<void*>& held = blocks[thread];
+        for (size_t i = 0; i < burst; ++i) {
+            held[i] = pool.allocate(blockSize);
+        }
+        for (size_t i = burst; i-- > 0;) {
+            pool.deallocate(held[i]);
+        }
+        return burst;
+    });
+    return result;
+}
+
+int main(int argc, char** argv) {
+    uint64_t durationMs = 1000;
+    bool quick = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            durationMs = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else {
+            std::fprintf(stderr, "usage: %s [--duration ms] [--quick]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (quick) {
+        durationMs = std::min<uint64_t>(durationMs, 200);
+    }
+    durationMs = std::max<uint64_t>(durationMs, 1);
+
+    std::vector<size_t> threadCounts = quick ? std::vector<size_t>{ 2 } : std::vector<size_t>{ 2, 4 };
+    std::vector<size_t> payloadSizes = quick ? std::vector<size_t>{ 1024, 1 << 20 }
+                                             : std::vector<size_t>{ 64, 1024, 16384, 1 << 20 };
+    std::vector<BenchResult> results;
+
+    results.push_back(benchRingLocal(1, durationMs));
+    results.push_back(benchRingLocal(32, durationMs));
+    for (size_t threads : threadCounts) {
+        results.push_back(benchRingTransfer(threads, durationMs));
+    }
+    results.push_back(benchDequeLocal(durationMs));
+    for (size_t threads : threadCounts) {
+        results.push_back(benchDequeSteal(threads, durationMs));
+    }
+
+    StringProcessor processor;
+    PatternMatcher http(processor.getCommonPatterns(), false);
+    std::vector<std::string> words = makeWords(1000);
+    PatternMatcher dictionary(words, true);
+    for (size_t payloadSize : payloadSizes) {
+        results.push_back(benchScan(http, "PatternMatcher.scan.http", http.getPatternCount(), payloadSize, false, durationMs));
+        results.push_back(benchScan(http, "PatternMatcher.scan.sparse", http.getPatternCount(), payloadSize, true, durationMs));
+        results.push_back(benchScan(dictionary, "PatternMatcher.scan.http", dictionary.getPatternCount(), payloadSize, false, durationMs));
+        results.push_back(benchHash(payloadSize, durationMs));
+    }
+
+    MemoryPool pool;
+    std::vector<size_t> blockSizes = quick ? std::vector<size_t>{ 1024 }
+                                           : std::vector<size_t>{ 64, 1024, 16384, 256 << 10 };
+    threadCounts.insert(threadCounts.begin(), 1);
+    for (size_t blockSize : blockSizes) {
+        for (size_t threads : threadCounts) {
+            results.push_back(benchPool(pool, blockSize, threads, durationMs));
+        }
+    }
+
+    printResults(results);
+    return 0;
+}
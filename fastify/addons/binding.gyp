@@ -31,6 +31,28 @@
           }
         }]
       ]
+    },
+    {
+      "target_name": "silicon_valley_bench",
+      "type": "executable",
+      "sources": [ "bench/native_bench.cpp" ],
+      "cflags!": [ "-fno-exceptions" ],
+      "cflags_cc!": [ "-fno-exceptions" ],
+      "xcode_settings": {
+        "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+        "CLANG_CXX_LIBRARY": "libc++",
+        "MACOSX_DEPLOYMENT_TARGET": "10.7"
+      },
+      "msvs_settings": {
+        "VCCLCompilerTool": {
+          "ExceptionHandling": 1
+        }
+      },
+      "conditions": [
+        ["OS!='win'", {
+          "libraries": [ "-lpthread" ]
+        }]
+      ]
     }
   ]
 }
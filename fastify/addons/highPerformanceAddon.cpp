@@ -17,336 +17,330 @@
 #include <node.h>
 #include <v8.h>
 #include <nan.h>
+#include <node_buffer.h>
+#include <uv.h>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <atomic>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
 #include <algorithm>
 #include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 
+#include "highPerformanceEngines.h"
+
 namespace SiliconValleyAddon {
 
 using namespace v8;
 
-// Advanced Lock-Free Queue Implementation (Microsoft Research)
-template<typename T>
-class LockFreeQueue {
-private:
-    struct Node {
-        T data;
-        std::atomic<Node*> next;
-        Node(const T& value) : data(value), next(nullptr) {}
-    };
+// Real-time Stream Processor (Twitter Research)
+struct StreamBatch;
+
+// One input: a view of the caller's bytes and room for its result
+struct StreamTask {
+    const char* data;
+    size_t length;
+    std::string result;
+    StreamBatch* batch;
+};
+
+// Everything one submission asked for. Tasks finish in any order on any
+// worker; the batch is handed back once the last of them has.
+struct StreamBatch {
+    std::vector<StreamTask> tasks;
+    std::atomic<size_t> remaining;
     
-    std::atomic<Node*> head;
-    std::atomic<Node*> tail;
-    std::atomic<size_t> size;
+    virtual ~StreamBatch() = default;
+};
 
+// N workers, each with its own deque, fed from one bounded ring. A worker
+// drains its deque, then takes up to kBatchSize tasks from the ring (keeping
+// the rest where others can steal them), then steals, and only then sleeps.
+// Finished batches are handed to the loop thread through one uv_async_t, so
+// a burst of completions costs one wakeup and is settled in one pass.
+class StreamProcessor {
 public:
-    LockFreeQueue() {
-        Node* dummy = new Node(T());
-        head.store(dummy);
-        tail.store(dummy);
-        size.store(0);
-    }
-    
-    ~LockFreeQueue() {
-        Node* current = head.load();
-        while (current) {
-            Node* next = current->next.load();
-            delete current;
-            current = next;
-        }
-    }
+    // Runs on the loop thread. delivered is false when the processor is torn
+    // down with the environment and the batches only need freeing.
+    using CompletionHandler = void (*)(std::vector<StreamBatch*>& batches, bool delivered);
     
-    void enqueue(const T& value) {
-        Node* newNode = new Node(value);
-        Node* oldTail = tail.exchange(newNode);
-        oldTail->next.store(newNode);
-        size.fetch_add(1);
-    }
+private:
+    static constexpr size_t kBatchSize = 32;
     
-    bool dequeue(T& value) {
-        Node* oldHead = head.load();
-        Node* newHead = oldHead->next.load();
+    struct Worker {
+        WorkStealingDeque<StreamTask*> deque;
+        std::thread thread;
         
-        if (!newHead) {
-            return false;
-        }
-        
-        value = newHead->data;
-        head.store(newHead);
-        delete oldHead;
-        size.fetch_sub(1);
-        return true;
-    }
+        Worker() : deque(kBatchSize) {}
+    };
     
-    size_t getSize() const {
-        return size.load();
-    }
-};
-
-// High-Performance String Processing (Google Research)
-class StringProcessor {
-private:
-    std::unordered_map<std::string, size_t> patternCache;
-    std::vector<std::string> commonPatterns;
+    MpmcRing<StreamTask*> inputQueue;
+    std::vector<std::unique_ptr<Worker>> workers;
+    WakeSignal inputReady;
+    std::atomic<bool> running;
+    std::atomic<bool> abandoned;
+    std::atomic<uint64_t> tasksCompleted;
+    std::atomic<uint64_t> tasksStolen;
+    StringProcessor stringProcessor;
+    
+    std::mutex completedMutex;
+    std::vector<StreamBatch*> completed;
+    uv_async_t* completionSignal;
+    CompletionHandler onComplete;
+    std::unordered_set<StreamBatch*> pending;  // loop thread only
+    bool stopped;
     
 public:
-    StringProcessor() {
-        // Initialize common patterns for optimization
-        commonPatterns = {
-            "GET", "POST", "PUT", "DELETE", "PATCH",
-            "application/json", "text/html", "text/plain",
-            "Authorization", "Content-Type", "User-Agent"
-        };
+    StreamProcessor(size_t workerCount, size_t queueCapacity, uv_loop_t* loop, CompletionHandler onComplete)
+        : inputQueue(queueCapacity), running(true), abandoned(false), tasksCompleted(0), tasksStolen(0),
+          completionSignal(new uv_async_t), onComplete(onComplete), stopped(false) {
+        completionSignal->data = this;
+        uv_async_init(loop, completionSignal, [](uv_async_t* handle) {
+            if (StreamProcessor* self = static_cast<StreamProcessor*>(handle->data)) {
+                self->deliverCompleted();
+            }
+        });
+        // Only keeps the loop alive while submissions are outstanding
+        uv_unref(reinterpret_cast<uv_handle_t*>(completionSignal));
         
-        for (size_t i = 0; i < commonPatterns.size(); ++i) {
-            patternCache[commonPatterns[i]] = i;
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers[i]->thread = std::thread([this, i] { workerLoop(i); });
         }
     }
     
-    // Advanced string matching with pattern optimization
-    std::vector<size_t> findPattern(const std::string& text, const std::string& pattern) {
-        std::vector<size_t> positions;
-        
-        // Use Boyer-Moore algorithm for large patterns
-        if (pattern.length() > 10) {
-            return boyerMooreSearch(text, pattern);
-        }
-        
-        // Use KMP for smaller patterns
-        return kmpSearch(text, pattern);
+    ~StreamProcessor() {
+        stop(false);
     }
     
-    // Boyer-Moore algorithm implementation
-    std::vector<size_t> boyerMooreSearch(const std::string& text, const std::string& pattern) {
-        std::vector<size_t> positions;
-        std::vector<int> badChar(256, -1);
-        
-        // Preprocess bad character rule
-        for (size_t i = 0; i < pattern.length(); ++i) {
-            badChar[static_cast<unsigned char>(pattern[i])] = i;
+    // Loop thread. false when the ring has no room for the whole batch,
+    // which is then left untouched
+    bool submit(StreamBatch* batch) {
+        size_t count = batch->tasks.size();
+        if (stopped || count > inputQueue.capacity() - inputQueue.getSize()) {
+            return false;
         }
         
-        size_t textLen = text.length();
-        size_t patternLen = pattern.length();
-        
-        for (size_t i = 0; i <= textLen - patternLen;) {
-            int j = patternLen - 1;
-            
-            while (j >= 0 && pattern[j] == text[i + j]) {
-                j--;
-            }
-            
-            if (j < 0) {
-                positions.push_back(i);
-                i += (i + patternLen < textLen) ? 
-                     patternLen - badChar[static_cast<unsigned char>(text[i + patternLen])] : 1;
-            } else {
-                i += std::max(1, j - badChar[static_cast<unsigned char>(text[i + j])]);
-            }
+        batch->remaining.store(count, std::memory_order_relaxed);
+        if (pending.empty()) {
+            uv_ref(reinterpret_cast<uv_handle_t*>(completionSignal));
+        }
+        pending.insert(batch);
+        if (count == 0) {
+            finish(batch);
+            return true;
         }
         
-        return positions;
-    }
-    
-    // KMP algorithm implementation
-    std::vector<size_t> kmpSearch(const std::string& text, const std::string& pattern) {
-        std::vector<size_t> positions;
-        std::vector<int> lps = computeLPS(pattern);
-        
-        size_t i = 0, j = 0;
-        size_t textLen = text.length();
-        size_t patternLen = pattern.length();
-        
-        while (i < textLen) {
-            if (pattern[j] == text[i]) {
-                i++;
-                j++;
+        StreamTask* run[kBatchSize];
+        for (size_t offset = 0; offset < count;) {
+            size_t n = std::min(kBatchSize, count - offset);
+            for (size_t i = 0; i < n; ++i) {
+                run[i] = &batch->tasks[offset + i];
             }
-            
-            if (j == patternLen) {
-                positions.push_back(i - j);
-                j = lps[j - 1];
-            } else if (i < textLen && pattern[j] != text[i]) {
-                if (j != 0) {
-                    j = lps[j - 1];
-                } else {
-                    i++;
+            // The room was checked above; a cell a consumer has claimed but
+            // not yet released only delays us
+            for (size_t sent = 0; sent < n;) {
+                size_t claimed = inputQueue.enqueueBatch(run + sent, n - sent);
+                if (claimed == 0) {
+                    std::this_thread::yield();
                 }
+                sent += claimed;
             }
+            offset += n;
         }
-        
-        return positions;
+        inputReady.notify(count > 1);
+        return true;
     }
     
-    std::vector<int> computeLPS(const std::string& pattern) {
-        std::vector<int> lps(pattern.length(), 0);
-        int len = 0;
-        int i = 1;
-        
-        while (i < static_cast<int>(pattern.length())) {
-            if (pattern[i] == pattern[len]) {
-                len++;
-                lps[i] = len;
-                i++;
-            } else {
-                if (len != 0) {
-                    len = lps[len - 1];
-                } else {
-                    lps[i] = 0;
-                    i++;
-                }
+    // Loop thread. deliver: finish everything queued and settle it;
+    // otherwise drop queued work and only free the batches
+    void stop(bool deliver) {
+        if (stopped) {
+            return;
+        }
+        stopped = true;
+        abandoned.store(!deliver, std::memory_order_relaxed);
+        running.store(false, std::memory_order_release);
+        inputReady.notify(true);
+        for (auto& worker : workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
             }
         }
         
-        return lps;
+        std::vector<StreamBatch*> batches;
+        if (deliver) {
+            takeCompleted(batches);
+        } else {
+            batches.assign(pending.begin(), pending.end());
+            pending.clear();
+            completed.clear();
+        }
+        completionSignal->data = nullptr;
+        uv_close(reinterpret_cast<uv_handle_t*>(completionSignal), [](uv_handle_t* handle) {
+            delete reinterpret_cast<uv_async_t*>(handle);
+        });
+        onComplete(batches, deliver);
+    }
+    
+    // Tasks not yet picked up by a worker
+    size_t getInputQueueSize() const {
+        size_t size = inputQueue.getSize();
+        for (const auto& worker : workers) {
+            size += worker->deque.getSize();
+        }
+        return size;
     }
     
-    // High-performance string hashing
-    uint64_t hashString(const std::string& str) {
-        uint64_t hash = 0x811c9dc5;
-        for (char c : str) {
-            hash ^= static_cast<uint64_t>(c);
-            hash *= 0x01000193;
-        }
-        return hash;
+    // Finished batches the loop thread has not settled yet
+    size_t getOutputQueueSize() {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        return completed.size();
     }
-};
-
-// Advanced Memory Pool (Facebook Research)
-class MemoryPool {
-private:
-    struct Block {
-        void* data;
-        bool used;
-        Block* next;
-    };
     
-    std::vector<std::unique_ptr<uint8_t[]>> pools;
-    std::vector<Block*> freeBlocks;
-    std::mutex poolMutex;
-    size_t blockSize;
-    size_t poolSize;
+    size_t getQueueCapacity() const {
+        return inputQueue.capacity();
+    }
     
-public:
-    MemoryPool(size_t blockSize = 1024, size_t poolSize = 1000) 
-        : blockSize(blockSize), poolSize(poolSize) {
-        allocatePool();
+    size_t getWorkerCount() const {
+        return workers.size();
     }
     
-    void* allocate() {
-        std::lock_guard<std::mutex> lock(poolMutex);
-        
-        if (freeBlocks.empty()) {
-            allocatePool();
-        }
-        
-        Block* block = freeBlocks.back();
-        freeBlocks.pop_back();
-        block->used = true;
-        return block->data;
+    size_t getPendingCount() const {
+        return pending.size();
     }
     
-    void deallocate(void* ptr) {
-        std::lock_guard<std::mutex> lock(poolMutex);
-        
-        // Find the block containing this pointer
-        for (auto& pool : pools) {
-            Block* block = reinterpret_cast<Block*>(pool.get());
-            for (size_t i = 0; i < poolSize; ++i) {
-                if (block[i].data == ptr) {
-                    block[i].used = false;
-                    freeBlocks.push_back(&block[i]);
-                    return;
-                }
-            }
-        }
+    uint64_t getTasksCompleted() const {
+        return tasksCompleted.load(std::memory_order_relaxed);
+    }
+    
+    uint64_t getTasksStolen() const {
+        return tasksStolen.load(std::memory_order_relaxed);
     }
     
 private:
-    void allocatePool() {
-        size_t totalSize = poolSize * (sizeof(Block) + blockSize);
-        auto pool = std::make_unique<uint8_t[]>(totalSize);
-        
-        Block* blocks = reinterpret_cast<Block*>(pool.get());
-        uint8_t* dataStart = pool.get() + poolSize * sizeof(Block);
-        
-        for (size_t i = 0; i < poolSize; ++i) {
-            blocks[i].data = dataStart + i * blockSize;
-            blocks[i].used = false;
-            blocks[i].next = nullptr;
-            freeBlocks.push_back(&blocks[i]);
+    void workerLoop(size_t self) {
+        Worker& worker = *workers[self];
+        StreamTask* run[kBatchSize];
+        while (!abandoned.load(std::memory_order_relaxed)) {
+            StreamTask* task = nullptr;
+            if (worker.deque.pop(task) || refill(worker, run, task) || steal(self, task)) {
+                process(*task);
+                continue;
+            }
+            if (!running.load(std::memory_order_acquire)) {
+                break;  // stopping, and nothing is left to drain
+            }
+            
+            // Sleep until a producer signals, re-checking after announcing
+            // ourselves so a concurrent submit is not missed
+            uint32_t key = inputReady.prepareWait();
+            if (hasWork() || !running.load(std::memory_order_acquire)) {
+                inputReady.cancelWait();
+                continue;
+            }
+            inputReady.wait(key);
         }
-        
-        pools.push_back(std::move(pool));
     }
-};
-
-// Real-time Stream Processor (Twitter Research)
-class StreamProcessor {
-private:
-    LockFreeQueue<std::string> inputQueue;
-    LockFreeQueue<std::string> outputQueue;
-    std::atomic<bool> running;
-    std::thread processorThread;
-    StringProcessor stringProcessor;
-    MemoryPool memoryPool;
     
-public:
-    StreamProcessor() : running(true) {
-        processorThread = std::thread([this] { processLoop(); });
+    // Take a run from the shared ring: keep the first task and queue the
+    // rest locally, waking an idle worker to steal from them
+    bool refill(Worker& worker, StreamTask** run, StreamTask*& task) {
+        size_t count = inputQueue.dequeueBatch(run, kBatchSize);
+        if (count == 0) {
+            return false;
+        }
+        task = run[0];
+        // The deque is empty whenever we get here, so these always fit
+        for (size_t i = 1; i < count; ++i) {
+            worker.deque.push(run[i]);
+        }
+        if (count > 1) {
+            inputReady.notify();
+        }
+        return true;
     }
     
-    ~StreamProcessor() {
-        running = false;
-        if (processorThread.joinable()) {
-            processorThread.join();
+    bool steal(size_t self, StreamTask*& task) {
+        size_t count = workers.size();
+        for (size_t i = 1; i < count; ++i) {
+            if (workers[(self + i) % count]->deque.steal(task)) {
+                tasksStolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
         }
+        return false;
     }
     
-    void addData(const std::string& data) {
-        inputQueue.enqueue(data);
+    bool hasWork() const {
+        return getInputQueueSize() > 0;
     }
     
-    bool getResult(std::string& result) {
-        return outputQueue.dequeue(result);
+    void process(StreamTask& task) {
+        task.result = processData(task.data, task.length);
+        tasksCompleted.fetch_add(1, std::memory_order_relaxed);
+        if (task.batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            finish(task.batch);
+        }
     }
     
-private:
-    void processLoop() {
-        std::string data;
-        while (running) {
-            if (inputQueue.dequeue(data)) {
-                // Process the data with high-performance algorithms
-                std::string processed = processData(data);
-                outputQueue.enqueue(processed);
-            } else {
-                std::this_thread::sleep_for(std::chrono::microseconds(100));
-            }
+    void finish(StreamBatch* batch) {
+        bool signal;
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            // A non-empty list already has a wakeup on its way
+            signal = completed.empty();
+            completed.push_back(batch);
+        }
+        if (signal) {
+            uv_async_send(completionSignal);
         }
     }
     
-    std::string processData(const std::string& data) {
-        // High-performance data processing
-        std::string result = data;
-        
-        // Apply string optimizations
-        auto positions = stringProcessor.findPattern(data, "pattern");
-        for (auto pos : positions) {
-            // Process found patterns
+    void takeCompleted(std::vector<StreamBatch*>& batches) {
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            batches.swap(completed);
         }
+        for (StreamBatch* batch : batches) {
+            pending.erase(batch);
+        }
+        if (pending.empty() && !batches.empty()) {
+            uv_unref(reinterpret_cast<uv_handle_t*>(completionSignal));
+        }
+    }
+    
+    void deliverCompleted() {
+        std::vector<StreamBatch*> batches;
+        takeCompleted(batches);
+        // The handler runs JS, which may replace this processor: nothing
+        // below touches it
+        CompletionHandler handler = onComplete;
+        handler(batches, true);
+    }
+    
+    std::string processData(const char* data, size_t length) {
+        std::string_view text(data, length);
         
         // Hash the data for caching
-        uint64_t hash = stringProcessor.hashString(data);
+        uint64_t hash = stringProcessor.hashString(text);
         
-        return result + "_processed_" + std::to_string(hash);
+        std::string result;
+        result.reserve(length + 32);
+        result.append(data, length);
+        result += "_processed_";
+        result += std::to_string(hash);
+        return result;
     }
 };
 
@@ -355,11 +349,129 @@ static std::unique_ptr<StreamProcessor> streamProcessor;
 static std::unique_ptr<StringProcessor> stringProcessor;
 static std::unique_ptr<MemoryPool> memoryPool;
 
+// A processStream() call waiting for its results
+struct PendingStream : StreamBatch {
+    Nan::Persistent<Array> inputs;     // keeps the caller's Buffers alive
+    std::vector<std::string> copies;   // string inputs, encoded once
+    Nan::Persistent<Promise::Resolver> resolver;
+    Nan::Callback callback;
+    bool single;
+    
+    ~PendingStream() {
+        inputs.Reset();
+        resolver.Reset();
+    }
+};
+
+// Resolution runs inside a callback scope so promise reactions and
+// nextTick callbacks run as soon as a batch of results has been settled
+static Nan::Persistent<Object> streamResource;
+static node::async_context streamContext;
+
+static void SettleStreams(std::vector<StreamBatch*>& batches, bool delivered) {
+    if (!delivered) {
+        for (StreamBatch* batch : batches) {
+            delete static_cast<PendingStream*>(batch);
+        }
+        return;
+    }
+    if (batches.empty()) {
+        return;
+    }
+    
+    Isolate* isolate = Isolate::GetCurrent();
+    Nan::HandleScope scope;
+    node::CallbackScope callbackScope(isolate, Nan::New(streamResource), streamContext);
+    Local<Context> context = Nan::GetCurrentContext();
+    
+    for (StreamBatch* batch : batches) {
+        std::unique_ptr<PendingStream> stream(static_cast<PendingStream*>(batch));
+        Local<Value> result;
+        if (stream->single) {
+            result = Nan::New(stream->tasks[0].result).ToLocalChecked();
+        } else {
+            Local<Array> results = Nan::New<Array>(static_cast<int>(stream->tasks.size()));
+            for (size_t i = 0; i < stream->tasks.size(); ++i) {
+                Nan::Set(results, static_cast<uint32_t>(i), Nan::New(stream->tasks[i].result).ToLocalChecked());
+            }
+            result = results;
+        }
+        
+        if (!stream->callback.IsEmpty()) {
+            Local<Value> argv[] = { Nan::Null(), result };
+            Nan::Call(stream->callback, 2, argv);
+        } else {
+            Nan::New(stream->resolver)->Resolve(context, result).FromMaybe(false);
+        }
+    }
+}
+
+static void CleanupStreams(void*) {
+    // The environment is going away: drop queued work without calling JS
+    streamProcessor.reset();
+    if (!streamResource.IsEmpty()) {
+        node::EmitAsyncDestroy(Isolate::GetCurrent(), streamContext);
+        streamResource.Reset();
+    }
+}
+
+// A JS string as UTF-8, written straight into out
+static void EncodeUtf8(Isolate* isolate, Local<String> text, std::string& out) {
+    out.assign(text->Utf8Length(isolate), '\0');
+    text->WriteUtf8(isolate, &out[0], static_cast<int>(out.size()), nullptr,
+                    String::NO_NULL_TERMINATION | String::REPLACE_INVALID_UTF8);
+}
+
+// Reads a numeric option into value; false (with a RangeError) when it is
+// present but outside [min, max]
+static bool ReadSizeOption(Local<Object> options, const char* name, double min, double max, size_t& value) {
+    Local<Value> option = Nan::Get(options, Nan::New(name).ToLocalChecked()).ToLocalChecked();
+    if (!option->IsNumber()) {
+        return true;
+    }
+    double number = option->NumberValue(Nan::GetCurrentContext()).FromJust();
+    if (!(number >= min && number <= max)) {
+        std::string message = std::string(name) + " must be between " +
+            std::to_string(static_cast<uint64_t>(min)) + " and " + std::to_string(static_cast<uint64_t>(max));
+        Nan::ThrowRangeError(message.c_str());
+        return false;
+    }
+    value = static_cast<size_t>(number);
+    return true;
+}
+
 // NAN Methods
 NAN_METHOD(Initialize) {
-    streamProcessor = std::make_unique<StreamProcessor>();
+    // initialize({ queueCapacity, workers }) fixes the stream queue size and
+    // the number of stream workers up front
+    size_t queueCapacity = 4096;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    if (info.Length() > 0 && info[0]->IsObject()) {
+        Local<Object> options = info[0].As<Object>();
+        if (!ReadSizeOption(options, "queueCapacity", 2, 1 << 24, queueCapacity) ||
+            !ReadSizeOption(options, "workers", 1, 256, workers)) {
+            return;
+        }
+    }
+    
+    if (streamResource.IsEmpty()) {
+        Local<Object> resource = Nan::New<Object>();
+        streamResource.Reset(resource);
+        streamContext = node::EmitAsyncInit(info.GetIsolate(), resource, "SiliconValleyAddon::StreamProcessor");
+    }
+    
+    // Anything still queued on the previous processor finishes and settles;
+    // callbacks submitting from there already reach the new one
+    std::unique_ptr<StreamProcessor> previous = std::move(streamProcessor);
+    streamProcessor = std::make_unique<StreamProcessor>(workers, queueCapacity, Nan::GetCurrentEventLoop(), SettleStreams);
     stringProcessor = std::make_unique<StringProcessor>();
-    memoryPool = std::make_unique<MemoryPool>();
+    // Kept across calls: Buffers still out there point into it
+    if (!memoryPool) {
+        memoryPool = std::make_unique<MemoryPool>();
+    }
+    if (previous) {
+        previous->stop(true);
+    }
     
     info.GetReturnValue().Set(Nan::New(true));
 }
@@ -383,45 +495,92 @@ NAN_METHOD(ProcessString) {
     }
     
     // Process the string with high-performance algorithms
-    auto positions = stringProcessor->findPattern(input, "pattern");
+    auto matches = stringProcessor->findCommonPatterns(input);
     uint64_t hash = stringProcessor->hashString(input);
     
     // Create result object
     Local<Object> result = Nan::New<Object>();
     Nan::Set(result, Nan::New("hash").ToLocalChecked(), Nan::New<Number>(static_cast<double>(hash)));
-    Nan::Set(result, Nan::New("patternCount").ToLocalChecked(), Nan::New<Number>(positions.size()));
+    Nan::Set(result, Nan::New("patternCount").ToLocalChecked(), Nan::New<Number>(matches.size()));
     
     info.GetReturnValue().Set(result);
 }
 
+// processStream(input, callback?) where input is a string, a Buffer or an
+// array of them. Resolves (or calls back) with the result, or an array of
+// results in input order, once every input has been processed. Buffers
+// are read in place, so they must not be modified until then.
 NAN_METHOD(ProcessStream) {
     if (info.Length() < 1) {
         Nan::ThrowTypeError("Wrong number of arguments");
         return;
     }
     
-    if (!info[0]->IsString()) {
-        Nan::ThrowTypeError("Argument must be a string");
+    bool withCallback = info.Length() > 1 && info[1]->IsFunction();
+    if (info.Length() > 1 && !withCallback && !info[1]->IsUndefined()) {
+        Nan::ThrowTypeError("Callback must be a function");
         return;
     }
     
-    std::string input = *Nan::Utf8String(info[0]);
-    
     if (!streamProcessor) {
         Nan::ThrowError("Stream processor not initialized");
         return;
     }
     
-    // Add data to stream processor
-    streamProcessor->addData(input);
+    Isolate* isolate = info.GetIsolate();
+    Local<Value> input = info[0];
+    auto stream = std::make_unique<PendingStream>();
+    stream->single = !input->IsArray();
+    Local<Array> items = stream->single ? Local<Array>() : input.As<Array>();
+    uint32_t count = stream->single ? 1 : items->Length();
+    if (count > streamProcessor->getQueueCapacity()) {
+        Nan::ThrowRangeError("More inputs than the stream queue capacity");
+        return;
+    }
     
-    // Get result if available
-    std::string result;
-    if (streamProcessor->getResult(result)) {
-        info.GetReturnValue().Set(Nan::New(result).ToLocalChecked());
+    stream->tasks.resize(count);
+    stream->copies.reserve(count);
+    Local<Array> buffers = Nan::New<Array>();
+    uint32_t bufferCount = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        Local<Value> item = stream->single ? input : Nan::Get(items, i).ToLocalChecked();
+        StreamTask& task = stream->tasks[i];
+        task.batch = stream.get();
+        if (node::Buffer::HasInstance(item)) {
+            task.data = node::Buffer::Data(item);
+            task.length = node::Buffer::Length(item);
+            Nan::Set(buffers, bufferCount++, item);
+        } else if (item->IsString()) {
+            // Encoded straight into storage the task keeps
+            stream->copies.emplace_back();
+            EncodeUtf8(isolate, item.As<String>(), stream->copies.back());
+            task.data = stream->copies.back().data();
+            task.length = stream->copies.back().size();
+        } else {
+            Nan::ThrowTypeError("Stream input must be a string or Buffer");
+            return;
+        }
+    }
+    if (bufferCount > 0) {
+        stream->inputs.Reset(buffers);
+    }
+    
+    Local<Value> returned = Nan::Undefined();
+    if (withCallback) {
+        stream->callback.Reset(info[1].As<Function>());
     } else {
-        info.GetReturnValue().Set(Nan::New("processing").ToLocalChecked());
+        Local<Promise::Resolver> resolver = Promise::Resolver::New(Nan::GetCurrentContext()).ToLocalChecked();
+        stream->resolver.Reset(resolver);
+        returned = resolver->GetPromise();
+    }
+    
+    if (!streamProcessor->submit(stream.get())) {
+        Nan::ThrowError("Stream processor queue is full");
+        return;
     }
+    stream.release();
+    
+    info.GetReturnValue().Set(returned);
 }
 
 NAN_METHOD(AllocateMemory) {
@@ -435,17 +594,29 @@ NAN_METHOD(AllocateMemory) {
         return;
     }
     
-    size_t size = static_cast<size_t>(info[0]->NumberValue(Nan::GetCurrentContext()).FromJust());
+    double requested = info[0]->NumberValue(Nan::GetCurrentContext()).FromJust();
+    if (!(requested >= 0 && requested <= static_cast<double>(node::Buffer::kMaxLength))) {
+        Nan::ThrowRangeError("Size must be between 0 and buffer.constants.MAX_LENGTH");
+        return;
+    }
+    size_t size = static_cast<size_t>(requested);
     
     if (!memoryPool) {
         Nan::ThrowError("Memory pool not initialized");
         return;
     }
     
-    void* ptr = memoryPool->allocate();
+    void* ptr = memoryPool->allocate(size);
+    if (!ptr) {
+        Nan::ThrowError("Memory pool allocation failed");
+        return;
+    }
     
-    // Return buffer
-    Local<Object> buffer = Nan::NewBuffer(static_cast<char*>(ptr), size).ToLocalChecked();
+    // Return buffer; collecting it hands the block back to the pool. Like
+    // Buffer.allocUnsafe, the contents are whatever the block last held.
+    Local<Object> buffer = Nan::NewBuffer(static_cast<char*>(ptr), size, [](char* data, void* hint) {
+        static_cast<MemoryPool*>(hint)->deallocate(data);
+    }, memoryPool.get()).ToLocalChecked();
     info.GetReturnValue().Set(buffer);
 }
 
@@ -457,13 +628,213 @@ NAN_METHOD(GetMetrics) {
                 Nan::New<Number>(streamProcessor->getInputQueueSize()));
         Nan::Set(metrics, Nan::New("outputQueueSize").ToLocalChecked(), 
                 Nan::New<Number>(streamProcessor->getOutputQueueSize()));
+        Nan::Set(metrics, Nan::New("queueCapacity").ToLocalChecked(), 
+                Nan::New<Number>(streamProcessor->getQueueCapacity()));
+        Nan::Set(metrics, Nan::New("workers").ToLocalChecked(), 
+                Nan::New<Number>(streamProcessor->getWorkerCount()));
+        Nan::Set(metrics, Nan::New("pendingSubmissions").ToLocalChecked(), 
+                Nan::New<Number>(streamProcessor->getPendingCount()));
+        Nan::Set(metrics, Nan::New("tasksCompleted").ToLocalChecked(), 
+                Nan::New<Number>(static_cast<double>(streamProcessor->getTasksCompleted())));
+        Nan::Set(metrics, Nan::New("tasksStolen").ToLocalChecked(), 
+                Nan::New<Number>(static_cast<double>(streamProcessor->getTasksStolen())));
+    }
+    
+    if (memoryPool) {
+        // memoryPool: totals plus one entry per size class
+        Local<Object> pool = Nan::New<Object>();
+        Local<Array> classes = Nan::New<Array>(static_cast<int>(MemoryPool::kClassCount));
+        double slabs = 0, blocksInUse = 0, capacity = 0, allocations = 0, cacheHits = 0;
+        for (size_t c = 0; c < MemoryPool::kClassCount; ++c) {
+            MemoryPool::ClassStats stats = memoryPool->getClassStats(c);
+            Local<Object> entry = Nan::New<Object>();
+            Nan::Set(entry, Nan::New("blockSize").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.blockSize)));
+            Nan::Set(entry, Nan::New("slabs").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.slabs)));
+            Nan::Set(entry, Nan::New("blocksInUse").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.blocksInUse)));
+            Nan::Set(entry, Nan::New("capacity").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.capacity)));
+            Nan::Set(entry, Nan::New("allocations").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.allocations)));
+            Nan::Set(entry, Nan::New("hitRate").ToLocalChecked(),
+                     Nan::New<Number>(stats.allocations ? static_cast<double>(stats.cacheHits) / stats.allocations : 0));
+            Nan::Set(classes, static_cast<uint32_t>(c), entry);
+            
+            slabs += stats.slabs;
+            blocksInUse += stats.blocksInUse;
+            capacity += stats.capacity;
+            allocations += stats.allocations;
+            cacheHits += stats.cacheHits;
+        }
+        Nan::Set(pool, Nan::New("slabs").ToLocalChecked(), Nan::New<Number>(slabs));
+        Nan::Set(pool, Nan::New("reservedBytes").ToLocalChecked(),
+                 Nan::New<Number>(slabs * MemoryPool::kSlabSize + static_cast<double>(memoryPool->getLargeBytes())));
+        Nan::Set(pool, Nan::New("blocksInUse").ToLocalChecked(), Nan::New<Number>(blocksInUse));
+        Nan::Set(pool, Nan::New("occupancy").ToLocalChecked(), Nan::New<Number>(capacity ? blocksInUse / capacity : 0));
+        Nan::Set(pool, Nan::New("allocations").ToLocalChecked(), Nan::New<Number>(allocations));
+        Nan::Set(pool, Nan::New("hitRate").ToLocalChecked(), Nan::New<Number>(allocations ? cacheHits / allocations : 0));
+        Nan::Set(pool, Nan::New("depotRefills").ToLocalChecked(), Nan::New<Number>(static_cast<double>(memoryPool->getDepotRefills())));
+        Nan::Set(pool, Nan::New("largeBlocksInUse").ToLocalChecked(), Nan::New<Number>(static_cast<double>(memoryPool->getLargeBlocksInUse())));
+        Nan::Set(pool, Nan::New("classes").ToLocalChecked(), classes);
+        Nan::Set(metrics, Nan::New("memoryPool").ToLocalChecked(), pool);
     }
     
     info.GetReturnValue().Set(metrics);
 }
 
+// new PatternMatcher(patterns, { caseInsensitive }) compiles once; then
+//   scan(input, maxMatches?)  Uint32Array of [patternId, offset] pairs
+//   test(input)               true at the first match
+//   count(input)              number of matches
+// Pattern ids are indices into patterns. input is a Buffer, read in place,
+// or a string, scanned as UTF-8 with offsets in bytes.
+class PatternMatcherWrap : public Nan::ObjectWrap {
+public:
+    static void Init(Local<Object> target) {
+        Local<FunctionTemplate> tpl = Nan::New<FunctionTemplate>(New);
+        tpl->SetClassName(Nan::New("PatternMatcher").ToLocalChecked());
+        tpl->InstanceTemplate()->SetInternalFieldCount(1);
+        Nan::SetPrototypeMethod(tpl, "scan", Scan);
+        Nan::SetPrototypeMethod(tpl, "test", Test);
+        Nan::SetPrototypeMethod(tpl, "count", Count);
+        Nan::Set(target, Nan::New("PatternMatcher").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
+    }
+    
+private:
+    PatternMatcher matcher;
+    
+    PatternMatcherWrap(const std::vector<std::string>& patterns, bool caseInsensitive)
+        : matcher(patterns, caseInsensitive) {}
+    
+    static NAN_METHOD(New) {
+        if (!info.IsConstructCall()) {
+            Nan::ThrowTypeError("PatternMatcher must be called with new");
+            return;
+        }
+        if (info.Length() < 1 || !info[0]->IsArray()) {
+            Nan::ThrowTypeError("Patterns must be an array");
+            return;
+        }
+        
+        Local<Array> list = info[0].As<Array>();
+        std::vector<std::string> patterns;
+        patterns.reserve(list->Length());
+        for (uint32_t i = 0; i < list->Length(); ++i) {
+            Local<Value> item = Nan::Get(list, i).ToLocalChecked();
+            if (node::Buffer::HasInstance(item)) {
+                patterns.emplace_back(node::Buffer::Data(item), node::Buffer::Length(item));
+            } else if (item->IsString()) {
+                Nan::Utf8String text(item);
+                patterns.emplace_back(*text, text.length());
+            } else {
+                Nan::ThrowTypeError("Patterns must be strings or Buffers");
+                return;
+            }
+            if (patterns.back().empty()) {
+                Nan::ThrowTypeError("Patterns must not be empty");
+                return;
+            }
+        }
+        
+        bool caseInsensitive = false;
+        if (info.Length() > 1 && info[1]->IsObject()) {
+            Local<Value> option = Nan::Get(info[1].As<Object>(), Nan::New("caseInsensitive").ToLocalChecked()).ToLocalChecked();
+            caseInsensitive = Nan::To<bool>(option).FromJust();
+        }
+        
+        PatternMatcherWrap* wrap = new PatternMatcherWrap(patterns, caseInsensitive);
+        wrap->Wrap(info.This());
+        Nan::Set(info.This(), Nan::New("patternCount").ToLocalChecked(), Nan::New<Number>(wrap->matcher.getPatternCount()));
+        Nan::Set(info.This(), Nan::New("stateCount").ToLocalChecked(), Nan::New<Number>(wrap->matcher.getStateCount()));
+        info.GetReturnValue().Set(info.This());
+    }
+    
+    // false (with a JS exception) unless info[0] is a Buffer or string
+    // whose offsets fit the Uint32Array results
+    static bool ReadInput(const Nan::FunctionCallbackInfo<Value>& info, std::string& storage,
+                          const uint8_t*& data, size_t& length) {
+        if (info.Length() > 0 && node::Buffer::HasInstance(info[0])) {
+            data = reinterpret_cast<const uint8_t*>(node::Buffer::Data(info[0]));
+            length = node::Buffer::Length(info[0]);
+        } else if (info.Length() > 0 && info[0]->IsString()) {
+            EncodeUtf8(info.GetIsolate(), info[0].As<String>(), storage);
+            data = reinterpret_cast<const uint8_t*>(storage.data());
+            length = storage.size();
+        } else {
+            Nan::ThrowTypeError("Input must be a string or Buffer");
+            return false;
+        }
+        if (length > UINT32_MAX) {
+            Nan::ThrowRangeError("Input must be smaller than 4 GiB");
+            return false;
+        }
+        return true;
+    }
+    
+    // Matches of the current call; the module only runs on the main thread
+    static std::vector<PatternMatch>& Scratch() {
+        static std::vector<PatternMatch> matches;
+        matches.clear();
+        return matches;
+    }
+    
+    static NAN_METHOD(Scan) {
+        PatternMatcherWrap* self = Nan::ObjectWrap::Unwrap<PatternMatcherWrap>(info.Holder());
+        std::string storage;
+        const uint8_t* data;
+        size_t length;
+        if (!ReadInput(info, storage, data, length)) {
+            return;
+        }
+        
+        size_t maxMatches = SIZE_MAX;
+        if (info.Length() > 1 && info[1]->IsNumber()) {
+            double value = info[1]->NumberValue(Nan::GetCurrentContext()).FromJust();
+            if (!(value >= 0)) {
+                Nan::ThrowRangeError("maxMatches must not be negative");
+                return;
+            }
+            maxMatches = value < 4294967296.0 ? static_cast<size_t>(value) : SIZE_MAX;
+        }
+        
+        std::vector<PatternMatch>& matches = Scratch();
+        self->matcher.scan(data, length, matches, maxMatches);
+        
+        Local<ArrayBuffer> buffer = ArrayBuffer::New(info.GetIsolate(), matches.size() * 2 * sizeof(uint32_t));
+        if (!matches.empty()) {
+            uint32_t* out = static_cast<uint32_t*>(buffer->GetBackingStore()->Data());
+            for (size_t i = 0; i < matches.size(); ++i) {
+                out[2 * i] = matches[i].patternId;
+                out[2 * i + 1] = static_cast<uint32_t>(matches[i].offset);
+            }
+        }
+        info.GetReturnValue().Set(Uint32Array::New(buffer, 0, matches.size() * 2));
+    }
+    
+    static NAN_METHOD(Test) {
+        PatternMatcherWrap* self = Nan::ObjectWrap::Unwrap<PatternMatcherWrap>(info.Holder());
+        std::string storage;
+        const uint8_t* data;
+        size_t length;
+        if (!ReadInput(info, storage, data, length)) {
+            return;
+        }
+        info.GetReturnValue().Set(Nan::New(self->matcher.scan(data, length, Scratch(), 1) > 0));
+    }
+    
+    static NAN_METHOD(Count) {
+        PatternMatcherWrap* self = Nan::ObjectWrap::Unwrap<PatternMatcherWrap>(info.Holder());
+        std::string storage;
+        const uint8_t* data;
+        size_t length;
+        if (!ReadInput(info, storage, data, length)) {
+            return;
+        }
+        info.GetReturnValue().Set(Nan::New<Number>(self->matcher.scan(data, length, Scratch())));
+    }
+};
+
 // Module initialization
 NAN_MODULE_INIT(Init) {
+    node::AddEnvironmentCleanupHook(Isolate::GetCurrent(), CleanupStreams, nullptr);
+    
     Nan::Set(target, Nan::New("initialize").ToLocalChecked(),
              Nan::GetFunction(Nan::New<FunctionTemplate>(Initialize)).ToLocalChecked());
     
@@ -478,6 +849,8 @@ NAN_MODULE_INIT(Init) {
     
     Nan::Set(target, Nan::New("getMetrics").ToLocalChecked(),
              Nan::GetFunction(Nan::New<FunctionTemplate>(GetMetrics)).ToLocalChecked());
+    
+    PatternMatcherWrap::Init(target);
 }
 
 NODE_MODULE(silicon_valley_addon, Init)
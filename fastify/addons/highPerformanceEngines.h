@@ -0,0 +1,1167 @@
+/**
+ * Engines behind the Silicon Valley add-on: lock-free queues, the
+ * multi-pattern matcher, string processing and the slab memory pool.
+ *
+ * Nothing here depends on V8, NAN or libuv, so the same code is built into
+ * the add-on and into the standalone microbenchmark (bench/native_bench.cpp).
+ */
+
+#ifndef SILICON_VALLEY_HIGH_PERFORMANCE_ENGINES_H
+#define SILICON_VALLEY_HIGH_PERFORMANCE_ENGINES_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace SiliconValleyAddon {
+
+// Bounded Lock-Free MPMC Ring (Vyukov, "Bounded MPMC queue")
+// Every cell carries a sequence number that says whose turn it is: a
+// producer may fill cell i when its sequence is i, a consumer may take it
+// when the sequence is i + 1. Producers and consumers only contend on their
+// own position counter, each cell sits on its own cache line, and nothing
+// is allocated after construction, so there is nothing to reclaim.
+template<typename T>
+class MpmcRing {
+private:
+    static constexpr size_t kCacheLine = 64;
+    
+    struct alignas(kCacheLine) Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+    
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(kCacheLine) std::atomic<size_t> enqueuePos;
+    alignas(kCacheLine) std::atomic<size_t> dequeuePos;
+
+public:
+    // Capacity is fixed here, rounded up to a power of two
+    explicit MpmcRing(size_t capacity) : enqueuePos(0), dequeuePos(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+    
+    size_t capacity() const {
+        return mask + 1;
+    }
+    
+    // Leaves value alone and returns false when the ring is full
+    bool tryEnqueue(T& value) {
+        return enqueueBatch(&value, 1) == 1;
+    }
+    
+    bool tryDequeue(T& value) {
+        return dequeueBatch(&value, 1) == 1;
+    }
+    
+    // Claim up to count consecutive free cells with a single CAS and move
+    // values into them; returns how many were taken
+    size_t enqueueBatch(T* values, size_t count) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t run = 0;
+            while (run < count && cells[(pos + run) & mask].sequence.load(std::memory_order_acquire) == pos + run) {
+                run++;
+            }
+            if (run == 0) {
+                // Full, or another producer moved on: retry only in the latter case
+                size_t seq = cells[pos & mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(seq - pos) < 0) {
+                    return 0;
+                }
+                pos = enqueuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueuePos.compare_exchange_weak(pos, pos + run, std::memory_order_relaxed)) {
+                for (size_t i = 0; i < run; ++i) {
+                    Cell& cell = cells[(pos + i) & mask];
+                    cell.data = std::move(values[i]);
+                    cell.sequence.store(pos + i + 1, std::memory_order_release);
+                }
+                return run;
+            }
+        }
+    }
+    
+    // Take up to max values that are ready, in order, with a single CAS
+    size_t dequeueBatch(T* out, size_t max) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t run = 0;
+            while (run < max && cells[(pos + run) & mask].sequence.load(std::memory_order_acquire) == pos + run + 1) {
+                run++;
+            }
+            if (run == 0) {
+                size_t seq = cells[pos & mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(seq - (pos + 1)) < 0) {
+                    return 0;
+                }
+                pos = dequeuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeuePos.compare_exchange_weak(pos, pos + run, std::memory_order_relaxed)) {
+                for (size_t i = 0; i < run; ++i) {
+                    Cell& cell = cells[(pos + i) & mask];
+                    out[i] = std::move(cell.data);
+                    cell.sequence.store(pos + i + mask + 1, std::memory_order_release);
+                }
+                return run;
+            }
+        }
+    }
+    
+    // Approximate while other threads are active
+    size_t getSize() const {
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+};
+
+// Blocking Wakeup (event count over a futex)
+// Sleepers read the epoch, re-check their condition and sleep only if the
+// epoch has not moved; notifiers bump it and make the wake syscall only
+// when someone is asleep. Idle threads cost nothing and wake in
+// microseconds, and the fast path on both sides is a couple of atomics.
+class WakeSignal {
+private:
+    std::atomic<uint32_t> epoch;
+    std::atomic<uint32_t> sleepers;
+#ifndef __linux__
+    std::mutex mutex;
+    std::condition_variable condition;
+#endif
+
+public:
+    WakeSignal() : epoch(0), sleepers(0) {}
+    
+    // Call, then re-check the condition, then wait(key) or cancelWait()
+    uint32_t prepareWait() {
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch.load(std::memory_order_seq_cst);
+    }
+    
+    void cancelWait() {
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+    
+    void wait(uint32_t key) {
+#ifdef __linux__
+        while (epoch.load(std::memory_order_acquire) == key) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+        }
+#else
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&] { return epoch.load(std::memory_order_acquire) != key; });
+#endif
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+    
+    // After publishing whatever the sleepers are waiting for
+    void notify(bool all = false) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) == 0) {
+            return;
+        }
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAKE_PRIVATE, all ? INT32_MAX : 1, nullptr, nullptr, 0);
+#else
+        std::lock_guard<std::mutex> lock(mutex);
+        if (all) {
+            condition.notify_all();
+        } else {
+            condition.notify_one();
+        }
+#endif
+    }
+};
+
+// Work-Stealing Deque (Chase & Lev, "Dynamic Circular Work-Stealing Deque")
+// The owning worker pushes and pops at the bottom with plain stores; other
+// workers steal from the top with one CAS, so the owner only contends when
+// a thief races it for the last item. The capacity is fixed because owners
+// only push what they took from the shared ring.
+template<typename T>
+class WorkStealingDeque {
+private:
+    std::unique_ptr<std::atomic<T>[]> items;
+    int64_t mask;
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    
+public:
+    explicit WorkStealingDeque(size_t capacity) : top(0), bottom(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        items = std::make_unique<std::atomic<T>[]>(size);
+        mask = static_cast<int64_t>(size - 1);
+    }
+    
+    // Owner only; false when full
+    bool push(T item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t > mask) {
+            return false;
+        }
+        items[b & mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+    
+    // Owner only; newest first
+    bool pop(T& item) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = items[b & mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last item: whoever moves top first gets it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+    
+    // Any thread; oldest first. false when empty or when another thief won
+    bool steal(T& item) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        T value = items[t & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+        item = value;
+        return true;
+    }
+    
+    size_t getSize() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+};
+
+// Multi-Pattern Matching (Aho & Corasick, "Efficient String Matching")
+struct PatternMatch {
+    uint32_t patternId;
+    size_t offset;  // of the first byte of the match
+};
+
+// Bytes that can start a match, and bytes that can follow them when every
+// pattern is at least two long. Each set is a shufti pair of 16-entry
+// tables: byte b may be in the set when lo[b & 15] & hi[b >> 4] is nonzero.
+// Nibbles share 8 bucket bits, so the SIMD test can report false positives
+// (the DFA rejects them) but never misses.
+struct PatternPrefilter {
+    bool enabled;
+    bool pair;
+    bool first[256];
+    bool second[256];
+    alignas(16) uint8_t firstLo[16];
+    alignas(16) uint8_t firstHi[16];
+    alignas(16) uint8_t secondLo[16];
+    alignas(16) uint8_t secondHi[16];
+    
+    // Next position at or after i where a match could start, or length
+    size_t scalarSkip(const uint8_t* data, size_t i, size_t length) const {
+        for (; i < length; ++i) {
+            if (first[data[i]] && (!pair || (i + 1 < length && second[data[i + 1]]))) {
+                return i;
+            }
+        }
+        return length;
+    }
+};
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SILICON_VALLEY_SIMD_PREFILTER 1
+
+__attribute__((target("avx2")))
+static size_t skipAvx2(const PatternPrefilter& filter, const uint8_t* data, size_t i, size_t length) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i firstLo = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(filter.firstLo)));
+    const __m256i firstHi = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(filter.firstHi)));
+    const __m256i secondLo = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(filter.secondLo)));
+    const __m256i secondHi = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(filter.secondHi)));
+    // The pair test reads one byte past the block
+    size_t reach = filter.pair ? 33 : 32;
+    
+    for (; i + reach <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hit = _mm256_and_si256(
+            _mm256_shuffle_epi8(firstLo, _mm256_and_si256(block, nibble)),
+            _mm256_shuffle_epi8(firstHi, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble)));
+        uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hit, zero)));
+        if (mask != 0 && filter.pair) {
+            __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+            __m256i follow = _mm256_and_si256(
+                _mm256_shuffle_epi8(secondLo, _mm256_and_si256(next, nibble)),
+                _mm256_shuffle_epi8(secondHi, _mm256_and_si256(_mm256_srli_epi16(next, 4), nibble)));
+            mask &= ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(follow, zero)));
+        }
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return filter.scalarSkip(data, i, length);
+}
+
+__attribute__((target("ssse3")))
+static size_t skipSsse3(const PatternPrefilter& filter, const uint8_t* data, size_t i, size_t length) {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i firstLo = _mm_load_si128(reinterpret_cast<const __m128i*>(filter.firstLo));
+    const __m128i firstHi = _mm_load_si128(reinterpret_cast<const __m128i*>(filter.firstHi));
+    const __m128i secondLo = _mm_load_si128(reinterpret_cast<const __m128i*>(filter.secondLo));
+    const __m128i secondHi = _mm_load_si128(reinterpret_cast<const __m128i*>(filter.secondHi));
+    size_t reach = filter.pair ? 17 : 16;
+    
+    for (; i + reach <= length; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hit = _mm_and_si128(
+            _mm_shuffle_epi8(firstLo, _mm_and_si128(block, nibble)),
+            _mm_shuffle_epi8(firstHi, _mm_and_si128(_mm_srli_epi16(block, 4), nibble)));
+        uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(hit, zero))) & 0xFFFF;
+        if (mask != 0 && filter.pair) {
+            __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+            __m128i follow = _mm_and_si128(
+                _mm_shuffle_epi8(secondLo, _mm_and_si128(next, nibble)),
+                _mm_shuffle_epi8(secondHi, _mm_and_si128(_mm_srli_epi16(next, 4), nibble)));
+            mask &= ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(follow, zero)));
+        }
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return filter.scalarSkip(data, i, length);
+}
+#endif
+
+// Aho-Corasick automaton compiled to a full DFA. Bytes are first mapped to
+// equivalence classes (bytes no pattern uses share class 0, and with
+// caseInsensitive both cases of a letter share one), which keeps each row
+// short. Rows are padded to a power of two and transitions store the target
+// row's offset, so a step is one load and one add. States that report
+// matches are numbered last, so "did this byte end a match?" is a single
+// compare. Tables are 16-bit when they fit.
+//
+// Scanning from the root state, the prefilter jumps straight to the next
+// byte that can start a match (32 bytes at a time with AVX2, 16 with
+// SSSE3), so text without candidates costs the same however many patterns
+// there are, and everything else costs one table step per byte.
+class PatternMatcher {
+private:
+    std::vector<uint32_t> patternLengths;
+    uint16_t byteClass[256];
+    uint32_t strideShift;
+    std::vector<uint16_t> table16;
+    std::vector<uint32_t> table32;
+    uint32_t matchThreshold;             // first offset of a reporting state
+    std::vector<uint32_t> outputStart;   // per reporting state, into outputs
+    std::vector<uint32_t> outputs;       // pattern ids
+    size_t stateCount;
+    PatternPrefilter prefilter;
+    
+public:
+    // Empty patterns are ignored; ids are indices into patterns
+    PatternMatcher(const std::vector<std::string>& patterns, bool caseInsensitive) {
+        auto fold = [caseInsensitive](uint8_t byte) -> uint8_t {
+            return caseInsensitive && byte >= 'A' && byte <= 'Z' ? byte + ('a' - 'A') : byte;
+        };
+        
+        // Byte classes; all 256 bytes in use makes 257, hence 16 bits
+        std::memset(byteClass, 0, sizeof(byteClass));
+        uint32_t classCount = 1;
+        for (const auto& pattern : patterns) {
+            for (unsigned char c : pattern) {
+                uint8_t folded = fold(c);
+                if (byteClass[folded] == 0) {
+                    byteClass[folded] = static_cast<uint16_t>(classCount++);
+                }
+            }
+        }
+        if (caseInsensitive) {
+            for (int c = 'A'; c <= 'Z'; ++c) {
+                byteClass[c] = byteClass[c + ('a' - 'A')];
+            }
+        }
+        strideShift = 0;
+        while ((1u << strideShift) < classCount) {
+            strideShift++;
+        }
+        uint32_t stride = 1u << strideShift;
+        
+        // Trie, -1 for missing edges
+        std::vector<int32_t> trie(stride, -1);
+        std::vector<std::vector<uint32_t>> stateOutputs(1);
+        patternLengths.resize(patterns.size());
+        for (size_t id = 0; id < patterns.size(); ++id) {
+            patternLengths[id] = static_cast<uint32_t>(patterns[id].size());
+            if (patterns[id].empty()) {
+                continue;
+            }
+            size_t state = 0;
+            for (unsigned char c : patterns[id]) {
+                size_t edge = (state << strideShift) + byteClass[fold(c)];
+                if (trie[edge] < 0) {
+                    trie[edge] = static_cast<int32_t>(stateOutputs.size());
+                    stateOutputs.emplace_back();
+                    trie.resize(trie.size() + stride, -1);
+                }
+                state = static_cast<size_t>(trie[edge]);
+            }
+            stateOutputs[state].push_back(static_cast<uint32_t>(id));
+        }
+        stateCount = stateOutputs.size();
+        
+        // Breadth-first: fill missing edges from the failure state, which
+        // is shallower and therefore already complete
+        std::vector<uint32_t> fail(stateCount, 0);
+        std::vector<uint32_t> order;
+        order.reserve(stateCount);
+        for (uint32_t c = 0; c < stride; ++c) {
+            if (trie[c] < 0) {
+                trie[c] = 0;
+            } else {
+                order.push_back(static_cast<uint32_t>(trie[c]));
+            }
+        }
+        for (size_t head = 0; head < order.size(); ++head) {
+            uint32_t state = order[head];
+            const auto& inherited = stateOutputs[fail[state]];
+            stateOutputs[state].insert(stateOutputs[state].end(), inherited.begin(), inherited.end());
+            for (uint32_t c = 0; c < stride; ++c) {
+                size_t edge = (static_cast<size_t>(state) << strideShift) + c;
+                int32_t fallback = trie[(static_cast<size_t>(fail[state]) << strideShift) + c];
+                if (trie[edge] < 0) {
+                    trie[edge] = fallback;
+                } else {
+                    fail[trie[edge]] = static_cast<uint32_t>(fallback);
+                    order.push_back(static_cast<uint32_t>(trie[edge]));
+                }
+            }
+        }
+        
+        // Renumber so reporting states come last; the root has no outputs
+        // and stays 0
+        std::vector<uint32_t> renumber(stateCount);
+        uint32_t next = 0;
+        for (size_t s = 0; s < stateCount; ++s) {
+            if (stateOutputs[s].empty()) {
+                renumber[s] = next++;
+            }
+        }
+        uint32_t firstReporting = next;
+        for (size_t s = 0; s < stateCount; ++s) {
+            if (!stateOutputs[s].empty()) {
+                renumber[s] = next++;
+                outputStart.push_back(static_cast<uint32_t>(outputs.size()));
+                outputs.insert(outputs.end(), stateOutputs[s].begin(), stateOutputs[s].end());
+            }
+        }
+        outputStart.push_back(static_cast<uint32_t>(outputs.size()));
+        matchThreshold = firstReporting << strideShift;
+        
+        std::vector<uint32_t> table(stateCount << strideShift);
+        for (size_t s = 0; s < stateCount; ++s) {
+            for (uint32_t c = 0; c < stride; ++c) {
+                table[(static_cast<size_t>(renumber[s]) << strideShift) + c] =
+                    renumber[trie[(s << strideShift) + c]] << strideShift;
+            }
+        }
+        if (table.size() <= UINT16_MAX) {
+            table16.assign(table.begin(), table.end());
+        } else {
+            table32 = std::move(table);
+        }
+        
+        buildPrefilter(patterns, caseInsensitive);
+    }
+    
+    // Every occurrence, overlapping ones included, in order of where they
+    // end; stops once matches holds maxMatches. Returns the number added.
+    size_t scan(const uint8_t* data, size_t length, std::vector<PatternMatch>& matches,
+                size_t maxMatches = SIZE_MAX) const {
+        size_t before = matches.size();
+        if (maxMatches > before) {
+            if (table16.empty()) {
+                scanTable(table32.data(), data, length, matches, maxMatches);
+            } else {
+                scanTable(table16.data(), data, length, matches, maxMatches);
+            }
+        }
+        return matches.size() - before;
+    }
+    
+    size_t getPatternCount() const {
+        return patternLengths.size();
+    }
+    
+    size_t getStateCount() const {
+        return stateCount;
+    }
+    
+private:
+    template<typename Cell>
+    void scanTable(const Cell* table, const uint8_t* data, size_t length,
+                   std::vector<PatternMatch>& matches, size_t maxMatches) const {
+        uint32_t state = 0;
+        for (size_t i = 0; i < length; ++i) {
+            if (state == 0 && prefilter.enabled) {
+                // Nothing is partially matched, so jump to the next byte
+                // that can start a match
+                i = skip(data, i, length);
+                if (i == length) {
+                    break;
+                }
+            }
+            state = table[state + byteClass[data[i]]];
+            if (state >= matchThreshold) {
+                uint32_t reporting = (state - matchThreshold) >> strideShift;
+                for (uint32_t k = outputStart[reporting]; k < outputStart[reporting + 1]; ++k) {
+                    uint32_t id = outputs[k];
+                    matches.push_back(PatternMatch{id, i + 1 - patternLengths[id]});
+                    if (matches.size() >= maxMatches) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+    
+    size_t skip(const uint8_t* data, size_t i, size_t length) const {
+#ifdef SILICON_VALLEY_SIMD_PREFILTER
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        static const bool ssse3 = __builtin_cpu_supports("ssse3");
+        if (avx2) {
+            return skipAvx2(prefilter, data, i, length);
+        }
+        if (ssse3) {
+            return skipSsse3(prefilter, data, i, length);
+        }
+#endif
+        return prefilter.scalarSkip(data, i, length);
+    }
+    
+    // One bucket per high nibble the set uses, which is exact up to eight
+    // of them; past that, nibbles share buckets and the test over-reports
+    static void buildShufti(const bool* set, uint8_t* lo, uint8_t* hi) {
+        int bucket = 0;
+        for (int h = 0; h < 16; ++h) {
+            uint8_t bit = 0;
+            for (int l = 0; l < 16; ++l) {
+                if (set[(h << 4) | l]) {
+                    bit = static_cast<uint8_t>(1 << (bucket % 8));
+                    lo[l] |= bit;
+                }
+            }
+            if (bit != 0) {
+                hi[h] = static_cast<uint8_t>(hi[h] | bit);
+                bucket++;
+            }
+        }
+    }
+    
+    void buildPrefilter(const std::vector<std::string>& patterns, bool caseInsensitive) {
+        std::memset(&prefilter, 0, sizeof(prefilter));
+        prefilter.pair = true;
+        size_t firstCount = 0;
+        bool any = false;
+        for (const auto& pattern : patterns) {
+            if (pattern.empty()) {
+                continue;
+            }
+            any = true;
+            if (pattern.size() < 2) {
+                prefilter.pair = false;
+            }
+            for (size_t k = 0; k < 2 && k < pattern.size(); ++k) {
+                bool* set = k == 0 ? prefilter.first : prefilter.second;
+                uint8_t byte = static_cast<uint8_t>(pattern[k]);
+                set[byte] = true;
+                if (caseInsensitive && (byte | 0x20) >= 'a' && (byte | 0x20) <= 'z') {
+                    set[byte ^ 0x20] = true;
+                }
+            }
+        }
+        for (int b = 0; b < 256; ++b) {
+            firstCount += prefilter.first[b];
+        }
+        buildShufti(prefilter.first, prefilter.firstLo, prefilter.firstHi);
+        buildShufti(prefilter.second, prefilter.secondLo, prefilter.secondHi);
+        // With most bytes able to start a match, skipping is pure overhead
+        prefilter.enabled = any && firstCount <= 64;
+    }
+};
+
+// High-Performance String Processing (Google Research)
+class StringProcessor {
+private:
+    std::vector<std::string> commonPatterns;
+    PatternMatcher commonMatcher;
+    
+public:
+    StringProcessor()
+        : commonPatterns{
+              "GET", "POST", "PUT", "DELETE", "PATCH",
+              "application/json", "text/html", "text/plain",
+              "Authorization", "Content-Type", "User-Agent"
+          },
+          commonMatcher(commonPatterns, false) {}
+    
+    // Every common HTTP token in one pass; ids index commonPatterns
+    std::vector<PatternMatch> findCommonPatterns(std::string_view text) const {
+        std::vector<PatternMatch> matches;
+        commonMatcher.scan(reinterpret_cast<const uint8_t*>(text.data()), text.size(), matches);
+        return matches;
+    }
+    
+    const std::vector<std::string>& getCommonPatterns() const {
+        return commonPatterns;
+    }
+    
+    // Advanced string matching with pattern optimization
+    std::vector<size_t> findPattern(std::string_view text, const std::string& pattern) {
+        std::vector<size_t> positions;
+        
+        // Use Boyer-Moore algorithm for large patterns
+        if (pattern.length() > 10) {
+            return boyerMooreSearch(text, pattern);
+        }
+        
+        // Use KMP for smaller patterns
+        return kmpSearch(text, pattern);
+    }
+    
+    // Boyer-Moore algorithm implementation
+    std::vector<size_t> boyerMooreSearch(std::string_view text, const std::string& pattern) {
+        std::vector<size_t> positions;
+        std::vector<int> badChar(256, -1);
+        
+        // Preprocess bad character rule
+        for (size_t i = 0; i < pattern.length(); ++i) {
+            badChar[static_cast<unsigned char>(pattern[i])] = i;
+        }
+        
+        size_t textLen = text.length();
+        size_t patternLen = pattern.length();
+        
+        for (size_t i = 0; i <= textLen - patternLen;) {
+            int j = patternLen - 1;
+            
+            while (j >= 0 && pattern[j] == text[i + j]) {
+                j--;
+            }
+            
+            if (j < 0) {
+                positions.push_back(i);
+                i += (i + patternLen < textLen) ? 
+                     patternLen - badChar[static_cast<unsigned char>(text[i + patternLen])] : 1;
+            } else {
+                i += std::max(1, j - badChar[static_cast<unsigned char>(text[i + j])]);
+            }
+        }
+        
+        return positions;
+    }
+    
+    // KMP algorithm implementation
+    std::vector<size_t> kmpSearch(std::string_view text, const std::string& pattern) {
+        std::vector<size_t> positions;
+        std::vector<int> lps = computeLPS(pattern);
+        
+        size_t i = 0, j = 0;
+        size_t textLen = text.length();
+        size_t patternLen = pattern.length();
+        
+        while (i < textLen) {
+            if (pattern[j] == text[i]) {
+                i++;
+                j++;
+            }
+            
+            if (j == patternLen) {
+                positions.push_back(i - j);
+                j = lps[j - 1];
+            } else if (i < textLen && pattern[j] != text[i]) {
+                if (j != 0) {
+                    j = lps[j - 1];
+                } else {
+                    i++;
+                }
+            }
+        }
+        
+        return positions;
+    }
+    
+    std::vector<int> computeLPS(const std::string& pattern) {
+        std::vector<int> lps(pattern.length(), 0);
+        int len = 0;
+        int i = 1;
+        
+        while (i < static_cast<int>(pattern.length())) {
+            if (pattern[i] == pattern[len]) {
+                len++;
+                lps[i] = len;
+                i++;
+            } else {
+                if (len != 0) {
+                    len = lps[len - 1];
+                } else {
+                    lps[i] = 0;
+                    i++;
+                }
+            }
+        }
+        
+        return lps;
+    }
+    
+    // High-performance string hashing
+    uint64_t hashString(std::string_view str) {
+        uint64_t hash = 0x811c9dc5;
+        for (char c : str) {
+            hash ^= static_cast<uint64_t>(c);
+            hash *= 0x01000193;
+        }
+        return hash;
+    }
+};
+
+// Advanced Memory Pool (Facebook Research)
+// Slab allocator with power-of-two size classes from 64 bytes to 64 KiB.
+// Every slab is a kSlabSize-aligned region whose header names its class,
+// so free() finds the class by masking the address. Each thread keeps a
+// small cache per class and trades blocks with the shared depot a
+// magazine at a time (up to 32 blocks, fewer for big blocks), so the
+// depot lock is taken once per magazine, not once per block. Larger
+// requests are plain malloc() blocks behind a small header; they are
+// aligned for any type but never to 64 bytes, unlike every slab block,
+// which is how free() tells the two apart.
+//
+// Blocks are recycled without being cleared, like Buffer.allocUnsafe.
+// A thread's cache belongs to the last pool it used, so there should be
+// one pool per process, and it must outlive every thread that allocated
+// from it: the destructor can only drain the calling thread's cache, and
+// other threads' caches still point at the pool until they exit.
+class MemoryPool {
+public:
+    static constexpr size_t kMinBlockShift = 6;    // 64 bytes
+    static constexpr size_t kMaxBlockShift = 16;   // 64 KiB
+    static constexpr size_t kClassCount = kMaxBlockShift - kMinBlockShift + 1;
+    static constexpr size_t kSlabSize = size_t(1) << 20;
+    static constexpr size_t kSlabHeader = 64;
+    static constexpr size_t kMagazineSize = 32;
+    static constexpr size_t kMagazineBytes = size_t(64) << 10;
+    
+    struct ClassStats {
+        size_t blockSize;
+        uint64_t slabs;
+        uint64_t blocksInUse;
+        uint64_t capacity;
+        uint64_t allocations;
+        uint64_t cacheHits;
+    };
+    
+private:
+    static constexpr uint32_t kSlabMagic = 0x534C4142;  // "SLAB"
+    static constexpr uint32_t kLargeMagic = 0x4C415247; // "LARG"
+#ifndef NDEBUG
+    static constexpr uint64_t kFreedCanary = 0xF4EEB10CF4EEB10Cull;  // first word of a free block
+#endif
+    
+    struct SlabHeader {
+        uint32_t magic;
+        uint32_t sizeClass;
+        size_t bytes;
+    };
+    
+    // Sits right in front of a large block
+    struct LargeHeader {
+        uint32_t magic;
+        size_t bytes;
+        void* base;     // what malloc() returned
+    };
+    
+    static constexpr size_t kLargeAlign = alignof(std::max_align_t);
+    static constexpr size_t kLargeHeader = (sizeof(LargeHeader) + kLargeAlign - 1) & ~(kLargeAlign - 1);
+    static_assert(kLargeAlign < (size_t(1) << kMinBlockShift), "large blocks must be told apart by alignment");
+    
+    struct alignas(64) Depot {
+        std::mutex mutex;
+        std::vector<void*> blocks;
+        std::vector<void*> slabs;
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> frees{0};
+        std::atomic<uint64_t> cacheHits{0};
+    };
+    
+    // Per thread and class: up to two magazines of free blocks, and
+    // counters published to the depot whenever the cache trades with it
+    struct Bin {
+        void* blocks[2 * kMagazineSize];
+        uint32_t count;
+        uint64_t allocations;
+        uint64_t frees;
+        uint64_t cacheHits;
+    };
+    
+    struct ThreadCache {
+        MemoryPool* pool = nullptr;
+        Bin bins[kClassCount] = {};
+        
+        ~ThreadCache() {
+            if (pool) {
+                pool->release(*this);
+            }
+        }
+    };
+    
+    Depot depots[kClassCount];
+    std::atomic<uint64_t> depotRefills;
+    std::atomic<uint64_t> largeBlocksInUse;
+    std::atomic<uint64_t> largeBytes;
+    
+public:
+    MemoryPool() : depotRefills(0), largeBlocksInUse(0), largeBytes(0) {}
+    
+    // Only the calling thread's cache can be drained here; see the class
+    // comment. Large blocks still allocated stay valid until freed.
+    ~MemoryPool() {
+        // This thread's cache would otherwise hand blocks back later
+        ThreadCache& cache = localCache();
+        if (cache.pool == this) {
+            for (auto& bin : cache.bins) {
+                bin.count = 0;
+            }
+            cache.pool = nullptr;
+        }
+        for (auto& depot : depots) {
+            for (void* slab : depot.slabs) {
+                freeSlab(slab);
+            }
+        }
+    }
+    
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+    
+    // nullptr only when the system is out of memory
+    void* allocate(size_t size) {
+        if (size > (size_t(1) << kMaxBlockShift)) {
+            return allocateLarge(size);
+        }
+        size_t sizeClass = classFor(size);
+        Bin& bin = threadCache().bins[sizeClass];
+        bin.allocations++;
+        if (bin.count > 0) {
+            bin.cacheHits++;
+        } else if (!refill(sizeClass, bin)) {
+            bin.allocations--;
+            return nullptr;
+        }
+        void* block = bin.blocks[--bin.count];
+#ifndef NDEBUG
+        *static_cast<uint64_t*>(block) = 0;
+#endif
+        return block;
+    }
+    
+    // Any pointer allocate() returned, from any thread. Anything else aborts
+    // instead of being threaded onto a free list, as does a block freed
+    // twice in debug builds.
+    void deallocate(void* ptr) {
+        if (reinterpret_cast<uintptr_t>(ptr) & ((size_t(1) << kMinBlockShift) - 1)) {
+            LargeHeader* large = reinterpret_cast<LargeHeader*>(static_cast<uint8_t*>(ptr) - kLargeHeader);
+            if (large->magic != kLargeMagic) {
+                corrupted("pointer is not a pool block", ptr);
+            }
+            largeBlocksInUse.fetch_sub(1, std::memory_order_relaxed);
+            largeBytes.fetch_sub(large->bytes, std::memory_order_relaxed);
+            large->magic = 0;
+            std::free(large->base);
+            return;
+        }
+        SlabHeader* slab = slabOf(ptr);
+        if (slab->magic != kSlabMagic) {
+            corrupted("pointer is not in a pool slab", ptr);
+        }
+        if (slab->sizeClass >= kClassCount || !isBlockStart(slab->sizeClass, slab, ptr)) {
+            corrupted("pointer is not the start of a pool block", ptr);
+        }
+#ifndef NDEBUG
+        if (*static_cast<uint64_t*>(ptr) == kFreedCanary) {
+            corrupted("block freed twice", ptr);
+        }
+        *static_cast<uint64_t*>(ptr) = kFreedCanary;
+#endif
+        Bin& bin = threadCache().bins[slab->sizeClass];
+        bin.frees++;
+        if (bin.count == 2 * magazineFor(slab->sizeClass)) {
+            flush(slab->sizeClass, bin);
+        }
+        bin.blocks[bin.count++] = ptr;
+    }
+    
+    // Counters from other threads' caches lag by at most a magazine
+    ClassStats getClassStats(size_t sizeClass) {
+        publish(threadCache().bins[sizeClass], depots[sizeClass]);
+        Depot& depot = depots[sizeClass];
+        ClassStats stats;
+        stats.blockSize = size_t(1) << (sizeClass + kMinBlockShift);
+        {
+            std::lock_guard<std::mutex> lock(depot.mutex);
+            stats.slabs = depot.slabs.size();
+        }
+        stats.capacity = stats.slabs * blocksPerSlab(sizeClass);
+        stats.allocations = depot.allocations.load(std::memory_order_relaxed);
+        uint64_t frees = depot.frees.load(std::memory_order_relaxed);
+        stats.blocksInUse = stats.allocations > frees ? stats.allocations - frees : 0;
+        stats.cacheHits = depot.cacheHits.load(std::memory_order_relaxed);
+        return stats;
+    }
+    
+    uint64_t getDepotRefills() const {
+        return depotRefills.load(std::memory_order_relaxed);
+    }
+    
+    uint64_t getLargeBlocksInUse() const {
+        return largeBlocksInUse.load(std::memory_order_relaxed);
+    }
+    
+    uint64_t getLargeBytes() const {
+        return largeBytes.load(std::memory_order_relaxed);
+    }
+    
+private:
+    static size_t classFor(size_t size) {
+        if (size <= (size_t(1) << kMinBlockShift)) {
+            return 0;
+        }
+#if defined(__GNUC__)
+        return 64 - __builtin_clzll(static_cast<unsigned long long>(size - 1)) - kMinBlockShift;
+#else
+        size_t sizeClass = 0;
+        while ((size_t(1) << (sizeClass + kMinBlockShift)) < size) {
+            sizeClass++;
+        }
+        return sizeClass;
+#endif
+    }
+    
+    static size_t blocksPerSlab(size_t sizeClass) {
+        size_t blockSize = size_t(1) << (sizeClass + kMinBlockShift);
+        return (kSlabSize - std::max(kSlabHeader, blockSize)) / blockSize;
+    }
+    
+    static size_t magazineFor(size_t sizeClass) {
+        size_t blocks = kMagazineBytes >> (sizeClass + kMinBlockShift);
+        return std::min(kMagazineSize, std::max<size_t>(4, blocks));
+    }
+    
+    static bool isBlockStart(size_t sizeClass, SlabHeader* slab, void* ptr) {
+        size_t blockSize = size_t(1) << (sizeClass + kMinBlockShift);
+        size_t first = std::max(kSlabHeader, blockSize);
+        size_t offset = static_cast<size_t>(static_cast<uint8_t*>(ptr) - reinterpret_cast<uint8_t*>(slab));
+        return offset >= first && ((offset - first) & (blockSize - 1)) == 0 &&
+               (offset - first) / blockSize < blocksPerSlab(sizeClass);
+    }
+    
+    [[noreturn]] static void corrupted(const char* reason, void* ptr) {
+        std::fprintf(stderr, "MemoryPool::deallocate(%p): %s\n", ptr, reason);
+        std::abort();
+    }
+    
+    static SlabHeader* slabOf(void* ptr) {
+        return reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(ptr) & ~(kSlabSize - 1));
+    }
+    
+    static void* allocateSlab(size_t bytes) {
+#ifdef _WIN32
+        return _aligned_malloc(bytes, kSlabSize);
+#else
+        void* slab = nullptr;
+        return posix_memalign(&slab, kSlabSize, bytes) == 0 ? slab : nullptr;
+#endif
+    }
+    
+    static void freeSlab(void* slab) {
+#ifdef _WIN32
+        _aligned_free(slab);
+#else
+        free(slab);
+#endif
+    }
+    
+    void* allocateLarge(size_t size) {
+        if (size > SIZE_MAX - kLargeHeader - kLargeAlign) {
+            return nullptr;
+        }
+        size_t bytes = kLargeHeader + kLargeAlign + size;
+        uint8_t* base = static_cast<uint8_t*>(std::malloc(bytes));
+        if (!base) {
+            return nullptr;
+        }
+        // Step off a 64-byte boundary so deallocate() never mistakes the
+        // block for a slab block
+        uint8_t* block = base + kLargeHeader;
+        if ((reinterpret_cast<uintptr_t>(block) & ((size_t(1) << kMinBlockShift) - 1)) == 0) {
+            block += kLargeAlign;
+        }
+        LargeHeader* large = reinterpret_cast<LargeHeader*>(block - kLargeHeader);
+        large->magic = kLargeMagic;
+        large->bytes = bytes;
+        large->base = base;
+        largeBlocksInUse.fetch_add(1, std::memory_order_relaxed);
+        largeBytes.fetch_add(bytes, std::memory_order_relaxed);
+        return block;
+    }
+    
+    static ThreadCache& localCache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+    
+    ThreadCache& threadCache() {
+        // A plain pointer keeps the hot path clear of the TLS init guard
+        thread_local ThreadCache* current = nullptr;
+        if (current && current->pool == this) {
+            return *current;
+        }
+        ThreadCache& cache = localCache();
+        current = &cache;
+        if (cache.pool != this) {
+            if (cache.pool) {
+                cache.pool->release(cache);
+            }
+            cache.pool = this;
+        }
+        return cache;
+    }
+    
+    static void publish(Bin& bin, Depot& depot) {
+        depot.allocations.fetch_add(bin.allocations, std::memory_order_relaxed);
+        depot.frees.fetch_add(bin.frees, std::memory_order_relaxed);
+        depot.cacheHits.fetch_add(bin.cacheHits, std::memory_order_relaxed);
+        bin.allocations = bin.frees = bin.cacheHits = 0;
+    }
+    
+    // Fill an empty bin with one magazine, carving a new slab if the
+    // depot has run dry
+    bool refill(size_t sizeClass, Bin& bin) {
+        Depot& depot = depots[sizeClass];
+        publish(bin, depot);
+        std::lock_guard<std::mutex> lock(depot.mutex);
+        if (depot.blocks.empty()) {
+            uint8_t* slab = static_cast<uint8_t*>(allocateSlab(kSlabSize));
+            if (!slab) {
+                return false;
+            }
+            SlabHeader* header = reinterpret_cast<SlabHeader*>(slab);
+            header->magic = kSlabMagic;
+            header->sizeClass = static_cast<uint32_t>(sizeClass);
+            header->bytes = kSlabSize;
+            depot.slabs.push_back(slab);
+            
+            size_t blockSize = size_t(1) << (sizeClass + kMinBlockShift);
+            size_t count = blocksPerSlab(sizeClass);
+            uint8_t* first = slab + std::max(kSlabHeader, blockSize);
+            // Reversed so blocks are handed out in address order
+            for (size_t i = count; i-- > 0;) {
+                depot.blocks.push_back(first + i * blockSize);
+            }
+        } else {
+            depotRefills.fetch_add(1, std::memory_order_relaxed);
+        }
+        size_t take = std::min(magazineFor(sizeClass), depot.blocks.size());
+        std::copy(depot.blocks.end() - take, depot.blocks.end(), bin.blocks);
+        depot.blocks.resize(depot.blocks.size() - take);
+        bin.count = static_cast<uint32_t>(take);
+        return true;
+    }
+    
+    // Return the older magazine of a full bin to the depot
+    void flush(size_t sizeClass, Bin& bin) {
+        Depot& depot = depots[sizeClass];
+        size_t magazine = magazineFor(sizeClass);
+        publish(bin, depot);
+        {
+            std::lock_guard<std::mutex> lock(depot.mutex);
+            depot.blocks.insert(depot.blocks.end(), bin.blocks, bin.blocks + magazine);
+        }
+        std::copy(bin.blocks + magazine, bin.blocks + bin.count, bin.blocks);
+        bin.count -= static_cast<uint32_t>(magazine);
+    }
+    
+    // A thread is leaving (or moving to another pool): hand everything back
+    void release(ThreadCache& cache) {
+        for (size_t c = 0; c < kClassCount; ++c) {
+            Bin& bin = cache.bins[c];
+            publish(bin, depots[c]);
+            std::lock_guard<std::mutex> lock(depots[c].mutex);
+            depots[c].blocks.insert(depots[c].blocks.end(), bin.blocks, bin.blocks + bin.count);
+            bin.count = 0;
+        }
+        cache.pool = nullptr;
+    }
+};
+
+} // namespace SiliconValleyAddon
+
+#endif // SILICON_VALLEY_HIGH_PERFORMANCE_ENGINES_H